@@ -0,0 +1,638 @@
+/**
+ * @file btree_bench.c
+ * @brief B-Tree 벤치마크 하니스 (YCSB 유사 작업 부하)
+ *
+ * 설정 조합 (작업 부하 x 키 분포 x 차수 x 키/값 크기 x 스레드 수)마다 트리를
+ * 새로 적재하고, 스레드별로 정해진 수의 연산을 실행한다. 처리량은 전체 구간의
+ * 단조 시계 (CLOCK_MONOTONIC) 벽시계 시간으로, 지연 시간은 연산마다 잰 값을
+ * 로그-선형 히스토그램 (2의 거듭제곱 구간당 8개 버킷)에 모아 분위수를 낸다.
+ * 결과는 설정 하나당 CSV 한 줄 또는 JSON 객체 한 줄로 stdout에 출력한다.
+ *
+ * 작업 부하:
+ *   point  - 적재된 키 조회 100% (YCSB-C)
+ *   insert - 새 키 삽입 100%
+ *   mixed  - 조회 90%, 새 키 삽입 10% (YCSB-B에 가까움, 갱신 대신 삽입)
+ *   scan   - 시작 키부터 scan-length개 범위 순회 100% (YCSB-E)
+ * 키 분포:
+ *   uniform - 균등, zipf - 섞인 Zipf (theta 0.99), seq - 스레드별 순차
+ *
+ * 키는 key-size 바이트의 빅엔디언 정수 (나머지는 0)이며 memcmp로 비교한다.
+ * --key-type int이면 8바이트 long long 키를 타입 특화 노드 내 검색
+ * (btree_search_llong)으로 찾으므로 --search로 검색 방식을 비교할 수 있다.
+ * --node-bytes를 주면 차수 목록 대신 BTREE_DEGREE_AUTO와 btree_set_node_bytes로
+ * 차수를 정하며, 출력의 degree와 search는 트리가 실제로 고른 값이다.
+ * 스레드가 둘 이상이면 btree_set_thread_safe를 켜고 조회는 btree_get을 쓴다.
+ *
+ * 사용 예:
+ *   btree_bench --workload point,mixed --dist zipf --degree 8,16,32,64
+ *   btree_bench --workload point,scan --key-type int --node-bytes 256,1024,4096
+ *   btree_bench --threads 1,2,4,8 --format json
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/btree.h"
+
+#define BENCH_MAX_LIST          16
+#define BENCH_MAX_KEY_SIZE      256
+#define BENCH_MAX_VALUE_SIZE    4096
+#define BENCH_SUB_BUCKETS       8
+#define BENCH_BUCKETS           (64 * BENCH_SUB_BUCKETS)
+#define BENCH_ZIPF_THETA        0.99
+
+typedef enum { BENCH_POINT, BENCH_INSERT, BENCH_MIXED, BENCH_SCAN, BENCH_WORKLOAD_COUNT } bench_workload_t;
+typedef enum { BENCH_UNIFORM, BENCH_ZIPF, BENCH_SEQ, BENCH_DIST_COUNT } bench_dist_t;
+#define BENCH_SEARCH_COUNT 4
+
+static const char *bench_workload_names[BENCH_WORKLOAD_COUNT] = { "point", "insert", "mixed", "scan" };
+static const char *bench_dist_names[BENCH_DIST_COUNT] = { "uniform", "zipf", "seq" };
+static const char *bench_search_names[BENCH_SEARCH_COUNT] = { "auto", "linear", "binary", "simd" };
+
+/* 정수 목록 옵션 */
+typedef struct {
+    long values[BENCH_MAX_LIST];
+    int count;
+} bench_list_t;
+
+/* 실행 옵션 */
+typedef struct {
+    bench_list_t workloads;
+    bench_list_t dists;
+    bench_list_t degrees;
+    bench_list_t node_bytes;            /* 비어 있지 않으면 degrees 대신 사용 */
+    bench_list_t searches;              /* btree_search_mode_t */
+    bench_list_t key_sizes;
+    bench_list_t value_sizes;
+    bench_list_t threads;
+    size_t records;                     /* 적재할 키 수 */
+    size_t ops;                         /* 스레드당 연산 수 */
+    size_t scan_length;
+    uint64_t seed;
+    bool int_keys;                      /* 8바이트 long long 키 */
+    bool json;
+} bench_options_t;
+
+/* Zipf 난수 (Gray et al., YCSB의 ZipfianGenerator와 같은 방식) */
+typedef struct {
+    uint64_t n;
+    double theta;
+    double alpha;
+    double zetan;
+    double eta;
+    double half_pow_theta;
+} bench_zipf_t;
+
+/* 한 설정의 실행 상태 (스레드 공유) */
+typedef struct {
+    const bench_options_t *options;
+    bench_workload_t workload;
+    bench_dist_t dist;
+    size_t key_size;
+    size_t value_size;
+    int threads;
+    btree_t *tree;
+    const bench_zipf_t *zipf;
+
+    /* 시작 신호 (모든 스레드가 준비된 뒤 한꺼번에 출발) */
+    pthread_mutex_t gate_lock;
+    pthread_cond_t gate;
+    int ready;
+    bool started;
+} bench_run_t;
+
+/* 스레드별 결과 */
+typedef struct {
+    bench_run_t *run;
+    int index;
+    pthread_t thread;
+    uint64_t histogram[BENCH_BUCKETS];
+    uint64_t ops;
+    uint64_t misses;                    /* 없는 키 조회 또는 중복 삽입 */
+} bench_worker_t;
+
+static size_t bench_key_size;           /* 비교 함수가 쓰는 현재 키 크기 */
+static bool bench_int_keys;             /* 키 인코딩이 long long인지 */
+
+static uint64_t bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/* xorshift64* */
+static uint64_t bench_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ull;
+}
+
+static double bench_random_unit(uint64_t *state) {
+    return (double)(bench_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* 64비트 섞기 (Zipf 순위를 키 공간에 흩뿌림) */
+static uint64_t bench_mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static void bench_zipf_init(bench_zipf_t *zipf, uint64_t n, double theta) {
+    double zeta2 = 1.0 + pow(0.5, theta);
+    double zetan = 0.0;
+    for (uint64_t i = 1; i <= n; i++) {
+        zetan += 1.0 / pow((double)i, theta);
+    }
+    zipf->n = n;
+    zipf->theta = theta;
+    zipf->alpha = 1.0 / (1.0 - theta);
+    zipf->zetan = zetan;
+    zipf->eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    zipf->half_pow_theta = 1.0 + pow(0.5, theta);
+}
+
+static uint64_t bench_zipf_next(const bench_zipf_t *zipf, uint64_t *state) {
+    double u = bench_random_unit(state);
+    double uz = u * zipf->zetan;
+    if (uz < 1.0) return 0;
+    if (uz < zipf->half_pow_theta) return 1;
+    uint64_t rank = (uint64_t)((double)zipf->n * pow(zipf->eta * u - zipf->eta + 1.0, zipf->alpha));
+    return rank < zipf->n ? rank : zipf->n - 1;
+}
+
+/* 키 인코딩: 앞 8바이트에 빅엔디언 정수, 나머지는 0 (정수 키는 long long 그대로) */
+static void bench_encode_key(unsigned char *key, uint64_t value, size_t key_size) {
+    if (bench_int_keys) {
+        long long k = (long long)value;
+        memcpy(key, &k, sizeof(k));
+        return;
+    }
+    memset(key, 0, key_size);
+    for (int i = 0; i < 8; i++) {
+        key[i] = (unsigned char)(value >> (56 - 8 * i));
+    }
+}
+
+static int bench_compare(const void *a, const void *b) {
+    return memcmp(a, b, bench_key_size);
+}
+
+/* 적재된 키 번호 (0 ~ records-1) 선택, 적재 키 값은 번호 * 2 */
+static uint64_t bench_pick(const bench_run_t *run, uint64_t *state, uint64_t *cursor) {
+    uint64_t records = run->options->records;
+    switch (run->dist) {
+        case BENCH_ZIPF:
+            return bench_mix(bench_zipf_next(run->zipf, state)) % records;
+        case BENCH_SEQ:
+            return (*cursor)++ % records;
+        default:
+            return bench_random(state) % records;
+    }
+}
+
+/* 새 키 값 (적재 키와 겹치지 않는 홀수, seq는 스레드별로 끝에 이어 붙임) */
+static uint64_t bench_fresh_key(const bench_run_t *run, int thread, uint64_t *state,
+                                uint64_t *counter) {
+    if (run->dist == BENCH_SEQ) {
+        uint64_t n = (*counter)++;
+        return 2 * (run->options->records + n * (uint64_t)run->threads + (uint64_t)thread) + 1;
+    }
+    return (bench_random(state) >> 1) | 1;
+}
+
+static void bench_record(uint64_t *histogram, uint64_t ns) {
+    int bucket;
+    if (ns < BENCH_SUB_BUCKETS) {
+        bucket = (int)ns;
+    } else {
+        int exponent = 63;
+        while (!(ns >> exponent)) exponent--;
+        bucket = (exponent - 2) * BENCH_SUB_BUCKETS + (int)((ns >> (exponent - 3)) & 7);
+    }
+    histogram[bucket]++;
+}
+
+static uint64_t bench_bucket_upper(int bucket) {
+    if (bucket < BENCH_SUB_BUCKETS) return (uint64_t)bucket;
+    int exponent = bucket / BENCH_SUB_BUCKETS + 2;
+    uint64_t sub = (uint64_t)(bucket % BENCH_SUB_BUCKETS);
+    return ((BENCH_SUB_BUCKETS + sub) << (exponent - 3)) + ((uint64_t)1 << (exponent - 3)) - 1;
+}
+
+static uint64_t bench_percentile(const uint64_t *histogram, uint64_t total, double quantile) {
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(quantile * (double)total);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BENCH_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= rank) return bench_bucket_upper(i);
+    }
+    return bench_bucket_upper(BENCH_BUCKETS - 1);
+}
+
+static bool bench_lookup(const bench_run_t *run, const unsigned char *key, unsigned char *value) {
+    if (run->threads > 1) {
+        return btree_get(run->tree, key, value) == BTREE_SUCCESS;
+    }
+    return btree_search(run->tree, key) != NULL;
+}
+
+static size_t bench_scan(const bench_run_t *run, const unsigned char *start) {
+    btree_iterator_t iter;
+    if (btree_iterator_init(&iter, run->tree, start, NULL) != BTREE_SUCCESS) return 0;
+
+    size_t visited = 0;
+    void *key, *value;
+    while (visited < run->options->scan_length && btree_iterator_next(&iter, &key, &value)) {
+        visited++;
+    }
+    return visited;
+}
+
+static void* bench_worker_main(void *arg) {
+    bench_worker_t *worker = arg;
+    bench_run_t *run = worker->run;
+    uint64_t key_words[BENCH_MAX_KEY_SIZE / sizeof(uint64_t)];   /* 정수 키 정렬 */
+    unsigned char *key = (unsigned char*)key_words;
+    unsigned char value[BENCH_MAX_VALUE_SIZE];
+    uint64_t state = bench_mix(run->options->seed + 0x9e3779b97f4a7c15ull * (uint64_t)(worker->index + 1));
+    uint64_t cursor = (uint64_t)worker->index * (run->options->records / (uint64_t)run->threads);
+    uint64_t counter = 0;
+
+    memset(value, 0xab, run->value_size);
+    pthread_mutex_lock(&run->gate_lock);
+    run->ready++;
+    pthread_cond_broadcast(&run->gate);
+    while (!run->started) pthread_cond_wait(&run->gate, &run->gate_lock);
+    pthread_mutex_unlock(&run->gate_lock);
+
+    for (size_t i = 0; i < run->options->ops; i++) {
+        bool insert = run->workload == BENCH_INSERT ||
+                      (run->workload == BENCH_MIXED && bench_random(&state) % 10 == 0);
+        if (insert) {
+            bench_encode_key(key, bench_fresh_key(run, worker->index, &state, &counter), run->key_size);
+        } else {
+            bench_encode_key(key, 2 * bench_pick(run, &state, &cursor), run->key_size);
+        }
+
+        uint64_t start = bench_now();
+        bool hit;
+        if (insert) {
+            hit = btree_insert(run->tree, key, value) == BTREE_SUCCESS;
+        } else if (run->workload == BENCH_SCAN) {
+            hit = bench_scan(run, key) > 0;
+        } else {
+            hit = bench_lookup(run, key, value);
+        }
+        bench_record(worker->histogram, bench_now() - start);
+        worker->misses += !hit;
+    }
+    worker->ops = run->options->ops;
+    return NULL;
+}
+
+/* 적재: 키 번호 i에 키 값 2i (정렬된 입력이므로 상향식 적재) */
+static btree_result_t bench_load(btree_t *tree, size_t records, size_t key_size, size_t value_size) {
+    unsigned char *keys = malloc(records * key_size);
+    unsigned char *values = malloc(value_size ? value_size : 1);
+    btree_key_value_pair_t *pairs = malloc(records * sizeof(btree_key_value_pair_t));
+    btree_result_t result = BTREE_ERROR_MEMORY_ALLOCATION;
+
+    if (keys && values && pairs) {
+        memset(values, 0xcd, value_size);
+        for (size_t i = 0; i < records; i++) {
+            bench_encode_key(keys + i * key_size, 2 * (uint64_t)i, key_size);
+            pairs[i].key = keys + i * key_size;
+            pairs[i].value = values;
+        }
+        result = btree_bulk_insert(tree, pairs, records);
+    }
+    free(pairs);
+    free(values);
+    free(keys);
+    return result;
+}
+
+static void bench_print_header(const bench_options_t *options) {
+    if (options->json) return;
+    printf("workload,dist,node_bytes,degree,search,key_size,value_size,threads,records,ops,"
+           "seconds,ops_per_sec,p50_ns,p99_ns,p999_ns,max_ns,misses,height,memory_bytes\n");
+}
+
+static bool bench_run_config(const bench_options_t *options, bench_workload_t workload,
+                             bench_dist_t dist, int degree, size_t node_bytes,
+                             btree_search_mode_t search, size_t key_size, size_t value_size,
+                             int threads, const bench_zipf_t *zipf) {
+    btree_type_info_t key_type = {
+        .key_size = key_size,
+        .alignment = 1,
+        .type_name = "bench_key",
+        .compare = bench_compare,
+    };
+    if (options->int_keys) {
+        key_type.alignment = sizeof(long long);
+        key_type.type_name = "long long";
+        key_type.compare = btree_compare_llong;
+        key_type.search = btree_search_llong;
+    }
+    btree_type_info_t value_type = {
+        .value_size = value_size,
+        .alignment = 1,
+        .type_name = "bench_value",
+    };
+    btree_t tree;
+    bench_key_size = key_size;
+
+    if (btree_init(&tree, node_bytes ? BTREE_DEGREE_AUTO : degree, &key_type, &value_type,
+                   NULL) != BTREE_SUCCESS) {
+        fprintf(stderr, "btree_init 실패 (degree %d)\n", degree);
+        return false;
+    }
+    if ((node_bytes && btree_set_node_bytes(&tree, node_bytes) != BTREE_SUCCESS) ||
+        btree_set_search_mode(&tree, search) != BTREE_SUCCESS) {
+        fprintf(stderr, "노드 크기 또는 검색 방식 설정 실패\n");
+        btree_cleanup(&tree);
+        return false;
+    }
+    if (bench_load(&tree, options->records, key_size, value_size) != BTREE_SUCCESS) {
+        fprintf(stderr, "적재 실패\n");
+        btree_cleanup(&tree);
+        return false;
+    }
+    if (threads > 1 && btree_set_thread_safe(&tree, true) != BTREE_SUCCESS) {
+        fprintf(stderr, "동시 모드 설정 실패\n");
+        btree_cleanup(&tree);
+        return false;
+    }
+
+    bench_run_t run = {
+        .options = options, .workload = workload, .dist = dist,
+        .key_size = key_size, .value_size = value_size, .threads = threads,
+        .tree = &tree, .zipf = zipf,
+    };
+    bench_worker_t *workers = calloc((size_t)threads, sizeof(bench_worker_t));
+    if (!workers) {
+        btree_cleanup(&tree);
+        return false;
+    }
+    pthread_mutex_init(&run.gate_lock, NULL);
+    pthread_cond_init(&run.gate, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        workers[i].run = &run;
+        workers[i].index = i;
+        pthread_create(&workers[i].thread, NULL, bench_worker_main, &workers[i]);
+    }
+    pthread_mutex_lock(&run.gate_lock);
+    while (run.ready < threads) pthread_cond_wait(&run.gate, &run.gate_lock);
+    uint64_t start = bench_now();
+    run.started = true;
+    pthread_cond_broadcast(&run.gate);
+    pthread_mutex_unlock(&run.gate_lock);
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double seconds = (double)(bench_now() - start) * 1e-9;
+    pthread_cond_destroy(&run.gate);
+    pthread_mutex_destroy(&run.gate_lock);
+
+    uint64_t histogram[BENCH_BUCKETS] = {0};
+    uint64_t ops = 0, misses = 0;
+    for (int i = 0; i < threads; i++) {
+        for (int b = 0; b < BENCH_BUCKETS; b++) histogram[b] += workers[i].histogram[b];
+        ops += workers[i].ops;
+        misses += workers[i].misses;
+    }
+    free(workers);
+
+    double ops_per_sec = seconds > 0.0 ? (double)ops / seconds : 0.0;
+    uint64_t p50 = bench_percentile(histogram, ops, 0.50);
+    uint64_t p99 = bench_percentile(histogram, ops, 0.99);
+    uint64_t p999 = bench_percentile(histogram, ops, 0.999);
+    uint64_t max = bench_percentile(histogram, ops, 1.0);
+
+    const char *search_name = bench_search_names[btree_get_search_mode(&tree)];
+    if (options->json) {
+        printf("{\"workload\":\"%s\",\"dist\":\"%s\",\"node_bytes\":%zu,\"degree\":%d,"
+               "\"search\":\"%s\",\"key_size\":%zu,"
+               "\"value_size\":%zu,\"threads\":%d,\"records\":%zu,\"ops\":%llu,"
+               "\"seconds\":%.6f,\"ops_per_sec\":%.0f,\"p50_ns\":%llu,\"p99_ns\":%llu,"
+               "\"p999_ns\":%llu,\"max_ns\":%llu,\"misses\":%llu,\"height\":%d,"
+               "\"memory_bytes\":%zu}\n",
+               bench_workload_names[workload], bench_dist_names[dist], node_bytes, tree.degree,
+               search_name, key_size, value_size, threads, options->records,
+               (unsigned long long)ops, seconds,
+               ops_per_sec, (unsigned long long)p50, (unsigned long long)p99,
+               (unsigned long long)p999, (unsigned long long)max, (unsigned long long)misses,
+               btree_height(&tree), tree.total_memory);
+    } else {
+        printf("%s,%s,%zu,%d,%s,%zu,%zu,%d,%zu,%llu,%.6f,%.0f,%llu,%llu,%llu,%llu,%llu,%d,%zu\n",
+               bench_workload_names[workload], bench_dist_names[dist], node_bytes, tree.degree,
+               search_name, key_size, value_size, threads, options->records,
+               (unsigned long long)ops, seconds,
+               ops_per_sec, (unsigned long long)p50, (unsigned long long)p99,
+               (unsigned long long)p999, (unsigned long long)max, (unsigned long long)misses,
+               btree_height(&tree), tree.total_memory);
+    }
+    fflush(stdout);
+
+    btree_cleanup(&tree);
+    return true;
+}
+
+/* "a,b,c" 형식의 이름 목록 */
+static bool bench_parse_names(const char *text, const char *const *names, int name_count,
+                              bench_list_t *list) {
+    char buffer[256];
+    if (strlen(text) >= sizeof(buffer)) return false;
+    strcpy(buffer, text);
+
+    list->count = 0;
+    for (char *token = strtok(buffer, ","); token; token = strtok(NULL, ",")) {
+        if (strcmp(token, "all") == 0) {
+            for (int i = 0; i < name_count && list->count < BENCH_MAX_LIST; i++) {
+                list->values[list->count++] = i;
+            }
+            continue;
+        }
+        int found = -1;
+        for (int i = 0; i < name_count; i++) {
+            if (strcmp(token, names[i]) == 0) found = i;
+        }
+        if (found < 0 || list->count >= BENCH_MAX_LIST) return false;
+        list->values[list->count++] = found;
+    }
+    return list->count > 0;
+}
+
+/* "1,2,4" 형식의 양의 정수 목록 */
+static bool bench_parse_numbers(const char *text, long max, bench_list_t *list) {
+    list->count = 0;
+    const char *p = text;
+    while (*p) {
+        char *end;
+        errno = 0;
+        long value = strtol(p, &end, 10);
+        if (end == p || errno || value <= 0 || value > max || list->count >= BENCH_MAX_LIST) {
+            return false;
+        }
+        list->values[list->count++] = value;
+        if (*end == ',') end++;
+        else if (*end) return false;
+        p = end;
+    }
+    return list->count > 0;
+}
+
+static bool bench_parse_size(const char *text, size_t *out) {
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || *end || errno || value == 0) return false;
+    *out = (size_t)value;
+    return true;
+}
+
+static void bench_usage(const char *program) {
+    fprintf(stderr,
+        "사용법: %s [옵션]\n"
+        "  --workload LIST     point,insert,mixed,scan 또는 all (기본 all)\n"
+        "  --dist LIST         uniform,zipf,seq 또는 all (기본 all)\n"
+        "  --degree LIST       차수 목록 (기본 %d)\n"
+        "  --node-bytes LIST   노드 바이트 예산 목록 (주면 차수 자동, 차수 목록 무시)\n"
+        "  --search LIST       auto,linear,binary,simd 또는 all (기본 auto)\n"
+        "  --key-type T        bytes 또는 int (8바이트 long long, 기본 bytes)\n"
+        "  --key-size LIST     키 바이트 수, 8 ~ %d (기본 8)\n"
+        "  --value-size LIST   값 바이트 수, 1 ~ %d (기본 8)\n"
+        "  --threads LIST      스레드 수 목록 (기본 1)\n"
+        "  --records N         적재할 키 수 (기본 200000)\n"
+        "  --ops N             스레드당 연산 수 (기본 200000)\n"
+        "  --scan-length N     범위 순회 길이 (기본 100)\n"
+        "  --seed N            난수 시드 (기본 42)\n"
+        "  --format csv|json   출력 형식 (기본 csv)\n",
+        program, BTREE_DEFAULT_DEGREE, BENCH_MAX_KEY_SIZE, BENCH_MAX_VALUE_SIZE);
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options = {
+        .workloads = { { BENCH_POINT, BENCH_INSERT, BENCH_MIXED, BENCH_SCAN }, BENCH_WORKLOAD_COUNT },
+        .dists = { { BENCH_UNIFORM, BENCH_ZIPF, BENCH_SEQ }, BENCH_DIST_COUNT },
+        .degrees = { { BTREE_DEFAULT_DEGREE }, 1 },
+        .node_bytes = { { 0 }, 0 },
+        .searches = { { BTREE_SEARCH_AUTO }, 1 },
+        .key_sizes = { { 8 }, 1 },
+        .value_sizes = { { 8 }, 1 },
+        .threads = { { 1 }, 1 },
+        .records = 200000,
+        .ops = 200000,
+        .scan_length = 100,
+        .seed = 42,
+        .int_keys = false,
+        .json = false,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *next = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            bench_usage(argv[0]);
+            return 0;
+        } else if (!next) {
+            ok = false;
+        } else if (strcmp(arg, "--workload") == 0) {
+            ok = bench_parse_names(next, bench_workload_names, BENCH_WORKLOAD_COUNT, &options.workloads);
+        } else if (strcmp(arg, "--dist") == 0) {
+            ok = bench_parse_names(next, bench_dist_names, BENCH_DIST_COUNT, &options.dists);
+        } else if (strcmp(arg, "--degree") == 0) {
+            ok = bench_parse_numbers(next, BTREE_MAX_DEGREE, &options.degrees);
+        } else if (strcmp(arg, "--node-bytes") == 0) {
+            ok = bench_parse_numbers(next, 1L << 24, &options.node_bytes);
+        } else if (strcmp(arg, "--search") == 0) {
+            ok = bench_parse_names(next, bench_search_names, BENCH_SEARCH_COUNT, &options.searches);
+        } else if (strcmp(arg, "--key-type") == 0) {
+            ok = strcmp(next, "bytes") == 0 || strcmp(next, "int") == 0;
+            options.int_keys = strcmp(next, "int") == 0;
+        } else if (strcmp(arg, "--key-size") == 0) {
+            ok = bench_parse_numbers(next, BENCH_MAX_KEY_SIZE, &options.key_sizes);
+            for (int k = 0; ok && k < options.key_sizes.count; k++) ok = options.key_sizes.values[k] >= 8;
+        } else if (strcmp(arg, "--value-size") == 0) {
+            ok = bench_parse_numbers(next, BENCH_MAX_VALUE_SIZE, &options.value_sizes);
+        } else if (strcmp(arg, "--threads") == 0) {
+            ok = bench_parse_numbers(next, 1024, &options.threads);
+        } else if (strcmp(arg, "--records") == 0) {
+            ok = bench_parse_size(next, &options.records);
+        } else if (strcmp(arg, "--ops") == 0) {
+            ok = bench_parse_size(next, &options.ops);
+        } else if (strcmp(arg, "--scan-length") == 0) {
+            ok = bench_parse_size(next, &options.scan_length);
+        } else if (strcmp(arg, "--seed") == 0) {
+            size_t seed;
+            ok = bench_parse_size(next, &seed);
+            options.seed = seed;
+        } else if (strcmp(arg, "--format") == 0) {
+            ok = strcmp(next, "csv") == 0 || strcmp(next, "json") == 0;
+            options.json = strcmp(next, "json") == 0;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "잘못된 옵션: %s%s%s\n", arg, next ? " " : "", next ? next : "");
+            bench_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    if (options.int_keys) {
+        for (int k = 0; k < options.key_sizes.count; k++) {
+            if (options.key_sizes.values[k] != (long)sizeof(long long)) {
+                fprintf(stderr, "--key-type int는 키 크기 %zu만 지원\n", sizeof(long long));
+                return 2;
+            }
+        }
+    }
+    bench_int_keys = options.int_keys;
+
+    bench_zipf_t zipf;
+    bench_zipf_init(&zipf, options.records, BENCH_ZIPF_THETA);
+
+    /* 노드 바이트 예산을 주면 차수 대신 예산마다 실행 (0은 고정 차수) */
+    bool auto_degree = options.node_bytes.count > 0;
+    const bench_list_t *sizes = auto_degree ? &options.node_bytes : &options.degrees;
+
+    bench_print_header(&options);
+    for (int w = 0; w < options.workloads.count; w++)
+    for (int d = 0; d < options.dists.count; d++)
+    for (int g = 0; g < sizes->count; g++)
+    for (int m = 0; m < options.searches.count; m++)
+    for (int k = 0; k < options.key_sizes.count; k++)
+    for (int v = 0; v < options.value_sizes.count; v++)
+    for (int t = 0; t < options.threads.count; t++) {
+        int degree = auto_degree ? BTREE_DEGREE_AUTO : (int)sizes->values[g];
+        size_t node_bytes = auto_degree ? (size_t)sizes->values[g] : 0;
+        if (!bench_run_config(&options, (bench_workload_t)options.workloads.values[w],
+                              (bench_dist_t)options.dists.values[d], degree, node_bytes,
+                              (btree_search_mode_t)options.searches.values[m],
+                              (size_t)options.key_sizes.values[k], (size_t)options.value_sizes.values[v],
+                              (int)options.threads.values[t], &zipf)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -9,11 +9,6 @@
 BTREE_DECLARE_INT_INT(traversal);
 BTREE_DEFINE_INT_INT(traversal);
 
-/* Global array for collecting traversal results */
-static int *traversal_result = NULL;
-static size_t traversal_index = 0;
-static size_t traversal_capacity = 0;
-
 /**
  * @brief Generate random integer array
  * @param arr Output array
@@ -63,19 +58,6 @@ bool is_sorted(const int *arr, size_t size) {
     return true;
 }
 
-/**
- * @brief Callback function for B-Tree traversal
- * This function will be called for each key-value pair during traversal
- */
-void traversal_callback(int key, int value, void *user_data) {
-    (void)value;      // We only care about keys for sorting
-    (void)user_data;  // Not used in this implementation
-    
-    if (traversal_result && traversal_index < traversal_capacity) {
-        traversal_result[traversal_index++] = key;
-    }
-}
-
 /**
  * @brief Sort array using B-Tree in-order traversal
  * @param arr Array to sort
@@ -124,35 +106,16 @@ bool btree_traversal_sort(int *arr, size_t size, int degree) {
     /* Prepare for traversal */
     printf("Performing in-order traversal...\n");
     
-    /* Setup global traversal state */
-    traversal_result = malloc(size * sizeof(int));
-    if (!traversal_result) {
-        printf("Error: Memory allocation failed for traversal result\n");
-        btree_traversal_destroy(tree);
-        return false;
-    }
-    traversal_index = 0;
-    traversal_capacity = size;
+    /* In-order traversal: the iterator points straight into node storage */
+    btree_iterator_t iter;
+    btree_iterator_init(&iter, &tree->base, NULL, NULL);
     
-    /* Simulate in-order traversal by iterating through sorted keys */
-    /* Since we don't have direct traversal API, we'll extract in sorted order */
-    
-    /* Find min and max values for range traversal */
-    int min_val = arr[0], max_val = arr[0];
-    for (size_t i = 1; i < size; i++) {
-        if (arr[i] < min_val) min_val = arr[i];
-        if (arr[i] > max_val) max_val = arr[i];
-    }
-    
-    /* Extract elements in sorted order (simulating in-order traversal) */
     size_t output_index = 0;
-    for (int val = min_val; val <= max_val && output_index < size; val++) {
-        int *count = btree_traversal_search(tree, val);
-        if (count && *count > 0) {
-            /* Add all occurrences of this value (sorted output) */
-            for (int i = 0; i < *count && output_index < size; i++) {
-                arr[output_index++] = val;
-            }
+    void *key, *value;
+    while (output_index < size && btree_iterator_next(&iter, &key, &value)) {
+        /* Add all occurrences of this value (sorted output) */
+        for (int i = 0; i < *(int*)value && output_index < size; i++) {
+            arr[output_index++] = *(int*)key;
         }
     }
     
@@ -162,8 +125,6 @@ bool btree_traversal_sort(int *arr, size_t size, int degree) {
     printf("Total sorting time: %.3fs\n", ((double)(end - start)) / CLOCKS_PER_SEC);
     
     /* Cleanup */
-    free(traversal_result);
-    traversal_result = NULL;
     btree_traversal_destroy(tree);
     
     return output_index == size;
@@ -210,7 +171,7 @@ void demonstrate_btree_structure(const int *data, size_t size, int degree) {
     printf("- Empty: %s\n", btree_traversal_is_empty(tree) ? "Yes" : "No");
     
     /* Demonstrate sorted extraction */
-    printf("\nExtracting in sorted order (simulated in-order traversal):\n");
+    printf("\nExtracting in sorted order (in-order traversal):\n");
     int *sorted_data = malloc(size * sizeof(int));
     if (sorted_data) {
         memcpy(sorted_data, data, size * sizeof(int));
@@ -32,11 +32,13 @@ extern "C" {
 #define BTREE_DEFAULT_DEGREE    16
 #endif
 
-#ifndef BTREE_MAX_HEIGHT
-#define BTREE_MAX_HEIGHT        20
-#endif
-
-/* B-Tree 초기화 및 정리 함수 */
+/*
+ * B-Tree 초기화 및 정리 함수
+ *
+ * degree가 BTREE_DEGREE_AUTO면 노드가 BTREE_DEFAULT_NODE_BYTES에 들어가는
+ * 가장 큰 차수를 키와 값 크기로 정한다 (btree_degree_for_bytes). 이렇게 만든
+ * 트리는 btree_set_variant로 변형을 바꿔도 같은 예산으로 차수를 다시 맞춘다.
+ */
 btree_result_t btree_init(btree_t *tree, int degree,
                          const btree_type_info_t *key_type,
                          const btree_type_info_t *value_type,
@@ -49,31 +51,166 @@ void* btree_search(btree_t *tree, const void *key);
 btree_result_t btree_delete(btree_t *tree, const void *key);
 bool btree_contains(btree_t *tree, const void *key);
 
+/**
+ * @brief 값을 value_out에 복사하여 검색 (value_size 바이트의 얕은 복사)
+ *
+ * 동시 모드에서 다른 스레드가 쓰는 중에도 일관된 값을 돌려주는 조회 방법이다.
+ */
+btree_result_t btree_get(btree_t *tree, const void *key, void *value_out);
+
+/**
+ * @brief 상태와 값 포인터를 한 번에 반환하는 검색
+ *
+ * status는 BTREE_SUCCESS, BTREE_ERROR_KEY_NOT_FOUND, BTREE_ERROR_NULL_POINTER
+ * 중 하나이고 value는 찾은 값 슬롯 (없으면 NULL)이다. 없는 키가 흔한 읽기
+ * 경로에서 btree_get_last_error를 거치지 않도록 오류 상태에는 아무것도 쓰지
+ * 않는다. 포인터의 유효 기간은 btree_search와 같다.
+ */
+typedef struct {
+    btree_result_t status;
+    void *value;
+} btree_lookup_t;
+
+btree_lookup_t btree_lookup(btree_t *tree, const void *key);
+
+/**
+ * @brief 동시 접근 모드 설정 (BTREE_FLAG_THREAD_SAFE)
+ *
+ * 켜면 검색(btree_search, btree_get, btree_contains)은 잠금 없이 노드 버전으로
+ * 검증하며 여러 스레드에서 동시에 호출할 수 있고, 삽입은 분할하거나 수정하는
+ * 노드만 잠근다. 삽입과 겹치는 동안 검색은 잠금 없이 진행된다 (바뀐 노드를
+ * 만나면 루트부터 다시). 삭제, 일괄 적재, 삭제 표시 제거, 재구성과 복사는
+ * 다른 쓰기와 배타적으로 수행되며, 그 구간이 진행 중이면 새로 시작하거나
+ * 재시도하는 검색은 구간이 끝날 때까지 양보하며 기다린다. 따라서 삭제가 계속
+ * 이어지는 동안 검색은 잠금 없이 진행된다고 볼 수 없다 (진척은 삭제 사이의
+ * 틈에 달림). 삭제로 떨어져 나간 노드는 그때 읽던 검색이 모두 끝난 뒤 이후의
+ * 배타 쓰기가 끝날 때 해제된다 (에포크 기반, btree_concurrent_retired는 아직
+ * 해제하지 않은 노드 수).
+ *
+ * 반복자, 범위 검색, 설정 함수와 clear/cleanup은 다른 스레드가 트리를 쓰지
+ * 않을 때만 사용해야 한다. btree_search가 돌려준 포인터는 이후 쓰기로 무효가
+ * 될 수 있으므로 동시 조회에는 btree_get을 사용한다. 잠금 없는 읽기는 수정 중인
+ * 키를 비교할 수 있으므로 포인터 키 타입(예: 문자열)에는 켤 수 없다. 검색이
+ * 키를 복사해 비교하므로 2KB보다 큰 키와, 쓰기가 임시 슬롯에 복사해 원자적으로
+ * 옮기는 256바이트보다 큰 포인터 값 타입도 마찬가지다 (BTREE_ERROR_TYPE_MISMATCH).
+ * 다른 스레드가 사용 중일 때 켜거나 끄면 안 된다.
+ */
+btree_result_t btree_set_thread_safe(btree_t *tree, bool enable);
+size_t btree_concurrent_retired(const btree_t *tree);
+
 /* 범위 검색 함수 */
 typedef struct {
     void *key;
     void *value;
 } btree_key_value_pair_t;
 
+/**
+ * @brief [min_key, max_key] 범위의 항목을 순서대로 results에 채움
+ *
+ * 키와 값은 복사하지 않고 노드 저장소를 직접 가리키며, 트리가 수정되기
+ * 전까지만 유효하다. min_key나 max_key가 NULL이면 해당 방향은 제한이 없다.
+ * @return 채운 항목 수 (최대 max_results)
+ */
 size_t btree_range_search(btree_t *tree, const void *min_key, const void *max_key,
                          btree_key_value_pair_t *results, size_t max_results);
+
+/**
+ * @brief prefix의 prefix_len 바이트로 시작하는 키를 순서대로 results에 채움
+ *
+ * prefix는 키가 아니라 바이트 열이다 (문자열 키라면 문자열 자체). 키의 바이트는
+ * 타입의 bytes 함수로 얻으며 (NULL이면 키 메모리 그대로), 키 순서가 바이트
+ * 사전순인 타입에서만 쓸 수 있다. 숫자와 포인터 키는 BTREE_ERROR_TYPE_MISMATCH.
+ * 하한으로 한 번 내려간 뒤 접두사가 맞지 않는 첫 키에서 멈추며, 결과는
+ * btree_range_search처럼 노드 저장소를 가리킨다. prefix_len이 0이면 모든 키.
+ * @return 채운 항목 수 (최대 max_results)
+ */
 size_t btree_prefix_search(btree_t *tree, const void *prefix, size_t prefix_len,
                           btree_key_value_pair_t *results, size_t max_results);
 
+/* 병렬 순회 콜백 (state는 조각별 누적 상태, 순회만 할 때는 NULL), false면 순회 중단 */
+typedef bool (*btree_visit_func_t)(const void *key, const void *value, void *state,
+                                   void *context);
+
+/* 병렬 집계 정의 */
+typedef struct {
+    size_t state_size;                  /* 누적 상태 크기 (0이면 상태 없음) */
+    void (*init)(void *state, void *context);   /* 상태 초기화 (NULL이면 0으로 채움) */
+    btree_visit_func_t visit;           /* 항목마다 호출 */
+    void (*merge)(void *into, const void *from, void *context); /* 뒤 조각을 앞 상태에 합침 */
+    void *context;
+} btree_aggregate_t;
+
+/**
+ * @brief [min_key, max_key] 범위를 여러 스레드로 나눠 집계
+ *
+ * 루트부터 내부 노드의 구분 키에서 잘라 서로 겹치지 않는 키 구간 조각을
+ * 스레드 수의 몇 배만큼 만들고, 작업 훔치기 풀로 조각을 나눠 돈다. 조각마다
+ * 상태를 init으로 만들어 그 조각의 항목을 키 순서로 visit에 넘기며, 끝나면
+ * result를 init한 뒤 조각 상태를 키 순서대로 merge한다. 따라서 merge가 결합
+ * 법칙만 지키면 결과는 직렬 순회와 같다.
+ *
+ * visit는 여러 스레드에서 동시에 불리고 (같은 조각은 한 스레드), false를
+ * 반환하면 남은 항목을 건너뛴다. btree_range_search처럼 도는 동안 트리를
+ * 수정하면 안 된다. threads가 0이면 온라인 CPU 수, 디스크 할당자 트리는
+ * 한 스레드로 돈다. 매핑된 트리는 BTREE_ERROR_INVALID_OPERATION.
+ */
+btree_result_t btree_parallel_aggregate(btree_t *tree, const void *min_key, const void *max_key,
+                                        const btree_aggregate_t *aggregate, void *result,
+                                        int threads);
+
+/**
+ * @brief [min_key, max_key] 범위의 항목을 여러 스레드로 나눠 visit에 넘김 (state는 NULL)
+ */
+btree_result_t btree_parallel_scan(btree_t *tree, const void *min_key, const void *max_key,
+                                   btree_visit_func_t visit, void *context, int threads);
+
 /* 유틸리티 함수 */
 size_t btree_size(const btree_t *tree);
 int btree_height(const btree_t *tree);
 bool btree_is_empty(const btree_t *tree);
 void btree_clear(btree_t *tree);
-btree_result_t btree_copy(btree_t *dest, const btree_t *src);
 
-/* 반복자 함수 */
+/**
+ * @brief 트리 사본 (스냅숏)
+ *
+ * dest를 src와 같은 설정과 내용의 트리로 초기화한다 (dest의 기존 내용은
+ * 정리하지 않음). 표준 B-Tree는 O(1)이다: 두 트리가 모든 노드를 참조 카운트로
+ * 공유하고, 어느 쪽이든 처음 쓰는 노드와 루트까지의 경로만 복사한다 (경로
+ * 복사). 따라서 사본은 원본의 그 시점 내용을 계속 보여 주며, 원본을 다른
+ * 스레드에서 계속 쓰는 동안 사본을 읽거나 사본에 쓰고 버리는 (롤백) 용도로
+ * 쓸 수 있다. 두 트리는 같은 할당자를 쓰므로 할당자는 둘 다 정리될 때까지
+ * 유지해야 한다.
+ *
+ * 공유를 시작한 두 트리에는 btree_clear 전까지 BTREE_FLAG_SHARED가 붙는다:
+ * 리프 연결과 부모 포인터를 유지하지 않으며, 동시 모드와 지연 삭제 모드를
+ * 바꿀 수 없고, 노드 수준 병합/재분배는 BTREE_ERROR_INVALID_OPERATION이다.
+ * btree_search가 돌려준 값 포인터로 직접 쓰면 두 트리에 모두 보인다.
+ *
+ * B+Tree와 동시 모드 트리는 노드를 하나씩 복사하며 (사본은 동시 모드가
+ * 아님), 계측, 이벤트 구독, 로그는 복사하지 않는다. 동시 모드 트리는 배타
+ * 쓰기 구간에서 복사하므로 다른 스레드가 쓰는 중에도 사본은 한 시점의
+ * 일관된 내용이다 (복사하는 동안 쓰기는 기다림). 매핑된 트리는
+ * BTREE_ERROR_INVALID_OPERATION.
+ */
+btree_result_t btree_copy(btree_t *dest, btree_t *src);
+
+/*
+ * 반복자 함수
+ *
+ * next/prev가 돌려주는 키와 값 포인터는 노드 저장소를 직접 가리킨다 (복사 없음).
+ * 반복 중 트리를 수정하면 반복자는 무효가 되므로 reset 하거나 다시 만들어야 한다.
+ * btree_iterator_init은 힙 할당 없이 호출자 메모리에 반복자를 초기화한다.
+ */
+btree_result_t btree_iterator_init(btree_iterator_t *iter, btree_t *tree,
+                                   const void *min_key, const void *max_key);
 btree_iterator_t* btree_iterator_create(btree_t *tree);
 btree_iterator_t* btree_iterator_create_range(btree_t *tree, 
                                              const void *min_key, 
                                              const void *max_key);
 bool btree_iterator_next(btree_iterator_t *iter, void **key, void **value);
 bool btree_iterator_prev(btree_iterator_t *iter, void **key, void **value);
+size_t btree_iterator_next_batch(btree_iterator_t *iter, btree_key_value_pair_t *pairs,
+                                 size_t max_pairs);
 bool btree_iterator_has_next(const btree_iterator_t *iter);
 bool btree_iterator_has_prev(const btree_iterator_t *iter);
 void btree_iterator_reset(btree_iterator_t *iter);
@@ -122,7 +259,90 @@ typedef struct {
 void btree_collect_statistics(const btree_t *tree, btree_statistics_t *stats);
 void btree_print_statistics(const btree_t *tree, FILE *output);
 
-/* 직렬화 및 역직렬화 */
+/**
+ * @brief 운영 계측 (연산 카운터와 지연 시간 히스토그램)
+ *
+ * btree_enable_metrics로 켜기 전에는 아무것도 세지 않으며 비용은 NULL 검사
+ * 하나다. 카운터는 btree_insert/btree_search/btree_delete 호출 수와 노드 방문,
+ * 노드 안 비교, 분할, 병합, 노드 메모리 할당 횟수를 센다. 노드 방문과 비교는
+ * 단일 스레드 경로에서만 센다 (동시 모드 검색은 연산 수와 지연 시간만).
+ *
+ * 지연 시간 히스토그램은 나노초 단위의 로그-선형 버킷이다: 2의 거듭제곱
+ * 구간마다 BTREE_LATENCY_SUB_BUCKETS (16)개로 나누므로 분위수의 상대 오차가
+ * 1/16 (6.25%) 이하다.
+ */
+typedef enum {
+    BTREE_METRIC_INSERT = 0,
+    BTREE_METRIC_SEARCH,
+    BTREE_METRIC_DELETE,
+    BTREE_METRIC_OP_COUNT
+} btree_metric_op_t;
+
+#define BTREE_METRICS_COUNTERS      0x01    /* 카운터 */
+#define BTREE_METRICS_LATENCY       0x02    /* 카운터와 지연 시간 히스토그램 */
+
+#define BTREE_LATENCY_SUB_BITS      4
+#define BTREE_LATENCY_SUB_BUCKETS   (1 << BTREE_LATENCY_SUB_BITS)
+#define BTREE_LATENCY_BUCKETS       ((65 - BTREE_LATENCY_SUB_BITS) * BTREE_LATENCY_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t operations[BTREE_METRIC_OP_COUNT];     /* 연산별 호출 수 */
+    uint64_t nodes_visited;             /* 검색/삽입/삭제 중 방문한 노드 수 */
+    uint64_t comparisons;               /* 노드 안 검색의 키 비교 수 (아래 참고) */
+    uint64_t splits;                    /* 노드 분할 수 */
+    uint64_t merges;                    /* 노드 병합 수 */
+    uint64_t node_allocs;               /* 노드 메모리 할당자 호출 수 */
+    uint64_t node_frees;                /* 해제된 노드 수 */
+    uint64_t latency[BTREE_METRIC_OP_COUNT][BTREE_LATENCY_BUCKETS];    /* 나노초 히스토그램 */
+} btree_metrics_t;
+
+/**
+ * @brief 계측 켜기/끄기
+ *
+ * flags는 BTREE_METRICS_* 조합이며 0이면 끄고 누적값을 버린다. 다시 켜면
+ * 0부터 센다. comparisons는 교체 가능한 타입별 검색 커널이 비교 횟수를
+ * 알려 주지 않으므로 노드 키 수로 계산한 이진 검색 비교 수다.
+ */
+btree_result_t btree_enable_metrics(btree_t *tree, uint32_t flags);
+
+/**
+ * @brief 누적 계측값 복사 (켜져 있지 않으면 0으로 채움)
+ *
+ * 락 없이 복사하므로 동시 모드에서는 카운터 사이에 진행 중인 연산 몇 개만큼의
+ * 차이가 있을 수 있다. 외부 수집기는 두 스냅숏의 차이로 구간 값을 구한다.
+ */
+void btree_metrics_snapshot(const btree_t *tree, btree_metrics_t *out);
+void btree_metrics_reset(btree_t *tree);
+
+/**
+ * @brief 히스토그램의 분위수 (0.0 ~ 1.0) 지연 시간 (나노초, 버킷 상한)
+ * @return 기록된 값이 없으면 0
+ */
+uint64_t btree_metrics_percentile(const btree_metrics_t *metrics, btree_metric_op_t op,
+                                  double quantile);
+
+/**
+ * @brief 스냅숏 히스토그램에 지연 시간 (나노초) 하나를 기록
+ *
+ * 트리가 쓰는 것과 같은 버킷에 넣으므로 외부에서 잰 값이나 여러 트리의
+ * 스냅숏을 한 히스토그램으로 합칠 때 쓴다.
+ */
+void btree_metrics_record(btree_metrics_t *metrics, btree_metric_op_t op, uint64_t ns);
+
+/**
+ * @brief 페이지 이미지 직렬화 및 파일 저장소
+ *
+ * 이미지는 버전이 있는 헤더와 노드당 하나의 고정 크기 페이지로 이루어지며
+ * 자식은 페이지 번호로 가리킨다. 헤더에는 차수, 노드 종류별 레이아웃, 키/값
+ * 크기와 타입 이름이 기록되고, 불러올 트리는 같은 키/값 타입으로 초기화된
+ * 빈 트리여야 한다 (차수와 변형은 파일을 따름). 포인터 타입은 저장할 수 없다.
+ *
+ * btree_load_from_file은 파일을 읽기 전용으로 매핑하고 페이지를 그대로
+ * 검색하므로 여는 비용이 파일 크기와 무관하다. 매핑된 트리는 검색만 지원하며
+ * (삽입, 삭제, 반복자는 BTREE_ERROR_INVALID_OPERATION), btree_clear나
+ * btree_cleanup으로 매핑을 해제한다. btree_deserialize는 이미지에서 수정 가능한
+ * 노드를 새로 만든다. 형식, 버전, 체크섬이 맞지 않으면 BTREE_ERROR_CORRUPTED.
+ */
 size_t btree_serialize_size(const btree_t *tree);
 btree_result_t btree_serialize(const btree_t *tree, void *buffer, size_t buffer_size);
 btree_result_t btree_deserialize(btree_t *tree, const void *buffer, size_t buffer_size);
@@ -131,45 +351,288 @@ btree_result_t btree_deserialize(btree_t *tree, const void *buffer, size_t buffe
 btree_result_t btree_save_to_file(const btree_t *tree, const char *filename);
 btree_result_t btree_load_from_file(btree_t *tree, const char *filename);
 
-/* B-Tree 변형 지원 */
-typedef enum {
-    BTREE_VARIANT_STANDARD,             /* 표준 B-Tree */
-    BTREE_VARIANT_PLUS,                 /* B+Tree */
-    BTREE_VARIANT_STAR,                 /* B*Tree */
-    BTREE_VARIANT_CONCURRENT            /* 동시성 B-Tree */
-} btree_variant_t;
+/**
+ * @brief 리프 압축 (압축 이미지와 메모리 안의 차가운 계층)
+ *
+ * btree_set_leaf_compression을 켜면 저장, 직렬화, 체크포인트가 리프를 압축한
+ * 이미지 (형식 버전 2)를 쓴다. 리프의 키, 값, 삭제 표시 배열은 각각 가장 작아지는
+ * 방식으로 압축된다: 정수 크기 (1, 2, 4, 8바이트) 배열은 기준값 + 고정 비트 폭
+ * (FOR)이나 차이값 varint (DELTA), 그 밖의 데이터는 LZ4, 줄지 않으면 그대로.
+ * 내부 노드 페이지는 압축하지 않는다. 압축 이미지를 btree_load_from_file로 열면
+ * 검색이 닿은 리프를 풀어서 작은 캐시 (64개, CLOCK 교체)에 두고 재사용한다.
+ *
+ * btree_freeze는 트리를 압축 이미지로 힙에 옮기고 노드를 해제한다. 이후 트리는
+ * 파일에서 연 트리처럼 읽기 전용이며 (검색, btree_get, 검증만), btree_thaw로
+ * 수정 가능한 노드로 되돌린다. 로그가 붙은 트리는 얼릴 수 없다.
+ *
+ * 압축 트리에서 btree_search가 반환하는 값 포인터는 리프 캐시 칸을 가리키므로
+ * 뒤이은 검색이 그 칸을 교체하면 바뀐다. 여러 스레드에서 검색하거나 포인터를
+ * 오래 쥐어야 하면 값을 캐시 잠금 안에서 복사하는 btree_get을 쓴다.
+ */
+btree_result_t btree_set_leaf_compression(btree_t *tree, bool enable);
+btree_result_t btree_freeze(btree_t *tree);
+btree_result_t btree_thaw(btree_t *tree);
+
+/* 압축 이미지 통계 */
+typedef struct {
+    size_t leaf_count;                  /* 리프 수 */
+    size_t leaf_bytes;                  /* 리프를 비압축 페이지로 둘 때의 크기 */
+    size_t compressed_bytes;            /* 리프 디렉터리와 압축 블롭 크기 */
+    size_t image_bytes;                 /* 이미지 전체 크기 */
+    size_t cache_slots;                 /* 리프 캐시 칸 수 */
+    size_t cache_hits;                  /* 캐시에 있던 리프 접근 */
+    size_t cache_misses;                /* 리프를 풀어야 했던 접근 */
+} btree_compression_stats_t;
 
+bool btree_compression_get_stats(const btree_t *tree, btree_compression_stats_t *stats);
+
+/**
+ * @brief B-Tree 변형 지원 (btree_variant_t는 btree_types.h에 정의)
+ *
+ * 변형은 빈 트리에서만 바꿀 수 있다. BTREE_VARIANT_PLUS는 값을 리프에만
+ * 저장하고 내부 노드에는 구분 키와 자식 포인터만 두므로, 리프와 같은 바이트
+ * 예산으로 더 많은 자식을 가진다. 리프는 next_leaf/prev_leaf로 연결된다.
+ * B+Tree는 중복 키 허용 모드와 함께 쓸 수 없다. BTREE_VARIANT_CONCURRENT는
+ * 표준 노드 구성에 btree_set_thread_safe를 켠 것과 같다.
+ */
 btree_result_t btree_set_variant(btree_t *tree, btree_variant_t variant);
 btree_variant_t btree_get_variant(const btree_t *tree);
 
-/* 성능 최적화 */
-void btree_optimize_layout(btree_t *tree);
-void btree_compact(btree_t *tree);
-void btree_rebuild(btree_t *tree);
+/**
+ * @brief 노드 크기와 노드 내 검색 방식
+ *
+ * btree_degree_for_bytes는 단일 블록 레이아웃의 리프와 내부 노드가 모두
+ * node_bytes 안에 드는 가장 큰 차수를 돌려준다 (variant의 노드 구성 기준,
+ * node_bytes가 0이면 OS 페이지 크기, 한 노드도 안 들어가면
+ * BTREE_MIN_DEGREE). 캐시 몇 줄 (256B)은 검색이, 페이지 크기 (4KB)는 적재와
+ * 범위 순회가 빠르다. btree_set_node_bytes는 빈 트리의 차수를 이 값으로 바꾸고
+ * 이후 변형 변경에도 예산을 유지한다.
+ *
+ * 노드 내 검색은 기본 (BTREE_SEARCH_AUTO)으로 노드 용량과 키 크기에 맞춰
+ * 고른다: 노드가 한 번에 셀 구간보다 작으면 LINEAR, SIMD 커널이 있는 빌드의
+ * 4/8바이트 키면 이진 탐색으로 BTREE_SIMD_SEARCH_BYTES 구간까지 줄인 뒤 벡터
+ * 비교로 세는 SIMD, 그 외에는 BINARY. SIMD를 요청했는데 커널이 없으면
+ * BINARY로 동작한다. btree_get_search_mode는 실제로 쓰는 방식을 돌려준다.
+ * 비교 연산자 대신 compare 함수를 쓰는 키 타입 (문자열 등)은 방식과 관계없이
+ * 이진 탐색이다. 동시 모드 트리는 비어 있을 때만 바꿀 수 있다.
+ */
+int btree_degree_for_bytes(const btree_type_info_t *key_type,
+                           const btree_type_info_t *value_type,
+                           btree_variant_t variant, size_t node_bytes);
+btree_result_t btree_set_node_bytes(btree_t *tree, size_t node_bytes);
+btree_result_t btree_set_search_mode(btree_t *tree, btree_search_mode_t mode);
+btree_search_mode_t btree_get_search_mode(const btree_t *tree);
+
+/**
+ * @brief 노드 재배치 (캐시 지역성)
+ *
+ * 변경이 쌓이면 노드가 반쯤 비고 힙 곳곳에 흩어진다. 재배치는 노드를 새
+ * 아레나(연속된 블록 하나)에 루트부터 순서대로 옮겨 상위 레벨이 몇 개
+ * 페이지에 모이게 하고, 옛 노드는 해제한다. 옮긴 노드는 단일 블록
+ * 레이아웃이 된다. 스냅숏(btree_copy)과 공유하던 노드는 복사하므로 스냅숏은
+ * 그대로 남는다. node_alloc 할당자(디스크)는 아레나 대신 할당자에 이 순서로
+ * 노드를 받는다. 파일을 매핑한 트리에서는 INVALID_OPERATION.
+ *
+ * - btree_optimize_layout: 채움 비율은 그대로 두고 order 순서로 옮긴다.
+ * - btree_rebuild: 살아 있는 키를 fill_factor(btree_set_fill_factor)로 다시
+ *   채운 뒤 BFS 순서로 옮긴다 (삭제 표시된 키는 버림).
+ * - btree_compact_step: 최대 max_nodes개 노드만 처리하고 돌아오는 점진
+ *   재배치. 레벨마다 새 아레나를 만들어 루트 레벨부터 왼쪽에서 오른쪽으로
+ *   옮기고, 합쳐도 fill_factor 이하인 이웃 형제는 병합한다 (부모가 최소 키
+ *   수를 지킬 때만). 다음에 처리할 노드의 첫 키를 커서로 기억하므로 단계
+ *   사이에 삽입과 삭제를 해도 된다. 한 바퀴를 마치면 *done이 true.
+ * - btree_compact: 삭제 표시된 키를 제거하고 btree_compact_step을 끝까지 수행.
+ *
+ * 동시 모드 트리에서는 쓰기 구간 안에서 수행한다 (한 단계씩).
+ */
+typedef enum {
+    BTREE_LAYOUT_BFS = 0,               /* 레벨 순서 (한 레벨의 노드가 키 순서로 이어짐) */
+    BTREE_LAYOUT_VEB                    /* van Emde Boas 순서 (높이 절반씩 서브트리를 모음) */
+} btree_layout_order_t;
+
+btree_result_t btree_optimize_layout(btree_t *tree, btree_layout_order_t order);
+btree_result_t btree_rebuild(btree_t *tree);
+btree_result_t btree_compact_step(btree_t *tree, size_t max_nodes, bool *done);
+btree_result_t btree_compact(btree_t *tree);
+
+/**
+ * 성능 최적화
+ *
+ * btree_set_cache_hint(SEQUENTIAL)은 오른쪽 끝 경로의 마지막 키 뒤로
+ * 삽입해 넘치는 노드를 마지막 키 하나만 떼어 분할한다. 순차 키를 넣으면
+ * 왼쪽 노드가 거의 가득 찬 채 남아 노드 수가 절반 가까이로 준다 (오른쪽
+ * 끝 경로의 노드는 최소 키 수보다 적을 수 있음). 힌트가 없어도 오른쪽 끝
+ * 추가가 연속으로 이어지면 같은 분할로 바꾸고, 다른 곳에 삽입하면 되돌린다.
+ * 다른 힌트는 보통 분할로 되돌린다. 할당 전략은
+ * btree_optimized_allocator_create (btree_memory.h).
+ *
+ * 삽입은 오른쪽 끝 리프를 기억해 두어, 빈 슬롯이 있고 키가 그 리프의
+ * 마지막 키보다 크면 루트부터 내려가지 않고 바로 붙인다.
+ */
 void btree_set_cache_hint(btree_t *tree, btree_alloc_hint_t hint);
 
+/**
+ * @brief NUMA 소켓별 상위 레벨 복제 (BTREE_NUMA_SUPPORT 빌드)
+ *
+ * 루트부터 levels 레벨의 내부 노드 키와 자식 포인터를 NUMA 노드마다 그 노드
+ * 메모리에 복사해 두고, btree_search는 호출한 스레드가 도는 소켓의 복제본부터
+ * 내려간다. 리프의 부모 레벨은 복제하지 않으므로 실제 레벨 수는 높이 - 2
+ * 이하이다 (btree_numa_replicated_levels). 복제된 노드를 바꾸는 쓰기는
+ * 복제본을 무효로 하고, btree_insert와 btree_delete는 끝날 때 다시 만든다.
+ * 다른 쓰기 뒤에는 다음 삽입/삭제나 이 함수를 다시 부를 때까지 원본 루트부터
+ * 검색한다.
+ *
+ * levels가 0이면 복제본을 해제한다. 동시 모드, 스냅숏과 공유하는 트리, 매핑된
+ * 트리, 디스크 할당자 트리와 NUMA 지원 없는 빌드에서는 INVALID_OPERATION.
+ * btree_clear, btree_copy, btree_set_thread_safe(true)는 복제본을 해제한다.
+ * 노드 자체를 소켓별로 두려면 btree_numa_allocator_create (btree_memory.h).
+ */
+btree_result_t btree_numa_replicate(btree_t *tree, int levels);
+int btree_numa_replicated_levels(const btree_t *tree);
+
 /* 배치 연산 */
+
+/**
+ * @brief 키-값 쌍 배열을 일괄 삽입
+ *
+ * 빈 트리에는 상향식으로 적재한다. 입력이 정렬되어 있지 않으면 내부에서
+ * 안정 정렬하며, 리프를 왼쪽부터 fill_factor 비율로 채운 뒤 상위 레벨을
+ * 차례로 구성한다. 키와 값은 타입의 copy 함수로 복사된다.
+ * 비어 있지 않은 트리에는 정렬된 항목을 리프 단위로 병합한다: 한 번
+ * 내려간 리프에 들어가는 뒤따르는 항목을 모아 한 번에 넣으므로 경로 탐색과
+ * 슬롯 이동이 키마다가 아니라 리프마다 일어난다.
+ *
+ * 중복 키는 첫 번째 항목만 유지하며 이 경우 나머지를 적재한 뒤
+ * BTREE_ERROR_DUPLICATE_KEY를 반환한다. 트리에 이미 있는 키도 같다.
+ */
 btree_result_t btree_bulk_insert(btree_t *tree, 
                                 const btree_key_value_pair_t *pairs, 
                                 size_t count);
+
+/**
+ * @brief 키-값 쌍 배열을 일괄 갱신
+ *
+ * btree_bulk_insert와 같은 경로로 병합하되, 트리에 이미 있는 키는 값을
+ * 교체하고 입력 안의 중복 키는 마지막 항목이 이긴다. 중복 키 허용 트리와
+ * 매핑된 트리에서는 BTREE_ERROR_INVALID_OPERATION을 반환한다.
+ */
+btree_result_t btree_batch_upsert(btree_t *tree,
+                                  const btree_key_value_pair_t *pairs,
+                                  size_t count);
+
+/**
+ * @brief 여러 스레드로 나눠 일괄 삽입
+ *
+ * btree_bulk_insert와 같은 결과 (트리 모양까지 같음)를 threads개 스레드로
+ * 만든다 (0이면 온라인 CPU 수). 빈 트리에는 입력을 구간별로 정렬해 병합하고,
+ * 레벨마다 노드를 구간으로 나눠 동시에 만든 뒤 구간 사이의 구분 키로 위 레벨을
+ * 잇는다. 노드는 여러 스레드에서 할당하므로 할당자는 동시 모드에서처럼 스레드
+ * 안전해야 한다 (기본 할당자와 노드 풀은 안전). 비어 있지 않은 트리, 중복 키
+ * 허용 트리와 디스크 할당자 트리는 btree_bulk_insert와 같이 한 스레드로 처리한다.
+ */
+btree_result_t btree_bulk_insert_parallel(btree_t *tree,
+                                          const btree_key_value_pair_t *pairs,
+                                          size_t count, int threads);
+btree_result_t btree_set_fill_factor(btree_t *tree, double fill_factor);
+
+/**
+ * @brief 여러 키를 한 번에 검색
+ *
+ * out_values[i]에 keys[i]의 값 포인터 (btree_search와 같음, 없으면 NULL)를
+ * 기록한다. 여러 검색을 번갈아 진행하며 다음 노드를 미리 프리페치하므로
+ * 키를 하나씩 찾는 것보다 메모리 대기가 겹친다. 큰 배치는 내부에서 키
+ * 순서로 정렬해 처리한다. 동시 모드와 매핑된 트리는 하나씩 검색한다.
+ * @return 찾은 키 수
+ */
+size_t btree_search_batch(btree_t *tree, const void **keys, size_t count, void **out_values);
+
+/**
+ * @brief 키 배열 일괄 삭제
+ *
+ * @return 실제로 삭제된 키 수 (없는 키는 건너뜀)
+ */
 size_t btree_bulk_delete(btree_t *tree, const void **keys, size_t count);
 
-/* 트랜잭션 지원 (기본) */
+/**
+ * @brief 지연 삭제 (삭제 표시) 모드
+ *
+ * 켜져 있으면 btree_delete는 슬롯에 삭제 표시만 하고 병합/재분배를 미룬다.
+ * 표시된 키는 검색되지 않으며 같은 키를 다시 삽입하면 새 값으로 되살아난다.
+ * btree_purge_tombstones나 btree_compact를 호출하면 일괄 제거하고 재균형한다.
+ * 중복 키 허용 트리에서는 BTREE_ERROR_INVALID_OPERATION을 반환한다.
+ */
+btree_result_t btree_set_lazy_delete(btree_t *tree, bool enable);
+size_t btree_purge_tombstones(btree_t *tree);
+
+/**
+ * @brief 트랜잭션과 선행 기록 로그
+ *
+ * 트랜잭션의 삽입/삭제는 트리에 바로 적용되고, 롤백은 적용한 작업을 역순으로
+ * 되돌린다. 트랜잭션 사이의 격리는 없으므로 여러 스레드에서 쓰려면
+ * btree_set_thread_safe를 켜고 서로 다른 키를 다뤄야 한다. 트랜잭션 밖의
+ * 변경은 기록되지 않는다. commit과 rollback은 트랜잭션을 해제한다.
+ *
+ * btree_wal_open은 트리를 filename에 저장하고 "filename.wal" 로그를 새로
+ * 시작한다. 이후 커밋은 재실행 레코드가 로그에 fdatasync된 뒤에 반환하며,
+ * 동시에 커밋하는 트랜잭션은 한 번의 쓰기와 동기화를 함께 쓴다 (그룹 커밋).
+ * btree_checkpoint는 트리를 이미지에 다시 쓰고 로그를 비운다. 이미지를 쓰는
+ * 동안 트리가 멈춰 있어야 하므로 진행 중인 트랜잭션이 있거나 동시 모드가
+ * 켜져 있으면 BTREE_ERROR_INVALID_OPERATION이다 (btree_wal_open도 동시 모드를
+ * 켜기 전에 호출). btree_load_from_file은
+ * 이미지 이후에 커밋된 묶음이 로그에 있으면 노드를 만들어 다시 적용하며,
+ * 쓰다 만 마지막 묶음은 버린다. 포인터 타입은 기록할 수 없고
+ * (BTREE_ERROR_TYPE_MISMATCH), 로그는 POSIX 플랫폼에서만 지원한다.
+ */
 typedef struct btree_transaction btree_transaction_t;
 
 btree_transaction_t* btree_transaction_begin(btree_t *tree);
+btree_result_t btree_transaction_insert(btree_transaction_t *tx, const void *key, const void *value);
+btree_result_t btree_transaction_delete(btree_transaction_t *tx, const void *key);
 btree_result_t btree_transaction_commit(btree_transaction_t *tx);
 btree_result_t btree_transaction_rollback(btree_transaction_t *tx);
 
-/* 콜백 및 이벤트 */
+/* 로그 통계 */
+typedef struct {
+    size_t commits;                     /* 기록된 커밋 수 */
+    size_t syncs;                       /* 로그 동기화 수 (commits 이하) */
+    size_t bytes_written;               /* 로그에 쓴 바이트 수 */
+    size_t checkpoints;                 /* 체크포인트 수 */
+    size_t buffer_capacity;             /* 커밋 대기 버퍼 최대 크기 */
+    uint64_t last_lsn;                  /* 마지막으로 배정한 LSN */
+    uint64_t durable_lsn;               /* 디스크에 내린 마지막 LSN */
+} btree_wal_stats_t;
+
+btree_result_t btree_wal_open(btree_t *tree, const char *filename);
+btree_result_t btree_wal_close(btree_t *tree);
+btree_result_t btree_checkpoint(btree_t *tree);
+bool btree_wal_get_stats(const btree_t *tree, btree_wal_stats_t *stats);
+
+/**
+ * @brief 이벤트 훅
+ *
+ * 구독이 하나도 없으면 트리는 이벤트 상태를 갖지 않고, 연산마다 드는 비용은
+ * NULL 검사 하나다. 이벤트는 연산이 성공한 뒤에만 보낸다:
+ * - INSERT: 새 키 삽입, 되살림, 일괄 갱신의 값 교체 (key, value는 입력)
+ * - DELETE: 키 삭제 (value는 NULL)
+ * - SEARCH: 검색 (value는 찾은 값 포인터, 없으면 NULL)
+ * - SPLIT: 노드 분할 (key는 부모로 올라간 구분 키, value는 NULL)
+ * - MERGE: 노드 병합 (key는 병합 직전의 구분 키, value는 NULL)
+ * 콜백은 연산 도중 (SPLIT/MERGE는 구조 변경 도중) 불리므로 같은 트리를
+ * 수정하면 안 된다. 동시 모드에서는 연산을 수행한 스레드에서 불린다.
+ * 구독 등록과 해제는 트리를 다른 스레드와 공유하기 전에 한다.
+ */
 typedef enum {
     BTREE_EVENT_INSERT,
     BTREE_EVENT_DELETE,
     BTREE_EVENT_SEARCH,
     BTREE_EVENT_SPLIT,
-    BTREE_EVENT_MERGE
+    BTREE_EVENT_MERGE,
+    BTREE_EVENT_COUNT
 } btree_event_type_t;
 
+#define BTREE_EVENT_MASK(event)     (1u << (event))
+#define BTREE_EVENT_MASK_ALL        ((1u << BTREE_EVENT_COUNT) - 1)
+
 typedef void (*btree_event_callback_t)(btree_t *tree, btree_event_type_t event,
                                       const void *key, const void *value, 
                                       void *context);
@@ -178,6 +641,35 @@ btree_result_t btree_set_event_callback(btree_t *tree, btree_event_type_t event,
                                        btree_event_callback_t callback, void *context);
 btree_result_t btree_remove_event_callback(btree_t *tree, btree_event_type_t event);
 
+/* 묶음으로 전달되는 이벤트 (키와 값은 버퍼 안의 바이트 사본) */
+typedef struct {
+    btree_event_type_t type;
+    uint64_t sequence;                  /* 트리별 일련번호 (1부터) */
+    const void *key;                    /* key_size 바이트 사본 */
+    const void *value;                  /* value_size 바이트 사본 (없으면 NULL) */
+} btree_event_record_t;
+
+typedef void (*btree_event_batch_callback_t)(btree_t *tree, const btree_event_record_t *events,
+                                             size_t count, void *context);
+
+/**
+ * @brief 이벤트 묶음 버퍼 설정
+ *
+ * mask (BTREE_EVENT_MASK 조합)에 든 이벤트를 연산마다 함수로 부르지 않고
+ * capacity개 레코드 버퍼에 쌓았다가, 버퍼가 차거나 btree_flush_events를 부르면
+ * callback에 한 번에 넘긴다. 키와 값은 바이트 그대로 복사하므로 포인터를 담는
+ * 타입은 얕은 사본이다. 레코드는 callback이 반환하면 재사용된다.
+ * mask가 0이거나 callback이 NULL이면 남은 이벤트를 보내고 버퍼를 없앤다.
+ */
+btree_result_t btree_set_event_buffer(btree_t *tree, uint32_t mask, size_t capacity,
+                                      btree_event_batch_callback_t callback, void *context);
+
+/**
+ * @brief 버퍼에 쌓인 이벤트를 바로 전달
+ * @return 전달한 이벤트 수
+ */
+size_t btree_flush_events(btree_t *tree);
+
 /* 라이브러리 초기화 및 정리 */
 btree_result_t btree_library_init(void);
 void btree_library_cleanup(void);
@@ -186,7 +678,19 @@ int btree_version_major(void);
 int btree_version_minor(void);
 int btree_version_patch(void);
 
-/* 오류 처리 */
+/**
+ * @brief 오류 처리
+ *
+ * 마지막 오류는 스레드마다 따로 기록되므로 btree_get_last_error는 호출한
+ * 스레드가 마지막으로 실패한 연산의 결과를 돌려준다. 성공한 연산은 이 값을
+ * 지우지 않고 (검색이 키를 찾으면 아무것도 쓰지 않음), btree_lookup은 없는
+ * 키도 기록하지 않는다.
+ *
+ * btree_set_error_handler로 등록한 처리기는 오류가 기록될 때마다 그 스레드에서
+ * btree_error_string 메시지와 함께 불린다. 없는 키 (BTREE_ERROR_KEY_NOT_FOUND)는
+ * 오류라기보다 검색 결과이므로 처리기에 보내지 않는다. 처리기는 프로세스에
+ * 하나이고, NULL을 넘기면 해제한다.
+ */
 const char* btree_error_string(btree_result_t error);
 btree_result_t btree_get_last_error(void);
 void btree_set_error_handler(void (*handler)(btree_result_t error, const char *message));
@@ -223,6 +727,28 @@ void btree_set_error_handler(void (*handler)(btree_result_t error, const char *m
     BTREE_DEFINE(char*, char*, suffix, string, string) \
     BTREE_DEFINE_DEBUG_OPS(char*, suffix, "%s")
 
+/**
+ * @brief 인라인 문자열 키 B-Tree를 위한 편의 매크로
+ *
+ * 키는 btree_strkey_t (btree_generic.h)로, 짧은 문자열은 노드 안에 그대로
+ * 저장되어 할당과 포인터 추적이 없다. 값 타입은 VALUE_OPS_SUFFIX 연산을 쓴다.
+ *
+ * @code
+ * BTREE_DECLARE_STRKEY(urls, int)
+ * BTREE_DEFINE_STRKEY(urls, int, int)
+ *
+ * btree_urls_insert(tree, btree_strkey("/index.html"), 1);
+ * int *hits = btree_urls_search(tree, btree_strkey("/index.html"));
+ * @endcode
+ */
+#define BTREE_DECLARE_STRKEY(suffix, VALUE_TYPE) \
+    BTREE_DECLARE(btree_strkey_t, VALUE_TYPE, suffix)
+
+#define BTREE_DEFINE_STRKEY(suffix, VALUE_TYPE, VALUE_OPS_SUFFIX) \
+    BTREE_DEFINE_EX(btree_strkey_t, VALUE_TYPE, suffix, strkey, VALUE_OPS_SUFFIX, \
+                    btree_destroy_strkey, NULL, btree_validate_strkey) \
+    BTREE_DEFINE_DEBUG_OPS(btree_strkey_t, suffix, "%s")
+
 /**
  * @brief 포인터 B-Tree를 위한 편의 매크로
  */
@@ -5,6 +5,19 @@
 #include <string.h>
 #include <stdlib.h>
 
+#if defined(__GNUC__) || defined(__clang__)
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define BTREE_SIMD_AVX2 1
+    #elif defined(__SSE4_2__)
+        #include <nmmintrin.h>
+        #define BTREE_SIMD_SSE42 1
+    #elif defined(__ARM_NEON) && defined(__aarch64__)
+        #include <arm_neon.h>
+        #define BTREE_SIMD_NEON 1
+    #endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -45,12 +58,233 @@ extern "C" {
         } \
     }
 
+/*
+ * SIMD 카운트 커널: keys 앞쪽의 벡터 폭 단위 구간에서 x보다 작은 원소 수를 센다.
+ * 처리한 원소 수는 *done에 기록하며 나머지는 호출자가 스칼라로 처리한다.
+ * SIMD를 사용할 수 없는 빌드에서는 아무것도 처리하지 않는다.
+ */
+BTREE_INLINE int btree_simd_count_less_i32(const void *keys, int len, int32_t x, int *done) {
+    const int32_t *base = (const int32_t *)keys;
+    int count = 0, i = 0;
+#if defined(BTREE_SIMD_AVX2)
+    __m256i vx = _mm256_set1_epi32(x);
+    for (; i + 8 <= len; i += 8) {
+        __m256i lt = _mm256_cmpgt_epi32(vx, _mm256_loadu_si256((const __m256i *)(base + i)));
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+    }
+#elif defined(BTREE_SIMD_SSE42)
+    __m128i vx = _mm_set1_epi32(x);
+    for (; i + 4 <= len; i += 4) {
+        __m128i lt = _mm_cmpgt_epi32(vx, _mm_loadu_si128((const __m128i *)(base + i)));
+        count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(lt)));
+    }
+#elif defined(BTREE_SIMD_NEON)
+    int32x4_t vx = vdupq_n_s32(x);
+    for (; i + 4 <= len; i += 4) {
+        count += (int)vaddvq_u32(vshrq_n_u32(vcltq_s32(vld1q_s32(base + i), vx), 31));
+    }
+#else
+    (void)base; (void)len; (void)x;
+#endif
+    *done = i;
+    return count;
+}
+
+BTREE_INLINE int btree_simd_count_less_i64(const void *keys, int len, int64_t x, int *done) {
+    const int64_t *base = (const int64_t *)keys;
+    int count = 0, i = 0;
+#if defined(BTREE_SIMD_AVX2)
+    __m256i vx = _mm256_set1_epi64x(x);
+    for (; i + 4 <= len; i += 4) {
+        __m256i lt = _mm256_cmpgt_epi64(vx, _mm256_loadu_si256((const __m256i *)(base + i)));
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+    }
+#elif defined(BTREE_SIMD_SSE42)
+    __m128i vx = _mm_set1_epi64x(x);
+    for (; i + 2 <= len; i += 2) {
+        __m128i lt = _mm_cmpgt_epi64(vx, _mm_loadu_si128((const __m128i *)(base + i)));
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(lt)));
+    }
+#elif defined(BTREE_SIMD_NEON)
+    int64x2_t vx = vdupq_n_s64(x);
+    for (; i + 2 <= len; i += 2) {
+        count += (int)vaddvq_u64(vshrq_n_u64(vcltq_s64(vld1q_s64(base + i), vx), 63));
+    }
+#else
+    (void)base; (void)len; (void)x;
+#endif
+    *done = i;
+    return count;
+}
+
+/*
+ * 부호 없는 정수: x86에는 부호 없는 비교가 없으므로 양쪽의 부호 비트를 뒤집어
+ * (XOR 0x80...0) 부호 있는 비교로 바꾼다. 2^31, 2^63 경계의 순서가 그대로 유지된다.
+ */
+BTREE_INLINE int btree_simd_count_less_u32(const void *keys, int len, uint32_t x, int *done) {
+    const uint32_t *base = (const uint32_t *)keys;
+    int count = 0, i = 0;
+#if defined(BTREE_SIMD_AVX2)
+    __m256i bias = _mm256_set1_epi32(INT32_MIN);
+    __m256i vx = _mm256_xor_si256(_mm256_set1_epi32((int32_t)x), bias);
+    for (; i + 8 <= len; i += 8) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(base + i)), bias);
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vx, v))));
+    }
+#elif defined(BTREE_SIMD_SSE42)
+    __m128i bias = _mm_set1_epi32(INT32_MIN);
+    __m128i vx = _mm_xor_si128(_mm_set1_epi32((int32_t)x), bias);
+    for (; i + 4 <= len; i += 4) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(base + i)), bias);
+        count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(vx, v))));
+    }
+#elif defined(BTREE_SIMD_NEON)
+    uint32x4_t vx = vdupq_n_u32(x);
+    for (; i + 4 <= len; i += 4) {
+        count += (int)vaddvq_u32(vshrq_n_u32(vcltq_u32(vld1q_u32(base + i), vx), 31));
+    }
+#else
+    (void)base; (void)len; (void)x;
+#endif
+    *done = i;
+    return count;
+}
+
+BTREE_INLINE int btree_simd_count_less_u64(const void *keys, int len, uint64_t x, int *done) {
+    const uint64_t *base = (const uint64_t *)keys;
+    int count = 0, i = 0;
+#if defined(BTREE_SIMD_AVX2)
+    __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    __m256i vx = _mm256_xor_si256(_mm256_set1_epi64x((int64_t)x), bias);
+    for (; i + 4 <= len; i += 4) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(base + i)), bias);
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vx, v))));
+    }
+#elif defined(BTREE_SIMD_SSE42)
+    __m128i bias = _mm_set1_epi64x(INT64_MIN);
+    __m128i vx = _mm_xor_si128(_mm_set1_epi64x((int64_t)x), bias);
+    for (; i + 2 <= len; i += 2) {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(base + i)), bias);
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(vx, v))));
+    }
+#elif defined(BTREE_SIMD_NEON)
+    uint64x2_t vx = vdupq_n_u64(x);
+    for (; i + 2 <= len; i += 2) {
+        count += (int)vaddvq_u64(vshrq_n_u64(vcltq_u64(vld1q_u64(base + i), vx), 63));
+    }
+#else
+    (void)base; (void)len; (void)x;
+#endif
+    *done = i;
+    return count;
+}
+
+BTREE_INLINE int btree_simd_count_less_f64(const void *keys, int len, double x, int *done) {
+    const double *base = (const double *)keys;
+    int count = 0, i = 0;
+#if defined(BTREE_SIMD_AVX2)
+    __m256d vx = _mm256_set1_pd(x);
+    for (; i + 4 <= len; i += 4) {
+        __m256d lt = _mm256_cmp_pd(_mm256_loadu_pd(base + i), vx, _CMP_LT_OQ);
+        count += __builtin_popcount(_mm256_movemask_pd(lt));
+    }
+#elif defined(BTREE_SIMD_SSE42)
+    __m128d vx = _mm_set1_pd(x);
+    for (; i + 2 <= len; i += 2) {
+        count += __builtin_popcount(_mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(base + i), vx)));
+    }
+#elif defined(BTREE_SIMD_NEON)
+    float64x2_t vx = vdupq_n_f64(x);
+    for (; i + 2 <= len; i += 2) {
+        count += (int)vaddvq_u64(vshrq_n_u64(vcltq_f64(vld1q_f64(base + i), vx), 63));
+    }
+#else
+    (void)base; (void)len; (void)x;
+#endif
+    *done = i;
+    return count;
+}
+
+/* 산술 타입 특성 (컴파일 타임 상수로 접힘) */
+#define BTREE_TYPE_IS_INTEGER(type)  ((type)0.5 == (type)0)
+#define BTREE_TYPE_IS_SIGNED(type)   ((type)-1 < (type)1)
+
+/**
+ * 비교 연산자를 쓰는 타입의 노드 내 검색 함수 생성 매크로
+ *
+ * 분기 없는 이진 탐색으로 구간을 linear_threshold 이하로 줄인 뒤 x보다 작은
+ * 원소 수를 센다. 32/64비트 정수 (부호 있는/없는)와 double은 SIMD 커널을 먼저 쓰고,
+ * 나머지 원소는 컴파일러가 벡터화할 수 있는 스칼라 루프로 센다.
+ * compare 함수 포인터는 호출하지 않는다.
+ */
+#define BTREE_DEFINE_SEARCH(type, suffix) \
+    BTREE_INLINE int btree_search_##suffix(const void *keys, int count, const void *key, \
+                                           int linear_threshold) { \
+        const type *k = (const type *)keys; \
+        const type x = *(const type *)key; \
+        const type *base = k; \
+        int len = count; \
+        if (linear_threshold < 1) linear_threshold = 1; \
+        while (len > linear_threshold) { \
+            int half = len >> 1; \
+            base = (base[half - 1] < x) ? base + half : base; \
+            len -= half; \
+        } \
+        int less = 0, done = 0; \
+        if (BTREE_TYPE_IS_INTEGER(type) && BTREE_TYPE_IS_SIGNED(type) && sizeof(type) == 4) { \
+            less = btree_simd_count_less_i32(base, len, (int32_t)x, &done); \
+        } else if (BTREE_TYPE_IS_INTEGER(type) && BTREE_TYPE_IS_SIGNED(type) && sizeof(type) == 8) { \
+            less = btree_simd_count_less_i64(base, len, (int64_t)x, &done); \
+        } else if (BTREE_TYPE_IS_INTEGER(type) && sizeof(type) == 4) { \
+            less = btree_simd_count_less_u32(base, len, (uint32_t)x, &done); \
+        } else if (BTREE_TYPE_IS_INTEGER(type) && sizeof(type) == 8) { \
+            less = btree_simd_count_less_u64(base, len, (uint64_t)x, &done); \
+        } else if (!BTREE_TYPE_IS_INTEGER(type) && sizeof(type) == sizeof(double)) { \
+            less = btree_simd_count_less_f64(base, len, (double)x, &done); \
+        } \
+        for (int i = done; i < len; i++) { \
+            less += base[i] < x; \
+        } \
+        int idx = (int)(base - k) + less; \
+        return (idx < count && !(x < k[idx])) ? idx : -(idx + 1); \
+    }
+
+/**
+ * 타입의 비교 함수를 직접 (인라인으로) 호출하는 이진 검색 생성 매크로
+ *
+ * 연산자로 비교할 수 없는 문자열, 포인터 타입용이다.
+ */
+#define BTREE_DEFINE_BINARY_SEARCH(type, suffix) \
+    BTREE_INLINE int btree_search_##suffix(const void *keys, int count, const void *key, \
+                                           int linear_threshold) { \
+        const type *k = (const type *)keys; \
+        int left = 0, right = count - 1; \
+        (void)linear_threshold; \
+        while (left <= right) { \
+            int mid = (left + right) >> 1; \
+            int cmp = btree_compare_##suffix(key, &k[mid]); \
+            if (cmp == 0) return mid; \
+            if (cmp < 0) right = mid - 1; else left = mid + 1; \
+        } \
+        return -(left + 1); \
+    }
+
+/* 바이트 순서와 키 순서가 다른 타입 (접두사 검색 불가) */
+#define BTREE_DEFINE_NO_BYTES(suffix) \
+    BTREE_INLINE const void* btree_bytes_##suffix(const void *key, size_t *length) { \
+        (void)key; \
+        *length = 0; \
+        return NULL; \
+    }
+
 /* 모든 기본 연산을 한번에 정의하는 매크로 */
 #define BTREE_DEFINE_BASIC_OPS(type, suffix) \
     BTREE_DEFINE_COMPARE(type, suffix) \
     BTREE_DEFINE_COPY(type, suffix) \
     BTREE_DEFINE_MOVE(type, suffix) \
-    BTREE_DEFINE_SWAP(type, suffix)
+    BTREE_DEFINE_SWAP(type, suffix) \
+    BTREE_DEFINE_SEARCH(type, suffix) \
+    BTREE_DEFINE_NO_BYTES(suffix)
 
 /* 숫자 타입에 대한 특화 연산 */
 #define BTREE_DEFINE_NUMERIC_OPS(type, suffix, format_spec) \
@@ -73,6 +307,9 @@ extern "C" {
         return compare_func(*pa, *pb); \
     } \
     \
+    BTREE_DEFINE_BINARY_SEARCH(pointed_type*, suffix) \
+    BTREE_DEFINE_NO_BYTES(suffix) \
+    \
     BTREE_INLINE void btree_copy_##suffix(void *dest, const void *src, size_t count) { \
         pointed_type **d = (pointed_type**)dest; \
         const pointed_type * const *s = (const pointed_type * const *)src; \
@@ -101,6 +338,8 @@ extern "C" {
         return strcmp(*sa, *sb); \
     } \
     \
+    BTREE_DEFINE_BINARY_SEARCH(char*, suffix) \
+    \
     BTREE_INLINE void btree_copy_##suffix(void *dest, const void *src, size_t count) { \
         char **d = (char**)dest; \
         const char * const *s = (const char * const *)src; \
@@ -109,6 +348,8 @@ extern "C" {
         } \
     } \
     \
+    BTREE_DEFINE_MOVE(char*, suffix) \
+    \
     BTREE_INLINE void btree_destroy_##suffix(void *ptr, size_t count) { \
         char **p = (char**)ptr; \
         for (size_t i = 0; i < count; i++) { \
@@ -124,7 +365,157 @@ extern "C" {
             const char * const *s = (const char * const *)ptr; \
             fprintf(output, "\"%s\"", *s ? *s : "(null)"); \
         } \
+    } \
+    \
+    BTREE_INLINE const void* btree_bytes_##suffix(const void *key, size_t *length) { \
+        const char *s = *(const char * const *)key; \
+        *length = strlen(s); \
+        return s; \
+    }
+
+/*
+ * 인라인 문자열 키 (btree_strkey_t)
+ *
+ * 키 슬롯에 앞 8바이트를 빅 엔디언 정수로 정규화한 prefix, 길이, 그리고
+ * BTREE_STRKEY_INLINE 바이트 이하의 문자열 자체를 담는다. 더 긴 문자열은
+ * 슬롯에 복사본 포인터를 둔다. 비교는 대부분 prefix 정수 비교로 끝나고,
+ * prefix가 같을 때만 나머지 바이트를 memcmp한다 (바이트 사전순, 짧은 쪽이 앞).
+ *
+ * btree_strkey / btree_strkey_n으로 만든 검색용 키는 긴 문자열을 복사하지 않고
+ * 가리키기만 하며, 트리에 삽입될 때 copy 함수가 소유 복사본을 만든다.
+ * 슬롯 크기 (12 + BTREE_STRKEY_INLINE)는 8의 배수여야 한다.
+ */
+#ifndef BTREE_STRKEY_INLINE
+#define BTREE_STRKEY_INLINE 20
+#endif
+
+/* 긴 문자열 복사본 할당 함수 (free로 해제할 수 있어야 함) */
+#ifndef BTREE_STRKEY_ALLOC
+#define BTREE_STRKEY_ALLOC malloc
+#endif
+
+#define BTREE_STRKEY_OWNED   0x80000000u    /* 긴 문자열 복사본을 슬롯이 소유 */
+#define BTREE_STRKEY_MAX_LENGTH 0x7fffffffu
+
+typedef struct {
+    uint64_t prefix;                    /* 앞 8바이트 (빅 엔디언, 0으로 채움) */
+    uint32_t length;                    /* 바이트 길이 | BTREE_STRKEY_OWNED */
+    char data[BTREE_STRKEY_INLINE];     /* 짧은 문자열 또는 긴 문자열 포인터 */
+} btree_strkey_t;
+
+BTREE_INLINE size_t btree_strkey_length(const btree_strkey_t *k) {
+    return k->length & BTREE_STRKEY_MAX_LENGTH;
+}
+
+/* 문자열 바이트 (길이가 BTREE_STRKEY_INLINE 미만이면 NUL로 끝남) */
+BTREE_INLINE const char* btree_strkey_data(const btree_strkey_t *k) {
+    if (btree_strkey_length(k) <= BTREE_STRKEY_INLINE) return k->data;
+    const char *p;
+    memcpy(&p, k->data, sizeof(p));
+    return p;
+}
+
+BTREE_INLINE btree_strkey_t btree_strkey_n(const char *s, size_t length) {
+    btree_strkey_t k;
+    memset(&k, 0, sizeof(k));
+    if (length > BTREE_STRKEY_MAX_LENGTH) length = BTREE_STRKEY_MAX_LENGTH;
+    for (size_t i = 0; i < 8; i++) {
+        k.prefix = (k.prefix << 8) | (i < length ? (unsigned char)s[i] : 0);
+    }
+    k.length = (uint32_t)length;
+    if (length <= BTREE_STRKEY_INLINE) {
+        memcpy(k.data, s, length);
+    } else {
+        memcpy(k.data, &s, sizeof(s));
     }
+    return k;
+}
+
+BTREE_INLINE btree_strkey_t btree_strkey(const char *s) {
+    return btree_strkey_n(s, strlen(s));
+}
+
+BTREE_INLINE int btree_compare_strkey(const void *a, const void *b) {
+    const btree_strkey_t *ka = (const btree_strkey_t *)a;
+    const btree_strkey_t *kb = (const btree_strkey_t *)b;
+    if (ka->prefix != kb->prefix) return ka->prefix < kb->prefix ? -1 : 1;
+
+    size_t la = btree_strkey_length(ka), lb = btree_strkey_length(kb);
+    size_t common = la < lb ? la : lb;
+    if (common > 8) {
+        int cmp = memcmp(btree_strkey_data(ka) + 8, btree_strkey_data(kb) + 8, common - 8);
+        if (cmp != 0) return cmp;
+    }
+    return (la > lb) - (la < lb);
+}
+
+/* prefix 정수 비교로 범위를 좁히고 prefix가 같은 구간에서만 전체 비교 */
+BTREE_INLINE int btree_search_strkey(const void *keys, int count, const void *key,
+                                     int linear_threshold) {
+    const btree_strkey_t *k = (const btree_strkey_t *)keys;
+    const btree_strkey_t *x = (const btree_strkey_t *)key;
+    int left = 0, right = count;
+    (void)linear_threshold;
+    while (left < right) {
+        int mid = (left + right) >> 1;
+        int cmp = (k[mid].prefix != x->prefix) ? (k[mid].prefix < x->prefix ? -1 : 1)
+                                                 : btree_compare_strkey(&k[mid], x);
+        if (cmp == 0) return mid;
+        if (cmp < 0) left = mid + 1; else right = mid;
+    }
+    return -(left + 1);
+}
+
+/* 긴 문자열 복사본을 할당하지 못하면 소유 표시 없이 NULL 포인터를 남긴다 */
+BTREE_INLINE void btree_copy_strkey(void *dest, const void *src, size_t count) {
+    btree_strkey_t *d = (btree_strkey_t *)dest;
+    const btree_strkey_t *s = (const btree_strkey_t *)src;
+    for (size_t i = 0; i < count; i++) {
+        d[i] = s[i];
+        size_t length = btree_strkey_length(&s[i]);
+        if (length > BTREE_STRKEY_INLINE) {
+            char *copy = BTREE_STRKEY_ALLOC(length);
+            memcpy(d[i].data, &copy, sizeof(copy));
+            d[i].length = (uint32_t)length;
+            if (copy) {
+                memcpy(copy, btree_strkey_data(&s[i]), length);
+                d[i].length |= BTREE_STRKEY_OWNED;
+            }
+        }
+    }
+}
+
+/* 복사 실패 검사: 긴 문자열인데 포인터가 NULL이면 유효하지 않은 키 */
+BTREE_INLINE bool btree_validate_strkey(const void *ptr) {
+    const btree_strkey_t *k = (const btree_strkey_t *)ptr;
+    return btree_strkey_length(k) <= BTREE_STRKEY_INLINE || btree_strkey_data(k) != NULL;
+}
+
+BTREE_DEFINE_MOVE(btree_strkey_t, strkey)
+
+BTREE_INLINE void btree_destroy_strkey(void *ptr, size_t count) {
+    btree_strkey_t *p = (btree_strkey_t *)ptr;
+    for (size_t i = 0; i < count; i++) {
+        if (p[i].length & BTREE_STRKEY_OWNED) {
+            free((void*)btree_strkey_data(&p[i]));
+            p[i].length &= BTREE_STRKEY_MAX_LENGTH;
+            memset(p[i].data, 0, sizeof(void*));
+        }
+    }
+}
+
+BTREE_INLINE const void* btree_bytes_strkey(const void *key, size_t *length) {
+    const btree_strkey_t *k = (const btree_strkey_t *)key;
+    *length = btree_strkey_length(k);
+    return btree_strkey_data(k);
+}
+
+BTREE_INLINE void btree_print_strkey(const void *ptr, FILE *output) {
+    if (ptr && output) {
+        const btree_strkey_t *k = (const btree_strkey_t *)ptr;
+        fprintf(output, "\"%.*s\"", (int)btree_strkey_length(k), btree_strkey_data(k));
+    }
+}
 
 /* 타입별 B-Tree 구조체 선언 매크로 */
 #define BTREE_DECLARE(KEY_TYPE, VALUE_TYPE, SUFFIX) \
@@ -168,29 +559,42 @@ extern "C" {
 
 /* 타입별 함수 구현 생성 매크로 */
 #define BTREE_DEFINE(KEY_TYPE, VALUE_TYPE, SUFFIX, KEY_OPS_SUFFIX, VALUE_OPS_SUFFIX) \
+    BTREE_DEFINE_EX(KEY_TYPE, VALUE_TYPE, SUFFIX, KEY_OPS_SUFFIX, VALUE_OPS_SUFFIX, NULL, NULL, NULL)
+
+/*
+ * 키/값 소멸 함수를 지정하는 구현 생성 매크로 (슬롯 밖의 메모리를 소유하는 타입용)
+ *
+ * KEY_VALIDATE는 복사된 키가 온전한지 검사하며, 삽입은 키 복사가 실패하면
+ * 노드를 건드리지 않고 BTREE_ERROR_MEMORY_ALLOCATION을 반환한다.
+ */
+#define BTREE_DEFINE_EX(KEY_TYPE, VALUE_TYPE, SUFFIX, KEY_OPS_SUFFIX, VALUE_OPS_SUFFIX, \
+                        KEY_DESTROY, VALUE_DESTROY, KEY_VALIDATE) \
     /* 타입 정보 초기화 함수 */ \
     static btree_type_info_t btree_##SUFFIX##_key_type_info = { \
         .key_size = sizeof(KEY_TYPE), \
         .value_size = 0, \
-        .alignment = _Alignof(KEY_TYPE), \
+        .alignment = BTREE_ALIGNOF(KEY_TYPE), \
         .type_name = #KEY_TYPE, \
         .type_id = BTREE_TYPE_ID(KEY_TYPE), \
         .compare = btree_compare_##KEY_OPS_SUFFIX, \
         .copy = (btree_copy_func_t)btree_copy_##KEY_OPS_SUFFIX, \
         .move = (btree_copy_func_t)btree_move_##KEY_OPS_SUFFIX, \
-        .destroy = NULL \
+        .destroy = KEY_DESTROY, \
+        .validate = KEY_VALIDATE, \
+        .search = btree_search_##KEY_OPS_SUFFIX, \
+        .bytes = btree_bytes_##KEY_OPS_SUFFIX \
     }; \
     \
     static btree_type_info_t btree_##SUFFIX##_value_type_info = { \
         .key_size = 0, \
         .value_size = sizeof(VALUE_TYPE), \
-        .alignment = _Alignof(VALUE_TYPE), \
+        .alignment = BTREE_ALIGNOF(VALUE_TYPE), \
         .type_name = #VALUE_TYPE, \
         .type_id = BTREE_TYPE_ID(VALUE_TYPE), \
         .compare = btree_compare_##VALUE_OPS_SUFFIX, \
         .copy = (btree_copy_func_t)btree_copy_##VALUE_OPS_SUFFIX, \
         .move = (btree_copy_func_t)btree_move_##VALUE_OPS_SUFFIX, \
-        .destroy = NULL \
+        .destroy = VALUE_DESTROY \
     }; \
     \
     /* 생성 함수 */ \
@@ -252,13 +656,46 @@ extern "C" {
     } \
     \
     bool btree_##SUFFIX##_is_empty(btree_##SUFFIX##_t *tree) { \
-        return tree ? (tree->base.root == NULL) : true; \
+        return tree ? btree_is_empty(&tree->base) : true; \
     } \
     \
     void btree_##SUFFIX##_clear(btree_##SUFFIX##_t *tree) { \
         if (tree) { \
             btree_clear(&tree->base); \
         } \
+    } \
+    \
+    /* 반복자 함수 (현재 항목은 current_key/current_value에 복사) */ \
+    btree_##SUFFIX##_iterator_t* btree_##SUFFIX##_iterator_create(btree_##SUFFIX##_t *tree) { \
+        if (BTREE_UNLIKELY(!tree)) return NULL; \
+        btree_##SUFFIX##_iterator_t *iter = malloc(sizeof(btree_##SUFFIX##_iterator_t)); \
+        if (BTREE_UNLIKELY(!iter)) return NULL; \
+        btree_iterator_init(&iter->base, &tree->base, NULL, NULL); \
+        return iter; \
+    } \
+    \
+    bool btree_##SUFFIX##_iterator_next(btree_##SUFFIX##_iterator_t *iter, KEY_TYPE *key, VALUE_TYPE *value) { \
+        void *k, *v; \
+        if (BTREE_UNLIKELY(!iter) || !btree_iterator_next(&iter->base, &k, &v)) return false; \
+        iter->current_key = *(KEY_TYPE*)k; \
+        iter->current_value = *(VALUE_TYPE*)v; \
+        if (key) *key = iter->current_key; \
+        if (value) *value = iter->current_value; \
+        return true; \
+    } \
+    \
+    bool btree_##SUFFIX##_iterator_prev(btree_##SUFFIX##_iterator_t *iter, KEY_TYPE *key, VALUE_TYPE *value) { \
+        void *k, *v; \
+        if (BTREE_UNLIKELY(!iter) || !btree_iterator_prev(&iter->base, &k, &v)) return false; \
+        iter->current_key = *(KEY_TYPE*)k; \
+        iter->current_value = *(VALUE_TYPE*)v; \
+        if (key) *key = iter->current_key; \
+        if (value) *value = iter->current_value; \
+        return true; \
+    } \
+    \
+    void btree_##SUFFIX##_iterator_destroy(btree_##SUFFIX##_iterator_t *iter) { \
+        free(iter); \
     }
 
 /* 컴파일 타임 최적화를 위한 매크로 */
@@ -357,6 +794,8 @@ BTREE_INLINE int btree_compare_ptr(const void *a, const void *b) {
 BTREE_DEFINE_COPY(void*, ptr)
 BTREE_DEFINE_MOVE(void*, ptr)
 BTREE_DEFINE_SWAP(void*, ptr)
+BTREE_DEFINE_BINARY_SEARCH(void*, ptr)
+BTREE_DEFINE_NO_BYTES(ptr)
 
 #ifdef __cplusplus
 }
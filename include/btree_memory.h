@@ -19,7 +19,10 @@ extern "C" {
 #define BTREE_MIN_POOL_SIZE            (64 * 1024)    /* 64KB */
 #define BTREE_MAX_POOL_SIZE            (64 * 1024 * 1024) /* 64MB */
 #define BTREE_POOL_ALIGNMENT           64
-#define BTREE_MAX_POOLS                8
+#define BTREE_MAX_POOLS                32             /* 매니저의 크기 클래스 수 */
+#define BTREE_SLAB_SHIFT               20             /* 슬랩 정렬/페이지 맵 단위 (1MB) */
+#define BTREE_POOL_MAGAZINES           16             /* 풀당 스레드 캐시 슬롯 수 */
+#define BTREE_POOL_MAGAZINE_SIZE       32             /* 캐시당 최대 블록 수 */
 
 /* 메모리 풀 통계 구조체 */
 typedef struct {
@@ -36,6 +39,18 @@ typedef struct {
     double fragmentation_ratio;         /* 단편화 비율 */
 } btree_pool_stats_t;
 
+/* 스레드별 블록 캐시 (매거진)
+ * 스레드는 슬롯 번호로 매거진을 고르며, 같은 슬롯을 쓰는 스레드가 드물게
+ * 겹칠 때만 lock에서 경합한다. 카운터는 읽을 때 모든 매거진을 합산한다. */
+typedef struct {
+    atomic_flag lock;                   /* 매거진 락 */
+    uint32_t count;                     /* 캐시된 블록 수 */
+    size_t alloc_count;                 /* 이 매거진을 거친 할당 수 */
+    size_t free_count;                  /* 이 매거진을 거친 해제 수 */
+    void *blocks[BTREE_POOL_MAGAZINE_SIZE];
+    char padding[BTREE_CACHE_LINE_SIZE]; /* 인접 매거진 헤더와 캐시 라인 분리 */
+} btree_pool_magazine_t;
+
 /* 메모리 풀 구조체 */
 typedef struct btree_memory_pool {
     /* 풀 기본 정보 */
@@ -45,22 +60,28 @@ typedef struct btree_memory_pool {
     size_t total_blocks;                /* 전체 블록 수 */
     size_t alignment;                   /* 메모리 정렬 */
     
-    /* 자유 블록 관리 */
-    void **free_list;                   /* 자유 블록 리스트 */
-    size_t free_count;                  /* 자유 블록 수 */
-    void *next_free;                    /* 다음 자유 블록 */
+    /* 자유 블록 관리 (자유 블록은 첫 워드에 다음 블록 링크를 저장) */
+    void *free_list;                    /* 반환된 블록 스택 (lock 보호) */
+    void *next_free;                    /* 아직 잘라내지 않은 영역의 시작 (lock 보호) */
+    void *remote_free;                  /* 넘친 해제 블록 스택 (lock-free, 블록 안에 링크) */
+    size_t reset_blocks;                /* 리셋으로 회수된 블록 수 (사용량 계산 보정) */
     
     /* 통계 정보 */
-    btree_pool_stats_t stats;           /* 풀 통계 */
+    btree_pool_stats_t stats;           /* 풀 통계 (고정 정보와 최대 사용량) */
     
     /* 동시성 제어 */
-    atomic_flag lock;                   /* 스핀락 */
+    atomic_flag lock;                   /* 중앙 리스트 스핀락 */
+    btree_pool_magazine_t magazines[BTREE_POOL_MAGAZINES]; /* 스레드별 캐시 (THREAD_SAFE) */
     
     /* 설정 플래그 */
     uint32_t flags;                     /* 풀 설정 플래그 */
     
-    /* 다음 풀 (연결 리스트) */
+    /* 같은 크기 클래스의 이전 슬랩 (매니저 체인) */
     struct btree_memory_pool *next;
+    
+    /* OS에서 직접 매핑한 영역 (보호 페이지 포함, malloc 영역이면 NULL) */
+    void *map_base;                     /* 매핑 시작 주소 */
+    size_t map_size;                    /* 매핑 크기 */
 } btree_memory_pool_t;
 
 /* 메모리 풀 플래그 */
@@ -68,12 +89,21 @@ typedef struct btree_memory_pool {
 #define BTREE_POOL_FLAG_ZERO_MEMORY    0x02
 #define BTREE_POOL_FLAG_DEBUG_MODE     0x04
 #define BTREE_POOL_FLAG_TRACK_STATS    0x08
+#define BTREE_POOL_FLAG_SLAB           0x10   /* 크기 정렬 슬랩 (매니저 생성, 페이지 맵 등록) */
+#define BTREE_POOL_FLAG_ARENA          0x20   /* 가변 크기 순차 할당 청크 (블록 수는 할당 횟수) */
+#define BTREE_POOL_FLAG_HUGE_PAGES     0x40   /* 영역을 2MB 큰 페이지로 요청 (2MB 배수 영역만) */
+
+/* 메모리 매니저 플래그 */
+#define BTREE_MANAGER_FLAG_SHARED_STATS 0x01  /* 매니저 카운터 대신 전역 샤드 통계에 반영 */
+#define BTREE_MANAGER_FLAG_RANDOM_ACCESS 0x02 /* 새 슬랩에 무작위 접근 알림 (MADV_RANDOM) */
+#define BTREE_MANAGER_FLAG_HUGE_PAGES   0x04  /* 2MB 이상 새 슬랩에 큰 페이지 요청 */
 
 /* 메모리 매니저 구조체 */
 typedef struct {
     /* 풀 관리 */
-    btree_memory_pool_t *pools[BTREE_MAX_POOLS];  /* 크기별 풀 배열 */
-    size_t pool_count;                  /* 활성 풀 수 */
+    btree_memory_pool_t *pools[BTREE_MAX_POOLS];  /* 크기 클래스별 슬랩 체인 (최신 슬랩이 앞) */
+    size_t pool_count;                  /* 크기 클래스 수 */
+    size_t slab_count;                  /* 전체 슬랩 수 */
     
     /* 큰 할당을 위한 일반 할당자 */
     btree_allocator_t *fallback_allocator;
@@ -87,12 +117,22 @@ typedef struct {
     
     /* 설정 */
     uint32_t flags;                     /* 전역 플래그 */
+    int numa_node;                      /* 새 슬랩을 묶을 NUMA 노드 (-1이면 묶지 않음) */
     
     /* 동시성 제어 */
     atomic_flag manager_lock;           /* 매니저 레벨 락 */
 } btree_memory_manager_t;
 
-/* 메모리 풀 생성 및 관리 함수 */
+/**
+ * 메모리 풀 생성 및 관리 함수
+ *
+ * btree_pool_create는 영역을 캐시 라인에 맞춰 할당한다. HUGE_PAGES나
+ * DEBUG_MODE 플래그를 주거나 btree_memory_set_debug_mode가 켜져 있으면
+ * 영역을 OS에서 직접 매핑한다 (mmap, VirtualAlloc). 큰 페이지는 Linux
+ * MAP_HUGETLB(예약 페이지가 없으면 THP 알림), macOS 2MB 슈퍼페이지, Windows
+ * MEM_LARGE_PAGES 순으로 요청하며 안 되면 보통 페이지를 쓴다. 디버그
+ * 모드에서는 영역 앞뒤에 접근 불가 보호 페이지를 둔다 (넘침은 즉시 SIGSEGV).
+ */
 btree_memory_pool_t* btree_pool_create(size_t block_size, size_t pool_size, uint32_t flags);
 void btree_pool_destroy(btree_memory_pool_t *pool);
 void* btree_pool_alloc(btree_memory_pool_t *pool);
@@ -105,17 +145,84 @@ void btree_pool_reset(btree_memory_pool_t *pool);
 btree_memory_manager_t* btree_memory_manager_create(void);
 void btree_memory_manager_destroy(btree_memory_manager_t *manager);
 void* btree_memory_manager_alloc(btree_memory_manager_t *manager, size_t size);
+void* btree_memory_manager_alloc_exact(btree_memory_manager_t *manager, size_t size);
 void btree_memory_manager_free(btree_memory_manager_t *manager, void *ptr);
 void* btree_memory_manager_realloc(btree_memory_manager_t *manager, void *ptr, size_t new_size);
 
+/**
+ * @brief 포인터가 속한 슬랩 풀 검색 (페이지 맵, O(1))
+ *
+ * 매니저가 만든 슬랩만 찾으며, 그 외 포인터는 NULL을 반환한다.
+ */
+btree_memory_pool_t* btree_memory_find_pool(const void *ptr);
+
 /* 기본 메모리 할당자 구현 */
 btree_allocator_t* btree_default_allocator(void);
 btree_allocator_t* btree_pool_allocator_create(size_t block_size, size_t pool_size);
+void btree_pool_allocator_destroy(btree_allocator_t *allocator);
+
+/**
+ * @brief 공용 노드 풀 할당자 (btree_init에 할당자를 주지 않으면 사용)
+ *
+ * 노드 블록은 btree_node_pool_alloc으로 트리의 노드 크기와 정확히 같은
+ * 크기 클래스에서 할당되고, 슬랩이 차면 더 큰 슬랩을 체인에 추가한다.
+ * 할당자의 alloc은 이미 있는 클래스에 맞는 크기만 풀을 쓰고 나머지는
+ * 기본 할당자로 넘긴다. 사용량은 btree_memory_get_usage에 반영된다.
+ */
+btree_allocator_t* btree_node_pool_allocator(void);
+void* btree_node_pool_alloc(size_t size);
 btree_allocator_t* btree_debug_allocator_create(btree_allocator_t *base_allocator);
 
+/* 디스크 할당자 기본 프레임 크기 */
+#define BTREE_DISK_DEFAULT_FRAME_SIZE  4096
+
+/* 디스크 할당자 통계 */
+typedef struct {
+    size_t frame_size;                  /* 프레임 크기 */
+    size_t file_size;                   /* 파일 크기 */
+    size_t frames_used;                 /* 할당에 쓴 프레임 수 */
+    size_t bytes_in_use;                /* 할당된 블록 바이트 수 */
+    size_t resident_frames;             /* 상주 프레임 수 */
+    size_t resident_limit;              /* 상주 프레임 한도 */
+    size_t pinned_frames;               /* 고정된 프레임 수 */
+    size_t faults;                      /* 내보낸 프레임 재접근 횟수 */
+    size_t evictions;                   /* 내보낸 횟수 */
+    size_t writebacks;                  /* 변경된 프레임을 파일에 쓴 횟수 */
+} btree_disk_stats_t;
+
+/**
+ * @brief 파일 기반 노드 할당자 (RAM보다 큰 트리용 버퍼 풀)
+ *
+ * 노드를 path에 새로 만든 파일 안의 프레임에 두고, 메모리에 올려 두는 프레임을
+ * resident_limit 바이트로 제한한다 (CLOCK 교체, 변경된 프레임은 내보낼 때
+ * 파일로 씀). btree_init에 넘기면 btree_insert, btree_search 등은 메모리 트리와
+ * 같이 동작한다. 내보낸 노드도 주소는 그대로이며 접근하면 다시 읽힌다.
+ * btree_disk_allocator_pin으로 고정한 프레임은 내보내지 않는다.
+ *
+ * max_size는 파일 최대 크기로, 처음에 그만큼 주소 공간만 예약한다.
+ * frame_size는 OS 페이지 크기 이상의 2의 거듭제곱 (0이면 기본값)이며,
+ * BTREE_FLAG_INLINE_NODES 노드가 한 프레임에 들어가도록 차수를
+ * btree_disk_page_degree로 정하는 것이 좋다. 파일은 이미 있으면 만들지 않고
+ * (BTREE_ERROR_IO) 할당자를 해제할 때 삭제한다. 영속 저장은 btree_save_to_file.
+ * 노드가 아닌 임시 할당은 기본 할당자를 쓴다. POSIX 플랫폼에서만 지원한다.
+ */
+btree_allocator_t* btree_disk_allocator_create(const char *path, size_t max_size,
+                                               size_t frame_size, size_t resident_limit);
+void btree_disk_allocator_destroy(btree_allocator_t *allocator);
+btree_result_t btree_disk_allocator_flush(btree_allocator_t *allocator);
+btree_result_t btree_disk_allocator_pin(btree_allocator_t *allocator, const void *ptr, bool pin);
+bool btree_disk_allocator_get_stats(const btree_allocator_t *allocator, btree_disk_stats_t *stats);
+
+/* 단일 블록 노드가 frame_size 한 프레임에 들어가는 최대 차수 */
+int btree_disk_page_degree(size_t frame_size, size_t key_size, size_t value_size);
+
+/* OS 페이지 크기 (btree_set_node_bytes에 0을 넘기면 이 크기) */
+size_t btree_memory_page_size(void);
+
 /* 메모리 디버깅 및 추적 */
 void btree_memory_print_stats(FILE *output);
 bool btree_memory_check_leaks(void);
+/* 켜면 이후 만드는 풀, 슬랩, 아레나 청크 앞뒤에 보호 페이지를 둠 */
 void btree_memory_set_debug_mode(bool enable);
 size_t btree_memory_get_usage(void);
 
@@ -138,15 +245,9 @@ BTREE_INLINE size_t btree_next_power_of_two(size_t n) {
     return power;
 }
 
-/* 캐시 친화적 메모리 할당 - 간단한 버전 */
-BTREE_INLINE void* btree_cache_aligned_alloc(size_t size) {
-    size_t aligned_size = btree_align_size(size, BTREE_CACHE_LINE_SIZE);
-    return malloc(aligned_size);  /* 간단하게 malloc 사용 */
-}
-
-BTREE_INLINE void btree_cache_aligned_free(void *ptr) {
-    free(ptr);
-}
+/* 캐시 라인 정렬 할당 (크기는 캐시 라인 배수로 올림, btree_cache_aligned_free로 해제) */
+void* btree_cache_aligned_alloc(size_t size);
+void btree_cache_aligned_free(void *ptr);
 
 /* 메모리 워킹 세트 관리 */
 typedef struct {
@@ -161,15 +262,37 @@ void btree_memory_set_locality_hint(const btree_memory_locality_hint_t *hint);
 void btree_memory_optimize_layout(void *base, size_t size);
 
 /* 메모리 압축 및 최적화 */
+#define BTREE_COMPRESS_NONE     0       /* 그대로 복사 */
+#define BTREE_COMPRESS_LZ4      1       /* LZ4 블록 형식 (일반 데이터) */
+#define BTREE_COMPRESS_FOR      2       /* 기준값 + 고정 비트 폭 (정수 배열) */
+#define BTREE_COMPRESS_DELTA    3       /* 차이값 zigzag varint (정렬된 정수 배열) */
+#define BTREE_COMPRESS_AUTO     0xFF    /* 가능한 방식 중 가장 작은 것 */
+
 typedef struct {
     size_t original_size;               /* 원본 크기 */
     size_t compressed_size;             /* 압축된 크기 */
     float compression_ratio;            /* 압축률 */
     uint32_t algorithm;                 /* 압축 알고리즘 */
+    uint32_t element_size;              /* 정수 원소 크기 (FOR, DELTA: 1, 2, 4, 8) */
 } btree_compression_info_t;
 
+/**
+ * @brief 메모리 블록 압축
+ *
+ * info->algorithm으로 방식을 고르고 (AUTO면 고른 방식을 다시 적음), FOR와
+ * DELTA는 src를 element_size 바이트 부호 있는 정수 배열로 본다. *dst_size는
+ * 들어올 때 dst 용량, 나갈 때 쓴 크기다. 용량이 모자라거나 고른 방식을 쓸 수
+ * 없으면 false. 복원에는 같은 algorithm, element_size와 원본 크기가 필요하다.
+ */
 bool btree_memory_compress(const void *src, size_t src_size, void *dst, 
                           size_t *dst_size, btree_compression_info_t *info);
+
+/**
+ * @brief btree_memory_compress로 만든 블록을 dst_size 바이트로 복원
+ *
+ * 손상된 입력이 dst 밖을 쓰지 않도록 모든 길이를 확인하고, 복원한 크기가
+ * dst_size와 다르면 false.
+ */
 bool btree_memory_decompress(const void *src, size_t src_size, void *dst, 
                             size_t dst_size, const btree_compression_info_t *info);
 
@@ -182,17 +305,50 @@ typedef struct {
     double access_latency;              /* 접근 지연시간 */
 } btree_numa_info_t;
 
+/**
+ * @brief 현재 스레드가 도는 CPU의 NUMA 노드 정보
+ *
+ * local_memory는 그 노드의 메모리, remote_memory는 나머지 노드 메모리의 합,
+ * access_latency는 다른 노드까지의 평균 거리를 로컬 거리로 나눈 값이다
+ * (노드가 하나면 1.0). libnuma를 쓸 수 없는 시스템에서는 false.
+ */
 bool btree_numa_get_info(btree_numa_info_t *info);
+int btree_numa_node_count(void);
+int btree_numa_current_node(void);
+
+/* NUMA 배치 할당 (libnuma를 쓸 수 없으면 malloc, 해제는 btree_numa_free) */
 void* btree_numa_alloc_local(size_t size);
 void* btree_numa_alloc_interleaved(size_t size);
+void* btree_numa_alloc_onnode(size_t size, int node);
 void btree_numa_free(void *ptr);
+
+/**
+ * @brief NUMA 노드별 크기 클래스를 쓰는 노드 할당자
+ *
+ * 노드 블록은 할당하는 스레드가 도는 소켓의 매니저에서 잘라 내며, 매니저의
+ * 슬랩은 그 소켓 메모리에 묶인다 (numa_tonode_memory). 해제는 어느 스레드에서
+ * 해도 된다. btree_optimized_allocator_destroy로 해제한다.
+ */
+btree_allocator_t* btree_numa_allocator_create(void);
 #endif
 
 /* 메모리 보안 기능 */
 void btree_memory_secure_zero(void *ptr, size_t size);
 bool btree_memory_is_readable(const void *ptr, size_t size);
 bool btree_memory_is_writable(void *ptr, size_t size);
-void btree_memory_protect(void *ptr, size_t size, int protection);
+
+/* btree_memory_protect 접근 권한 (조합 가능) */
+#define BTREE_PROTECT_NONE             0x00
+#define BTREE_PROTECT_READ             0x01
+#define BTREE_PROTECT_WRITE            0x02
+
+/**
+ * @brief [ptr, ptr + size)를 덮는 페이지의 접근 권한 변경 (mprotect, VirtualProtect)
+ *
+ * 페이지 단위로 바뀌므로 ptr은 페이지 경계여야 한다. 매핑한 영역(보호
+ * 페이지 등)에만 쓴다. 실패하거나 지원하지 않는 플랫폼이면 false.
+ */
+bool btree_memory_protect(void *ptr, size_t size, int protection);
 
 /* 메모리 풀 최적화 힌트 */
 typedef enum {
@@ -204,9 +360,47 @@ typedef enum {
     BTREE_ALLOC_HINT_PERSISTENT        /* 지속적 할당 */
 } btree_alloc_hint_t;
 
+#define BTREE_HUGE_PAGE_SIZE           (2 * 1024 * 1024) /* 큰 페이지 크기 (SEQUENTIAL 아레나 청크 크기) */
+
+/**
+ * @brief 공용 노드 풀의 새 슬랩에 적용할 힌트
+ *
+ * 공용 노드 풀은 기본으로 2MB 이상 슬랩에 큰 페이지를 요청한다. RANDOM은
+ * 무작위 접근 알림(MADV_RANDOM)을 더하고, TEMPORARY와 LARGE_INFREQUENT는
+ * 큰 페이지를 끈다 (잠깐 쓰는 슬랩에는 페이지 병합 비용만 듦). 나머지
+ * 힌트는 기본으로 되돌린다. 이미 만든 슬랩은 그대로.
+ */
 void btree_memory_set_alloc_hint(btree_alloc_hint_t hint);
+
+/**
+ * @brief 힌트에 맞는 노드 할당 전략의 할당자 반환
+ *
+ * - SMALL_FREQUENT, PERSISTENT: 공용 노드 풀 (크기 클래스별 슬랩, 블록 재사용)
+ * - LARGE_INFREQUENT: 기본 할당자 (malloc)
+ * - SEQUENTIAL: 2MB 청크에서 잘라 내는 순차 할당 아레나. 청크는 큰 페이지로
+ *   요청하며, 해제는 횟수만 세고 블록이 모두 반환된 청크를 다시 쓴다.
+ * - TEMPORARY: 1MB 청크 아레나. btree_optimized_allocator_reset으로 청크를
+ *   btree_pool_reset해 한 번에 비운다.
+ * - RANDOM: 전용 크기 클래스 슬랩 (새 슬랩마다 MADV_RANDOM)
+ *
+ * 노드 외의 할당은 기본 할당자를 쓴다. 앞의 두 경우는 공용 할당자를 그대로
+ * 반환하므로 btree_optimized_allocator_destroy는 아무 일도 하지 않는다.
+ * 순차 삽입 트리는 btree_set_cache_hint(SEQUENTIAL)로 분할도 함께 바꾼다.
+ */
 btree_allocator_t* btree_optimized_allocator_create(btree_alloc_hint_t hint);
 
+/**
+ * @brief 아레나 할당자 (SEQUENTIAL/TEMPORARY)의 모든 블록을 한 번에 회수
+ *
+ * 이 할당자를 쓰는 트리는 먼저 정리해야 한다. 첫 청크만 남기고 반환한다.
+ */
+void btree_optimized_allocator_reset(btree_allocator_t *allocator);
+
+/**
+ * @brief 힌트 할당자 해제 (이 할당자를 쓰는 트리를 먼저 정리해야 함)
+ */
+void btree_optimized_allocator_destroy(btree_allocator_t *allocator);
+
 /* 메모리 풀 자동 조정 */
 typedef struct {
     size_t min_pool_size;               /* 최소 풀 크기 */
@@ -15,6 +15,15 @@ extern "C" {
 #define BTREE_MAX_DEGREE           1024
 #define BTREE_DEFAULT_DEGREE       16
 #define BTREE_CACHE_LINE_SIZE      64
+#define BTREE_DEFAULT_FILL_FACTOR  1.0
+#define BTREE_LINEAR_SEARCH_THRESHOLD 16     /* 노드 내 검색: 이 크기 이하 구간은 선형 스캔 */
+#define BTREE_SIMD_SEARCH_BYTES    256   /* SIMD 노드 내 검색: 이 바이트 이하 구간은 벡터 비교로 셈 */
+#define BTREE_DEGREE_AUTO          0     /* btree_init 차수: 노드 바이트 예산에 맞춰 결정 */
+#define BTREE_DEFAULT_NODE_BYTES   4096  /* 자동 차수의 기본 노드 크기 */
+
+#ifndef BTREE_MAX_HEIGHT
+#define BTREE_MAX_HEIGHT           20    /* 최대 트리 높이 (반복자 경로 스택 크기) */
+#endif
 
 /* 오류 코드 정의 */
 typedef enum {
@@ -27,9 +36,27 @@ typedef enum {
     BTREE_ERROR_INVALID_OPERATION,
     BTREE_ERROR_TYPE_MISMATCH,
     BTREE_ERROR_INVALID_SIZE,
-    BTREE_ERROR_ALIGNMENT_ERROR
+    BTREE_ERROR_ALIGNMENT_ERROR,
+    BTREE_ERROR_IO,                     /* 파일 열기/읽기/쓰기/매핑 실패 */
+    BTREE_ERROR_CORRUPTED               /* 파일 형식, 버전 또는 체크섬 불일치 */
 } btree_result_t;
 
+/* B-Tree 변형 */
+typedef enum {
+    BTREE_VARIANT_STANDARD,             /* 표준 B-Tree */
+    BTREE_VARIANT_PLUS,                 /* B+Tree */
+    BTREE_VARIANT_STAR,                 /* B*Tree */
+    BTREE_VARIANT_CONCURRENT            /* 동시성 B-Tree */
+} btree_variant_t;
+
+/* 노드 내 검색 방식 (btree_set_search_mode) */
+typedef enum {
+    BTREE_SEARCH_AUTO,                  /* 노드 크기와 키 크기에 맞춰 선택 */
+    BTREE_SEARCH_LINEAR,                /* 노드 전체를 선형으로 셈 */
+    BTREE_SEARCH_BINARY,                /* 이진 탐색 후 BTREE_LINEAR_SEARCH_THRESHOLD 이하 구간만 선형 */
+    BTREE_SEARCH_SIMD                   /* 이진 탐색 후 BTREE_SIMD_SEARCH_BYTES 이하 구간을 벡터 비교 */
+} btree_search_mode_t;
+
 /* 전방 선언 */
 typedef struct btree_node btree_node_t;
 typedef struct btree btree_t;
@@ -45,10 +72,19 @@ typedef uint64_t (*btree_hash_func_t)(const void *ptr);
 typedef void (*btree_print_func_t)(const void *ptr, FILE *output);
 typedef bool (*btree_validate_func_t)(const void *ptr);
 
+/* 노드 내 검색 함수: 찾으면 위치, 없으면 -(삽입 위치 + 1) 반환 */
+typedef int (*btree_search_func_t)(const void *keys, int count, const void *key,
+                                   int linear_threshold);
+
+/* 키의 바이트 표현 (길이는 *length), 순서가 바이트 사전순이 아닌 타입은 NULL 반환 */
+typedef const void* (*btree_bytes_func_t)(const void *key, size_t *length);
+
 /* 메모리 할당자 함수 포인터 */
 typedef void* (*btree_alloc_func_t)(size_t size);
 typedef void (*btree_free_func_t)(void *ptr);
 typedef void* (*btree_realloc_func_t)(void *ptr, size_t new_size);
+typedef void* (*btree_node_alloc_func_t)(void *context, size_t size);
+typedef void (*btree_access_func_t)(void *context, const void *ptr, bool write);
 
 /* 타입 정보 구조체 */
 struct btree_type_info {
@@ -69,6 +105,8 @@ struct btree_type_info {
     btree_hash_func_t hash;             /* 해시 함수 */
     btree_print_func_t print;           /* 출력 함수 */
     btree_validate_func_t validate;     /* 유효성 검사 함수 */
+    btree_search_func_t search;         /* 타입 특화 노드 내 검색 (NULL이면 compare 사용) */
+    btree_bytes_func_t bytes;           /* 바이트 표현 (접두사 검색용, NULL이면 키 자체) */
 };
 
 /* 메모리 할당자 구조체 */
@@ -79,17 +117,26 @@ struct btree_allocator {
     void *context;                      /* 할당자 컨텍스트 */
     size_t total_allocated;             /* 총 할당된 메모리 */
     size_t total_freed;                 /* 총 해제된 메모리 */
+    
+    /* 선택 항목 (NULL이면 alloc 사용, 접근 알림 없음) */
+    btree_node_alloc_func_t node_alloc; /* 노드 블록 할당 (캐시 라인 정렬, 해제는 free) */
+    btree_access_func_t access;         /* 탐색 중 노드 접근 알림 (버퍼 풀 교체 정책용) */
 };
 
 /* B-Tree 노드 구조체 */
 struct btree_node {
     /* 노드 기본 정보 */
     uint32_t is_leaf : 1;               /* 리프 노드 여부 */
-    uint32_t num_keys : 31;             /* 현재 키 개수 */
+    uint32_t is_inline : 1;             /* 단일 블록 레이아웃 여부 */
+    uint32_t in_arena : 1;              /* 재배치 아레나에서 잘라 낸 블록 (block은 아레나) */
+    uint32_t replicated : 1;            /* NUMA 복제본이 있는 상위 노드 (바뀌면 복제본 무효) */
+    uint32_t is_replica : 1;            /* NUMA 복제본 (parent는 원본, 값과 삭제 표시는 원본에) */
+    uint32_t num_keys : 27;             /* 현재 키 개수 */
     
     /* 데이터 포인터 */
     void *keys;                         /* 키 배열 */
     void *values;                       /* 값 배열 (리프 노드용) */
+    uint8_t *tombstones;                /* 삭제 표시 배열 (지연 삭제 모드, 그 외 NULL) */
     btree_node_t **children;            /* 자식 노드 배열 */
     
     /* 트리 구조 정보 */
@@ -101,7 +148,9 @@ struct btree_node {
     
     /* 메모리 관리 정보 */
     size_t capacity;                    /* 최대 키 용량 */
-    uint32_t ref_count;                 /* 참조 카운트 */
+    uint32_t ref_count;                 /* 참조 카운트 (btree_copy로 공유하면 2 이상) */
+    uint32_t version;                   /* 낙관적 잠금 버전 (홀수면 쓰기 잠금, 동시 모드) */
+    void *block;                        /* 단일 블록 할당의 원본 주소 (in_arena면 아레나) */
 };
 
 /* 메인 B-Tree 구조체 */
@@ -111,7 +160,12 @@ struct btree {
     int degree;                         /* B-Tree 차수 */
     int max_keys;                       /* 최대 키 개수 */
     int min_keys;                       /* 최소 키 개수 */
+    int internal_max_keys;              /* 내부 노드 최대 키 개수 (B+Tree는 더 큼) */
     int height;                         /* 트리 높이 */
+    btree_variant_t variant;            /* 트리 변형 */
+    size_t node_bytes;                  /* 자동 차수의 노드 바이트 예산 (고정 차수면 0) */
+    btree_search_mode_t search_mode;    /* 요청한 노드 내 검색 방식 */
+    int search_window;                  /* 노드 내 검색에서 선형으로 세는 구간 (키 수) */
     
     /* 타입 정보 */
     btree_type_info_t key_type;         /* 키 타입 정보 */
@@ -122,14 +176,38 @@ struct btree {
     
     /* 통계 정보 */
     size_t node_count;                  /* 전체 노드 수 */
-    size_t key_count;                   /* 전체 키 수 */
+    size_t key_count;                   /* 전체 키 수 (삭제 표시된 키 제외) */
+    size_t dead_count;                  /* 삭제 표시만 된 키 수 */
     size_t total_memory;                /* 총 메모리 사용량 */
     
     /* 설정 플래그 */
     uint32_t flags;                     /* 설정 플래그들 */
+    double fill_factor;                 /* 일괄 적재 시 노드 채움 비율 */
     
-    /* 동기화 (향후 멀티스레드 지원용) */
+    /* 동기화 (btree_set_thread_safe로 생성, 그 외 NULL) */
     void *lock;                         /* 동기화 객체 */
+    
+    /* 파일 저장소 (btree_load_from_file로 연 읽기 전용 매핑, 그 외 NULL) */
+    void *storage;                      /* 매핑된 페이지 파일 */
+
+    /* 선행 기록 로그 (btree_wal_open으로 생성, 그 외 NULL) */
+    void *log;                          /* 로그 파일과 커밋 대기 버퍼 */
+
+    /* 운영 계측 (btree_enable_metrics로 생성, 그 외 NULL) */
+    void *metrics;                      /* 카운터와 지연 시간 히스토그램 */
+
+    /* 이벤트 구독 (btree_set_event_callback/버퍼로 생성, 그 외 NULL) */
+    void *events;                       /* 이벤트 콜백과 묶음 버퍼 */
+
+    /* 점진 재배치 (btree_compact_step으로 생성, 끝나면 NULL) */
+    void *layout;                       /* 진행 중인 레벨과 커서 */
+
+    /* 오른쪽 끝 추가 (삽입이 관리, 스냅숏 공유나 동시 모드에서는 NULL) */
+    btree_node_t *append_leaf;          /* 오른쪽 끝 리프 */
+    uint32_t append_run;                /* 연속으로 오른쪽 끝에 추가한 삽입 수 */
+
+    /* NUMA 소켓별 상위 레벨 복제본 (btree_numa_replicate로 생성, 그 외 NULL) */
+    void *numa;                         /* 복제 상태 */
 };
 
 /* B-Tree 설정 플래그 */
@@ -137,14 +215,33 @@ struct btree {
 #define BTREE_FLAG_CASE_INSENSITIVE    0x02
 #define BTREE_FLAG_AUTO_BALANCE        0x04
 #define BTREE_FLAG_THREAD_SAFE         0x08
+#define BTREE_FLAG_INLINE_NODES        0x10    /* 노드당 단일 캐시 정렬 블록 */
+#define BTREE_FLAG_LAZY_DELETE         0x20    /* 지연 삭제 (btree_set_lazy_delete로 설정) */
+#define BTREE_FLAG_SHARED              0x40    /* 스냅숏과 노드 공유 (btree_copy, btree_clear까지) */
+#define BTREE_FLAG_APPEND              0x80    /* 오른쪽 끝 추가는 치우쳐 분할 (btree_set_cache_hint) */
+#define BTREE_FLAG_COMPRESS_LEAVES     0x100   /* 이미지의 리프 압축 (btree_set_leaf_compression) */
 
-/* 반복자 구조체 */
+/*
+ * 반복자 구조체
+ *
+ * 커서는 다음 next 호출이 반환할 항목을 가리킨다 (is_valid가 false면 끝).
+ * 범위 경계 키는 복사하지 않으므로 반복자보다 오래 유지되어야 한다.
+ */
 struct btree_iterator {
     btree_t *tree;                      /* 대상 트리 */
     btree_node_t *current_node;         /* 현재 노드 */
     int current_index;                  /* 현재 인덱스 */
     bool is_valid;                      /* 반복자 유효성 */
     bool is_reverse;                    /* 역방향 반복 여부 */
+    
+    /* 범위 경계 (NULL이면 제한 없음, 양 끝 포함) */
+    const void *min_key;
+    const void *max_key;
+    
+    /* 표준 B-Tree 중위 순회 경로 (B+Tree는 리프 연결을 사용) */
+    btree_node_t *path[BTREE_MAX_HEIGHT];   /* 루트부터 현재 노드까지 */
+    int path_index[BTREE_MAX_HEIGHT];       /* 조상은 자식 인덱스, 마지막은 키 인덱스 */
+    int depth;                              /* 경로 길이 */
 };
 
 /* 타입 ID 생성 매크로 */
@@ -169,10 +266,35 @@ struct btree_iterator {
 #define BTREE_ALIGN(size, alignment) \
     (((size) + (alignment) - 1) & ~((alignment) - 1))
 
-/* 최적 차수 계산 매크로 */
+/* 타입의 정렬 요구사항 (C99에는 _Alignof가 없으므로 offsetof로 구함) */
+#if defined(__cplusplus)
+    #define BTREE_ALIGNOF(type) alignof(type)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+    #define BTREE_ALIGNOF(type) _Alignof(type)
+#else
+    #define BTREE_ALIGNOF(type) offsetof(struct { char c; type t; }, t)
+#endif
+
+/*
+ * 노드 바이트 예산에 맞는 차수 (표준 변형의 근사값, 컴파일 타임 상수)
+ *
+ * 내부 노드의 헤더, 키, 값, 자식 포인터가 bytes에 들어가는 가장 큰 차수를
+ * [BTREE_MIN_DEGREE, BTREE_MAX_DEGREE]로 자른다. 정렬 여백까지 맞춘 정확한
+ * 값은 btree_degree_for_bytes.
+ */
+#define BTREE_DEGREE_FOR_BYTES_RAW(bytes, key_size, value_size) \
+    ((bytes) > sizeof(btree_node_t) + sizeof(void*) \
+        ? (((bytes) - sizeof(btree_node_t) - sizeof(void*)) / \
+           ((key_size) + (value_size) + sizeof(void*)) + 1) / 2 \
+        : 0)
+#define BTREE_DEGREE_FOR_BYTES(bytes, key_size, value_size) \
+    (BTREE_DEGREE_FOR_BYTES_RAW(bytes, key_size, value_size) < BTREE_MIN_DEGREE ? BTREE_MIN_DEGREE : \
+     BTREE_DEGREE_FOR_BYTES_RAW(bytes, key_size, value_size) > BTREE_MAX_DEGREE ? BTREE_MAX_DEGREE : \
+     (int)BTREE_DEGREE_FOR_BYTES_RAW(bytes, key_size, value_size))
+
+/* 최적 차수 계산 매크로 (기본 노드 크기 BTREE_DEFAULT_NODE_BYTES 기준) */
 #define BTREE_OPTIMAL_DEGREE(key_size, value_size) \
-    ((BTREE_CACHE_LINE_SIZE - sizeof(btree_node_t)) / \
-     ((key_size) + (value_size) + sizeof(void*)))
+    BTREE_DEGREE_FOR_BYTES(BTREE_DEFAULT_NODE_BYTES, key_size, value_size)
 
 /* 컴파일러별 속성 정의 */
 #if defined(__GNUC__) || defined(__clang__)
@@ -180,16 +302,19 @@ struct btree_iterator {
     #define BTREE_LIKELY(x) __builtin_expect(!!(x), 1)
     #define BTREE_UNLIKELY(x) __builtin_expect(!!(x), 0)
     #define BTREE_RESTRICT __restrict__
+    #define BTREE_THREAD_LOCAL __thread
 #elif defined(_MSC_VER)
     #define BTREE_INLINE static __forceinline
     #define BTREE_LIKELY(x) (x)
     #define BTREE_UNLIKELY(x) (x)
     #define BTREE_RESTRICT __restrict
+    #define BTREE_THREAD_LOCAL __declspec(thread)
 #else
     #define BTREE_INLINE static inline
     #define BTREE_LIKELY(x) (x)
     #define BTREE_UNLIKELY(x) (x)
     #define BTREE_RESTRICT
+    #define BTREE_THREAD_LOCAL              /* 스레드 지역 저장소 미지원: 단일 스레드 전용 */
 #endif
 
 /* C++ 지원 */
@@ -1,3 +1,7 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L     /* clock_gettime, strdup */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -9,6 +13,15 @@
 BTREE_DECLARE_INT_INT(verify);
 BTREE_DEFINE_INT_INT(verify);
 
+/**
+ * @brief Wall-clock time in seconds (CLOCK_MONOTONIC; clock() would count CPU time only)
+ */
+static double wall_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
 /**
  * @brief Value pair structure for sorting
  */
@@ -218,7 +231,7 @@ bool btree_traversal_sort_detailed(int *arr, size_t size, int degree) {
     }
     
     printf("Step 1: Inserting %zu unique elements into B-Tree...\n", size);
-    clock_t start = clock();
+    double start = wall_seconds();
     
     /* Insert unique values (no duplicates) */
     int successful_insertions = 0;
@@ -242,8 +255,8 @@ bool btree_traversal_sort_detailed(int *arr, size_t size, int degree) {
     }
     printf("\n");
     
-    clock_t mid = clock();
-    double insert_time = ((double)(mid - start)) / CLOCKS_PER_SEC;
+    double mid = wall_seconds();
+    double insert_time = mid - start;
     
     printf("Step 2: B-Tree construction completed\n");
     printf("  - Insertion time: %.4fs\n", insert_time);
@@ -276,9 +289,9 @@ bool btree_traversal_sort_detailed(int *arr, size_t size, int degree) {
         }
     }
     
-    clock_t end = clock();
-    double extract_time = ((double)(end - mid)) / CLOCKS_PER_SEC;
-    double total_time = ((double)(end - start)) / CLOCKS_PER_SEC;
+    double end = wall_seconds();
+    double extract_time = end - mid;
+    double total_time = end - start;
     
     printf("Step 4: Extraction completed\n");
     printf("  - Extraction time: %.4fs\n", extract_time);
@@ -319,18 +332,18 @@ void compare_with_qsort(const int *original, size_t size) {
     
     /* B-Tree sorting */
     printf("Testing B-Tree sorting...\n");
-    clock_t start = clock();
+    double start = wall_seconds();
     bool btree_success = btree_traversal_sort_detailed(btree_copy, size, 16);
-    clock_t mid = clock();
-    double btree_time = ((double)(mid - start)) / CLOCKS_PER_SEC;
+    double mid = wall_seconds();
+    double btree_time = mid - start;
     
     /* qsort sorting */
     printf("\nTesting standard qsort...\n");
     
-    start = clock();
+    start = wall_seconds();
     qsort(qsort_copy, size, sizeof(int), compare_ints);
-    clock_t end = clock();
-    double qsort_time = ((double)(end - start)) / CLOCKS_PER_SEC;
+    double end = wall_seconds();
+    double qsort_time = end - start;
     
     /* Results comparison */
     printf("\n--- Performance Comparison ---\n");
@@ -0,0 +1,881 @@
+/**
+ * @file btree_bulk.c
+ * @brief B-Tree 일괄 적재 (bulk loading) 구현
+ */
+
+#include "btree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* 정렬된 입력 항목 (입력 배열 내 위치를 가리키는 포인터) */
+typedef const btree_key_value_pair_t* btree_bulk_item_t;
+
+/* 병렬 적재에서 스레드 하나가 정렬하는 최소 항목 수와 작업 하나가 만드는 노드 수 */
+#define BTREE_BULK_SORT_GRAIN 4096
+#define BTREE_BULK_GRAIN 64
+
+/* 레벨 구성 계획 */
+typedef struct {
+    size_t node_count;                  /* 레벨의 노드 수 */
+    size_t keys_per_node;               /* 노드당 기본 키 수 */
+    size_t remainder;                   /* 키를 하나 더 받는 앞쪽 노드 수 */
+} btree_bulk_level_t;
+
+/**
+ * @brief 안정 병합 정렬 (트리 비교 함수 사용)
+ */
+static void btree_bulk_merge_sort(btree_bulk_item_t *items, btree_bulk_item_t *tmp,
+                                  size_t count, btree_compare_func_t compare) {
+    if (count < 2) return;
+
+    size_t half = count / 2;
+    btree_bulk_merge_sort(items, tmp, half, compare);
+    btree_bulk_merge_sort(items + half, tmp, count - half, compare);
+
+    /* 이미 순서가 맞으면 병합 생략 */
+    if (compare(items[half - 1]->key, items[half]->key) <= 0) return;
+
+    size_t i = 0, j = half, k = 0;
+    while (i < half && j < count) {
+        if (compare(items[j]->key, items[i]->key) < 0) {
+            tmp[k++] = items[j++];
+        } else {
+            tmp[k++] = items[i++];
+        }
+    }
+    while (i < half) tmp[k++] = items[i++];
+    while (j < count) tmp[k++] = items[j++];
+
+    memcpy(items, tmp, count * sizeof(btree_bulk_item_t));
+}
+
+/* 병렬 정렬 상태: bounds[i]부터 bounds[i + 1]까지가 정렬된 구간 i */
+typedef struct {
+    btree_bulk_item_t *src;
+    btree_bulk_item_t *dst;
+    const size_t *bounds;
+    size_t runs;
+    size_t step;                        /* 이번 단계에서 합치는 구간 묶음 크기 */
+    btree_compare_func_t compare;
+} btree_bulk_sort_t;
+
+/* 구간 하나를 제자리 정렬 */
+static void btree_bulk_sort_task(void *context, size_t index, int worker) {
+    (void)worker;
+    btree_bulk_sort_t *sort = context;
+    size_t begin = sort->bounds[index], end = sort->bounds[index + 1];
+    btree_bulk_merge_sort(sort->src + begin, sort->dst + begin, end - begin, sort->compare);
+}
+
+/* 이웃한 두 구간 묶음을 src에서 dst로 병합 (같은 키는 왼쪽 먼저) */
+static void btree_bulk_sort_merge_task(void *context, size_t index, int worker) {
+    (void)worker;
+    btree_bulk_sort_t *sort = context;
+    size_t first = index * sort->step * 2;
+    size_t middle = first + sort->step < sort->runs ? first + sort->step : sort->runs;
+    size_t last = first + sort->step * 2 < sort->runs ? first + sort->step * 2 : sort->runs;
+
+    size_t i = sort->bounds[first], half = sort->bounds[middle];
+    size_t j = half, end = sort->bounds[last], k = i;
+    while (i < half && j < end) {
+        if (sort->compare(sort->src[j]->key, sort->src[i]->key) < 0) {
+            sort->dst[k++] = sort->src[j++];
+        } else {
+            sort->dst[k++] = sort->src[i++];
+        }
+    }
+    while (i < half) sort->dst[k++] = sort->src[i++];
+    while (j < end) sort->dst[k++] = sort->src[j++];
+}
+
+/**
+ * @brief 구간별로 나눠 정렬한 뒤 두 구간씩 병합 (안정 정렬)
+ *
+ * 스레드마다 구간 하나를 정렬하고, 병합 단계마다 구간 수가 반으로 준다.
+ * 단계마다 items와 tmp를 번갈아 쓰고 끝난 쪽이 tmp면 되돌려 복사한다.
+ */
+static void btree_bulk_sort(btree_bulk_item_t *items, btree_bulk_item_t *tmp, size_t count,
+                            btree_compare_func_t compare, int workers) {
+    size_t bounds[BTREE_PARALLEL_MAX_THREADS + 1];
+    size_t runs = (size_t)workers;
+    if (runs > count / BTREE_BULK_SORT_GRAIN) runs = count / BTREE_BULK_SORT_GRAIN;
+    if (runs <= 1) {
+        btree_bulk_merge_sort(items, tmp, count, compare);
+        return;
+    }
+    for (size_t i = 0; i <= runs; i++) {
+        bounds[i] = count * i / runs;
+    }
+
+    btree_bulk_sort_t sort = { items, tmp, bounds, runs, 1, compare };
+    btree_parallel_for(runs, workers, btree_bulk_sort_task, &sort);
+
+    for (; sort.step < runs; sort.step *= 2) {
+        size_t merges = (runs + sort.step * 2 - 1) / (sort.step * 2);
+        btree_parallel_for(merges, workers, btree_bulk_sort_merge_task, &sort);
+        btree_bulk_item_t *swap = sort.src;
+        sort.src = sort.dst;
+        sort.dst = swap;
+    }
+    if (sort.src != items) {
+        memcpy(items, sort.src, count * sizeof(btree_bulk_item_t));
+    }
+}
+
+/**
+ * @brief 입력을 정렬된 항목 배열로 준비
+ *
+ * @return 준비된 배열 (항목 수는 *out_count), 실패 시 NULL
+ */
+static btree_bulk_item_t* btree_bulk_prepare(btree_t *tree,
+                                             const btree_key_value_pair_t *pairs,
+                                             size_t count, bool keep_last, int workers,
+                                             size_t *out_count, bool *had_duplicates) {
+    btree_compare_func_t compare = tree->key_type.compare;
+    btree_bulk_item_t *items = tree->allocator->alloc(count * sizeof(btree_bulk_item_t));
+    if (!items) return NULL;
+
+    bool sorted = true;
+    for (size_t i = 0; i < count; i++) {
+        items[i] = &pairs[i];
+        if (i > 0 && sorted && compare(pairs[i - 1].key, pairs[i].key) > 0) {
+            sorted = false;
+        }
+    }
+
+    if (!sorted) {
+        btree_bulk_item_t *tmp = tree->allocator->alloc(count * sizeof(btree_bulk_item_t));
+        if (!tmp) {
+            tree->allocator->free(items);
+            return NULL;
+        }
+        btree_bulk_sort(items, tmp, count, compare, workers);
+        tree->allocator->free(tmp);
+    }
+
+    /* 중복 키 제거 (안정 정렬이므로 keep_last가 아니면 먼저 나온 항목 유지) */
+    size_t unique = count;
+    if (!(tree->flags & BTREE_FLAG_ALLOW_DUPLICATES) && count > 1) {
+        unique = 1;
+        for (size_t i = 1; i < count; i++) {
+            if (compare(items[unique - 1]->key, items[i]->key) == 0) {
+                *had_duplicates = true;
+                if (keep_last) items[unique - 1] = items[i];
+            } else {
+                items[unique++] = items[i];
+            }
+        }
+    }
+
+    *out_count = unique;
+    return items;
+}
+
+/**
+ * @brief 한 레벨에 들어갈 노드 수와 노드당 키 수 계산
+ *
+ * 노드 사이의 구분 키는 상위 레벨로 올라가므로 m개 항목을 g개 노드로 나누면
+ * 노드에는 m - (g - 1)개의 키가 남는다. B+Tree의 리프는 구분 키 사본만
+ * 올리므로 (gap = 0) m개가 모두 남는다. 모든 노드가 최소 키 수 이상,
+ * capacity 이하가 되도록 g를 조정한다.
+ */
+static void btree_bulk_plan_level(const btree_t *tree, size_t items, size_t capacity,
+                                  size_t gap, btree_bulk_level_t *level) {
+    size_t max_keys = capacity;
+    size_t min_keys = (capacity - 1) / 2;
+    size_t target = (size_t)(tree->fill_factor * max_keys + 0.5);
+
+    if (target < min_keys) target = min_keys;
+    if (target > max_keys) target = max_keys;
+
+    size_t nodes = (items + gap + target) / (target + gap);
+    if (nodes == 0) nodes = 1;
+    while (nodes > 1 && items - gap * (nodes - 1) < nodes * min_keys) {
+        nodes--;
+    }
+    while (items - gap * (nodes - 1) > nodes * max_keys) {
+        nodes++;
+    }
+
+    size_t keys = items - gap * (nodes - 1);
+    level->node_count = nodes;
+    level->keys_per_node = keys / nodes;
+    level->remainder = keys % nodes;
+}
+
+/* 스레드별 노드 생성 집계 (트리 사본의 카운터에 모았다가 레벨마다 합침) */
+typedef struct {
+    btree_t shadow;
+    btree_metrics_state_t metrics;
+    bool failed;
+} btree_bulk_worker_t;
+
+/* 한 레벨 구성 상태 (작업 사이에 공유) */
+typedef struct {
+    btree_bulk_worker_t *workers;
+    const btree_bulk_item_t *items;
+    const size_t *level_items;          /* 이 레벨 항목 (items 배열의 인덱스) */
+    size_t *next_items;                 /* 상위 레벨로 올라가는 구분 키 */
+    btree_node_t **prev_nodes;          /* 아래 레벨 노드 (리프 레벨이면 NULL) */
+    btree_node_t **nodes;
+    btree_bulk_level_t plan;
+    size_t gap;
+    bool copy_up;
+} btree_bulk_level_ctx_t;
+
+/**
+ * @brief 레벨의 노드 BTREE_BULK_GRAIN개 구성
+ *
+ * 노드 n 앞에는 노드마다 키와 구분 키가 정해진 수만큼 있으므로, 첫 항목과 첫
+ * 자식 위치를 계산으로 바로 찾아 앞 작업을 기다리지 않는다. 구간 경계의 리프
+ * 연결은 레벨이 끝난 뒤 잇는다.
+ */
+static void btree_bulk_build_task(void *context, size_t index, int worker) {
+    btree_bulk_level_ctx_t *level = context;
+    btree_bulk_worker_t *self = &level->workers[worker];
+    btree_t *tree = &self->shadow;
+    const btree_bulk_level_t *plan = &level->plan;
+    if (self->failed) return;
+
+    size_t first = index * BTREE_BULK_GRAIN;
+    size_t last = first + BTREE_BULK_GRAIN < plan->node_count
+                ? first + BTREE_BULK_GRAIN : plan->node_count;
+    size_t extra = first < plan->remainder ? first : plan->remainder;
+    size_t pos = first * (plan->keys_per_node + level->gap) + extra;
+    size_t child = first * (plan->keys_per_node + 1) + extra;
+    bool is_leaf = (level->prev_nodes == NULL);
+
+    for (size_t n = first; n < last; n++) {
+        btree_node_t *node = btree_node_create(tree, is_leaf);
+        if (!node) {
+            self->failed = true;
+            return;
+        }
+        level->nodes[n] = node;
+
+        size_t keys = plan->keys_per_node + (n < plan->remainder ? 1 : 0);
+        for (size_t k = 0; k < keys; k++) {
+            const btree_key_value_pair_t *pair = level->items[level->level_items[pos++]];
+            btree_node_insert_key(node, (int)k, pair->key, pair->value,
+                                  &tree->key_type, &tree->value_type);
+        }
+
+        if (is_leaf) {
+            if (n > first) {
+                level->nodes[n - 1]->next_leaf = node;
+                node->prev_leaf = level->nodes[n - 1];
+            }
+        } else {
+            for (size_t c = 0; c <= keys; c++) {
+                node->children[c] = level->prev_nodes[child++];
+                node->children[c]->parent = node;
+            }
+        }
+
+        /* 노드 사이의 항목은 구분 키로 상위 레벨에 전달,
+         * B+Tree 리프는 다음 리프의 첫 키를 사본으로 전달 */
+        if (n + 1 < plan->node_count) {
+            level->next_items[n] = level->copy_up ? level->level_items[pos]
+                                                  : level->level_items[pos++];
+        }
+    }
+}
+
+/* 스레드별 집계를 트리로 옮김 (실패한 스레드가 있으면 true) */
+static bool btree_bulk_collect(btree_t *tree, btree_bulk_worker_t *workers, int count) {
+    bool failed = false;
+    for (int w = 0; w < count; w++) {
+        btree_bulk_worker_t *self = &workers[w];
+        btree_counter_add(tree, &tree->node_count, self->shadow.node_count);
+        btree_counter_add(tree, &tree->total_memory, self->shadow.total_memory);
+        BTREE_METRIC_ADD(tree, node_allocs, self->metrics.data.node_allocs);
+        BTREE_METRIC_ADD(tree, node_frees, self->metrics.data.node_frees);
+        self->shadow.node_count = 0;
+        self->shadow.total_memory = 0;
+        self->metrics.data.node_allocs = 0;
+        self->metrics.data.node_frees = 0;
+        failed |= self->failed;
+    }
+    return failed;
+}
+
+/**
+ * @brief 정렬된 항목으로 빈 트리를 상향식 구성
+ *
+ * 레벨마다 노드를 BTREE_BULK_GRAIN개씩 작업으로 나눠 workers개 스레드로
+ * 만든다. 노드는 스레드마다 둔 트리 사본으로 만들어 카운터를 따로 세므로
+ * 노드 생성 경로는 직렬과 같다.
+ */
+static btree_result_t btree_bulk_build(btree_t *tree, const btree_bulk_item_t *items,
+                                       size_t count, int workers) {
+    /* 현재 레벨과 다음 레벨의 항목 (items 배열의 인덱스) */
+    size_t *level_items = tree->allocator->alloc(count * sizeof(size_t));
+    size_t *next_items = tree->allocator->alloc(count * sizeof(size_t));
+    btree_bulk_worker_t *states = tree->allocator->alloc((size_t)workers * sizeof(btree_bulk_worker_t));
+    if (!level_items || !next_items || !states) {
+        if (level_items) tree->allocator->free(level_items);
+        if (next_items) tree->allocator->free(next_items);
+        if (states) tree->allocator->free(states);
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    for (size_t i = 0; i < count; i++) {
+        level_items[i] = i;
+    }
+    for (int w = 0; w < workers; w++) {
+        memset(&states[w], 0, sizeof(btree_bulk_worker_t));
+        states[w].shadow = *tree;
+        states[w].shadow.node_count = 0;
+        states[w].shadow.total_memory = 0;
+        if (tree->metrics) {
+            states[w].metrics.flags = ((btree_metrics_state_t*)tree->metrics)->flags;
+            states[w].shadow.metrics = &states[w].metrics;
+        }
+    }
+
+    btree_node_t **prev_nodes = NULL;
+    size_t prev_count = 0;
+    size_t level_count = count;
+    int height = 0;
+    btree_result_t result = BTREE_SUCCESS;
+
+    for (;;) {
+        bool is_leaf = (prev_nodes == NULL);
+        btree_bulk_level_ctx_t level;
+        level.workers = states;
+        level.items = items;
+        level.level_items = level_items;
+        level.next_items = next_items;
+        level.prev_nodes = prev_nodes;
+        level.copy_up = is_leaf && btree_is_plus(tree);
+        level.gap = level.copy_up ? 0 : 1;
+        btree_bulk_plan_level(tree, level_count, (size_t)btree_node_capacity_for(tree, is_leaf),
+                              level.gap, &level.plan);
+
+        size_t node_count = level.plan.node_count;
+        level.nodes = tree->allocator->alloc(node_count * sizeof(btree_node_t*));
+        if (!level.nodes) {
+            result = BTREE_ERROR_MEMORY_ALLOCATION;
+            break;
+        }
+        memset(level.nodes, 0, node_count * sizeof(btree_node_t*));
+
+        size_t tasks = (node_count + BTREE_BULK_GRAIN - 1) / BTREE_BULK_GRAIN;
+        btree_parallel_for(tasks, workers, btree_bulk_build_task, &level);
+
+        if (btree_bulk_collect(tree, states, workers)) {
+            /* 부모에 붙지 못한 하위 노드를 먼저 골라 해제한 뒤 만든 노드를
+             * 연결된 자식까지 함께 해제 */
+            for (size_t c = 0; prev_nodes && c < prev_count; c++) {
+                if (!prev_nodes[c]->parent) btree_node_destroy(tree, prev_nodes[c]);
+            }
+            for (size_t n = 0; n < node_count; n++) {
+                if (level.nodes[n]) btree_node_destroy(tree, level.nodes[n]);
+            }
+            tree->allocator->free(level.nodes);
+            if (prev_nodes) tree->allocator->free(prev_nodes);
+            prev_nodes = NULL;
+            result = BTREE_ERROR_MEMORY_ALLOCATION;
+            break;
+        }
+
+        for (size_t n = BTREE_BULK_GRAIN; is_leaf && n < node_count; n += BTREE_BULK_GRAIN) {
+            level.nodes[n - 1]->next_leaf = level.nodes[n];
+            level.nodes[n]->prev_leaf = level.nodes[n - 1];
+        }
+
+        if (prev_nodes) tree->allocator->free(prev_nodes);
+        prev_nodes = level.nodes;
+        prev_count = node_count;
+        level_count = node_count - 1;
+        height++;
+
+        size_t *swap = level_items;
+        level_items = next_items;
+        next_items = swap;
+
+        if (node_count == 1) break;
+    }
+
+    if (result == BTREE_SUCCESS) {
+        btree_set_root(tree, prev_nodes[0]);
+        tree->height = height;
+        tree->key_count = count;
+    } else if (prev_nodes) {
+        for (size_t n = 0; n < prev_count; n++) {
+            btree_node_destroy(tree, prev_nodes[n]);
+        }
+    }
+
+    if (prev_nodes) tree->allocator->free(prev_nodes);
+    tree->allocator->free(states);
+    tree->allocator->free(next_items);
+    tree->allocator->free(level_items);
+    return result;
+}
+
+/* 리프에 병합할 항목과 병합 전 리프에서의 삽입 위치 */
+typedef struct {
+    btree_bulk_item_t item;
+    int pos;
+} btree_batch_pending_t;
+
+/* 이미 있는 키: 갱신 모드면 값을 덮어쓰고, 아니면 삭제 표시된 슬롯만 되살림 */
+static void btree_batch_existing(btree_t *tree, btree_node_t *node, int index,
+                                 btree_bulk_item_t item, bool overwrite,
+                                 bool *had_duplicates) {
+    if (overwrite) {
+        btree_overwrite_slot(tree, node, index, item->value);
+    } else if (btree_revive_slot(tree, node, index, item->value) == BTREE_ERROR_DUPLICATE_KEY) {
+        *had_duplicates = true;
+        return;
+    }
+    btree_event_emit(tree, BTREE_EVENT_INSERT, item->key, item->value);
+}
+
+/* 비워 둔 리프 슬롯에 새 항목의 키와 값을 복사 */
+static void btree_batch_place(btree_t *tree, btree_node_t *leaf, int index,
+                              btree_bulk_item_t item) {
+    btree_store_key(tree, btree_get_key_ptr(leaf, index, &tree->key_type), item->key);
+    if (leaf->values && item->value) {
+        btree_store_value(tree, btree_get_value_ptr(leaf, index, &tree->value_type), item->value);
+    }
+    if (leaf->tombstones) {
+        btree_slot_mark(leaf->tombstones + index, 0, btree_is_concurrent(tree));
+    }
+    btree_event_emit(tree, BTREE_EVENT_INSERT, item->key, item->value);
+}
+
+/**
+ * @brief 정렬되고 중복이 제거된 항목을 비어 있지 않은 트리에 병합
+ *
+ * 항목 하나로 리프까지 내려간 뒤 (선제 분할은 btree_insert와 같음), 뒤따르는
+ * 항목 중 그 리프의 상한보다 작고 빈 슬롯에 들어가는 것을 모아 뒤에서부터
+ * 한 번에 병합한다. 기존 슬롯은 리프마다 한 번만 이동하고, 경로 탐색은
+ * 키마다가 아니라 리프가 찰 때마다 한 번 일어난다.
+ */
+static btree_result_t btree_batch_merge(btree_t *tree, const btree_bulk_item_t *items,
+                                        size_t count, bool overwrite,
+                                        bool *had_duplicates) {
+    btree_batch_pending_t *pending =
+        tree->allocator->alloc((size_t)tree->max_keys * sizeof(btree_batch_pending_t));
+    if (!pending) return BTREE_ERROR_MEMORY_ALLOCATION;
+
+    btree_compare_func_t compare = tree->key_type.compare;
+    btree_result_t result = BTREE_SUCCESS;
+    size_t i = 0;
+
+    while (i < count) {
+        btree_insert_path_t path;
+        result = btree_insert_descend(tree, items[i]->key, &path);
+        if (result != BTREE_SUCCESS) break;
+
+        btree_node_t *leaf = path.node;
+        if (path.pos >= 0) {
+            btree_batch_existing(tree, leaf, path.pos, items[i++], overwrite, had_duplicates);
+            continue;
+        }
+
+        /* 1단계: 이 리프에 들어갈 항목 수집 (이미 있는 키는 제자리에서 처리) */
+        int room = (int)leaf->capacity - leaf->num_keys;
+        int n = 0;
+        pending[n].item = items[i++];
+        pending[n++].pos = -(path.pos + 1);
+        while (i < count && n < room) {
+            const void *key = items[i]->key;
+            if (path.upper && compare(key, path.upper) >= 0) break;
+
+            int pos = btree_node_search(tree, leaf, key);
+            if (pos >= 0) {
+                btree_batch_existing(tree, leaf, pos, items[i++], overwrite, had_duplicates);
+                continue;
+            }
+            pending[n].item = items[i++];
+            pending[n++].pos = -(pos + 1);
+        }
+
+        /* 2단계: 뒤에서부터 기존 슬롯을 밀어내며 새 항목 배치 */
+        int end = leaf->num_keys;
+        for (int j = n - 1; j >= 0; j--) {
+            int pos = pending[j].pos;
+            btree_move_slots(tree, leaf, pos + j + 1, leaf, pos, end - pos);
+            btree_batch_place(tree, leaf, pos + j, pending[j].item);
+            end = pos;
+        }
+        btree_node_set_count(tree, leaf, leaf->num_keys + n);
+        btree_counter_add(tree, &tree->key_count, (size_t)n);
+    }
+
+    tree->allocator->free(pending);
+    return result;
+}
+
+/* btree_bulk_insert와 btree_batch_upsert 공통 경로 (정렬과 빈 트리 구성은 workers개 스레드) */
+static btree_result_t btree_batch_apply(btree_t *tree, const btree_key_value_pair_t *pairs,
+                                        size_t count, bool overwrite, int workers) {
+    size_t unique = 0;
+    bool had_duplicates = false;
+    btree_bulk_item_t *items = btree_bulk_prepare(tree, pairs, count, overwrite, workers,
+                                                  &unique, &had_duplicates);
+    if (!items) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    btree_result_t result = BTREE_SUCCESS;
+    if (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES) {
+        /* 중복 허용 트리에는 정렬된 순서로 개별 삽입 */
+        for (size_t i = 0; i < unique && result == BTREE_SUCCESS; i++) {
+            result = btree_insert(tree, items[i]->key, items[i]->value);
+        }
+    } else {
+        btree_writer_begin(tree);
+        if (!tree->root) {
+            result = btree_bulk_build(tree, items, unique, workers);
+            for (size_t i = 0; tree->events && result == BTREE_SUCCESS && i < unique; i++) {
+                btree_event_emit(tree, BTREE_EVENT_INSERT, items[i]->key, items[i]->value);
+            }
+        } else {
+            result = btree_batch_merge(tree, items, unique, overwrite, &had_duplicates);
+        }
+        btree_writer_end(tree);
+    }
+
+    tree->allocator->free(items);
+
+    if (result == BTREE_SUCCESS && had_duplicates && !overwrite) {
+        result = BTREE_ERROR_DUPLICATE_KEY;
+    }
+    if (result != BTREE_SUCCESS) {
+        btree_set_error(result);
+    }
+    return result;
+}
+
+/**
+ * @brief 키-값 쌍 배열 일괄 삽입
+ */
+btree_result_t btree_bulk_insert(btree_t *tree,
+                                const btree_key_value_pair_t *pairs,
+                                size_t count) {
+    if (!tree || (!pairs && count > 0)) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    if (count == 0) return BTREE_SUCCESS;
+
+    return btree_batch_apply(tree, pairs, count, false, 1);
+}
+
+/**
+ * @brief 키-값 쌍 배열 일괄 갱신 (없으면 삽입, 있으면 값 교체)
+ */
+btree_result_t btree_batch_upsert(btree_t *tree,
+                                  const btree_key_value_pair_t *pairs,
+                                  size_t count) {
+    if (!tree || (!pairs && count > 0)) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree) || (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    if (count == 0) return BTREE_SUCCESS;
+
+    return btree_batch_apply(tree, pairs, count, true, 1);
+}
+
+/**
+ * @brief 여러 스레드로 나눠 일괄 삽입
+ */
+btree_result_t btree_bulk_insert_parallel(btree_t *tree,
+                                          const btree_key_value_pair_t *pairs,
+                                          size_t count, int threads) {
+    if (!tree || (!pairs && count > 0)) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (threads < 0) {
+        return btree_set_error(BTREE_ERROR_INVALID_SIZE), BTREE_ERROR_INVALID_SIZE;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    if (count == 0) return BTREE_SUCCESS;
+
+    /* 디스크 할당자의 접근 알림은 한 스레드에서만 부름 */
+    int workers = tree->allocator->access ? 1 : btree_parallel_threads(threads);
+    return btree_batch_apply(tree, pairs, count, false, workers);
+}
+
+/**
+ * @brief 키 배열 일괄 삭제
+ */
+size_t btree_bulk_delete(btree_t *tree, const void **keys, size_t count) {
+    if (!tree || (!keys && count > 0)) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return 0;
+    }
+
+    size_t deleted = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (keys[i] && btree_delete(tree, keys[i]) == BTREE_SUCCESS) {
+            deleted++;
+        }
+    }
+    return deleted;
+}
+
+/* 동시에 진행하는 검색 수와 정렬을 시작하는 배치 크기 */
+#define BTREE_BATCH_GROUP 16
+#define BTREE_BATCH_SORT_MIN 64
+
+/* 프리페치할 최대 바이트 (노드 하나의 검색 구간) */
+#define BTREE_BATCH_PREFETCH_MAX (16 * BTREE_CACHE_LINE_SIZE)
+
+/* 진행 중인 검색 하나 */
+typedef struct {
+    const void *key;
+    void **out;                         /* 결과를 기록할 위치 */
+    const btree_node_t *node;           /* 다음에 읽을 노드 (프리페치됨) */
+    bool keys_ready;                    /* 분리 할당 노드의 키 배열 프리페치 여부 */
+} btree_batch_cursor_t;
+
+/* 노드의 검색 구간 프리페치 (단일 블록이면 헤더와 키, 분리 할당이면 헤더만) */
+static inline void btree_batch_prefetch_node(const btree_node_t *node, size_t inline_span) {
+    btree_memory_prefetch(node, node->is_inline ? inline_span : sizeof(btree_node_t));
+}
+
+/*
+ * 한 단계 진행. 분리 할당 노드는 헤더를 읽은 뒤 한 번 양보하여 키 배열이
+ * 올라오는 동안 다른 검색을 진행한다.
+ * @return 검색이 끝났으면 true
+ */
+static bool btree_batch_step(const btree_t *tree, btree_batch_cursor_t *c, bool plus,
+                             size_t inline_span) {
+    const btree_node_t *node = c->node;
+    if (!node->is_inline && !c->keys_ready) {
+        size_t size = (size_t)node->num_keys * tree->key_type.key_size;
+        btree_memory_prefetch(node->keys, size < BTREE_BATCH_PREFETCH_MAX ? size : BTREE_BATCH_PREFETCH_MAX);
+        c->keys_ready = true;
+        return false;
+    }
+
+    btree_node_access(tree, node, false);
+    int pos = btree_node_search(tree, node, c->key);
+    if (pos >= 0 && (node->is_leaf || !plus)) {
+        *c->out = btree_slot_is_dead(node, pos)
+                ? NULL : btree_get_value_ptr(node, pos, &tree->value_type);
+        return true;
+    }
+    if (node->is_leaf) {
+        *c->out = NULL;
+        return true;
+    }
+
+    c->node = node->children[btree_descend_index(pos)];
+    c->keys_ready = false;
+    btree_batch_prefetch_node(c->node, inline_span);
+    return false;
+}
+
+/**
+ * @brief 여러 키를 함께 검색 (결과는 btree_search처럼 값 포인터)
+ *
+ * 최대 BTREE_BATCH_GROUP개의 검색을 번갈아 한 단계씩 진행하면서 각 검색이
+ * 다음에 읽을 노드를 미리 프리페치한다. 배치가 크면 키 순서로 정렬하여
+ * 이웃한 검색이 같은 상위 노드를 공유하게 한다. 결과 순서는 입력 순서이다.
+ */
+size_t btree_search_batch(btree_t *tree, const void **keys, size_t count, void **out_values) {
+    if (!tree || (count > 0 && (!keys || !out_values))) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return 0;
+    }
+
+    size_t found = 0;
+    if (BTREE_UNLIKELY(btree_is_concurrent(tree) || btree_is_mapped(tree) || !tree->root)) {
+        for (size_t i = 0; i < count; i++) {
+            out_values[i] = keys[i] ? btree_search(tree, keys[i]) : NULL;
+            found += out_values[i] != NULL;
+        }
+        return found;
+    }
+
+    /* 큰 배치는 키 순서로 처리 (정렬 실패 시 입력 순서) */
+    size_t total = count;
+    btree_key_value_pair_t *pairs = NULL;
+    btree_bulk_item_t *order = NULL;
+    if (count >= BTREE_BATCH_SORT_MIN && tree->height > 1) {
+        pairs = tree->allocator->alloc(count * sizeof(btree_key_value_pair_t));
+        order = tree->allocator->alloc(2 * count * sizeof(btree_bulk_item_t));
+        if (pairs && order) {
+            size_t n = 0;
+            for (size_t i = 0; i < count; i++) {
+                out_values[i] = NULL;
+                if (!keys[i]) continue;
+                pairs[n].key = (void*)keys[i];
+                pairs[n].value = &out_values[i];
+                order[n] = &pairs[n];
+                n++;
+            }
+            btree_bulk_merge_sort(order, order + n, n, tree->key_type.compare);
+            count = n;
+        } else {
+            if (pairs) tree->allocator->free(pairs);
+            if (order) tree->allocator->free(order);
+            pairs = NULL;
+            order = NULL;
+        }
+    }
+
+    /* 단일 블록 노드는 헤더부터 키 배열 끝까지가 검색 구간 */
+    btree_node_layout_t layout;
+    btree_node_compute_layout(tree, true, &layout);
+    int capacity = btree_node_capacity_for(tree, false);
+    if (btree_node_capacity_for(tree, true) > capacity) capacity = btree_node_capacity_for(tree, true);
+    size_t inline_span = layout.keys_offset + (size_t)capacity * tree->key_type.key_size;
+    if (inline_span > BTREE_BATCH_PREFETCH_MAX) inline_span = BTREE_BATCH_PREFETCH_MAX;
+
+    btree_batch_cursor_t cursors[BTREE_BATCH_GROUP];
+    bool plus = btree_is_plus(tree);
+    size_t next = 0, active = 0;
+
+    for (;;) {
+        /* 빈 자리를 다음 키로 채움 */
+        while (active < BTREE_BATCH_GROUP && next < count) {
+            const void *key;
+            void **out;
+            if (order) {
+                key = order[next]->key;
+                out = order[next]->value;
+            } else {
+                key = keys[next];
+                out = &out_values[next];
+            }
+            next++;
+            if (!key) {
+                *out = NULL;
+                continue;
+            }
+            cursors[active++] = (btree_batch_cursor_t){ key, out, tree->root, false };
+        }
+        if (active == 0) break;
+
+        for (size_t i = 0; i < active;) {
+            if (btree_batch_step(tree, &cursors[i], plus, inline_span)) {
+                found += *cursors[i].out != NULL;
+                cursors[i] = cursors[--active];
+            } else {
+                i++;
+            }
+        }
+    }
+
+    if (pairs) tree->allocator->free(pairs);
+    if (order) tree->allocator->free(order);
+
+    /* 검색 이벤트는 입력 순서로 */
+    for (size_t i = 0; tree->events && i < total; i++) {
+        if (keys[i]) btree_event_emit(tree, BTREE_EVENT_SEARCH, keys[i], out_values[i]);
+    }
+    return found;
+}
+
+/**
+ * @brief 일괄 적재 채움 비율 설정 (0.5 ~ 1.0)
+ */
+btree_result_t btree_set_fill_factor(btree_t *tree, double fill_factor) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (!(fill_factor >= 0.5 && fill_factor <= 1.0)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    tree->fill_factor = fill_factor;
+    return BTREE_SUCCESS;
+}
+
+/* 살아 있는 항목을 키 순서로 모음 (노드의 슬롯을 가리킬 뿐 복사하지 않음) */
+static void btree_rebuild_collect(const btree_t *tree, btree_node_t *node,
+                                  btree_key_value_pair_t *pairs, size_t *count) {
+    bool separators = !node->is_leaf && btree_is_plus(tree);
+    for (int i = 0; i <= node->num_keys; i++) {
+        if (!node->is_leaf) {
+            btree_rebuild_collect(tree, node->children[i], pairs, count);
+        }
+        if (i == node->num_keys || separators || btree_slot_is_dead(node, i)) continue;
+
+        pairs[*count].key = btree_get_key_ptr(node, i, &tree->key_type);
+        pairs[*count].value = node->values ? btree_get_value_ptr(node, i, &tree->value_type)
+                                           : NULL;
+        (*count)++;
+    }
+}
+
+/* 쓰기 구간 안에서 다시 적재하고 재배치 */
+static btree_result_t btree_rebuild_locked(btree_t *tree) {
+    if (!tree->root) return BTREE_SUCCESS;
+
+    size_t slots = tree->key_count > 0 ? tree->key_count : 1;
+    btree_key_value_pair_t *pairs = tree->allocator->alloc(slots * sizeof(btree_key_value_pair_t));
+    btree_bulk_item_t *items = tree->allocator->alloc(slots * sizeof(btree_bulk_item_t));
+    if (!pairs || !items) {
+        if (pairs) tree->allocator->free(pairs);
+        if (items) tree->allocator->free(items);
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    size_t count = 0;
+    btree_rebuild_collect(tree, tree->root, pairs, &count);
+    for (size_t i = 0; i < count; i++) {
+        items[i] = &pairs[i];
+    }
+
+    /* 새 노드는 같은 설정의 빈 트리에 쌓고 집계만 옮김 */
+    btree_t fresh = *tree;
+    fresh.root = NULL;
+    fresh.height = 0;
+    fresh.node_count = 0;
+    fresh.total_memory = 0;
+    fresh.flags &= ~(uint32_t)BTREE_FLAG_SHARED;
+
+    btree_result_t result = count > 0 ? btree_bulk_build(&fresh, items, count, 1) : BTREE_SUCCESS;
+    tree->allocator->free(items);
+    tree->allocator->free(pairs);
+    if (result != BTREE_SUCCESS) return result;
+
+    /* 스냅숏과 공유하던 노드는 해제되지 않으므로 집계를 새로 시작 (btree_clear와 같음) */
+    bool shared = (tree->flags & BTREE_FLAG_SHARED) != 0;
+    btree_node_retire(tree, tree->root);
+    if (shared) {
+        tree->node_count = 0;
+        tree->total_memory = sizeof(btree_t);
+        tree->flags &= ~(uint32_t)BTREE_FLAG_SHARED;
+    }
+    btree_counter_add(tree, &tree->node_count, fresh.node_count);
+    btree_counter_add(tree, &tree->total_memory, fresh.total_memory);
+
+    btree_set_root(tree, fresh.root);
+    tree->height = fresh.height;
+    tree->key_count = count;
+    tree->dead_count = 0;
+    return btree_layout_apply(tree, BTREE_LAYOUT_BFS);
+}
+
+/**
+ * @brief 살아 있는 키를 fill_factor로 다시 채우고 BFS 순서로 재배치
+ */
+btree_result_t btree_rebuild(btree_t *tree) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_writer_begin(tree);
+    btree_result_t result = btree_rebuild_locked(tree);
+    btree_writer_end(tree);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
@@ -0,0 +1,638 @@
+/**
+ * @file btree_concurrent.c
+ * @brief 낙관적 잠금 결합 (optimistic lock coupling) 기반 동시 접근 모드
+ *
+ * 노드마다 버전 카운터를 두고, 쓰기 잠금은 버전을 홀수로 만든다.
+ * 읽기는 잠금 없이 버전을 읽고 노드를 읽은 뒤 버전이 그대로인지 확인하며,
+ * 바뀌었으면 루트부터 다시 시작한다. 자식 포인터는 부모 버전을 확인한 뒤에만
+ * 따라가므로 분할 중인 노드의 깨진 값을 역참조하지 않는다. 검증 전에 읽는
+ * 필드는 쓰기와 겹칠 수 있으므로 쓰는 쪽과 읽는 쪽 모두 단어 단위 원자적
+ * 접근으로 다룬다 (btree_atomic_move, btree_atomic_load).
+ *
+ * 삽입은 하향식 선제 분할을 그대로 쓰되, 분할할 때 부모와 자식, 리프에 넣을
+ * 때 그 리프만 잠근다 (관찰한 버전에서 잠금을 올리지 못하면 재시작).
+ * 삽입끼리는 공유 잠금을 잡고 노드 잠금으로 조율하며, 노드를 해제하는 삭제는
+ * 배타 잠금과 트리 단위 순번(seq)으로 보호한다. 해제할 노드는 읽는 스레드가
+ * 아직 보고 있을 수 있으므로 에포크 기반으로 보류한다: 잠금 없는 검색은
+ * 들어올 때 읽은 전역 에포크를 자기 칸에 게시하고 나갈 때 지운다. 배타 쓰기
+ * 구간이 끝나면 그 구간에 떨어져 나간 노드 묶음에 지금 에포크를 붙이고 전역
+ * 에포크를 올린다. 게시된 에포크가 모두 묶음의 에포크보다 크면 (떼어 낸 뒤에
+ * 들어온 검색만 남으면) 묶음을 해제한다. 삽입은 공유 잠금 아래에서만 노드를
+ * 읽으므로 배타 구간과 겹치지 않는다.
+ */
+
+#include "btree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(BTREE_PLATFORM_WINDOWS) || !(defined(__GNUC__) || defined(__clang__))
+
+/* 이 플랫폼에서는 동시 접근 모드를 지원하지 않음 (btree_is_concurrent는 항상 false) */
+
+btree_result_t btree_set_thread_safe(btree_t *tree, bool enable) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (!enable) return BTREE_SUCCESS;
+    return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+}
+
+btree_result_t btree_concurrent_insert(btree_t *tree, const void *key, const void *value) {
+    (void)tree; (void)key; (void)value;
+    return BTREE_ERROR_INVALID_OPERATION;
+}
+
+void* btree_concurrent_search(btree_t *tree, const void *key, void *value_out) {
+    (void)tree; (void)key; (void)value_out;
+    return NULL;
+}
+
+void btree_writer_begin(btree_t *tree) { (void)tree; }
+void btree_writer_end(btree_t *tree) { (void)tree; }
+void btree_node_retire(btree_t *tree, btree_node_t *node) { btree_node_destroy(tree, node); }
+void btree_reclaim_retired(btree_t *tree) { (void)tree; }
+size_t btree_concurrent_retired(const btree_t *tree) { (void)tree; return 0; }
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+
+#define BTREE_EPOCH_SLOTS       64      /* 동시에 에포크를 게시할 수 있는 검색 수 */
+#define BTREE_RETIRE_BATCHES    16      /* 에포크가 붙은 보류 묶음 수 (넘치면 마지막에 합침) */
+#define BTREE_OLC_KEY_BYTES     4096    /* 검색이 한 번에 복사하는 최대 키 바이트 */
+#define BTREE_OLC_COPY_BYTES    512     /* 이 이하인 키 배열은 통째로 복사해 검색 */
+
+/* 검색 하나가 게시한 진입 에포크 (0이면 빈 칸, 칸마다 캐시 라인 하나) */
+typedef struct {
+    uint64_t epoch;
+    char pad[BTREE_CACHE_LINE_SIZE - sizeof(uint64_t)];
+} btree_epoch_slot_t;
+
+/* 같은 배타 구간들에서 떨어져 나간 노드 (epoch 이하로 들어온 검색이 볼 수 있음) */
+typedef struct {
+    btree_node_t *nodes;                /* parent 필드로 연결 */
+    size_t count;
+    uint64_t epoch;
+} btree_retire_batch_t;
+
+/* 트리 단위 동기화 상태 (tree->lock) */
+typedef struct {
+    pthread_rwlock_t writers;           /* 삽입은 공유, 구조 변경은 배타 */
+    pthread_mutex_t root_lock;          /* 루트 생성과 교체 직렬화 */
+    uint32_t seq;                       /* 배타 쓰기 순번 (홀수면 진행 중) */
+    btree_node_t *retired;              /* 이번 배타 구간의 보류 노드 (parent 필드로 연결) */
+    size_t retired_count;
+    btree_retire_batch_t batches[BTREE_RETIRE_BATCHES];  /* 오래된 것부터 */
+    int batch_count;
+    size_t pending;                     /* 해제하지 않은 보류 노드 전체 수 */
+    uint64_t epoch;                     /* 전역 에포크 (1부터) */
+    btree_epoch_slot_t slots[BTREE_EPOCH_SLOTS];
+} btree_sync_t;
+
+/* 검색 스레드가 먼저 시도할 칸 (스레드마다 다르게 흩어 둠) */
+static BTREE_THREAD_LOCAL unsigned g_epoch_hint;
+static unsigned g_epoch_next;
+
+/* 내부 재시작 신호 */
+typedef enum {
+    BTREE_OLC_DONE,
+    BTREE_OLC_RESTART
+} btree_olc_status_t;
+
+static inline void btree_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/* 잠기지 않은 버전을 읽음 (잠겨 있으면 대기) */
+static inline uint32_t btree_olc_read_begin(const uint32_t *version) {
+    uint32_t v;
+    while ((v = __atomic_load_n(version, __ATOMIC_ACQUIRE)) & 1) {
+        btree_cpu_relax();
+    }
+    return v;
+}
+
+/* 읽기 이후 버전이 그대로인지 확인 */
+static inline bool btree_olc_validate(const uint32_t *version, uint32_t v) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(version, __ATOMIC_RELAXED) == v;
+}
+
+/* 관찰한 버전 v에서 쓰기 잠금으로 올림 (그 사이 바뀌었으면 실패) */
+static inline bool btree_olc_upgrade(btree_node_t *node, uint32_t v) {
+    if (!__atomic_compare_exchange_n(&node->version, &v, v + 1, false,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    /* 이후의 노드 쓰기가 잠금보다 먼저 보이지 않도록 */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return true;
+}
+
+static inline void btree_olc_unlock(btree_node_t *node) {
+    __atomic_add_fetch(&node->version, 1, __ATOMIC_RELEASE);
+}
+
+/* 배타 쓰기 순번 대기 (구조 변경 중이면 양보) */
+static inline uint32_t btree_seq_begin(const btree_sync_t *sync) {
+    uint32_t s;
+    while ((s = __atomic_load_n(&sync->seq, __ATOMIC_ACQUIRE)) & 1) {
+        sched_yield();
+    }
+    return s;
+}
+
+/*
+ * 읽는 도중 바뀌었을 수 있는 num_keys로 노드 안 검색.
+ * 쓰기와 겹칠 수 있으므로 키는 원자적으로 복사한 뒤 비교한다. 검색 함수가 없으면
+ * 이진 검색이 비교하는 키만 복사한다. 있으면 작은 키 배열은 통째로 복사해 맡기고,
+ * 큰 배열은 검색 함수처럼 구간을 search_window 이하로 줄인 뒤 남은 구간 (하한이
+ * 구간 끝일 수 있어 하나 더)만 복사해 맡긴다.
+ */
+static int btree_olc_find(const btree_t *tree, const btree_node_t *node, int count,
+                          const void *key) {
+    if (count == 0) return -1;
+    const btree_type_info_t *type = &tree->key_type;
+    size_t key_size = type->key_size;
+    uint64_t buf[BTREE_OLC_KEY_BYTES / sizeof(uint64_t)];
+
+    if (!type->search) {
+        int left = 0, right = count - 1;
+        while (left <= right) {
+            int mid = (left + right) / 2;
+            btree_atomic_load(buf, btree_get_key_ptr(node, mid, type), key_size);
+            int cmp = type->compare(key, buf);
+            if (cmp == 0) return mid;
+            if (cmp < 0) right = mid - 1;
+            else left = mid + 1;
+        }
+        return -(left + 1);
+    }
+
+    if ((size_t)count * key_size <= BTREE_OLC_COPY_BYTES) {
+        btree_atomic_load(buf, node->keys, (size_t)count * key_size);
+        return type->search(buf, count, key, tree->search_window);
+    }
+
+    int window = tree->search_window;
+    int max_window = (int)(sizeof(buf) / key_size) - 1;
+    if (window > max_window) window = max_window;
+    if (window < 1) window = 1;
+
+    int base = 0, len = count;
+    while (len > window) {
+        int half = len >> 1;
+        btree_atomic_load(buf, btree_get_key_ptr(node, base + half - 1, type), key_size);
+        if (type->compare(buf, key) < 0) base += half;
+        len -= half;
+    }
+    int n = len < count - base ? len + 1 : count - base;
+    btree_atomic_load(buf, btree_get_key_ptr(node, base, type), (size_t)n * key_size);
+    int pos = type->search(buf, n, key, window);
+    return pos >= 0 ? base + pos : pos - base;
+}
+
+/* 쓰기와 겹칠 수 있는 자식 포인터와 삭제 표시 읽기 */
+static inline btree_node_t* btree_olc_child(const btree_node_t *node, int index) {
+    return __atomic_load_n(&node->children[index], __ATOMIC_ACQUIRE);
+}
+
+static inline bool btree_olc_slot_dead(const btree_node_t *node, int index) {
+    return node->tombstones && __atomic_load_n(&node->tombstones[index], __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief 동시 접근 모드 설정
+ */
+btree_result_t btree_set_thread_safe(btree_t *tree, bool enable) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (enable == btree_is_concurrent(tree)) return BTREE_SUCCESS;
+
+    if (!enable) {
+        btree_sync_t *sync = tree->lock;
+        btree_reclaim_retired(tree);
+        pthread_rwlock_destroy(&sync->writers);
+        pthread_mutex_destroy(&sync->root_lock);
+        tree->lock = NULL;
+        tree->allocator->free(sync);
+        tree->flags &= ~BTREE_FLAG_THREAD_SAFE;
+        return BTREE_SUCCESS;
+    }
+
+    /* 매핑된 트리는 읽기 전용이라 잠금 없이도 여러 스레드가 검색할 수 있음.
+     * 스냅숏과 노드를 공유하는 트리는 쓰기가 경로 복사를 거쳐야 하므로 불가 */
+    if (btree_is_mapped(tree) || (tree->flags & BTREE_FLAG_SHARED)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    /* 잠금 없는 읽기는 수정 중인 슬롯을 비교할 수 있으므로 포인터 키는 불가.
+     * 검색은 키를 복사해 비교하고, 포인터 값은 임시 슬롯을 거쳐 기록하므로
+     * 그 버퍼보다 큰 키와 포인터 값도 불가 */
+    if (btree_type_is_pointer(&tree->key_type) ||
+        tree->key_type.key_size > BTREE_OLC_KEY_BYTES / 2 ||
+        (btree_type_is_pointer(&tree->value_type) &&
+         tree->value_type.value_size > BTREE_ATOMIC_SLOT_MAX)) {
+        return btree_set_error(BTREE_ERROR_TYPE_MISMATCH), BTREE_ERROR_TYPE_MISMATCH;
+    }
+
+    btree_sync_t *sync = tree->allocator->alloc(sizeof(btree_sync_t));
+    if (!sync) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    if (pthread_rwlock_init(&sync->writers, NULL) != 0) {
+        tree->allocator->free(sync);
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    if (pthread_mutex_init(&sync->root_lock, NULL) != 0) {
+        pthread_rwlock_destroy(&sync->writers);
+        tree->allocator->free(sync);
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    memset(sync->slots, 0, sizeof(sync->slots));
+    sync->seq = 0;
+    sync->retired = NULL;
+    sync->retired_count = 0;
+    sync->batch_count = 0;
+    sync->pending = 0;
+    sync->epoch = 1;
+
+    /* 오른쪽 끝 리프 캐시와 NUMA 복제본은 단일 쓰기 전용 */
+    tree->append_leaf = NULL;
+    btree_replica_release(tree);
+    tree->lock = sync;
+    tree->flags |= BTREE_FLAG_THREAD_SAFE;
+    return BTREE_SUCCESS;
+}
+
+/*
+ * 루트 생성 또는 가득 찬 루트 분할 (root_lock 아래에서 수행).
+ * root는 관찰한 루트(없으면 NULL), v는 그 버전이다.
+ */
+static btree_olc_status_t btree_olc_grow_root(btree_t *tree, btree_sync_t *sync,
+                                              btree_node_t *root, uint32_t v,
+                                              btree_result_t *result) {
+    btree_olc_status_t status = BTREE_OLC_RESTART;
+
+    pthread_mutex_lock(&sync->root_lock);
+    if (tree->root != root) goto out;
+
+    if (!root) {
+        btree_node_t *leaf = btree_node_create(tree, true);
+        if (!leaf) {
+            *result = BTREE_ERROR_MEMORY_ALLOCATION;
+            status = BTREE_OLC_DONE;
+            goto out;
+        }
+        tree->height = 1;
+        __atomic_store_n(&tree->root, leaf, __ATOMIC_RELEASE);
+        goto out;
+    }
+
+    if (tree->height >= BTREE_MAX_HEIGHT) {
+        btree_set_error(BTREE_ERROR_INVALID_OPERATION);
+        *result = BTREE_ERROR_INVALID_OPERATION;
+        status = BTREE_OLC_DONE;
+        goto out;
+    }
+    if (!btree_olc_upgrade(root, v)) goto out;
+
+    /* 새 루트는 공개 전까지 다른 스레드에 보이지 않으므로 잠글 필요 없음 */
+    btree_node_t *new_root = btree_node_create(tree, false);
+    if (!new_root) {
+        btree_olc_unlock(root);
+        *result = BTREE_ERROR_MEMORY_ALLOCATION;
+        status = BTREE_OLC_DONE;
+        goto out;
+    }
+    new_root->children[0] = root;
+    btree_result_t split = btree_split_child(tree, new_root, 0, false);
+    if (split != BTREE_SUCCESS) {
+        new_root->children[0] = NULL;
+        btree_node_destroy(tree, new_root);
+        btree_olc_unlock(root);
+        *result = split;
+        status = BTREE_OLC_DONE;
+        goto out;
+    }
+    root->parent = new_root;
+    tree->height++;
+    __atomic_store_n(&tree->root, new_root, __ATOMIC_RELEASE);
+    btree_olc_unlock(root);
+
+out:
+    pthread_mutex_unlock(&sync->root_lock);
+    return status;
+}
+
+/* 삽입 한 번 시도 (동시 수정과 충돌하면 RESTART) */
+static btree_olc_status_t btree_olc_insert(btree_t *tree, btree_sync_t *sync,
+                                           const void *key, const void *value,
+                                           btree_result_t *result) {
+    btree_node_t *node = __atomic_load_n(&tree->root, __ATOMIC_ACQUIRE);
+    if (!node) return btree_olc_grow_root(tree, sync, NULL, 0, result);
+
+    uint32_t v = btree_olc_read_begin(&node->version);
+    if (node != __atomic_load_n(&tree->root, __ATOMIC_ACQUIRE)) return BTREE_OLC_RESTART;
+    btree_node_t head;
+    btree_node_load_head(node, &head);
+    if (head.num_keys >= node->capacity) {
+        return btree_olc_grow_root(tree, sync, node, v, result);
+    }
+
+    bool allow_duplicates = (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES) != 0;
+    bool plus = btree_is_plus(tree);
+
+    for (;;) {
+        btree_node_load_head(node, &head);
+        int count = head.num_keys;
+        if (count > (int)node->capacity) return BTREE_OLC_RESTART;
+        int pos = btree_olc_find(tree, node, count, key);
+
+        if (pos >= 0 && !allow_duplicates && (head.is_leaf || !plus)) {
+            if (!btree_olc_slot_dead(node, pos)) {
+                if (!btree_olc_validate(&node->version, v)) return BTREE_OLC_RESTART;
+                *result = BTREE_ERROR_DUPLICATE_KEY;
+                return BTREE_OLC_DONE;
+            }
+            if (!btree_olc_upgrade(node, v)) return BTREE_OLC_RESTART;
+            *result = btree_revive_slot(tree, node, pos, value);
+            btree_olc_unlock(node);
+            return BTREE_OLC_DONE;
+        }
+
+        if (head.is_leaf) {
+            /* 잠금을 올렸다면 노드는 검색한 그대로이며 빈 슬롯이 있음 */
+            if (!btree_olc_upgrade(node, v)) return BTREE_OLC_RESTART;
+            *result = btree_node_insert_at(tree, node, pos >= 0 ? pos : -(pos + 1), key, value);
+            btree_olc_unlock(node);
+            if (*result == BTREE_SUCCESS) {
+                btree_counter_add(tree, &tree->key_count, 1);
+            }
+            return BTREE_OLC_DONE;
+        }
+
+        int child_index = btree_descend_index(pos);
+        btree_node_t *child = btree_olc_child(node, child_index);
+        if (!btree_olc_validate(&node->version, v)) return BTREE_OLC_RESTART;
+        uint32_t child_v = btree_olc_read_begin(&child->version);
+
+        btree_node_t child_head;
+        btree_node_load_head(child, &child_head);
+        if (child_head.num_keys >= child->capacity) {
+            /* 부모와 자식만 잠그고 분할한 뒤 처음부터 다시 */
+            if (!btree_olc_upgrade(node, v)) return BTREE_OLC_RESTART;
+            if (!btree_olc_upgrade(child, child_v)) {
+                btree_olc_unlock(node);
+                return BTREE_OLC_RESTART;
+            }
+            btree_result_t split = btree_split_child(tree, node, child_index, false);
+            btree_olc_unlock(child);
+            btree_olc_unlock(node);
+            if (split != BTREE_SUCCESS) {
+                *result = split;
+                return BTREE_OLC_DONE;
+            }
+            return BTREE_OLC_RESTART;
+        }
+
+        /* 자식 버전을 읽는 동안 부모가 바뀌지 않았는지 확인 */
+        if (!btree_olc_validate(&node->version, v)) return BTREE_OLC_RESTART;
+        node = child;
+        v = child_v;
+    }
+}
+
+/**
+ * @brief 동시 모드 삽입 (btree_insert에서 호출)
+ */
+btree_result_t btree_concurrent_insert(btree_t *tree, const void *key, const void *value) {
+    btree_sync_t *sync = tree->lock;
+    btree_result_t result = BTREE_SUCCESS;
+
+    pthread_rwlock_rdlock(&sync->writers);
+    while (btree_olc_insert(tree, sync, key, value, &result) == BTREE_OLC_RESTART) {
+        btree_cpu_relax();
+    }
+    pthread_rwlock_unlock(&sync->writers);
+    return result;
+}
+
+/* 검색 한 번 시도 (찾으면 *slot에 값 위치) */
+static btree_olc_status_t btree_olc_lookup(const btree_t *tree, const btree_sync_t *sync,
+                                           uint32_t seq, const void *key, void *value_out,
+                                           void **slot) {
+    bool plus = btree_is_plus(tree);
+    *slot = NULL;
+
+    btree_node_t *node = __atomic_load_n(&tree->root, __ATOMIC_ACQUIRE);
+    if (!node) return BTREE_OLC_DONE;
+    uint32_t v = btree_olc_read_begin(&node->version);
+
+    for (;;) {
+        btree_node_t head;
+        btree_node_load_head(node, &head);
+        int count = head.num_keys;
+        if (count > (int)node->capacity) return BTREE_OLC_RESTART;
+        int pos = btree_olc_find(tree, node, count, key);
+
+        if (pos >= 0 && (head.is_leaf || !plus)) {
+            bool dead = btree_olc_slot_dead(node, pos);
+            void *value = btree_get_value_ptr(node, pos, &tree->value_type);
+            if (!dead && value_out) {
+                btree_atomic_load(value_out, value, tree->value_type.value_size);
+            }
+            if (!btree_olc_validate(&node->version, v)) return BTREE_OLC_RESTART;
+            if (!dead) *slot = value;
+            return BTREE_OLC_DONE;
+        }
+        if (head.is_leaf) {
+            return btree_olc_validate(&node->version, v) ? BTREE_OLC_DONE : BTREE_OLC_RESTART;
+        }
+
+        btree_node_t *child = btree_olc_child(node, btree_descend_index(pos));
+        if (!btree_olc_validate(&node->version, v) || !btree_olc_validate(&sync->seq, seq)) {
+            return BTREE_OLC_RESTART;
+        }
+        uint32_t child_v = btree_olc_read_begin(&child->version);
+        if (!btree_olc_validate(&node->version, v)) return BTREE_OLC_RESTART;
+        node = child;
+        v = child_v;
+    }
+}
+
+/*
+ * 빈 칸을 잡아 진입 에포크 게시 (모든 칸이 차 있으면 빌 때까지 대기).
+ * 게시한 뒤의 완전 장벽 덕분에, 회수하는 쪽이 이 칸을 비어 있다고 본 경우
+ * 이후의 노드 읽기는 그 전에 떼어 낸 노드에 닿지 않는다.
+ */
+static btree_epoch_slot_t* btree_epoch_enter(btree_sync_t *sync) {
+    if (!g_epoch_hint) g_epoch_hint = __atomic_add_fetch(&g_epoch_next, 1, __ATOMIC_RELAXED);
+
+    for (unsigned i = 0;; i++) {
+        btree_epoch_slot_t *slot = &sync->slots[(g_epoch_hint + i) % BTREE_EPOCH_SLOTS];
+        uint64_t expected = 0;
+        uint64_t epoch = __atomic_load_n(&sync->epoch, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->epoch, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&slot->epoch, &expected, epoch, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            return slot;
+        }
+        if ((i + 1) % BTREE_EPOCH_SLOTS == 0) btree_cpu_relax();
+    }
+}
+
+static void btree_epoch_exit(btree_epoch_slot_t *slot) {
+    __atomic_store_n(&slot->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 동시 모드 검색 (잠금 없음)
+ *
+ * value_out이 있으면 검증된 값을 복사한다.
+ * @return 값 위치 (찾지 못하면 NULL)
+ */
+void* btree_concurrent_search(btree_t *tree, const void *key, void *value_out) {
+    btree_sync_t *sync = tree->lock;
+    btree_epoch_slot_t *epoch = btree_epoch_enter(sync);
+
+    for (;;) {
+        uint32_t seq = btree_seq_begin(sync);
+        void *slot;
+        if (btree_olc_lookup(tree, sync, seq, key, value_out, &slot) == BTREE_OLC_DONE &&
+            btree_olc_validate(&sync->seq, seq)) {
+            btree_epoch_exit(epoch);
+            return slot;
+        }
+        btree_cpu_relax();
+    }
+}
+
+/* 묶음의 노드 해제 */
+static void btree_retire_free(btree_t *tree, btree_node_t *node) {
+    while (node) {
+        btree_node_t *next = node->parent;
+        btree_node_destroy(tree, node);
+        node = next;
+    }
+}
+
+/*
+ * 이번 배타 구간의 보류 노드에 에포크를 붙여 묶음으로 넘기고, 게시된 가장
+ * 작은 진입 에포크보다 앞선 묶음을 해제 (배타 구간 안에서 호출)
+ */
+static void btree_epoch_advance(btree_t *tree, btree_sync_t *sync) {
+    if (sync->retired) {
+        /* 떼어 낸 노드의 연결 해제가 에포크 증가보다 먼저 보이도록 */
+        uint64_t epoch = __atomic_fetch_add(&sync->epoch, 1, __ATOMIC_SEQ_CST);
+        btree_retire_batch_t *batch;
+        if (sync->batch_count == BTREE_RETIRE_BATCHES) {
+            /* 더 늦은 에포크로 합치면 해제만 늦어질 뿐 안전함 */
+            batch = &sync->batches[BTREE_RETIRE_BATCHES - 1];
+            btree_node_t *tail = sync->retired;
+            while (tail->parent) tail = tail->parent;
+            tail->parent = batch->nodes;
+            batch->nodes = sync->retired;
+            batch->count += sync->retired_count;
+        } else {
+            batch = &sync->batches[sync->batch_count++];
+            batch->nodes = sync->retired;
+            batch->count = sync->retired_count;
+        }
+        batch->epoch = epoch;
+        sync->retired = NULL;
+        sync->retired_count = 0;
+    }
+    if (sync->batch_count == 0) return;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < BTREE_EPOCH_SLOTS; i++) {
+        uint64_t e = __atomic_load_n(&sync->slots[i].epoch, __ATOMIC_ACQUIRE);
+        if (e && e < oldest) oldest = e;
+    }
+
+    int freed = 0;
+    while (freed < sync->batch_count && sync->batches[freed].epoch < oldest) {
+        btree_retire_free(tree, sync->batches[freed].nodes);
+        __atomic_sub_fetch(&sync->pending, sync->batches[freed].count, __ATOMIC_RELAXED);
+        freed++;
+    }
+    if (freed) {
+        sync->batch_count -= freed;
+        memmove(sync->batches, sync->batches + freed,
+                (size_t)sync->batch_count * sizeof(btree_retire_batch_t));
+    }
+}
+
+/**
+ * @brief 배타 쓰기 구간 시작 (동시 모드가 아니면 아무 일도 하지 않음)
+ */
+void btree_writer_begin(btree_t *tree) {
+    btree_sync_t *sync = tree->lock;
+    if (!sync) return;
+
+    pthread_rwlock_wrlock(&sync->writers);
+    __atomic_store_n(&sync->seq, sync->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 배타 쓰기 구간 종료
+ */
+void btree_writer_end(btree_t *tree) {
+    btree_sync_t *sync = tree->lock;
+    if (!sync) return;
+
+    __atomic_store_n(&sync->seq, sync->seq + 1, __ATOMIC_RELEASE);
+    btree_epoch_advance(tree, sync);
+    pthread_rwlock_unlock(&sync->writers);
+}
+
+/**
+ * @brief 트리에서 떨어져 나간 노드 해제 (동시 모드에서는 읽는 검색이 모두 떠날 때까지 보류)
+ */
+void btree_node_retire(btree_t *tree, btree_node_t *node) {
+    btree_sync_t *sync = tree->lock;
+    if (!sync) {
+        btree_node_destroy(tree, node);
+        return;
+    }
+
+    /* 읽는 스레드는 parent를 보지 않으므로 연결 필드로 재사용 */
+    node->parent = sync->retired;
+    sync->retired = node;
+    sync->retired_count++;
+    __atomic_add_fetch(&sync->pending, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 보류된 노드 모두 해제 (다른 스레드가 트리를 사용하지 않을 때)
+ */
+void btree_reclaim_retired(btree_t *tree) {
+    btree_sync_t *sync = tree->lock;
+    if (!sync) return;
+
+    btree_retire_free(tree, sync->retired);
+    for (int i = 0; i < sync->batch_count; i++) {
+        btree_retire_free(tree, sync->batches[i].nodes);
+    }
+    sync->retired = NULL;
+    sync->retired_count = 0;
+    sync->batch_count = 0;
+    __atomic_store_n(&sync->pending, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 해제를 기다리는 보류 노드 수 (동시 모드가 아니면 0)
+ */
+size_t btree_concurrent_retired(const btree_t *tree) {
+    const btree_sync_t *sync = tree ? tree->lock : NULL;
+    return sync ? __atomic_load_n(&sync->pending, __ATOMIC_RELAXED) : 0;
+}
+
+#endif
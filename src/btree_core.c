@@ -3,29 +3,132 @@
  * @brief B-Tree 핵심 알고리즘 구현
  */
 
-#include "../include/btree.h"
+#include "btree_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
-/* 전역 오류 상태 - C99에서는 thread_local 대신 static 사용 */
-static btree_result_t g_last_error = BTREE_SUCCESS;
+/*
+ * 마지막 오류 (스레드마다 따로)
+ *
+ * 여러 스레드가 검색하면서 같은 전역 변수에 쓰면 그 캐시 라인이 코어 사이를
+ * 오가고, 읽는 값도 다른 스레드의 오류일 수 있다.
+ */
+static BTREE_THREAD_LOCAL btree_result_t g_last_error = BTREE_SUCCESS;
+
+/* 오류 처리기 (btree_set_error_handler, 프로세스 전체에 하나) */
+typedef void (*btree_error_handler_t)(btree_result_t error, const char *message);
+static btree_error_handler_t g_error_handler;
 
-/* 오류 설정 함수 */
-static void btree_set_error(btree_result_t error) {
+#if defined(__GNUC__) || defined(__clang__)
+#define btree_handler_load() __atomic_load_n(&g_error_handler, __ATOMIC_ACQUIRE)
+#define btree_handler_store(h) __atomic_store_n(&g_error_handler, (h), __ATOMIC_RELEASE)
+#else
+#define btree_handler_load() (g_error_handler)
+#define btree_handler_store(h) (g_error_handler = (h))
+#endif
+
+/* 오류 설정 함수 (없는 키는 결과일 뿐이므로 처리기를 부르지 않음) */
+void btree_set_error(btree_result_t error) {
     g_last_error = error;
+    if (error == BTREE_ERROR_KEY_NOT_FOUND) return;
+
+    btree_error_handler_t handler = btree_handler_load();
+    if (BTREE_UNLIKELY(handler != NULL)) handler(error, btree_error_string(error));
+}
+
+/* B+Tree 내부 노드 용량: 리프와 같은 바이트 예산을 키와 자식 포인터에 사용 */
+static int btree_plus_internal_capacity(const btree_t *tree) {
+    size_t leaf_bytes = (size_t)tree->max_keys *
+                        (tree->key_type.key_size + tree->value_type.value_size);
+    size_t per_key = tree->key_type.key_size + sizeof(btree_node_t*);
+    size_t capacity = (leaf_bytes - sizeof(btree_node_t*)) / per_key;
+    
+    if (capacity < (size_t)tree->max_keys) capacity = tree->max_keys;
+    if (capacity > 2 * BTREE_MAX_DEGREE - 1) capacity = 2 * BTREE_MAX_DEGREE - 1;
+    return (int)capacity;
+}
+
+/* 차수로 노드 용량을 정함 (변형은 먼저 정해 둠) */
+static void btree_size_nodes(btree_t *tree, int degree) {
+    tree->degree = degree;
+    tree->max_keys = 2 * degree - 1;
+    tree->min_keys = degree - 1;
+    tree->internal_max_keys = btree_is_plus(tree) ? btree_plus_internal_capacity(tree)
+                                                  : tree->max_keys;
+    btree_update_search(tree);
+}
+
+/* SIMD 커널로 셀 수 있는 구간 (키 수, 커널이 없는 빌드나 키 크기면 0) */
+static int btree_simd_search_keys(size_t key_size) {
+#if defined(BTREE_SIMD_AVX2) || defined(BTREE_SIMD_SSE42) || defined(BTREE_SIMD_NEON)
+    if (key_size == 4 || key_size == 8) return (int)(BTREE_SIMD_SEARCH_BYTES / key_size);
+#endif
+    (void)key_size;
+    return 0;
+}
+
+/* 요청한 검색 방식을 노드 용량과 키 크기로 풀고 선형 구간 (키 수)을 돌려줌 */
+static btree_search_mode_t btree_search_resolve(const btree_t *tree, int *window) {
+    int capacity = tree->max_keys > tree->internal_max_keys ? tree->max_keys
+                                                            : tree->internal_max_keys;
+    int simd = btree_simd_search_keys(tree->key_type.key_size);
+    btree_search_mode_t mode = tree->search_mode;
+    
+    if (mode == BTREE_SEARCH_AUTO) {
+        /* 노드 전체가 한 번에 셀 구간 안이면 이진 탐색을 건너뜀 */
+        int scan = simd > BTREE_LINEAR_SEARCH_THRESHOLD ? simd : BTREE_LINEAR_SEARCH_THRESHOLD;
+        mode = capacity <= scan ? BTREE_SEARCH_LINEAR
+             : simd ? BTREE_SEARCH_SIMD : BTREE_SEARCH_BINARY;
+    } else if (mode == BTREE_SEARCH_SIMD && !simd) {
+        mode = BTREE_SEARCH_BINARY;
+    }
+    
+    switch (mode) {
+        case BTREE_SEARCH_LINEAR: *window = capacity; break;
+        case BTREE_SEARCH_SIMD:   *window = simd; break;
+        default:                  *window = BTREE_LINEAR_SEARCH_THRESHOLD; break;
+    }
+    return mode;
 }
 
-/* 키 포인터 계산 */
-static inline void* btree_get_key_ptr(const btree_node_t *node, int index,
-                                     const btree_type_info_t *key_type) {
-    return (char*)node->keys + (index * key_type->key_size);
+void btree_update_search(btree_t *tree) {
+    btree_search_resolve(tree, &tree->search_window);
 }
 
-/* 값 포인터 계산 */
-static inline void* btree_get_value_ptr(const btree_node_t *node, int index,
-                                       const btree_type_info_t *value_type) {
-    return (char*)node->values + (index * value_type->value_size);
+/**
+ * @brief 노드 바이트 예산에 맞는 차수
+ *
+ * 단일 블록 레이아웃 (헤더, 키, 자식 배열, 값, 캐시 라인 정렬)으로 잰 리프와
+ * 내부 노드가 모두 node_bytes에 들어가는 가장 큰 차수. 크기는 차수에 따라
+ * 늘기만 하므로 이진 탐색한다.
+ */
+int btree_degree_for_bytes(const btree_type_info_t *key_type,
+                           const btree_type_info_t *value_type,
+                           btree_variant_t variant, size_t node_bytes) {
+    if (!key_type || !value_type) return 0;
+    if (node_bytes == 0) node_bytes = btree_memory_page_size();
+    
+    btree_t probe;
+    memset(&probe, 0, sizeof(btree_t));
+    probe.key_type = *key_type;
+    probe.value_type = *value_type;
+    probe.variant = variant == BTREE_VARIANT_PLUS ? BTREE_VARIANT_PLUS : BTREE_VARIANT_STANDARD;
+    
+    int low = BTREE_MIN_DEGREE, high = BTREE_MAX_DEGREE;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        btree_node_layout_t leaf, internal;
+        btree_size_nodes(&probe, mid);
+        btree_node_compute_layout(&probe, true, &leaf);
+        btree_node_compute_layout(&probe, false, &internal);
+        if (leaf.block_size <= node_bytes && internal.block_size <= node_bytes) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
 }
 
 /**
@@ -39,6 +142,11 @@ btree_result_t btree_init(btree_t *tree, int degree,
         return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
     }
 
+    size_t node_bytes = 0;
+    if (degree == BTREE_DEGREE_AUTO) {
+        node_bytes = BTREE_DEFAULT_NODE_BYTES;
+        degree = btree_degree_for_bytes(key_type, value_type, BTREE_VARIANT_STANDARD, node_bytes);
+    }
     if (degree < BTREE_MIN_DEGREE || degree > BTREE_MAX_DEGREE) {
         return btree_set_error(BTREE_ERROR_INVALID_DEGREE), BTREE_ERROR_INVALID_DEGREE;
     }
@@ -46,17 +154,19 @@ btree_result_t btree_init(btree_t *tree, int degree,
     /* 기본값 초기화 */
     memset(tree, 0, sizeof(btree_t));
     
-    tree->degree = degree;
-    tree->max_keys = 2 * degree - 1;
-    tree->min_keys = degree - 1;
     tree->height = 0;
+    tree->variant = BTREE_VARIANT_STANDARD;
+    tree->fill_factor = BTREE_DEFAULT_FILL_FACTOR;
+    tree->node_bytes = node_bytes;
+    tree->search_mode = BTREE_SEARCH_AUTO;
     
     /* 타입 정보 복사 */
     memcpy(&tree->key_type, key_type, sizeof(btree_type_info_t));
     memcpy(&tree->value_type, value_type, sizeof(btree_type_info_t));
+    btree_size_nodes(tree, degree);
     
-    /* 할당자 설정 */
-    tree->allocator = allocator ? allocator : btree_default_allocator();
+    /* 할당자 설정 (지정하지 않으면 노드 크기별 공용 노드 풀) */
+    tree->allocator = allocator ? allocator : btree_node_pool_allocator();
     
     /* 통계 초기화 */
     tree->node_count = 0;
@@ -72,7 +182,11 @@ btree_result_t btree_init(btree_t *tree, int degree,
 void btree_cleanup(btree_t *tree) {
     if (!tree) return;
     
+    btree_wal_close(tree);
     btree_clear(tree);
+    btree_set_thread_safe(tree, false);
+    btree_enable_metrics(tree, 0);
+    btree_events_release(tree);
     
     /* 통계 리셋 */
     tree->node_count = 0;
@@ -81,77 +195,218 @@ void btree_cleanup(btree_t *tree) {
 }
 
 /**
- * @brief 노드 생성
+ * @brief 단일 블록 노드 레이아웃 계산
+ *
+ * 검색 경로에서 함께 읽히는 헤더, 키, 자식 배열을 앞쪽에 연속 배치하고
+ * 히트 시에만 읽는 값 배열을 뒤에 둔다.
  */
-btree_node_t* btree_node_create(btree_t *tree, bool is_leaf) {
-    if (!tree || !tree->allocator) return NULL;
+void btree_node_compute_layout(const btree_t *tree, bool is_leaf,
+                               btree_node_layout_t *layout) {
+    size_t key_align = tree->key_type.alignment;
+    size_t value_align = tree->value_type.alignment;
     
-    btree_node_t *node = tree->allocator->alloc(sizeof(btree_node_t));
-    if (!node) {
-        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
-        return NULL;
+    if (!btree_is_power_of_two(key_align)) key_align = sizeof(void*);
+    if (!btree_is_power_of_two(value_align)) value_align = sizeof(void*);
+    
+    size_t capacity = (size_t)btree_node_capacity_for(tree, is_leaf);
+    size_t offset = btree_align_size(sizeof(btree_node_t), key_align);
+    layout->keys_offset = offset;
+    offset += capacity * tree->key_type.key_size;
+    
+    if (is_leaf) {
+        layout->children_offset = 0;
+    } else {
+        offset = btree_align_size(offset, sizeof(btree_node_t*));
+        layout->children_offset = offset;
+        offset += (capacity + 1) * sizeof(btree_node_t*);
     }
     
-    /* 노드 초기화 */
+    if (btree_node_has_values(tree, is_leaf)) {
+        offset = btree_align_size(offset, value_align);
+        layout->values_offset = offset;
+        offset += capacity * tree->value_type.value_size;
+    } else {
+        layout->values_offset = 0;
+    }
+    
+    layout->block_size = btree_align_size(offset, BTREE_CACHE_LINE_SIZE);
+}
+
+/**
+ * @brief 노드 메모리 크기 계산 (통계용)
+ */
+size_t btree_node_memory_size(const btree_t *tree, const btree_node_t *node) {
+    size_t size;
+    
+    if (node->is_inline) {
+        btree_node_layout_t layout;
+        btree_node_compute_layout(tree, node->is_leaf, &layout);
+        bool exact = node->in_arena || btree_node_aligned(tree);
+        size = layout.block_size + (exact ? 0 : BTREE_CACHE_LINE_SIZE - 1);
+    } else {
+        size = sizeof(btree_node_t) + node->capacity * tree->key_type.key_size;
+        if (node->values) {
+            size += node->capacity * tree->value_type.value_size;
+        }
+        if (!node->is_leaf) {
+            size += (node->capacity + 1) * sizeof(btree_node_t*);
+        }
+    }
+    
+    /* 삭제 표시 배열은 단일 블록 레이아웃에서도 별도 할당 */
+    if (node->tombstones) {
+        size += node->capacity;
+    }
+    return size;
+}
+
+/* 단일 블록 노드 생성 */
+static btree_node_t* btree_node_create_inline(btree_t *tree, bool is_leaf) {
+    btree_node_layout_t layout;
+    btree_node_compute_layout(tree, is_leaf, &layout);
+    
+    /* 일반 할당자는 정렬을 보장하지 않으므로 여유분을 두고 직접 정렬
+     * (노드 풀과 node_alloc 블록은 이미 캐시 라인 정렬) */
+    size_t slack = btree_node_aligned(tree) ? 0 : BTREE_CACHE_LINE_SIZE - 1;
+    void *block = btree_node_alloc(tree, layout.block_size + slack);
+    if (!block) return NULL;
+    
+    char *base = (char*)(((uintptr_t)block + BTREE_CACHE_LINE_SIZE - 1) &
+                         ~(uintptr_t)(BTREE_CACHE_LINE_SIZE - 1));
+    memset(base, 0, layout.block_size);
+    
+    btree_node_t *node = (btree_node_t*)base;
+    node->is_inline = 1;
+    node->block = block;
+    node->keys = base + layout.keys_offset;
+    if (layout.values_offset) {
+        node->values = base + layout.values_offset;
+    }
+    if (!is_leaf) {
+        node->children = (btree_node_t**)(base + layout.children_offset);
+    }
+    return node;
+}
+
+/* 아레나의 남은 자리에서 단일 블록 노드를 잘라 냄 (자리가 없으면 NULL) */
+static btree_node_t* btree_node_carve(btree_t *tree, btree_arena_t *arena, bool is_leaf) {
+    btree_node_layout_t layout;
+    btree_node_compute_layout(tree, is_leaf, &layout);
+    if (arena->used + layout.block_size > arena->size) return NULL;
+    
+    char *base = arena->base + arena->used;
+    arena->used += layout.block_size;
+    btree_arena_ref(arena);
+    memset(base, 0, layout.block_size);
+    
+    btree_node_t *node = (btree_node_t*)base;
+    node->is_inline = 1;
+    node->in_arena = 1;
+    node->block = arena;
+    node->keys = base + layout.keys_offset;
+    if (layout.values_offset) {
+        node->values = base + layout.values_offset;
+    }
+    if (!is_leaf) {
+        node->children = (btree_node_t**)(base + layout.children_offset);
+    }
+    return node;
+}
+
+/* 분리 할당 노드 생성 (헤더, 키, 값, 자식 배열을 각각 할당) */
+static btree_node_t* btree_node_create_split(btree_t *tree, bool is_leaf) {
+    btree_node_t *node = btree_node_alloc(tree, sizeof(btree_node_t));
+    if (!node) return NULL;
+    
     memset(node, 0, sizeof(btree_node_t));
-    node->is_leaf = is_leaf ? 1 : 0;
-    node->num_keys = 0;
-    node->capacity = tree->max_keys;
-    node->ref_count = 1;
+    size_t capacity = (size_t)btree_node_capacity_for(tree, is_leaf);
     
     /* 키 배열 할당 */
-    size_t key_array_size = tree->max_keys * tree->key_type.key_size;
-    node->keys = tree->allocator->alloc(key_array_size);
+    size_t key_array_size = capacity * tree->key_type.key_size;
+    node->keys = btree_node_alloc(tree, key_array_size);
     if (!node->keys) {
         tree->allocator->free(node);
-        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
         return NULL;
     }
     
-    /* 값 배열 할당 (표준 B-Tree에서는 모든 노드에서 값 저장) */
-    size_t value_array_size = tree->max_keys * tree->value_type.value_size;
-    node->values = tree->allocator->alloc(value_array_size);
-    if (!node->values) {
-        tree->allocator->free(node->keys);
-        tree->allocator->free(node);
-        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
-        return NULL;
+    /* 값 배열 할당 (표준 B-Tree는 모든 노드, B+Tree는 리프만) */
+    if (btree_node_has_values(tree, is_leaf)) {
+        size_t value_array_size = capacity * tree->value_type.value_size;
+        node->values = btree_node_alloc(tree, value_array_size);
+        if (!node->values) {
+            tree->allocator->free(node->keys);
+            tree->allocator->free(node);
+            return NULL;
+        }
     }
     
     /* 자식 배열 할당 (내부 노드만) */
     if (!is_leaf) {
-        size_t children_array_size = (tree->max_keys + 1) * sizeof(btree_node_t*);
-        node->children = tree->allocator->alloc(children_array_size);
+        size_t children_array_size = (capacity + 1) * sizeof(btree_node_t*);
+        node->children = btree_node_alloc(tree, children_array_size);
         if (!node->children) {
+            if (node->values) tree->allocator->free(node->values);
             tree->allocator->free(node->keys);
             tree->allocator->free(node);
-            btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
             return NULL;
         }
         memset(node->children, 0, children_array_size);
     }
     
-    /* 통계 업데이트 */
-    tree->node_count++;
-    tree->total_memory += sizeof(btree_node_t) + key_array_size;
-    if (is_leaf) {
-        tree->total_memory += tree->max_keys * tree->value_type.value_size;
-    } else {
-        tree->total_memory += (tree->max_keys + 1) * sizeof(btree_node_t*);
-    }
-    
     return node;
 }
 
 /**
- * @brief 노드 소멸
+ * @brief 노드 생성
  */
-void btree_node_destroy(btree_t *tree, btree_node_t *node) {
-    if (!tree || !node || !tree->allocator) return;
+btree_node_t* btree_node_create(btree_t *tree, bool is_leaf) {
+    return btree_node_create_in(tree, NULL, is_leaf);
+}
+
+/**
+ * @brief 아레나에 노드 생성 (arena가 NULL이거나 가득 차면 트리의 할당자 사용)
+ */
+btree_node_t* btree_node_create_in(btree_t *tree, btree_arena_t *arena, bool is_leaf) {
+    if (!tree || !tree->allocator) return NULL;
     
-    /* 참조 카운트 감소 */
-    if (--node->ref_count > 0) return;
+    btree_node_t *node = arena ? btree_node_carve(tree, arena, is_leaf) : NULL;
+    if (!node) {
+        node = (tree->flags & BTREE_FLAG_INLINE_NODES)
+             ? btree_node_create_inline(tree, is_leaf)
+             : btree_node_create_split(tree, is_leaf);
+    }
+    if (!node) {
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    
+    /* 노드 초기화 */
+    node->is_leaf = is_leaf ? 1 : 0;
+    node->num_keys = 0;
+    node->capacity = btree_node_capacity_for(tree, is_leaf);
+    node->ref_count = 1;
+    
+    /* 통계 업데이트 */
+    btree_counter_add(tree, &tree->node_count, 1);
+    btree_counter_add(tree, &tree->total_memory, btree_node_memory_size(tree, node));
     
+    /* 지연 삭제 모드에서는 모든 노드가 삭제 표시 배열을 가짐 */
+    if (tree->flags & BTREE_FLAG_LAZY_DELETE) {
+        node->tombstones = btree_node_alloc(tree, node->capacity);
+        if (!node->tombstones) {
+            btree_node_destroy(tree, node);
+            btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+            return NULL;
+        }
+        memset(node->tombstones, 0, node->capacity);
+        btree_counter_add(tree, &tree->total_memory, node->capacity);
+    }
+    
+    return node;
+}
+
+/* 마지막 참조가 놓인 노드의 내용과 메모리 해제 (자식은 참조 하나씩 놓음) */
+static void btree_node_free(btree_t *tree, btree_node_t *node) {
     /* 키 및 값 소멸자 호출 */
     if (tree->key_type.destroy) {
         tree->key_type.destroy(node->keys, node->num_keys);
@@ -167,33 +422,117 @@ void btree_node_destroy(btree_t *tree, btree_node_t *node) {
                 btree_node_destroy(tree, node->children[i]);
             }
         }
-        tree->allocator->free(node->children);
     }
+    BTREE_METRIC_ADD(tree, node_frees, 1);
     
     /* 메모리 해제 */
+    if (node->tombstones) tree->allocator->free(node->tombstones);
+    if (node->in_arena) {
+        btree_arena_release(tree, node->block);
+        return;
+    }
+    if (node->is_inline) {
+        tree->allocator->free(node->block);
+        return;
+    }
+    
+    if (node->children) tree->allocator->free(node->children);
     if (node->keys) tree->allocator->free(node->keys);
     if (node->values) tree->allocator->free(node->values);
     tree->allocator->free(node);
+}
+
+/* 키, 값, 삭제 표시를 빈 노드 dst로 복사 (타입의 copy 함수 사용, 자식은 제외) */
+void btree_node_copy_slots(const btree_t *tree, btree_node_t *dst, const btree_node_t *src) {
+    int n = src->num_keys;
+    if (tree->key_type.copy) {
+        tree->key_type.copy(dst->keys, src->keys, n);
+    } else {
+        memcpy(dst->keys, src->keys, (size_t)n * tree->key_type.key_size);
+    }
+    if (src->values && dst->values) {
+        if (tree->value_type.copy) {
+            tree->value_type.copy(dst->values, src->values, n);
+        } else {
+            memcpy(dst->values, src->values, (size_t)n * tree->value_type.value_size);
+        }
+    }
+    if (dst->tombstones && src->tombstones) {
+        memcpy(dst->tombstones, src->tombstones, n);
+    }
+    dst->num_keys = n;
+}
+
+/* 트리 집계에서 노드 하나를 뺌 */
+static void btree_node_uncount(btree_t *tree, const btree_node_t *node) {
+    if (tree->append_leaf == node) tree->append_leaf = NULL;
+    btree_replica_forget(tree, node);
+    btree_counter_add(tree, &tree->node_count, (size_t)-1);
+    btree_counter_add(tree, &tree->total_memory, 0 - btree_node_memory_size(tree, node));
+}
+
+/**
+ * @brief 노드 소멸
+ *
+ * 참조 하나를 놓고, 다른 트리가 아직 참조하면 (btree_copy) 그대로 둔다.
+ */
+void btree_node_destroy(btree_t *tree, btree_node_t *node) {
+    if (!tree || !node || !tree->allocator) return;
     
-    /* 통계 업데이트 */
-    tree->node_count--;
+    /* 참조 카운트 감소 */
+    if (!btree_node_unref(node)) return;
+    
+    btree_node_uncount(tree, node);
+    btree_node_free(tree, node);
 }
 
 /**
- * @brief 노드에서 키 검색 (이진 검색)
+ * @brief 공유 노드의 전용 사본 생성 (경로 복사)
+ *
+ * 키와 값은 타입의 copy 함수로 복사하고 자식은 참조만 하나씩 늘려 공유한다.
+ * 원본은 이 트리의 집계에서 빠지며 다른 트리에 남는다 (그사이 다른 트리가
+ * 놓았으면 여기서 해제). 사본의 자식은 이제 공유 노드이므로 쓰기는 계속
+ * 위에서부터 이 함수를 거친다. arena가 있으면 사본을 그 안에 만든다 (재배치).
  */
-int btree_node_find_key(const btree_node_t *node, const void *key,
-                       const btree_type_info_t *key_type) {
-    if (!node || !key || !key_type || node->num_keys == 0) {
-        return -1;
+btree_node_t* btree_node_unshare(btree_t *tree, btree_node_t *node, btree_node_t *parent,
+                                 btree_arena_t *arena) {
+    btree_node_t *copy = btree_node_create_in(tree, arena, node->is_leaf);
+    if (!copy) return NULL;
+    
+    btree_node_copy_slots(tree, copy, node);
+    if (!node->is_leaf) {
+        memcpy(copy->children, node->children, (node->num_keys + 1) * sizeof(btree_node_t*));
+        for (int i = 0; i <= node->num_keys; i++) {
+            btree_node_ref(copy->children[i]);
+        }
+    }
+    copy->parent = parent;
+    
+    btree_node_uncount(tree, node);
+    if (btree_node_unref(node)) {
+        btree_node_free(tree, node);
+    }
+    return copy;
+}
+
+/**
+ * @brief 정렬된 키 배열에서 키 검색 (이진 검색)
+ *
+ * 타입 특화 검색 함수가 있으면 사용하고, 없으면 compare 함수 포인터로
+ * 이진 검색한다. 노드 외에 파일 페이지의 키 배열에도 쓰인다.
+ */
+static int btree_keys_find_window(const void *keys, int count, const void *key,
+                                  const btree_type_info_t *key_type, int window) {
+    if (key_type->search) {
+        return key_type->search(keys, count, key, window);
     }
     
     int left = 0;
-    int right = node->num_keys - 1;
+    int right = count - 1;
     
     while (left <= right) {
         int mid = (left + right) / 2;
-        void *mid_key = btree_get_key_ptr(node, mid, key_type);
+        const void *mid_key = (const char*)keys + (size_t)mid * key_type->key_size;
         
         int cmp = key_type->compare(key, mid_key);
         if (cmp == 0) {
@@ -208,13 +547,32 @@ int btree_node_find_key(const btree_node_t *node, const void *key,
     return -(left + 1);  /* 삽입 위치 반환 */
 }
 
+/* 트리의 노드 내 검색 방식 (search_window)으로 키 배열 검색 */
+int btree_keys_find(const btree_t *tree, const void *keys, int count, const void *key) {
+    return btree_keys_find_window(keys, count, key, &tree->key_type, tree->search_window);
+}
+
 /**
- * @brief 노드에 키-값 쌍 삽입
+ * @brief 노드에서 키 검색 (이진 검색)
+ *
+ * 트리 없이 부르는 공개 함수라 선형 구간은 BTREE_LINEAR_SEARCH_THRESHOLD이다.
+ * 트리 안의 경로는 btree_node_search (트리의 검색 방식)를 쓴다.
  */
-btree_result_t btree_node_insert_key(btree_node_t *node, int index,
-                                    const void *key, const void *value,
-                                    const btree_type_info_t *key_type,
-                                    const btree_type_info_t *value_type) {
+int btree_node_find_key(const btree_node_t *node, const void *key,
+                       const btree_type_info_t *key_type) {
+    if (!node || !key || !key_type || node->num_keys == 0) {
+        return -1;
+    }
+    return btree_keys_find_window(node->keys, node->num_keys, key, key_type,
+                                  BTREE_LINEAR_SEARCH_THRESHOLD);
+}
+
+/* 노드에 키-값 쌍 삽입 (atomic이면 잠금 없는 검색과 겹쳐도 되도록 원자적으로 기록) */
+static btree_result_t btree_node_insert_slot(btree_node_t *node, int index,
+                                             const void *key, const void *value,
+                                             const btree_type_info_t *key_type,
+                                             const btree_type_info_t *value_type,
+                                             bool atomic) {
     if (!node || !key || !key_type || index < 0 || index > node->num_keys) {
         return BTREE_ERROR_NULL_POINTER;
     }
@@ -223,66 +581,78 @@ btree_result_t btree_node_insert_key(btree_node_t *node, int index,
         return BTREE_ERROR_INVALID_OPERATION;
     }
     
+    /*
+     * 복사가 실패할 수 있는 키 타입 (validate 제공)은 노드를 건드리기 전에
+     * 임시 슬롯에 먼저 복사해 보고, 실패하면 노드를 그대로 두고 오류를 반환한다.
+     */
+    uint64_t local_key[16];
+    void *staged = NULL;
+    if (key_type->copy && key_type->validate) {
+        staged = key_type->key_size <= sizeof(local_key) ? local_key : malloc(key_type->key_size);
+        if (!staged) {
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        key_type->copy(staged, key, 1);
+        if (!key_type->validate(staged)) {
+            if (staged != local_key) free(staged);
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    
     /* 키들을 뒤로 이동 */
     if (index < node->num_keys) {
-        size_t move_size = (node->num_keys - index) * key_type->key_size;
-        void *src = btree_get_key_ptr(node, index, key_type);
-        void *dst = btree_get_key_ptr(node, index + 1, key_type);
+        size_t tail = node->num_keys - index;
+        btree_slots_move(key_type, key_type->key_size, btree_get_key_ptr(node, index + 1, key_type),
+                         btree_get_key_ptr(node, index, key_type), tail, atomic);
         
-        if (key_type->move) {
-            key_type->move(dst, src, node->num_keys - index);
-        } else {
-            memmove(dst, src, move_size);
+        /* 값들도 이동 (표준 B-Tree에서는 내부 노드에도 값 저장) */
+        if (node->values && value_type) {
+            btree_slots_move(value_type, value_type->value_size,
+                             btree_get_value_ptr(node, index + 1, value_type),
+                             btree_get_value_ptr(node, index, value_type), tail, atomic);
         }
         
-        /* 값들도 이동 (리프 노드의 경우) */
-        if (node->is_leaf && node->values && value_type) {
-            size_t value_move_size = (node->num_keys - index) * value_type->value_size;
-            void *value_src = btree_get_value_ptr(node, index, value_type);
-            void *value_dst = btree_get_value_ptr(node, index + 1, value_type);
-            
-            if (value_type->move) {
-                value_type->move(value_dst, value_src, node->num_keys - index);
-            } else {
-                memmove(value_dst, value_src, value_move_size);
-            }
+        /* 삭제 표시 이동 */
+        if (node->tombstones) {
+            btree_node_memmove(node->tombstones + index + 1, node->tombstones + index, tail,
+                               atomic);
         }
         
         /* 자식 포인터들 이동 (내부 노드의 경우) */
         if (!node->is_leaf && node->children) {
-            memmove(&node->children[index + 2], &node->children[index + 1],
-                   (node->num_keys - index) * sizeof(btree_node_t*));
+            btree_node_memmove(&node->children[index + 2], &node->children[index + 1],
+                               tail * sizeof(btree_node_t*), atomic);
         }
     }
     
+    if (node->tombstones) {
+        btree_slot_mark(node->tombstones + index, 0, atomic);
+    }
+    
     /* 새 키 복사 */
     void *key_slot = btree_get_key_ptr(node, index, key_type);
-    if (key_type->copy) {
-        key_type->copy(key_slot, key, 1);
+    if (staged) {
+        btree_node_memmove(key_slot, staged, key_type->key_size, atomic);
+        if (staged != local_key) free(staged);
     } else {
-        memcpy(key_slot, key, key_type->key_size);
+        btree_slot_store(key_type, key_type->key_size, key_slot, key, atomic);
     }
     
     /* 새 값 복사 (표준 B-Tree에서는 내부 노드와 리프 노드 모두에서 값 저장) */
     if (node->values && value && value_type) {
-        void *value_slot = btree_get_value_ptr(node, index, value_type);
-        if (value_type->copy) {
-            value_type->copy(value_slot, value, 1);
-        } else {
-            memcpy(value_slot, value, value_type->value_size);
-        }
+        btree_slot_store(value_type, value_type->value_size,
+                         btree_get_value_ptr(node, index, value_type), value, atomic);
     }
     
-    node->num_keys++;
+    btree_node_store_count(node, node->num_keys + 1, atomic);
     return BTREE_SUCCESS;
 }
 
-/**
- * @brief 노드에서 키 제거
- */
-btree_result_t btree_node_remove_key(btree_node_t *node, int index,
-                                    const btree_type_info_t *key_type,
-                                    const btree_type_info_t *value_type) {
+/* 노드에서 키 제거 (atomic이면 잠금 없는 검색과 겹쳐도 되도록 원자적으로 기록) */
+static btree_result_t btree_node_remove_slot(btree_node_t *node, int index,
+                                             const btree_type_info_t *key_type,
+                                             const btree_type_info_t *value_type,
+                                             bool atomic) {
     if (!node || index < 0 || index >= node->num_keys) {
         return BTREE_ERROR_INVALID_OPERATION;
     }
@@ -293,82 +663,147 @@ btree_result_t btree_node_remove_key(btree_node_t *node, int index,
         key_type->destroy(key_slot, 1);
     }
     
-    /* 값 소멸자 호출 (리프 노드의 경우) */
-    if (node->is_leaf && node->values && value_type && value_type->destroy) {
+    /* 값 소멸자 호출 */
+    if (node->values && value_type && value_type->destroy) {
         void *value_slot = btree_get_value_ptr(node, index, value_type);
         value_type->destroy(value_slot, 1);
     }
     
     /* 뒤의 키들을 앞으로 이동 */
     if (index < node->num_keys - 1) {
-        size_t move_size = (node->num_keys - index - 1) * key_type->key_size;
-        void *dst = btree_get_key_ptr(node, index, key_type);
-        void *src = btree_get_key_ptr(node, index + 1, key_type);
+        size_t tail = node->num_keys - index - 1;
+        btree_slots_move(key_type, key_type->key_size, btree_get_key_ptr(node, index, key_type),
+                         btree_get_key_ptr(node, index + 1, key_type), tail, atomic);
         
-        if (key_type->move) {
-            key_type->move(dst, src, node->num_keys - index - 1);
-        } else {
-            memmove(dst, src, move_size);
+        /* 값들도 이동 (표준 B-Tree에서는 내부 노드에도 값 저장) */
+        if (node->values && value_type) {
+            btree_slots_move(value_type, value_type->value_size,
+                             btree_get_value_ptr(node, index, value_type),
+                             btree_get_value_ptr(node, index + 1, value_type), tail, atomic);
         }
         
-        /* 값들도 이동 (리프 노드의 경우) */
-        if (node->is_leaf && node->values && value_type) {
-            size_t value_move_size = (node->num_keys - index - 1) * value_type->value_size;
-            void *value_dst = btree_get_value_ptr(node, index, value_type);
-            void *value_src = btree_get_value_ptr(node, index + 1, value_type);
-            
-            if (value_type->move) {
-                value_type->move(value_dst, value_src, node->num_keys - index - 1);
-            } else {
-                memmove(value_dst, value_src, value_move_size);
-            }
+        /* 삭제 표시 이동 */
+        if (node->tombstones) {
+            btree_node_memmove(node->tombstones + index, node->tombstones + index + 1, tail,
+                               atomic);
         }
         
         /* 자식 포인터들 이동 (내부 노드의 경우) */
         if (!node->is_leaf && node->children) {
-            memmove(&node->children[index + 1], &node->children[index + 2],
-                   (node->num_keys - index - 1) * sizeof(btree_node_t*));
+            btree_node_memmove(&node->children[index + 1], &node->children[index + 2],
+                               tail * sizeof(btree_node_t*), atomic);
         }
     }
     
-    node->num_keys--;
+    btree_node_store_count(node, node->num_keys - 1, atomic);
     return BTREE_SUCCESS;
 }
 
 /**
- * @brief B-Tree에서 검색
+ * @brief 노드에 키-값 쌍 삽입
  */
-void* btree_search(btree_t *tree, const void *key) {
-    if (!tree || !key) {
-        btree_set_error(BTREE_ERROR_NULL_POINTER);
-        return NULL;
+btree_result_t btree_node_insert_key(btree_node_t *node, int index,
+                                    const void *key, const void *value,
+                                    const btree_type_info_t *key_type,
+                                    const btree_type_info_t *value_type) {
+    return btree_node_insert_slot(node, index, key, value, key_type, value_type, false);
+}
+
+/**
+ * @brief 노드에서 키 제거
+ */
+btree_result_t btree_node_remove_key(btree_node_t *node, int index,
+                                    const btree_type_info_t *key_type,
+                                    const btree_type_info_t *value_type) {
+    return btree_node_remove_slot(node, index, key_type, value_type, false);
+}
+
+/* 트리의 노드에 키-값 쌍 삽입 (동시 모드에서는 잠금 없는 검색과 겹칠 수 있음) */
+btree_result_t btree_node_insert_at(btree_t *tree, btree_node_t *node, int index,
+                                    const void *key, const void *value) {
+    return btree_node_insert_slot(node, index, key, value, &tree->key_type, &tree->value_type,
+                                  btree_is_concurrent(tree));
+}
+
+/* 트리의 노드에서 키 제거 (동시 모드에서는 잠금 없는 검색과 겹칠 수 있음) */
+btree_result_t btree_node_remove_at(btree_t *tree, btree_node_t *node, int index) {
+    return btree_node_remove_slot(node, index, &tree->key_type, &tree->value_type,
+                                  btree_is_concurrent(tree));
+}
+
+/**
+ * @brief B-Tree에서 검색 (오류 상태는 건드리지 않음, 없으면 NULL)
+ */
+static void* btree_search_key(btree_t *tree, const void *key) {
+    if (BTREE_UNLIKELY(btree_is_concurrent(tree))) {
+        return btree_concurrent_search(tree, key, NULL);
+    }
+    if (BTREE_UNLIKELY(btree_is_mapped(tree))) {
+        return btree_mapped_search(tree, key, NULL);
     }
     
-    btree_node_t *node = tree->root;
+    btree_node_t *node = btree_search_root(tree);
+    bool plus = btree_is_plus(tree);
     
     while (node) {
-        int pos = btree_node_find_key(node, key, &tree->key_type);
+        btree_node_access(tree, node, false);
+        int pos = btree_node_search(tree, node, key);
         
-        if (pos >= 0) {
+        if (pos >= 0 && (node->is_leaf || !plus)) {
+            /* 복제본에는 키만 있음 */
+            if (BTREE_UNLIKELY(node->is_replica)) node = node->parent;
+            /* 삭제 표시된 키는 없는 키로 취급 */
+            if (BTREE_UNLIKELY(btree_slot_is_dead(node, pos))) return NULL;
             /* 키를 찾았음 - 표준 B-Tree에서는 내부 노드와 리프 노드 모두에서 값 반환 */
             return btree_get_value_ptr(node, pos, &tree->value_type);
         } else {
-            if (node->is_leaf) {
-                /* 리프 노드에서 못 찾았음 */
-                btree_set_error(BTREE_ERROR_KEY_NOT_FOUND);
-                return NULL;
-            }
+            /* 리프 노드에서 못 찾았음 */
+            if (node->is_leaf) return NULL;
             
             /* 적절한 자식으로 이동 */
-            int child_index = -(pos + 1);
-            node = node->children[child_index];
+            node = node->children[btree_descend_index(pos)];
         }
     }
-    
-    btree_set_error(BTREE_ERROR_KEY_NOT_FOUND);
     return NULL;
 }
 
+/* 계측이나 이벤트 구독이 있으면 연산 수, 지연 시간, 이벤트도 기록 */
+static void* btree_search_observed(btree_t *tree, const void *key) {
+    if (BTREE_LIKELY(!btree_is_observed(tree))) {
+        return btree_search_key(tree, key);
+    }
+    
+    uint64_t start = btree_op_begin(tree);
+    void *slot = btree_search_key(tree, key);
+    btree_op_end(tree, BTREE_METRIC_SEARCH, start);
+    btree_event_emit(tree, BTREE_EVENT_SEARCH, key, slot);
+    return slot;
+}
+
+/* 찾으면 오류 상태에 아무것도 쓰지 않음 (없으면 이 스레드의 마지막 오류만) */
+void* btree_search(btree_t *tree, const void *key) {
+    if (!tree || !key) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return NULL;
+    }
+    
+    void *slot = btree_search_observed(tree, key);
+    if (BTREE_UNLIKELY(!slot)) btree_set_error(BTREE_ERROR_KEY_NOT_FOUND);
+    return slot;
+}
+
+/**
+ * @brief 상태와 값 포인터를 함께 반환하는 검색 (오류 상태는 건드리지 않음)
+ */
+btree_lookup_t btree_lookup(btree_t *tree, const void *key) {
+    btree_lookup_t result = { BTREE_ERROR_NULL_POINTER, NULL };
+    if (!tree || !key) return result;
+    
+    result.value = btree_search_observed(tree, key);
+    result.status = result.value ? BTREE_SUCCESS : BTREE_ERROR_KEY_NOT_FOUND;
+    return result;
+}
+
 /**
  * @brief 노드 분할
  */
@@ -381,6 +816,8 @@ btree_result_t btree_split_node(btree_t *tree, btree_node_t *node,
     if (node->num_keys < tree->max_keys) {
         return BTREE_ERROR_INVALID_OPERATION;
     }
+    btree_replica_touch(tree, node);
+    BTREE_METRIC_ADD(tree, splits, 1);
     
     /* 새 노드 생성 */
     *new_node = btree_node_create(tree, node->is_leaf);
@@ -427,8 +864,8 @@ btree_result_t btree_split_node(btree_t *tree, btree_node_t *node,
             memcpy((*new_node)->keys, src_keys, keys_size);
         }
         
-        /* 값들도 이동 (리프 노드의 경우) */
-        if (node->is_leaf && node->values) {
+        /* 값들도 이동 (표준 B-Tree에서는 내부 노드에도 값 저장) */
+        if (node->values) {
             void *src_values = btree_get_value_ptr(node, mid + 1, &tree->value_type);
             size_t values_size = keys_to_move * tree->value_type.value_size;
             
@@ -447,7 +884,7 @@ btree_result_t btree_split_node(btree_t *tree, btree_node_t *node,
             /* 부모 포인터 업데이트 */
             for (int i = 0; i <= keys_to_move; i++) {
                 if ((*new_node)->children[i]) {
-                    (*new_node)->children[i]->parent = *new_node;
+                    btree_node_set_parent((*new_node)->children[i], *new_node);
                 }
             }
         }
@@ -461,7 +898,7 @@ btree_result_t btree_split_node(btree_t *tree, btree_node_t *node,
     node->num_keys = mid;
     
     /* B+Tree의 경우 리프 노드 연결 */
-    if (node->is_leaf) {
+    if (node->is_leaf && btree_has_leaf_links(tree)) {
         (*new_node)->next_leaf = node->next_leaf;
         if (node->next_leaf) {
             node->next_leaf->prev_leaf = *new_node;
@@ -474,192 +911,455 @@ btree_result_t btree_split_node(btree_t *tree, btree_node_t *node,
 }
 
 /**
- * @brief B-Tree에 삽입 (재귀 헬퍼)
+ * @brief 가득 찬 자식 노드 분할
+ *
+ * parent->children[index]의 중간 키(와 값)를 부모의 index 위치로 옮기고
+ * 오른쪽 절반을 새 형제 노드로 이동한다. 키는 복사하지 않고 슬롯째
+ * 옮기므로 임시 버퍼가 필요 없다. 부모에는 빈 슬롯이 있어야 한다.
+ *
+ * B+Tree의 리프는 모든 키를 리프에 남기고, 오른쪽 리프의 첫 키 사본을
+ * 구분 키로 부모에 올린다.
+ *
+ * append면 (오른쪽 끝 경로에서 마지막 키 뒤로 삽입) 형제에는 마지막 키
+ * 하나만 옮겨 왼쪽 노드를 거의 가득 채운 채 남긴다. 오른쪽 끝 경로의
+ * 노드는 그래서 최소 키 수보다 적을 수 있다.
  */
-static btree_result_t btree_insert_recursive(btree_t *tree, btree_node_t *node,
-                                            const void *key, const void *value,
-                                            void **split_key, btree_node_t **new_child) {
-    int pos = btree_node_find_key(node, key, &tree->key_type);
+btree_result_t btree_split_child(btree_t *tree, btree_node_t *parent, int index, bool append) {
+    BTREE_METRIC_ADD(tree, splits, 1);
+    btree_node_t *child = parent->children[index];
+    bool copy_up = child->is_leaf && btree_is_plus(tree);
+    int mid = copy_up ? child->num_keys / 2 : ((int)child->capacity - 1) / 2;
+    if (append) {
+        mid = copy_up ? child->num_keys - 1 : child->num_keys - 2;
+    }
+    int first = copy_up ? mid : mid + 1;        /* 형제로 옮길 첫 슬롯 */
+    int right_keys = child->num_keys - first;
     
-    if (pos >= 0) {
-        /* 중복 키 */
-        if (!(tree->flags & BTREE_FLAG_ALLOW_DUPLICATES)) {
-            return BTREE_ERROR_DUPLICATE_KEY;
+    btree_node_t *sibling = btree_node_create(tree, child->is_leaf);
+    if (!sibling) return BTREE_ERROR_MEMORY_ALLOCATION;
+    
+    /* 오른쪽 절반을 형제 노드로 이동 */
+    btree_move_slots(tree, sibling, 0, child, first, right_keys);
+    if (!child->is_leaf) {
+        memcpy(sibling->children, &child->children[first],
+               (right_keys + 1) * sizeof(btree_node_t*));
+        for (int i = 0; i <= right_keys; i++) {
+            btree_node_set_parent(sibling->children[i], sibling);
         }
     }
+    sibling->num_keys = right_keys;
+    sibling->parent = parent;
+    if (tree->append_leaf == child) tree->append_leaf = sibling;
     
-    if (node->is_leaf) {
-        /* 리프 노드에 직접 삽입 */
-        int insert_pos = (pos >= 0) ? pos : -(pos + 1);
-        
-        if (node->num_keys >= tree->max_keys) {
-            /* 노드가 가득 참 - 분할 필요 */
-            btree_result_t result = btree_split_node(tree, node, new_child, split_key);
-            if (result != BTREE_SUCCESS) return result;
-            
-            /* 분할 키와 비교하여 적절한 노드에 삽입 */
-            int cmp = tree->key_type.compare(key, *split_key);
-            btree_node_t *target_node = (cmp < 0) ? node : *new_child;
-            
-            if (cmp >= 0) {
-                /* 새 노드에 삽입하는 경우 인덱스 조정 */
-                insert_pos -= (tree->min_keys + 1);
-            }
-            
-            return btree_node_insert_key(target_node, insert_pos, key, value,
-                                       &tree->key_type, &tree->value_type);
-        } else {
-            /* 노드에 여유가 있음 */
-            return btree_node_insert_key(node, insert_pos, key, value,
-                                       &tree->key_type, &tree->value_type);
-        }
+    /* 부모에 중간 키 자리 확보 */
+    int tail = parent->num_keys - index;
+    btree_move_slots(tree, parent, index + 1, parent, index, tail);
+    btree_move_children(tree, &parent->children[index + 2], &parent->children[index + 1], tail);
+    
+    /* 중간 키와 값을 부모로 이동 (B+Tree 리프는 구분 키만 복사) */
+    if (copy_up) {
+        btree_copy_separator(tree, parent, index, sibling, 0);
     } else {
-        /* 내부 노드 - 적절한 자식으로 재귀 */
-        int child_index = (pos >= 0) ? pos + 1 : -(pos + 1);
-        btree_node_t *child = node->children[child_index];
+        btree_move_slots(tree, parent, index, child, mid, 1);
+    }
+    btree_node_set_child(tree, parent, index + 1, sibling);
+    btree_node_set_count(tree, parent, parent->num_keys + 1);
+    btree_node_set_count(tree, child, mid);
+    
+    /* 리프 노드 연결 */
+    if (child->is_leaf && btree_has_leaf_links(tree)) {
+        sibling->next_leaf = child->next_leaf;
+        if (child->next_leaf) {
+            child->next_leaf->prev_leaf = sibling;
+        }
+        child->next_leaf = sibling;
+        sibling->prev_leaf = child;
+    }
+    
+    btree_event_emit(tree, BTREE_EVENT_SPLIT,
+                     btree_get_key_ptr(parent, index, &tree->key_type), NULL);
+    return BTREE_SUCCESS;
+}
+
+/* 슬롯의 값을 교체 (기존 값은 소멸) */
+static void btree_assign_value(btree_t *tree, btree_node_t *node, int index, const void *value) {
+    void *slot = btree_get_value_ptr(node, index, &tree->value_type);
+    if (tree->value_type.destroy) {
+        tree->value_type.destroy(slot, 1);
+    }
+    btree_store_value(tree, slot, value);
+}
+
+/* 기존 키 발견: 삭제 표시된 슬롯이면 새 값으로 되살리고, 아니면 중복 */
+btree_result_t btree_revive_slot(btree_t *tree, btree_node_t *node, int index,
+                                 const void *value) {
+    if (BTREE_LIKELY(!btree_slot_is_dead(node, index))) {
+        return BTREE_ERROR_DUPLICATE_KEY;
+    }
+    
+    if (value) {
+        btree_assign_value(tree, node, index, value);
+    }
+    btree_slot_mark(node->tombstones + index, 0, btree_is_concurrent(tree));
+    btree_counter_add(tree, &tree->dead_count, (size_t)-1);
+    btree_counter_add(tree, &tree->key_count, 1);
+    return BTREE_SUCCESS;
+}
+
+/* 기존 키 발견 (갱신): 삭제 표시된 슬롯은 되살리고, 살아 있으면 값만 교체 */
+void btree_overwrite_slot(btree_t *tree, btree_node_t *node, int index, const void *value) {
+    if (btree_revive_slot(tree, node, index, value) == BTREE_ERROR_DUPLICATE_KEY && value) {
+        btree_assign_value(tree, node, index, value);
+    }
+}
+
+/* node의 마지막 키보다 큰 키인지 */
+static inline bool btree_key_after_last(const btree_t *tree, const btree_node_t *node,
+                                        const void *key) {
+    return node->num_keys > 0 &&
+           tree->key_type.compare(key,
+               btree_get_key_ptr(node, node->num_keys - 1, &tree->key_type)) > 0;
+}
+
+/* 오른쪽 끝 추가로 넘치는 노드를 치우쳐 분할할지 (APPEND 힌트 또는 연속 추가 감지) */
+static bool btree_is_append(const btree_t *tree, const btree_node_t *node, const void *key) {
+    if (!(tree->flags & BTREE_FLAG_APPEND) && tree->append_run < BTREE_APPEND_RUN) return false;
+    return btree_key_after_last(tree, node, key);
+}
+
+/**
+ * @brief 삽입 위치까지 선제 분할하며 내려감
+ *
+ * 내려갈 자식이 가득 차 있으면 미리 분할한다. 같은 키를 만나면 (중복 허용
+ * 트리 제외, B+Tree는 리프에서만) 그 노드에서 멈추고, 아니면 빈 슬롯이
+ * 하나 이상 있는 리프에서 멈춘다. path->upper는 그 리프에 들어갈 수 있는
+ * 키의 상한 (경로상 가장 가까운 오른쪽 구분 키)이며, 리프 밖의 노드가
+ * 바뀌기 전까지 유효하다. 다른 트리와 공유된 노드는 내려가며 복사하므로
+ * path->node는 이 트리만 참조한다.
+ */
+btree_result_t btree_insert_descend(btree_t *tree, const void *key, btree_insert_path_t *path) {
+    if (!tree->root) {
+        /* 첫 번째 노드 생성 */
+        btree_node_t *root = btree_node_create(tree, true);
+        if (!root) {
+            return BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        btree_set_root(tree, root);
+        tree->height = 1;
+    } else if (!btree_writable_root(tree)) {
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    } else if (tree->root->num_keys >= (int)tree->root->capacity) {
+        /* 루트가 가득 참 - 새 루트 아래에서 분할 */
+        if (tree->height >= BTREE_MAX_HEIGHT) {
+            return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+        }
+        btree_node_t *new_root = btree_node_create(tree, false);
+        if (!new_root) {
+            return BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        new_root->children[0] = tree->root;
         
-        void *child_split_key = NULL;
-        btree_node_t *child_new_node = NULL;
+        btree_result_t result = btree_split_child(tree, new_root, 0,
+                                                  btree_is_append(tree, tree->root, key));
+        if (result != BTREE_SUCCESS) {
+            new_root->children[0] = NULL;
+            btree_node_destroy(tree, new_root);
+            return result;
+        }
+        tree->root->parent = new_root;
+        btree_set_root(tree, new_root);
+        tree->height++;
+    }
+    
+    bool allow_duplicates = (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES) != 0;
+    bool plus = btree_is_plus(tree);
+    btree_node_t *node = tree->root;
+    path->upper = NULL;
+    
+    for (;;) {
+        btree_node_access(tree, node, true);
+        int pos = btree_node_search(tree, node, key);
         
-        btree_result_t result = btree_insert_recursive(tree, child, key, value,
-                                                      &child_split_key, &child_new_node);
+        /* B+Tree의 내부 키는 구분 키일 뿐이므로 중복 판단은 리프에서 */
+        if (node->is_leaf || (pos >= 0 && !allow_duplicates && !plus)) {
+            path->node = node;
+            path->pos = pos;
+            if (node->is_leaf && !path->upper && !btree_is_concurrent(tree) &&
+                !(tree->flags & BTREE_FLAG_SHARED)) {
+                tree->append_leaf = node;
+            }
+            return BTREE_SUCCESS;
+        }
         
-        if (result != BTREE_SUCCESS) return result;
+        /* 내부 노드 - 적절한 자식으로 이동 */
+        int child_index = btree_descend_index(pos);
+        btree_node_t *child = btree_writable_child(tree, node, child_index);
+        if (!child) return BTREE_ERROR_MEMORY_ALLOCATION;
         
-        if (child_new_node) {
-            /* 자식이 분할되었음 - 분할 키를 이 노드에 삽입 */
-            if (node->num_keys >= tree->max_keys) {
-                /* 이 노드도 가득 참 - 분할 필요 */
-                result = btree_split_node(tree, node, new_child, split_key);
-                if (result != BTREE_SUCCESS) {
-                    tree->allocator->free(child_split_key);
-                    return result;
-                }
-                
-                /* 분할 키와 비교하여 적절한 노드에 삽입 */
-                int cmp = tree->key_type.compare(child_split_key, *split_key);
-                btree_node_t *target_node = (cmp < 0) ? node : *new_child;
-                
-                int insert_pos = btree_node_find_key(target_node, child_split_key, &tree->key_type);
-                insert_pos = (insert_pos >= 0) ? insert_pos : -(insert_pos + 1);
-                
-                /* 분할 키에서 키와 값 추출 */
-                void *split_value = (char*)child_split_key + tree->key_type.key_size;
-                result = btree_node_insert_key(target_node, insert_pos, child_split_key, split_value,
-                                             &tree->key_type, &tree->value_type);
-                if (result == BTREE_SUCCESS) {
-                    /* 자식 포인터 설정 */
-                    target_node->children[insert_pos + 1] = child_new_node;
-                    child_new_node->parent = target_node;
-                }
-            } else {
-                /* 노드에 여유가 있음 */
-                int insert_pos = btree_node_find_key(node, child_split_key, &tree->key_type);
-                insert_pos = (insert_pos >= 0) ? insert_pos : -(insert_pos + 1);
-                
-                /* 분할 키에서 키와 값 추출 */
-                void *split_value = (char*)child_split_key + tree->key_type.key_size;
-                result = btree_node_insert_key(node, insert_pos, child_split_key, split_value,
-                                             &tree->key_type, &tree->value_type);
-                if (result == BTREE_SUCCESS) {
-                    /* 자식 포인터 설정 */
-                    node->children[insert_pos + 1] = child_new_node;
-                    child_new_node->parent = node;
-                }
-            }
+        if (child->num_keys >= (int)child->capacity) {
+            bool append = !path->upper && child_index == node->num_keys &&
+                          btree_is_append(tree, child, key);
+            btree_result_t result = btree_split_child(tree, node, child_index, append);
+            if (result != BTREE_SUCCESS) return result;
             
-            tree->allocator->free(child_split_key);
+            /* 올라온 중간 키와 비교하여 내려갈 쪽 결정 */
+            int cmp = tree->key_type.compare(key,
+                          btree_get_key_ptr(node, child_index, &tree->key_type));
+            if (cmp == 0 && !allow_duplicates && !plus) {
+                path->node = node;
+                path->pos = child_index;
+                return BTREE_SUCCESS;
+            }
+            if (cmp >= 0) {
+                child_index++;
+            }
         }
         
-        return result;
+        if (child_index < node->num_keys) {
+            path->upper = btree_get_key_ptr(node, child_index, &tree->key_type);
+        }
+        node = node->children[child_index];
+    }
+}
+
+/* 오른쪽 끝 추가 기록 (연속 추가가 BTREE_APPEND_RUN에 이르면 치우쳐 분할) */
+static inline void btree_note_append(btree_t *tree, bool append) {
+    if (!append) {
+        tree->append_run = 0;
+    } else if (tree->append_run < BTREE_APPEND_RUN) {
+        tree->append_run++;
     }
 }
 
 /**
  * @brief B-Tree에 삽입
+ *
+ * 루트에서 리프까지 한 번만 내려가며, 내려갈 자식이 가득 차 있으면 미리
+ * 분할한다 (선제 분할). 되돌아 올라갈 일이 없으므로 재귀나 임시 키 버퍼가
+ * 필요 없고, 새 노드 외에는 힙 할당을 하지 않는다.
+ * 중복 키로 실패하더라도 이미 수행된 선제 분할은 유지되며 트리는 유효하다.
+ *
+ * 최댓값은 항상 오른쪽 끝 리프에 있으므로, 그 리프에 빈 슬롯이 있고 키가
+ * 마지막 키보다 크면 내려가지 않고 바로 끝에 붙인다 (순차 키의 빠른 경로).
  */
-btree_result_t btree_insert(btree_t *tree, const void *key, const void *value) {
-    if (!tree || !key) {
-        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+static btree_result_t btree_insert_key(btree_t *tree, const void *key, const void *value) {
+    if (BTREE_UNLIKELY(btree_is_concurrent(tree))) {
+        return btree_concurrent_insert(tree, key, value);
+    }
+    if (BTREE_UNLIKELY(btree_is_mapped(tree))) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
     }
     
-    if (!tree->root) {
-        /* 첫 번째 노드 생성 */
-        tree->root = btree_node_create(tree, true);
-        if (!tree->root) {
-            return BTREE_ERROR_MEMORY_ALLOCATION;
-        }
-        tree->height = 1;
-        
-        btree_result_t result = btree_node_insert_key(tree->root, 0, key, value,
-                                                     &tree->key_type, &tree->value_type);
-        if (result == BTREE_SUCCESS) {
-            tree->key_count++;
+    btree_result_t result;
+    btree_node_t *leaf = tree->append_leaf;
+    if (leaf) {
+        btree_node_access(tree, leaf, true);
+        if (leaf->num_keys < (int)leaf->capacity && btree_key_after_last(tree, leaf, key)) {
+            result = btree_node_insert_key(leaf, leaf->num_keys, key, value,
+                                           &tree->key_type, &tree->value_type);
+            if (result == BTREE_SUCCESS) {
+                tree->key_count++;
+                btree_note_append(tree, true);
+            }
+            return result;
         }
-        return result;
     }
     
-    void *split_key = NULL;
-    btree_node_t *new_child = NULL;
+    btree_insert_path_t path;
+    result = btree_insert_descend(tree, key, &path);
+    if (result != BTREE_SUCCESS) return result;
     
-    btree_result_t result = btree_insert_recursive(tree, tree->root, key, value,
-                                                  &split_key, &new_child);
+    if (path.pos >= 0 && !(tree->flags & BTREE_FLAG_ALLOW_DUPLICATES)) {
+        btree_note_append(tree, false);
+        return btree_revive_slot(tree, path.node, path.pos, value);
+    }
     
+    int insert_pos = (path.pos >= 0) ? path.pos : -(path.pos + 1);
+    btree_note_append(tree, path.node == tree->append_leaf && insert_pos == path.node->num_keys);
+    result = btree_node_insert_key(path.node, insert_pos, key, value,
+                                   &tree->key_type, &tree->value_type);
     if (result == BTREE_SUCCESS) {
         tree->key_count++;
-        
-        if (new_child) {
-            /* 루트가 분할되었음 - 새 루트 생성 */
-            btree_node_t *new_root = btree_node_create(tree, false);
-            if (!new_root) {
-                tree->allocator->free(split_key);
-                return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    return result;
+}
+
+/* 계측이나 이벤트 구독이 있으면 연산 수, 지연 시간, 이벤트도 기록 */
+btree_result_t btree_insert(btree_t *tree, const void *key, const void *value) {
+    if (!tree || !key) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    
+    if (BTREE_LIKELY(!btree_is_observed(tree))) {
+        btree_result_t result = btree_insert_key(tree, key, value);
+        btree_replica_sync(tree);
+        return result;
+    }
+    
+    uint64_t start = btree_op_begin(tree);
+    btree_result_t result = btree_insert_key(tree, key, value);
+    btree_replica_sync(tree);
+    btree_op_end(tree, BTREE_METRIC_INSERT, start);
+    if (result == BTREE_SUCCESS) {
+        btree_event_emit(tree, BTREE_EVENT_INSERT, key, value);
+    }
+    return result;
+}
+
+/**
+ * @brief 트리 변형 설정 (빈 트리에서만 가능)
+ */
+btree_result_t btree_set_variant(btree_t *tree, btree_variant_t variant) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (tree->root || btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    
+    switch (variant) {
+        case BTREE_VARIANT_STANDARD:
+            break;
+        case BTREE_VARIANT_PLUS:
+            if (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES) {
+                return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
             }
-            
-            /* 분할 키를 새 루트에 삽입 */
-            void *split_value = (char*)split_key + tree->key_type.key_size;
-            btree_node_insert_key(new_root, 0, split_key, split_value,
-                                 &tree->key_type, &tree->value_type);
-            
-            /* 자식 포인터 설정 */
-            new_root->children[0] = tree->root;
-            new_root->children[1] = new_child;
-            tree->root->parent = new_root;
-            new_child->parent = new_root;
-            
-            tree->root = new_root;
-            tree->height++;
-            
-            tree->allocator->free(split_key);
+            break;
+        case BTREE_VARIANT_CONCURRENT: {
+            /* 표준 노드 구성에 동시 접근 모드를 켬 */
+            btree_result_t result = btree_set_thread_safe(tree, true);
+            if (result != BTREE_SUCCESS) return result;
+            break;
         }
+        default:
+            return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
     }
     
-    return result;
+    /* 자동 차수는 새 변형의 노드 구성으로 다시 맞춤 */
+    tree->variant = variant;
+    int degree = tree->degree;
+    if (tree->node_bytes) {
+        degree = btree_degree_for_bytes(&tree->key_type, &tree->value_type, variant,
+                                        tree->node_bytes);
+    }
+    btree_size_nodes(tree, degree);
+    return BTREE_SUCCESS;
 }
 
 /**
- * @brief B-Tree에서 삭제
+ * @brief 노드 바이트 예산으로 차수 다시 정하기 (빈 트리에서만 가능)
  */
-btree_result_t btree_delete(btree_t *tree, const void *key) {
-    if (!tree || !key) {
+btree_result_t btree_set_node_bytes(btree_t *tree, size_t node_bytes) {
+    if (!tree) {
         return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
     }
+    if (tree->root || btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
     
-    if (!tree->root) {
-        return btree_set_error(BTREE_ERROR_KEY_NOT_FOUND), BTREE_ERROR_KEY_NOT_FOUND;
+    if (node_bytes == 0) node_bytes = btree_memory_page_size();
+    tree->node_bytes = node_bytes;
+    btree_size_nodes(tree, btree_degree_for_bytes(&tree->key_type, &tree->value_type,
+                                                  tree->variant, node_bytes));
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 노드 내 검색 방식 설정
+ */
+btree_result_t btree_set_search_mode(btree_t *tree, btree_search_mode_t mode) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (mode < BTREE_SEARCH_AUTO || mode > BTREE_SEARCH_SIMD) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    /* 잠금 없는 읽기가 search_window를 읽는 중에는 바꾸지 않음 */
+    if (btree_is_concurrent(tree) && tree->root) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
     }
     
-    /* TODO: 삭제 알고리즘 구현 */
-    /* 복잡한 삭제 로직은 다음 구현에서... */
+    tree->search_mode = mode;
+    btree_update_search(tree);
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 실제로 쓰는 노드 내 검색 방식 (AUTO를 푼 결과)
+ */
+btree_search_mode_t btree_get_search_mode(const btree_t *tree) {
+    if (!tree) return BTREE_SEARCH_AUTO;
+    int window;
+    return btree_search_resolve(tree, &window);
+}
+
+/**
+ * @brief 접근 패턴 힌트 설정
+ *
+ * SEQUENTIAL이면 오른쪽 끝에 추가되는 키로 넘치는 노드를 치우쳐 분할하고
+ * (BTREE_FLAG_APPEND), 다른 힌트는 보통 분할로 되돌린다. 노드 할당 전략은
+ * btree_init에 btree_optimized_allocator_create(hint)를 넘겨 고른다.
+ */
+void btree_set_cache_hint(btree_t *tree, btree_alloc_hint_t hint) {
+    if (!tree) return;
     
-    return BTREE_ERROR_INVALID_OPERATION;
+    if (hint == BTREE_ALLOC_HINT_SEQUENTIAL) {
+        tree->flags |= BTREE_FLAG_APPEND;
+    } else {
+        tree->flags &= ~(uint32_t)BTREE_FLAG_APPEND;
+    }
+}
+
+/**
+ * @brief 트리 변형 반환
+ */
+btree_variant_t btree_get_variant(const btree_t *tree) {
+    return tree ? tree->variant : BTREE_VARIANT_STANDARD;
+}
+
+/**
+ * @brief 값을 value_out에 복사하여 검색 (값 바이트의 얕은 복사)
+ *
+ * 동시 모드에서는 검증된 일관된 값을 복사하므로, 다른 스레드가 쓰는 중에도
+ * 안전한 조회 방법이다 (btree_search의 포인터는 이후 쓰기로 무효가 될 수 있음).
+ */
+btree_result_t btree_get(btree_t *tree, const void *key, void *value_out) {
+    if (!tree || !key || !value_out) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    
+    if (btree_is_concurrent(tree)) {
+        if (!btree_concurrent_search(tree, key, value_out)) {
+            return btree_set_error(BTREE_ERROR_KEY_NOT_FOUND), BTREE_ERROR_KEY_NOT_FOUND;
+        }
+        return BTREE_SUCCESS;
+    }
+    /* 압축 이미지의 리프 캐시 칸은 다른 검색이 바꿀 수 있으므로 잠금 안에서 복사 */
+    if (btree_is_mapped(tree)) {
+        bool observed = btree_is_observed(tree);
+        uint64_t start = observed ? btree_op_begin(tree) : 0;
+        void *slot = btree_mapped_search(tree, key, value_out);
+        if (observed) {
+            btree_op_end(tree, BTREE_METRIC_SEARCH, start);
+            btree_event_emit(tree, BTREE_EVENT_SEARCH, key, slot);
+        }
+        if (!slot) {
+            return btree_set_error(BTREE_ERROR_KEY_NOT_FOUND), BTREE_ERROR_KEY_NOT_FOUND;
+        }
+        return BTREE_SUCCESS;
+    }
+    
+    const void *slot = btree_search(tree, key);
+    if (!slot) return BTREE_ERROR_KEY_NOT_FOUND;
+    memcpy(value_out, slot, tree->value_type.value_size);
+    return BTREE_SUCCESS;
 }
 
 /**
  * @brief 키 포함 여부 확인
  */
 bool btree_contains(btree_t *tree, const void *key) {
-    return btree_search(tree, key) != NULL;
+    return btree_lookup(tree, key).status == BTREE_SUCCESS;
 }
 
 /**
@@ -680,7 +1380,7 @@ int btree_height(const btree_t *tree) {
  * @brief 트리가 비어있는지 확인
  */
 bool btree_is_empty(const btree_t *tree) {
-    return !tree || tree->root == NULL;
+    return !tree || (tree->root == NULL && tree->key_count == 0);
 }
 
 /**
@@ -693,8 +1393,21 @@ void btree_clear(btree_t *tree) {
         btree_node_destroy(tree, tree->root);
         tree->root = NULL;
     }
+    btree_layout_release(tree);
+    btree_replica_release(tree);
+    btree_reclaim_retired(tree);
+    if (btree_is_mapped(tree)) {
+        btree_storage_release(tree);
+    }
     
+    /* 다른 트리와 공유하던 노드는 해제되지 않아 집계에서 빠지지 않았음 */
+    if (tree->flags & BTREE_FLAG_SHARED) {
+        tree->node_count = 0;
+        tree->total_memory = sizeof(btree_t);
+        tree->flags &= ~(uint32_t)BTREE_FLAG_SHARED;
+    }
     tree->key_count = 0;
+    tree->dead_count = 0;
     tree->height = 0;
 }
 
@@ -705,6 +1418,13 @@ btree_result_t btree_get_last_error(void) {
     return g_last_error;
 }
 
+/**
+ * @brief 오류 처리기 설정 (NULL이면 해제)
+ */
+void btree_set_error_handler(void (*handler)(btree_result_t error, const char *message)) {
+    btree_handler_store(handler);
+}
+
 /**
  * @brief 오류 문자열 반환
  */
@@ -720,6 +1440,8 @@ const char* btree_error_string(btree_result_t error) {
         case BTREE_ERROR_TYPE_MISMATCH: return "Type mismatch";
         case BTREE_ERROR_INVALID_SIZE: return "Invalid size";
         case BTREE_ERROR_ALIGNMENT_ERROR: return "Alignment error";
+        case BTREE_ERROR_IO: return "I/O error";
+        case BTREE_ERROR_CORRUPTED: return "Corrupted data";
         default: return "Unknown error";
     }
 }
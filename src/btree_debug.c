@@ -0,0 +1,168 @@
+/**
+ * @file btree_debug.c
+ * @brief B-Tree 구조 검증 및 시각화
+ */
+
+#include "btree_internal.h"
+
+/* 검증 상태 */
+typedef struct {
+    const btree_t *tree;
+    int leaf_depth;                     /* 첫 리프의 깊이 (-1: 미확인) */
+    size_t key_count;                   /* 누적 키 수 (삭제 표시 제외) */
+    size_t dead_count;                  /* 누적 삭제 표시 수 */
+    const btree_node_t *last_leaf;      /* 직전에 방문한 리프 (리프 연결 확인용) */
+} btree_validate_ctx_t;
+
+/**
+ * @brief 노드 내부 불변식 검사 (키 개수, 정렬 순서)
+ */
+bool btree_validate_node(const btree_node_t *node, const btree_type_info_t *key_type) {
+    if (!node || !key_type || !key_type->compare) return false;
+    if (node->num_keys > node->capacity) return false;
+    if (!node->is_leaf && !node->children) return false;
+
+    for (int i = 1; i < node->num_keys; i++) {
+        const void *prev = btree_get_key_ptr(node, i - 1, key_type);
+        const void *curr = btree_get_key_ptr(node, i, key_type);
+        if (key_type->compare(prev, curr) > 0) return false;
+    }
+    return true;
+}
+
+/* 키가 (lower, upper) 범위 안에 있는지 확인 (B+Tree는 [lower, upper)) */
+static bool btree_key_in_bounds(const btree_t *tree, const void *key,
+                                const void *lower, const void *upper) {
+    bool strict = !(tree->flags & BTREE_FLAG_ALLOW_DUPLICATES);
+    if (lower) {
+        int cmp = tree->key_type.compare(key, lower);
+        if (cmp < 0 || (strict && cmp == 0 && !btree_is_plus(tree))) return false;
+    }
+    if (upper) {
+        int cmp = tree->key_type.compare(key, upper);
+        if (cmp > 0 || (strict && cmp == 0)) return false;
+    }
+    return true;
+}
+
+/* 서브트리 재귀 검증 */
+static bool btree_validate_subtree(btree_validate_ctx_t *ctx, const btree_node_t *node,
+                                   int depth, const void *lower, const void *upper) {
+    const btree_t *tree = ctx->tree;
+
+    if (!btree_validate_node(node, &tree->key_type)) return false;
+
+    /* 루트를 제외한 노드는 최소 키 수 이상 (오른쪽 끝 경로는 치우친 분할로 적을 수 있음) */
+    if (node != tree->root && upper && node->num_keys < (node->capacity - 1) / 2) return false;
+    if (node != tree->root && node->num_keys == 0) return false;
+
+    for (int i = 0; i < node->num_keys; i++) {
+        const void *key = btree_get_key_ptr(node, i, &tree->key_type);
+        if (!btree_key_in_bounds(tree, key, lower, upper)) return false;
+    }
+    /* B+Tree 내부 노드의 키는 구분 키 사본이므로 세지 않음 */
+    if (node->is_leaf || !btree_is_plus(tree)) {
+        for (int i = 0; i < node->num_keys; i++) {
+            if (btree_slot_is_dead(node, i)) {
+                ctx->dead_count++;
+            } else {
+                ctx->key_count++;
+            }
+        }
+    }
+
+    if (node->is_leaf) {
+        if (ctx->leaf_depth < 0) {
+            ctx->leaf_depth = depth;
+        }
+        /* 리프는 왼쪽부터 순서대로 연결되어 있어야 함 (스냅숏과 공유하는 트리는 연결 없음) */
+        if (btree_has_leaf_links(tree)) {
+            if (node->prev_leaf != ctx->last_leaf) return false;
+            if (ctx->last_leaf && ctx->last_leaf->next_leaf != node) return false;
+        }
+        ctx->last_leaf = node;
+        return ctx->leaf_depth == depth;
+    }
+    if (btree_is_plus(tree) && node->values) return false;
+
+    for (int i = 0; i <= node->num_keys; i++) {
+        const btree_node_t *child = node->children[i];
+        if (!child) return false;
+
+        const void *child_lower = (i > 0) ? btree_get_key_ptr(node, i - 1, &tree->key_type) : lower;
+        const void *child_upper = (i < node->num_keys) ? btree_get_key_ptr(node, i, &tree->key_type) : upper;
+        if (!btree_validate_subtree(ctx, child, depth + 1, child_lower, child_upper)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 트리 전체 불변식 검사
+ *
+ * 키 순서, 노드별 최소/최대 키 수, 리프 깊이 일치, 리프 연결 순서, 높이와
+ * 키 수 (삭제 표시된 키는 따로 집계)를 확인한다.
+ */
+bool btree_validate_structure(const btree_t *tree) {
+    if (!tree) return false;
+    if (btree_is_mapped(tree)) return btree_mapped_validate(tree);
+    if (!tree->root) return tree->key_count == 0 && tree->height == 0;
+
+    btree_validate_ctx_t ctx = { tree, -1, 0, 0, NULL };
+    if (!btree_validate_subtree(&ctx, tree->root, 1, NULL, NULL)) return false;
+    if (btree_has_leaf_links(tree) && ctx.last_leaf->next_leaf != NULL) return false;
+
+    return ctx.leaf_depth == tree->height && ctx.key_count == tree->key_count &&
+           ctx.dead_count == tree->dead_count;
+}
+
+/* 단일 항목 출력 (print 함수가 없으면 자리 표시) */
+static void btree_print_item(const void *ptr, const btree_type_info_t *type, FILE *output) {
+    if (type && type->print) {
+        type->print(ptr, output);
+    } else {
+        fprintf(output, "?");
+    }
+}
+
+/**
+ * @brief 노드와 하위 노드를 들여쓰기 형태로 출력
+ */
+void btree_print_node(const btree_node_t *node, const btree_type_info_t *key_type,
+                     const btree_type_info_t *value_type, FILE *output, int depth) {
+    if (!node || !key_type || !output) return;
+
+    for (int i = 0; i < depth; i++) {
+        fprintf(output, "  ");
+    }
+    fprintf(output, "%s[", node->is_leaf ? "L" : "I");
+    for (int i = 0; i < node->num_keys; i++) {
+        if (i > 0) fprintf(output, " ");
+        btree_print_item(btree_get_key_ptr(node, i, key_type), key_type, output);
+        if (node->values && value_type && value_type->print) {
+            fprintf(output, ":");
+            value_type->print(btree_get_value_ptr(node, i, value_type), output);
+        }
+    }
+    fprintf(output, "]\n");
+
+    if (!node->is_leaf) {
+        for (int i = 0; i <= node->num_keys; i++) {
+            btree_print_node(node->children[i], key_type, value_type, output, depth + 1);
+        }
+    }
+}
+
+/**
+ * @brief 트리 구조 출력
+ */
+void btree_print_structure(const btree_t *tree, FILE *output) {
+    if (!tree || !output) return;
+
+    if (!tree->root) {
+        fprintf(output, "(empty)\n");
+        return;
+    }
+    btree_print_node(tree->root, &tree->key_type, &tree->value_type, output, 0);
+}
@@ -0,0 +1,579 @@
+/**
+ * @file btree_delete.c
+ * @brief B-Tree 삭제, 노드 병합/재분배, 지연 삭제(삭제 표시) 구현
+ */
+
+#include "btree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* 병합 후 비어 버린 루트를 유일한 자식으로 교체 */
+static void btree_collapse_root(btree_t *tree) {
+    btree_node_t *root = tree->root;
+    if (root->num_keys > 0 || root->is_leaf) return;
+
+    btree_set_root(tree, root->children[0]);
+    btree_node_set_parent(tree->root, NULL);
+    tree->height--;
+
+    btree_node_set_child(tree, root, 0, NULL);
+    btree_node_retire(tree, root);
+}
+
+/* B+Tree 리프 사이의 구분 키인지 (사본이므로 내리지 않고 버림) */
+static bool btree_separator_is_copy(const btree_t *tree, const btree_node_t *child) {
+    return child->is_leaf && btree_is_plus(tree);
+}
+
+/* 부모의 구분 키 index를 오른쪽 자식의 첫 키 사본으로 교체 */
+static void btree_refresh_separator(btree_t *tree, btree_node_t *parent, int index) {
+    if (tree->key_type.destroy) {
+        tree->key_type.destroy(btree_get_key_ptr(parent, index, &tree->key_type), 1);
+    }
+    btree_copy_separator(tree, parent, index, parent->children[index + 1], 0);
+}
+
+/**
+ * @brief 자식 index와 index + 1을 부모의 구분 키와 함께 왼쪽 자식으로 병합
+ *
+ * 슬롯은 복사하지 않고 옮기며, 비게 된 오른쪽 노드는 내용 소멸 없이 해제한다.
+ * B+Tree 리프는 구분 키를 내리지 않고 소멸시킨다. 두 자식은 이 트리 전용이어야
+ * 한다 (btree_writable_child).
+ */
+void btree_merge_children(btree_t *tree, btree_node_t *parent, int index) {
+    btree_node_t *left = parent->children[index];
+    btree_node_t *right = parent->children[index + 1];
+    int left_keys = left->num_keys;
+    int right_keys = right->num_keys;
+
+    BTREE_METRIC_ADD(tree, merges, 1);
+    btree_event_emit(tree, BTREE_EVENT_MERGE,
+                     btree_get_key_ptr(parent, index, &tree->key_type), NULL);
+
+    /* 구분 키를 내리고 오른쪽 노드의 슬롯을 이어 붙임 */
+    if (btree_separator_is_copy(tree, left)) {
+        if (tree->key_type.destroy) {
+            tree->key_type.destroy(btree_get_key_ptr(parent, index, &tree->key_type), 1);
+        }
+    } else {
+        btree_move_slots(tree, left, left_keys++, parent, index, 1);
+    }
+    btree_move_slots(tree, left, left_keys, right, 0, right_keys);
+    if (!left->is_leaf) {
+        btree_move_children(tree, &left->children[left_keys], right->children,
+                            (size_t)right_keys + 1);
+        for (int i = 0; i <= right_keys; i++) {
+            btree_node_set_parent(left->children[left_keys + i], left);
+        }
+    }
+    btree_node_set_count(tree, left, left_keys + right_keys);
+
+    /* 부모에서 구분 키와 오른쪽 자식 포인터 제거 */
+    int tail = parent->num_keys - index - 1;
+    btree_move_slots(tree, parent, index, parent, index + 1, tail);
+    btree_move_children(tree, &parent->children[index + 1], &parent->children[index + 2], tail);
+    btree_node_set_count(tree, parent, parent->num_keys - 1);
+
+    /* 리프 연결 갱신 */
+    if (left->is_leaf && btree_has_leaf_links(tree)) {
+        left->next_leaf = right->next_leaf;
+        if (right->next_leaf) {
+            right->next_leaf->prev_leaf = left;
+        }
+    }
+
+    btree_node_set_count(tree, right, 0);
+    if (!right->is_leaf) {
+        btree_node_set_child(tree, right, 0, NULL);
+    }
+    btree_node_retire(tree, right);
+}
+
+/* 자식 index가 왼쪽 형제에게서 키 하나를 빌림 (부모를 거쳐 회전) */
+static void btree_borrow_from_left(btree_t *tree, btree_node_t *parent, int index) {
+    btree_node_t *child = parent->children[index];
+    btree_node_t *left = parent->children[index - 1];
+
+    btree_move_slots(tree, child, 1, child, 0, child->num_keys);
+    if (btree_separator_is_copy(tree, child)) {
+        btree_move_slots(tree, child, 0, left, left->num_keys - 1, 1);
+        btree_node_set_count(tree, left, left->num_keys - 1);
+        btree_node_set_count(tree, child, child->num_keys + 1);
+        btree_refresh_separator(tree, parent, index - 1);
+        return;
+    }
+    btree_move_slots(tree, child, 0, parent, index - 1, 1);
+    btree_move_slots(tree, parent, index - 1, left, left->num_keys - 1, 1);
+
+    if (!child->is_leaf) {
+        btree_move_children(tree, &child->children[1], &child->children[0],
+                            (size_t)child->num_keys + 1);
+        btree_node_set_child(tree, child, 0, left->children[left->num_keys]);
+        btree_node_set_parent(child->children[0], child);
+    }
+
+    btree_node_set_count(tree, left, left->num_keys - 1);
+    btree_node_set_count(tree, child, child->num_keys + 1);
+}
+
+/* 자식 index가 오른쪽 형제에게서 키 하나를 빌림 (부모를 거쳐 회전) */
+static void btree_borrow_from_right(btree_t *tree, btree_node_t *parent, int index) {
+    btree_node_t *child = parent->children[index];
+    btree_node_t *right = parent->children[index + 1];
+
+    if (btree_separator_is_copy(tree, child)) {
+        btree_move_slots(tree, child, child->num_keys, right, 0, 1);
+        btree_move_slots(tree, right, 0, right, 1, right->num_keys - 1);
+        btree_node_set_count(tree, right, right->num_keys - 1);
+        btree_node_set_count(tree, child, child->num_keys + 1);
+        btree_refresh_separator(tree, parent, index);
+        return;
+    }
+    btree_move_slots(tree, child, child->num_keys, parent, index, 1);
+    btree_move_slots(tree, parent, index, right, 0, 1);
+    btree_move_slots(tree, right, 0, right, 1, right->num_keys - 1);
+
+    if (!child->is_leaf) {
+        btree_node_set_child(tree, child, child->num_keys + 1, right->children[0]);
+        btree_node_set_parent(child->children[child->num_keys + 1], child);
+        btree_move_children(tree, &right->children[0], &right->children[1], right->num_keys);
+    }
+
+    btree_node_set_count(tree, right, right->num_keys - 1);
+    btree_node_set_count(tree, child, child->num_keys + 1);
+}
+
+/**
+ * @brief 내려갈 자식이 최소 키 수보다 많은 키를 갖도록 보장
+ *
+ * 형제에게서 빌릴 수 있으면 회전하고, 아니면 형제와 병합한다. 자식과
+ * 손대는 형제는 공유 중이면 먼저 복사한다.
+ * @return 조정 후 내려갈 자식의 인덱스 (메모리 부족 시 -1)
+ */
+static int btree_fill_child(btree_t *tree, btree_node_t *parent, int index) {
+    btree_node_t *child = btree_writable_child(tree, parent, index);
+    if (!child) return -1;
+    if (child->num_keys > btree_node_min_keys(child)) return index;
+
+    if (index > 0) {
+        btree_node_t *left = parent->children[index - 1];
+        if (left->num_keys > btree_node_min_keys(left)) {
+            if (!btree_writable_child(tree, parent, index - 1)) return -1;
+            btree_borrow_from_left(tree, parent, index);
+            return index;
+        }
+    }
+    if (index < parent->num_keys) {
+        btree_node_t *right = btree_writable_child(tree, parent, index + 1);
+        if (!right) return -1;
+        if (right->num_keys > btree_node_min_keys(right)) {
+            btree_borrow_from_right(tree, parent, index);
+            return index;
+        }
+        btree_merge_children(tree, parent, index);
+        return index;
+    }
+
+    if (!btree_writable_child(tree, parent, index - 1)) return -1;
+    btree_merge_children(tree, parent, index - 1);
+    return index - 1;
+}
+
+/* 슬롯의 키와 값 소멸 (슬롯은 이후 덮어씀) */
+static void btree_destroy_slot(btree_t *tree, btree_node_t *node, int index) {
+    if (tree->key_type.destroy) {
+        tree->key_type.destroy(btree_get_key_ptr(node, index, &tree->key_type), 1);
+    }
+    if (node->values && tree->value_type.destroy) {
+        tree->value_type.destroy(btree_get_value_ptr(node, index, &tree->value_type), 1);
+    }
+}
+
+/**
+ * @brief 서브트리의 최댓값(또는 최솟값) 슬롯으로 dst의 dst_index를 대체
+ *
+ * node->children[child_index]는 최소 키 수보다 많은 키를 가져야 한다.
+ * 내려가는 동안 각 자식을 미리 채우므로 리프에서 바로 제거할 수 있다.
+ * dst의 기존 슬롯은 리프에 닿은 뒤에 소멸하므로 실패해도 트리는 유효하다.
+ */
+static btree_result_t btree_take_extreme(btree_t *tree, btree_node_t *dst, int dst_index,
+                                         int child_index, bool take_max) {
+    btree_node_t *node = btree_writable_child(tree, dst, child_index);
+    if (!node) return BTREE_ERROR_MEMORY_ALLOCATION;
+
+    while (!node->is_leaf) {
+        int index = take_max ? node->num_keys : 0;
+        index = btree_fill_child(tree, node, index);
+        if (index < 0) return BTREE_ERROR_MEMORY_ALLOCATION;
+        node = node->children[index];
+    }
+
+    btree_destroy_slot(tree, dst, dst_index);
+    if (take_max) {
+        btree_move_slots(tree, dst, dst_index, node, node->num_keys - 1, 1);
+    } else {
+        btree_move_slots(tree, dst, dst_index, node, 0, 1);
+        btree_move_slots(tree, node, 0, node, 1, node->num_keys - 1);
+    }
+    btree_node_set_count(tree, node, node->num_keys - 1);
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 키를 물리적으로 제거 (하향식 단일 패스)
+ *
+ * 내려갈 자식이 최소 키 수뿐이면 미리 빌리거나 병합하므로 되돌아 올라갈
+ * 필요가 없다. key_count와 dead_count는 호출자가 갱신한다.
+ * B+Tree는 항상 리프까지 내려가며, 내부 노드에 남은 구분 키는 그대로 둔다.
+ * 공유된 노드는 손대기 전에 복사하며, 복사할 메모리가 없으면 그때까지의
+ * 재균형만 남긴 채 (트리는 유효) 실패한다.
+ */
+static btree_result_t btree_delete_physical(btree_t *tree, const void *key) {
+    if (!tree->root) return BTREE_ERROR_KEY_NOT_FOUND;
+    btree_node_t *node = btree_writable_root(tree);
+    if (!node) return BTREE_ERROR_MEMORY_ALLOCATION;
+    bool plus = btree_is_plus(tree);
+
+    for (;;) {
+        btree_node_access(tree, node, true);
+        int pos = btree_node_search(tree, node, key);
+
+        if (node->is_leaf) {
+            if (pos < 0) return BTREE_ERROR_KEY_NOT_FOUND;
+            btree_node_remove_at(tree, node, pos);
+            if (node == tree->root && node->num_keys == 0) {
+                btree_node_retire(tree, node);
+                btree_set_root(tree, NULL);
+                tree->height = 0;
+            }
+            return BTREE_SUCCESS;
+        }
+
+        if (pos >= 0 && !plus) {
+            /* 내부 노드: 선행자나 후행자로 대체, 둘 다 여유가 없으면 병합 후 계속 */
+            btree_node_t *left = node->children[pos];
+            btree_node_t *right = node->children[pos + 1];
+
+            if (left->num_keys > btree_node_min_keys(left)) {
+                return btree_take_extreme(tree, node, pos, pos, true);
+            }
+            if (right->num_keys > btree_node_min_keys(right)) {
+                return btree_take_extreme(tree, node, pos, pos + 1, false);
+            }
+
+            left = btree_writable_child(tree, node, pos);
+            if (!left || !btree_writable_child(tree, node, pos + 1)) {
+                return BTREE_ERROR_MEMORY_ALLOCATION;
+            }
+            btree_merge_children(tree, node, pos);
+            if (node == tree->root) {
+                btree_collapse_root(tree);
+            }
+            node = left;
+            continue;
+        }
+
+        int child_index = btree_fill_child(tree, node, btree_descend_index(pos));
+        if (child_index < 0) return BTREE_ERROR_MEMORY_ALLOCATION;
+        btree_node_t *child = node->children[child_index];
+        if (node == tree->root) {
+            btree_collapse_root(tree);
+        }
+        node = child;
+    }
+}
+
+/* 키가 있는 노드와 위치 검색 (삭제 표시 여부와 무관, shared는 경로에 공유 노드가 있는지) */
+static btree_node_t* btree_locate(const btree_t *tree, const void *key, int *index,
+                                  bool *shared) {
+    btree_node_t *node = tree->root;
+    bool plus = btree_is_plus(tree);
+
+    *shared = false;
+    while (node) {
+        btree_node_access(tree, node, true);
+        *shared |= btree_node_is_shared(node);
+        int pos = btree_node_search(tree, node, key);
+        if (pos >= 0 && (node->is_leaf || !plus)) {
+            *index = pos;
+            return node;
+        }
+        if (node->is_leaf) break;
+        node = node->children[btree_descend_index(pos)];
+    }
+    return NULL;
+}
+
+/* 있는 키까지 다시 내려가며 경로의 공유 노드를 복사 (메모리 부족 시 NULL) */
+static btree_node_t* btree_locate_writable(btree_t *tree, const void *key, int *index) {
+    btree_node_t *node = btree_writable_root(tree);
+    bool plus = btree_is_plus(tree);
+
+    while (node) {
+        int pos = btree_node_search(tree, node, key);
+        if (pos >= 0 && (node->is_leaf || !plus)) {
+            *index = pos;
+            return node;
+        }
+        node = btree_writable_child(tree, node, btree_descend_index(pos));
+    }
+    return NULL;
+}
+
+/* 키 삭제 (동시 모드에서는 배타 쓰기 구간 안에서 호출) */
+static btree_result_t btree_delete_key(btree_t *tree, const void *key) {
+    if (!tree->root) {
+        return btree_set_error(BTREE_ERROR_KEY_NOT_FOUND), BTREE_ERROR_KEY_NOT_FOUND;
+    }
+
+    if (tree->flags & BTREE_FLAG_LAZY_DELETE) {
+        int index;
+        bool shared;
+        btree_node_t *node = btree_locate(tree, key, &index, &shared);
+        if (!node || btree_slot_is_dead(node, index)) {
+            return btree_set_error(BTREE_ERROR_KEY_NOT_FOUND), BTREE_ERROR_KEY_NOT_FOUND;
+        }
+        if (BTREE_UNLIKELY(shared) && node->tombstones) {
+            node = btree_locate_writable(tree, key, &index);
+            if (!node) {
+                return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+            }
+        }
+        if (node->tombstones) {
+            btree_slot_mark(node->tombstones + index, 1, btree_is_concurrent(tree));
+            tree->dead_count++;
+            tree->key_count--;
+            return BTREE_SUCCESS;
+        }
+        /* 표시 배열이 없는 노드는 즉시 제거 */
+    }
+
+    btree_result_t result = btree_delete_physical(tree, key);
+    if (result != BTREE_SUCCESS) {
+        return btree_set_error(result), result;
+    }
+    tree->key_count--;
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief B-Tree에서 삭제
+ *
+ * 지연 삭제 모드에서는 슬롯에 삭제 표시만 하고 구조는 건드리지 않는다.
+ * 표시된 슬롯은 btree_purge_tombstones나 btree_compact에서 일괄 제거된다.
+ * 동시 모드에서는 다른 쓰기와 배타적으로 수행된다.
+ */
+btree_result_t btree_delete(btree_t *tree, const void *key) {
+    if (!tree || !key) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    if (BTREE_LIKELY(!btree_is_observed(tree))) {
+        btree_writer_begin(tree);
+        btree_result_t result = btree_delete_key(tree, key);
+        btree_writer_end(tree);
+        btree_replica_sync(tree);
+        return result;
+    }
+
+    uint64_t start = btree_op_begin(tree);
+    btree_writer_begin(tree);
+    btree_result_t result = btree_delete_key(tree, key);
+    btree_writer_end(tree);
+    btree_replica_sync(tree);
+    btree_op_end(tree, BTREE_METRIC_DELETE, start);
+    if (result == BTREE_SUCCESS) {
+        btree_event_emit(tree, BTREE_EVENT_DELETE, key, NULL);
+    }
+    return result;
+}
+
+/* 인접한 두 형제의 부모 내 구분 키 위치 확인 (스냅숏과 공유하는 트리는 parent를 믿을 수 없음) */
+static int btree_sibling_index(const btree_t *tree, const btree_node_t *left,
+                               const btree_node_t *right, const void *sep_key) {
+    btree_node_t *parent = left->parent;
+    if (!parent || right->parent != parent || (tree->flags & BTREE_FLAG_SHARED)) return -1;
+
+    for (int i = 0; i < parent->num_keys; i++) {
+        if (parent->children[i] == left) {
+            if (parent->children[i + 1] != right) return -1;
+            if (sep_key && tree->key_type.compare(sep_key,
+                               btree_get_key_ptr(parent, i, &tree->key_type)) != 0) {
+                return -1;
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 인접한 형제 노드 병합
+ *
+ * right의 키와 부모의 구분 키(sep_key)를 left로 옮기고 right를 해제한다.
+ * B+Tree 리프는 구분 키 사본을 버리고 키만 합친다.
+ * 루트가 비게 되면 트리 높이가 하나 줄어든다.
+ */
+btree_result_t btree_merge_nodes(btree_t *tree, btree_node_t *left,
+                                btree_node_t *right, const void *sep_key) {
+    if (!tree || !left || !right) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    int index = btree_sibling_index(tree, left, right, sep_key);
+    int merged = left->num_keys + right->num_keys + (btree_separator_is_copy(tree, left) ? 0 : 1);
+    if (index < 0 || merged > (int)left->capacity) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_node_t *parent = left->parent;
+    btree_merge_children(tree, parent, index);
+    if (parent == tree->root) {
+        btree_collapse_root(tree);
+    }
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 인접한 형제 노드 사이의 키 재분배
+ *
+ * 구분 키를 거치는 회전으로 두 노드의 키 수 차이를 1 이하로 맞춘다.
+ */
+btree_result_t btree_redistribute_keys(btree_t *tree, btree_node_t *left,
+                                      btree_node_t *right, const void *sep_key) {
+    if (!tree || !left || !right) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    int index = btree_sibling_index(tree, left, right, sep_key);
+    if (index < 0) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_node_t *parent = left->parent;
+    while (left->num_keys + 1 < right->num_keys) {
+        btree_borrow_from_right(tree, parent, index);
+    }
+    while (right->num_keys + 1 < left->num_keys) {
+        btree_borrow_from_left(tree, parent, index + 1);
+    }
+    return BTREE_SUCCESS;
+}
+
+/* 삭제 표시된 키를 버퍼에 모음 (슬롯 내용의 비트 복사, 소유권 이전 없음) */
+static void btree_collect_dead(const btree_t *tree, const btree_node_t *node,
+                               char *buffer, size_t *count) {
+    if (node->tombstones) {
+        for (int i = 0; i < node->num_keys; i++) {
+            if (node->tombstones[i]) {
+                memcpy(buffer + *count * tree->key_type.key_size,
+                       btree_get_key_ptr(node, i, &tree->key_type), tree->key_type.key_size);
+                (*count)++;
+            }
+        }
+    }
+    if (!node->is_leaf) {
+        for (int i = 0; i <= node->num_keys; i++) {
+            btree_collect_dead(tree, node->children[i], buffer, count);
+        }
+    }
+}
+
+/**
+ * @brief 삭제 표시된 키를 일괄 제거하고 트리를 재균형
+ *
+ * @return 제거된 키 수 (메모리 부족 시 0)
+ */
+size_t btree_purge_tombstones(btree_t *tree) {
+    if (!tree || !tree->root || tree->dead_count == 0) return 0;
+
+    btree_writer_begin(tree);
+    if (tree->dead_count == 0) {
+        btree_writer_end(tree);
+        return 0;
+    }
+    char *dead = tree->allocator->alloc(tree->dead_count * tree->key_type.key_size);
+    if (!dead) {
+        btree_writer_end(tree);
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return 0;
+    }
+
+    size_t count = 0;
+    btree_collect_dead(tree, tree->root, dead, &count);
+
+    /* 중복 키가 없으므로 같은 키로 찾으면 표시된 바로 그 슬롯이 제거됨 */
+    size_t purged = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (btree_delete_physical(tree, dead + i * tree->key_type.key_size) == BTREE_SUCCESS) {
+            purged++;
+        }
+    }
+    tree->dead_count -= purged;
+    btree_writer_end(tree);
+
+    tree->allocator->free(dead);
+    return purged;
+}
+
+/* 서브트리 전체에 삭제 표시 배열 할당 또는 해제 */
+static bool btree_set_tombstone_arrays(btree_t *tree, btree_node_t *node, bool enable) {
+    if (enable && !node->tombstones) {
+        node->tombstones = btree_node_alloc(tree, node->capacity);
+        if (!node->tombstones) return false;
+        memset(node->tombstones, 0, node->capacity);
+        tree->total_memory += node->capacity;
+    } else if (!enable && node->tombstones) {
+        tree->allocator->free(node->tombstones);
+        node->tombstones = NULL;
+        tree->total_memory -= node->capacity;
+    }
+
+    if (!node->is_leaf) {
+        for (int i = 0; i <= node->num_keys; i++) {
+            if (!btree_set_tombstone_arrays(tree, node->children[i], enable)) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 지연 삭제 모드 설정
+ *
+ * 켜면 기존 노드에도 삭제 표시 배열을 할당하고, 끄면 표시된 키를 모두
+ * 제거한 뒤 배열을 해제한다. 중복 키 허용 트리에서는 사용할 수 없다.
+ */
+btree_result_t btree_set_lazy_delete(btree_t *tree, bool enable) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree) || (enable && (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES))) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    /* 삭제 표시 배열은 노드마다 제자리에서 붙이거나 떼므로 공유 노드에는 불가 */
+    if ((tree->flags & BTREE_FLAG_SHARED) &&
+        enable != ((tree->flags & BTREE_FLAG_LAZY_DELETE) != 0)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    if (!enable) {
+        btree_purge_tombstones(tree);
+        if (tree->dead_count > 0) {
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+    }
+
+    if (tree->root && !btree_set_tombstone_arrays(tree, tree->root, enable)) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    if (enable) {
+        tree->flags |= BTREE_FLAG_LAZY_DELETE;
+    } else {
+        tree->flags &= ~(uint32_t)BTREE_FLAG_LAZY_DELETE;
+    }
+    return BTREE_SUCCESS;
+}
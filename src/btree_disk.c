@@ -0,0 +1,604 @@
+/**
+ * @file btree_disk.c
+ * @brief 파일 기반 노드 할당자 (버퍼 풀)
+ *
+ * 파일을 예약한 주소 공간에 공유 매핑으로 이어 붙이고, 노드는 프레임 (고정
+ * 크기 페이지) 안에서 할당한다. 노드 주소는 파일 안의 위치와 같으므로 트리
+ * 코드는 포인터를 그대로 쓰고, 상주 프레임 수만 CLOCK으로 제한한다. 내보낼
+ * 프레임은 변경되었으면 파일로 쓰고 (msync) 매핑에서 내린다 (MADV_DONTNEED).
+ * 내린 프레임에 다시 접근하면 커널이 파일에서 읽어 오므로 포인터는 항상
+ * 유효하며, 고정(pin)은 유효성이 아니라 상주 여부만 정한다.
+ */
+
+#include "btree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(BTREE_PLATFORM_WINDOWS) || !(defined(__GNUC__) || defined(__clang__))
+
+/* 이 플랫폼에서는 디스크 할당자를 지원하지 않음 */
+
+btree_allocator_t* btree_disk_allocator_create(const char *path, size_t max_size,
+                                               size_t frame_size, size_t resident_limit) {
+    (void)path; (void)max_size; (void)frame_size; (void)resident_limit;
+    btree_set_error(BTREE_ERROR_INVALID_OPERATION);
+    return NULL;
+}
+
+void btree_disk_allocator_destroy(btree_allocator_t *allocator) {
+    (void)allocator;
+}
+
+btree_result_t btree_disk_allocator_flush(btree_allocator_t *allocator) {
+    (void)allocator;
+    return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+}
+
+btree_result_t btree_disk_allocator_pin(btree_allocator_t *allocator, const void *ptr, bool pin) {
+    (void)allocator; (void)ptr; (void)pin;
+    return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+}
+
+bool btree_disk_allocator_get_stats(const btree_allocator_t *allocator, btree_disk_stats_t *stats) {
+    (void)allocator; (void)stats;
+    return false;
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BTREE_DISK_EXTENT_SIZE   (1024 * 1024)  /* 파일 확장 단위 */
+#define BTREE_DISK_MAX_ARENAS    16             /* 동시에 열 수 있는 디스크 할당자 수 */
+#define BTREE_DISK_CLASS_FREE    0              /* 아직 쓰지 않은 프레임 */
+#define BTREE_DISK_CLASS_LARGE   0xffff         /* 여러 프레임에 걸친 할당의 첫 프레임 */
+#define BTREE_DISK_CLASS_TAIL    0xfffe         /* 여러 프레임에 걸친 할당의 나머지 프레임 */
+#define BTREE_DISK_NO_SLOT       SIZE_MAX
+
+/* 프레임 정보 */
+typedef struct {
+    uint16_t size_class;                /* 블록 크기 / 64 또는 BTREE_DISK_CLASS_* */
+    uint8_t referenced;                 /* CLOCK 참조 비트 */
+    uint8_t dirty;                      /* 내보내기 전에 파일로 써야 함 */
+    uint32_t pins;                      /* 고정 횟수 (0보다 크면 내보내지 않음) */
+    uint32_t slot;                      /* CLOCK 링 위치 + 1 (0: 비상주) */
+    uint32_t span;                      /* 큰 할당이 차지하는 프레임 수 */
+} btree_disk_frame_t;
+
+/* 반환된 큰 할당 (같은 프레임 수의 요청에 재사용) */
+typedef struct btree_disk_span {
+    size_t first;
+    size_t count;
+    struct btree_disk_span *next;
+} btree_disk_span_t;
+
+typedef struct {
+    btree_allocator_t allocator;        /* 트리에 넘기는 할당자 (context는 자신) */
+    char *path;                         /* 파일 경로 (해제 시 삭제) */
+    int fd;
+
+    unsigned char *base;                /* 예약한 주소 공간 시작 */
+    size_t reserved;                    /* 예약 크기 (파일 최대 크기) */
+    size_t file_size;                   /* 매핑된 파일 크기 */
+    size_t frame_size;
+    unsigned frame_shift;
+
+    btree_disk_frame_t *frames;         /* 프레임 표 (예약 크기만큼, 쓰는 부분만 메모리 차지) */
+    size_t frames_size;                 /* 프레임 표 매핑 크기 */
+    size_t frames_used;                 /* 할당에 쓰기 시작한 프레임 수 */
+
+    /* 크기 클래스별 자유 블록 스택과 현재 프레임의 남은 영역 */
+    size_t class_count;
+    void **class_free;
+    unsigned char **class_next;
+    unsigned char **class_end;
+    btree_disk_span_t *free_spans;
+
+    /* CLOCK 링 (상주 프레임 번호) */
+    size_t *ring;
+    size_t ring_capacity;
+    size_t ring_count;
+    size_t hand;
+
+    /* 통계 (lock 보호) */
+    size_t pinned_frames;
+    size_t faults;
+    size_t evictions;
+    size_t writebacks;
+    size_t bytes_in_use;
+
+    int lock;                           /* 스핀락 */
+} btree_disk_t;
+
+/* 열린 디스크 할당자 목록 (free에서 포인터 주인 검색) */
+static btree_disk_t *g_disk_arenas[BTREE_DISK_MAX_ARENAS];
+static int g_disk_arenas_lock;
+
+static void btree_disk_lock(int *lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+}
+
+static void btree_disk_unlock(int *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+/* 포인터가 이 할당자의 파일 영역에 있는지 */
+static bool btree_disk_owns(const btree_disk_t *disk, const void *ptr) {
+    const unsigned char *p = ptr;
+    return p >= disk->base && p < disk->base + disk->reserved;
+}
+
+static btree_disk_t* btree_disk_find(const void *ptr) {
+    for (int i = 0; i < BTREE_DISK_MAX_ARENAS; i++) {
+        btree_disk_t *disk = __atomic_load_n(&g_disk_arenas[i], __ATOMIC_ACQUIRE);
+        if (disk && btree_disk_owns(disk, ptr)) return disk;
+    }
+    return NULL;
+}
+
+static size_t btree_disk_frame_of(const btree_disk_t *disk, const void *ptr) {
+    return (size_t)((const unsigned char*)ptr - disk->base) >> disk->frame_shift;
+}
+
+/* 프레임을 파일로 쓰고 매핑에서 내림 */
+static void btree_disk_evict_frame(btree_disk_t *disk, size_t index) {
+    btree_disk_frame_t *frame = &disk->frames[index];
+    unsigned char *addr = disk->base + (index << disk->frame_shift);
+
+    if (frame->dirty) {
+        msync(addr, disk->frame_size, MS_ASYNC);
+        frame->dirty = 0;
+        disk->writebacks++;
+    }
+    madvise(addr, disk->frame_size, MADV_DONTNEED);
+    __atomic_store_n(&frame->slot, 0, __ATOMIC_RELAXED);
+    disk->evictions++;
+}
+
+/*
+ * CLOCK으로 내보낼 프레임을 골라 그 링 위치를 반환.
+ * 참조 비트가 켜진 프레임은 한 번 건너뛰고, 고정된 프레임은 항상 건너뛴다.
+ * 한 바퀴 반을 돌도록 후보가 없으면 (모두 고정) 링 밖에 둔다.
+ */
+static size_t btree_disk_clock_victim(btree_disk_t *disk) {
+    for (size_t steps = 0; steps < 2 * disk->ring_count + 1; steps++) {
+        size_t slot = disk->hand;
+        disk->hand = (disk->hand + 1) % disk->ring_count;
+
+        btree_disk_frame_t *frame = &disk->frames[disk->ring[slot]];
+        if (frame->pins > 0) continue;
+        if (__atomic_load_n(&frame->referenced, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&frame->referenced, 0, __ATOMIC_RELAXED);
+            continue;
+        }
+        btree_disk_evict_frame(disk, disk->ring[slot]);
+        return slot;
+    }
+    return BTREE_DISK_NO_SLOT;
+}
+
+/* 프레임을 상주 집합에 넣음 (lock 보호) */
+static void btree_disk_make_resident(btree_disk_t *disk, size_t index, bool write) {
+    btree_disk_frame_t *frame = &disk->frames[index];
+    if (frame->dirty == 0 && write) frame->dirty = 1;
+    frame->referenced = 1;
+    if (frame->slot != 0) return;
+
+    size_t slot;
+    if (disk->ring_count < disk->ring_capacity) {
+        slot = disk->ring_count++;
+    } else {
+        slot = btree_disk_clock_victim(disk);
+        if (slot == BTREE_DISK_NO_SLOT) return;
+    }
+    disk->ring[slot] = index;
+    __atomic_store_n(&frame->slot, (uint32_t)(slot + 1), __ATOMIC_RELAXED);
+}
+
+/* 파일을 확장하여 예약 영역에 매핑 (lock 보호) */
+static bool btree_disk_grow(btree_disk_t *disk, size_t min_size) {
+    size_t extent = btree_align_size(min_size - disk->file_size, BTREE_DISK_EXTENT_SIZE);
+    size_t new_size = disk->file_size + extent;
+    if (new_size > disk->reserved) new_size = disk->reserved;
+    if (new_size < min_size) return false;
+
+    if (ftruncate(disk->fd, (off_t)new_size) != 0) return false;
+    void *mapped = mmap(disk->base + disk->file_size, new_size - disk->file_size,
+                        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, disk->fd,
+                        (off_t)disk->file_size);
+    if (mapped == MAP_FAILED) return false;
+
+    disk->file_size = new_size;
+    return true;
+}
+
+/* 새 프레임 count개를 연속으로 확보 (lock 보호), 실패 시 SIZE_MAX */
+static size_t btree_disk_take_frames(btree_disk_t *disk, size_t count) {
+    size_t first = disk->frames_used;
+    size_t end = (first + count) << disk->frame_shift;
+    if (end > disk->file_size && !btree_disk_grow(disk, end)) return SIZE_MAX;
+    disk->frames_used += count;
+    return first;
+}
+
+/* 노드 블록 할당 (프레임 경계를 넘지 않음) */
+static void* btree_disk_node_alloc(void *context, size_t size) {
+    btree_disk_t *disk = context;
+    if (size == 0) size = 1;
+
+    btree_disk_lock(&disk->lock);
+    void *block = NULL;
+    size_t index;
+
+    if (size > disk->frame_size) {
+        size_t count = (size + disk->frame_size - 1) >> disk->frame_shift;
+        btree_disk_span_t **link = &disk->free_spans;
+        while (*link && (*link)->count != count) link = &(*link)->next;
+
+        if (*link) {
+            btree_disk_span_t *span = *link;
+            *link = span->next;
+            index = span->first;
+            free(span);
+        } else {
+            index = btree_disk_take_frames(disk, count);
+        }
+        if (index != SIZE_MAX) {
+            disk->frames[index].size_class = BTREE_DISK_CLASS_LARGE;
+            disk->frames[index].span = (uint32_t)count;
+            for (size_t i = 1; i < count; i++) {
+                disk->frames[index + i].size_class = BTREE_DISK_CLASS_TAIL;
+            }
+            disk->bytes_in_use += count << disk->frame_shift;
+            block = disk->base + (index << disk->frame_shift);
+        }
+    } else {
+        size_t cls = (size + BTREE_CACHE_LINE_SIZE - 1) / BTREE_CACHE_LINE_SIZE;
+        size_t block_size = cls * BTREE_CACHE_LINE_SIZE;
+
+        if (disk->class_free[cls]) {
+            block = disk->class_free[cls];
+            disk->class_free[cls] = *(void**)block;
+        } else {
+            if (disk->class_next[cls] + block_size > disk->class_end[cls]) {
+                index = btree_disk_take_frames(disk, 1);
+                if (index != SIZE_MAX) {
+                    disk->frames[index].size_class = (uint16_t)cls;
+                    disk->class_next[cls] = disk->base + (index << disk->frame_shift);
+                    disk->class_end[cls] = disk->class_next[cls] + disk->frame_size;
+                }
+            }
+            if (disk->class_next[cls] + block_size <= disk->class_end[cls]) {
+                block = disk->class_next[cls];
+                disk->class_next[cls] += block_size;
+            }
+        }
+        if (block) disk->bytes_in_use += block_size;
+    }
+
+    if (block) btree_disk_make_resident(disk, btree_disk_frame_of(disk, block), true);
+    btree_disk_unlock(&disk->lock);
+    return block;
+}
+
+/* 블록 크기 (프레임의 크기 클래스로 계산) */
+static size_t btree_disk_block_size(const btree_disk_t *disk, const void *ptr) {
+    const btree_disk_frame_t *frame = &disk->frames[btree_disk_frame_of(disk, ptr)];
+    if (frame->size_class == BTREE_DISK_CLASS_LARGE) {
+        return (size_t)frame->span << disk->frame_shift;
+    }
+    return (size_t)frame->size_class * BTREE_CACHE_LINE_SIZE;
+}
+
+static void btree_disk_node_free(btree_disk_t *disk, void *ptr) {
+    btree_disk_lock(&disk->lock);
+    size_t index = btree_disk_frame_of(disk, ptr);
+    btree_disk_frame_t *frame = &disk->frames[index];
+
+    if (frame->size_class == BTREE_DISK_CLASS_LARGE) {
+        btree_disk_span_t *span = malloc(sizeof(btree_disk_span_t));
+        disk->bytes_in_use -= (size_t)frame->span << disk->frame_shift;
+        if (span) {
+            span->first = index;
+            span->count = frame->span;
+            span->next = disk->free_spans;
+            disk->free_spans = span;
+        }
+    } else {
+        size_t cls = frame->size_class;
+        *(void**)ptr = disk->class_free[cls];
+        disk->class_free[cls] = ptr;
+        disk->bytes_in_use -= cls * BTREE_CACHE_LINE_SIZE;
+        btree_disk_make_resident(disk, index, true);
+    }
+    btree_disk_unlock(&disk->lock);
+}
+
+/* 임시 버퍼 등 노드 외 할당은 기본 할당자 사용 */
+static void* btree_disk_alloc(size_t size) {
+    return btree_default_allocator()->alloc(size);
+}
+
+static void btree_disk_free(void *ptr) {
+    if (!ptr) return;
+    btree_disk_t *disk = btree_disk_find(ptr);
+    if (disk) {
+        btree_disk_node_free(disk, ptr);
+    } else {
+        btree_default_allocator()->free(ptr);
+    }
+}
+
+static void* btree_disk_realloc(void *ptr, size_t new_size) {
+    btree_disk_t *disk = ptr ? btree_disk_find(ptr) : NULL;
+    if (!disk) return btree_default_allocator()->realloc(ptr, new_size);
+
+    void *block = btree_disk_node_alloc(disk, new_size);
+    if (!block) return NULL;
+    size_t old_size = btree_disk_block_size(disk, ptr);
+    memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+    btree_disk_node_free(disk, ptr);
+    return block;
+}
+
+/* 탐색 중 접근 알림: 상주 프레임은 참조 비트만 켜고, 아니면 다시 들임 */
+static void btree_disk_access(void *context, const void *ptr, bool write) {
+    btree_disk_t *disk = context;
+    if (!btree_disk_owns(disk, ptr)) return;
+
+    size_t index = btree_disk_frame_of(disk, ptr);
+    btree_disk_frame_t *frame = &disk->frames[index];
+    if (__atomic_load_n(&frame->slot, __ATOMIC_RELAXED) != 0 &&
+        (!write || __atomic_load_n(&frame->dirty, __ATOMIC_RELAXED))) {
+        if (!__atomic_load_n(&frame->referenced, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&frame->referenced, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+
+    btree_disk_lock(&disk->lock);
+    if (frame->slot == 0) disk->faults++;
+    btree_disk_make_resident(disk, index, write);
+    btree_disk_unlock(&disk->lock);
+}
+
+static btree_disk_t* btree_disk_from(const btree_allocator_t *allocator) {
+    if (!allocator || allocator->node_alloc != btree_disk_node_alloc) return NULL;
+    return allocator->context;
+}
+
+static void btree_disk_release(btree_disk_t *disk) {
+    if (disk->base) munmap(disk->base, disk->reserved);
+    if (disk->frames) munmap(disk->frames, disk->frames_size);
+    if (disk->fd >= 0) {
+        close(disk->fd);
+        unlink(disk->path);
+    }
+    while (disk->free_spans) {
+        btree_disk_span_t *next = disk->free_spans->next;
+        free(disk->free_spans);
+        disk->free_spans = next;
+    }
+    free(disk->path);
+    free(disk->class_free);
+    free(disk->class_next);
+    free(disk->class_end);
+    free(disk->ring);
+    free(disk);
+}
+
+/**
+ * @brief 디스크 할당자 생성
+ */
+btree_allocator_t* btree_disk_allocator_create(const char *path, size_t max_size,
+                                               size_t frame_size, size_t resident_limit) {
+    if (!path) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return NULL;
+    }
+    if (frame_size == 0) frame_size = BTREE_DISK_DEFAULT_FRAME_SIZE;
+    size_t os_page = (size_t)sysconf(_SC_PAGESIZE);
+    if (!btree_is_power_of_two(frame_size) || frame_size < os_page ||
+        frame_size / BTREE_CACHE_LINE_SIZE >= BTREE_DISK_CLASS_TAIL ||
+        max_size < frame_size || resident_limit < frame_size) {
+        btree_set_error(BTREE_ERROR_INVALID_SIZE);
+        return NULL;
+    }
+
+    btree_disk_t *disk = calloc(1, sizeof(btree_disk_t));
+    if (!disk) {
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    disk->fd = -1;
+    disk->frame_size = frame_size;
+    while (((size_t)1 << disk->frame_shift) < frame_size) disk->frame_shift++;
+    disk->reserved = btree_align_size(max_size, frame_size);
+    disk->class_count = frame_size / BTREE_CACHE_LINE_SIZE + 1;
+    disk->ring_capacity = resident_limit / frame_size;
+
+    disk->path = malloc(strlen(path) + 1);
+    disk->class_free = calloc(disk->class_count, sizeof(void*));
+    disk->class_next = calloc(disk->class_count, sizeof(unsigned char*));
+    disk->class_end = calloc(disk->class_count, sizeof(unsigned char*));
+    disk->ring = malloc(disk->ring_capacity * sizeof(size_t));
+    if (!disk->path || !disk->class_free || !disk->class_next || !disk->class_end || !disk->ring) {
+        btree_disk_release(disk);
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    strcpy(disk->path, path);
+
+    /* 노드 주소가 바뀌지 않도록 최대 크기만큼 주소 공간을 먼저 예약 */
+    void *base = mmap(NULL, disk->reserved, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        btree_disk_release(disk);
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    disk->base = base;
+
+    disk->frames_size = btree_align_size((disk->reserved >> disk->frame_shift) *
+                                         sizeof(btree_disk_frame_t), os_page);
+    void *frames = mmap(NULL, disk->frames_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (frames == MAP_FAILED) {
+        btree_disk_release(disk);
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    disk->frames = frames;
+
+    /* 기존 파일은 덮어쓰지 않음 */
+    disk->fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (disk->fd < 0) {
+        btree_disk_release(disk);
+        btree_set_error(BTREE_ERROR_IO);
+        return NULL;
+    }
+
+    int slot = -1;
+    btree_disk_lock(&g_disk_arenas_lock);
+    for (int i = 0; i < BTREE_DISK_MAX_ARENAS && slot < 0; i++) {
+        if (!g_disk_arenas[i]) {
+            __atomic_store_n(&g_disk_arenas[i], disk, __ATOMIC_RELEASE);
+            slot = i;
+        }
+    }
+    btree_disk_unlock(&g_disk_arenas_lock);
+    if (slot < 0) {
+        btree_disk_release(disk);
+        btree_set_error(BTREE_ERROR_INVALID_OPERATION);
+        return NULL;
+    }
+
+    disk->allocator.alloc = btree_disk_alloc;
+    disk->allocator.free = btree_disk_free;
+    disk->allocator.realloc = btree_disk_realloc;
+    disk->allocator.context = disk;
+    disk->allocator.node_alloc = btree_disk_node_alloc;
+    disk->allocator.access = btree_disk_access;
+    return &disk->allocator;
+}
+
+/**
+ * @brief 디스크 할당자 해제 (파일도 삭제, 트리를 먼저 정리해야 함)
+ */
+void btree_disk_allocator_destroy(btree_allocator_t *allocator) {
+    btree_disk_t *disk = btree_disk_from(allocator);
+    if (!disk) return;
+
+    btree_disk_lock(&g_disk_arenas_lock);
+    for (int i = 0; i < BTREE_DISK_MAX_ARENAS; i++) {
+        if (g_disk_arenas[i] == disk) {
+            __atomic_store_n(&g_disk_arenas[i], NULL, __ATOMIC_RELEASE);
+        }
+    }
+    btree_disk_unlock(&g_disk_arenas_lock);
+    btree_disk_release(disk);
+}
+
+/**
+ * @brief 변경된 프레임을 모두 파일에 씀
+ */
+btree_result_t btree_disk_allocator_flush(btree_allocator_t *allocator) {
+    btree_disk_t *disk = btree_disk_from(allocator);
+    if (!disk) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_result_t result = BTREE_SUCCESS;
+    btree_disk_lock(&disk->lock);
+    if (disk->file_size > 0 && msync(disk->base, disk->file_size, MS_SYNC) != 0) {
+        result = BTREE_ERROR_IO;
+    }
+    for (size_t i = 0; result == BTREE_SUCCESS && i < disk->frames_used; i++) {
+        if (disk->frames[i].dirty) {
+            disk->frames[i].dirty = 0;
+            disk->writebacks++;
+        }
+    }
+    btree_disk_unlock(&disk->lock);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 포인터가 있는 프레임 고정/해제 (고정된 프레임은 내보내지 않음)
+ */
+btree_result_t btree_disk_allocator_pin(btree_allocator_t *allocator, const void *ptr, bool pin) {
+    btree_disk_t *disk = btree_disk_from(allocator);
+    if (!disk || !ptr || !btree_disk_owns(disk, ptr)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_result_t result = BTREE_SUCCESS;
+    btree_disk_lock(&disk->lock);
+    size_t index = btree_disk_frame_of(disk, ptr);
+    btree_disk_frame_t *frame = index < disk->frames_used ? &disk->frames[index] : NULL;
+    if (!frame || (!pin && frame->pins == 0)) {
+        result = BTREE_ERROR_INVALID_OPERATION;
+    } else if (pin) {
+        if (frame->pins++ == 0) disk->pinned_frames++;
+        btree_disk_make_resident(disk, index, false);
+    } else if (--frame->pins == 0) {
+        disk->pinned_frames--;
+    }
+    btree_disk_unlock(&disk->lock);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 디스크 할당자 통계
+ */
+bool btree_disk_allocator_get_stats(const btree_allocator_t *allocator, btree_disk_stats_t *stats) {
+    btree_disk_t *disk = btree_disk_from(allocator);
+    if (!disk || !stats) return false;
+
+    btree_disk_lock(&disk->lock);
+    stats->frame_size = disk->frame_size;
+    stats->file_size = disk->file_size;
+    stats->frames_used = disk->frames_used;
+    stats->bytes_in_use = disk->bytes_in_use;
+    stats->resident_frames = 0;
+    for (size_t i = 0; i < disk->ring_count; i++) {
+        if (disk->frames[disk->ring[i]].slot == i + 1) stats->resident_frames++;
+    }
+    stats->resident_limit = disk->ring_capacity;
+    stats->pinned_frames = disk->pinned_frames;
+    stats->faults = disk->faults;
+    stats->evictions = disk->evictions;
+    stats->writebacks = disk->writebacks;
+    btree_disk_unlock(&disk->lock);
+    return true;
+}
+
+#endif
+
+/**
+ * @brief 단일 블록 노드가 한 프레임에 들어가는 최대 차수
+ */
+int btree_disk_page_degree(size_t frame_size, size_t key_size, size_t value_size) {
+    /* 헤더 + (2d - 1)개 키와 값 + 2d개 자식 포인터, 배열 사이 정렬 여유 포함 */
+    size_t overhead = sizeof(btree_node_t) + 2 * sizeof(void*);
+    size_t per_degree = 2 * (key_size + value_size + sizeof(void*));
+    if (frame_size <= overhead) return BTREE_MIN_DEGREE;
+
+    size_t degree = (frame_size - overhead + key_size + value_size) / per_degree;
+    if (degree < BTREE_MIN_DEGREE) degree = BTREE_MIN_DEGREE;
+    if (degree > BTREE_MAX_DEGREE) degree = BTREE_MAX_DEGREE;
+    return (int)degree;
+}
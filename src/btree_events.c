@@ -0,0 +1,255 @@
+/**
+ * @file btree_events.c
+ * @brief 이벤트 훅 (연산별 콜백과 묶음 버퍼)
+ *
+ * 구독이 생길 때 tree->events를 만들고 모든 구독이 사라지면 해제하므로,
+ * 구독하지 않은 트리의 연산은 포인터 검사 하나만 한다. 묶음 버퍼는 이벤트
+ * 레코드와 키/값 사본을 미리 할당해 두고, 가득 차면 한 번의 호출로 넘긴다.
+ */
+
+#include "btree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    btree_event_callback_t callback;
+    void *context;
+} btree_event_handler_t;
+
+typedef struct {
+    btree_event_handler_t handlers[BTREE_EVENT_COUNT];
+    uint32_t handler_mask;              /* 콜백이 있는 이벤트 */
+
+    /* 묶음 버퍼 */
+    uint32_t buffer_mask;               /* 버퍼에 쌓을 이벤트 */
+    btree_event_batch_callback_t batch_callback;
+    void *batch_context;
+    btree_event_record_t *records;
+    unsigned char *payload;             /* 레코드마다 키 | 값 사본 */
+    size_t capacity;
+    size_t count;
+    uint64_t sequence;
+    int busy;                           /* 동시 모드의 버퍼 잠금 */
+} btree_events_t;
+
+static btree_events_t* btree_events_get(btree_t *tree) {
+    if (tree->events) return tree->events;
+
+    btree_events_t *events = tree->allocator->alloc(sizeof(btree_events_t));
+    if (!events) return NULL;
+    memset(events, 0, sizeof(btree_events_t));
+    tree->events = events;
+    return events;
+}
+
+/* 구독이 하나도 없으면 상태 해제 */
+static void btree_events_trim(btree_t *tree) {
+    btree_events_t *events = tree->events;
+    if (events && !events->handler_mask && !events->buffer_mask) {
+        tree->events = NULL;
+        tree->allocator->free(events);
+    }
+}
+
+static void btree_events_lock(const btree_t *tree, btree_events_t *events) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (tree->lock) {
+        while (__atomic_exchange_n(&events->busy, 1, __ATOMIC_ACQUIRE)) {
+            while (__atomic_load_n(&events->busy, __ATOMIC_RELAXED)) { }
+        }
+    }
+#else
+    (void)tree; (void)events;
+#endif
+}
+
+static void btree_events_unlock(const btree_t *tree, btree_events_t *events) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (tree->lock) __atomic_store_n(&events->busy, 0, __ATOMIC_RELEASE);
+#else
+    (void)tree; (void)events;
+#endif
+}
+
+/* 쌓인 레코드 전달 (버퍼 잠금 상태에서 호출) */
+static size_t btree_events_deliver(btree_t *tree, btree_events_t *events) {
+    size_t count = events->count;
+    if (count > 0) {
+        events->batch_callback(tree, events->records, count, events->batch_context);
+        events->count = 0;
+    }
+    return count;
+}
+
+static void btree_events_append(btree_t *tree, btree_events_t *events,
+                                btree_event_type_t event, const void *key, const void *value) {
+    size_t key_size = tree->key_type.key_size;
+    size_t slot_size = key_size + tree->value_type.value_size;
+
+    btree_events_lock(tree, events);
+    btree_event_record_t *record = &events->records[events->count];
+    unsigned char *payload = events->payload + events->count * slot_size;
+
+    record->type = event;
+    record->sequence = ++events->sequence;
+    memcpy(payload, key, key_size);
+    record->key = payload;
+    if (value) {
+        memcpy(payload + key_size, value, tree->value_type.value_size);
+        record->value = payload + key_size;
+    } else {
+        record->value = NULL;
+    }
+
+    if (++events->count == events->capacity) {
+        btree_events_deliver(tree, events);
+    }
+    btree_events_unlock(tree, events);
+}
+
+/**
+ * @brief 구독한 콜백과 버퍼로 이벤트 전달
+ */
+void btree_event_dispatch(btree_t *tree, btree_event_type_t event,
+                          const void *key, const void *value) {
+    btree_events_t *events = tree->events;
+    uint32_t bit = BTREE_EVENT_MASK(event);
+
+    if (events->handler_mask & bit) {
+        const btree_event_handler_t *handler = &events->handlers[event];
+        handler->callback(tree, event, key, value, handler->context);
+    }
+    if (events->buffer_mask & bit) {
+        btree_events_append(tree, events, event, key, value);
+    }
+}
+
+/**
+ * @brief 이벤트 콜백 등록 (같은 이벤트의 이전 콜백은 교체)
+ */
+btree_result_t btree_set_event_callback(btree_t *tree, btree_event_type_t event,
+                                       btree_event_callback_t callback, void *context) {
+    if (!tree || !callback) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (event < 0 || event >= BTREE_EVENT_COUNT) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_events_t *events = btree_events_get(tree);
+    if (!events) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    events->handlers[event].callback = callback;
+    events->handlers[event].context = context;
+    events->handler_mask |= BTREE_EVENT_MASK(event);
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 이벤트 콜백 해제 (등록되어 있지 않아도 성공)
+ */
+btree_result_t btree_remove_event_callback(btree_t *tree, btree_event_type_t event) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (event < 0 || event >= BTREE_EVENT_COUNT) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_events_t *events = tree->events;
+    if (events) {
+        events->handlers[event].callback = NULL;
+        events->handlers[event].context = NULL;
+        events->handler_mask &= ~BTREE_EVENT_MASK(event);
+        btree_events_trim(tree);
+    }
+    return BTREE_SUCCESS;
+}
+
+/* 버퍼를 비우고 해제 */
+static void btree_events_drop_buffer(btree_t *tree, btree_events_t *events) {
+    if (!events->buffer_mask) return;
+
+    btree_events_deliver(tree, events);
+    tree->allocator->free(events->records);
+    tree->allocator->free(events->payload);
+    events->records = NULL;
+    events->payload = NULL;
+    events->buffer_mask = 0;
+    events->capacity = 0;
+    events->batch_callback = NULL;
+    events->batch_context = NULL;
+}
+
+/**
+ * @brief 이벤트 묶음 버퍼 설정
+ */
+btree_result_t btree_set_event_buffer(btree_t *tree, uint32_t mask, size_t capacity,
+                                      btree_event_batch_callback_t callback, void *context) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (mask & ~(uint32_t)BTREE_EVENT_MASK_ALL) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    if (tree->events) {
+        btree_events_drop_buffer(tree, tree->events);
+    }
+    if (!mask || !callback) {
+        btree_events_trim(tree);
+        return BTREE_SUCCESS;
+    }
+    if (capacity == 0) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_events_t *events = btree_events_get(tree);
+    if (!events) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    size_t slot_size = tree->key_type.key_size + tree->value_type.value_size;
+    events->records = tree->allocator->alloc(capacity * sizeof(btree_event_record_t));
+    events->payload = tree->allocator->alloc(capacity * slot_size);
+    if (!events->records || !events->payload) {
+        if (events->records) tree->allocator->free(events->records);
+        if (events->payload) tree->allocator->free(events->payload);
+        events->records = NULL;
+        events->payload = NULL;
+        btree_events_trim(tree);
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    events->capacity = capacity;
+    events->count = 0;
+    events->batch_callback = callback;
+    events->batch_context = context;
+    events->buffer_mask = mask;
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 버퍼에 쌓인 이벤트를 바로 전달
+ */
+size_t btree_flush_events(btree_t *tree) {
+    if (!tree || !tree->events) return 0;
+
+    btree_events_t *events = tree->events;
+    if (!events->buffer_mask) return 0;
+
+    btree_events_lock(tree, events);
+    size_t delivered = btree_events_deliver(tree, events);
+    btree_events_unlock(tree, events);
+    return delivered;
+}
+
+/* 트리 정리: 남은 이벤트를 보내고 구독 해제 */
+void btree_events_release(btree_t *tree) {
+    btree_events_t *events = tree->events;
+    if (!events) return;
+
+    btree_events_drop_buffer(tree, events);
+    tree->events = NULL;
+    tree->allocator->free(events);
+}
@@ -0,0 +1,743 @@
+#ifndef BTREE_INTERNAL_H
+#define BTREE_INTERNAL_H
+
+/**
+ * @file btree_internal.h
+ * @brief 라이브러리 내부 전용 헬퍼 (설치되지 않음)
+ */
+
+#include "../include/btree.h"
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 오류 설정 함수 */
+void btree_set_error(btree_result_t error);
+
+/* 키 포인터 계산 */
+static inline void* btree_get_key_ptr(const btree_node_t *node, int index,
+                                     const btree_type_info_t *key_type) {
+    return (char*)node->keys + (index * key_type->key_size);
+}
+
+/* 값 포인터 계산 */
+static inline void* btree_get_value_ptr(const btree_node_t *node, int index,
+                                       const btree_type_info_t *value_type) {
+    return (char*)node->values + (index * value_type->value_size);
+}
+
+/* 동시 접근 모드 여부 (btree_set_thread_safe) */
+static inline bool btree_is_concurrent(const btree_t *tree) {
+    return tree->lock != NULL;
+}
+
+/*
+ * 잠금 없는 검색과 겹치는 노드 접근 (동시 모드)
+ *
+ * 잠금 없는 검색은 쓰기가 고치는 중인 슬롯을 읽은 뒤 버전으로 결과를 버리므로,
+ * 검색이 읽는 필드 (첫 단어의 num_keys와 is_leaf, 키, 값, 삭제 표시, 자식)는
+ * 쓰는 쪽과 읽는 쪽 모두 단어 단위 원자적 접근으로 다룬다. 단어는 주소와
+ * 길이가 함께 맞는 가장 큰 크기이며, 저장은 release, 읽기는 acquire라 자식
+ * 포인터를 읽으면 그 노드의 초기화도 보인다. atomic이 거짓이면 보통 복사다.
+ */
+#define BTREE_ATOMIC_SLOT_MAX   256     /* 원자적 기록 전에 임시 슬롯에 복사하는 최대 크기 */
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef uint64_t btree_word64_t __attribute__((may_alias));
+typedef uint32_t btree_word32_t __attribute__((may_alias));
+typedef uint16_t btree_word16_t __attribute__((may_alias));
+
+#define BTREE_ATOMIC_COPY_WORDS(word_t, dst, src, bytes, load_order, store_order) \
+    do { \
+        word_t *d_ = (word_t*)(dst); \
+        const word_t *s_ = (const word_t*)(src); \
+        size_t n_ = (bytes) / sizeof(word_t); \
+        if ((const void*)d_ <= (const void*)s_) { \
+            for (size_t i_ = 0; i_ < n_; i_++) \
+                __atomic_store_n(d_ + i_, __atomic_load_n(s_ + i_, load_order), store_order); \
+        } else { \
+            for (size_t i_ = n_; i_-- > 0;) \
+                __atomic_store_n(d_ + i_, __atomic_load_n(s_ + i_, load_order), store_order); \
+        } \
+    } while (0)
+
+#define BTREE_ATOMIC_COPY(dst, src, bytes, load_order, store_order) \
+    do { \
+        uintptr_t align_ = (uintptr_t)(dst) | (uintptr_t)(src) | (uintptr_t)(bytes); \
+        if (!(align_ & 7)) { \
+            BTREE_ATOMIC_COPY_WORDS(btree_word64_t, dst, src, bytes, load_order, store_order); \
+        } else if (!(align_ & 3)) { \
+            BTREE_ATOMIC_COPY_WORDS(btree_word32_t, dst, src, bytes, load_order, store_order); \
+        } else if (!(align_ & 1)) { \
+            BTREE_ATOMIC_COPY_WORDS(btree_word16_t, dst, src, bytes, load_order, store_order); \
+        } else { \
+            BTREE_ATOMIC_COPY_WORDS(uint8_t, dst, src, bytes, load_order, store_order); \
+        } \
+    } while (0)
+#endif
+
+/* 검색과 겹치는 노드에 기록 (겹치는 영역 허용, 원본은 쓰는 스레드만 고치는 메모리) */
+static inline void btree_atomic_move(void *dst, const void *src, size_t bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+    BTREE_ATOMIC_COPY(dst, src, bytes, __ATOMIC_RELAXED, __ATOMIC_RELEASE);
+#else
+    memmove(dst, src, bytes);
+#endif
+}
+
+/* 쓰기와 겹치는 노드에서 전용 버퍼로 읽기 (검색) */
+static inline void btree_atomic_load(void *dst, const void *src, size_t bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+    BTREE_ATOMIC_COPY(dst, src, bytes, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#else
+    memcpy(dst, src, bytes);
+#endif
+}
+
+/* 노드 메모리 이동 (겹치는 영역 허용, 삭제 표시와 자식 포인터 배열) */
+static inline void btree_node_memmove(void *dst, const void *src, size_t bytes, bool atomic) {
+    if (BTREE_UNLIKELY(atomic)) {
+        btree_atomic_move(dst, src, bytes);
+    } else {
+        memmove(dst, src, bytes);
+    }
+}
+
+/* 슬롯 count개 이동 (소유권 이전, 겹치는 영역 허용) */
+static inline void btree_slots_move(const btree_type_info_t *type, size_t size, void *dst,
+                                    const void *src, size_t count, bool atomic) {
+    if (count == 0) return;
+    if (BTREE_UNLIKELY(atomic)) {
+        /* 동시 모드 타입은 move가 비트 복사임 (btree_set_thread_safe) */
+        btree_atomic_move(dst, src, count * size);
+    } else if (type->move) {
+        type->move(dst, src, count);
+    } else {
+        memmove(dst, src, count * size);
+    }
+}
+
+/*
+ * 슬롯 하나에 키나 값 복사 (atomic이면 임시 슬롯에 복사한 뒤 원자적으로 기록).
+ * 임시 슬롯보다 큰 타입은 비트 복사 타입뿐이므로 (btree_set_thread_safe) 바로 옮긴다.
+ */
+static inline void btree_slot_store(const btree_type_info_t *type, size_t size, void *slot,
+                                    const void *src, bool atomic) {
+    if (BTREE_UNLIKELY(atomic)) {
+        uint64_t staged[BTREE_ATOMIC_SLOT_MAX / sizeof(uint64_t)];
+        if (type->copy && size <= sizeof(staged)) {
+            type->copy(staged, src, 1);
+            src = staged;
+        }
+        btree_atomic_move(slot, src, size);
+    } else if (type->copy) {
+        type->copy(slot, src, 1);
+    } else {
+        memcpy(slot, src, size);
+    }
+}
+
+/* 삭제 표시 기록 */
+static inline void btree_slot_mark(uint8_t *flag, uint8_t dead, bool atomic) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_UNLIKELY(atomic)) {
+        __atomic_store_n(flag, dead, __ATOMIC_RELEASE);
+        return;
+    }
+#endif
+    (void)atomic;
+    *flag = dead;
+}
+
+/*
+ * 노드 첫 단어 (is_leaf부터 num_keys까지의 비트 필드, GCC와 Clang은 uint32_t
+ * 하나에 묶음)를 원자적으로 읽어 head에 복사 (검색용, head의 나머지는 무의미)
+ */
+static inline void btree_node_load_head(const btree_node_t *node, btree_node_t *head) {
+#if defined(__GNUC__) || defined(__clang__)
+    uint32_t word = __atomic_load_n((const btree_word32_t*)node, __ATOMIC_ACQUIRE);
+    memcpy(head, &word, sizeof(word));
+#else
+    memcpy(head, node, sizeof(uint32_t));
+#endif
+}
+
+/* 키 수 기록 (atomic이면 첫 단어를 통째로 원자적으로 기록) */
+static inline void btree_node_store_count(btree_node_t *node, int count, bool atomic) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_UNLIKELY(atomic)) {
+        btree_node_t head;
+        uint32_t word;
+        memcpy(&head, node, sizeof(word));
+        head.num_keys = (uint32_t)count;
+        memcpy(&word, &head, sizeof(word));
+        __atomic_store_n((btree_word32_t*)node, word, __ATOMIC_RELEASE);
+        return;
+    }
+#endif
+    (void)atomic;
+    node->num_keys = (uint32_t)count;
+}
+
+
+/* 키 슬롯 이동 (소유권 이전, 겹치는 영역 허용) */
+static inline void btree_move_keys(const btree_t *tree, void *dst, const void *src,
+                                   size_t count) {
+    btree_slots_move(&tree->key_type, tree->key_type.key_size, dst, src, count,
+                     btree_is_concurrent(tree));
+}
+
+/* 값 슬롯 이동 (소유권 이전, 겹치는 영역 허용) */
+static inline void btree_move_values(const btree_t *tree, void *dst, const void *src,
+                                     size_t count) {
+    btree_slots_move(&tree->value_type, tree->value_type.value_size, dst, src, count,
+                     btree_is_concurrent(tree));
+}
+
+/* 키 슬롯에 키 복사 */
+static inline void btree_store_key(const btree_t *tree, void *slot, const void *key) {
+    btree_slot_store(&tree->key_type, tree->key_type.key_size, slot, key,
+                     btree_is_concurrent(tree));
+}
+
+/* 값 슬롯에 값 복사 */
+static inline void btree_store_value(const btree_t *tree, void *slot, const void *value) {
+    btree_slot_store(&tree->value_type, tree->value_type.value_size, slot, value,
+                     btree_is_concurrent(tree));
+}
+
+/* 키 수 기록 */
+static inline void btree_node_set_count(const btree_t *tree, btree_node_t *node, int count) {
+    btree_node_store_count(node, count, btree_is_concurrent(tree));
+}
+
+/* 자식 포인터 기록 (동시 모드에서는 새 자식의 초기화가 함께 보이도록 공개) */
+static inline void btree_node_set_child(const btree_t *tree, btree_node_t *node, int index,
+                                        btree_node_t *child) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_UNLIKELY(btree_is_concurrent(tree))) {
+        __atomic_store_n(&node->children[index], child, __ATOMIC_RELEASE);
+        return;
+    }
+#endif
+    node->children[index] = child;
+}
+
+/* 자식 포인터 이동 */
+static inline void btree_move_children(const btree_t *tree, btree_node_t **dst,
+                                       btree_node_t *const *src, size_t count) {
+    btree_node_memmove(dst, src, count * sizeof(btree_node_t*), btree_is_concurrent(tree));
+}
+
+/* 루트 교체 (동시 모드에서는 새 루트의 초기화가 함께 보이도록 공개) */
+static inline void btree_set_root(btree_t *tree, btree_node_t *root) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_UNLIKELY(btree_is_concurrent(tree))) {
+        __atomic_store_n(&tree->root, root, __ATOMIC_RELEASE);
+        return;
+    }
+#endif
+    tree->root = root;
+}
+
+/*
+ * NUMA 복제본 (btree_numa.c): 복제된 상위 노드가 바뀌거나 해제되면 복제본을
+ * 무효로 하고, 삽입과 삭제가 끝날 때 다시 만든다. 무효인 동안 검색은 원본
+ * 루트부터 내려간다.
+ */
+#ifdef BTREE_NUMA_SUPPORT
+void btree_numa_invalidate(const btree_t *tree, const btree_node_t *node, bool freed);
+void btree_numa_sync(btree_t *tree);
+void btree_numa_release(btree_t *tree);
+btree_node_t* btree_numa_root(const btree_t *tree);
+#endif
+
+/* 노드를 바꾸기 전에 호출 */
+static inline void btree_replica_touch(const btree_t *tree, const btree_node_t *node) {
+#ifdef BTREE_NUMA_SUPPORT
+    if (BTREE_UNLIKELY(node->replicated)) btree_numa_invalidate(tree, node, false);
+#else
+    (void)tree;
+    (void)node;
+#endif
+}
+
+/* 노드를 트리에서 뺄 때 호출 */
+static inline void btree_replica_forget(const btree_t *tree, const btree_node_t *node) {
+#ifdef BTREE_NUMA_SUPPORT
+    if (BTREE_UNLIKELY(node->replicated)) btree_numa_invalidate(tree, node, true);
+#else
+    (void)tree;
+    (void)node;
+#endif
+}
+
+/* 복제본 해제 (트리를 비우거나 공유, 동시 모드로 바꿀 때) */
+static inline void btree_replica_release(btree_t *tree) {
+#ifdef BTREE_NUMA_SUPPORT
+    if (tree->numa) btree_numa_release(tree);
+#else
+    (void)tree;
+#endif
+}
+
+/* 쓰기 연산 끝에서 호출 */
+static inline void btree_replica_sync(btree_t *tree) {
+#ifdef BTREE_NUMA_SUPPORT
+    if (BTREE_UNLIKELY(tree->numa != NULL)) btree_numa_sync(tree);
+#else
+    (void)tree;
+#endif
+}
+
+/* 검색 시작 노드 (이 소켓의 복제 루트, 없거나 무효면 원본 루트) */
+static inline btree_node_t* btree_search_root(const btree_t *tree) {
+#ifdef BTREE_NUMA_SUPPORT
+    if (BTREE_UNLIKELY(tree->numa != NULL)) return btree_numa_root(tree);
+#endif
+    return tree->root;
+}
+
+/**
+ * 슬롯 이동: 키, 값, 삭제 표시를 함께 옮긴다 (같은 노드 안의 겹치는 이동 허용).
+ * 삭제 표시 배열이 없는 노드에서 온 슬롯은 살아 있는 것으로 기록한다.
+ */
+static inline void btree_move_slots(const btree_t *tree, btree_node_t *dst, int dst_index,
+                                    btree_node_t *src, int src_index, int count) {
+    if (count <= 0) return;
+    btree_replica_touch(tree, dst);
+    btree_replica_touch(tree, src);
+    btree_move_keys(tree, btree_get_key_ptr(dst, dst_index, &tree->key_type),
+                    btree_get_key_ptr(src, src_index, &tree->key_type), count);
+    if (dst->values && src->values) {
+        btree_move_values(tree, btree_get_value_ptr(dst, dst_index, &tree->value_type),
+                          btree_get_value_ptr(src, src_index, &tree->value_type), count);
+    }
+    if (dst->tombstones) {
+        uint8_t *flags = dst->tombstones + dst_index;
+        if (BTREE_UNLIKELY(btree_is_concurrent(tree))) {
+            if (src->tombstones) {
+                btree_atomic_move(flags, src->tombstones + src_index, count);
+            } else {
+                for (int i = 0; i < count; i++) btree_slot_mark(flags + i, 0, true);
+            }
+        } else if (src->tombstones) {
+            memmove(flags, src->tombstones + src_index, count);
+        } else {
+            memset(flags, 0, count);
+        }
+    }
+}
+
+/* B+Tree 여부 (값은 리프에만, 내부 노드 키는 구분 키 사본) */
+static inline bool btree_is_plus(const btree_t *tree) {
+    return tree->variant == BTREE_VARIANT_PLUS;
+}
+
+/* 노드 종류별 최대 키 수 */
+static inline int btree_node_capacity_for(const btree_t *tree, bool is_leaf) {
+    return is_leaf ? tree->max_keys : tree->internal_max_keys;
+}
+
+/* 노드 종류별 값 배열 보유 여부 */
+static inline bool btree_node_has_values(const btree_t *tree, bool is_leaf) {
+    return is_leaf || !btree_is_plus(tree);
+}
+
+/* 노드 메모리를 공용 노드 풀의 정확한 크기 클래스에서 받는지 (캐시 라인 정렬 보장) */
+static inline bool btree_node_pooled(const btree_t *tree) {
+    return tree->allocator == btree_node_pool_allocator();
+}
+
+/* 노드 블록이 캐시 라인 정렬로 나오는지 (공용 노드 풀 또는 node_alloc이 있는 할당자) */
+static inline bool btree_node_aligned(const btree_t *tree) {
+    return btree_node_pooled(tree) || tree->allocator->node_alloc != NULL;
+}
+
+/*
+ * 운영 계측 (btree_stats.c)
+ *
+ * tree->metrics가 NULL이 아닐 때만 센다. 동시 모드 트리는 여러 스레드가
+ * 같은 카운터를 올리므로 원자적으로 더한다.
+ */
+typedef struct {
+    btree_metrics_t data;               /* 누적값 (스냅숏으로 그대로 복사) */
+    uint32_t flags;                     /* BTREE_METRICS_* */
+} btree_metrics_state_t;
+
+static inline void btree_metric_add(const btree_t *tree, uint64_t *counter, uint64_t delta) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_UNLIKELY(tree->lock != NULL)) {
+        __atomic_add_fetch(counter, delta, __ATOMIC_RELAXED);
+        return;
+    }
+#endif
+    (void)tree;
+    *counter += delta;
+}
+
+#define BTREE_METRIC_ADD(tree, field, delta) \
+    do { \
+        if (BTREE_UNLIKELY((tree)->metrics != NULL)) { \
+            btree_metric_add((tree), \
+                &((btree_metrics_state_t*)(tree)->metrics)->data.field, (delta)); \
+        } \
+    } while (0)
+
+/* 연산 시작 시각 (지연 시간을 재지 않으면 0) / 연산 수와 지연 시간 기록 */
+uint64_t btree_metrics_start(const btree_t *tree);
+void btree_metrics_finish(const btree_t *tree, btree_metric_op_t op, uint64_t start);
+
+static inline uint64_t btree_op_begin(const btree_t *tree) {
+    return BTREE_UNLIKELY(tree->metrics != NULL) ? btree_metrics_start(tree) : 0;
+}
+
+static inline void btree_op_end(const btree_t *tree, btree_metric_op_t op, uint64_t start) {
+    if (BTREE_UNLIKELY(tree->metrics != NULL)) btree_metrics_finish(tree, op, start);
+}
+
+/*
+ * 이벤트 훅 (btree_events.c)
+ *
+ * tree->events가 NULL이면 구독이 없다. 디스패치는 구독한 이벤트만 처리한다.
+ */
+void btree_event_dispatch(btree_t *tree, btree_event_type_t event,
+                          const void *key, const void *value);
+void btree_events_release(btree_t *tree);
+
+static inline void btree_event_emit(btree_t *tree, btree_event_type_t event,
+                                    const void *key, const void *value) {
+    if (BTREE_UNLIKELY(tree->events != NULL)) btree_event_dispatch(tree, event, key, value);
+}
+
+/* 계측이나 이벤트 구독이 있는지 (공개 연산의 느린 경로 선택) */
+static inline bool btree_is_observed(const btree_t *tree) {
+    return (tree->metrics != NULL) | (tree->events != NULL);
+}
+
+/* 노드 하나를 방문하며 키 n개를 이진 검색하는 비교 수 (floor(log2 n) + 1) */
+static inline void btree_metrics_visit(const btree_t *tree, int num_keys) {
+    btree_metrics_state_t *state = (btree_metrics_state_t*)tree->metrics;
+    uint64_t cost = 0;
+    for (unsigned n = (unsigned)num_keys; n > 0; n >>= 1) cost++;
+    btree_metric_add(tree, &state->data.nodes_visited, 1);
+    btree_metric_add(tree, &state->data.comparisons, cost);
+}
+
+/* 노드 메모리 할당 (해제는 tree->allocator->free) */
+static inline void* btree_node_alloc(btree_t *tree, size_t size) {
+    BTREE_METRIC_ADD(tree, node_allocs, 1);
+    if (btree_node_pooled(tree)) return btree_node_pool_alloc(size);
+    if (tree->allocator->node_alloc) {
+        return tree->allocator->node_alloc(tree->allocator->context, size);
+    }
+    return tree->allocator->alloc(size);
+}
+
+/* 노드 접근 알림 (디스크 할당자가 상주 페이지를 고르는 데 사용, 계측의 노드 방문 수) */
+static inline void btree_node_access(const btree_t *tree, const btree_node_t *node, bool write) {
+    if (BTREE_UNLIKELY(tree->metrics != NULL)) {
+        btree_metrics_visit(tree, node->num_keys);
+    }
+    if (BTREE_UNLIKELY(tree->allocator->access != NULL)) {
+        tree->allocator->access(tree->allocator->context, node, write);
+        if (!node->is_inline) {
+            tree->allocator->access(tree->allocator->context, node->keys, write);
+        }
+    }
+}
+
+/*
+ * 검색 결과(pos)로 내려갈 자식 인덱스 계산.
+ * B+Tree의 구분 키는 오른쪽 서브트리의 첫 키이므로 같으면 오른쪽으로 간다.
+ */
+static inline int btree_descend_index(int pos) {
+    return pos >= 0 ? pos + 1 : -(pos + 1);
+}
+
+/* B+Tree 구분 키 설정: src 슬롯의 키 사본을 dst 슬롯에 기록 (값은 없음) */
+static inline void btree_copy_separator(const btree_t *tree, btree_node_t *dst, int dst_index,
+                                        const btree_node_t *src, int src_index) {
+    btree_replica_touch(tree, dst);
+    btree_store_key(tree, btree_get_key_ptr(dst, dst_index, &tree->key_type),
+                    btree_get_key_ptr(src, src_index, &tree->key_type));
+    if (dst->tombstones) {
+        btree_slot_mark(dst->tombstones + dst_index, 0, btree_is_concurrent(tree));
+    }
+}
+
+/* 삭제 표시된 슬롯인지 확인 */
+static inline bool btree_slot_is_dead(const btree_node_t *node, int index) {
+    return node->tombstones && node->tombstones[index];
+}
+
+/* 루트가 아닌 노드의 최소 키 수 */
+static inline int btree_node_min_keys(const btree_node_t *node) {
+    return ((int)node->capacity - 1) / 2;
+}
+
+/* 포인터를 담는 타입인지 (타입 이름에 '*' 포함 또는 소멸 함수가 있음,
+ * 노드 바이트만으로 값이 완결되지 않음) */
+static inline bool btree_type_is_pointer(const btree_type_info_t *type) {
+    return (type->type_name && strchr(type->type_name, '*')) || type->destroy != NULL;
+}
+
+/* 파일을 매핑한 읽기 전용 트리인지 (btree_load_from_file) */
+static inline bool btree_is_mapped(const btree_t *tree) {
+    return tree->storage != NULL;
+}
+
+/* FNV-1a 체크섬 (파일 헤더, 로그 레코드) */
+static inline uint32_t btree_checksum(const void *data, size_t size, uint32_t hash) {
+    const unsigned char *bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+#define BTREE_CHECKSUM_SEED 2166136261u
+
+/* 트리 카운터 갱신 (동시 모드에서는 원자적으로, delta는 size_t 래핑으로 음수 표현) */
+static inline void btree_counter_add(btree_t *tree, size_t *counter, size_t delta) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_UNLIKELY(btree_is_concurrent(tree))) {
+        __atomic_add_fetch(counter, delta, __ATOMIC_RELAXED);
+        return;
+    }
+#endif
+    (void)tree;
+    *counter += delta;
+}
+
+/*
+ * 동시 접근 모드 (btree_concurrent.c)
+ *
+ * 읽기는 잠금 없이 노드 버전으로 검증하고, 삽입은 분할하거나 수정하는 노드만
+ * 잠근다. 삭제처럼 노드를 해제하는 구조 변경은 쓰기 구간(writer_begin/end)에서
+ * 배타적으로 수행하며 해제할 노드는 정리 시점까지 보류한다.
+ */
+btree_result_t btree_concurrent_insert(btree_t *tree, const void *key, const void *value);
+void* btree_concurrent_search(btree_t *tree, const void *key, void *value_out);
+void btree_writer_begin(btree_t *tree);
+void btree_writer_end(btree_t *tree);
+void btree_node_retire(btree_t *tree, btree_node_t *node);
+void btree_reclaim_retired(btree_t *tree);
+
+/* 정렬된 키 배열 검색 (btree_node_find_key와 같은 반환 규칙, 트리의 검색 방식) */
+int btree_keys_find(const btree_t *tree, const void *keys, int count, const void *key);
+
+/* 노드 안 키 검색 (빈 노드면 -1) */
+static inline int btree_node_search(const btree_t *tree, const btree_node_t *node,
+                                    const void *key) {
+    if (node->num_keys == 0) return -1;
+    return btree_keys_find(tree, node->keys, node->num_keys, key);
+}
+
+/* 노드 용량과 키 크기로 search_window 다시 계산 (차수나 변형이 바뀐 뒤) */
+void btree_update_search(btree_t *tree);
+
+/*
+ * 파일 매핑 트리 (btree_persist.c)
+ *
+ * 매핑된 페이지를 그대로 검색한다. 매핑 해제는 btree_clear/btree_destroy에서 한다.
+ * 압축 이미지는 리프를 캐시에 풀어서 검색하며, value_out이 있으면 캐시 잠금
+ * 안에서 값을 복사한다.
+ */
+void* btree_mapped_search(const btree_t *tree, const void *key, void *value_out);
+bool btree_mapped_validate(const btree_t *tree);
+void btree_storage_release(btree_t *tree);
+btree_result_t btree_storage_materialize(btree_t *tree);
+
+/* 이미지 저장 (로그 식별자와 이미지에 반영된 마지막 LSN을 헤더에 기록, fsync 포함) */
+btree_result_t btree_persist_save(const btree_t *tree, const char *filename,
+                                  uint64_t log_id, uint64_t log_lsn);
+
+/*
+ * 로그 복구 (btree_wal.c)
+ *
+ * filename의 로그에서 log_id가 같고 log_lsn 뒤에 커밋된 트랜잭션 수를 세거나
+ * 트리에 다시 적용한다.
+ */
+size_t btree_wal_pending(const char *filename, uint64_t log_id, uint64_t log_lsn,
+                         size_t key_size, size_t value_size);
+btree_result_t btree_wal_replay(btree_t *tree, const char *filename,
+                                uint64_t log_id, uint64_t log_lsn);
+
+/* 삭제 표시된 슬롯을 새 값으로 되살림 (살아 있으면 DUPLICATE_KEY) */
+btree_result_t btree_revive_slot(btree_t *tree, btree_node_t *node, int index,
+                                 const void *value);
+
+/* 살아 있는 슬롯은 값만 교체하고, 삭제 표시된 슬롯은 되살림 */
+void btree_overwrite_slot(btree_t *tree, btree_node_t *node, int index, const void *value);
+
+/* btree_node_insert_key / btree_node_remove_key의 트리 버전 (동시 모드면 원자적으로 기록) */
+btree_result_t btree_node_insert_at(btree_t *tree, btree_node_t *node, int index,
+                                    const void *key, const void *value);
+btree_result_t btree_node_remove_at(btree_t *tree, btree_node_t *node, int index);
+
+/*
+ * 재배치 아레나 (btree_layout.c)
+ *
+ * 재배치는 노드를 한 덩어리로 할당한 아레나에 순서대로 잘라 넣는다. 아레나
+ * 노드는 하나씩 해제하지 않고, 잘라 준 노드가 모두 해제되고 만든 쪽의 참조도
+ * 놓이면 통째로 반환된다. 스냅숏과 공유한 노드는 다른 스레드에서 해제될 수
+ * 있어 참조 수는 원자적으로 바꾼다.
+ */
+typedef struct btree_arena {
+    size_t live;                        /* 잘라 준 노드 수 + 만든 쪽의 참조 하나 */
+    size_t used;                        /* 잘라 준 바이트 수 */
+    size_t size;                        /* 노드 영역 크기 */
+    char *base;                         /* 캐시 라인 정렬된 노드 영역 시작 */
+} btree_arena_t;
+
+static inline void btree_arena_ref(btree_arena_t *arena) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_add_fetch(&arena->live, 1, __ATOMIC_RELAXED);
+#else
+    arena->live++;
+#endif
+}
+
+/* 노드 size바이트 영역을 가진 아레나 생성 (node_alloc 할당자는 NULL, 배치는 할당자에 맡김) */
+btree_arena_t* btree_arena_create(btree_t *tree, size_t size);
+
+/* 참조 하나를 놓고 마지막이면 아레나 반환 */
+void btree_arena_release(btree_t *tree, btree_arena_t *arena);
+
+/* 아레나에 노드 생성 (arena가 NULL이거나 가득 차면 트리의 할당자 사용) */
+btree_node_t* btree_node_create_in(btree_t *tree, btree_arena_t *arena, bool is_leaf);
+
+/* 전체 노드를 새 아레나에 order 순서로 옮김 (쓰기 구간 안에서 호출) */
+btree_result_t btree_layout_apply(btree_t *tree, btree_layout_order_t order);
+
+/* 점진 재배치 상태 해제 (btree_clear) */
+void btree_layout_release(btree_t *tree);
+
+/* 자식 index와 index + 1을 부모의 구분 키와 함께 왼쪽 자식으로 병합 (btree_delete.c) */
+void btree_merge_children(btree_t *tree, btree_node_t *parent, int index);
+
+/*
+ * 노드 공유 (btree_copy)
+ *
+ * 스냅숏은 노드를 참조 카운트로 공유한다. 쓰기는 루트부터 내려가며 참조가
+ * 둘 이상인 노드를 복사해 바꿔 끼우므로 (경로 복사), 수정하는 노드는 항상 이
+ * 트리만 참조한다. 다른 스레드의 트리와 같은 노드를 동시에 놓을 수 있어
+ * 참조 카운트는 원자적으로 바꾼다.
+ */
+static inline bool btree_node_is_shared(const btree_node_t *node) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(&node->ref_count, __ATOMIC_ACQUIRE) > 1;
+#else
+    return node->ref_count > 1;
+#endif
+}
+
+static inline void btree_node_ref(btree_node_t *node) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_add_fetch(&node->ref_count, 1, __ATOMIC_RELAXED);
+#else
+    node->ref_count++;
+#endif
+}
+
+/* 참조 하나를 놓음 (마지막 참조였으면 true) */
+static inline bool btree_node_unref(btree_node_t *node) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (BTREE_LIKELY(__atomic_load_n(&node->ref_count, __ATOMIC_ACQUIRE) == 1)) return true;
+    return __atomic_sub_fetch(&node->ref_count, 1, __ATOMIC_ACQ_REL) == 0;
+#else
+    return --node->ref_count == 0;
+#endif
+}
+
+/* 키, 값, 삭제 표시를 빈 노드 dst로 복사 (타입의 copy 함수 사용, 자식은 제외) */
+void btree_node_copy_slots(const btree_t *tree, btree_node_t *dst, const btree_node_t *src);
+
+/* 공유 노드의 전용 사본으로 교체 (원본의 참조 하나를 놓음, 메모리 부족 시 NULL) */
+btree_node_t* btree_node_unshare(btree_t *tree, btree_node_t *node, btree_node_t *parent,
+                                 btree_arena_t *arena);
+
+/* 수정할 루트 (공유 중이면 사본으로 교체, 메모리 부족 시 NULL) */
+static inline btree_node_t* btree_writable_root(btree_t *tree) {
+    btree_node_t *root = tree->root;
+    if (BTREE_UNLIKELY(btree_node_is_shared(root))) {
+        root = btree_node_unshare(tree, root, NULL, NULL);
+        if (root) tree->root = root;
+    }
+    return root;
+}
+
+/* 수정할 자식 (parent는 이미 이 트리 전용이어야 함, 메모리 부족 시 NULL) */
+static inline btree_node_t* btree_writable_child(btree_t *tree, btree_node_t *parent, int index) {
+    btree_node_t *child = parent->children[index];
+    if (BTREE_UNLIKELY(btree_node_is_shared(child))) {
+        child = btree_node_unshare(tree, child, parent, NULL);
+        if (child) parent->children[index] = child;
+    }
+    return child;
+}
+
+/* 부모 포인터 갱신 (공유된 노드는 부모가 여럿이므로 건드리지 않음) */
+static inline void btree_node_set_parent(btree_node_t *node, btree_node_t *parent) {
+    if (BTREE_LIKELY(!btree_node_is_shared(node))) node->parent = parent;
+}
+
+/* 리프 연결을 유지하는지 (노드를 공유한 표준 트리는 사본의 이웃을 고칠 수 없어 끊음) */
+static inline bool btree_has_leaf_links(const btree_t *tree) {
+    return !(tree->flags & BTREE_FLAG_SHARED);
+}
+
+/* 삽입 경로 (btree_insert_descend 결과) */
+typedef struct {
+    btree_node_t *node;                 /* 같은 키가 있는 노드 또는 삽입할 리프 */
+    int pos;                            /* node에서의 검색 결과 (btree_node_find_key) */
+    const void *upper;                  /* 리프에 들어갈 키의 상한 (없으면 NULL) */
+} btree_insert_path_t;
+
+/* 치우친 분할로 바꾸는 연속 오른쪽 끝 추가 수 (BTREE_FLAG_APPEND가 없을 때) */
+#define BTREE_APPEND_RUN 16
+
+/* 선제 분할하며 삽입 위치까지 내려감 (오른쪽 끝 리프에 닿으면 tree->append_leaf로 기억) */
+btree_result_t btree_insert_descend(btree_t *tree, const void *key, btree_insert_path_t *path);
+
+/* 가득 찬 자식 노드를 분할하여 중간 키를 부모로 올림 (append면 오른쪽에 키 하나만 남김) */
+btree_result_t btree_split_child(btree_t *tree, btree_node_t *parent, int index, bool append);
+
+/* 단일 블록 노드 레이아웃 (헤더 | 키 | 자식 | 값) */
+typedef struct {
+    size_t keys_offset;                 /* 키 배열 오프셋 */
+    size_t children_offset;             /* 자식 배열 오프셋 (리프는 0) */
+    size_t values_offset;               /* 값 배열 오프셋 */
+    size_t block_size;                  /* 캐시 라인 단위로 정렬된 블록 크기 */
+} btree_node_layout_t;
+
+void btree_node_compute_layout(const btree_t *tree, bool is_leaf,
+                               btree_node_layout_t *layout);
+
+/* 노드 하나가 차지하는 실제 메모리 크기 */
+size_t btree_node_memory_size(const btree_t *tree, const btree_node_t *node);
+
+/*
+ * 작업 분배 (btree_parallel.c)
+ *
+ * btree_parallel_for는 [0, count) 작업을 workers개 스레드 (호출한 스레드가
+ * 0번)에 나눠 func(context, index, worker)로 실행하고 모두 끝나면 반환한다.
+ * 자기 구간을 다 비운 스레드는 다른 스레드 구간의 뒤쪽 절반을 훔친다.
+ * 스레드를 만들지 못하면 남은 스레드가 그 구간까지 처리하므로 실패하지 않는다.
+ */
+#define BTREE_PARALLEL_MAX_THREADS 64
+
+typedef void (*btree_task_func_t)(void *context, size_t index, int worker);
+
+/* 쓸 작업 스레드 수 (requested가 0 이하면 온라인 CPU 수, 1..BTREE_PARALLEL_MAX_THREADS) */
+int btree_parallel_threads(int requested);
+void btree_parallel_for(size_t count, int workers, btree_task_func_t func, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BTREE_INTERNAL_H */
@@ -0,0 +1,569 @@
+/**
+ * @file btree_iterator.c
+ * @brief B-Tree 반복자 및 범위 검색 구현
+ *
+ * 반복자는 노드 저장소를 직접 가리키는 포인터를 돌려주며 키나 값을 복사하지
+ * 않는다. B+Tree는 리프 연결(next_leaf/prev_leaf)을 따라가고, 표준 B-Tree는
+ * 내부 노드에도 항목이 있으므로 높이만큼의 명시적 경로 스택으로 중위 순회한다.
+ */
+
+#include "btree_internal.h"
+#include <string.h>
+
+/* 커서 위치의 키 포인터 */
+static inline void* btree_iter_key(const btree_iterator_t *iter) {
+    return btree_get_key_ptr(iter->current_node, iter->current_index, &iter->tree->key_type);
+}
+
+/* 경로 스택의 마지막 항목을 커서에 반영 */
+static inline void btree_iter_sync(btree_iterator_t *iter) {
+    iter->current_node = iter->path[iter->depth - 1];
+    iter->current_index = iter->path_index[iter->depth - 1];
+}
+
+/* 경로 스택에 노드 추가 */
+static inline void btree_iter_push(btree_iterator_t *iter, btree_node_t *node, int index) {
+    iter->path[iter->depth] = node;
+    iter->path_index[iter->depth] = index;
+    iter->depth++;
+}
+
+/* node 서브트리의 첫 항목까지 내려감 */
+static void btree_iter_descend_first(btree_iterator_t *iter, btree_node_t *node) {
+    while (!node->is_leaf) {
+        btree_iter_push(iter, node, 0);
+        node = node->children[0];
+    }
+    btree_iter_push(iter, node, 0);
+}
+
+/* node 서브트리의 마지막 항목까지 내려감 */
+static void btree_iter_descend_last(btree_iterator_t *iter, btree_node_t *node) {
+    while (!node->is_leaf) {
+        btree_iter_push(iter, node, node->num_keys);
+        node = node->children[node->num_keys];
+    }
+    btree_iter_push(iter, node, node->num_keys - 1);
+}
+
+/*
+ * 다 읽은 노드를 스택에서 꺼내고 다음 항목이 있는 조상으로 올라감.
+ * 자식 c에서 돌아온 조상의 다음 항목은 키 c이다.
+ */
+static bool btree_iter_pop_forward(btree_iterator_t *iter) {
+    for (;;) {
+        if (--iter->depth == 0) return false;
+        int top = iter->depth - 1;
+        if (iter->path_index[top] < iter->path[top]->num_keys) return true;
+    }
+}
+
+/* 다음 항목으로 이동 (없으면 false) */
+static bool btree_iter_advance(btree_iterator_t *iter) {
+    if (btree_is_plus(iter->tree)) {
+        btree_node_t *node = iter->current_node;
+        if (iter->current_index + 1 < node->num_keys) {
+            iter->current_index++;
+            return true;
+        }
+        if (!node->next_leaf) return false;
+        iter->current_node = node->next_leaf;
+        iter->current_index = 0;
+        return true;
+    }
+
+    int top = iter->depth - 1;
+    btree_node_t *node = iter->path[top];
+    int index = iter->path_index[top];
+
+    if (!node->is_leaf) {
+        iter->path_index[top] = index + 1;
+        btree_iter_descend_first(iter, node->children[index + 1]);
+    } else if (index + 1 < node->num_keys) {
+        iter->path_index[top] = index + 1;
+    } else if (!btree_iter_pop_forward(iter)) {
+        return false;
+    }
+    btree_iter_sync(iter);
+    return true;
+}
+
+/* 이전 항목으로 이동 (없으면 false, 표준 B-Tree는 경로가 비워짐) */
+static bool btree_iter_retreat(btree_iterator_t *iter) {
+    if (btree_is_plus(iter->tree)) {
+        btree_node_t *node = iter->current_node;
+        if (iter->current_index > 0) {
+            iter->current_index--;
+            return true;
+        }
+        if (!node->prev_leaf) return false;
+        iter->current_node = node->prev_leaf;
+        iter->current_index = iter->current_node->num_keys - 1;
+        return true;
+    }
+
+    int top = iter->depth - 1;
+    btree_node_t *node = iter->path[top];
+    int index = iter->path_index[top];
+
+    if (!node->is_leaf) {
+        btree_iter_descend_last(iter, node->children[index]);
+    } else if (index > 0) {
+        iter->path_index[top] = index - 1;
+    } else {
+        /* 자식 c에서 돌아온 조상의 이전 항목은 키 c - 1 */
+        for (;;) {
+            if (--iter->depth == 0) return false;
+            top = iter->depth - 1;
+            if (iter->path_index[top] > 0) {
+                iter->path_index[top]--;
+                break;
+            }
+        }
+    }
+    btree_iter_sync(iter);
+    return true;
+}
+
+/*
+ * 노드 안에서 key의 경계 위치 계산.
+ * strict가 false면 key 이상인 첫 위치, true면 key보다 큰 첫 위치.
+ */
+static int btree_iter_node_bound(const btree_t *tree, const btree_node_t *node,
+                                 const void *key, bool strict) {
+    btree_node_access(tree, node, false);
+    int pos = btree_node_search(tree, node, key);
+    if (pos < 0) return -(pos + 1);
+
+    /* 중복 키가 허용되면 같은 키 구간의 끝까지 이동 */
+    if (strict) {
+        while (pos < node->num_keys &&
+               tree->key_type.compare(btree_get_key_ptr(node, pos, &tree->key_type), key) == 0) {
+            pos++;
+        }
+    } else {
+        while (pos > 0 &&
+               tree->key_type.compare(btree_get_key_ptr(node, pos - 1, &tree->key_type), key) == 0) {
+            pos--;
+        }
+    }
+    return pos;
+}
+
+/* 접두사 탐색 조건 */
+typedef struct {
+    const unsigned char *bytes;
+    size_t length;
+} btree_prefix_t;
+
+/* 키의 바이트 표현 (타입이 지원하지 않으면 NULL) */
+static inline const unsigned char* btree_key_bytes(const btree_t *tree, const void *key,
+                                                   size_t *length) {
+    if (!tree->key_type.bytes) {
+        *length = tree->key_type.key_size;
+        return key;
+    }
+    return tree->key_type.bytes(key, length);
+}
+
+/* 키를 접두사와 비교 (접두사로 시작하면 0, 접두사보다 앞이면 음수) */
+static inline int btree_prefix_compare(const btree_t *tree, const void *key,
+                                       const btree_prefix_t *prefix) {
+    size_t length;
+    const unsigned char *bytes = btree_key_bytes(tree, key, &length);
+    size_t n = length < prefix->length ? length : prefix->length;
+    int cmp = n ? memcmp(bytes, prefix->bytes, n) : 0;
+    if (cmp != 0 || length >= prefix->length) return cmp;
+    return -1;
+}
+
+/* 노드 안에서 접두사 이상인 첫 위치 (키 순서가 바이트 사전순이므로 이진 검색) */
+static int btree_iter_prefix_bound(const btree_t *tree, const btree_node_t *node,
+                                   const btree_prefix_t *prefix) {
+    btree_node_access(tree, node, false);
+    int left = 0, right = node->num_keys;
+    while (left < right) {
+        int mid = (left + right) >> 1;
+        if (btree_prefix_compare(tree, btree_get_key_ptr(node, mid, &tree->key_type), prefix) < 0) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return left;
+}
+
+/*
+ * 접두사 이상인 첫 항목으로 커서 이동.
+ * B+Tree 구분 키가 접두사로 시작해도 왼쪽 자식에 같은 접두사의 키가 있을 수
+ * 있으므로 내부 노드에서도 하한으로 내려간다.
+ */
+static bool btree_iter_seek_prefix(btree_iterator_t *iter, const btree_prefix_t *prefix) {
+    btree_t *tree = iter->tree;
+    btree_node_t *node = tree->root;
+
+    iter->depth = 0;
+    iter->current_node = NULL;
+    iter->current_index = 0;
+    if (!node || node->num_keys == 0) return false;
+
+    if (btree_is_plus(tree)) {
+        while (!node->is_leaf) {
+            node = node->children[btree_iter_prefix_bound(tree, node, prefix)];
+        }
+        int pos = btree_iter_prefix_bound(tree, node, prefix);
+        if (pos == node->num_keys) {
+            if (!node->next_leaf) return false;
+            node = node->next_leaf;
+            pos = 0;
+        }
+        iter->current_node = node;
+        iter->current_index = pos;
+        return true;
+    }
+
+    for (;;) {
+        int pos = btree_iter_prefix_bound(tree, node, prefix);
+        btree_iter_push(iter, node, pos);
+        if (node->is_leaf) break;
+        node = node->children[pos];
+    }
+    if (iter->path_index[iter->depth - 1] == node->num_keys && !btree_iter_pop_forward(iter)) {
+        return false;
+    }
+    btree_iter_sync(iter);
+    return true;
+}
+
+/*
+ * 경계 위치로 커서 이동 (key가 NULL이면 첫 항목).
+ * @return 해당 위치에 항목이 있으면 true, 트리 끝이면 false
+ */
+static bool btree_iter_seek(btree_iterator_t *iter, const void *key, bool strict) {
+    btree_t *tree = iter->tree;
+    btree_node_t *node = tree->root;
+
+    iter->depth = 0;
+    iter->current_node = NULL;
+    iter->current_index = 0;
+    if (!node || node->num_keys == 0) return false;
+
+    if (!key) {
+        if (btree_is_plus(tree)) {
+            while (!node->is_leaf) node = node->children[0];
+            iter->current_node = node;
+            return true;
+        }
+        btree_iter_descend_first(iter, node);
+        btree_iter_sync(iter);
+        return true;
+    }
+
+    if (btree_is_plus(tree)) {
+        /* 구분 키는 오른쪽 서브트리의 첫 키이므로 같으면 오른쪽으로 */
+        while (!node->is_leaf) {
+            node = node->children[btree_iter_node_bound(tree, node, key, true)];
+        }
+        int pos = btree_iter_node_bound(tree, node, key, strict);
+        if (pos == node->num_keys) {
+            if (!node->next_leaf) return false;
+            node = node->next_leaf;
+            pos = 0;
+        }
+        iter->current_node = node;
+        iter->current_index = pos;
+        return true;
+    }
+
+    for (;;) {
+        int pos = btree_iter_node_bound(tree, node, key, strict);
+        btree_iter_push(iter, node, pos);
+        if (node->is_leaf) break;
+        node = node->children[pos];
+    }
+    if (iter->path_index[iter->depth - 1] == node->num_keys && !btree_iter_pop_forward(iter)) {
+        return false;
+    }
+    btree_iter_sync(iter);
+    return true;
+}
+
+/* 마지막 항목으로 커서 이동 (max_key가 있으면 그 이하의 마지막 항목) */
+static bool btree_iter_seek_last(btree_iterator_t *iter) {
+    btree_t *tree = iter->tree;
+
+    if (iter->max_key) {
+        /* max_key보다 큰 첫 항목의 바로 앞 */
+        if (btree_iter_seek(iter, iter->max_key, true)) {
+            return btree_iter_retreat(iter);
+        }
+    }
+
+    btree_node_t *node = tree->root;
+    if (btree_is_plus(tree)) {
+        while (!node->is_leaf) node = node->children[node->num_keys];
+        iter->current_node = node;
+        iter->current_index = node->num_keys - 1;
+        return true;
+    }
+    iter->depth = 0;
+    btree_iter_descend_last(iter, node);
+    btree_iter_sync(iter);
+    return true;
+}
+
+/* 삭제 표시된 항목을 건너뛰고 범위 상한을 확인하여 커서 정규화 */
+static void btree_iter_settle(btree_iterator_t *iter) {
+    while (iter->is_valid && btree_slot_is_dead(iter->current_node, iter->current_index)) {
+        iter->is_valid = btree_iter_advance(iter);
+    }
+    if (iter->is_valid && iter->max_key &&
+        iter->tree->key_type.compare(btree_iter_key(iter), iter->max_key) > 0) {
+        iter->is_valid = false;
+    }
+}
+
+/**
+ * @brief 반복자 초기화 (힙 할당 없음)
+ */
+btree_result_t btree_iterator_init(btree_iterator_t *iter, btree_t *tree,
+                                   const void *min_key, const void *max_key) {
+    if (!iter || !tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    iter->tree = tree;
+    /* 매핑된 트리는 메모리 노드가 없으므로 빈 반복자 (검색만 지원) */
+    if (btree_is_mapped(tree)) {
+        iter->current_node = NULL;
+        iter->current_index = 0;
+        iter->is_valid = false;
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    iter->is_reverse = false;
+    iter->min_key = min_key;
+    iter->max_key = max_key;
+    btree_iterator_reset(iter);
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 트리 전체를 순회하는 반복자 생성
+ */
+btree_iterator_t* btree_iterator_create(btree_t *tree) {
+    return btree_iterator_create_range(tree, NULL, NULL);
+}
+
+/**
+ * @brief [min_key, max_key] 범위 반복자 생성 (경계 키는 복사하지 않음)
+ */
+btree_iterator_t* btree_iterator_create_range(btree_t *tree,
+                                             const void *min_key, const void *max_key) {
+    if (!tree) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return NULL;
+    }
+
+    btree_iterator_t *iter = tree->allocator->alloc(sizeof(btree_iterator_t));
+    if (!iter) {
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    btree_iterator_init(iter, tree, min_key, max_key);
+    return iter;
+}
+
+/**
+ * @brief 다음 항목 반환 후 커서 전진
+ */
+bool btree_iterator_next(btree_iterator_t *iter, void **key, void **value) {
+    if (!iter || !iter->is_valid) return false;
+
+    if (key) *key = btree_iter_key(iter);
+    if (value) *value = btree_get_value_ptr(iter->current_node, iter->current_index,
+                                            &iter->tree->value_type);
+
+    iter->is_valid = btree_iter_advance(iter);
+    btree_iter_settle(iter);
+    return true;
+}
+
+/**
+ * @brief 커서를 한 칸 뒤로 옮기고 그 항목 반환
+ *
+ * 처음 위치에서는 false를 반환하며 커서는 그대로 남는다.
+ */
+bool btree_iterator_prev(btree_iterator_t *iter, void **key, void **value) {
+    if (!iter || !iter->tree->root) return false;
+
+    const btree_compare_func_t compare = iter->tree->key_type.compare;
+    bool found = iter->is_valid ? btree_iter_retreat(iter) : btree_iter_seek_last(iter);
+
+    while (found && btree_slot_is_dead(iter->current_node, iter->current_index)) {
+        found = btree_iter_retreat(iter);
+    }
+    if (found && iter->min_key && compare(btree_iter_key(iter), iter->min_key) < 0) {
+        found = false;
+    }
+    if (!found) {
+        /* 경로가 바뀌었으므로 처음 위치로 복원 */
+        btree_iterator_reset(iter);
+        return false;
+    }
+
+    iter->is_valid = true;
+    if (key) *key = btree_iter_key(iter);
+    if (value) *value = btree_get_value_ptr(iter->current_node, iter->current_index,
+                                            &iter->tree->value_type);
+    return true;
+}
+
+/**
+ * @brief 최대 max_pairs개의 항목을 pairs에 채우고 커서 전진
+ *
+ * @return 채운 항목 수 (0이면 끝)
+ */
+size_t btree_iterator_next_batch(btree_iterator_t *iter, btree_key_value_pair_t *pairs,
+                                 size_t max_pairs) {
+    if (!iter || !pairs) return 0;
+
+    const btree_t *tree = iter->tree;
+    size_t count = 0;
+
+    if (!btree_is_plus(tree)) {
+        while (count < max_pairs && btree_iterator_next(iter, &pairs[count].key,
+                                                        &pairs[count].value)) {
+            count++;
+        }
+        return count;
+    }
+
+    /* B+Tree: 리프 단위로 연속 구간을 한 번에 채움 */
+    while (count < max_pairs && iter->is_valid) {
+        btree_node_t *leaf = iter->current_node;
+        int i = iter->current_index;
+
+        for (; i < leaf->num_keys && count < max_pairs; i++) {
+            if (btree_slot_is_dead(leaf, i)) continue;
+            void *key = btree_get_key_ptr(leaf, i, &tree->key_type);
+            if (iter->max_key && tree->key_type.compare(key, iter->max_key) > 0) {
+                iter->is_valid = false;
+                return count;
+            }
+            pairs[count].key = key;
+            pairs[count].value = btree_get_value_ptr(leaf, i, &tree->value_type);
+            count++;
+        }
+
+        if (i < leaf->num_keys) {
+            iter->current_index = i;
+        } else if (leaf->next_leaf) {
+            iter->current_node = leaf->next_leaf;
+            iter->current_index = 0;
+        } else {
+            iter->is_valid = false;
+        }
+    }
+    btree_iter_settle(iter);
+    return count;
+}
+
+/**
+ * @brief 다음 항목 존재 여부
+ */
+bool btree_iterator_has_next(const btree_iterator_t *iter) {
+    return iter && iter->is_valid;
+}
+
+/**
+ * @brief 이전 항목 존재 여부
+ */
+bool btree_iterator_has_prev(const btree_iterator_t *iter) {
+    if (!iter) return false;
+
+    btree_iterator_t probe = *iter;
+    return btree_iterator_prev(&probe, NULL, NULL);
+}
+
+/**
+ * @brief 반복자를 범위의 처음으로 되돌림
+ */
+void btree_iterator_reset(btree_iterator_t *iter) {
+    if (!iter) return;
+
+    iter->is_valid = btree_iter_seek(iter, iter->min_key, false);
+    btree_iter_settle(iter);
+}
+
+/**
+ * @brief 반복자 해제
+ */
+void btree_iterator_destroy(btree_iterator_t *iter) {
+    if (iter) {
+        iter->tree->allocator->free(iter);
+    }
+}
+
+/**
+ * @brief 범위 검색 (결과는 노드 저장소를 가리키는 포인터)
+ */
+size_t btree_range_search(btree_t *tree, const void *min_key, const void *max_key,
+                         btree_key_value_pair_t *results, size_t max_results) {
+    if (!tree || !results) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return 0;
+    }
+
+    btree_iterator_t iter;
+    btree_iterator_init(&iter, tree, min_key, max_key);
+    return btree_iterator_next_batch(&iter, results, max_results);
+}
+
+/**
+ * @brief 바이트 접두사로 시작하는 키를 순서대로 results에 채움
+ *
+ * 접두사의 하한으로 한 번 내려간 뒤 접두사가 맞는 동안만 앞으로 읽는다.
+ * 결과는 range_search처럼 노드 저장소를 가리킨다.
+ */
+size_t btree_prefix_search(btree_t *tree, const void *prefix, size_t prefix_len,
+                          btree_key_value_pair_t *results, size_t max_results) {
+    if (!tree || !results || (!prefix && prefix_len > 0)) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return 0;
+    }
+    if (btree_is_mapped(tree)) {
+        btree_set_error(BTREE_ERROR_INVALID_OPERATION);
+        return 0;
+    }
+    if (tree->key_type.bytes) {
+        size_t length;
+        btree_node_t *root = tree->root;
+        if (root && root->num_keys > 0 &&
+            !tree->key_type.bytes(btree_get_key_ptr(root, 0, &tree->key_type), &length)) {
+            btree_set_error(BTREE_ERROR_TYPE_MISMATCH);
+            return 0;
+        }
+    }
+
+    btree_prefix_t bound = { prefix, prefix_len };
+    btree_iterator_t iter;
+    iter.tree = tree;
+    iter.is_reverse = false;
+    iter.min_key = NULL;
+    iter.max_key = NULL;
+    iter.is_valid = btree_iter_seek_prefix(&iter, &bound);
+    btree_iter_settle(&iter);
+
+    size_t count = 0;
+    while (count < max_results && iter.is_valid) {
+        void *key = btree_iter_key(&iter);
+        if (btree_prefix_compare(tree, key, &bound) != 0) break;
+        results[count].key = key;
+        results[count].value = btree_get_value_ptr(iter.current_node, iter.current_index,
+                                                   &tree->value_type);
+        count++;
+        iter.is_valid = btree_iter_advance(&iter);
+        btree_iter_settle(&iter);
+    }
+    return count;
+}
@@ -0,0 +1,532 @@
+/**
+ * @file btree_layout.c
+ * @brief 노드 재배치 (아레나에 BFS/vEB 순서로 연속 배치, 점진 압축)
+ *
+ * 노드를 옮길 때 슬롯은 복사하지 않고 이동하며, 비게 된 옛 노드는 병합된
+ * 노드처럼 내용 소멸 없이 해제한다 (동시 모드는 정리 시점까지 보류). 다른
+ * 트리와 공유하는 노드는 btree_node_unshare로 아레나 안에 사본을 만든다.
+ */
+
+#include "btree_internal.h"
+#include <string.h>
+
+/* 점진 재배치 진행 상태 (tree->layout) */
+typedef struct {
+    btree_arena_t *arena;               /* 현재 레벨의 아레나 (node_alloc 할당자는 NULL) */
+    int level;                          /* 처리 중인 레벨 (리프가 0) */
+    size_t level_nodes;                 /* 현재 레벨의 노드 수 (윗 레벨 자식 수의 합) */
+    size_t next_nodes;                  /* 지금까지 센 다음 레벨 노드 수 */
+    bool has_cursor;                    /* 거짓이면 레벨의 맨 왼쪽부터 */
+    void *cursor;                       /* 다음에 처리할 노드의 첫 키 사본 */
+} btree_layout_state_t;
+
+/* 한 레벨을 왼쪽부터 도는 위치 (nodes[d]는 깊이 d의 노드, index[d]는 거기서 내려간 자식) */
+typedef struct {
+    btree_node_t *nodes[BTREE_MAX_HEIGHT];
+    int index[BTREE_MAX_HEIGHT];
+    int depth;                          /* 처리할 레벨의 깊이 */
+} btree_layout_walk_t;
+
+/* 전체 재배치 순서의 항목 (루트가 항상 0번) */
+typedef struct {
+    btree_node_t *node;                 /* 옮길 노드 (옮긴 뒤에는 새 노드) */
+    size_t parent;                      /* 부모 항목 위치 */
+    int index;                          /* 부모에서의 자식 인덱스 */
+    int depth;                          /* 루트로부터의 깊이 */
+} btree_layout_entry_t;
+
+/**
+ * @brief 아레나 생성
+ *
+ * 헤더 뒤에 캐시 라인 정렬된 노드 영역을 둔다. 파일에 노드를 두는 할당자는
+ * 노드 위치를 스스로 정하므로 아레나를 만들지 않는다.
+ */
+btree_arena_t* btree_arena_create(btree_t *tree, size_t size) {
+    if (tree->allocator->node_alloc || size == 0) return NULL;
+
+    btree_arena_t *arena = tree->allocator->alloc(sizeof(btree_arena_t) + size +
+                                                  BTREE_CACHE_LINE_SIZE - 1);
+    if (!arena) return NULL;
+
+    uintptr_t start = (uintptr_t)(arena + 1);
+    arena->base = (char*)((start + BTREE_CACHE_LINE_SIZE - 1) &
+                          ~(uintptr_t)(BTREE_CACHE_LINE_SIZE - 1));
+    arena->live = 1;
+    arena->used = 0;
+    arena->size = size;
+    return arena;
+}
+
+/**
+ * @brief 아레나 참조 하나를 놓음 (마지막이면 반환)
+ */
+void btree_arena_release(btree_t *tree, btree_arena_t *arena) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (__atomic_sub_fetch(&arena->live, 1, __ATOMIC_ACQ_REL) != 0) return;
+#else
+    if (--arena->live != 0) return;
+#endif
+    tree->allocator->free(arena);
+}
+
+/* 아레나를 만들 수 없는 것이 메모리 부족 때문인지 */
+static bool btree_arena_missing(const btree_t *tree, const btree_arena_t *arena) {
+    return !arena && !tree->allocator->node_alloc;
+}
+
+/* 노드 종류별 아레나 블록 크기 */
+static size_t btree_layout_block_size(const btree_t *tree, bool is_leaf) {
+    btree_node_layout_t layout;
+    btree_node_compute_layout(tree, is_leaf, &layout);
+    return layout.block_size;
+}
+
+/* 트리 높이 (레벨 수, 맨 왼쪽 경로로 셈) */
+static int btree_layout_height(const btree_node_t *node) {
+    int height = 1;
+    while (!node->is_leaf) {
+        node = node->children[0];
+        height++;
+    }
+    return height;
+}
+
+/**
+ * @brief node(parent의 index번 자식, 루트면 parent는 NULL)를 아레나의 새 노드로 옮김
+ *
+ * @return 옮긴 노드 (메모리 부족 시 NULL, 트리는 그대로)
+ */
+static btree_node_t* btree_layout_move(btree_t *tree, btree_arena_t *arena,
+                                       btree_node_t *node, btree_node_t *parent, int index) {
+    if (parent) btree_replica_touch(tree, parent);
+
+    /* 공유 노드는 사본을 만들고 원본의 참조를 놓음 */
+    if (btree_node_is_shared(node)) {
+        btree_node_t *copy = btree_node_unshare(tree, node, parent, arena);
+        if (!copy) return NULL;
+        if (parent) {
+            btree_node_set_child(tree, parent, index, copy);
+        } else {
+            btree_set_root(tree, copy);
+        }
+        return copy;
+    }
+
+    btree_node_t *moved = btree_node_create_in(tree, arena, node->is_leaf);
+    if (!moved) return NULL;
+
+    int n = node->num_keys;
+    btree_move_slots(tree, moved, 0, node, 0, n);
+    moved->num_keys = n;
+    if (!node->is_leaf) {
+        memcpy(moved->children, node->children, (n + 1) * sizeof(btree_node_t*));
+        for (int i = 0; i <= n; i++) {
+            btree_node_set_parent(moved->children[i], moved);
+        }
+    }
+    moved->parent = parent;
+    moved->version = node->version;
+
+    if (node->is_leaf && btree_has_leaf_links(tree)) {
+        moved->prev_leaf = node->prev_leaf;
+        moved->next_leaf = node->next_leaf;
+        if (moved->prev_leaf) moved->prev_leaf->next_leaf = moved;
+        if (moved->next_leaf) moved->next_leaf->prev_leaf = moved;
+    }
+
+    if (parent) {
+        btree_node_set_child(tree, parent, index, moved);
+    } else {
+        btree_set_root(tree, moved);
+    }
+
+    /* 비운 옛 노드는 내용 소멸 없이 해제 */
+    btree_node_set_count(tree, node, 0);
+    if (!node->is_leaf) {
+        btree_node_set_child(tree, node, 0, NULL);
+    }
+    btree_node_retire(tree, node);
+    return moved;
+}
+
+/* 항목 추가 */
+static void btree_layout_push(btree_layout_entry_t *entries, size_t *count,
+                              btree_node_t *node, size_t parent, int index, int depth) {
+    btree_layout_entry_t *entry = &entries[(*count)++];
+    entry->node = node;
+    entry->parent = parent;
+    entry->index = index;
+    entry->depth = depth;
+}
+
+/* BFS 순서 (항목 배열을 그대로 큐로 사용) */
+static void btree_layout_order_bfs(btree_layout_entry_t *entries, size_t *count,
+                                   btree_node_t *root) {
+    btree_layout_push(entries, count, root, 0, 0, 0);
+    for (size_t head = 0; head < *count; head++) {
+        btree_node_t *node = entries[head].node;
+        if (node->is_leaf) continue;
+        for (int i = 0; i <= node->num_keys; i++) {
+            btree_layout_push(entries, count, node->children[i], head, i,
+                              entries[head].depth + 1);
+        }
+    }
+}
+
+/**
+ * @brief van Emde Boas 순서
+ *
+ * 높이 levels인 서브트리를 위쪽 levels / 2 레벨과 그 아래 서브트리들로 나눠
+ * 각각 재귀적으로 이어 놓는다. 이 순서에서는 같은 깊이의 노드가 항상 키
+ * 순서로 나오므로, 위쪽 조각의 맨 아래 노드를 놓인 순서대로 따라가면 된다.
+ */
+static void btree_layout_order_veb(btree_layout_entry_t *entries, size_t *count,
+                                   btree_node_t *node, size_t parent, int index,
+                                   int depth, int levels) {
+    if (levels == 1) {
+        btree_layout_push(entries, count, node, parent, index, depth);
+        return;
+    }
+
+    int top = levels / 2;
+    size_t first = *count;
+    btree_layout_order_veb(entries, count, node, parent, index, depth, top);
+    size_t end = *count;
+
+    for (size_t e = first; e < end; e++) {
+        btree_node_t *bottom = entries[e].node;
+        if (entries[e].depth != depth + top - 1) continue;
+        for (int i = 0; i <= bottom->num_keys; i++) {
+            btree_layout_order_veb(entries, count, bottom->children[i], e, i,
+                                   depth + top, levels - top);
+        }
+    }
+}
+
+/* 서브트리의 노드 수 */
+static size_t btree_layout_count(const btree_node_t *node) {
+    size_t count = 1;
+    if (!node->is_leaf) {
+        for (int i = 0; i <= node->num_keys; i++) {
+            count += btree_layout_count(node->children[i]);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 전체 노드를 새 아레나에 order 순서로 옮김
+ *
+ * 부모가 항상 자식보다 먼저 놓이므로 항목 순서대로 옮기면 부모 항목은 이미
+ * 새 노드를 가리킨다. 중간에 메모리가 모자라면 거기서 멈추며 트리는 유효하다.
+ * 공유를 모두 끊으면 (모든 노드가 새 사본) 리프를 다시 연결하고 공유 표시를 지운다.
+ */
+btree_result_t btree_layout_apply(btree_t *tree, btree_layout_order_t order) {
+    btree_layout_release(tree);
+    if (!tree->root) return BTREE_SUCCESS;
+
+    size_t total = btree_layout_count(tree->root);
+    btree_layout_entry_t *entries = tree->allocator->alloc(total * sizeof(btree_layout_entry_t));
+    if (!entries) return BTREE_ERROR_MEMORY_ALLOCATION;
+
+    size_t count = 0;
+    if (order == BTREE_LAYOUT_VEB) {
+        btree_layout_order_veb(entries, &count, tree->root, 0, 0, 0,
+                               btree_layout_height(tree->root));
+    } else {
+        btree_layout_order_bfs(entries, &count, tree->root);
+    }
+
+    size_t leaf_block = btree_layout_block_size(tree, true);
+    size_t internal_block = btree_layout_block_size(tree, false);
+    size_t bytes = 0;
+    for (size_t k = 0; k < count; k++) {
+        bytes += entries[k].node->is_leaf ? leaf_block : internal_block;
+    }
+
+    btree_arena_t *arena = btree_arena_create(tree, bytes);
+    if (btree_arena_missing(tree, arena)) {
+        tree->allocator->free(entries);
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    btree_result_t result = BTREE_SUCCESS;
+    for (size_t k = 0; k < count; k++) {
+        btree_node_t *parent = k > 0 ? entries[entries[k].parent].node : NULL;
+        btree_node_t *moved = btree_layout_move(tree, arena, entries[k].node,
+                                                parent, entries[k].index);
+        if (!moved) {
+            result = BTREE_ERROR_MEMORY_ALLOCATION;
+            break;
+        }
+        entries[k].node = moved;
+    }
+
+    if (result == BTREE_SUCCESS && (tree->flags & BTREE_FLAG_SHARED)) {
+        btree_node_t *prev = NULL;
+        for (size_t k = 0; k < count; k++) {
+            btree_node_t *leaf = entries[k].node;
+            if (!leaf->is_leaf) continue;
+            leaf->prev_leaf = prev;
+            leaf->next_leaf = NULL;
+            if (prev) prev->next_leaf = leaf;
+            prev = leaf;
+        }
+        tree->flags &= ~(uint32_t)BTREE_FLAG_SHARED;
+    }
+
+    if (arena) btree_arena_release(tree, arena);
+    tree->allocator->free(entries);
+    return result;
+}
+
+/**
+ * @brief 노드 재배치 (채움 비율은 그대로)
+ */
+btree_result_t btree_optimize_layout(btree_t *tree, btree_layout_order_t order) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree) || (order != BTREE_LAYOUT_BFS && order != BTREE_LAYOUT_VEB)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_writer_begin(tree);
+    btree_result_t result = btree_layout_apply(tree, order);
+    btree_writer_end(tree);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/* 커서 키 소멸 */
+static void btree_layout_drop_cursor(btree_t *tree, btree_layout_state_t *state) {
+    if (state->has_cursor && tree->key_type.destroy) {
+        tree->key_type.destroy(state->cursor, 1);
+    }
+    state->has_cursor = false;
+}
+
+/**
+ * @brief 점진 재배치 상태 해제
+ */
+void btree_layout_release(btree_t *tree) {
+    btree_layout_state_t *state = tree->layout;
+    if (!state) return;
+
+    btree_layout_drop_cursor(tree, state);
+    if (state->arena) btree_arena_release(tree, state->arena);
+    tree->allocator->free(state->cursor);
+    tree->allocator->free(state);
+    tree->layout = NULL;
+}
+
+/* 루트 레벨부터 시작하는 상태 생성 */
+static btree_layout_state_t* btree_layout_start(btree_t *tree) {
+    btree_layout_state_t *state = tree->allocator->alloc(sizeof(btree_layout_state_t));
+    if (!state) return NULL;
+
+    state->cursor = tree->allocator->alloc(tree->key_type.key_size);
+    if (!state->cursor) {
+        tree->allocator->free(state);
+        return NULL;
+    }
+    state->arena = NULL;
+    state->level = btree_layout_height(tree->root) - 1;
+    state->level_nodes = 1;
+    state->next_nodes = 0;
+    state->has_cursor = false;
+    tree->layout = state;
+    return state;
+}
+
+/* nodes[from]에서 처리할 깊이까지 내려감 (key가 있으면 그 키를 담을 노드, 없으면 맨 왼쪽) */
+static void btree_layout_descend(const btree_t *tree, btree_layout_walk_t *walk, int from,
+                                 const void *key) {
+    for (int d = from; d < walk->depth; d++) {
+        btree_node_t *node = walk->nodes[d];
+        int i = key ? btree_descend_index(btree_node_search(tree, node, key)) : 0;
+        walk->index[d] = i;
+        walk->nodes[d + 1] = node->children[i];
+    }
+}
+
+/* 같은 레벨의 다음 노드로 이동 (레벨 끝이면 false) */
+static bool btree_layout_advance(const btree_t *tree, btree_layout_walk_t *walk) {
+    for (int d = walk->depth - 1; d >= 0; d--) {
+        btree_node_t *node = walk->nodes[d];
+        if (walk->index[d] < node->num_keys) {
+            walk->index[d]++;
+            walk->nodes[d + 1] = node->children[walk->index[d]];
+            btree_layout_descend(tree, walk, d + 1, NULL);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* 자식 index와 오른쪽 형제를 합쳐도 채움 목표 이하이고 부모가 최소 키 수를 지키는지 */
+static bool btree_layout_can_merge(const btree_t *tree, const btree_node_t *parent, int index) {
+    if (index >= parent->num_keys) return false;
+
+    int floor = parent == tree->root ? 1 : btree_node_min_keys(parent);
+    if (parent->num_keys <= floor) return false;
+
+    const btree_node_t *left = parent->children[index];
+    const btree_node_t *right = parent->children[index + 1];
+    if (btree_node_is_shared(parent) || btree_node_is_shared(left) ||
+        btree_node_is_shared(right)) {
+        return false;
+    }
+
+    int separator = (left->is_leaf && btree_is_plus(tree)) ? 0 : 1;
+    int target = (int)(tree->fill_factor * (double)left->capacity + 0.5);
+    return left->num_keys + right->num_keys + separator <= target;
+}
+
+/* 현재 노드 처리: 오른쪽 형제를 합친 뒤 이 레벨의 아레나로 옮김 */
+static btree_result_t btree_layout_visit(btree_t *tree, btree_layout_state_t *state,
+                                         btree_layout_walk_t *walk, size_t *budget) {
+    int d = walk->depth;
+    btree_node_t *parent = d > 0 ? walk->nodes[d - 1] : NULL;
+    int index = d > 0 ? walk->index[d - 1] : 0;
+
+    while (parent && *budget > 1 && btree_layout_can_merge(tree, parent, index)) {
+        btree_merge_children(tree, parent, index);
+        (*budget)--;
+    }
+
+    btree_node_t *node = walk->nodes[d];
+    if (!node->in_arena || node->block != state->arena) {
+        node = btree_layout_move(tree, state->arena, node, parent, index);
+        if (!node) return BTREE_ERROR_MEMORY_ALLOCATION;
+        walk->nodes[d] = node;
+    }
+    if (!node->is_leaf) {
+        state->next_nodes += (size_t)node->num_keys + 1;
+    }
+    (*budget)--;
+    return BTREE_SUCCESS;
+}
+
+/* 커서를 node의 첫 키로 설정 */
+static void btree_layout_set_cursor(btree_t *tree, btree_layout_state_t *state,
+                                    const btree_node_t *node) {
+    btree_layout_drop_cursor(tree, state);
+    if (node->num_keys == 0) return;
+
+    if (tree->key_type.copy) {
+        tree->key_type.copy(state->cursor, node->keys, 1);
+    } else {
+        memcpy(state->cursor, node->keys, tree->key_type.key_size);
+    }
+    state->has_cursor = true;
+}
+
+/* 쓰기 구간 안에서 최대 budget개 노드 처리 */
+static btree_result_t btree_layout_step(btree_t *tree, size_t budget, bool *done) {
+    if (!tree->root) {
+        btree_layout_release(tree);
+        *done = true;
+        return BTREE_SUCCESS;
+    }
+
+    btree_layout_state_t *state = tree->layout;
+    if (!state) {
+        state = btree_layout_start(tree);
+        if (!state) return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    while (budget > 0) {
+        /* 단계 사이에 높이가 줄었으면 남은 가장 높은 레벨부터 */
+        int height = btree_layout_height(tree->root);
+        if (state->level >= height) {
+            state->level = height - 1;
+        }
+        bool is_leaf = state->level == 0;
+
+        if (!state->arena) {
+            state->arena = btree_arena_create(tree, state->level_nodes *
+                                                    btree_layout_block_size(tree, is_leaf));
+            if (btree_arena_missing(tree, state->arena)) return BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+
+        btree_layout_walk_t walk;
+        walk.depth = height - 1 - state->level;
+        walk.nodes[0] = tree->root;
+        btree_layout_descend(tree, &walk, 0, state->has_cursor ? state->cursor : NULL);
+
+        bool more;
+        do {
+            btree_result_t result = btree_layout_visit(tree, state, &walk, &budget);
+            if (result != BTREE_SUCCESS) return result;
+            more = btree_layout_advance(tree, &walk);
+        } while (more && budget > 0);
+
+        if (more) {
+            btree_layout_set_cursor(tree, state, walk.nodes[walk.depth]);
+            return BTREE_SUCCESS;
+        }
+
+        /* 레벨 끝: 아레나를 닫고 아래 레벨로 */
+        btree_layout_drop_cursor(tree, state);
+        if (state->arena) {
+            btree_arena_release(tree, state->arena);
+            state->arena = NULL;
+        }
+        if (is_leaf) {
+            btree_layout_release(tree);
+            *done = true;
+            return BTREE_SUCCESS;
+        }
+        state->level--;
+        state->level_nodes = state->next_nodes;
+        state->next_nodes = 0;
+    }
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 점진 재배치 한 단계 (최대 max_nodes개 노드)
+ */
+btree_result_t btree_compact_step(btree_t *tree, size_t max_nodes, bool *done) {
+    if (!tree || !done) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    *done = false;
+    btree_writer_begin(tree);
+    btree_result_t result = btree_layout_step(tree, max_nodes, done);
+    btree_writer_end(tree);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 트리 압축 (삭제 표시된 키 제거 후 한 바퀴 재배치)
+ */
+btree_result_t btree_compact(btree_t *tree) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_purge_tombstones(tree);
+    if (tree->dead_count > 0) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    /* 진행 중이던 단계는 버리고 처음부터 끝까지 */
+    btree_writer_begin(tree);
+    btree_layout_release(tree);
+    btree_writer_end(tree);
+
+    bool done = false;
+    return btree_compact_step(tree, SIZE_MAX, &done);
+}
@@ -8,28 +8,70 @@
 #include <string.h>
 #include <assert.h>
 
-/* C99 호환성을 위해 atomic 연산을 간단한 연산으로 대체 */
-#define atomic_size_t size_t
-#define atomic_flag int
-#define atomic_fetch_add(ptr, val) (*(ptr) += (val))
-#define atomic_fetch_sub(ptr, val) (*(ptr) -= (val))
+#ifdef BTREE_COMPRESSION_SUPPORT
+#include <lz4.h>
+#endif
+
+/* 원자 연산 (C99에서도 쓸 수 있도록 GCC/Clang 내장 함수 사용) */
+#if defined(__GNUC__) || defined(__clang__)
+#define BTREE_MEMORY_ATOMICS 1
+#define atomic_fetch_add(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_RELAXED)
+#define atomic_fetch_sub(ptr, val) __atomic_fetch_sub((ptr), (val), __ATOMIC_RELAXED)
+#define atomic_load(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define atomic_load_relaxed(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define atomic_store(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define atomic_store_relaxed(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+#define atomic_compare_exchange_weak(ptr, expected, desired) \
+    __atomic_compare_exchange_n((ptr), (expected), (desired), true, \
+                                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#define atomic_compare_exchange_strong(ptr, expected, desired) \
+    __atomic_compare_exchange_n((ptr), (expected), (desired), false, \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define atomic_flag_test_and_set(ptr) __atomic_exchange_n((ptr), 1, __ATOMIC_ACQUIRE)
+#define atomic_flag_clear(ptr) __atomic_store_n((ptr), 0, __ATOMIC_RELEASE)
+#if defined(__x86_64__) || defined(__i386__)
+#define btree_cpu_relax() __builtin_ia32_pause()
+#else
+#define btree_cpu_relax() ((void)0)
+#endif
+#else
+/* 내장 원자 연산이 없는 컴파일러: 단일 스레드 전용 */
+#define atomic_fetch_add(ptr, val) ((*(ptr) += (val)) - (val))
+#define atomic_fetch_sub(ptr, val) ((*(ptr) -= (val)) + (val))
 #define atomic_load(ptr) (*(ptr))
+#define atomic_load_relaxed(ptr) (*(ptr))
 #define atomic_store(ptr, val) (*(ptr) = (val))
+#define atomic_store_relaxed(ptr, val) (*(ptr) = (val))
 #define atomic_compare_exchange_weak(ptr, expected, desired) \
     (*(ptr) == *(expected) ? (*(ptr) = (desired), 1) : (*(expected) = *(ptr), 0))
+#define atomic_compare_exchange_strong(ptr, expected, desired) \
+    atomic_compare_exchange_weak(ptr, expected, desired)
 #define atomic_flag_test_and_set(ptr) (*(ptr) ? 1 : (*(ptr) = 1, 0))
 #define atomic_flag_clear(ptr) (*(ptr) = 0)
+#define btree_cpu_relax() ((void)0)
+#endif
 
-#ifdef BTREE_PLATFORM_WINDOWS
+#if defined(BTREE_PLATFORM_WINDOWS) || defined(_WIN32)
 #include <windows.h>
-#ifdef _MSC_VER
 #include <malloc.h>
 #endif
-#endif
 
-#ifdef BTREE_PLATFORM_LINUX
+#if defined(BTREE_PLATFORM_LINUX) || defined(__linux__) || defined(__unix__) || defined(__APPLE__)
 #include <sys/mman.h>
 #include <unistd.h>
+#define BTREE_HAS_MMAP 1
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+#ifdef __APPLE__
+#include <mach/vm_statistics.h>
+#endif
+
+#ifdef BTREE_NUMA_SUPPORT
+#include <numa.h>
+#include <sched.h>
 #endif
 
 /* 메모리 블록 헤더 (할당 크기 추적용) */
@@ -41,14 +83,69 @@ typedef struct memory_header {
 #define MEMORY_MAGIC 0xDEADBEEF
 #define HEADER_SIZE sizeof(memory_header_t)
 
-/* 전역 메모리 통계 */
-static struct {
-    atomic_size_t total_allocated;
-    atomic_size_t total_freed;
-    atomic_size_t peak_usage;
-    atomic_size_t current_usage;
-    atomic_flag lock;
-} g_memory_stats = {0};
+/* 전역 메모리 통계 (스레드 슬롯별 샤드, 읽을 때 합산)
+ * 샤드 사용량은 다른 스레드가 해제한 만큼 음수가 될 수 있으므로 부호 있는
+ * 정수로 두고, 합계만 의미를 가진다. */
+#define BTREE_MEMORY_STAT_SHARDS 16
+#define BTREE_MEMORY_PEAK_GRANULE 4096  /* 샤드가 이만큼 늘 때마다 최대값 갱신 */
+
+typedef struct {
+    size_t total_allocated;
+    size_t total_freed;
+    ptrdiff_t current_usage;
+    ptrdiff_t high_mark;                /* 다음 최대값 갱신을 시도할 샤드 사용량 */
+    char padding[BTREE_CACHE_LINE_SIZE];
+} btree_memory_shard_t;
+
+static btree_memory_shard_t g_memory_shards[BTREE_MEMORY_STAT_SHARDS];
+static atomic_size_t g_memory_peak;
+
+/**
+ * @brief 현재 스레드의 슬롯 번호 (처음 호출될 때 순서대로 배정)
+ */
+static unsigned btree_memory_thread_slot(void) {
+    static BTREE_THREAD_LOCAL unsigned slot;   /* 0: 미배정, 그 외 번호 + 1 */
+    static unsigned next_slot;
+
+    if (BTREE_UNLIKELY(slot == 0)) {
+        slot = atomic_fetch_add(&next_slot, 1u) + 1;
+    }
+    return slot - 1;
+}
+
+/* 샤드 합산 */
+static size_t btree_memory_sum_usage(void) {
+    ptrdiff_t usage = 0;
+    for (int i = 0; i < BTREE_MEMORY_STAT_SHARDS; i++) {
+        usage += atomic_load_relaxed(&g_memory_shards[i].current_usage);
+    }
+    return usage > 0 ? (size_t)usage : 0;
+}
+
+/**
+ * @brief 할당/해제 크기를 현재 스레드 샤드에 반영
+ *
+ * 최대 사용량은 샤드 사용량이 high_mark를 넘을 때만 전체를 합산해 갱신하므로
+ * 샤드당 BTREE_MEMORY_PEAK_GRANULE 이내의 오차가 있다.
+ */
+static void btree_memory_account(size_t allocated, size_t freed) {
+    btree_memory_shard_t *shard =
+        &g_memory_shards[btree_memory_thread_slot() % BTREE_MEMORY_STAT_SHARDS];
+
+    if (allocated) atomic_fetch_add(&shard->total_allocated, allocated);
+    if (freed) atomic_fetch_add(&shard->total_freed, freed);
+    ptrdiff_t delta = (ptrdiff_t)allocated - (ptrdiff_t)freed;
+    ptrdiff_t current = atomic_fetch_add(&shard->current_usage, delta) + delta;
+
+    if (BTREE_LIKELY(current <= atomic_load_relaxed(&shard->high_mark))) return;
+    atomic_store_relaxed(&shard->high_mark, current + BTREE_MEMORY_PEAK_GRANULE);
+
+    size_t usage = btree_memory_sum_usage();
+    size_t peak = atomic_load_relaxed(&g_memory_peak);
+    while (usage > peak && !atomic_compare_exchange_weak(&g_memory_peak, &peak, usage)) {
+        /* 다른 스레드가 먼저 갱신, 다시 비교 */
+    }
+}
 
 /* 기본 할당자 구현 - 크기 추적 개선 */
 static void* default_alloc(size_t size) {
@@ -63,12 +160,7 @@ static void* default_alloc(size_t size) {
     header->magic = MEMORY_MAGIC;
     
     /* 통계 업데이트 */
-    g_memory_stats.current_usage += size;
-    g_memory_stats.total_allocated += size;
-    
-    if (g_memory_stats.current_usage > g_memory_stats.peak_usage) {
-        g_memory_stats.peak_usage = g_memory_stats.current_usage;
-    }
+    btree_memory_account(size, 0);
     
     /* 실제 데이터 영역 포인터 반환 */
     return (char*)header + HEADER_SIZE;
@@ -88,11 +180,7 @@ static void default_free(void *ptr) {
     }
     
     /* 통계 업데이트 */
-    size_t size = header->size;
-    g_memory_stats.total_freed += size;
-    if (g_memory_stats.current_usage >= size) {
-        g_memory_stats.current_usage -= size;
-    }
+    btree_memory_account(0, header->size);
     
     /* 메모리 해제 */
     free(header);
@@ -126,13 +214,7 @@ static void* default_realloc(void *ptr, size_t new_size) {
     new_header->magic = MEMORY_MAGIC;
     
     /* 통계 업데이트 */
-    g_memory_stats.total_allocated += new_size;
-    g_memory_stats.total_freed += old_size;
-    g_memory_stats.current_usage = g_memory_stats.current_usage - old_size + new_size;
-    
-    if (g_memory_stats.current_usage > g_memory_stats.peak_usage) {
-        g_memory_stats.peak_usage = g_memory_stats.current_usage;
-    }
+    btree_memory_account(new_size, old_size);
     
     return (char*)new_header + HEADER_SIZE;
 }
@@ -153,52 +235,437 @@ btree_allocator_t* btree_default_allocator(void) {
     return &g_default_allocator;
 }
 
+/* 스핀락 획득/해제 */
+static void btree_spin_lock(atomic_flag *lock) {
+    while (atomic_flag_test_and_set(lock)) {
+        while (atomic_load_relaxed(lock)) {
+            btree_cpu_relax();
+        }
+    }
+}
+
+static void btree_spin_unlock(atomic_flag *lock) {
+    atomic_flag_clear(lock);
+}
+
+/* 락을 쥔 쪽만 쓰는 카운터 증가 (읽는 쪽은 잠그지 않고 합산) */
+#define btree_owned_counter_inc(ptr) atomic_store_relaxed((ptr), atomic_load_relaxed(ptr) + 1)
+
+/* 자유 블록 첫 워드에 저장하는 링크 */
+#define btree_pool_block_next(block) (*(void**)(block))
+
+/*
+ * 슬랩 페이지 맵
+ *
+ * 매니저 슬랩은 자기 크기(2의 거듭제곱, 1MB 이상)로 정렬해 할당하므로
+ * 1MB 단위 페이지마다 소유 풀이 하나뿐이다. 주소 상위 비트로 2단계 표를
+ * 찾아 해제할 포인터의 소유 풀을 O(1)에 구한다. 잎 표는 처음 쓰일 때
+ * 만들고 프로세스가 끝날 때까지 유지한다.
+ */
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define BTREE_ADDRESS_BITS 48
+#else
+#define BTREE_ADDRESS_BITS 32
+#endif
+#define BTREE_SLAB_MAP_BITS  (BTREE_ADDRESS_BITS - BTREE_SLAB_SHIFT)
+#define BTREE_SLAB_LEAF_BITS (BTREE_SLAB_MAP_BITS / 2)
+#define BTREE_SLAB_TOP_SIZE  ((size_t)1 << (BTREE_SLAB_MAP_BITS - BTREE_SLAB_LEAF_BITS))
+#define BTREE_SLAB_LEAF_SIZE ((size_t)1 << BTREE_SLAB_LEAF_BITS)
+#define BTREE_SLAB_SIZE      ((size_t)1 << BTREE_SLAB_SHIFT)
+
+static btree_memory_pool_t **g_slab_map[BTREE_SLAB_TOP_SIZE];
+
+/* 페이지 번호의 맵 항목 (create가 false면 잎 표가 없을 때 NULL) */
+static btree_memory_pool_t** btree_slab_map_entry(uintptr_t page, bool create) {
+    uintptr_t top = page >> BTREE_SLAB_LEAF_BITS;
+    if (top >= BTREE_SLAB_TOP_SIZE) return NULL;
+
+    btree_memory_pool_t **leaf = atomic_load(&g_slab_map[top]);
+    if (!leaf && create) {
+        btree_memory_pool_t **fresh = calloc(BTREE_SLAB_LEAF_SIZE, sizeof(*fresh));
+        if (!fresh) return NULL;
+        btree_memory_pool_t **expected = NULL;
+        if (atomic_compare_exchange_strong(&g_slab_map[top], &expected, fresh)) {
+            leaf = fresh;
+        } else {
+            free(fresh);
+            leaf = expected;
+        }
+    }
+    return leaf ? &leaf[page & (BTREE_SLAB_LEAF_SIZE - 1)] : NULL;
+}
+
+/* 슬랩이 덮는 모든 페이지에 소유 풀 기록 (owner가 NULL이면 해제) */
+static bool btree_slab_map_set(const btree_memory_pool_t *slab, btree_memory_pool_t *owner) {
+    uintptr_t first = (uintptr_t)slab->pool_start >> BTREE_SLAB_SHIFT;
+    uintptr_t pages = slab->pool_size >> BTREE_SLAB_SHIFT;
+
+    for (uintptr_t page = first; page < first + pages; page++) {
+        btree_memory_pool_t **entry = btree_slab_map_entry(page, owner != NULL);
+        if (!entry) return false;
+        atomic_store(entry, owner);
+    }
+    return true;
+}
+
 /**
- * @brief 메모리 풀 생성
+ * @brief 포인터가 속한 슬랩 풀 검색 (페이지 맵, O(1))
  */
-btree_memory_pool_t* btree_pool_create(size_t block_size, size_t pool_size, uint32_t flags) {
-    if (block_size == 0 || pool_size < BTREE_MIN_POOL_SIZE || pool_size > BTREE_MAX_POOL_SIZE) {
-        return NULL;
+btree_memory_pool_t* btree_memory_find_pool(const void *ptr) {
+    if (!ptr) return NULL;
+
+    btree_memory_pool_t **entry = btree_slab_map_entry((uintptr_t)ptr >> BTREE_SLAB_SHIFT, false);
+    return entry ? atomic_load(entry) : NULL;
+}
+
+/* 크기로 정렬된 슬랩 메모리 */
+static void* btree_slab_alloc(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, size);
+#else
+    void *ptr = NULL;
+    return posix_memalign(&ptr, size, size) == 0 ? ptr : NULL;
+#endif
+}
+
+static void btree_slab_free(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/*
+ * 페이지 매핑 영역
+ *
+ * 슬랩, 아레나 청크, 큰 페이지나 보호 페이지를 요청한 풀은 OS에서 페이지를
+ * 직접 매핑한다. 정렬이 매핑 단위보다 크면 정렬만큼 더 예약한 뒤 앞뒤를
+ * 돌려준다. 큰 페이지는 2MB 배수 영역에만 요청하며, 예약된 큰 페이지
+ * (MAP_HUGETLB, macOS 슈퍼페이지, Windows MEM_LARGE_PAGES)를 먼저 시도하고
+ * 안 되면 보통 페이지에 THP 알림(MADV_HUGEPAGE)을 준다. 보호 페이지는 영역
+ * 앞뒤에 한 단위씩 접근 불가로 둔다.
+ */
+#define BTREE_REGION_HUGE  0x01
+#define BTREE_REGION_GUARD 0x02
+
+static bool g_memory_debug = false;
+
+/**
+ * @brief 디버그 모드 (이후 만드는 영역에 보호 페이지)
+ */
+void btree_memory_set_debug_mode(bool enable) {
+    atomic_store(&g_memory_debug, enable);
+}
+
+/* 페이지 크기 */
+static size_t btree_os_page_size(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#elif defined(BTREE_HAS_MMAP)
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t)size : 4096;
+#else
+    return 4096;
+#endif
+}
+
+size_t btree_memory_page_size(void) {
+    return btree_os_page_size();
+}
+
+/* 매핑 단위 (Windows는 예약 주소가 할당 단위 배수여야 함) */
+static size_t btree_region_unit(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return btree_os_page_size();
+#endif
+}
+
+#if defined(BTREE_HAS_MMAP)
+static char* btree_region_reserve(size_t span, int extra_flags, int fd) {
+    void *ptr = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags,
+                     fd, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+/* [p, p + span)에서 앞에 guard를 두고 정렬한 size 바이트만 남김 */
+static char* btree_region_trim(char *p, size_t span, size_t size, size_t alignment, size_t guard) {
+    char *start = (char*)btree_align_size((uintptr_t)p + guard, alignment);
+    size_t head = (size_t)(start - guard - p);
+    char *tail = start + size + guard;
+    if (head) munmap(p, head);
+    if (p + span > tail) munmap(tail, (size_t)(p + span - tail));
+    return start;
+}
+#endif
+
+/**
+ * @brief size 바이트를 alignment에 맞춰 매핑 (*base, *length는 해제할 영역)
+ *
+ * @return 영역 시작 (지원하지 않거나 실패하면 NULL)
+ */
+static void* btree_region_map(size_t size, size_t alignment, uint32_t options,
+                              void **base, size_t *length) {
+    size_t unit = btree_region_unit();
+    size_t guard = (options & BTREE_REGION_GUARD) ? unit : 0;
+    bool huge = (options & BTREE_REGION_HUGE) && size % BTREE_HUGE_PAGE_SIZE == 0;
+    
+    size = btree_align_size(size, unit);
+    if (alignment < unit) alignment = unit;
+    if (huge && alignment < BTREE_HUGE_PAGE_SIZE) alignment = BTREE_HUGE_PAGE_SIZE;
+    size_t slack = alignment > unit ? alignment : 0;
+    
+#if defined(BTREE_HAS_MMAP)
+    char *p = NULL;
+    if (huge && !guard) {
+#if defined(MAP_HUGETLB)
+        size_t span = size + (alignment > BTREE_HUGE_PAGE_SIZE ? alignment : 0);
+        p = btree_region_reserve(span, MAP_HUGETLB, -1);
+        if (p) p = btree_region_trim(p, span, size, alignment, 0);
+#elif defined(VM_FLAGS_SUPERPAGE_SIZE_2MB)
+        if (alignment == BTREE_HUGE_PAGE_SIZE) {
+            p = btree_region_reserve(size, 0, VM_FLAGS_SUPERPAGE_SIZE_2MB);
+        }
+#endif
+        if (p) {
+            *base = p;
+            *length = size;
+            return p;
+        }
     }
     
-    /* 블록 크기와 풀 크기를 정렬 */
-    block_size = btree_align_size(block_size, BTREE_POOL_ALIGNMENT);
-    pool_size = btree_align_size(pool_size, BTREE_CACHE_LINE_SIZE);
+    size_t span = size + slack + 2 * guard;
+    p = btree_region_reserve(span, 0, -1);
+    if (!p) return NULL;
+    char *start = btree_region_trim(p, span, size, alignment, guard);
+    if (guard) {
+        mprotect(start - guard, guard, PROT_NONE);
+        mprotect(start + size, guard, PROT_NONE);
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge) madvise(start, size, MADV_HUGEPAGE);
+#endif
+    *base = start - guard;
+    *length = size + 2 * guard;
+    return start;
+#elif defined(_WIN32)
+    if (huge && !guard) {
+        SIZE_T large = GetLargePageMinimum();
+        if (large && size % large == 0 && alignment <= large) {
+            void *p = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                   PAGE_READWRITE);
+            if (p) {
+                *base = p;
+                *length = size;
+                return p;
+            }
+        }
+    }
     
-    /* 풀 구조체 할당 */
+    /* 넉넉히 예약해 정렬된 주소를 찾고 놓은 뒤 그 자리에 다시 예약
+     * (그사이 다른 스레드가 가져가면 다시 시도) */
+    for (int attempt = 0; attempt < 8; attempt++) {
+        char *p = VirtualAlloc(NULL, size + slack + 2 * guard, MEM_RESERVE, PAGE_NOACCESS);
+        if (!p) return NULL;
+        char *start = (char*)btree_align_size((uintptr_t)p + guard, alignment);
+        VirtualFree(p, 0, MEM_RELEASE);
+        
+        char *q = VirtualAlloc(start - guard, size + 2 * guard, MEM_RESERVE | MEM_COMMIT,
+                               PAGE_READWRITE);
+        if (!q) continue;
+        if (guard) {
+            DWORD old;
+            VirtualProtect(start - guard, guard, PAGE_NOACCESS, &old);
+            VirtualProtect(start + size, guard, PAGE_NOACCESS, &old);
+        }
+        *base = q;
+        *length = size + 2 * guard;
+        return start;
+    }
+    return NULL;
+#else
+    (void)slack;
+    (void)guard;
+    (void)huge;
+    (void)base;
+    (void)length;
+    return NULL;
+#endif
+}
+
+static void btree_region_unmap(void *base, size_t length) {
+#if defined(BTREE_HAS_MMAP)
+    munmap(base, length);
+#elif defined(_WIN32)
+    (void)length;
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    (void)base;
+    (void)length;
+#endif
+}
+
+/* 풀 플래그와 디버그 모드에 맞는 매핑 옵션 */
+static uint32_t btree_region_options(uint32_t pool_flags) {
+    uint32_t options = 0;
+    if (pool_flags & BTREE_POOL_FLAG_HUGE_PAGES) options |= BTREE_REGION_HUGE;
+    if ((pool_flags & BTREE_POOL_FLAG_DEBUG_MODE) || atomic_load(&g_memory_debug)) {
+        options |= BTREE_REGION_GUARD;
+    }
+    return options;
+}
+
+/**
+ * @brief 캐시 라인 정렬 할당
+ */
+void* btree_cache_aligned_alloc(size_t size) {
+    size_t aligned_size = btree_align_size(size ? size : 1, BTREE_CACHE_LINE_SIZE);
+#ifdef _WIN32
+    return _aligned_malloc(aligned_size, BTREE_CACHE_LINE_SIZE);
+#else
+    void *ptr = NULL;
+    return posix_memalign(&ptr, BTREE_CACHE_LINE_SIZE, aligned_size) == 0 ? ptr : NULL;
+#endif
+}
+
+void btree_cache_aligned_free(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/**
+ * @brief 페이지 접근 권한 변경
+ */
+bool btree_memory_protect(void *ptr, size_t size, int protection) {
+    if (!ptr || size == 0 || (uintptr_t)ptr % btree_os_page_size() != 0) return false;
+    size = btree_align_size(size, btree_os_page_size());
+    
+#if defined(BTREE_HAS_MMAP)
+    int prot = PROT_NONE;
+    if (protection & BTREE_PROTECT_READ) prot |= PROT_READ;
+    if (protection & BTREE_PROTECT_WRITE) prot |= PROT_READ | PROT_WRITE;
+    return mprotect(ptr, size, prot) == 0;
+#elif defined(_WIN32)
+    DWORD prot = PAGE_NOACCESS;
+    if (protection & BTREE_PROTECT_WRITE) {
+        prot = PAGE_READWRITE;
+    } else if (protection & BTREE_PROTECT_READ) {
+        prot = PAGE_READONLY;
+    }
+    DWORD old;
+    return VirtualProtect(ptr, size, prot, &old) != 0;
+#else
+    (void)protection;
+    return false;
+#endif
+}
+
+/* 슬랩 영역에 접근 패턴 알림 (매니저 플래그, madvise가 없으면 무시) */
+static void btree_slab_advise(void *start, size_t size, uint32_t manager_flags) {
+#ifdef MADV_RANDOM
+    if (manager_flags & BTREE_MANAGER_FLAG_RANDOM_ACCESS) madvise(start, size, MADV_RANDOM);
+#endif
+    (void)start;
+    (void)size;
+    (void)manager_flags;
+}
+
+/* 슬랩 영역을 NUMA 노드 메모리에 묶음 (첫 접근 전에 호출, node < 0이면 무시) */
+static void btree_slab_bind(void *start, size_t size, int node) {
+#ifdef BTREE_NUMA_SUPPORT
+    if (node >= 0 && numa_available() >= 0) numa_tonode_memory(start, size, node);
+#endif
+    (void)start;
+    (void)size;
+    (void)node;
+}
+
+/**
+ * @brief 블록 사슬 [first..last]를 반환 스택에 한 번에 올림 (lock-free)
+ *
+ * 꺼낼 때는 스택 전체를 한 번에 가져가므로 ABA 문제가 생기지 않는다.
+ */
+static void btree_pool_push_remote(btree_memory_pool_t *pool, void *first, void *last) {
+#ifdef BTREE_MEMORY_ATOMICS
+    void *head = atomic_load_relaxed(&pool->remote_free);
+    do {
+        btree_pool_block_next(last) = head;
+    } while (!atomic_compare_exchange_weak(&pool->remote_free, &head, first));
+#else
+    btree_pool_block_next(last) = pool->remote_free;
+    pool->remote_free = first;
+#endif
+}
+
+/**
+ * @brief 중앙 리스트에서 블록 하나 꺼냄 (pool->lock 보유 상태 또는 단일 스레드 풀)
+ *
+ * 반환된 블록, 반환 스택 (비었을 때 통째로 가져옴), 아직 쓰지 않은 영역
+ * 순서로 찾는다. 풀을 만들 때는 블록 목록을 미리 채우지 않는다.
+ */
+static void* btree_pool_take_central(btree_memory_pool_t *pool) {
+    void *block = pool->free_list;
+    if (!block) {
+#ifdef BTREE_MEMORY_ATOMICS
+        block = __atomic_exchange_n(&pool->remote_free, NULL, __ATOMIC_ACQUIRE);
+#else
+        block = pool->remote_free;
+        pool->remote_free = NULL;
+#endif
+    }
+    if (block) {
+        pool->free_list = btree_pool_block_next(block);
+        return block;
+    }
+
+    char *end = (char*)pool->pool_start + pool->total_blocks * pool->block_size;
+    if ((char*)pool->next_free < end) {
+        block = pool->next_free;
+        pool->next_free = (char*)block + pool->block_size;
+    }
+    return block;
+}
+
+/* 모든 매거진 카운터 합산으로 사용 중인 블록 수 계산 */
+static size_t btree_pool_used_blocks(btree_memory_pool_t *pool,
+                                     size_t *allocs, size_t *frees) {
+    size_t a = 0, f = 0;
+    for (int i = 0; i < BTREE_POOL_MAGAZINES; i++) {
+        a += atomic_load_relaxed(&pool->magazines[i].alloc_count);
+        f += atomic_load_relaxed(&pool->magazines[i].free_count);
+    }
+    if (allocs) *allocs = a;
+    if (frees) *frees = f;
+
+    size_t released = f + atomic_load_relaxed(&pool->reset_blocks);
+    return a > released ? a - released : 0;
+}
+
+/* 풀 구조체 초기화 (영역은 호출자가 할당) */
+static btree_memory_pool_t* btree_pool_init(void *start, size_t block_size,
+                                            size_t pool_size, uint32_t flags) {
     btree_memory_pool_t *pool = malloc(sizeof(btree_memory_pool_t));
     if (!pool) return NULL;
     
     memset(pool, 0, sizeof(btree_memory_pool_t));
     
-    /* 풀 메모리 할당 */
-    pool->pool_start = btree_cache_aligned_alloc(pool_size);
-    if (!pool->pool_start) {
-        free(pool);
-        return NULL;
-    }
-    
     /* 풀 기본 정보 설정 */
+    pool->pool_start = start;
     pool->pool_size = pool_size;
     pool->block_size = block_size;
     pool->total_blocks = pool_size / block_size;
     pool->alignment = BTREE_POOL_ALIGNMENT;
     pool->flags = flags;
-    
-    /* 자유 블록 리스트 초기화 */
-    pool->free_list = malloc(pool->total_blocks * sizeof(void*));
-    if (!pool->free_list) {
-        btree_cache_aligned_free(pool->pool_start);
-        free(pool);
-        return NULL;
-    }
-    
-    /* 모든 블록을 자유 리스트에 추가 */
-    for (size_t i = 0; i < pool->total_blocks; i++) {
-        pool->free_list[i] = (char*)pool->pool_start + (i * block_size);
-    }
-    pool->free_count = pool->total_blocks;
-    pool->next_free = pool->pool_start;
+    pool->next_free = start;
     
     /* 통계 초기화 */
     pool->stats.total_size = pool_size;
@@ -214,66 +681,191 @@ btree_memory_pool_t* btree_pool_create(size_t block_size, size_t pool_size, uint
 }
 
 /**
- * @brief 메모리 풀 소멸
+ * @brief 메모리 풀 생성
+ */
+btree_memory_pool_t* btree_pool_create(size_t block_size, size_t pool_size, uint32_t flags) {
+    if (block_size == 0 || pool_size < BTREE_MIN_POOL_SIZE || pool_size > BTREE_MAX_POOL_SIZE) {
+        return NULL;
+    }
+    
+    /* 블록 크기와 풀 크기를 정렬 (블록은 자유 리스트 링크를 담을 수 있음) */
+    block_size = btree_align_size(block_size, BTREE_POOL_ALIGNMENT);
+    pool_size = btree_align_size(pool_size, BTREE_CACHE_LINE_SIZE);
+    
+    /* 풀 메모리 할당 (큰 페이지나 보호 페이지는 직접 매핑) */
+    uint32_t options = btree_region_options(flags);
+    void *base = NULL;
+    size_t length = 0;
+    void *start = options ? btree_region_map(pool_size, BTREE_CACHE_LINE_SIZE, options,
+                                             &base, &length) : NULL;
+    if (!start) start = btree_cache_aligned_alloc(pool_size);
+    if (!start) return NULL;
+    
+    btree_memory_pool_t *pool = btree_pool_init(start, block_size, pool_size,
+                                                flags & ~(uint32_t)BTREE_POOL_FLAG_SLAB);
+    if (!pool) {
+        if (base) {
+            btree_region_unmap(base, length);
+        } else {
+            btree_cache_aligned_free(start);
+        }
+        return NULL;
+    }
+    pool->map_base = base;
+    pool->map_size = length;
+    return pool;
+}
+
+/**
+ * @brief 크기 정렬 슬랩 생성 및 페이지 맵 등록
+ *
+ * @param slab_size 2의 거듭제곱, BTREE_SLAB_SIZE 이상
+ * @param flags 추가 풀 플래그 (SLAB은 항상 켬)
+ */
+static btree_memory_pool_t* btree_slab_create(size_t block_size, size_t slab_size, uint32_t flags) {
+    void *base = NULL;
+    size_t length = 0;
+    void *start = btree_region_map(slab_size, slab_size, btree_region_options(flags), &base, &length);
+    if (!start) start = btree_slab_alloc(slab_size);
+    if (!start) return NULL;
+    
+    btree_memory_pool_t *pool = btree_pool_init(start, block_size, slab_size,
+                                                flags | BTREE_POOL_FLAG_SLAB);
+    if (!pool) {
+        if (base) {
+            btree_region_unmap(base, length);
+        } else {
+            btree_slab_free(start);
+        }
+        return NULL;
+    }
+    pool->map_base = base;
+    pool->map_size = length;
+    if (!btree_slab_map_set(pool, pool)) {
+        btree_slab_map_set(pool, NULL);
+        btree_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+/**
+ * @brief 메모리 풀 소멸 (다른 스레드가 더 이상 풀을 쓰지 않아야 함)
  */
 void btree_pool_destroy(btree_memory_pool_t *pool) {
     if (!pool) return;
     
-    /* 스핀락 획득 */
-    while (atomic_flag_test_and_set(&pool->lock)) {
-        /* 대기 */
+    /* 메모리 해제 (매거진은 풀 구조체 안에 있으므로 함께 해제됨) */
+    if (pool->flags & BTREE_POOL_FLAG_SLAB) btree_slab_map_set(pool, NULL);
+    if (pool->map_base) {
+        btree_region_unmap(pool->map_base, pool->map_size);
+    } else if (pool->flags & BTREE_POOL_FLAG_SLAB) {
+        btree_slab_free(pool->pool_start);
+    } else if (pool->pool_start) {
+        btree_cache_aligned_free(pool->pool_start);
     }
     
-    /* 메모리 해제 */
-    if (pool->pool_start) {
-        btree_cache_aligned_free(pool->pool_start);
+    free(pool);
+}
+
+/*
+ * 매거진 count는 매거진 락 아래에서만 바꾸지만 btree_pool_steal이 락 없이
+ * 엿보므로 읽기와 쓰기를 모두 원자적으로 한다 (매거진 락 보유 상태에서 호출).
+ */
+#define btree_magazine_count(mag) atomic_load_relaxed(&(mag)->count)
+
+static inline void* btree_magazine_pop(btree_pool_magazine_t *mag) {
+    uint32_t count = btree_magazine_count(mag) - 1;
+    void *ptr = mag->blocks[count];
+    atomic_store_relaxed(&mag->count, count);
+    btree_owned_counter_inc(&mag->alloc_count);
+    return ptr;
+}
+
+/**
+ * @brief 매거진을 중앙 리스트에서 절반까지 채움 (매거진 락 보유 상태)
+ */
+static void btree_pool_refill(btree_memory_pool_t *pool, btree_pool_magazine_t *mag) {
+    btree_spin_lock(&pool->lock);
+    
+    uint32_t take = 0;
+    while (take < BTREE_POOL_MAGAZINE_SIZE / 2) {
+        void *block = btree_pool_take_central(pool);
+        if (!block) break;
+        mag->blocks[take++] = block;
     }
-    if (pool->free_list) {
-        free(pool->free_list);
+    atomic_store_relaxed(&mag->count, take);
+    
+    /* 최대 사용량은 보충 시점마다 갱신 (근사값, 매거진에 남은 블록은 제외) */
+    size_t used = (btree_pool_used_blocks(pool, NULL, NULL) + 1) * pool->block_size;
+    if (take > 0 && used > pool->stats.peak_usage) {
+        pool->stats.peak_usage = used;
     }
     
-    atomic_flag_clear(&pool->lock);
-    free(pool);
+    btree_spin_unlock(&pool->lock);
+}
+
+/**
+ * @brief 중앙 리스트가 바닥났을 때 다른 매거진에 남은 블록을 가져옴
+ */
+static void* btree_pool_steal(btree_memory_pool_t *pool) {
+    void *ptr = NULL;
+    for (int i = 0; i < BTREE_POOL_MAGAZINES && !ptr; i++) {
+        btree_pool_magazine_t *mag = &pool->magazines[i];
+        if (btree_magazine_count(mag) == 0) continue;
+        
+        btree_spin_lock(&mag->lock);
+        if (btree_magazine_count(mag) > 0) {
+            ptr = btree_magazine_pop(mag);
+        }
+        btree_spin_unlock(&mag->lock);
+    }
+    return ptr;
 }
 
 /**
  * @brief 풀에서 메모리 할당
+ *
+ * THREAD_SAFE 풀은 스레드 슬롯의 매거진에서 먼저 꺼내고, 비었을 때만 중앙
+ * 리스트 락을 잡아 절반을 보충한다. 중앙 리스트와 반환 스택이 모두 비면
+ * 다른 매거진의 블록을 가져온다.
  */
 void* btree_pool_alloc(btree_memory_pool_t *pool) {
-    if (!pool || pool->free_count == 0) return NULL;
+    if (!pool) return NULL;
+    
+    void *ptr = NULL;
+    btree_pool_magazine_t *mag = &pool->magazines[0];
     
-    /* 스핀락 획득 */
     if (pool->flags & BTREE_POOL_FLAG_THREAD_SAFE) {
-        while (atomic_flag_test_and_set(&pool->lock)) {
-            /* 스핀 대기 */
+        mag = &pool->magazines[btree_memory_thread_slot() % BTREE_POOL_MAGAZINES];
+        btree_spin_lock(&mag->lock);
+        if (btree_magazine_count(mag) == 0) {
+            btree_pool_refill(pool, mag);
         }
-    }
-    
-    void *ptr = NULL;
-    if (pool->free_count > 0) {
-        /* 자유 리스트에서 블록 가져오기 */
-        ptr = pool->free_list[--pool->free_count];
-        
-        /* 메모리 초기화 */
-        if (pool->flags & BTREE_POOL_FLAG_ZERO_MEMORY) {
-            memset(ptr, 0, pool->block_size);
+        if (btree_magazine_count(mag) > 0) {
+            ptr = btree_magazine_pop(mag);
         }
+        btree_spin_unlock(&mag->lock);
         
-        /* 통계 업데이트 */
-        pool->stats.used_blocks++;
-        pool->stats.free_blocks--;
-        pool->stats.used_size += pool->block_size;
-        pool->stats.free_size -= pool->block_size;
-        pool->stats.allocation_count++;
-        
-        if (pool->stats.used_size > pool->stats.peak_usage) {
-            pool->stats.peak_usage = pool->stats.used_size;
+        if (!ptr) {
+            ptr = btree_pool_steal(pool);
+        }
+    } else {
+        /* 단일 스레드 풀은 중앙 리스트를 직접 사용 */
+        ptr = btree_pool_take_central(pool);
+        if (ptr) {
+            btree_owned_counter_inc(&mag->alloc_count);
+            
+            size_t used = btree_pool_used_blocks(pool, NULL, NULL) * pool->block_size;
+            if (used > pool->stats.peak_usage) {
+                pool->stats.peak_usage = used;
+            }
         }
     }
     
-    /* 스핀락 해제 */
-    if (pool->flags & BTREE_POOL_FLAG_THREAD_SAFE) {
-        atomic_flag_clear(&pool->lock);
+    /* 메모리 초기화 */
+    if (ptr && (pool->flags & BTREE_POOL_FLAG_ZERO_MEMORY)) {
+        memset(ptr, 0, pool->block_size);
     }
     
     return ptr;
@@ -281,36 +873,45 @@ void* btree_pool_alloc(btree_memory_pool_t *pool) {
 
 /**
  * @brief 풀에 메모리 반환
+ *
+ * 어느 스레드에서 해제하든 자기 매거진에 넣고, 매거진이 가득 차면 절반을
+ * 사슬로 묶어 lock-free 반환 스택에 넘긴다. 해제 경로는 중앙 락을 잡지 않는다.
  */
 void btree_pool_free(btree_memory_pool_t *pool, void *ptr) {
     if (!pool || !ptr || !btree_pool_contains(pool, ptr)) return;
     
-    /* 스핀락 획득 */
-    if (pool->flags & BTREE_POOL_FLAG_THREAD_SAFE) {
-        while (atomic_flag_test_and_set(&pool->lock)) {
-            /* 스핀 대기 */
-        }
+    if (!(pool->flags & BTREE_POOL_FLAG_THREAD_SAFE)) {
+        /* 자유 리스트에 블록 반환 */
+        btree_pool_block_next(ptr) = pool->free_list;
+        pool->free_list = ptr;
+        btree_owned_counter_inc(&pool->magazines[0].free_count);
+        return;
     }
     
-    /* 자유 리스트에 블록 반환 */
-    if (pool->free_count < pool->total_blocks) {
-        pool->free_list[pool->free_count++] = ptr;
-        
-        /* 통계 업데이트 */
-        pool->stats.used_blocks--;
-        pool->stats.free_blocks++;
-        pool->stats.used_size -= pool->block_size;
-        pool->stats.free_size += pool->block_size;
-        pool->stats.deallocation_count++;
-        
-        /* 단편화 계산 */
-        pool->stats.fragmentation_ratio = 
-            (double)(pool->stats.total_blocks - pool->stats.free_blocks) / pool->stats.total_blocks;
+    btree_pool_magazine_t *mag =
+        &pool->magazines[btree_memory_thread_slot() % BTREE_POOL_MAGAZINES];
+    void *first = NULL, *last = NULL;
+    
+    btree_spin_lock(&mag->lock);
+    uint32_t count = btree_magazine_count(mag);
+    if (count == BTREE_POOL_MAGAZINE_SIZE) {
+        /* 위쪽 절반을 사슬로 연결 (가장 최근 블록은 캐시에 남김) */
+        uint32_t keep = BTREE_POOL_MAGAZINE_SIZE / 2;
+        first = mag->blocks[keep];
+        last = first;
+        for (uint32_t i = keep + 1; i < count; i++) {
+            btree_pool_block_next(last) = mag->blocks[i];
+            last = mag->blocks[i];
+        }
+        count = keep;
     }
+    mag->blocks[count] = ptr;
+    atomic_store_relaxed(&mag->count, count + 1);
+    btree_owned_counter_inc(&mag->free_count);
+    btree_spin_unlock(&mag->lock);
     
-    /* 스핀락 해제 */
-    if (pool->flags & BTREE_POOL_FLAG_THREAD_SAFE) {
-        atomic_flag_clear(&pool->lock);
+    if (first) {
+        btree_pool_push_remote(pool, first, last);
     }
 }
 
@@ -328,23 +929,28 @@ bool btree_pool_contains(btree_memory_pool_t *pool, const void *ptr) {
 }
 
 /**
- * @brief 풀 통계 수집
+ * @brief 풀 통계 수집 (매거진별 카운터를 락 없이 합산)
  */
 void btree_pool_get_stats(btree_memory_pool_t *pool, btree_pool_stats_t *stats) {
     if (!pool || !stats) return;
     
-    /* 스핀락 획득 */
-    if (pool->flags & BTREE_POOL_FLAG_THREAD_SAFE) {
-        while (atomic_flag_test_and_set(&pool->lock)) {
-            /* 스핀 대기 */
-        }
-    }
+    size_t allocs = 0, frees = 0;
+    size_t used = btree_pool_used_blocks(pool, &allocs, &frees);
     
     *stats = pool->stats;
-    
-    /* 스핀락 해제 */
-    if (pool->flags & BTREE_POOL_FLAG_THREAD_SAFE) {
-        atomic_flag_clear(&pool->lock);
+    stats->used_blocks = used;
+    stats->free_blocks = pool->total_blocks - used;
+    stats->used_size = used * pool->block_size;
+    if (pool->flags & BTREE_POOL_FLAG_ARENA) {
+        /* 아레나 청크는 잘라 낸 영역 전체를 사용 중으로 봄 */
+        stats->used_size = (size_t)((char*)pool->next_free - (char*)pool->pool_start);
+    }
+    stats->free_size = pool->pool_size - stats->used_size;
+    stats->allocation_count = allocs;
+    stats->deallocation_count = frees;
+    stats->fragmentation_ratio = (double)used / pool->total_blocks;
+    if (stats->used_size > stats->peak_usage) {
+        stats->peak_usage = stats->used_size;
     }
 }
 
@@ -354,25 +960,27 @@ void btree_pool_get_stats(btree_memory_pool_t *pool, btree_pool_stats_t *stats)
 void btree_pool_reset(btree_memory_pool_t *pool) {
     if (!pool) return;
     
-    /* 스핀락 획득 */
-    while (atomic_flag_test_and_set(&pool->lock)) {
-        /* 스핀 대기 */
+    /* 매거진과 중앙 리스트를 모두 잠근 뒤 비움 */
+    for (int i = 0; i < BTREE_POOL_MAGAZINES; i++) {
+        btree_spin_lock(&pool->magazines[i].lock);
     }
+    btree_spin_lock(&pool->lock);
     
-    /* 모든 블록을 자유 리스트로 되돌림 */
-    for (size_t i = 0; i < pool->total_blocks; i++) {
-        pool->free_list[i] = (char*)pool->pool_start + (i * pool->block_size);
+    for (int i = 0; i < BTREE_POOL_MAGAZINES; i++) {
+        atomic_store_relaxed(&pool->magazines[i].count, 0);
     }
-    pool->free_count = pool->total_blocks;
+    pool->free_list = NULL;
+    pool->remote_free = NULL;
+    pool->next_free = pool->pool_start;
     
-    /* 통계 리셋 */
-    pool->stats.used_size = 0;
-    pool->stats.free_size = pool->pool_size;
-    pool->stats.used_blocks = 0;
-    pool->stats.free_blocks = pool->total_blocks;
-    pool->stats.fragmentation_ratio = 0.0;
+    /* 통계 리셋 (할당/해제 횟수는 유지) */
+    size_t used = btree_pool_used_blocks(pool, NULL, NULL);
+    atomic_store_relaxed(&pool->reset_blocks, pool->reset_blocks + used);
     
-    atomic_flag_clear(&pool->lock);
+    btree_spin_unlock(&pool->lock);
+    for (int i = BTREE_POOL_MAGAZINES - 1; i >= 0; i--) {
+        btree_spin_unlock(&pool->magazines[i].lock);
+    }
 }
 
 /**
@@ -387,6 +995,7 @@ btree_memory_manager_t* btree_memory_manager_create(void) {
     /* 기본 설정 */
     manager->fallback_allocator = btree_default_allocator();
     manager->large_allocation_threshold = 64 * 1024;  /* 64KB */
+    manager->numa_node = -1;
     
     /* 통계 초기화 */
     atomic_store(&manager->total_allocated, 0);
@@ -401,85 +1010,186 @@ btree_memory_manager_t* btree_memory_manager_create(void) {
 }
 
 /**
- * @brief 메모리 매니저 소멸
+ * @brief 메모리 매니저 소멸 (모든 크기 클래스의 슬랩 체인 해제)
  */
 void btree_memory_manager_destroy(btree_memory_manager_t *manager) {
     if (!manager) return;
     
-    /* 모든 풀 소멸 */
     for (size_t i = 0; i < manager->pool_count; i++) {
-        if (manager->pools[i]) {
-            btree_pool_destroy(manager->pools[i]);
+        btree_memory_pool_t *pool = manager->pools[i];
+        while (pool) {
+            btree_memory_pool_t *next = pool->next;
+            btree_pool_destroy(pool);
+            pool = next;
         }
     }
     
     free(manager);
 }
 
-/**
- * @brief 적절한 풀 찾기
- */
-static btree_memory_pool_t* find_suitable_pool(btree_memory_manager_t *manager, size_t size) {
-    for (size_t i = 0; i < manager->pool_count; i++) {
-        btree_memory_pool_t *pool = manager->pools[i];
-        if (pool && pool->block_size >= size && pool->free_count > 0) {
-            return pool;
-        }
+/* 매니저 통계 반영 (SHARED_STATS면 전역 샤드 통계) */
+static void btree_manager_account(btree_memory_manager_t *manager,
+                                  size_t allocated, size_t freed) {
+    if (manager->flags & BTREE_MANAGER_FLAG_SHARED_STATS) {
+        btree_memory_account(allocated, freed);
+        return;
+    }
+    if (allocated) {
+        atomic_fetch_add(&manager->total_allocated, allocated);
+        atomic_fetch_add(&manager->current_usage, allocated);
+    }
+    if (freed) {
+        atomic_fetch_add(&manager->total_freed, freed);
+        atomic_fetch_sub(&manager->current_usage, freed);
+    }
+}
+
+/**
+ * @brief size 이상 limit 이하 블록 크기 중 가장 작은 크기 클래스 (없으면 -1)
+ *
+ * pools[i]는 btree_manager_grow가 release로 게시하므로 락 없이 acquire로 읽는다.
+ */
+static int btree_manager_find_class(btree_memory_manager_t *manager, size_t size, size_t limit) {
+    size_t count = atomic_load(&manager->pool_count);
+    int best = -1;
+    size_t best_block = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t block = atomic_load(&manager->pools[i])->block_size;
+        if (block >= size && block <= limit && (best < 0 || block < best_block)) {
+            best_block = block;
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+/* 크기 클래스의 슬랩을 최신 것부터 차례로 시도 */
+static void* btree_manager_class_alloc(btree_memory_manager_t *manager, int index) {
+    for (btree_memory_pool_t *pool = atomic_load(&manager->pools[index]); pool; pool = pool->next) {
+        void *ptr = btree_pool_alloc(pool);
+        if (ptr) return ptr;
     }
     return NULL;
 }
 
 /**
- * @brief 매니저에서 메모리 할당
+ * @brief 크기 클래스에 슬랩 추가 (manager_lock 보유 상태)
+ *
+ * 새 슬랩은 직전 슬랩의 두 배 크기 (BTREE_MAX_POOL_SIZE까지)이며 체인 앞에
+ * 연결된다. 첫 슬랩은 블록을 최소 64개 담는다.
  */
-void* btree_memory_manager_alloc(btree_memory_manager_t *manager, size_t size) {
-    if (!manager || size == 0) return NULL;
+static btree_memory_pool_t* btree_manager_grow(btree_memory_manager_t *manager,
+                                              int index, size_t block_size) {
+    btree_memory_pool_t *head = index < (int)manager->pool_count ? manager->pools[index] : NULL;
+    size_t slab_size;
+    
+    if (head) {
+        slab_size = head->pool_size < BTREE_MAX_POOL_SIZE ? head->pool_size * 2 : head->pool_size;
+    } else {
+        slab_size = btree_next_power_of_two(block_size * 64);
+        if (slab_size < BTREE_SLAB_SIZE) slab_size = BTREE_SLAB_SIZE;
+    }
     
-    /* 큰 할당은 fallback 할당자 사용 */
-    if (size > manager->large_allocation_threshold) {
-        void *ptr = manager->fallback_allocator->alloc(size);
-        if (ptr) {
-            atomic_fetch_add(&manager->total_allocated, size);
-            atomic_fetch_add(&manager->current_usage, size);
-        }
-        return ptr;
+    uint32_t flags = BTREE_POOL_FLAG_THREAD_SAFE;
+    if (manager->flags & BTREE_MANAGER_FLAG_HUGE_PAGES) flags |= BTREE_POOL_FLAG_HUGE_PAGES;
+    btree_memory_pool_t *slab = btree_slab_create(block_size, slab_size, flags);
+    if (!slab) return NULL;
+    btree_slab_advise(slab->pool_start, slab_size, manager->flags);
+    btree_slab_bind(slab->pool_start, slab_size, manager->numa_node);
+    
+    slab->next = head;
+    atomic_store(&manager->pools[index], slab);
+    manager->slab_count++;
+    if (index == (int)manager->pool_count) {
+        atomic_store(&manager->pool_count, manager->pool_count + 1);
     }
+    return slab;
+}
+
+/**
+ * @brief 블록 크기가 [size, limit]인 크기 클래스에서 할당 (필요하면 클래스/슬랩 추가)
+ */
+static void* btree_manager_alloc_block(btree_memory_manager_t *manager, size_t size,
+                                       size_t limit, size_t *block_size) {
+    int index = btree_manager_find_class(manager, size, limit);
+    void *ptr = index >= 0 ? btree_manager_class_alloc(manager, index) : NULL;
     
-    /* 적절한 풀 찾기 */
-    btree_memory_pool_t *pool = find_suitable_pool(manager, size);
-    if (pool) {
-        void *ptr = btree_pool_alloc(pool);
-        if (ptr) {
-            atomic_fetch_add(&manager->total_allocated, pool->block_size);
-            atomic_fetch_add(&manager->current_usage, pool->block_size);
+    if (!ptr) {
+        btree_spin_lock(&manager->manager_lock);
+        
+        /* 락을 기다리는 동안 다른 스레드가 클래스나 슬랩을 추가했을 수 있음 */
+        index = btree_manager_find_class(manager, size, limit);
+        if (index >= 0) {
+            ptr = btree_pool_alloc(manager->pools[index]);
+        } else if (manager->pool_count < BTREE_MAX_POOLS) {
+            index = (int)manager->pool_count;
         }
-        return ptr;
+        if (!ptr && index >= 0) {
+            size_t block = index < (int)manager->pool_count ? manager->pools[index]->block_size : limit;
+            btree_memory_pool_t *slab = btree_manager_grow(manager, index, block);
+            if (slab) ptr = btree_pool_alloc(slab);
+        }
+        
+        btree_spin_unlock(&manager->manager_lock);
     }
     
-    /* 적절한 풀이 없으면 새 풀 생성 */
-    if (manager->pool_count < BTREE_MAX_POOLS) {
-        size_t block_size = btree_next_power_of_two(size);
-        size_t pool_size = BTREE_DEFAULT_POOL_SIZE;
-        
-        btree_memory_pool_t *new_pool = btree_pool_create(block_size, pool_size, 
-                                                         BTREE_POOL_FLAG_THREAD_SAFE);
-        if (new_pool) {
-            manager->pools[manager->pool_count++] = new_pool;
-            
-            void *ptr = btree_pool_alloc(new_pool);
-            if (ptr) {
-                atomic_fetch_add(&manager->total_allocated, block_size);
-                atomic_fetch_add(&manager->current_usage, block_size);
-            }
+    if (ptr) {
+        *block_size = atomic_load(&manager->pools[index])->block_size;
+    }
+    return ptr;
+}
+
+/**
+ * @brief 매니저에서 메모리 할당 (2의 거듭제곱 크기 클래스)
+ */
+void* btree_memory_manager_alloc(btree_memory_manager_t *manager, size_t size) {
+    if (!manager || size == 0) return NULL;
+    
+    if (size <= manager->large_allocation_threshold) {
+        size_t limit = btree_next_power_of_two(btree_align_size(size, BTREE_POOL_ALIGNMENT));
+        size_t block_size = 0;
+        void *ptr = btree_manager_alloc_block(manager, size, limit, &block_size);
+        if (ptr) {
+            btree_manager_account(manager, block_size, 0);
             return ptr;
         }
     }
     
-    /* 모든 방법이 실패하면 fallback 할당자 사용 */
+    /* 큰 할당이거나 클래스를 더 만들 수 없으면 fallback 할당자 사용 */
     void *ptr = manager->fallback_allocator->alloc(size);
+    if (ptr && !(manager->flags & BTREE_MANAGER_FLAG_SHARED_STATS)) {
+        btree_manager_account(manager, size, 0);
+    }
+    return ptr;
+}
+
+/**
+ * @brief 크기와 정확히 같은 블록 크기 (BTREE_POOL_ALIGNMENT 정렬)의 클래스에서 할당
+ *
+ * 클래스 수가 BTREE_MAX_POOLS에 이르면 가장 가까운 큰 클래스, 그마저 없으면 fallback
+ * 할당자를 사용한다.
+ */
+void* btree_memory_manager_alloc_exact(btree_memory_manager_t *manager, size_t size) {
+    if (!manager || size == 0) return NULL;
+    
+    size_t aligned = btree_align_size(size, BTREE_POOL_ALIGNMENT);
+    size_t block_size = 0;
+    void *ptr = NULL;
+    if (size <= manager->large_allocation_threshold) {
+        ptr = btree_manager_alloc_block(manager, size, aligned, &block_size);
+        if (!ptr && atomic_load(&manager->pool_count) >= BTREE_MAX_POOLS) {
+            ptr = btree_manager_alloc_block(manager, size, manager->large_allocation_threshold,
+                                            &block_size);
+        }
+    }
     if (ptr) {
-        atomic_fetch_add(&manager->total_allocated, size);
-        atomic_fetch_add(&manager->current_usage, size);
+        btree_manager_account(manager, block_size, 0);
+        return ptr;
+    }
+    
+    ptr = manager->fallback_allocator->alloc(size);
+    if (ptr && !(manager->flags & BTREE_MANAGER_FLAG_SHARED_STATS)) {
+        btree_manager_account(manager, size, 0);
     }
     return ptr;
 }
@@ -490,15 +1200,12 @@ void* btree_memory_manager_alloc(btree_memory_manager_t *manager, size_t size) {
 void btree_memory_manager_free(btree_memory_manager_t *manager, void *ptr) {
     if (!manager || !ptr) return;
     
-    /* 어느 풀에 속하는지 확인 */
-    for (size_t i = 0; i < manager->pool_count; i++) {
-        btree_memory_pool_t *pool = manager->pools[i];
-        if (pool && btree_pool_contains(pool, ptr)) {
-            btree_pool_free(pool, ptr);
-            manager->total_freed += pool->block_size;
-            manager->current_usage -= pool->block_size;
-            return;
-        }
+    /* 페이지 맵으로 소유 슬랩 확인 */
+    btree_memory_pool_t *pool = btree_memory_find_pool(ptr);
+    if (pool) {
+        btree_pool_free(pool, ptr);
+        btree_manager_account(manager, 0, pool->block_size);
+        return;
     }
     
     /* 풀에 속하지 않으면 fallback 할당자 사용 */
@@ -506,28 +1213,939 @@ void btree_memory_manager_free(btree_memory_manager_t *manager, void *ptr) {
     /* default_free에서 자동으로 크기 추적되므로 추가 업데이트 불필요 */
 }
 
+/**
+ * @brief 매니저 메모리 재할당 (슬랩 블록에 들어가면 그대로 반환)
+ */
+void* btree_memory_manager_realloc(btree_memory_manager_t *manager, void *ptr, size_t new_size) {
+    if (!manager) return NULL;
+    if (!ptr) return btree_memory_manager_alloc(manager, new_size);
+    if (new_size == 0) {
+        btree_memory_manager_free(manager, ptr);
+        return NULL;
+    }
+    
+    btree_memory_pool_t *pool = btree_memory_find_pool(ptr);
+    if (!pool) {
+        return manager->fallback_allocator->realloc(ptr, new_size);
+    }
+    if (new_size <= pool->block_size) return ptr;
+    
+    void *moved = btree_memory_manager_alloc(manager, new_size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, pool->block_size);
+    btree_memory_manager_free(manager, ptr);
+    return moved;
+}
+
+/* 공용 노드 풀 매니저 (처음 쓰일 때 생성, 프로세스 수명 동안 유지) */
+static btree_memory_manager_t *g_node_manager;
+
+static btree_memory_manager_t* btree_node_manager(void) {
+    btree_memory_manager_t *manager = atomic_load(&g_node_manager);
+    if (BTREE_LIKELY(manager != NULL)) return manager;
+    
+    btree_memory_manager_t *fresh = btree_memory_manager_create();
+    if (!fresh) return NULL;
+    fresh->flags |= BTREE_MANAGER_FLAG_SHARED_STATS | BTREE_MANAGER_FLAG_HUGE_PAGES;
+    
+    btree_memory_manager_t *expected = NULL;
+    if (!atomic_compare_exchange_strong(&g_node_manager, &expected, fresh)) {
+        btree_memory_manager_destroy(fresh);
+        return expected;
+    }
+    return fresh;
+}
+
+/**
+ * @brief 노드 블록 할당 (정확한 크기 클래스, 필요하면 클래스 생성)
+ */
+void* btree_node_pool_alloc(size_t size) {
+    btree_memory_manager_t *manager = btree_node_manager();
+    return manager ? btree_memory_manager_alloc_exact(manager, size) : default_alloc(size);
+}
+
+/* 공용 노드 풀 할당자 함수 (이미 있는 클래스에 맞는 크기만 풀 사용) */
+static void* node_pool_alloc(size_t size) {
+    btree_memory_manager_t *manager = btree_node_manager();
+    if (manager && size > 0 && size <= manager->large_allocation_threshold) {
+        size_t block_size = 0;
+        size_t aligned = btree_align_size(size, BTREE_POOL_ALIGNMENT);
+        int index = btree_manager_find_class(manager, size, aligned);
+        void *ptr = index >= 0 ? btree_manager_alloc_block(manager, size, aligned, &block_size) : NULL;
+        if (ptr) {
+            btree_manager_account(manager, block_size, 0);
+            return ptr;
+        }
+    }
+    return default_alloc(size);
+}
+
+static void node_pool_free(void *ptr) {
+    btree_memory_manager_t *manager = atomic_load(&g_node_manager);
+    if (manager) {
+        btree_memory_manager_free(manager, ptr);
+    } else {
+        default_free(ptr);
+    }
+}
+
+static void* node_pool_realloc(void *ptr, size_t new_size) {
+    btree_memory_manager_t *manager = atomic_load(&g_node_manager);
+    if (!manager || !btree_memory_find_pool(ptr)) {
+        return default_realloc(ptr, new_size);
+    }
+    return btree_memory_manager_realloc(manager, ptr, new_size);
+}
+
+static btree_allocator_t g_node_pool_allocator = {
+    .alloc = node_pool_alloc,
+    .free = node_pool_free,
+    .realloc = node_pool_realloc,
+    .context = NULL,
+    .total_allocated = 0,
+    .total_freed = 0
+};
+
+/**
+ * @brief 공용 노드 풀 할당자 반환
+ */
+btree_allocator_t* btree_node_pool_allocator(void) {
+    return &g_node_pool_allocator;
+}
+
 /**
  * @brief 풀 할당자 생성
+ *
+ * 할당자 함수는 컨텍스트를 받지 않으므로 전용 풀 대신 공용 노드 풀에
+ * block_size 크기 클래스를 만들어 두고 그 할당자의 사본을 반환한다.
+ * block_size 크기 요청은 이 클래스에서, 나머지는 기본 할당자에서 할당된다.
  */
 btree_allocator_t* btree_pool_allocator_create(size_t block_size, size_t pool_size) {
-    btree_memory_pool_t *pool = btree_pool_create(block_size, pool_size, 
-                                                 BTREE_POOL_FLAG_THREAD_SAFE);
-    if (!pool) return NULL;
+    if (block_size == 0 || pool_size < BTREE_MIN_POOL_SIZE || pool_size > BTREE_MAX_POOL_SIZE) {
+        return NULL;
+    }
+    
+    btree_memory_manager_t *manager = btree_node_manager();
+    if (!manager || block_size > manager->large_allocation_threshold) return NULL;
+    
+    /* 크기 클래스 준비 */
+    void *probe = btree_node_pool_alloc(block_size);
+    if (!probe) return NULL;
+    btree_memory_manager_free(manager, probe);
     
     btree_allocator_t *allocator = malloc(sizeof(btree_allocator_t));
-    if (!allocator) {
-        btree_pool_destroy(pool);
+    if (!allocator) return NULL;
+    
+    *allocator = g_node_pool_allocator;
+    allocator->context = manager;
+    return allocator;
+}
+
+/**
+ * @brief 풀 할당자 해제 (할당한 블록은 먼저 반환되어야 함)
+ */
+void btree_pool_allocator_destroy(btree_allocator_t *allocator) {
+    if (allocator && allocator != &g_node_pool_allocator) {
+        free(allocator);
+    }
+}
+
+/**
+ * @brief 공용 노드 풀의 새 슬랩에 적용할 힌트
+ */
+void btree_memory_set_alloc_hint(btree_alloc_hint_t hint) {
+    btree_memory_manager_t *manager = btree_node_manager();
+    if (!manager) return;
+    
+    btree_spin_lock(&manager->manager_lock);
+    manager->flags &= ~(uint32_t)(BTREE_MANAGER_FLAG_HUGE_PAGES | BTREE_MANAGER_FLAG_RANDOM_ACCESS);
+    if (hint != BTREE_ALLOC_HINT_TEMPORARY && hint != BTREE_ALLOC_HINT_LARGE_INFREQUENT) {
+        manager->flags |= BTREE_MANAGER_FLAG_HUGE_PAGES;
+    }
+    if (hint == BTREE_ALLOC_HINT_RANDOM) {
+        manager->flags |= BTREE_MANAGER_FLAG_RANDOM_ACCESS;
+    }
+    btree_spin_unlock(&manager->manager_lock);
+}
+
+/*
+ * 힌트별 할당자
+ *
+ * 노드 블록은 node_alloc으로 힌트에 맞는 곳에서 할당하고 그 외 할당은 기본
+ * 할당자를 쓴다. 해제 함수는 컨텍스트를 받지 않으므로 페이지 맵으로 소유
+ * 슬랩을 찾는다 (아레나 청크도 자기 크기로 정렬한 슬랩으로 등록한다).
+ */
+typedef struct {
+    btree_allocator_t allocator;        /* 공개 할당자 (첫 멤버) */
+    btree_alloc_hint_t hint;            /* 생성 힌트 */
+    btree_memory_manager_t *manager;    /* RANDOM: 전용 크기 클래스 (그 외 NULL) */
+    btree_memory_manager_t **node_managers; /* NUMA: 노드별 크기 클래스 (그 외 NULL) */
+    int node_count;                     /* node_managers 수 */
+    btree_memory_pool_t *chunks;        /* 아레나 청크 체인 (현재 청크가 앞) */
+    size_t chunk_size;                  /* 기본 청크 크기 (2의 거듭제곱) */
+    atomic_flag lock;                   /* 청크 체인과 현재 청크의 잘라 내기 보호 */
+} btree_hint_allocator_t;
+
+/* 아레나 청크 생성 (블록 단위는 정렬 크기, 사용량은 전역 통계에 청크째 반영) */
+static btree_memory_pool_t* btree_hint_chunk_create(btree_hint_allocator_t *hint, size_t size) {
+    size_t chunk_size = hint->chunk_size;
+    if (size > chunk_size) chunk_size = btree_next_power_of_two(size);
+    
+    uint32_t flags = BTREE_POOL_FLAG_ARENA;
+    if (hint->hint == BTREE_ALLOC_HINT_SEQUENTIAL) flags |= BTREE_POOL_FLAG_HUGE_PAGES;
+    btree_memory_pool_t *chunk = btree_slab_create(BTREE_POOL_ALIGNMENT, chunk_size, flags);
+    if (!chunk) return NULL;
+    btree_memory_account(chunk_size, 0);
+    return chunk;
+}
+
+static void btree_hint_chunk_destroy(btree_memory_pool_t *chunk) {
+    btree_memory_account(0, chunk->pool_size);
+    btree_pool_destroy(chunk);
+}
+
+/* 현재 청크 끝에서 size 바이트 잘라 냄 (hint->lock 보유 상태) */
+static void* btree_hint_chunk_take(btree_memory_pool_t *chunk, size_t size) {
+    char *end = (char*)chunk->pool_start + chunk->pool_size;
+    if ((size_t)(end - (char*)chunk->next_free) < size) return NULL;
+    
+    void *ptr = chunk->next_free;
+    chunk->next_free = (char*)ptr + size;
+    btree_owned_counter_inc(&chunk->magazines[0].alloc_count);
+    return ptr;
+}
+
+/**
+ * @brief 아레나에서 노드 블록 할당
+ *
+ * 현재 청크가 모자라면 블록이 모두 반환된 이전 청크를 비워 앞으로 옮기고,
+ * 없으면 새 청크를 만든다. 남은 꼬리는 버린다.
+ */
+static void* btree_hint_arena_alloc(btree_hint_allocator_t *hint, size_t size) {
+    size = btree_align_size(size ? size : 1, BTREE_POOL_ALIGNMENT);
+    
+    btree_spin_lock(&hint->lock);
+    void *ptr = hint->chunks ? btree_hint_chunk_take(hint->chunks, size) : NULL;
+    if (!ptr) {
+        btree_memory_pool_t **link = hint->chunks ? &hint->chunks->next : &hint->chunks;
+        while (*link && (btree_pool_used_blocks(*link, NULL, NULL) > 0 || (*link)->pool_size < size)) {
+            link = &(*link)->next;
+        }
+        btree_memory_pool_t *chunk = *link;
+        if (chunk) {
+            *link = chunk->next;
+            btree_pool_reset(chunk);
+        } else {
+            chunk = btree_hint_chunk_create(hint, size);
+        }
+        if (chunk) {
+            chunk->next = hint->chunks;
+            hint->chunks = chunk;
+            ptr = btree_hint_chunk_take(chunk, size);
+        }
+    }
+    btree_spin_unlock(&hint->lock);
+    return ptr;
+}
+
+static void* btree_hint_node_alloc(void *context, size_t size) {
+    btree_hint_allocator_t *hint = context;
+    if (hint->manager) return btree_memory_manager_alloc_exact(hint->manager, size);
+    return btree_hint_arena_alloc(hint, size);
+}
+
+/* 아레나 블록은 해제 수만 세고, 크기 클래스 블록은 슬랩에 반환 */
+static void btree_hint_free(void *ptr) {
+    if (!ptr) return;
+    
+    btree_memory_pool_t *pool = btree_memory_find_pool(ptr);
+    if (!pool) {
+        default_free(ptr);
+    } else if (pool->flags & BTREE_POOL_FLAG_ARENA) {
+        atomic_fetch_add(&pool->magazines[0].free_count, 1);
+    } else {
+        btree_pool_free(pool, ptr);
+        btree_memory_account(0, pool->block_size);
+    }
+}
+
+/* 슬랩 블록은 기본 할당자로 옮김 (아레나 블록은 청크의 잘라 낸 끝까지만 복사) */
+static void* btree_hint_realloc(void *ptr, size_t new_size) {
+    btree_memory_pool_t *pool = ptr ? btree_memory_find_pool(ptr) : NULL;
+    if (!pool) return default_realloc(ptr, new_size);
+    if (new_size == 0) {
+        btree_hint_free(ptr);
         return NULL;
     }
     
-    allocator->alloc = (btree_alloc_func_t)btree_pool_alloc;
-    allocator->free = (btree_free_func_t)btree_pool_free;
-    allocator->realloc = NULL;  /* 풀은 재할당 지원하지 않음 */
-    allocator->context = pool;
-    allocator->total_allocated = 0;
-    allocator->total_freed = 0;
+    size_t old_size = pool->block_size;
+    if (pool->flags & BTREE_POOL_FLAG_ARENA) {
+        old_size = (size_t)((char*)pool->next_free - (char*)ptr);
+    }
+    void *moved = default_alloc(new_size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    btree_hint_free(ptr);
+    return moved;
+}
+
+static bool btree_is_hint_allocator(const btree_allocator_t *allocator) {
+    return allocator && allocator->free == btree_hint_free;
+}
+
+/**
+ * @brief 힌트에 맞는 노드 할당 전략의 할당자 반환
+ */
+btree_allocator_t* btree_optimized_allocator_create(btree_alloc_hint_t hint) {
+    switch (hint) {
+        case BTREE_ALLOC_HINT_SMALL_FREQUENT:
+        case BTREE_ALLOC_HINT_PERSISTENT:
+            return btree_node_pool_allocator();
+        case BTREE_ALLOC_HINT_LARGE_INFREQUENT:
+            return btree_default_allocator();
+        case BTREE_ALLOC_HINT_SEQUENTIAL:
+        case BTREE_ALLOC_HINT_TEMPORARY:
+        case BTREE_ALLOC_HINT_RANDOM:
+            break;
+        default:
+            return NULL;
+    }
     
-    return allocator;
+    btree_hint_allocator_t *state = calloc(1, sizeof(btree_hint_allocator_t));
+    if (!state) return NULL;
+    
+    state->hint = hint;
+    state->chunk_size = hint == BTREE_ALLOC_HINT_SEQUENTIAL ? BTREE_HUGE_PAGE_SIZE : BTREE_SLAB_SIZE;
+    atomic_flag_clear(&state->lock);
+    if (hint == BTREE_ALLOC_HINT_RANDOM) {
+        state->manager = btree_memory_manager_create();
+        if (!state->manager) {
+            free(state);
+            return NULL;
+        }
+        /* 해제는 매니저 없이 전역 통계로 되돌리므로 할당도 전역 통계에 반영 */
+        state->manager->flags |= BTREE_MANAGER_FLAG_SHARED_STATS | BTREE_MANAGER_FLAG_RANDOM_ACCESS;
+    }
+    
+    state->allocator.alloc = default_alloc;
+    state->allocator.free = btree_hint_free;
+    state->allocator.realloc = btree_hint_realloc;
+    state->allocator.context = state;
+    state->allocator.node_alloc = btree_hint_node_alloc;
+    return &state->allocator;
+}
+
+/**
+ * @brief 아레나 할당자의 모든 블록을 한 번에 회수 (첫 청크만 남김)
+ */
+void btree_optimized_allocator_reset(btree_allocator_t *allocator) {
+    if (!btree_is_hint_allocator(allocator)) return;
+    
+    btree_hint_allocator_t *state = allocator->context;
+    btree_spin_lock(&state->lock);
+    btree_memory_pool_t *chunk = state->chunks;
+    if (chunk) {
+        while (chunk->next) {
+            btree_memory_pool_t *next = chunk->next->next;
+            btree_hint_chunk_destroy(chunk->next);
+            chunk->next = next;
+        }
+        btree_pool_reset(chunk);
+    }
+    btree_spin_unlock(&state->lock);
+}
+
+/**
+ * @brief 힌트 할당자 해제 (공용 할당자는 그대로 둠)
+ */
+void btree_optimized_allocator_destroy(btree_allocator_t *allocator) {
+    if (!btree_is_hint_allocator(allocator)) return;
+    
+    btree_hint_allocator_t *state = allocator->context;
+    while (state->chunks) {
+        btree_memory_pool_t *next = state->chunks->next;
+        btree_hint_chunk_destroy(state->chunks);
+        state->chunks = next;
+    }
+    btree_memory_manager_destroy(state->manager);
+    for (int i = 0; i < state->node_count; i++) {
+        btree_memory_manager_destroy(state->node_managers[i]);
+    }
+    free(state->node_managers);
+    free(state);
+}
+
+#ifdef BTREE_NUMA_SUPPORT
+
+/* NUMA 할당 머리 (해제할 때 크기와 할당 방식이 필요) */
+typedef struct {
+    size_t size;                        /* 머리를 포함한 전체 크기 */
+    bool numa;                          /* numa_alloc_*로 받았는지 (아니면 malloc) */
+} btree_numa_header_t;
+
+#define BTREE_NUMA_HEADER_SIZE btree_align_size(sizeof(btree_numa_header_t), BTREE_CACHE_LINE_SIZE)
+
+/**
+ * @brief 구성된 NUMA 노드 수 (libnuma를 쓸 수 없으면 1)
+ */
+int btree_numa_node_count(void) {
+    if (numa_available() < 0) return 1;
+    int count = numa_max_node() + 1;
+    return count > 0 ? count : 1;
+}
+
+/**
+ * @brief 현재 CPU의 NUMA 노드 (알 수 없으면 0)
+ */
+int btree_numa_current_node(void) {
+    if (numa_available() < 0) return 0;
+    int cpu = sched_getcpu();
+    int node = cpu >= 0 ? numa_node_of_cpu(cpu) : -1;
+    return node >= 0 ? node : 0;
+}
+
+bool btree_numa_get_info(btree_numa_info_t *info) {
+    if (!info || numa_available() < 0) return false;
+    
+    int node = btree_numa_current_node();
+    int count = btree_numa_node_count();
+    long long local = numa_node_size64(node, NULL);
+    
+    info->node_id = node;
+    info->local_memory = local > 0 ? (size_t)local : 0;
+    info->remote_memory = 0;
+    
+    double distance = 0.0;
+    int remote_nodes = 0;
+    for (int i = 0; i < count; i++) {
+        if (i == node) continue;
+        long long size = numa_node_size64(i, NULL);
+        if (size <= 0) continue;
+        info->remote_memory += (size_t)size;
+        distance += numa_distance(node, i);
+        remote_nodes++;
+    }
+    int local_distance = numa_distance(node, node);
+    info->access_latency = remote_nodes > 0 && local_distance > 0
+                         ? distance / remote_nodes / local_distance : 1.0;
+    return true;
+}
+
+/* 머리를 채우고 사용자 영역 반환 */
+static void* btree_numa_finish(void *block, size_t size, bool numa) {
+    if (!block) return NULL;
+    btree_numa_header_t *header = block;
+    header->size = size;
+    header->numa = numa;
+    btree_memory_account(size, 0);
+    return (char*)block + BTREE_NUMA_HEADER_SIZE;
+}
+
+/* how: 0 로컬, 1 교차 배치, 2 node에 고정 */
+static void* btree_numa_alloc_with(size_t size, int how, int node) {
+    if (size == 0) return NULL;
+    size_t total = size + BTREE_NUMA_HEADER_SIZE;
+    if (numa_available() < 0) return btree_numa_finish(malloc(total), total, false);
+    
+    void *block;
+    switch (how) {
+        case 0: block = numa_alloc_local(total); break;
+        case 1: block = numa_alloc_interleaved(total); break;
+        default: block = numa_alloc_onnode(total, node); break;
+    }
+    return btree_numa_finish(block, total, true);
+}
+
+void* btree_numa_alloc_local(size_t size) {
+    return btree_numa_alloc_with(size, 0, 0);
+}
+
+void* btree_numa_alloc_interleaved(size_t size) {
+    return btree_numa_alloc_with(size, 1, 0);
+}
+
+void* btree_numa_alloc_onnode(size_t size, int node) {
+    if (node < 0) return btree_numa_alloc_local(size);
+    return btree_numa_alloc_with(size, 2, node);
+}
+
+void btree_numa_free(void *ptr) {
+    if (!ptr) return;
+    
+    btree_numa_header_t *header = (btree_numa_header_t*)((char*)ptr - BTREE_NUMA_HEADER_SIZE);
+    size_t size = header->size;
+    btree_memory_account(0, size);
+    if (header->numa) {
+        numa_free(header, size);
+    } else {
+        free(header);
+    }
+}
+
+/* 할당하는 스레드의 노드 매니저에서 노드 블록 할당 */
+static void* btree_numa_node_alloc(void *context, size_t size) {
+    btree_hint_allocator_t *state = context;
+    int node = btree_numa_current_node();
+    if (node >= state->node_count) node = 0;
+    return btree_memory_manager_alloc_exact(state->node_managers[node], size);
+}
+
+/**
+ * @brief NUMA 노드별 매니저로 노드를 할당하는 할당자
+ */
+btree_allocator_t* btree_numa_allocator_create(void) {
+    btree_hint_allocator_t *state = calloc(1, sizeof(btree_hint_allocator_t));
+    if (!state) return NULL;
+    
+    int count = btree_numa_node_count();
+    state->node_managers = calloc((size_t)count, sizeof(btree_memory_manager_t*));
+    if (!state->node_managers) {
+        free(state);
+        return NULL;
+    }
+    state->hint = BTREE_ALLOC_HINT_PERSISTENT;
+    atomic_flag_clear(&state->lock);
+    state->allocator.alloc = default_alloc;
+    state->allocator.free = btree_hint_free;
+    state->allocator.realloc = btree_hint_realloc;
+    state->allocator.context = state;
+    state->allocator.node_alloc = btree_numa_node_alloc;
+    
+    for (int i = 0; i < count; i++) {
+        btree_memory_manager_t *manager = btree_memory_manager_create();
+        if (!manager) {
+            btree_optimized_allocator_destroy(&state->allocator);
+            return NULL;
+        }
+        /* 해제는 btree_hint_free가 매니저 없이 전역 통계로 되돌림 */
+        manager->flags |= BTREE_MANAGER_FLAG_SHARED_STATS;
+        manager->numa_node = numa_available() >= 0 ? i : -1;
+        state->node_managers[i] = manager;
+        state->node_count = i + 1;
+    }
+
+    return &state->allocator;
+}
+
+#endif /* BTREE_NUMA_SUPPORT */
+
+/* ---- 블록 압축 (FOR, DELTA, LZ4) ---- */
+
+#define BTREE_FOR_MAX_WIDTH     56      /* 비트 누산기 하나로 다룰 수 있는 폭 */
+#define BTREE_FOR_HEADER_SIZE   9       /* 비트 폭 1바이트 + 기준값 8바이트 */
+#define BTREE_LZ4_HASH_BITS     12
+#define BTREE_LZ4_MIN_MATCH     4
+#define BTREE_LZ4_LAST_LITERALS 5       /* 블록 끝 5바이트는 늘 리터럴 */
+#define BTREE_LZ4_MF_LIMIT      12      /* 마지막 일치는 끝에서 12바이트 앞에서 시작 */
+#define BTREE_LZ4_MAX_OFFSET    65535
+
+static bool btree_int_element_size(uint32_t size) {
+    return size == 1 || size == 2 || size == 4 || size == 8;
+}
+
+/* size 바이트 정수를 부호 확장해 읽음 */
+static int64_t btree_load_int(const unsigned char *p, uint32_t size) {
+    switch (size) {
+    case 1: { int8_t v; memcpy(&v, p, 1); return v; }
+    case 2: { int16_t v; memcpy(&v, p, 2); return v; }
+    case 4: { int32_t v; memcpy(&v, p, 4); return v; }
+    default: { int64_t v; memcpy(&v, p, 8); return v; }
+    }
+}
+
+static void btree_store_int(unsigned char *p, uint32_t size, uint64_t value) {
+    switch (size) {
+    case 1: { uint8_t v = (uint8_t)value; memcpy(p, &v, 1); break; }
+    case 2: { uint16_t v = (uint16_t)value; memcpy(p, &v, 2); break; }
+    case 4: { uint32_t v = (uint32_t)value; memcpy(p, &v, 4); break; }
+    default: memcpy(p, &value, 8); break;
+    }
+}
+
+/* FOR: 최솟값과 범위를 담는 비트 폭 */
+static unsigned btree_for_width(const unsigned char *src, size_t count, uint32_t esize,
+                                int64_t *min_out) {
+    int64_t min = 0, max = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t v = btree_load_int(src + i * esize, esize);
+        if (i == 0 || v < min) min = v;
+        if (i == 0 || v > max) max = v;
+    }
+    uint64_t range = (uint64_t)max - (uint64_t)min;
+    unsigned width = 0;
+    while (width < 64 && (range >> width)) width++;
+    *min_out = min;
+    return width;
+}
+
+static size_t btree_for_size(size_t count, unsigned width) {
+    return BTREE_FOR_HEADER_SIZE + (count * width + 7) / 8;
+}
+
+/* FOR: [비트 폭][기준값][값 - 기준값을 width 비트씩 리틀 엔디언으로] */
+static bool btree_for_encode(const unsigned char *src, size_t count, uint32_t esize,
+                             unsigned char *dst, size_t capacity, size_t *used) {
+    int64_t min;
+    unsigned width = btree_for_width(src, count, esize, &min);
+    if (width > BTREE_FOR_MAX_WIDTH || btree_for_size(count, width) > capacity) return false;
+
+    dst[0] = (unsigned char)width;
+    memcpy(dst + 1, &min, sizeof(min));
+    unsigned char *out = dst + BTREE_FOR_HEADER_SIZE;
+    uint64_t acc = 0;
+    unsigned bits = 0;
+    for (size_t i = 0; i < count; i++) {
+        acc |= ((uint64_t)btree_load_int(src + i * esize, esize) - (uint64_t)min) << bits;
+        bits += width;
+        while (bits >= 8) {
+            *out++ = (unsigned char)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits) *out++ = (unsigned char)acc;
+    *used = (size_t)(out - dst);
+    return true;
+}
+
+static bool btree_for_decode(const unsigned char *src, size_t size, unsigned char *dst,
+                             size_t count, uint32_t esize) {
+    if (size < BTREE_FOR_HEADER_SIZE) return false;
+    unsigned width = src[0];
+    if (width > BTREE_FOR_MAX_WIDTH || size != btree_for_size(count, width)) return false;
+
+    int64_t min;
+    memcpy(&min, src + 1, sizeof(min));
+    const unsigned char *in = src + BTREE_FOR_HEADER_SIZE;
+    uint64_t mask = width ? ((uint64_t)1 << width) - 1 : 0;
+    uint64_t acc = 0;
+    unsigned bits = 0;
+    for (size_t i = 0; i < count; i++) {
+        while (bits < width) {
+            acc |= (uint64_t)*in++ << bits;
+            bits += 8;
+        }
+        btree_store_int(dst + i * esize, esize, (uint64_t)min + (acc & mask));
+        acc >>= width;
+        bits -= width;
+    }
+    return true;
+}
+
+static size_t btree_varint_size(uint64_t value) {
+    size_t n = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        n++;
+    }
+    return n;
+}
+
+/* DELTA: 앞 값과의 차이 (첫 값은 0과의 차이)를 zigzag로 바꿔 varint로 */
+static uint64_t btree_delta_zigzag(const unsigned char *src, size_t i, uint32_t esize) {
+    uint64_t prev = i ? (uint64_t)btree_load_int(src + (i - 1) * esize, esize) : 0;
+    uint64_t d = (uint64_t)btree_load_int(src + i * esize, esize) - prev;
+    return (d << 1) ^ (0 - (d >> 63));
+}
+
+static size_t btree_delta_size(const unsigned char *src, size_t count, uint32_t esize) {
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++) {
+        size += btree_varint_size(btree_delta_zigzag(src, i, esize));
+    }
+    return size;
+}
+
+static bool btree_delta_encode(const unsigned char *src, size_t count, uint32_t esize,
+                               unsigned char *dst, size_t capacity, size_t *used) {
+    size_t o = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t zz = btree_delta_zigzag(src, i, esize);
+        if (capacity - o < btree_varint_size(zz)) return false;
+        while (zz >= 0x80) {
+            dst[o++] = (unsigned char)(zz | 0x80);
+            zz >>= 7;
+        }
+        dst[o++] = (unsigned char)zz;
+    }
+    *used = o;
+    return true;
+}
+
+static bool btree_delta_decode(const unsigned char *src, size_t size, unsigned char *dst,
+                               size_t count, uint32_t esize) {
+    size_t i = 0;
+    uint64_t prev = 0;
+    for (size_t n = 0; n < count; n++) {
+        uint64_t zz = 0;
+        unsigned shift = 0;
+        for (;;) {
+            if (i >= size || shift >= 64) return false;
+            unsigned char byte = src[i++];
+            zz |= (uint64_t)(byte & 0x7F) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) break;
+        }
+        prev += (zz >> 1) ^ (0 - (zz & 1));
+        btree_store_int(dst + n * esize, esize, prev);
+        /* 다음 차이는 저장한 폭으로 부호 확장한 값 기준 */
+        prev = (uint64_t)btree_load_int(dst + n * esize, esize);
+    }
+    return i == size;
+}
+
+#ifdef BTREE_COMPRESSION_SUPPORT
+
+/* liblz4와 같은 블록 형식이므로 어느 쪽으로 만든 이미지든 서로 읽음 */
+static bool btree_lz4_encode(const unsigned char *src, size_t size, unsigned char *dst,
+                             size_t capacity, size_t *used) {
+    if (size > (size_t)LZ4_MAX_INPUT_SIZE || capacity > (size_t)INT32_MAX) return false;
+    int n = LZ4_compress_default((const char*)src, (char*)dst, (int)size, (int)capacity);
+    if (n <= 0) return false;
+    *used = (size_t)n;
+    return true;
+}
+
+static bool btree_lz4_decode(const unsigned char *src, size_t size, unsigned char *dst,
+                             size_t dst_size) {
+    if (size > (size_t)INT32_MAX || dst_size > (size_t)INT32_MAX) return false;
+    int n = LZ4_decompress_safe((const char*)src, (char*)dst, (int)size, (int)dst_size);
+    return n >= 0 && (size_t)n == dst_size;
+}
+
+#else
+
+static bool btree_lz4_put_length(unsigned char **op, const unsigned char *end, size_t length) {
+    for (; length >= 255; length -= 255) {
+        if (*op >= end) return false;
+        *(*op)++ = 255;
+    }
+    if (*op >= end) return false;
+    *(*op)++ = (unsigned char)length;
+    return true;
+}
+
+/* 시퀀스 하나 (match_len이 0이면 마지막 리터럴만) */
+static bool btree_lz4_emit(unsigned char **op, const unsigned char *end,
+                           const unsigned char *literals, size_t literal_len,
+                           size_t offset, size_t match_len) {
+    unsigned char *o = *op;
+    if (o >= end) return false;
+    unsigned char *token = o++;
+    *token = (unsigned char)((literal_len >= 15 ? 15 : literal_len) << 4);
+    if (literal_len >= 15 && !btree_lz4_put_length(&o, end, literal_len - 15)) return false;
+    if ((size_t)(end - o) < literal_len) return false;
+    memcpy(o, literals, literal_len);
+    o += literal_len;
+
+    if (match_len) {
+        size_t extra = match_len - BTREE_LZ4_MIN_MATCH;
+        if (end - o < 2) return false;
+        o[0] = (unsigned char)offset;
+        o[1] = (unsigned char)(offset >> 8);
+        o += 2;
+        *token |= (unsigned char)(extra >= 15 ? 15 : extra);
+        if (extra >= 15 && !btree_lz4_put_length(&o, end, extra - 15)) return false;
+    }
+    *op = o;
+    return true;
+}
+
+/* 탐욕 LZ4 블록 압축 (4바이트 해시로 가장 최근 위치 하나만 봄) */
+static bool btree_lz4_encode(const unsigned char *src, size_t size, unsigned char *dst,
+                             size_t capacity, size_t *used) {
+    if (size > INT32_MAX) return false;
+
+    unsigned char *op = dst;
+    const unsigned char *end = dst + capacity;
+    const unsigned char *anchor = src;
+
+    if (size > BTREE_LZ4_MF_LIMIT) {
+        uint32_t table[1 << BTREE_LZ4_HASH_BITS];   /* 위치 + 1 (0은 빈 칸) */
+        memset(table, 0, sizeof(table));
+        const unsigned char *ip = src;
+        const unsigned char *match_limit = src + size - BTREE_LZ4_LAST_LITERALS;
+        const unsigned char *ip_limit = src + size - BTREE_LZ4_MF_LIMIT;
+
+        while (ip <= ip_limit) {
+            uint32_t seq;
+            memcpy(&seq, ip, sizeof(seq));
+            uint32_t h = (seq * 2654435761u) >> (32 - BTREE_LZ4_HASH_BITS);
+            uint32_t pos = (uint32_t)(ip - src);
+            uint32_t ref_pos = table[h];
+            table[h] = pos + 1;
+
+            if (ref_pos && pos - (ref_pos - 1) <= BTREE_LZ4_MAX_OFFSET) {
+                const unsigned char *ref = src + ref_pos - 1;
+                if (memcmp(ref, ip, BTREE_LZ4_MIN_MATCH) == 0) {
+                    const unsigned char *m = ip + BTREE_LZ4_MIN_MATCH;
+                    const unsigned char *r = ref + BTREE_LZ4_MIN_MATCH;
+                    while (m < match_limit && *m == *r) {
+                        m++;
+                        r++;
+                    }
+                    if (!btree_lz4_emit(&op, end, anchor, (size_t)(ip - anchor),
+                                        (size_t)(ip - ref), (size_t)(m - ip))) {
+                        return false;
+                    }
+                    ip = anchor = m;
+                    continue;
+                }
+            }
+            ip++;
+        }
+    }
+
+    if (!btree_lz4_emit(&op, end, anchor, (size_t)(src + size - anchor), 0, 0)) return false;
+    *used = (size_t)(op - dst);
+    return true;
+}
+
+static bool btree_lz4_get_length(const unsigned char **ip, const unsigned char *end,
+                                 size_t *length) {
+    unsigned char byte;
+    do {
+        if (*ip >= end || *length > SIZE_MAX / 2) return false;
+        byte = *(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/* 모든 길이와 오프셋을 확인하는 복원 (손상된 입력도 dst 밖을 쓰지 않음) */
+static bool btree_lz4_decode(const unsigned char *src, size_t size, unsigned char *dst,
+                             size_t dst_size) {
+    const unsigned char *ip = src, *iend = src + size;
+    unsigned char *op = dst, *oend = dst + dst_size;
+
+    for (;;) {
+        if (ip >= iend) return false;
+        unsigned token = *ip++;
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !btree_lz4_get_length(&ip, iend, &literal_len)) return false;
+        if ((size_t)(iend - ip) < literal_len || (size_t)(oend - op) < literal_len) return false;
+        memcpy(op, ip, literal_len);
+        op += literal_len;
+        ip += literal_len;
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return false;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) return false;
+        size_t match_len = token & 15;
+        if (match_len == 15 && !btree_lz4_get_length(&ip, iend, &match_len)) return false;
+        match_len += BTREE_LZ4_MIN_MATCH;
+        if ((size_t)(oend - op) < match_len) return false;
+
+        /* 겹치는 복사 (offset이 길이보다 짧으면 반복 패턴) */
+        const unsigned char *ref = op - offset;
+        while (match_len--) *op++ = *ref++;
+    }
+    return op == oend;
+}
+
+#endif /* BTREE_COMPRESSION_SUPPORT */
+
+static bool btree_compress_with(uint32_t algorithm, const unsigned char *src, size_t size,
+                                uint32_t esize, unsigned char *dst, size_t capacity,
+                                size_t *used) {
+    switch (algorithm) {
+    case BTREE_COMPRESS_NONE:
+        if (size > capacity) return false;
+        memcpy(dst, src, size);
+        *used = size;
+        return true;
+    case BTREE_COMPRESS_LZ4:
+        return btree_lz4_encode(src, size, dst, capacity, used);
+    case BTREE_COMPRESS_FOR:
+        return btree_int_element_size(esize) && size % esize == 0 &&
+               btree_for_encode(src, size / esize, esize, dst, capacity, used);
+    case BTREE_COMPRESS_DELTA:
+        return btree_int_element_size(esize) && size % esize == 0 &&
+               btree_delta_encode(src, size / esize, esize, dst, capacity, used);
+    default:
+        return false;
+    }
+}
+
+/* AUTO: FOR와 DELTA는 크기를 미리 계산하고, LZ4는 dst에 실제로 압축해 비교 */
+static uint32_t btree_compress_auto(const unsigned char *src, size_t size, uint32_t esize,
+                                    unsigned char *dst, size_t capacity, size_t *used) {
+    uint32_t best = BTREE_COMPRESS_NONE;
+    size_t best_size = size;
+
+    if (btree_int_element_size(esize) && size % esize == 0) {
+        size_t count = size / esize;
+        int64_t min;
+        unsigned width = btree_for_width(src, count, esize, &min);
+        if (width <= BTREE_FOR_MAX_WIDTH && btree_for_size(count, width) < best_size) {
+            best = BTREE_COMPRESS_FOR;
+            best_size = btree_for_size(count, width);
+        }
+        size_t delta = btree_delta_size(src, count, esize);
+        if (delta < best_size) {
+            best = BTREE_COMPRESS_DELTA;
+            best_size = delta;
+        }
+    }
+
+    size_t lz4_size;
+    size_t lz4_capacity = best_size < capacity ? best_size : capacity;
+    if (best_size > 0 && btree_lz4_encode(src, size, dst, lz4_capacity, &lz4_size) &&
+        lz4_size < best_size) {
+        *used = lz4_size;
+        return BTREE_COMPRESS_LZ4;
+    }
+    if (!btree_compress_with(best, src, size, esize, dst, capacity, used)) {
+        return BTREE_COMPRESS_AUTO;
+    }
+    return best;
+}
+
+bool btree_memory_compress(const void *src, size_t src_size, void *dst, 
+                          size_t *dst_size, btree_compression_info_t *info) {
+    if ((!src && src_size) || !dst || !dst_size || !info) return false;
+
+    size_t used = 0;
+    uint32_t algorithm = info->algorithm;
+    if (algorithm == BTREE_COMPRESS_AUTO) {
+        algorithm = btree_compress_auto(src, src_size, info->element_size, dst, *dst_size, &used);
+        if (algorithm == BTREE_COMPRESS_AUTO) return false;
+    } else if (!btree_compress_with(algorithm, src, src_size, info->element_size,
+                                    dst, *dst_size, &used)) {
+        return false;
+    }
+
+    info->algorithm = algorithm;
+    info->original_size = src_size;
+    info->compressed_size = used;
+    info->compression_ratio = src_size ? (float)used / (float)src_size : 1.0f;
+    *dst_size = used;
+    return true;
+}
+
+bool btree_memory_decompress(const void *src, size_t src_size, void *dst, 
+                            size_t dst_size, const btree_compression_info_t *info) {
+    if ((!src && src_size) || (!dst && dst_size) || !info) return false;
+
+    uint32_t esize = info->element_size;
+    switch (info->algorithm) {
+    case BTREE_COMPRESS_NONE:
+        if (src_size != dst_size) return false;
+        if (dst_size) memcpy(dst, src, dst_size);
+        return true;
+    case BTREE_COMPRESS_LZ4:
+        return btree_lz4_decode(src, src_size, dst, dst_size);
+    case BTREE_COMPRESS_FOR:
+        return btree_int_element_size(esize) && dst_size % esize == 0 &&
+               btree_for_decode(src, src_size, dst, dst_size / esize, esize);
+    case BTREE_COMPRESS_DELTA:
+        return btree_int_element_size(esize) && dst_size % esize == 0 &&
+               btree_delta_decode(src, src_size, dst, dst_size / esize, esize);
+    default:
+        return false;
+    }
 }
 
 /**
@@ -561,7 +2179,7 @@ void btree_memory_prefetch(const void *addr, size_t size) {
  * @brief 현재 메모리 사용량 반환
  */
 size_t btree_memory_get_usage(void) {
-    return atomic_load(&g_memory_stats.current_usage);
+    return btree_memory_sum_usage();
 }
 
 /**
@@ -570,10 +2188,15 @@ size_t btree_memory_get_usage(void) {
 void btree_memory_print_stats(FILE *output) {
     if (!output) return;
     
-    size_t total_allocated = atomic_load(&g_memory_stats.total_allocated);
-    size_t total_freed = atomic_load(&g_memory_stats.total_freed);
-    size_t current_usage = atomic_load(&g_memory_stats.current_usage);
-    size_t peak_usage = atomic_load(&g_memory_stats.peak_usage);
+    size_t total_allocated = 0;
+    size_t total_freed = 0;
+    for (int i = 0; i < BTREE_MEMORY_STAT_SHARDS; i++) {
+        total_allocated += atomic_load_relaxed(&g_memory_shards[i].total_allocated);
+        total_freed += atomic_load_relaxed(&g_memory_shards[i].total_freed);
+    }
+    size_t current_usage = btree_memory_sum_usage();
+    size_t peak_usage = atomic_load_relaxed(&g_memory_peak);
+    if (current_usage > peak_usage) peak_usage = current_usage;
     
     fprintf(output, "Memory Statistics:\n");
     fprintf(output, "  Total Allocated: %zu bytes\n", total_allocated);
@@ -588,8 +2211,7 @@ void btree_memory_print_stats(FILE *output) {
  * @brief 메모리 누수 확인
  */
 bool btree_memory_check_leaks(void) {
-    size_t current_usage = atomic_load(&g_memory_stats.current_usage);
-    return current_usage > 0;
+    return btree_memory_sum_usage() > 0;
 }
 
 /**
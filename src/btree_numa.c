@@ -0,0 +1,276 @@
+/**
+ * @file btree_numa.c
+ * @brief NUMA 소켓별 상위 레벨 복제 (BTREE_NUMA_SUPPORT)
+ *
+ * 루트 쪽 몇 레벨은 작고 거의 읽기만 하지만 모든 검색이 지나간다. 이 레벨의
+ * 키와 자식 포인터를 NUMA 노드마다 그 노드 메모리에 복사해 두면 검색은 자기
+ * 소켓의 복제 루트부터 내려가고 복제 구간 아래에서 원본 노드로 넘어간다.
+ * 복제 노드는 키만 가지며, 키를 찾으면 parent에 둔 원본에서 값과 삭제 표시를
+ * 읽는다.
+ *
+ * 원본 노드에는 replicated를 표시하고, 표시된 노드의 슬롯이 바뀌거나 노드가
+ * 해제되면 (btree_replica_touch, btree_replica_forget) 복제본 전체를 무효로
+ * 한다. 루트가 바뀐 것은 복제할 때의 루트와 비교해 안다. 삽입과 삭제는 끝날
+ * 때 무효인 복제본을 다시 만든다. 리프의 부모 레벨은 리프 분할마다 바뀌므로
+ * 복제하지 않는다.
+ */
+
+#include "btree_internal.h"
+#include <string.h>
+
+#ifndef BTREE_NUMA_SUPPORT
+
+/* NUMA 지원 없이 빌드하면 복제하지 않음 (검색은 늘 원본 루트부터) */
+
+btree_result_t btree_numa_replicate(btree_t *tree, int levels) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (levels == 0) return BTREE_SUCCESS;
+    return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+}
+
+int btree_numa_replicated_levels(const btree_t *tree) {
+    (void)tree;
+    return 0;
+}
+
+#else
+
+/* 복제 상태 (tree->numa) */
+typedef struct {
+    int levels;                         /* 요청한 복제 레벨 수 */
+    bool stale;                         /* 원본이 바뀌어 다시 만들어야 함 */
+    btree_node_t *source_root;          /* 복제할 때의 루트 */
+    int node_count;                     /* NUMA 노드 수 */
+    btree_node_t **roots;               /* 노드별 복제 루트 (복제본이 없으면 NULL) */
+    void **blocks;                      /* 노드별 복제 블록 (btree_numa_alloc_onnode) */
+    btree_node_t **sources;             /* replicated를 표시한 원본 (BFS 순서, 해제되면 NULL) */
+    size_t source_count;                /* sources에 든 노드 수 */
+    size_t source_capacity;             /* sources 용량 */
+} btree_replica_t;
+
+/* 복제본을 버리고 원본 표시를 지움 */
+static void btree_replica_drop(btree_t *tree, btree_replica_t *rep) {
+    (void)tree;
+    for (size_t i = 0; i < rep->source_count; i++) {
+        if (rep->sources[i]) rep->sources[i]->replicated = 0;
+    }
+    rep->source_count = 0;
+    for (int i = 0; i < rep->node_count; i++) {
+        btree_numa_free(rep->blocks[i]);
+        rep->blocks[i] = NULL;
+        rep->roots[i] = NULL;
+    }
+    rep->source_root = NULL;
+}
+
+/* sources 끝에 원본 추가 (공간이 모자라면 두 배로 늘림) */
+static bool btree_replica_push(btree_t *tree, btree_replica_t *rep, btree_node_t *node) {
+    if (rep->source_count == rep->source_capacity) {
+        size_t capacity = rep->source_capacity ? rep->source_capacity * 2 : 16;
+        btree_node_t **grown = tree->allocator->realloc(rep->sources,
+                                                        capacity * sizeof(btree_node_t*));
+        if (!grown) return false;
+        rep->sources = grown;
+        rep->source_capacity = capacity;
+    }
+    rep->sources[rep->source_count++] = node;
+    return true;
+}
+
+/* 복제 노드 하나의 크기 (머리, 키, 자식 배열을 캐시 라인 단위로) */
+static size_t btree_replica_stride(const btree_t *tree, size_t capacity) {
+    return btree_align_size(sizeof(btree_node_t), BTREE_CACHE_LINE_SIZE) +
+           btree_align_size(capacity * tree->key_type.key_size, BTREE_CACHE_LINE_SIZE) +
+           btree_align_size((capacity + 1) * sizeof(btree_node_t*), BTREE_CACHE_LINE_SIZE);
+}
+
+/* block 안의 index번째 복제 노드 */
+static btree_node_t* btree_replica_at(void *block, size_t stride, size_t index) {
+    return (btree_node_t*)((char*)block + stride * index);
+}
+
+/**
+ * @brief 상위 levels 레벨을 NUMA 노드마다 복제
+ *
+ * 원본을 BFS 순서로 모으면 한 노드의 자식은 다음 레벨에 이어서 놓이므로,
+ * 복제 노드의 자식 위치는 앞에서부터 자식 수를 더해 가며 정해진다.
+ */
+static btree_result_t btree_replica_build(btree_t *tree, btree_replica_t *rep) {
+    btree_replica_drop(tree, rep);
+    rep->stale = false;
+    rep->source_root = tree->root;
+
+    int levels = rep->levels;
+    if (levels > tree->height - 2) levels = tree->height - 2;
+    if (levels <= 0 || !tree->root) return BTREE_SUCCESS;
+
+    /* 복제 구간의 원본을 레벨 순서로 모음 */
+    size_t level_end[BTREE_MAX_HEIGHT];
+    size_t capacity = 0;
+    if (!btree_replica_push(tree, rep, tree->root)) goto fail;
+    for (int level = 0; level < levels; level++) {
+        size_t begin = level > 0 ? level_end[level - 1] : 0;
+        level_end[level] = rep->source_count;
+        for (size_t i = begin; i < level_end[level]; i++) {
+            btree_node_t *node = rep->sources[i];
+            if (node->capacity > capacity) capacity = node->capacity;
+            if (level + 1 == levels) continue;
+            for (int c = 0; c <= node->num_keys; c++) {
+                if (!btree_replica_push(tree, rep, node->children[c])) goto fail;
+            }
+        }
+    }
+
+    size_t stride = btree_replica_stride(tree, capacity);
+    size_t header = btree_align_size(sizeof(btree_node_t), BTREE_CACHE_LINE_SIZE);
+    size_t keys_size = btree_align_size(capacity * tree->key_type.key_size, BTREE_CACHE_LINE_SIZE);
+    size_t count = rep->source_count;
+
+    for (int n = 0; n < rep->node_count; n++) {
+        void *block = btree_numa_alloc_onnode(stride * count, n);
+        if (!block) goto fail;
+        rep->blocks[n] = block;
+
+        size_t next_child = 1;
+        int level = 0;
+        for (size_t i = 0; i < count; i++) {
+            const btree_node_t *source = rep->sources[i];
+            btree_node_t *copy = btree_replica_at(block, stride, i);
+            while (i >= level_end[level]) level++;
+
+            memset(copy, 0, sizeof(btree_node_t));
+            copy->is_replica = 1;
+            copy->num_keys = source->num_keys;
+            copy->capacity = source->capacity;
+            copy->keys = (char*)copy + header;
+            copy->children = (btree_node_t**)((char*)copy + header + keys_size);
+            copy->parent = (btree_node_t*)source;
+            memcpy(copy->keys, source->keys, source->num_keys * tree->key_type.key_size);
+
+            for (int c = 0; c <= source->num_keys; c++) {
+                copy->children[c] = level + 1 < levels
+                                  ? btree_replica_at(block, stride, next_child + c)
+                                  : source->children[c];
+            }
+            if (level + 1 < levels) next_child += source->num_keys + 1;
+        }
+        rep->roots[n] = btree_replica_at(block, stride, 0);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        rep->sources[i]->replicated = 1;
+    }
+    return BTREE_SUCCESS;
+
+fail:
+    rep->source_count = 0;
+    btree_replica_drop(tree, rep);
+    return BTREE_ERROR_MEMORY_ALLOCATION;
+}
+
+/**
+ * @brief 상위 레벨 복제 설정 (levels가 0이면 해제)
+ */
+btree_result_t btree_numa_replicate(btree_t *tree, int levels) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (levels < 0) {
+        return btree_set_error(BTREE_ERROR_INVALID_SIZE), BTREE_ERROR_INVALID_SIZE;
+    }
+    if (levels == 0) {
+        btree_replica_release(tree);
+        return BTREE_SUCCESS;
+    }
+    /* 잠금 없는 읽기, 스냅숏 공유, 매핑과 디스크 할당자의 노드는 복제하지 않음 */
+    if (btree_is_concurrent(tree) || btree_is_mapped(tree) ||
+        (tree->flags & BTREE_FLAG_SHARED) || tree->allocator->access) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_replica_t *rep = tree->numa;
+    if (!rep) {
+        rep = tree->allocator->alloc(sizeof(btree_replica_t));
+        if (!rep) {
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        memset(rep, 0, sizeof(btree_replica_t));
+        rep->node_count = btree_numa_node_count();
+        rep->roots = tree->allocator->alloc(rep->node_count * sizeof(btree_node_t*));
+        rep->blocks = tree->allocator->alloc(rep->node_count * sizeof(void*));
+        if (!rep->roots || !rep->blocks) {
+            tree->allocator->free(rep->roots);
+            tree->allocator->free(rep->blocks);
+            tree->allocator->free(rep);
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        memset(rep->roots, 0, rep->node_count * sizeof(btree_node_t*));
+        memset(rep->blocks, 0, rep->node_count * sizeof(void*));
+        tree->numa = rep;
+    }
+
+    rep->levels = levels;
+    btree_result_t result = btree_replica_build(tree, rep);
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 지금 검색이 쓰는 복제 레벨 수 (복제본이 없거나 무효면 0)
+ */
+int btree_numa_replicated_levels(const btree_t *tree) {
+    if (!tree || !tree->numa) return 0;
+
+    const btree_replica_t *rep = tree->numa;
+    if (rep->stale || !rep->roots[0] || rep->source_root != tree->root) return 0;
+
+    int levels = 0;
+    for (const btree_node_t *node = rep->roots[0]; node->is_replica; node = node->children[0]) {
+        levels++;
+    }
+    return levels;
+}
+
+void btree_numa_invalidate(const btree_t *tree, const btree_node_t *node, bool freed) {
+    btree_replica_t *rep = tree->numa;
+    if (!rep) return;
+
+    rep->stale = true;
+    if (!freed) return;
+    for (size_t i = 0; i < rep->source_count; i++) {
+        if (rep->sources[i] == node) {
+            rep->sources[i] = NULL;
+            break;
+        }
+    }
+}
+
+void btree_numa_sync(btree_t *tree) {
+    btree_replica_t *rep = tree->numa;
+    if (rep->stale || rep->source_root != tree->root) {
+        btree_replica_build(tree, rep);
+    }
+}
+
+void btree_numa_release(btree_t *tree) {
+    btree_replica_t *rep = tree->numa;
+    btree_replica_drop(tree, rep);
+    tree->allocator->free(rep->sources);
+    tree->allocator->free(rep->roots);
+    tree->allocator->free(rep->blocks);
+    tree->allocator->free(rep);
+    tree->numa = NULL;
+}
+
+btree_node_t* btree_numa_root(const btree_t *tree) {
+    const btree_replica_t *rep = tree->numa;
+    if (rep->stale || rep->source_root != tree->root) return tree->root;
+
+    int node = btree_numa_current_node();
+    if (node >= rep->node_count) node = 0;
+    return rep->roots[node] ? rep->roots[node] : tree->root;
+}
+
+#endif /* BTREE_NUMA_SUPPORT */
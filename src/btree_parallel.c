@@ -0,0 +1,406 @@
+/**
+ * @file btree_parallel.c
+ * @brief 작업 훔치기 스레드 풀과 병렬 범위 순회/집계
+ *
+ * 작업 풀은 [0, count) 작업 번호를 스레드마다 연속 구간으로 나눠 준다. 구간은
+ * [begin, end)를 64비트 하나에 담아 CAS로만 바꾸며, 주인은 앞에서 하나씩 꺼내고
+ * 일이 떨어진 스레드는 남의 구간 뒤쪽 절반을 가져간다. 작업은 새로 생기지 않고
+ * 옮겨질 뿐이므로, 한 바퀴 둘러봐서 훔칠 것이 없는 스레드는 끝내도 된다.
+ *
+ * 범위 순회는 루트부터 내부 노드의 구분 키에서 잘라 서로 겹치지 않는 서브트리
+ * 조각을 만든 뒤 조각 하나를 작업 하나로 돌린다. 표준 B-Tree는 구분 키도
+ * 항목이므로 앞 조각의 끝에 붙인다.
+ */
+
+#include "btree_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(BTREE_PLATFORM_WINDOWS) || !(defined(__GNUC__) || defined(__clang__))
+
+/* 이 플랫폼에서는 스레드를 만들지 않고 호출한 스레드에서 차례로 실행 */
+
+int btree_parallel_threads(int requested) {
+    (void)requested;
+    return 1;
+}
+
+void btree_parallel_for(size_t count, int workers, btree_task_func_t func, void *context) {
+    (void)workers;
+    for (size_t i = 0; i < count; i++) {
+        func(context, i, 0);
+    }
+}
+
+#define btree_scan_load(ptr) (*(ptr))
+#define btree_scan_store(ptr, val) (*(ptr) = (val))
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define btree_scan_load(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define btree_scan_store(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+
+/* 스레드별 남은 구간 (하위 32비트 begin, 상위 32비트 end, 캐시 라인 하나씩) */
+typedef struct {
+    uint64_t range;
+    char pad[BTREE_CACHE_LINE_SIZE - sizeof(uint64_t)];
+} btree_steal_slot_t;
+
+typedef struct {
+    btree_task_func_t func;
+    void *context;
+    int workers;
+    btree_steal_slot_t slots[BTREE_PARALLEL_MAX_THREADS];
+} btree_pool_t;
+
+/* 작업 스레드 인자 */
+typedef struct {
+    btree_pool_t *pool;
+    int worker;
+} btree_pool_worker_t;
+
+static inline uint64_t btree_range_pack(uint64_t begin, uint64_t end) {
+    return (end << 32) | begin;
+}
+
+/* 자기 구간 앞에서 하나 꺼냄 (비었으면 false) */
+static bool btree_pool_pop(btree_steal_slot_t *slot, size_t *index) {
+    uint64_t range = __atomic_load_n(&slot->range, __ATOMIC_ACQUIRE);
+    for (;;) {
+        uint64_t begin = range & 0xFFFFFFFFu, end = range >> 32;
+        if (begin >= end) return false;
+        if (__atomic_compare_exchange_n(&slot->range, &range, btree_range_pack(begin + 1, end),
+                                        true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = (size_t)begin;
+            return true;
+        }
+    }
+}
+
+/* 다른 스레드 구간의 뒤쪽 절반을 가져와 첫 작업을 꺼냄 (훔칠 것이 없으면 false) */
+static bool btree_pool_steal(btree_pool_t *pool, int worker, size_t *index) {
+    for (int k = 1; k < pool->workers; k++) {
+        btree_steal_slot_t *victim = &pool->slots[(worker + k) % pool->workers];
+        uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+        for (;;) {
+            uint64_t begin = range & 0xFFFFFFFFu, end = range >> 32;
+            if (begin >= end) break;
+            uint64_t mid = begin + (end - begin) / 2;
+            if (__atomic_compare_exchange_n(&victim->range, &range, btree_range_pack(begin, mid),
+                                            true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                /* 비어 있던 자기 구간에 나머지를 둠 (다른 스레드는 빈 구간을 건드리지 않음) */
+                __atomic_store_n(&pool->slots[worker].range, btree_range_pack(mid + 1, end),
+                                 __ATOMIC_RELEASE);
+                *index = (size_t)mid;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void btree_pool_run(btree_pool_t *pool, int worker) {
+    size_t index;
+    for (;;) {
+        while (btree_pool_pop(&pool->slots[worker], &index)) {
+            pool->func(pool->context, index, worker);
+        }
+        if (!btree_pool_steal(pool, worker, &index)) return;
+        pool->func(pool->context, index, worker);
+    }
+}
+
+static void* btree_pool_thread(void *arg) {
+    btree_pool_worker_t *self = arg;
+    btree_pool_run(self->pool, self->worker);
+    return NULL;
+}
+
+int btree_parallel_threads(int requested) {
+    if (requested <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        requested = online > 0 ? (int)(online < BTREE_PARALLEL_MAX_THREADS
+                                       ? online : BTREE_PARALLEL_MAX_THREADS) : 1;
+    }
+    return requested < BTREE_PARALLEL_MAX_THREADS ? requested : BTREE_PARALLEL_MAX_THREADS;
+}
+
+void btree_parallel_for(size_t count, int workers, btree_task_func_t func, void *context) {
+    if (workers > BTREE_PARALLEL_MAX_THREADS) workers = BTREE_PARALLEL_MAX_THREADS;
+    if ((size_t)workers > count) workers = (int)count;
+    if (workers <= 1 || count > 0xFFFFFFFFu) {
+        for (size_t i = 0; i < count; i++) {
+            func(context, i, 0);
+        }
+        return;
+    }
+
+    btree_pool_t pool;
+    pool.func = func;
+    pool.context = context;
+    pool.workers = workers;
+    for (int w = 0; w < workers; w++) {
+        pool.slots[w].range = btree_range_pack(count * (size_t)w / (size_t)workers,
+                                               count * (size_t)(w + 1) / (size_t)workers);
+    }
+
+    /* 만들지 못한 스레드의 구간은 나머지가 훔쳐 감 */
+    pthread_t threads[BTREE_PARALLEL_MAX_THREADS];
+    btree_pool_worker_t args[BTREE_PARALLEL_MAX_THREADS];
+    bool started[BTREE_PARALLEL_MAX_THREADS];
+    for (int w = 1; w < workers; w++) {
+        args[w].pool = &pool;
+        args[w].worker = w;
+        started[w] = pthread_create(&threads[w], NULL, btree_pool_thread, &args[w]) == 0;
+    }
+
+    btree_pool_run(&pool, 0);
+
+    for (int w = 1; w < workers; w++) {
+        if (started[w]) pthread_join(threads[w], NULL);
+    }
+}
+
+#endif
+
+/* 순회 조각: 서브트리 하나와 그 뒤의 구분 항목 (표준 B-Tree, 없으면 tail_node가 NULL) */
+typedef struct {
+    const btree_node_t *node;
+    const btree_node_t *tail_node;
+    int tail_index;
+} btree_scan_unit_t;
+
+/* 범위 순회 상태 (작업 사이에 공유) */
+typedef struct {
+    const btree_t *tree;
+    const void *min_key;
+    const void *max_key;
+    const btree_aggregate_t *aggregate;
+    btree_scan_unit_t *units;
+    char *states;                       /* 조각별 누적 상태 (stride 간격) */
+    size_t stride;
+    bool touch;                         /* 노드 접근 알림 (직렬로 돌 때만) */
+    int stopped;                        /* visit가 false를 반환함 */
+} btree_scan_t;
+
+/* key 이상인 첫 위치 (중복 키가 있으면 같은 키 구간의 처음) */
+static int btree_scan_lower(const btree_t *tree, const btree_node_t *node, const void *key) {
+    int pos = btree_node_search(tree, node, key);
+    if (pos < 0) return -(pos + 1);
+    while (pos > 0 &&
+           tree->key_type.compare(btree_get_key_ptr(node, pos - 1, &tree->key_type), key) == 0) {
+        pos--;
+    }
+    return pos;
+}
+
+/* key보다 큰 첫 위치 */
+static int btree_scan_upper(const btree_t *tree, const btree_node_t *node, const void *key) {
+    int pos = btree_node_search(tree, node, key);
+    if (pos < 0) return -(pos + 1);
+    while (pos < node->num_keys &&
+           tree->key_type.compare(btree_get_key_ptr(node, pos, &tree->key_type), key) == 0) {
+        pos++;
+    }
+    return pos;
+}
+
+/* 항목 하나 방문 (순회를 멈춰야 하면 false) */
+static bool btree_scan_entry(btree_scan_t *scan, const btree_node_t *node, int index,
+                             void *state) {
+    if (btree_scan_load(&scan->stopped)) return false;
+    if (btree_slot_is_dead(node, index)) return true;
+
+    const btree_t *tree = scan->tree;
+    const void *key = btree_get_key_ptr(node, index, &tree->key_type);
+    const void *value = btree_get_value_ptr(node, index, &tree->value_type);
+    if (!scan->aggregate->visit(key, value, state, scan->aggregate->context)) {
+        btree_scan_store(&scan->stopped, 1);
+        return false;
+    }
+    return true;
+}
+
+/* 서브트리의 범위 안 항목을 키 순서로 방문 (max_key를 넘었거나 멈추면 false) */
+static bool btree_scan_subtree(btree_scan_t *scan, const btree_node_t *node, void *state) {
+    const btree_t *tree = scan->tree;
+    bool entries = node->is_leaf || !btree_is_plus(tree);
+    if (scan->touch) btree_node_access(tree, node, false);
+
+    int i = scan->min_key ? btree_scan_lower(tree, node, scan->min_key) : 0;
+    for (; i <= node->num_keys; i++) {
+        if (!node->is_leaf && !btree_scan_subtree(scan, node->children[i], state)) return false;
+        if (i == node->num_keys) break;
+
+        const void *key = btree_get_key_ptr(node, i, &tree->key_type);
+        if (scan->max_key && tree->key_type.compare(key, scan->max_key) > 0) return false;
+        if (entries && !btree_scan_entry(scan, node, i, state)) return false;
+    }
+    return true;
+}
+
+static void btree_scan_task(void *context, size_t index, int worker) {
+    (void)worker;
+    btree_scan_t *scan = context;
+    const btree_scan_unit_t *unit = &scan->units[index];
+    void *state = scan->states ? scan->states + index * scan->stride : NULL;
+
+    if (!btree_scan_subtree(scan, unit->node, state) || !unit->tail_node) return;
+    if (scan->touch) btree_node_access(scan->tree, unit->tail_node, false);
+    btree_scan_entry(scan, unit->tail_node, unit->tail_index, state);
+}
+
+/* 조각 노드가 범위에 걸치는 자식 구간 [*lo, *hi] */
+static void btree_scan_children(const btree_scan_t *scan, const btree_node_t *node,
+                                int *lo, int *hi) {
+    *lo = scan->min_key ? btree_scan_lower(scan->tree, node, scan->min_key) : 0;
+    *hi = scan->max_key ? btree_scan_upper(scan->tree, node, scan->max_key) : node->num_keys;
+}
+
+/**
+ * @brief 범위를 target개 이상의 조각으로 나눔
+ *
+ * 조각을 레벨 단위로 자식들로 펼치며, 범위 밖 자식은 버린다. 표준 B-Tree에서
+ * 자식 사이의 구분 항목은 왼쪽 자식 조각의 꼬리가 되고, 펼친 조각의 꼬리는
+ * 마지막 자식이 물려받는다.
+ */
+static btree_result_t btree_scan_partition(btree_scan_t *scan, size_t target, size_t *out_count) {
+    const btree_t *tree = scan->tree;
+    size_t count = 1;
+    btree_scan_unit_t *units = tree->allocator->alloc(sizeof(btree_scan_unit_t));
+    if (!units) return BTREE_ERROR_MEMORY_ALLOCATION;
+    units[0].node = tree->root;
+    units[0].tail_node = NULL;
+    units[0].tail_index = 0;
+
+    bool tails = !btree_is_plus(tree);
+    while (count < target && !units[0].node->is_leaf) {
+        size_t next_count = 0;
+        for (size_t u = 0; u < count; u++) {
+            int lo, hi;
+            if (scan->touch) btree_node_access(tree, units[u].node, false);
+            btree_scan_children(scan, units[u].node, &lo, &hi);
+            next_count += (size_t)(hi - lo + 1);
+        }
+
+        btree_scan_unit_t *next = tree->allocator->alloc(next_count * sizeof(btree_scan_unit_t));
+        if (!next) {
+            tree->allocator->free(units);
+            return BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+
+        size_t n = 0;
+        for (size_t u = 0; u < count; u++) {
+            const btree_node_t *node = units[u].node;
+            int lo, hi;
+            btree_scan_children(scan, node, &lo, &hi);
+            for (int c = lo; c <= hi; c++) {
+                next[n].node = node->children[c];
+                next[n].tail_node = c < hi ? (tails ? node : NULL) : units[u].tail_node;
+                next[n].tail_index = c < hi ? c : units[u].tail_index;
+                n++;
+            }
+        }
+
+        tree->allocator->free(units);
+        units = next;
+        count = next_count;
+    }
+
+    scan->units = units;
+    *out_count = count;
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 범위의 항목을 여러 스레드로 나눠 집계
+ */
+btree_result_t btree_parallel_aggregate(btree_t *tree, const void *min_key, const void *max_key,
+                                        const btree_aggregate_t *aggregate, void *result,
+                                        int threads) {
+    if (!tree || !aggregate || !aggregate->visit ||
+        (aggregate->state_size > 0 && (!result || !aggregate->merge))) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (threads < 0) {
+        return btree_set_error(BTREE_ERROR_INVALID_SIZE), BTREE_ERROR_INVALID_SIZE;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    size_t state_size = aggregate->state_size;
+    if (state_size > 0) {
+        if (aggregate->init) {
+            aggregate->init(result, aggregate->context);
+        } else {
+            memset(result, 0, state_size);
+        }
+    }
+    if (!tree->root || tree->root->num_keys == 0 ||
+        (min_key && max_key && tree->key_type.compare(min_key, max_key) > 0)) {
+        return BTREE_SUCCESS;
+    }
+
+    /* 디스크 할당자의 접근 알림은 한 스레드에서만 부름 */
+    int workers = tree->allocator->access ? 1 : btree_parallel_threads(threads);
+
+    btree_scan_t scan;
+    memset(&scan, 0, sizeof(scan));
+    scan.tree = tree;
+    scan.min_key = min_key;
+    scan.max_key = max_key;
+    scan.aggregate = aggregate;
+    scan.touch = (workers == 1);
+
+    size_t count = 0;
+    btree_result_t status = btree_scan_partition(&scan, workers > 1 ? (size_t)workers * 8 : 1,
+                                                 &count);
+    if (status != BTREE_SUCCESS) {
+        return btree_set_error(status), status;
+    }
+
+    /* 조각별 상태는 캐시 라인 단위로 떨어뜨려 스레드끼리 같은 줄을 쓰지 않게 함 */
+    if (state_size > 0) {
+        scan.stride = btree_align_size(state_size, BTREE_CACHE_LINE_SIZE);
+        scan.states = tree->allocator->alloc(count * scan.stride);
+        if (!scan.states) {
+            tree->allocator->free(scan.units);
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        for (size_t i = 0; i < count; i++) {
+            void *state = scan.states + i * scan.stride;
+            if (aggregate->init) {
+                aggregate->init(state, aggregate->context);
+            } else {
+                memset(state, 0, state_size);
+            }
+        }
+    }
+
+    btree_parallel_for(count, workers, btree_scan_task, &scan);
+
+    /* 조각은 키 순서이므로 순서대로 합치면 결과가 직렬 순회와 같음 */
+    for (size_t i = 0; scan.states && i < count; i++) {
+        aggregate->merge(result, scan.states + i * scan.stride, aggregate->context);
+    }
+
+    if (scan.states) tree->allocator->free(scan.states);
+    tree->allocator->free(scan.units);
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 범위의 항목을 여러 스레드로 나눠 방문
+ */
+btree_result_t btree_parallel_scan(btree_t *tree, const void *min_key, const void *max_key,
+                                   btree_visit_func_t visit, void *context, int threads) {
+    btree_aggregate_t aggregate;
+    memset(&aggregate, 0, sizeof(aggregate));
+    aggregate.visit = visit;
+    aggregate.context = context;
+    return btree_parallel_aggregate(tree, min_key, max_key, &aggregate, NULL, threads);
+}
@@ -0,0 +1,1334 @@
+/**
+ * @file btree_persist.c
+ * @brief 페이지 파일 형식 직렬화와 읽기 전용 파일 매핑
+ *
+ * 이미지는 같은 크기의 페이지 배열이다. 앞쪽 페이지에 헤더가 있고 그 뒤에
+ * 노드가 너비 우선 순서로 한 페이지씩 놓인다. 자식은 포인터 대신 페이지 번호로
+ * 가리키므로 이미지를 어느 주소에 매핑해도 그대로 검색할 수 있다. 리프는 마지막
+ * 레벨에 연속으로 놓인다. 키와 값은 노드 슬롯의 바이트를 그대로 기록하므로
+ * 바이트 순서와 정렬은 저장한 플랫폼을 따른다 (헤더의 endian 표식으로 확인).
+ *
+ * 압축 이미지 (버전 2, BTREE_FILE_FLAG_COMPRESSED)는 내부 노드 페이지까지는
+ * 같고, 첫 리프 페이지 자리부터 리프마다 블롭 시작 위치를 적은 디렉터리
+ * (리프 수 + 1개의 uint64_t)와 블롭이 이어진다. 블롭은 리프의 키, 값, 삭제
+ * 표시 배열을 각각 btree_memory_compress(AUTO)로 압축한 것이다. 리프 페이지
+ * 번호는 그대로 쓰므로 내부 노드의 자식 번호와 리프 연결 규칙은 바뀌지 않고,
+ * 읽을 때 리프를 비압축 페이지와 같은 모양으로 풀어서 다룬다. 매핑된 압축
+ * 트리는 푼 리프를 작은 캐시 (CLOCK 교체)에 둔다.
+ */
+
+#include "btree_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(BTREE_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BTREE_PERSIST_MMAP 1
+#endif
+
+#define BTREE_FILE_MAGIC "BTREEPG1"
+#define BTREE_FILE_VERSION 1
+#define BTREE_FILE_VERSION_COMPRESSED 2
+#define BTREE_FILE_ENDIAN 0x01020304u
+#define BTREE_FILE_TYPE_NAME 32
+
+/* 헤더 플래그 */
+#define BTREE_FILE_FLAG_PLUS           0x01
+#define BTREE_FILE_FLAG_DUPLICATES     0x02
+#define BTREE_FILE_FLAG_LAZY_DELETE    0x04
+#define BTREE_FILE_FLAG_COMPRESSED     0x08
+
+/* 매핑된 압축 트리가 풀어 두는 리프 수 */
+#define BTREE_LEAF_CACHE_SLOTS 64
+
+/* 노드 종류별 페이지 레이아웃 (오프셋 0은 배열 없음) */
+typedef struct {
+    uint32_t capacity;                  /* 최대 키 수 */
+    uint32_t keys_offset;               /* 키 배열 */
+    uint32_t children_offset;           /* 자식 페이지 번호 배열 (uint64_t) */
+    uint32_t values_offset;             /* 값 배열 */
+    uint32_t tombstones_offset;         /* 삭제 표시 배열 */
+} btree_page_layout_t;
+
+/* 파일 헤더 (첫 페이지부터 기록) */
+typedef struct {
+    char magic[8];                      /* "BTREEPG1" */
+    uint32_t version;                   /* 형식 버전 */
+    uint32_t endian;                    /* BTREE_FILE_ENDIAN */
+    uint32_t header_size;               /* sizeof(btree_file_header_t) */
+    uint32_t page_size;                 /* 페이지 크기 (캐시 라인 배수) */
+    uint32_t flags;                     /* BTREE_FILE_FLAG_* */
+    int32_t degree;                     /* 트리 차수 */
+    int32_t height;                     /* 트리 높이 */
+    uint32_t key_size;                  /* 키 크기 */
+    uint32_t value_size;                /* 값 크기 */
+    uint32_t reserved;
+    uint64_t key_count;                 /* 키 수 (삭제 표시 제외) */
+    uint64_t dead_count;                /* 삭제 표시 수 */
+    uint64_t page_count;                /* 헤더 페이지를 포함한 전체 페이지 수 */
+    uint64_t root_page;                 /* 루트 페이지 (0: 빈 트리) */
+    uint64_t first_leaf_page;           /* 첫 리프 페이지 (0: 빈 트리) */
+    uint64_t log_id;                    /* 이어지는 로그 식별자 (0: 없음) */
+    uint64_t log_lsn;                   /* 이미지에 반영된 마지막 로그 LSN */
+    btree_page_layout_t layouts[2];     /* [0] 내부 노드, [1] 리프 */
+    char key_type_name[BTREE_FILE_TYPE_NAME];
+    char value_type_name[BTREE_FILE_TYPE_NAME];
+    uint32_t checksum;                  /* checksum 앞까지의 FNV-1a */
+    uint32_t padding;
+} btree_file_header_t;
+
+/* 노드 페이지 머리 (페이지 번호 0은 없음을 뜻함) */
+typedef struct {
+    uint32_t is_leaf;
+    uint32_t num_keys;
+    uint64_t next_leaf;
+    uint64_t prev_leaf;
+} btree_page_header_t;
+
+/* 압축 리프 블롭 머리 (뒤에 키, 값, 삭제 표시 스트림이 이어짐) */
+typedef struct {
+    uint32_t num_keys;
+    uint8_t key_codec;                  /* BTREE_COMPRESS_* */
+    uint8_t value_codec;
+    uint8_t tombstone_codec;
+    uint8_t reserved;
+    uint32_t key_bytes;                 /* 스트림별 압축 크기 */
+    uint32_t value_bytes;
+    uint32_t tombstone_bytes;
+} btree_leaf_blob_t;
+
+/* 풀어 둔 리프 (page_no가 0이면 빈 칸) */
+typedef struct {
+    uint64_t page_no;
+    unsigned char *page;                /* 비압축 리프 페이지 모양 */
+    int referenced;                     /* CLOCK 참조 비트 */
+} btree_leaf_slot_t;
+
+/* 매핑 상태 (tree->storage) */
+typedef struct {
+    const unsigned char *base;          /* 이미지 시작 */
+    size_t size;                        /* 이미지 크기 */
+    int mapped;                         /* 1: mmap, 0: 힙 사본 */
+
+    /* 압축 이미지의 리프 캐시 (비압축 이미지는 NULL, lock 보호) */
+    btree_leaf_slot_t *cache;           /* BTREE_LEAF_CACHE_SLOTS칸 */
+    unsigned char *cache_pages;         /* 칸마다 페이지 하나 */
+    size_t clock;                       /* 다음 교체 후보 */
+    size_t cache_hits;
+    size_t cache_misses;
+    int lock;                           /* 스핀락 */
+} btree_storage_t;
+
+#if defined(__GNUC__) || defined(__clang__)
+static void btree_storage_lock(int *lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+    }
+}
+
+static void btree_storage_unlock(int *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+#else
+/* 원자 연산이 없으면 매핑된 압축 트리를 한 스레드에서만 검색 */
+static void btree_storage_lock(int *lock) { (void)lock; }
+static void btree_storage_unlock(int *lock) { (void)lock; }
+#endif
+
+/* 열어 둔 이미지 해제 (매핑 또는 힙 사본) */
+static void btree_storage_close(const btree_storage_t *storage) {
+#ifdef BTREE_PERSIST_MMAP
+    if (storage->mapped) {
+        munmap((void*)storage->base, storage->size);
+        return;
+    }
+#endif
+    free((void*)storage->base);
+}
+
+/* 이미지 출력 함수 (버퍼 복사 또는 파일 쓰기) */
+typedef bool (*btree_page_sink_t)(void *ctx, const void *data, size_t size);
+
+/* 헤더 체크섬 (checksum 앞까지) */
+static uint32_t btree_file_checksum(const btree_file_header_t *header) {
+    return btree_checksum(header, offsetof(btree_file_header_t, checksum), BTREE_CHECKSUM_SEED);
+}
+
+/* 노드 종류별 페이지 레이아웃 계산, 사용하는 바이트 수 반환 */
+static size_t btree_page_layout(const btree_t *tree, bool is_leaf, btree_page_layout_t *layout) {
+    size_t key_align = tree->key_type.alignment;
+    size_t value_align = tree->value_type.alignment;
+
+    if (!btree_is_power_of_two(key_align)) key_align = sizeof(void*);
+    if (!btree_is_power_of_two(value_align)) value_align = sizeof(void*);
+
+    size_t capacity = (size_t)btree_node_capacity_for(tree, is_leaf);
+    size_t offset = btree_align_size(sizeof(btree_page_header_t), key_align);
+
+    memset(layout, 0, sizeof(*layout));
+    layout->capacity = (uint32_t)capacity;
+    layout->keys_offset = (uint32_t)offset;
+    offset += capacity * tree->key_type.key_size;
+
+    if (!is_leaf) {
+        offset = btree_align_size(offset, sizeof(uint64_t));
+        layout->children_offset = (uint32_t)offset;
+        offset += (capacity + 1) * sizeof(uint64_t);
+    }
+    if (btree_node_has_values(tree, is_leaf) && tree->value_type.value_size > 0) {
+        offset = btree_align_size(offset, value_align);
+        layout->values_offset = (uint32_t)offset;
+        offset += capacity * tree->value_type.value_size;
+    }
+    if (tree->flags & BTREE_FLAG_LAZY_DELETE) {
+        layout->tombstones_offset = (uint32_t)offset;
+        offset += capacity;
+    }
+    return offset;
+}
+
+/* 타입 이름 기록 (잘리는 이름도 NUL로 끝남) */
+static void btree_copy_type_name(char *dst, const char *name) {
+    memset(dst, 0, BTREE_FILE_TYPE_NAME);
+    if (name) strncpy(dst, name, BTREE_FILE_TYPE_NAME - 1);
+}
+
+/* 헤더 구성 (페이지 수는 호출자가 채움) */
+static void btree_file_header_build(const btree_t *tree, btree_file_header_t *header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, BTREE_FILE_MAGIC, sizeof(header->magic));
+    header->version = BTREE_FILE_VERSION;
+    header->endian = BTREE_FILE_ENDIAN;
+    header->header_size = (uint32_t)sizeof(btree_file_header_t);
+
+    size_t internal_end = btree_page_layout(tree, false, &header->layouts[0]);
+    size_t leaf_end = btree_page_layout(tree, true, &header->layouts[1]);
+    size_t page_end = internal_end > leaf_end ? internal_end : leaf_end;
+    header->page_size = (uint32_t)btree_align_size(page_end, BTREE_CACHE_LINE_SIZE);
+
+    if (btree_is_plus(tree)) header->flags |= BTREE_FILE_FLAG_PLUS;
+    if (tree->flags & BTREE_FLAG_ALLOW_DUPLICATES) header->flags |= BTREE_FILE_FLAG_DUPLICATES;
+    if (tree->flags & BTREE_FLAG_LAZY_DELETE) header->flags |= BTREE_FILE_FLAG_LAZY_DELETE;
+
+    header->degree = tree->degree;
+    header->height = tree->height;
+    header->key_size = (uint32_t)tree->key_type.key_size;
+    header->value_size = (uint32_t)tree->value_type.value_size;
+    header->key_count = tree->key_count;
+    header->dead_count = tree->dead_count;
+    btree_copy_type_name(header->key_type_name, tree->key_type.type_name);
+    btree_copy_type_name(header->value_type_name, tree->value_type.type_name);
+}
+
+/* 헤더가 차지하는 페이지 수 */
+static size_t btree_file_header_pages(size_t page_size) {
+    return (sizeof(btree_file_header_t) + page_size - 1) / page_size;
+}
+
+/* 이미지로 저장할 수 있는 트리인지 확인 */
+static btree_result_t btree_persist_check(const btree_t *tree) {
+    if (btree_is_concurrent(tree) || btree_is_mapped(tree)) return BTREE_ERROR_INVALID_OPERATION;
+    /* 포인터는 다른 프로세스에서 의미가 없음 */
+    if (btree_type_is_pointer(&tree->key_type) || btree_type_is_pointer(&tree->value_type)) {
+        return BTREE_ERROR_TYPE_MISMATCH;
+    }
+    return BTREE_SUCCESS;
+}
+
+/* 노드 하나를 페이지로 기록 (first_child: 첫 자식의 페이지 번호) */
+static void btree_page_write(const btree_t *tree, const btree_file_header_t *header,
+                             const btree_node_t *node, uint64_t first_child,
+                             uint64_t prev_leaf, uint64_t next_leaf, unsigned char *page) {
+    const btree_page_layout_t *layout = &header->layouts[node->is_leaf ? 1 : 0];
+    btree_page_header_t *ph = (btree_page_header_t*)page;
+    size_t n = (size_t)node->num_keys;
+
+    memset(page, 0, header->page_size);
+    ph->is_leaf = node->is_leaf ? 1 : 0;
+    ph->num_keys = (uint32_t)n;
+    ph->prev_leaf = prev_leaf;
+    ph->next_leaf = next_leaf;
+
+    memcpy(page + layout->keys_offset, node->keys, n * tree->key_type.key_size);
+    if (layout->children_offset) {
+        uint64_t *children = (uint64_t*)(page + layout->children_offset);
+        for (size_t c = 0; c <= n; c++) {
+            children[c] = first_child + c;
+        }
+    }
+    if (layout->values_offset && node->values) {
+        memcpy(page + layout->values_offset, node->values, n * tree->value_type.value_size);
+    }
+    if (layout->tombstones_offset && node->tombstones) {
+        memcpy(page + layout->tombstones_offset, node->tombstones, n);
+    }
+}
+
+/* 압축 리프 묶음 (블롭을 이어 붙인 버퍼와 리프별 블롭 시작 위치, data는 malloc) */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    uint64_t *offsets;                  /* 리프 수 + 1 */
+    size_t count;                       /* 추가한 리프 수 */
+} btree_leaf_pack_t;
+
+/* 스트림 하나 압축 (AUTO가 고른 방식이 원본보다 크지 않으므로 용량은 원본 크기) */
+static bool btree_leaf_stream(const unsigned char *src, size_t size, uint32_t element_size,
+                              unsigned char *dst, uint8_t *codec, uint32_t *bytes) {
+    btree_compression_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.algorithm = BTREE_COMPRESS_AUTO;
+    info.element_size = element_size;
+
+    size_t used = size;
+    if (!btree_memory_compress(src, size, dst, &used, &info)) return false;
+    *codec = (uint8_t)info.algorithm;
+    *bytes = (uint32_t)used;
+    return true;
+}
+
+/* 리프 페이지를 블롭으로 압축해 묶음 끝에 추가 */
+static bool btree_leaf_pack_add(const btree_file_header_t *header, const unsigned char *page,
+                                btree_leaf_pack_t *pack) {
+    const btree_page_layout_t *layout = &header->layouts[1];
+    size_t n = ((const btree_page_header_t*)page)->num_keys;
+    size_t key_raw = n * header->key_size;
+    size_t value_raw = layout->values_offset ? n * header->value_size : 0;
+    size_t tombstone_raw = layout->tombstones_offset ? n : 0;
+    size_t need = sizeof(btree_leaf_blob_t) + key_raw + value_raw + tombstone_raw;
+
+    if (pack->capacity - pack->size < need) {
+        size_t capacity = pack->capacity ? pack->capacity * 2 : header->page_size * 16;
+        if (capacity < pack->size + need) capacity = pack->size + need;
+        unsigned char *grown = realloc(pack->data, capacity);
+        if (!grown) return false;
+        pack->data = grown;
+        pack->capacity = capacity;
+    }
+
+    btree_leaf_blob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    blob.num_keys = (uint32_t)n;
+    unsigned char *out = pack->data + pack->size + sizeof(blob);
+    if (!btree_leaf_stream(page + layout->keys_offset, key_raw, header->key_size, out,
+                           &blob.key_codec, &blob.key_bytes)) {
+        return false;
+    }
+    out += blob.key_bytes;
+    if (value_raw && !btree_leaf_stream(page + layout->values_offset, value_raw,
+                                        header->value_size, out,
+                                        &blob.value_codec, &blob.value_bytes)) {
+        return false;
+    }
+    out += blob.value_bytes;
+    if (tombstone_raw && !btree_leaf_stream(page + layout->tombstones_offset, tombstone_raw, 1,
+                                            out, &blob.tombstone_codec, &blob.tombstone_bytes)) {
+        return false;
+    }
+
+    memcpy(pack->data + pack->size, &blob, sizeof(blob));
+    pack->offsets[pack->count++] = pack->size;
+    pack->size += sizeof(blob) + blob.key_bytes + blob.value_bytes + blob.tombstone_bytes;
+    return true;
+}
+
+/**
+ * @brief 트리 전체를 페이지 이미지로 출력
+ *
+ * 노드를 너비 우선으로 나열하면 각 노드의 자식은 큐에서 연속된 구간이므로
+ * 첫 자식의 페이지 번호만 따라가면 된다. 리프를 압축하면 블롭을 모두 만든
+ * 뒤에 디렉터리와 함께 내보낸다.
+ */
+static btree_result_t btree_persist_write(const btree_t *tree, btree_page_sink_t sink,
+                                          void *ctx, uint64_t log_id, uint64_t log_lsn) {
+    btree_result_t result = btree_persist_check(tree);
+    if (result != BTREE_SUCCESS) return result;
+
+    btree_file_header_t header;
+    btree_file_header_build(tree, &header);
+    header.log_id = log_id;
+    header.log_lsn = log_lsn;
+    size_t page_size = header.page_size;
+    size_t header_pages = btree_file_header_pages(page_size);
+
+    /* 너비 우선 순서 */
+    const btree_node_t **queue = NULL;
+    size_t count = 0;
+    if (tree->root) {
+        queue = tree->allocator->alloc(tree->node_count * sizeof(btree_node_t*));
+        if (!queue) return BTREE_ERROR_MEMORY_ALLOCATION;
+        queue[count++] = tree->root;
+        for (size_t i = 0; i < count; i++) {
+            const btree_node_t *node = queue[i];
+            if (node->is_leaf) continue;
+            for (int c = 0; c <= node->num_keys; c++) {
+                if (count >= tree->node_count) {
+                    tree->allocator->free(queue);
+                    return BTREE_ERROR_INVALID_OPERATION;
+                }
+                queue[count++] = node->children[c];
+            }
+        }
+    }
+
+    header.page_count = header_pages + count;
+    size_t leaf_index = count;
+    if (count > 0) {
+        header.root_page = header_pages;
+        for (size_t i = 0; i < count; i++) {
+            if (queue[i]->is_leaf) {
+                header.first_leaf_page = header_pages + i;
+                leaf_index = i;
+                break;
+            }
+        }
+    }
+    bool compressed = (tree->flags & BTREE_FLAG_COMPRESS_LEAVES) && count > 0;
+    if (compressed) {
+        header.version = BTREE_FILE_VERSION_COMPRESSED;
+        header.flags |= BTREE_FILE_FLAG_COMPRESSED;
+    }
+    header.checksum = btree_file_checksum(&header);
+
+    size_t buffer_size = header_pages * page_size;
+    unsigned char *page = tree->allocator->alloc(buffer_size);
+    btree_leaf_pack_t pack;
+    memset(&pack, 0, sizeof(pack));
+    if (compressed) pack.offsets = tree->allocator->alloc((count - leaf_index + 1) * sizeof(uint64_t));
+    if (!page || (compressed && !pack.offsets)) {
+        if (page) tree->allocator->free(page);
+        if (queue) tree->allocator->free(queue);
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    memset(page, 0, buffer_size);
+    memcpy(page, &header, sizeof(header));
+    result = sink(ctx, page, buffer_size) ? BTREE_SUCCESS : BTREE_ERROR_IO;
+
+    uint64_t next_child = header_pages + 1;
+    for (size_t i = 0; i < count && result == BTREE_SUCCESS; i++) {
+        const btree_node_t *node = queue[i];
+        uint64_t page_no = header_pages + i;
+        uint64_t prev_leaf = 0, next_leaf = 0;
+
+        if (node->is_leaf) {
+            if (i > 0 && queue[i - 1]->is_leaf) prev_leaf = page_no - 1;
+            if (i + 1 < count) next_leaf = page_no + 1;
+        }
+        btree_page_write(tree, &header, node, next_child, prev_leaf, next_leaf, page);
+        if (!node->is_leaf) next_child += (uint64_t)node->num_keys + 1;
+
+        if (compressed && node->is_leaf) {
+            if (!btree_leaf_pack_add(&header, page, &pack)) {
+                result = BTREE_ERROR_MEMORY_ALLOCATION;
+            }
+        } else if (!sink(ctx, page, page_size)) {
+            result = BTREE_ERROR_IO;
+        }
+    }
+
+    if (compressed && result == BTREE_SUCCESS) {
+        /* 디렉터리의 위치는 이미지 기준 (마지막 칸은 블롭 끝) */
+        size_t directory_size = (pack.count + 1) * sizeof(uint64_t);
+        uint64_t blobs = (uint64_t)header.first_leaf_page * page_size + directory_size;
+        pack.offsets[pack.count] = pack.size;
+        for (size_t i = 0; i <= pack.count; i++) {
+            pack.offsets[i] += blobs;
+        }
+        if (!sink(ctx, pack.offsets, directory_size) ||
+            (pack.size > 0 && !sink(ctx, pack.data, pack.size))) {
+            result = BTREE_ERROR_IO;
+        }
+    }
+
+    free(pack.data);
+    if (pack.offsets) tree->allocator->free(pack.offsets);
+    tree->allocator->free(page);
+    if (queue) tree->allocator->free(queue);
+    return result;
+}
+
+/* 이미지 헤더 검증 */
+static btree_result_t btree_file_header_check(const btree_t *tree, const void *data,
+                                              size_t size) {
+    const btree_file_header_t *header = data;
+
+    if (size < sizeof(btree_file_header_t)) return BTREE_ERROR_CORRUPTED;
+    bool compressed = (header->flags & BTREE_FILE_FLAG_COMPRESSED) != 0;
+    if (memcmp(header->magic, BTREE_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != (compressed ? BTREE_FILE_VERSION_COMPRESSED : BTREE_FILE_VERSION) ||
+        header->endian != BTREE_FILE_ENDIAN ||
+        header->header_size != sizeof(btree_file_header_t) ||
+        header->checksum != btree_file_checksum(header)) {
+        return BTREE_ERROR_CORRUPTED;
+    }
+
+    /* 트리는 파일과 같은 타입으로 초기화되어 있어야 함 */
+    char key_name[BTREE_FILE_TYPE_NAME], value_name[BTREE_FILE_TYPE_NAME];
+    btree_copy_type_name(key_name, tree->key_type.type_name);
+    btree_copy_type_name(value_name, tree->value_type.type_name);
+    if (header->key_size != tree->key_type.key_size ||
+        header->value_size != tree->value_type.value_size ||
+        memcmp(key_name, header->key_type_name, BTREE_FILE_TYPE_NAME) != 0 ||
+        memcmp(value_name, header->value_type_name, BTREE_FILE_TYPE_NAME) != 0) {
+        return BTREE_ERROR_TYPE_MISMATCH;
+    }
+
+    if (header->degree < BTREE_MIN_DEGREE || header->degree > BTREE_MAX_DEGREE ||
+        header->height < 0 || header->height > BTREE_MAX_HEIGHT ||
+        header->page_size < sizeof(btree_page_header_t) ||
+        header->page_size % BTREE_CACHE_LINE_SIZE != 0) {
+        return BTREE_ERROR_CORRUPTED;
+    }
+
+    /* 압축 이미지는 첫 리프 앞까지만 고정 크기 페이지 */
+    size_t header_pages = btree_file_header_pages(header->page_size);
+    uint64_t fixed_pages = compressed ? header->first_leaf_page : header->page_count;
+    if (header->page_count < header_pages || fixed_pages > size / header->page_size) {
+        return BTREE_ERROR_INVALID_SIZE;
+    }
+    if (header->root_page == 0
+            ? (compressed || header->page_count != header_pages || header->key_count != 0)
+            : (header->root_page != header_pages || header->first_leaf_page < header_pages ||
+               header->first_leaf_page >= header->page_count)) {
+        return BTREE_ERROR_CORRUPTED;
+    }
+    if (compressed) {
+        uint64_t leaves = header->page_count - header->first_leaf_page;
+        size_t directory = (size_t)header->first_leaf_page * header->page_size;
+        if (leaves >= (size - directory) / sizeof(uint64_t)) return BTREE_ERROR_INVALID_SIZE;
+    }
+
+    /* 배열이 페이지 안에 들어가는지 확인 */
+    for (int kind = 0; kind < 2; kind++) {
+        const btree_page_layout_t *layout = &header->layouts[kind];
+        uint64_t cap = layout->capacity;
+        if (cap == 0 || cap > 2 * (uint64_t)BTREE_MAX_DEGREE * BTREE_MAX_DEGREE ||
+            layout->keys_offset < sizeof(btree_page_header_t) ||
+            layout->keys_offset + cap * header->key_size > header->page_size ||
+            (layout->children_offset &&
+             layout->children_offset + (cap + 1) * sizeof(uint64_t) > header->page_size) ||
+            (layout->values_offset &&
+             layout->values_offset + cap * header->value_size > header->page_size) ||
+            (layout->tombstones_offset && layout->tombstones_offset + cap > header->page_size) ||
+            (kind == 0 ? !layout->children_offset : layout->children_offset != 0) ||
+            (kind == 1 && header->value_size > 0 && !layout->values_offset)) {
+            return BTREE_ERROR_CORRUPTED;
+        }
+    }
+    return BTREE_SUCCESS;
+}
+
+static bool btree_image_compressed(const btree_file_header_t *header) {
+    return (header->flags & BTREE_FILE_FLAG_COMPRESSED) != 0;
+}
+
+/* 페이지 주소 (범위 밖이거나 압축된 리프면 NULL) */
+static const unsigned char* btree_image_page(const btree_file_header_t *header,
+                                             const unsigned char *base, uint64_t page_no) {
+    uint64_t end = btree_image_compressed(header) ? header->first_leaf_page : header->page_count;
+    if (page_no < btree_file_header_pages(header->page_size) || page_no >= end) {
+        return NULL;
+    }
+    return base + page_no * header->page_size;
+}
+
+static bool btree_leaf_unstream(const unsigned char *src, size_t size, uint8_t codec,
+                                uint32_t element_size, unsigned char *dst, size_t dst_size) {
+    btree_compression_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.algorithm = codec;
+    info.element_size = element_size;
+    return btree_memory_decompress(src, size, dst, dst_size, &info);
+}
+
+/*
+ * 압축 리프를 page에 비압축 리프 페이지 모양으로 풂 (손상이면 false)
+ *
+ * 리프는 이웃 페이지 번호로 연결되므로 prev/next는 페이지 번호에서 정해진다.
+ */
+static bool btree_leaf_decode(const btree_file_header_t *header, const unsigned char *base,
+                              size_t size, uint64_t page_no, unsigned char *page) {
+    if (page_no < header->first_leaf_page || page_no >= header->page_count) return false;
+
+    const btree_page_layout_t *layout = &header->layouts[1];
+    const unsigned char *directory = base + header->first_leaf_page * header->page_size;
+    uint64_t leaf = page_no - header->first_leaf_page;
+    uint64_t begin, end;
+    memcpy(&begin, directory + leaf * sizeof(uint64_t), sizeof(begin));
+    memcpy(&end, directory + (leaf + 1) * sizeof(uint64_t), sizeof(end));
+    if (begin > end || end > size || end - begin < sizeof(btree_leaf_blob_t)) return false;
+
+    btree_leaf_blob_t blob;
+    memcpy(&blob, base + begin, sizeof(blob));
+    if (blob.num_keys > layout->capacity ||
+        (uint64_t)blob.key_bytes + blob.value_bytes + blob.tombstone_bytes >
+            end - begin - sizeof(blob)) {
+        return false;
+    }
+
+    size_t n = blob.num_keys;
+    memset(page, 0, header->page_size);
+    btree_page_header_t *ph = (btree_page_header_t*)page;
+    ph->is_leaf = 1;
+    ph->num_keys = (uint32_t)n;
+    ph->prev_leaf = page_no > header->first_leaf_page ? page_no - 1 : 0;
+    ph->next_leaf = page_no + 1 < header->page_count ? page_no + 1 : 0;
+
+    const unsigned char *src = base + begin + sizeof(blob);
+    if (!btree_leaf_unstream(src, blob.key_bytes, blob.key_codec, header->key_size,
+                             page + layout->keys_offset, n * header->key_size)) {
+        return false;
+    }
+    src += blob.key_bytes;
+    if (layout->values_offset &&
+        !btree_leaf_unstream(src, blob.value_bytes, blob.value_codec, header->value_size,
+                             page + layout->values_offset, n * header->value_size)) {
+        return false;
+    }
+    src += blob.value_bytes;
+    if (layout->tombstones_offset &&
+        !btree_leaf_unstream(src, blob.tombstone_bytes, blob.tombstone_codec, 1,
+                             page + layout->tombstones_offset, n)) {
+        return false;
+    }
+    return true;
+}
+
+/* 페이지 내용 (압축된 리프는 buffer에 풀어서, 범위 밖이거나 손상이면 NULL) */
+static const unsigned char* btree_image_fetch(const btree_file_header_t *header,
+                                              const unsigned char *base, size_t size,
+                                              uint64_t page_no, unsigned char *buffer) {
+    if (!btree_image_compressed(header) || page_no < header->first_leaf_page) {
+        return btree_image_page(header, base, page_no);
+    }
+    return btree_leaf_decode(header, base, size, page_no, buffer) ? buffer : NULL;
+}
+
+/* 페이지의 키 수 (용량을 넘으면 -1) */
+static int btree_image_page_keys(const btree_file_header_t *header,
+                                 const btree_page_header_t *ph) {
+    const btree_page_layout_t *layout = &header->layouts[ph->is_leaf ? 1 : 0];
+    return ph->num_keys <= layout->capacity ? (int)ph->num_keys : -1;
+}
+
+/**
+ * @brief 이미지 구조 검증
+ *
+ * 너비 우선 배치 (자식 페이지가 순서대로 이어짐), 페이지별 키 정렬, 리프 연결,
+ * 리프 깊이와 키 수를 확인한다. 압축된 리프는 buffer에 풀어서 본다.
+ */
+static bool btree_image_walk(const btree_t *tree, const btree_file_header_t *header,
+                             const unsigned char *base, size_t size, unsigned char *buffer) {
+    if (header->root_page == 0) return header->height == 0 && header->dead_count == 0;
+
+    size_t key_size = header->key_size;
+    bool plus = (header->flags & BTREE_FILE_FLAG_PLUS) != 0;
+    uint64_t next_child = header->root_page + 1;
+    uint64_t level_end = header->root_page + 1;     /* 현재 레벨의 마지막 페이지 다음 */
+    int depth = 1;
+    bool seen_leaf = false;
+    uint64_t live = 0, dead = 0;
+
+    for (uint64_t page_no = header->root_page; page_no < header->page_count; page_no++) {
+        if (page_no == level_end) {
+            level_end = next_child;
+            depth++;
+        }
+
+        const unsigned char *page = btree_image_fetch(header, base, size, page_no, buffer);
+        if (!page) return false;
+        const btree_page_header_t *ph = (const btree_page_header_t*)page;
+        const btree_page_layout_t *layout = &header->layouts[ph->is_leaf ? 1 : 0];
+        int n = btree_image_page_keys(header, ph);
+        if (n < 0 || (n == 0 && page_no != header->root_page) || ph->is_leaf > 1) return false;
+
+        const unsigned char *keys = page + layout->keys_offset;
+        for (int i = 1; i < n; i++) {
+            if (tree->key_type.compare(keys + (i - 1) * key_size, keys + i * key_size) > 0) {
+                return false;
+            }
+        }
+        if (ph->is_leaf || !plus) {
+            for (int i = 0; i < n; i++) {
+                if (layout->tombstones_offset && page[layout->tombstones_offset + i]) {
+                    dead++;
+                } else {
+                    live++;
+                }
+            }
+        }
+
+        if (ph->is_leaf) {
+            /* 리프는 모두 마지막 레벨에 있고 서로 이웃 페이지다 */
+            if (depth != header->height || (!seen_leaf && page_no != header->first_leaf_page)) {
+                return false;
+            }
+            seen_leaf = true;
+            if (ph->prev_leaf != (page_no > header->first_leaf_page ? page_no - 1 : 0) ||
+                ph->next_leaf != (page_no + 1 < header->page_count ? page_no + 1 : 0)) {
+                return false;
+            }
+        } else {
+            if (seen_leaf) return false;
+            const uint64_t *children = (const uint64_t*)(page + layout->children_offset);
+            for (int c = 0; c <= n; c++) {
+                if (children[c] != next_child++) return false;
+            }
+        }
+    }
+
+    return next_child == header->page_count && depth == header->height &&
+           live == header->key_count && dead == header->dead_count;
+}
+
+static bool btree_image_validate(const btree_t *tree, const btree_file_header_t *header,
+                                 const unsigned char *base, size_t size) {
+    if (!btree_image_compressed(header)) return btree_image_walk(tree, header, base, size, NULL);
+
+    unsigned char *buffer = malloc(header->page_size);
+    if (!buffer) return false;
+    bool valid = btree_image_walk(tree, header, base, size, buffer);
+    free(buffer);
+    return valid;
+}
+
+/* 파일 헤더의 트리 구성을 적용 (키 수와 높이 포함) */
+static void btree_apply_header(btree_t *tree, const btree_file_header_t *header) {
+    tree->degree = header->degree;
+    tree->min_keys = header->degree - 1;
+    tree->max_keys = (int)header->layouts[1].capacity;
+    tree->internal_max_keys = (int)header->layouts[0].capacity;
+    tree->variant = (header->flags & BTREE_FILE_FLAG_PLUS) ? BTREE_VARIANT_PLUS
+                                                           : BTREE_VARIANT_STANDARD;
+    tree->flags &= ~(uint32_t)(BTREE_FLAG_ALLOW_DUPLICATES | BTREE_FLAG_LAZY_DELETE |
+                               BTREE_FLAG_COMPRESS_LEAVES);
+    if (header->flags & BTREE_FILE_FLAG_DUPLICATES) tree->flags |= BTREE_FLAG_ALLOW_DUPLICATES;
+    if (header->flags & BTREE_FILE_FLAG_LAZY_DELETE) tree->flags |= BTREE_FLAG_LAZY_DELETE;
+    if (header->flags & BTREE_FILE_FLAG_COMPRESSED) tree->flags |= BTREE_FLAG_COMPRESS_LEAVES;
+    tree->height = header->height;
+    tree->key_count = (size_t)header->key_count;
+    tree->dead_count = (size_t)header->dead_count;
+    tree->node_bytes = 0;
+    btree_update_search(tree);
+}
+
+/* 불러올 수 있는 트리인지 확인 (초기화만 된 빈 트리) */
+static btree_result_t btree_load_check(const btree_t *tree) {
+    if (tree->root || btree_is_concurrent(tree) || btree_is_mapped(tree)) {
+        return BTREE_ERROR_INVALID_OPERATION;
+    }
+    return BTREE_SUCCESS;
+}
+
+/* 캐시에서 리프를 찾고 없으면 CLOCK으로 고른 칸에 풂 (lock을 잡고 호출) */
+static const unsigned char* btree_leaf_cache_get(btree_storage_t *storage,
+                                                 const btree_file_header_t *header,
+                                                 uint64_t page_no) {
+    btree_leaf_slot_t *cache = storage->cache;
+    for (size_t i = 0; i < BTREE_LEAF_CACHE_SLOTS; i++) {
+        if (cache[i].page_no == page_no) {
+            cache[i].referenced = 1;
+            storage->cache_hits++;
+            return cache[i].page;
+        }
+    }
+
+    storage->cache_misses++;
+    while (cache[storage->clock].referenced) {
+        cache[storage->clock].referenced = 0;
+        storage->clock = (storage->clock + 1) % BTREE_LEAF_CACHE_SLOTS;
+    }
+    btree_leaf_slot_t *victim = &cache[storage->clock];
+    storage->clock = (storage->clock + 1) % BTREE_LEAF_CACHE_SLOTS;
+
+    victim->page_no = 0;
+    if (!btree_leaf_decode(header, storage->base, storage->size, page_no, victim->page)) {
+        return NULL;
+    }
+    victim->page_no = page_no;
+    victim->referenced = 1;
+    return victim->page;
+}
+
+/*
+ * 매핑된 트리 검색
+ *
+ * 페이지 번호와 키 수는 헤더 범위 안으로 확인하며 내려가므로 손상된 페이지도
+ * 이미지 밖을 읽지 않는다. 압축 이미지의 리프는 캐시에서 읽고, 값은 캐시
+ * 잠금 안에서 value_out에 복사한다 (반환한 포인터는 다음 교체까지 유효).
+ */
+void* btree_mapped_search(const btree_t *tree, const void *key, void *value_out) {
+    btree_storage_t *storage = tree->storage;
+    const btree_file_header_t *header = (const btree_file_header_t*)storage->base;
+    bool plus = (header->flags & BTREE_FILE_FLAG_PLUS) != 0;
+    uint64_t page_no = header->root_page;
+    bool locked = false;
+    void *slot = NULL;
+
+    for (int depth = 0; depth < header->height; depth++) {
+        const unsigned char *page = btree_image_page(header, storage->base, page_no);
+        if (!page && storage->cache) {
+            btree_storage_lock(&storage->lock);
+            locked = true;
+            page = btree_leaf_cache_get(storage, header, page_no);
+        }
+        if (!page) break;
+
+        const btree_page_header_t *ph = (const btree_page_header_t*)page;
+        const btree_page_layout_t *layout = &header->layouts[ph->is_leaf ? 1 : 0];
+        int n = btree_image_page_keys(header, ph);
+        if (n <= 0) break;
+
+        int pos = btree_keys_find(tree, page + layout->keys_offset, n, key);
+        if (pos >= 0 && (ph->is_leaf || !plus)) {
+            if (!layout->tombstones_offset || !page[layout->tombstones_offset + pos]) {
+                slot = (void*)(page + layout->values_offset + (size_t)pos * header->value_size);
+            }
+            break;
+        }
+        if (ph->is_leaf || locked) break;
+
+        const uint64_t *children = (const uint64_t*)(page + layout->children_offset);
+        page_no = children[btree_descend_index(pos)];
+    }
+
+    if (slot && value_out) memcpy(value_out, slot, header->value_size);
+    if (locked) btree_storage_unlock(&storage->lock);
+    return slot;
+}
+
+/* 매핑된 트리 구조 검증 */
+bool btree_mapped_validate(const btree_t *tree) {
+    const btree_storage_t *storage = tree->storage;
+    return btree_image_validate(tree, (const btree_file_header_t*)storage->base,
+                                storage->base, storage->size);
+}
+
+/*
+ * 열어 둔 이미지로 매핑 상태 생성 (압축 이미지는 리프 캐시를 붙임)
+ *
+ * 실패해도 opened는 닫지 않는다.
+ */
+static btree_storage_t* btree_storage_create(btree_t *tree, const btree_storage_t *opened) {
+    btree_storage_t *storage = tree->allocator->alloc(sizeof(btree_storage_t));
+    if (!storage) return NULL;
+    memset(storage, 0, sizeof(btree_storage_t));
+    storage->base = opened->base;
+    storage->size = opened->size;
+    storage->mapped = opened->mapped;
+
+    const btree_file_header_t *header = (const btree_file_header_t*)opened->base;
+    if (!btree_image_compressed(header)) return storage;
+
+    storage->cache = tree->allocator->alloc(BTREE_LEAF_CACHE_SLOTS * sizeof(btree_leaf_slot_t));
+    storage->cache_pages = tree->allocator->alloc(BTREE_LEAF_CACHE_SLOTS * (size_t)header->page_size);
+    if (!storage->cache || !storage->cache_pages) {
+        if (storage->cache) tree->allocator->free(storage->cache);
+        if (storage->cache_pages) tree->allocator->free(storage->cache_pages);
+        tree->allocator->free(storage);
+        return NULL;
+    }
+    for (size_t i = 0; i < BTREE_LEAF_CACHE_SLOTS; i++) {
+        storage->cache[i].page_no = 0;
+        storage->cache[i].page = storage->cache_pages + i * (size_t)header->page_size;
+        storage->cache[i].referenced = 0;
+    }
+    return storage;
+}
+
+/* 이미지를 닫고 매핑 상태 해제 */
+static void btree_storage_destroy(btree_t *tree, btree_storage_t *storage) {
+    btree_storage_close(storage);
+    if (storage->cache) {
+        tree->allocator->free(storage->cache);
+        tree->allocator->free(storage->cache_pages);
+    }
+    tree->allocator->free(storage);
+}
+
+/* 매핑 해제 */
+void btree_storage_release(btree_t *tree) {
+    btree_storage_t *storage = tree->storage;
+    if (!storage) return;
+
+    btree_storage_destroy(tree, storage);
+    tree->storage = NULL;
+}
+
+/* 매핑된 트리를 같은 내용의 수정 가능한 트리로 바꿈 */
+btree_result_t btree_storage_materialize(btree_t *tree) {
+    btree_storage_t *storage = tree->storage;
+    tree->storage = NULL;
+
+    btree_result_t result = btree_deserialize(tree, storage->base, storage->size);
+    if (result != BTREE_SUCCESS) {
+        tree->storage = storage;
+        return result;
+    }
+    btree_storage_destroy(tree, storage);
+    return BTREE_SUCCESS;
+}
+
+/* 버퍼 출력 상태 */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t used;
+} btree_buffer_sink_t;
+
+static bool btree_buffer_sink(void *ctx, const void *data, size_t size) {
+    btree_buffer_sink_t *buffer = ctx;
+    if (size > buffer->size - buffer->used) return false;
+    memcpy(buffer->data + buffer->used, data, size);
+    buffer->used += size;
+    return true;
+}
+
+/* 늘어나는 힙 버퍼 출력 (data는 malloc, 크기만 셀 때는 count_only) */
+typedef struct {
+    unsigned char *data;
+    size_t capacity;
+    size_t used;
+    bool count_only;
+} btree_heap_sink_t;
+
+static bool btree_heap_sink(void *ctx, const void *data, size_t size) {
+    btree_heap_sink_t *heap = ctx;
+    if (heap->count_only) {
+        heap->used += size;
+        return true;
+    }
+    if (size > heap->capacity - heap->used) {
+        size_t capacity = heap->capacity ? heap->capacity * 2 : size;
+        if (capacity < heap->used + size) capacity = heap->used + size;
+        unsigned char *grown = realloc(heap->data, capacity);
+        if (!grown) return false;
+        heap->data = grown;
+        heap->capacity = capacity;
+    }
+    memcpy(heap->data + heap->used, data, size);
+    heap->used += size;
+    return true;
+}
+
+static bool btree_file_sink(void *ctx, const void *data, size_t size) {
+    return fwrite(data, 1, size, (FILE*)ctx) == size;
+}
+
+/**
+ * @brief 직렬화 이미지 크기 (저장할 수 없는 트리는 0)
+ *
+ * 리프를 압축하는 트리는 크기를 알기 위해 압축까지 해 본다.
+ */
+size_t btree_serialize_size(const btree_t *tree) {
+    if (!tree || btree_persist_check(tree) != BTREE_SUCCESS) return 0;
+
+    if (tree->root && (tree->flags & BTREE_FLAG_COMPRESS_LEAVES)) {
+        btree_heap_sink_t counter = { NULL, 0, 0, true };
+        if (btree_persist_write(tree, btree_heap_sink, &counter, 0, 0) != BTREE_SUCCESS) return 0;
+        return counter.used;
+    }
+
+    btree_file_header_t header;
+    btree_file_header_build(tree, &header);
+    size_t pages = btree_file_header_pages(header.page_size) + (tree->root ? tree->node_count : 0);
+    return pages * header.page_size;
+}
+
+/**
+ * @brief 트리를 버퍼에 페이지 이미지로 직렬화
+ */
+btree_result_t btree_serialize(const btree_t *tree, void *buffer, size_t buffer_size) {
+    if (!tree || !buffer) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    btree_buffer_sink_t sink = { buffer, buffer_size, 0 };
+    btree_result_t result = btree_persist_write(tree, btree_buffer_sink, &sink, 0, 0);
+    if (result == BTREE_ERROR_IO) result = BTREE_ERROR_INVALID_SIZE;
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 페이지 이미지에서 수정 가능한 트리 구성
+ *
+ * 노드마다 새로 할당하여 키, 값, 삭제 표시 배열을 복사하고 자식과 리프를
+ * 연결한다. 실패하면 트리는 호출 전 상태로 남는다.
+ */
+btree_result_t btree_deserialize(btree_t *tree, const void *buffer, size_t buffer_size) {
+    if (!tree || !buffer) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    btree_result_t result = btree_load_check(tree);
+    if (result == BTREE_SUCCESS) result = btree_file_header_check(tree, buffer, buffer_size);
+    if (result != BTREE_SUCCESS) {
+        return btree_set_error(result), result;
+    }
+
+    const btree_file_header_t *header = buffer;
+    const unsigned char *base = buffer;
+    if (!btree_image_validate(tree, header, base, buffer_size)) {
+        return btree_set_error(BTREE_ERROR_CORRUPTED), BTREE_ERROR_CORRUPTED;
+    }
+
+    btree_t saved = *tree;
+    btree_apply_header(tree, header);
+    if (header->root_page == 0) return BTREE_SUCCESS;
+
+    size_t first = (size_t)header->root_page;
+    size_t count = (size_t)header->page_count - first;
+    btree_node_t **nodes = tree->allocator->alloc(count * sizeof(btree_node_t*));
+    unsigned char *leaf_page = btree_image_compressed(header) ? malloc(header->page_size) : NULL;
+    if (!nodes || (btree_image_compressed(header) && !leaf_page)) {
+        if (nodes) tree->allocator->free(nodes);
+        free(leaf_page);
+        *tree = saved;
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    size_t built = 0;
+    for (; built < count; built++) {
+        /* 검증을 통과했으므로 압축된 리프도 풀림 */
+        const unsigned char *page = btree_image_fetch(header, base, buffer_size, first + built,
+                                                      leaf_page);
+        const btree_page_header_t *ph = (const btree_page_header_t*)page;
+        const btree_page_layout_t *layout = &header->layouts[ph->is_leaf ? 1 : 0];
+        size_t n = ph->num_keys;
+
+        btree_node_t *node = btree_node_create(tree, ph->is_leaf != 0);
+        if (!node) break;
+        nodes[built] = node;
+
+        node->num_keys = (int)n;
+        memcpy(node->keys, page + layout->keys_offset, n * header->key_size);
+        if (node->values && layout->values_offset) {
+            memcpy(node->values, page + layout->values_offset, n * header->value_size);
+        }
+        if (node->tombstones && layout->tombstones_offset) {
+            memcpy(node->tombstones, page + layout->tombstones_offset, n);
+        }
+    }
+
+    free(leaf_page);
+    if (built < count) {
+        /* 아직 연결 전이므로 노드를 하나씩 해제 */
+        for (size_t i = 0; i < built; i++) {
+            nodes[i]->num_keys = 0;
+            btree_node_destroy(tree, nodes[i]);
+        }
+        tree->allocator->free(nodes);
+        *tree = saved;
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    btree_node_t *prev_leaf = NULL;
+    for (size_t i = 0; i < count; i++) {
+        btree_node_t *node = nodes[i];
+        if (node->is_leaf) {
+            node->prev_leaf = prev_leaf;
+            if (prev_leaf) prev_leaf->next_leaf = node;
+            prev_leaf = node;
+            continue;
+        }
+
+        const unsigned char *page = base + (first + i) * header->page_size;
+        const uint64_t *children = (const uint64_t*)(page + header->layouts[0].children_offset);
+        for (int c = 0; c <= node->num_keys; c++) {
+            node->children[c] = nodes[children[c] - first];
+            node->children[c]->parent = node;
+        }
+    }
+
+    tree->root = nodes[0];
+    tree->allocator->free(nodes);
+    return BTREE_SUCCESS;
+}
+
+/* 이미지 파일 저장 (임시 파일에 쓰고 디스크에 내린 뒤 이름 변경) */
+btree_result_t btree_persist_save(const btree_t *tree, const char *filename,
+                                  uint64_t log_id, uint64_t log_lsn) {
+    btree_result_t result = btree_persist_check(tree);
+    if (result != BTREE_SUCCESS) return result;
+
+    size_t name_length = strlen(filename);
+    char *temp_name = malloc(name_length + 5);
+    if (!temp_name) return BTREE_ERROR_MEMORY_ALLOCATION;
+    memcpy(temp_name, filename, name_length);
+    memcpy(temp_name + name_length, ".tmp", 5);
+
+    FILE *file = fopen(temp_name, "wb");
+    if (!file) {
+        free(temp_name);
+        return BTREE_ERROR_IO;
+    }
+
+    result = btree_persist_write(tree, btree_file_sink, file, log_id, log_lsn);
+#ifdef BTREE_PERSIST_MMAP
+    if (result == BTREE_SUCCESS && (fflush(file) != 0 || fsync(fileno(file)) != 0)) {
+        result = BTREE_ERROR_IO;
+    }
+#endif
+    if (fclose(file) != 0 && result == BTREE_SUCCESS) {
+        result = BTREE_ERROR_IO;
+    }
+    if (result == BTREE_SUCCESS) {
+#ifdef BTREE_PLATFORM_WINDOWS
+        remove(filename);
+#endif
+        if (rename(temp_name, filename) != 0) result = BTREE_ERROR_IO;
+    }
+    if (result != BTREE_SUCCESS) remove(temp_name);
+    free(temp_name);
+    return result;
+}
+
+/**
+ * @brief 트리를 페이지 파일로 저장
+ *
+ * 임시 파일에 모두 쓴 뒤 이름을 바꾸므로 실패해도 기존 파일은 그대로 남는다.
+ */
+btree_result_t btree_save_to_file(const btree_t *tree, const char *filename) {
+    if (!tree || !filename) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    btree_result_t result = btree_persist_save(tree, filename, 0, 0);
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/* 파일 전체를 읽기 전용으로 매핑 (mmap이 없으면 힙으로 읽음) */
+static btree_result_t btree_storage_open(const char *filename, btree_storage_t *storage) {
+#ifdef BTREE_PERSIST_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return BTREE_ERROR_IO;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return BTREE_ERROR_IO;
+    }
+    if ((size_t)st.st_size < sizeof(btree_file_header_t)) {
+        close(fd);
+        return BTREE_ERROR_CORRUPTED;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return BTREE_ERROR_IO;
+
+    storage->base = base;
+    storage->size = (size_t)st.st_size;
+    storage->mapped = 1;
+    return BTREE_SUCCESS;
+#else
+    FILE *file = fopen(filename, "rb");
+    if (!file) return BTREE_ERROR_IO;
+
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return BTREE_ERROR_IO;
+    }
+    if ((size_t)size < sizeof(btree_file_header_t)) {
+        fclose(file);
+        return BTREE_ERROR_CORRUPTED;
+    }
+
+    unsigned char *base = malloc((size_t)size);
+    if (!base) {
+        fclose(file);
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    bool ok = fread(base, 1, (size_t)size, file) == (size_t)size;
+    fclose(file);
+    if (!ok) {
+        free(base);
+        return BTREE_ERROR_IO;
+    }
+
+    storage->base = base;
+    storage->size = (size_t)size;
+    storage->mapped = 0;
+    return BTREE_SUCCESS;
+#endif
+}
+
+/**
+ * @brief 페이지 파일을 읽기 전용으로 매핑
+ *
+ * 노드를 만들지 않고 매핑한 페이지를 그대로 검색한다. 헤더만 확인하므로
+ * 여는 비용은 파일 크기와 무관하다 (전체 검사는 btree_validate_structure).
+ *
+ * 이미지에 이어지는 로그 (btree_wal_open)에 이미지 이후 커밋된 트랜잭션이
+ * 있으면 이미지를 수정 가능한 노드로 읽어 들인 뒤 로그를 다시 적용한다
+ * (충돌 복구). 이 경우 트리는 매핑되지 않는다.
+ */
+btree_result_t btree_load_from_file(btree_t *tree, const char *filename) {
+    if (!tree || !filename) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    btree_result_t result = btree_load_check(tree);
+    if (result != BTREE_SUCCESS) {
+        return btree_set_error(result), result;
+    }
+
+    btree_storage_t opened;
+    result = btree_storage_open(filename, &opened);
+    if (result != BTREE_SUCCESS) {
+        return btree_set_error(result), result;
+    }
+
+    btree_storage_t *storage = NULL;
+    result = btree_file_header_check(tree, opened.base, opened.size);
+    if (result == BTREE_SUCCESS) {
+        const btree_file_header_t *header = (const btree_file_header_t*)opened.base;
+        if (header->log_id != 0 &&
+            btree_wal_pending(filename, header->log_id, header->log_lsn,
+                              header->key_size, header->value_size) > 0) {
+            uint64_t log_id = header->log_id, log_lsn = header->log_lsn;
+            result = btree_deserialize(tree, opened.base, opened.size);
+            btree_storage_close(&opened);
+            if (result != BTREE_SUCCESS) return result;
+
+            result = btree_wal_replay(tree, filename, log_id, log_lsn);
+            if (result != BTREE_SUCCESS) btree_set_error(result);
+            return result;
+        }
+        storage = btree_storage_create(tree, &opened);
+        if (!storage) result = BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    if (result != BTREE_SUCCESS) {
+        btree_storage_close(&opened);
+        return btree_set_error(result), result;
+    }
+
+    btree_apply_header(tree, (const btree_file_header_t*)opened.base);
+    tree->storage = storage;
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 리프 압축 설정
+ *
+ * 켜 두면 저장, 직렬화, 체크포인트가 압축 이미지를 쓴다. 트리 노드 자체는
+ * 바뀌지 않는다.
+ */
+btree_result_t btree_set_leaf_compression(btree_t *tree, bool enable) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (btree_is_mapped(tree)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    if (enable) {
+        tree->flags |= BTREE_FLAG_COMPRESS_LEAVES;
+    } else {
+        tree->flags &= ~(uint32_t)BTREE_FLAG_COMPRESS_LEAVES;
+    }
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 트리를 메모리 안의 압축 이미지로 바꿔 읽기 전용으로 둠
+ *
+ * 압축 이미지를 힙에 만든 뒤 노드를 해제하고, 이후 검색은 파일에서 연
+ * 압축 트리처럼 리프 캐시를 거친다. 이미지를 다 만든 다음에 노드를 버리므로
+ * 실패하면 트리는 그대로다.
+ */
+btree_result_t btree_freeze(btree_t *tree) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    /* 로그가 붙은 트리는 체크포인트가 노드를 이미지로 써야 함 */
+    btree_result_t result = tree->log ? BTREE_ERROR_INVALID_OPERATION : btree_persist_check(tree);
+    if (result != BTREE_SUCCESS) {
+        return btree_set_error(result), result;
+    }
+
+    uint32_t flags = tree->flags;
+    tree->flags |= BTREE_FLAG_COMPRESS_LEAVES;
+    btree_heap_sink_t image = { NULL, 0, 0, false };
+    result = btree_persist_write(tree, btree_heap_sink, &image, 0, 0);
+
+    btree_storage_t *storage = NULL;
+    if (result == BTREE_SUCCESS) {
+        /* 늘어난 여유분을 돌려줌 (실패하면 그대로 씀) */
+        unsigned char *fitted = realloc(image.data, image.used);
+        if (fitted) image.data = fitted;
+
+        btree_storage_t opened;
+        memset(&opened, 0, sizeof(opened));
+        opened.base = image.data;
+        opened.size = image.used;
+        opened.mapped = 0;
+        storage = btree_storage_create(tree, &opened);
+        if (!storage) result = BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    if (result != BTREE_SUCCESS) {
+        free(image.data);
+        tree->flags = flags;
+        return btree_set_error(result), result;
+    }
+
+    btree_clear(tree);
+    btree_apply_header(tree, (const btree_file_header_t*)storage->base);
+    tree->storage = storage;
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 매핑된 트리를 수정 가능한 노드로 되돌림 (압축 여부와 무관)
+ *
+ * 리프 압축 설정은 이미지를 따르므로 얼린 트리는 다시 저장할 때도 압축한다.
+ */
+btree_result_t btree_thaw(btree_t *tree) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (!btree_is_mapped(tree)) return BTREE_SUCCESS;
+
+    btree_result_t result = btree_storage_materialize(tree);
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 압축 이미지와 리프 캐시 통계 (압축 이미지를 쓰지 않는 트리는 false)
+ */
+bool btree_compression_get_stats(const btree_t *tree, btree_compression_stats_t *stats) {
+    if (!tree || !stats || !btree_is_mapped(tree)) return false;
+
+    btree_storage_t *storage = tree->storage;
+    const btree_file_header_t *header = (const btree_file_header_t*)storage->base;
+    if (!storage->cache) return false;
+
+    size_t leaves = (size_t)(header->page_count - header->first_leaf_page);
+    size_t directory = (size_t)header->first_leaf_page * header->page_size;
+    memset(stats, 0, sizeof(*stats));
+    stats->leaf_count = leaves;
+    stats->leaf_bytes = leaves * header->page_size;
+    stats->compressed_bytes = storage->size - directory;
+    stats->image_bytes = storage->size;
+
+    btree_storage_lock(&storage->lock);
+    stats->cache_slots = BTREE_LEAF_CACHE_SLOTS;
+    stats->cache_hits = storage->cache_hits;
+    stats->cache_misses = storage->cache_misses;
+    btree_storage_unlock(&storage->lock);
+    return true;
+}
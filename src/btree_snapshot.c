@@ -0,0 +1,102 @@
+/**
+ * @file btree_snapshot.c
+ * @brief 트리 복사 (노드를 공유하는 스냅숏과 깊은 복사)
+ *
+ * 표준 B-Tree는 루트의 참조 카운트만 늘려 모든 노드를 공유하고, 이후 두
+ * 트리의 쓰기는 경로 복사로 갈라진다 (btree_node_unshare). B+Tree는 리프
+ * 연결 때문에 사본 하나를 끼우려면 이웃 리프까지 모두 복사해야 하고, 동시
+ * 모드 삽입은 노드를 제자리에서 바꾸므로 이 둘은 노드를 하나씩 복사한다.
+ */
+
+#include "btree_internal.h"
+#include <string.h>
+
+/* 서브트리를 dest의 새 노드로 복사 (리프는 왼쪽부터 last_leaf 뒤에 연결) */
+static btree_node_t* btree_clone_subtree(btree_t *dest, const btree_node_t *node,
+                                         btree_node_t *parent, btree_node_t **last_leaf) {
+    btree_node_t *copy = btree_node_create(dest, node->is_leaf);
+    if (!copy) return NULL;
+
+    btree_node_copy_slots(dest, copy, node);
+    copy->parent = parent;
+
+    if (node->is_leaf) {
+        copy->prev_leaf = *last_leaf;
+        if (*last_leaf) (*last_leaf)->next_leaf = copy;
+        *last_leaf = copy;
+        return copy;
+    }
+
+    /* 자식 배열은 0으로 초기화되어 있어 실패 시 채운 자식까지만 해제됨 */
+    for (int i = 0; i <= node->num_keys; i++) {
+        copy->children[i] = btree_clone_subtree(dest, node->children[i], copy, last_leaf);
+        if (!copy->children[i]) {
+            btree_node_destroy(dest, copy);
+            return NULL;
+        }
+    }
+    return copy;
+}
+
+/* src를 바꾸는 스레드가 없는 상태에서 복사 (btree_copy가 배타 쓰기 구간에서 호출) */
+static btree_result_t btree_copy_locked(btree_t *dest, btree_t *src) {
+    /* 설정과 집계는 그대로, 트리마다 따로 갖는 상태는 비움 */
+    *dest = *src;
+    dest->lock = NULL;
+    dest->storage = NULL;
+    dest->log = NULL;
+    dest->metrics = NULL;
+    dest->events = NULL;
+    dest->layout = NULL;
+    dest->append_leaf = NULL;
+    dest->numa = NULL;
+    dest->flags &= ~(uint32_t)BTREE_FLAG_THREAD_SAFE;
+    if (dest->variant == BTREE_VARIANT_CONCURRENT) {
+        dest->variant = BTREE_VARIANT_STANDARD;
+    }
+    if (!src->root) return BTREE_SUCCESS;
+
+    if (!btree_is_plus(src) && !btree_is_concurrent(src)) {
+        btree_node_ref(src->root);
+        btree_replica_release(src);
+        src->append_leaf = NULL;
+        src->flags |= BTREE_FLAG_SHARED;
+        dest->flags |= BTREE_FLAG_SHARED;
+        return BTREE_SUCCESS;
+    }
+
+    btree_node_t *last_leaf = NULL;
+    dest->node_count = 0;
+    dest->total_memory = sizeof(btree_t);
+    dest->root = btree_clone_subtree(dest, src->root, NULL, &last_leaf);
+    if (!dest->root) {
+        dest->key_count = 0;
+        dest->dead_count = 0;
+        dest->height = 0;
+        return BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief src의 사본으로 dest 초기화
+ *
+ * dest의 기존 내용은 정리하지 않는다 (btree_init처럼 덮어씀). 동시 모드의
+ * src는 배타 쓰기 구간에서 복사하므로 다른 스레드의 분할이나 병합 도중의
+ * 노드와 key_count, height를 보지 않는다 (그동안 쓰기는 기다림).
+ */
+btree_result_t btree_copy(btree_t *dest, btree_t *src) {
+    if (!dest || !src) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (dest == src || btree_is_mapped(src)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_writer_begin(src);
+    btree_result_t result = btree_copy_locked(dest, src);
+    btree_writer_end(src);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file btree_stats.c
+ * @brief B-Tree 통계 수집 및 출력
+ */
+
+#include "btree_internal.h"
+#include <string.h>
+#include <time.h>
+
+/* 노드 단위 통계 누적 (재귀 헬퍼), capacity에는 키를 세는 노드의 용량을 누적 */
+static void btree_collect_node(const btree_t *tree, const btree_node_t *node,
+                               int depth, btree_statistics_t *stats, size_t *capacity) {
+    size_t slot_size = tree->key_type.key_size + (node->values ? tree->value_type.value_size : 0);
+
+    stats->node_count++;
+    if (node->is_leaf || !btree_is_plus(tree)) {
+        for (int i = 0; i < node->num_keys; i++) {
+            if (!btree_slot_is_dead(node, i)) stats->key_count++;
+        }
+        *capacity += node->capacity;
+    }
+    stats->memory_usage += btree_node_memory_size(tree, node);
+    stats->wasted_space += (node->capacity - node->num_keys) * slot_size;
+    if (depth > stats->height) {
+        stats->height = depth;
+    }
+
+    if (node->is_leaf) {
+        stats->leaf_count++;
+        return;
+    }
+
+    stats->internal_count++;
+    for (int i = 0; i <= node->num_keys; i++) {
+        if (node->children[i]) {
+            btree_collect_node(tree, node->children[i], depth + 1, stats, capacity);
+        }
+    }
+}
+
+/**
+ * @brief 트리 전체를 순회하여 통계 수집
+ */
+void btree_collect_statistics(const btree_t *tree, btree_statistics_t *stats) {
+    if (!stats) return;
+
+    memset(stats, 0, sizeof(btree_statistics_t));
+    if (!tree) return;
+
+    size_t capacity = 0;
+    stats->memory_usage = sizeof(btree_t);
+    if (tree->root) {
+        btree_collect_node(tree, tree->root, 1, stats, &capacity);
+    }
+
+    stats->fill_factor = capacity > 0 ? (double)stats->key_count / capacity : 0.0;
+}
+
+/**
+ * @brief 통계 출력
+ */
+void btree_print_statistics(const btree_t *tree, FILE *output) {
+    if (!tree || !output) return;
+
+    btree_statistics_t stats;
+    btree_collect_statistics(tree, &stats);
+
+    fprintf(output, "B-Tree Statistics:\n");
+    fprintf(output, "  Variant:         %s\n", btree_is_plus(tree) ? "B+Tree" : "B-Tree");
+    fprintf(output, "  Layout:          %s\n",
+            (tree->flags & BTREE_FLAG_INLINE_NODES) ? "inline" : "split");
+    fprintf(output, "  Nodes:           %zu (leaf %zu, internal %zu)\n",
+            stats.node_count, stats.leaf_count, stats.internal_count);
+    fprintf(output, "  Keys:            %zu\n", stats.key_count);
+    fprintf(output, "  Height:          %d\n", stats.height);
+    fprintf(output, "  Fill Factor:     %.2f%%\n", stats.fill_factor * 100.0);
+    fprintf(output, "  Memory Usage:    %zu bytes\n", stats.memory_usage);
+    fprintf(output, "  Wasted Space:    %zu bytes\n", stats.wasted_space);
+
+    if (tree->metrics) {
+        btree_metrics_t metrics;
+        btree_metrics_snapshot(tree, &metrics);
+        fprintf(output, "  Operations:      insert %llu, search %llu, delete %llu\n",
+                (unsigned long long)metrics.operations[BTREE_METRIC_INSERT],
+                (unsigned long long)metrics.operations[BTREE_METRIC_SEARCH],
+                (unsigned long long)metrics.operations[BTREE_METRIC_DELETE]);
+        fprintf(output, "  Nodes Visited:   %llu (comparisons %llu)\n",
+                (unsigned long long)metrics.nodes_visited,
+                (unsigned long long)metrics.comparisons);
+        fprintf(output, "  Splits/Merges:   %llu / %llu\n",
+                (unsigned long long)metrics.splits, (unsigned long long)metrics.merges);
+        fprintf(output, "  Node Allocs:     %llu (nodes freed %llu)\n",
+                (unsigned long long)metrics.node_allocs, (unsigned long long)metrics.node_frees);
+        if (((const btree_metrics_state_t*)tree->metrics)->flags & BTREE_METRICS_LATENCY) {
+            static const char *names[BTREE_METRIC_OP_COUNT] = { "insert", "search", "delete" };
+            for (int op = 0; op < BTREE_METRIC_OP_COUNT; op++) {
+                fprintf(output, "  Latency %-7s  p50 %llu ns, p99 %llu ns, max %llu ns\n",
+                        names[op],
+                        (unsigned long long)btree_metrics_percentile(&metrics, op, 0.50),
+                        (unsigned long long)btree_metrics_percentile(&metrics, op, 0.99),
+                        (unsigned long long)btree_metrics_percentile(&metrics, op, 1.0));
+            }
+        }
+    }
+}
+
+/* 지연 시간 값 (나노초)의 로그-선형 버킷 번호 */
+static int btree_latency_bucket(uint64_t ns) {
+    if (ns < BTREE_LATENCY_SUB_BUCKETS) return (int)ns;
+
+    int exponent = 63;
+    while (!(ns >> exponent)) exponent--;
+    /* 최상위 비트 아래 BTREE_LATENCY_SUB_BITS 비트로 구간을 나눔 */
+    int shift = exponent - BTREE_LATENCY_SUB_BITS;
+    return (shift + 1) * BTREE_LATENCY_SUB_BUCKETS +
+           (int)((ns >> shift) & (BTREE_LATENCY_SUB_BUCKETS - 1));
+}
+
+/* 버킷에 들어가는 가장 큰 값 */
+static uint64_t btree_latency_bucket_upper(int bucket) {
+    if (bucket < BTREE_LATENCY_SUB_BUCKETS) return (uint64_t)bucket;
+
+    int shift = bucket / BTREE_LATENCY_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(bucket % BTREE_LATENCY_SUB_BUCKETS);
+    uint64_t lower = ((uint64_t)BTREE_LATENCY_SUB_BUCKETS + sub) << shift;
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+static uint64_t btree_metrics_clock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief 계측 켜기/끄기
+ */
+btree_result_t btree_enable_metrics(btree_t *tree, uint32_t flags) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (flags & ~(uint32_t)(BTREE_METRICS_COUNTERS | BTREE_METRICS_LATENCY)) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    btree_metrics_state_t *state = tree->metrics;
+    if (!flags) {
+        tree->metrics = NULL;
+        if (state) tree->allocator->free(state);
+        return BTREE_SUCCESS;
+    }
+
+    if (!state) {
+        state = tree->allocator->alloc(sizeof(btree_metrics_state_t));
+        if (!state) {
+            return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+        }
+        memset(state, 0, sizeof(btree_metrics_state_t));
+    }
+    state->flags = flags;
+    tree->metrics = state;
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 누적 계측값 복사
+ */
+void btree_metrics_snapshot(const btree_t *tree, btree_metrics_t *out) {
+    if (!out) return;
+
+    const btree_metrics_state_t *state = tree ? tree->metrics : NULL;
+    if (state) {
+        memcpy(out, &state->data, sizeof(btree_metrics_t));
+    } else {
+        memset(out, 0, sizeof(btree_metrics_t));
+    }
+}
+
+/**
+ * @brief 누적 계측값 초기화
+ */
+void btree_metrics_reset(btree_t *tree) {
+    if (!tree || !tree->metrics) return;
+
+    btree_metrics_state_t *state = tree->metrics;
+    memset(&state->data, 0, sizeof(btree_metrics_t));
+}
+
+/**
+ * @brief 히스토그램 분위수
+ */
+uint64_t btree_metrics_percentile(const btree_metrics_t *metrics, btree_metric_op_t op,
+                                  double quantile) {
+    if (!metrics || op < 0 || op >= BTREE_METRIC_OP_COUNT) return 0;
+
+    const uint64_t *histogram = metrics->latency[op];
+    uint64_t total = 0;
+    for (int i = 0; i < BTREE_LATENCY_BUCKETS; i++) total += histogram[i];
+    if (total == 0) return 0;
+
+    if (quantile < 0.0) quantile = 0.0;
+    if (quantile > 1.0) quantile = 1.0;
+    uint64_t rank = (uint64_t)(quantile * (double)total + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BTREE_LATENCY_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= rank) return btree_latency_bucket_upper(i);
+    }
+    return btree_latency_bucket_upper(BTREE_LATENCY_BUCKETS - 1);
+}
+
+void btree_metrics_record(btree_metrics_t *metrics, btree_metric_op_t op, uint64_t ns) {
+    if (!metrics || op < 0 || op >= BTREE_METRIC_OP_COUNT) return;
+    metrics->latency[op][btree_latency_bucket(ns)]++;
+}
+
+/* 연산 시작 시각 */
+uint64_t btree_metrics_start(const btree_t *tree) {
+    const btree_metrics_state_t *state = tree->metrics;
+    return (state->flags & BTREE_METRICS_LATENCY) ? btree_metrics_clock() : 0;
+}
+
+/* 연산 수와 지연 시간 기록 */
+void btree_metrics_finish(const btree_t *tree, btree_metric_op_t op, uint64_t start) {
+    btree_metrics_state_t *state = tree->metrics;
+    btree_metric_add(tree, &state->data.operations[op], 1);
+    if (state->flags & BTREE_METRICS_LATENCY) {
+        uint64_t elapsed = btree_metrics_clock() - start;
+        btree_metric_add(tree, &state->data.latency[op][btree_latency_bucket(elapsed)], 1);
+    }
+}
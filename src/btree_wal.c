@@ -0,0 +1,740 @@
+/**
+ * @file btree_wal.c
+ * @brief 트랜잭션과 선행 기록 로그 (그룹 커밋)
+ *
+ * 트랜잭션의 삽입과 삭제는 트리에 바로 적용하고, 되돌릴 정보는 메모리의
+ * 실행 취소 버퍼에만 둔다. 커밋하면 트랜잭션의 재실행 레코드를 한 묶음으로
+ * 로그 버퍼에 붙이고, 로그를 디스크에 내리는 일은 기다리는 커밋들 중 하나
+ * (리더)가 한 번의 write와 fdatasync로 처리한다. 따라서 디스크 비용은
+ * 로그 끝에 붙이는 순차 쓰기뿐이고 페이지는 체크포인트에서만 쓴다.
+ *
+ * 로그는 이미지 파일 이름에 ".wal"을 붙인 파일이다. 로그 헤더의 식별자와
+ * 묶음마다 붙는 LSN을 이미지 헤더 (btree_persist.c)와 대조하여, 이미지 이후에
+ * 커밋된 묶음만 복구 때 다시 적용한다. 체크섬이 맞지 않는 꼬리 (쓰다 만 묶음)는
+ * 버린다.
+ */
+
+#include "btree_internal.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 트랜잭션 작업 */
+#define BTREE_TX_INSERT 1
+#define BTREE_TX_DELETE 2
+
+/* 트랜잭션 (실행 취소/재실행 레코드는 같은 배열, 레코드당 op | 키 | 값) */
+struct btree_transaction {
+    btree_t *tree;
+    unsigned char *records;             /* 적용한 작업 (삭제는 이전 값 보관) */
+    size_t count;
+    size_t capacity;
+};
+
+/* 레코드 크기 (작업 코드 4바이트 + 키 + 값) */
+static size_t btree_tx_record_size(const btree_t *tree) {
+    return sizeof(uint32_t) + tree->key_type.key_size + tree->value_type.value_size;
+}
+
+/* 레코드 추가 (실패 시 false) */
+static bool btree_tx_append(btree_transaction_t *tx, uint32_t op, const void *key,
+                            const void *value) {
+    const btree_t *tree = tx->tree;
+    size_t record_size = btree_tx_record_size(tree);
+
+    if (tx->count == tx->capacity) {
+        size_t capacity = tx->capacity ? tx->capacity * 2 : 16;
+        unsigned char *records = tree->allocator->alloc(capacity * record_size);
+        if (!records) return false;
+        if (tx->records) {
+            memcpy(records, tx->records, tx->count * record_size);
+            tree->allocator->free(tx->records);
+        }
+        tx->records = records;
+        tx->capacity = capacity;
+    }
+
+    unsigned char *record = tx->records + tx->count * record_size;
+    memcpy(record, &op, sizeof(op));
+    memcpy(record + sizeof(op), key, tree->key_type.key_size);
+    if (value) {
+        memcpy(record + sizeof(op) + tree->key_type.key_size, value, tree->value_type.value_size);
+    } else {
+        memset(record + sizeof(op) + tree->key_type.key_size, 0, tree->value_type.value_size);
+    }
+    tx->count++;
+    return true;
+}
+
+static void btree_tx_free(btree_transaction_t *tx) {
+    if (tx->records) tx->tree->allocator->free(tx->records);
+    tx->tree->allocator->free(tx);
+}
+
+#if defined(BTREE_PLATFORM_WINDOWS) || !(defined(__GNUC__) || defined(__clang__))
+
+/* 이 플랫폼에서는 로그를 지원하지 않음 (트랜잭션은 실행 취소만 지원) */
+
+typedef struct btree_wal btree_wal_t;
+
+static void btree_wal_transaction_started(btree_t *tree) { (void)tree; }
+static void btree_wal_transaction_finished(btree_t *tree) { (void)tree; }
+
+static btree_result_t btree_wal_commit(btree_transaction_t *tx) {
+    (void)tx;
+    return BTREE_SUCCESS;
+}
+
+btree_result_t btree_wal_open(btree_t *tree, const char *filename) {
+    (void)tree; (void)filename;
+    return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+}
+
+btree_result_t btree_wal_close(btree_t *tree) {
+    (void)tree;
+    return BTREE_SUCCESS;
+}
+
+btree_result_t btree_checkpoint(btree_t *tree) {
+    (void)tree;
+    return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+}
+
+bool btree_wal_get_stats(const btree_t *tree, btree_wal_stats_t *stats) {
+    (void)tree; (void)stats;
+    return false;
+}
+
+size_t btree_wal_pending(const char *filename, uint64_t log_id, uint64_t log_lsn,
+                         size_t key_size, size_t value_size) {
+    (void)filename; (void)log_id; (void)log_lsn; (void)key_size; (void)value_size;
+    return 0;
+}
+
+btree_result_t btree_wal_replay(btree_t *tree, const char *filename,
+                                uint64_t log_id, uint64_t log_lsn) {
+    (void)tree; (void)filename; (void)log_id; (void)log_lsn;
+    return BTREE_SUCCESS;
+}
+
+#else
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BTREE_WAL_MAGIC "BTREEWL1"
+#define BTREE_WAL_VERSION 1
+#define BTREE_WAL_BATCH_MAGIC 0x4e585442u   /* "BTXN" */
+
+#if defined(__linux__)
+#define btree_wal_sync(fd) fdatasync(fd)
+#else
+#define btree_wal_sync(fd) fsync(fd)
+#endif
+
+/* 로그 파일 헤더 */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint64_t log_id;                    /* 이미지 헤더의 log_id와 대조 */
+    uint32_t checksum;
+    uint32_t padding;
+} btree_wal_header_t;
+
+/* 커밋 묶음 머리 (뒤에 count개의 레코드) */
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+    uint64_t lsn;
+    uint32_t checksum;                  /* 레코드들의 체크섬 (lsn, count 포함) */
+    uint32_t padding;
+} btree_wal_batch_t;
+
+/* 트리에 붙은 로그 (tree->log) */
+typedef struct btree_wal {
+    int fd;
+    char *image_path;                   /* 체크포인트 이미지 경로 */
+    uint64_t log_id;
+    size_t record_size;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t flushed;             /* durable_lsn 갱신 알림 */
+
+    /* 커밋 대기 묶음 (mutex 보호), 리더가 writing과 바꿔 쓴다 */
+    unsigned char *pending;
+    size_t pending_size;
+    size_t pending_capacity;
+    unsigned char *writing;
+    size_t writing_capacity;
+
+    uint64_t last_lsn;                  /* 마지막으로 배정한 LSN */
+    uint64_t durable_lsn;               /* 디스크에 내린 마지막 LSN */
+    bool flushing;                      /* 리더가 쓰는 중 */
+    btree_result_t failure;             /* 쓰기 실패 (이후 커밋도 실패) */
+    size_t active;                      /* 끝나지 않은 트랜잭션 수 */
+
+    btree_wal_stats_t stats;
+} btree_wal_t;
+
+static char* btree_wal_path(const char *filename) {
+    size_t length = strlen(filename);
+    char *path = malloc(length + 5);
+    if (path) {
+        memcpy(path, filename, length);
+        memcpy(path + length, ".wal", 5);
+    }
+    return path;
+}
+
+static uint32_t btree_wal_header_checksum(const btree_wal_header_t *header) {
+    return btree_checksum(header, offsetof(btree_wal_header_t, checksum), BTREE_CHECKSUM_SEED);
+}
+
+static uint32_t btree_wal_batch_checksum(const btree_wal_batch_t *batch, const void *records,
+                                         size_t size) {
+    uint32_t hash = btree_checksum(&batch->count, sizeof(batch->count), BTREE_CHECKSUM_SEED);
+    hash = btree_checksum(&batch->lsn, sizeof(batch->lsn), hash);
+    return btree_checksum(records, size, hash);
+}
+
+/* 전체 쓰기 (중간에 끊긴 write 재시도) */
+static bool btree_wal_write_all(int fd, const void *data, size_t size) {
+    const unsigned char *p = data;
+    while (size > 0) {
+        ssize_t written = write(fd, p, size);
+        if (written < 0) return false;
+        p += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+/* 로그 읽기 상태 */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t offset;                      /* 다음 묶음 위치 */
+} btree_wal_reader_t;
+
+/* 로그 파일 전체 읽기 (헤더 확인 포함), 없거나 맞지 않으면 false */
+static bool btree_wal_read(const char *path, uint64_t log_id, size_t key_size,
+                           size_t value_size, btree_wal_reader_t *reader) {
+    memset(reader, 0, sizeof(*reader));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(btree_wal_header_t);
+    if (ok) {
+        reader->size = (size_t)st.st_size;
+        reader->data = malloc(reader->size);
+        ok = reader->data != NULL;
+    }
+    for (size_t got = 0; ok && got < reader->size;) {
+        ssize_t n = read(fd, reader->data + got, reader->size - got);
+        if (n <= 0) ok = false;
+        else got += (size_t)n;
+    }
+    close(fd);
+
+    if (ok) {
+        btree_wal_header_t header;
+        memcpy(&header, reader->data, sizeof(header));
+        ok = memcmp(header.magic, BTREE_WAL_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == BTREE_WAL_VERSION &&
+             header.header_size == sizeof(btree_wal_header_t) &&
+             header.checksum == btree_wal_header_checksum(&header) &&
+             header.log_id == log_id && header.key_size == key_size &&
+             header.value_size == value_size;
+    }
+    if (!ok) {
+        free(reader->data);
+        reader->data = NULL;
+        return false;
+    }
+    reader->offset = sizeof(btree_wal_header_t);
+    return true;
+}
+
+/* 다음 온전한 커밋 묶음 (없거나 꼬리가 손상되었으면 false) */
+static bool btree_wal_next_batch(btree_wal_reader_t *reader, size_t record_size,
+                                 btree_wal_batch_t *batch, const unsigned char **records) {
+    if (reader->size - reader->offset < sizeof(btree_wal_batch_t)) return false;
+    memcpy(batch, reader->data + reader->offset, sizeof(*batch));
+    if (batch->magic != BTREE_WAL_BATCH_MAGIC) return false;
+
+    size_t available = reader->size - reader->offset - sizeof(btree_wal_batch_t);
+    if (batch->count == 0 || batch->count > available / record_size) return false;
+
+    size_t size = (size_t)batch->count * record_size;
+    *records = reader->data + reader->offset + sizeof(btree_wal_batch_t);
+    if (btree_wal_batch_checksum(batch, *records, size) != batch->checksum) return false;
+
+    reader->offset += sizeof(btree_wal_batch_t) + size;
+    return true;
+}
+
+size_t btree_wal_pending(const char *filename, uint64_t log_id, uint64_t log_lsn,
+                         size_t key_size, size_t value_size) {
+    char *path = btree_wal_path(filename);
+    if (!path) return 0;
+
+    btree_wal_reader_t reader;
+    size_t pending = 0;
+    if (btree_wal_read(path, log_id, key_size, value_size, &reader)) {
+        size_t record_size = sizeof(uint32_t) + key_size + value_size;
+        btree_wal_batch_t batch;
+        const unsigned char *records;
+        while (btree_wal_next_batch(&reader, record_size, &batch, &records)) {
+            if (batch.lsn > log_lsn) pending++;
+        }
+        free(reader.data);
+    }
+    free(path);
+    return pending;
+}
+
+/* 레코드 하나 적용 (이미 반영된 작업은 무시) */
+static btree_result_t btree_wal_apply(btree_t *tree, const unsigned char *record) {
+    uint32_t op;
+    memcpy(&op, record, sizeof(op));
+    const void *key = record + sizeof(op);
+    const void *value = record + sizeof(op) + tree->key_type.key_size;
+
+    btree_result_t result;
+    if (op == BTREE_TX_INSERT) {
+        result = btree_insert(tree, key, value);
+        if (result == BTREE_ERROR_DUPLICATE_KEY) result = BTREE_SUCCESS;
+    } else if (op == BTREE_TX_DELETE) {
+        result = btree_delete(tree, key);
+        if (result == BTREE_ERROR_KEY_NOT_FOUND) result = BTREE_SUCCESS;
+    } else {
+        result = BTREE_ERROR_CORRUPTED;
+    }
+    return result;
+}
+
+btree_result_t btree_wal_replay(btree_t *tree, const char *filename,
+                                uint64_t log_id, uint64_t log_lsn) {
+    char *path = btree_wal_path(filename);
+    if (!path) return BTREE_ERROR_MEMORY_ALLOCATION;
+
+    btree_wal_reader_t reader;
+    btree_result_t result = BTREE_SUCCESS;
+    if (btree_wal_read(path, log_id, tree->key_type.key_size, tree->value_type.value_size,
+                       &reader)) {
+        size_t record_size = btree_tx_record_size(tree);
+        btree_wal_batch_t batch;
+        const unsigned char *records;
+        while (result == BTREE_SUCCESS &&
+               btree_wal_next_batch(&reader, record_size, &batch, &records)) {
+            if (batch.lsn <= log_lsn) continue;
+            for (uint32_t i = 0; i < batch.count && result == BTREE_SUCCESS; i++) {
+                result = btree_wal_apply(tree, records + (size_t)i * record_size);
+            }
+        }
+        free(reader.data);
+    }
+    free(path);
+    return result;
+}
+
+/* 새 로그 파일 생성 (기존 로그는 덮어씀) */
+static btree_result_t btree_wal_create_file(btree_wal_t *wal, const btree_t *tree) {
+    char *path = btree_wal_path(wal->image_path);
+    if (!path) return BTREE_ERROR_MEMORY_ALLOCATION;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    free(path);
+    if (fd < 0) return BTREE_ERROR_IO;
+
+    btree_wal_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BTREE_WAL_MAGIC, sizeof(header.magic));
+    header.version = BTREE_WAL_VERSION;
+    header.header_size = sizeof(btree_wal_header_t);
+    header.key_size = (uint32_t)tree->key_type.key_size;
+    header.value_size = (uint32_t)tree->value_type.value_size;
+    header.log_id = wal->log_id;
+    header.checksum = btree_wal_header_checksum(&header);
+
+    if (!btree_wal_write_all(fd, &header, sizeof(header)) || btree_wal_sync(fd) != 0) {
+        close(fd);
+        return BTREE_ERROR_IO;
+    }
+    wal->fd = fd;
+    return BTREE_SUCCESS;
+}
+
+/* 로그 식별자 (같은 경로에서 다시 만든 로그와 구분되면 충분) */
+static uint64_t btree_wal_new_id(const void *salt) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t id = ((uint64_t)now.tv_sec << 32) ^ (uint64_t)now.tv_nsec ^
+                  ((uint64_t)getpid() << 16) ^ (uint64_t)(uintptr_t)salt;
+    return id ? id : 1;
+}
+
+static void btree_wal_free(btree_wal_t *wal) {
+    if (wal->fd >= 0) close(wal->fd);
+    pthread_cond_destroy(&wal->flushed);
+    pthread_mutex_destroy(&wal->mutex);
+    free(wal->pending);
+    free(wal->writing);
+    free(wal->image_path);
+    free(wal);
+}
+
+/**
+ * @brief 트리에 로그를 붙임
+ *
+ * 현재 트리를 filename에 체크포인트로 저장하고 빈 로그를 새로 시작한다.
+ * 매핑된 트리는 먼저 수정 가능한 노드로 읽어 들인다.
+ */
+btree_result_t btree_wal_open(btree_t *tree, const char *filename) {
+    if (!tree || !filename) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    if (tree->log) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+    /* 로그에는 키와 값의 바이트만 남으므로 포인터 타입은 불가 */
+    if (btree_type_is_pointer(&tree->key_type) || btree_type_is_pointer(&tree->value_type)) {
+        return btree_set_error(BTREE_ERROR_TYPE_MISMATCH), BTREE_ERROR_TYPE_MISMATCH;
+    }
+    if (btree_is_mapped(tree)) {
+        btree_result_t result = btree_storage_materialize(tree);
+        if (result != BTREE_SUCCESS) return btree_set_error(result), result;
+    }
+
+    btree_wal_t *wal = calloc(1, sizeof(btree_wal_t));
+    if (!wal) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    wal->fd = -1;
+    wal->record_size = btree_tx_record_size(tree);
+    wal->log_id = btree_wal_new_id(wal);
+    wal->image_path = malloc(strlen(filename) + 1);
+    pthread_mutex_init(&wal->mutex, NULL);
+    pthread_cond_init(&wal->flushed, NULL);
+    if (!wal->image_path) {
+        btree_wal_free(wal);
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+    strcpy(wal->image_path, filename);
+
+    /* 이미지가 새 로그를 가리키게 한 뒤 로그를 만든다. 그 사이에 멈추면
+     * 로그가 없는 것으로 보고 이미지만 쓴다. */
+    btree_result_t result = btree_persist_save(tree, filename, wal->log_id, 0);
+    if (result == BTREE_SUCCESS) result = btree_wal_create_file(wal, tree);
+    if (result != BTREE_SUCCESS) {
+        btree_wal_free(wal);
+        return btree_set_error(result), result;
+    }
+
+    tree->log = wal;
+    return BTREE_SUCCESS;
+}
+
+/* 대기 중인 묶음을 모두 디스크에 내림 (mutex 보유 상태로 호출) */
+static void btree_wal_drain(btree_wal_t *wal) {
+    while (wal->durable_lsn < wal->last_lsn && wal->failure == BTREE_SUCCESS) {
+        if (wal->flushing) {
+            pthread_cond_wait(&wal->flushed, &wal->mutex);
+            continue;
+        }
+
+        /* 리더: 쌓인 묶음을 한 번에 쓴다. 그동안 다른 커밋은 새 버퍼에 쌓인다. */
+        unsigned char *buffer = wal->pending;
+        size_t capacity = wal->pending_capacity;
+        size_t size = wal->pending_size;
+        uint64_t lsn = wal->last_lsn;
+        wal->pending = wal->writing;
+        wal->pending_capacity = wal->writing_capacity;
+        wal->pending_size = 0;
+        wal->writing = buffer;
+        wal->writing_capacity = capacity;
+        wal->flushing = true;
+        pthread_mutex_unlock(&wal->mutex);
+
+        bool ok = btree_wal_write_all(wal->fd, buffer, size) && btree_wal_sync(wal->fd) == 0;
+
+        pthread_mutex_lock(&wal->mutex);
+        wal->flushing = false;
+        if (ok) {
+            wal->durable_lsn = lsn;
+            wal->stats.syncs++;
+            wal->stats.bytes_written += size;
+        } else {
+            wal->failure = BTREE_ERROR_IO;
+        }
+        pthread_cond_broadcast(&wal->flushed);
+    }
+}
+
+/* 대기 버퍼에 공간 확보 (mutex 보유) */
+static bool btree_wal_reserve(btree_wal_t *wal, size_t size) {
+    if (wal->pending_size + size <= wal->pending_capacity) return true;
+
+    size_t capacity = wal->pending_capacity ? wal->pending_capacity : 64 * 1024;
+    while (capacity < wal->pending_size + size) capacity *= 2;
+    unsigned char *buffer = realloc(wal->pending, capacity);
+    if (!buffer) return false;
+    wal->pending = buffer;
+    wal->pending_capacity = capacity;
+    if (capacity > wal->stats.buffer_capacity) wal->stats.buffer_capacity = capacity;
+    return true;
+}
+
+/* 커밋: 묶음을 붙이고 디스크에 내려질 때까지 대기 */
+static btree_result_t btree_wal_commit(btree_transaction_t *tx) {
+    btree_wal_t *wal = tx->tree->log;
+    if (!wal || tx->count == 0) return BTREE_SUCCESS;
+
+    size_t size = tx->count * wal->record_size;
+    btree_result_t result = BTREE_SUCCESS;
+
+    pthread_mutex_lock(&wal->mutex);
+    if (wal->failure != BTREE_SUCCESS) {
+        result = wal->failure;
+    } else if (!btree_wal_reserve(wal, sizeof(btree_wal_batch_t) + size)) {
+        result = BTREE_ERROR_MEMORY_ALLOCATION;
+    } else {
+        btree_wal_batch_t batch;
+        memset(&batch, 0, sizeof(batch));
+        batch.magic = BTREE_WAL_BATCH_MAGIC;
+        batch.count = (uint32_t)tx->count;
+        batch.lsn = ++wal->last_lsn;
+        batch.checksum = btree_wal_batch_checksum(&batch, tx->records, size);
+
+        memcpy(wal->pending + wal->pending_size, &batch, sizeof(batch));
+        memcpy(wal->pending + wal->pending_size + sizeof(batch), tx->records, size);
+        wal->pending_size += sizeof(batch) + size;
+        wal->stats.commits++;
+
+        uint64_t lsn = batch.lsn;
+        while (wal->durable_lsn < lsn && wal->failure == BTREE_SUCCESS) {
+            btree_wal_drain(wal);
+        }
+        if (wal->durable_lsn < lsn) result = wal->failure;
+    }
+    pthread_mutex_unlock(&wal->mutex);
+    return result;
+}
+
+static void btree_wal_transaction_started(btree_t *tree) {
+    btree_wal_t *wal = tree->log;
+    if (!wal) return;
+    pthread_mutex_lock(&wal->mutex);
+    wal->active++;
+    pthread_mutex_unlock(&wal->mutex);
+}
+
+static void btree_wal_transaction_finished(btree_t *tree) {
+    btree_wal_t *wal = tree->log;
+    if (!wal) return;
+    pthread_mutex_lock(&wal->mutex);
+    wal->active--;
+    pthread_mutex_unlock(&wal->mutex);
+}
+
+/**
+ * @brief 로그를 이미지에 반영하고 비움
+ *
+ * 진행 중인 트랜잭션이 있으면 커밋되지 않은 변경이 이미지에 들어가므로
+ * BTREE_ERROR_INVALID_OPERATION을 반환한다. 동시 모드 트리는 이미지로 쓸 수
+ * 없다 (btree_persist_save가 거부).
+ */
+btree_result_t btree_checkpoint(btree_t *tree) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    btree_wal_t *wal = tree->log;
+    if (!wal) {
+        return btree_set_error(BTREE_ERROR_INVALID_OPERATION), BTREE_ERROR_INVALID_OPERATION;
+    }
+
+    pthread_mutex_lock(&wal->mutex);
+    btree_wal_drain(wal);
+    btree_result_t result = wal->failure;
+    if (result == BTREE_SUCCESS && wal->active > 0) result = BTREE_ERROR_INVALID_OPERATION;
+
+    /* 이미지에 LSN을 기록한 뒤 로그를 비운다. 그 사이에 멈추면 로그의 묶음은
+     * 모두 이미지 LSN 이하이므로 복구 때 건너뛴다. */
+    if (result == BTREE_SUCCESS) {
+        result = btree_persist_save(tree, wal->image_path, wal->log_id, wal->last_lsn);
+    }
+    if (result == BTREE_SUCCESS &&
+        (ftruncate(wal->fd, sizeof(btree_wal_header_t)) != 0 ||
+         lseek(wal->fd, 0, SEEK_END) < 0 || btree_wal_sync(wal->fd) != 0)) {
+        result = BTREE_ERROR_IO;
+    }
+    if (result == BTREE_SUCCESS) wal->stats.checkpoints++;
+    pthread_mutex_unlock(&wal->mutex);
+
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
+
+/**
+ * @brief 로그 분리 (커밋된 묶음은 이미 디스크에 있으므로 체크포인트 없이 닫음)
+ */
+btree_result_t btree_wal_close(btree_t *tree) {
+    if (!tree) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    btree_wal_t *wal = tree->log;
+    if (!wal) return BTREE_SUCCESS;
+
+    pthread_mutex_lock(&wal->mutex);
+    btree_wal_drain(wal);
+    btree_result_t result = wal->failure;
+    pthread_mutex_unlock(&wal->mutex);
+
+    tree->log = NULL;
+    btree_wal_free(wal);
+    return result;
+}
+
+/**
+ * @brief 로그 통계
+ */
+bool btree_wal_get_stats(const btree_t *tree, btree_wal_stats_t *stats) {
+    if (!tree || !stats || !tree->log) return false;
+    btree_wal_t *wal = tree->log;
+
+    pthread_mutex_lock(&wal->mutex);
+    *stats = wal->stats;
+    stats->last_lsn = wal->last_lsn;
+    stats->durable_lsn = wal->durable_lsn;
+    pthread_mutex_unlock(&wal->mutex);
+    return true;
+}
+
+#endif
+
+/**
+ * @brief 트랜잭션 시작
+ */
+btree_transaction_t* btree_transaction_begin(btree_t *tree) {
+    if (!tree) {
+        btree_set_error(BTREE_ERROR_NULL_POINTER);
+        return NULL;
+    }
+    if (btree_is_mapped(tree)) {
+        btree_set_error(BTREE_ERROR_INVALID_OPERATION);
+        return NULL;
+    }
+
+    btree_transaction_t *tx = tree->allocator->alloc(sizeof(btree_transaction_t));
+    if (!tx) {
+        btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION);
+        return NULL;
+    }
+    memset(tx, 0, sizeof(*tx));
+    tx->tree = tree;
+    btree_wal_transaction_started(tree);
+    return tx;
+}
+
+/**
+ * @brief 트랜잭션 안에서 삽입 (트리에 바로 적용)
+ */
+btree_result_t btree_transaction_insert(btree_transaction_t *tx, const void *key,
+                                        const void *value) {
+    if (!tx || !key) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    /* 되돌릴 기록을 먼저 확보해야 적용한 뒤 실패하지 않음 */
+    if (!btree_tx_append(tx, BTREE_TX_INSERT, key, value)) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    btree_result_t result = btree_insert(tx->tree, key, value);
+    if (result != BTREE_SUCCESS) tx->count--;
+    return result;
+}
+
+/**
+ * @brief 트랜잭션 안에서 삭제 (이전 값은 실행 취소 버퍼에 보관)
+ */
+btree_result_t btree_transaction_delete(btree_transaction_t *tx, const void *key) {
+    if (!tx || !key) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+    btree_t *tree = tx->tree;
+    if (!btree_tx_append(tx, BTREE_TX_DELETE, key, NULL)) {
+        return btree_set_error(BTREE_ERROR_MEMORY_ALLOCATION), BTREE_ERROR_MEMORY_ALLOCATION;
+    }
+
+    unsigned char *record = tx->records + (tx->count - 1) * btree_tx_record_size(tree);
+    void *old_value = record + sizeof(uint32_t) + tree->key_type.key_size;
+    btree_result_t result = tree->value_type.value_size > 0
+                          ? btree_get(tree, key, old_value)
+                          : (btree_contains(tree, key) ? BTREE_SUCCESS : BTREE_ERROR_KEY_NOT_FOUND);
+    if (result == BTREE_SUCCESS) result = btree_delete(tree, key);
+    if (result != BTREE_SUCCESS) {
+        tx->count--;
+        btree_set_error(result);
+    }
+    return result;
+}
+
+/**
+ * @brief 트랜잭션 커밋
+ *
+ * 로그가 붙어 있으면 재실행 레코드가 디스크에 내려진 뒤 반환한다. 동시에
+ * 커밋하는 트랜잭션은 한 번의 fdatasync를 함께 쓴다. 로그 쓰기에 실패하면
+ * 변경을 되돌리고 오류를 반환한다. 트랜잭션은 성공 여부와 무관하게 해제된다.
+ */
+btree_result_t btree_transaction_commit(btree_transaction_t *tx) {
+    if (!tx) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    btree_result_t result = btree_wal_commit(tx);
+    if (result != BTREE_SUCCESS) {
+        btree_transaction_rollback(tx);
+        return btree_set_error(result), result;
+    }
+
+    btree_wal_transaction_finished(tx->tree);
+    btree_tx_free(tx);
+    return BTREE_SUCCESS;
+}
+
+/**
+ * @brief 트랜잭션 롤백 (적용한 작업을 역순으로 되돌리고 해제)
+ */
+btree_result_t btree_transaction_rollback(btree_transaction_t *tx) {
+    if (!tx) {
+        return btree_set_error(BTREE_ERROR_NULL_POINTER), BTREE_ERROR_NULL_POINTER;
+    }
+
+    btree_t *tree = tx->tree;
+    size_t record_size = btree_tx_record_size(tree);
+    btree_result_t result = BTREE_SUCCESS;
+
+    for (size_t i = tx->count; i-- > 0;) {
+        const unsigned char *record = tx->records + i * record_size;
+        uint32_t op;
+        memcpy(&op, record, sizeof(op));
+        const void *key = record + sizeof(op);
+        const void *value = record + sizeof(op) + tree->key_type.key_size;
+
+        btree_result_t r = (op == BTREE_TX_INSERT) ? btree_delete(tree, key)
+                                                   : btree_insert(tree, key, value);
+        if (r != BTREE_SUCCESS && result == BTREE_SUCCESS) result = r;
+    }
+
+    btree_wal_transaction_finished(tree);
+    btree_tx_free(tx);
+    if (result != BTREE_SUCCESS) btree_set_error(result);
+    return result;
+}
@@ -8,8 +8,26 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* 긴 문자열 키 복사본 할당 (test_strkey_fail이면 실패를 흉내 냄) */
+static int test_strkey_fail = 0;
+static void* test_strkey_alloc(size_t size) {
+    return test_strkey_fail ? NULL : malloc(size);
+}
+#define BTREE_STRKEY_ALLOC test_strkey_alloc
+
 #include "../include/btree.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define TEST_HAS_FORK 1
+#endif
+
 /* 테스트 매크로 */
 #define TEST_ASSERT(condition, message) \
     do { \
@@ -41,6 +59,10 @@ static int test_passes = 0;
 BTREE_DECLARE_INT_INT(test_int);
 BTREE_DEFINE_INT_INT(test_int);
 
+/* 인라인 문자열 키 B-Tree 정의 */
+BTREE_DECLARE_STRKEY(test_str, int)
+BTREE_DEFINE_STRKEY(test_str, int, int)
+
 /**
  * @brief 테스트 시작 매크로
  */
@@ -282,56 +304,3509 @@ bool test_tree_clear() {
 }
 
 /**
- * @brief 메모리 풀 테스트
+ * @brief 단일 블록 노드 레이아웃 테스트
  */
-bool test_memory_pool() {
-    btree_memory_pool_t *pool = btree_pool_create(64, 64 * 1024, BTREE_POOL_FLAG_ZERO_MEMORY);
-    TEST_ASSERT_NOT_NULL(pool, "메모리 풀 생성 실패");
+bool test_inline_node_layout() {
+    btree_test_int_t *tree = btree_test_int_create(8);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_INLINE_NODES;
     
-    /* 메모리 할당 테스트 */
-    void *ptr1 = btree_pool_alloc(pool);
-    TEST_ASSERT_NOT_NULL(ptr1, "풀에서 메모리 할당 실패");
+    for (int i = 0; i < 2000; i++) {
+        btree_result_t result = btree_test_int_insert(tree, i, i * 7);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, result, "단일 블록 노드 삽입 실패");
+    }
     
-    void *ptr2 = btree_pool_alloc(pool);
-    TEST_ASSERT_NOT_NULL(ptr2, "풀에서 두 번째 메모리 할당 실패");
-    TEST_ASSERT_NE(ptr1, ptr2, "동일한 메모리 주소가 할당됨");
+    for (int i = 0; i < 2000; i++) {
+        int *value = btree_test_int_search(tree, i);
+        TEST_ASSERT_NOT_NULL(value, "단일 블록 노드에서 키를 찾을 수 없음");
+        TEST_ASSERT_EQ(i * 7, *value, "단일 블록 노드의 값이 올바르지 않음");
+    }
     
-    /* 메모리 소속 확인 */
-    TEST_ASSERT(btree_pool_contains(pool, ptr1), "할당된 메모리가 풀에 속하지 않음");
-    TEST_ASSERT(btree_pool_contains(pool, ptr2), "할당된 메모리가 풀에 속하지 않음");
+    /* 헤더와 배열이 하나의 정렬된 블록 안에 있는지 확인 */
+    btree_node_t *root = tree->base.root;
+    TEST_ASSERT(root->is_inline, "루트가 단일 블록 노드가 아님");
+    TEST_ASSERT_EQ(0, (uintptr_t)root % BTREE_CACHE_LINE_SIZE, "노드가 캐시 라인에 정렬되지 않음");
+    TEST_ASSERT((char*)root->keys > (char*)root, "키 배열이 블록 밖에 있음");
+    TEST_ASSERT((char*)root->children > (char*)root->keys, "자식 배열 위치가 올바르지 않음");
+    TEST_ASSERT((char*)root->values > (char*)root->children, "값 배열 위치가 올바르지 않음");
+    
+    btree_statistics_t stats;
+    btree_collect_statistics(&tree->base, &stats);
+    TEST_ASSERT_EQ(2000, stats.key_count, "통계의 키 수가 올바르지 않음");
+    TEST_ASSERT_EQ(tree->base.node_count, stats.node_count, "통계의 노드 수가 올바르지 않음");
+    TEST_ASSERT_EQ(stats.leaf_count + stats.internal_count, stats.node_count, "노드 분류가 맞지 않음");
+    TEST_ASSERT_EQ(tree->base.total_memory, stats.memory_usage, "메모리 사용량이 일치하지 않음");
     
-    /* 통계 확인 */
-    btree_pool_stats_t stats;
-    btree_pool_get_stats(pool, &stats);
-    TEST_ASSERT(stats.used_blocks >= 2, "사용된 블록 수가 올바르지 않음");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 정렬된 입력 일괄 적재 테스트
+ */
+bool test_bulk_insert_sorted() {
+    const int count = 10000;
+    int *keys = malloc(count * sizeof(int));
+    int *values = malloc(count * sizeof(int));
+    btree_key_value_pair_t *pairs = malloc(count * sizeof(btree_key_value_pair_t));
+    TEST_ASSERT(keys && values && pairs, "테스트 버퍼 할당 실패");
+    
+    for (int i = 0; i < count; i++) {
+        keys[i] = i * 2;
+        values[i] = i * 5;
+        pairs[i].key = &keys[i];
+        pairs[i].value = &values[i];
+    }
     
-    /* 메모리 해제 */
-    btree_pool_free(pool, ptr1);
-    btree_pool_free(pool, ptr2);
+    const double fill_factors[] = {1.0, 0.7};
+    for (size_t f = 0; f < sizeof(fill_factors)/sizeof(fill_factors[0]); f++) {
+        btree_test_int_t *tree = btree_test_int_create(8);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_fill_factor(&tree->base, fill_factors[f]),
+                       "채움 비율 설정 실패");
+        
+        btree_result_t result = btree_bulk_insert(&tree->base, pairs, count);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, result, "일괄 적재 실패");
+        TEST_ASSERT_EQ((size_t)count, btree_test_int_size(tree), "일괄 적재 후 크기 불일치");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "일괄 적재 후 구조가 유효하지 않음");
+        
+        for (int i = 0; i < count; i++) {
+            int *value = btree_test_int_search(tree, i * 2);
+            TEST_ASSERT_NOT_NULL(value, "일괄 적재한 키를 찾을 수 없음");
+            TEST_ASSERT_EQ(i * 5, *value, "일괄 적재한 값이 올바르지 않음");
+        }
+        TEST_ASSERT_NULL(btree_test_int_search(tree, 1), "없는 키가 발견됨");
+        
+        /* 리프 연결 리스트를 따라 정렬 순서 확인 */
+        btree_node_t *leaf = tree->base.root;
+        while (!leaf->is_leaf) leaf = leaf->children[0];
+        int leaf_keys = 0, last = -1;
+        for (btree_node_t *prev = NULL; leaf; prev = leaf, leaf = leaf->next_leaf) {
+            TEST_ASSERT(leaf->prev_leaf == prev, "리프 역방향 연결이 올바르지 않음");
+            for (int i = 0; i < leaf->num_keys; i++) {
+                int key = ((int*)leaf->keys)[i];
+                TEST_ASSERT(key > last, "리프 순서가 정렬되지 않음");
+                last = key;
+                leaf_keys++;
+            }
+        }
+        TEST_ASSERT(leaf_keys > 0 && leaf_keys < count, "리프 키 수가 올바르지 않음");
+        
+        /* 적재 후 일반 삽입도 정상 동작 */
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, 1, 11), "적재 후 삽입 실패");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "적재 후 삽입으로 구조 손상");
+        
+        btree_test_int_destroy(tree);
+    }
     
-    btree_pool_destroy(pool);
+    free(pairs);
+    free(values);
+    free(keys);
     return true;
 }
 
 /**
- * @brief 오류 처리 테스트
+ * @brief 정렬되지 않은 입력 및 기존 트리 일괄 삽입 테스트
  */
-bool test_error_handling() {
-    /* NULL 포인터 테스트 */
-    btree_result_t result = btree_insert(NULL, NULL, NULL);
-    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, result, "NULL 포인터 오류가 감지되지 않음");
+bool test_bulk_insert_unsorted() {
+    int keys[] = {42, 7, 19, 7, 88, 3, 61, 19, 25, 50, 1, 99, 73, 14, 36};
+    int values[sizeof(keys)/sizeof(keys[0])];
+    const size_t count = sizeof(keys)/sizeof(keys[0]);
+    btree_key_value_pair_t pairs[sizeof(keys)/sizeof(keys[0])];
+    
+    for (size_t i = 0; i < count; i++) {
+        values[i] = (int)i;
+        pairs[i].key = &keys[i];
+        pairs[i].value = &values[i];
+    }
     
-    void *search_result = btree_search(NULL, NULL);
-    TEST_ASSERT_NULL(search_result, "NULL 트리에서 검색이 성공함");
+    btree_test_int_t *tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
     
-    /* 잘못된 차수 테스트 */
-    btree_test_int_t *invalid_tree = btree_test_int_create(1);  /* 최소 차수보다 작음 */
-    TEST_ASSERT_NULL(invalid_tree, "잘못된 차수로 트리가 생성됨");
+    btree_result_t result = btree_bulk_insert(&tree->base, pairs, count);
+    TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, result, "중복 키가 보고되지 않음");
+    TEST_ASSERT_EQ(count - 2, btree_test_int_size(tree), "중복 제거 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "정렬 적재 후 구조가 유효하지 않음");
+    
+    /* 먼저 나온 항목이 유지되어야 함 */
+    TEST_ASSERT_EQ(1, *btree_test_int_search(tree, 7), "중복 키의 첫 값이 유지되지 않음");
+    TEST_ASSERT_EQ(2, *btree_test_int_search(tree, 19), "중복 키의 첫 값이 유지되지 않음");
+    
+    /* 비어 있지 않은 트리에 추가 적재 */
+    int more_keys[] = {2, 100, 42, 55};
+    int more_values[] = {200, 1000, 420, 550};
+    btree_key_value_pair_t more[4];
+    for (int i = 0; i < 4; i++) {
+        more[i].key = &more_keys[i];
+        more[i].value = &more_values[i];
+    }
+    result = btree_bulk_insert(&tree->base, more, 4);
+    TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, result, "기존 키 중복이 보고되지 않음");
+    TEST_ASSERT_EQ(count + 1, btree_test_int_size(tree), "추가 적재 후 크기 불일치");
+    TEST_ASSERT_EQ(0, *btree_test_int_search(tree, 42), "기존 값이 덮어써짐");
+    TEST_ASSERT_EQ(550, *btree_test_int_search(tree, 55), "추가 적재 값이 올바르지 않음");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "추가 적재 후 구조가 유효하지 않음");
     
-    /* 오류 문자열 테스트 */
-    const char *error_msg = btree_error_string(BTREE_ERROR_MEMORY_ALLOCATION);
-    TEST_ASSERT_NOT_NULL(error_msg, "오류 문자열이 NULL임");
-    TEST_ASSERT(strlen(error_msg) > 0, "오류 문자열이 비어있음");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 비어 있지 않은 트리에 대한 일괄 갱신/병합 테스트
+ */
+bool test_batch_upsert() {
+    enum { N = 4000, BATCH = 300 };
+    int *keys = malloc(BATCH * sizeof(int));
+    int *values = malloc(BATCH * sizeof(int));
+    int *expected = malloc(3 * N * sizeof(int));
+    btree_key_value_pair_t *pairs = malloc(BATCH * sizeof(btree_key_value_pair_t));
+    TEST_ASSERT(keys && values && expected && pairs, "테스트 버퍼 할당 실패");
+    
+    for (int variant = 0; variant < 2; variant++) {
+        for (int lazy = 0; lazy < 2; lazy++) {
+            btree_test_int_t *tree = btree_test_int_create(4);
+            TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+            if (variant) {
+                TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS),
+                               "변형 설정 실패");
+            }
+            if (lazy) {
+                TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true),
+                               "지연 삭제 설정 실패");
+            }
+            
+            /* 짝수 키로 채운 뒤 일부 삭제 (-1은 없음) */
+            for (int k = 0; k < 3 * N; k++) expected[k] = -1;
+            for (int k = 0; k < 2 * N; k += 2) {
+                btree_test_int_insert(tree, k, k);
+                expected[k] = k;
+            }
+            for (int k = 0; k < 2 * N; k += 10) {
+                btree_test_int_delete(tree, k);
+                expected[k] = -1;
+            }
+            
+            /* 기존 키, 삭제된 키, 새 키, 배치 내 중복이 섞인 무작위 배치 */
+            srand(1700 + variant * 2 + lazy);
+            for (int round = 0; round < 20; round++) {
+                int batch = 1 + rand() % BATCH;
+                for (int i = 0; i < batch; i++) {
+                    keys[i] = rand() % (3 * N);
+                    values[i] = round * 100000 + i;
+                    pairs[i].key = &keys[i];
+                    pairs[i].value = &values[i];
+                }
+                TEST_ASSERT_EQ(BTREE_SUCCESS, btree_batch_upsert(&tree->base, pairs, (size_t)batch),
+                               "일괄 갱신 실패");
+                /* 같은 키는 마지막 항목이 이김 */
+                for (int i = 0; i < batch; i++) expected[keys[i]] = values[i];
+                TEST_ASSERT(btree_validate_structure(&tree->base), "일괄 갱신 후 구조가 유효하지 않음");
+            }
+            
+            /* 순차 구간 병합: 리프를 여러 번 채우며 분할 */
+            for (int i = 0; i < BATCH; i++) {
+                keys[i] = 2 * N + 1 + 3 * i;
+                values[i] = -keys[i];
+                pairs[i].key = &keys[i];
+                pairs[i].value = &values[i];
+            }
+            btree_result_t result = btree_bulk_insert(&tree->base, pairs, BATCH);
+            TEST_ASSERT(result == BTREE_SUCCESS || result == BTREE_ERROR_DUPLICATE_KEY,
+                        "일괄 삽입 실패");
+            for (int i = 0; i < BATCH; i++) {
+                if (expected[keys[i]] == -1) expected[keys[i]] = values[i];
+            }
+            TEST_ASSERT(btree_validate_structure(&tree->base), "일괄 삽입 후 구조가 유효하지 않음");
+            
+            size_t live = 0;
+            for (int k = 0; k < 3 * N; k++) {
+                int *value = btree_test_int_search(tree, k);
+                if (expected[k] == -1) {
+                    TEST_ASSERT_NULL(value, "없어야 할 키가 발견됨");
+                } else {
+                    TEST_ASSERT_NOT_NULL(value, "갱신한 키를 찾을 수 없음");
+                    TEST_ASSERT_EQ(expected[k], *value, "갱신한 값이 올바르지 않음");
+                    live++;
+                }
+            }
+            TEST_ASSERT_EQ(live, btree_test_int_size(tree), "일괄 갱신 후 크기 불일치");
+            
+            btree_test_int_destroy(tree);
+        }
+    }
+    
+    /* 빈 트리 갱신은 적재와 같고, 중복 허용 트리는 거부 */
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    for (int i = 0; i < 3; i++) {
+        keys[i] = 5;
+        values[i] = i;
+        pairs[i].key = &keys[i];
+        pairs[i].value = &values[i];
+    }
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_batch_upsert(&tree->base, pairs, 3), "빈 트리 갱신 실패");
+    TEST_ASSERT_EQ(1, btree_test_int_size(tree), "빈 트리 갱신 후 크기 불일치");
+    TEST_ASSERT_EQ(2, *btree_test_int_search(tree, 5), "마지막 항목이 이기지 않음");
+    btree_test_int_destroy(tree);
+    
+    tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_ALLOW_DUPLICATES;
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_batch_upsert(&tree->base, pairs, 3),
+                   "중복 허용 트리 갱신이 거부되지 않음");
+    btree_test_int_destroy(tree);
+    
+    free(pairs);
+    free(expected);
+    free(values);
+    free(keys);
+    return true;
+}
+
+/* 두 서브트리의 모양과 키가 같은지 확인 */
+static bool test_same_shape(const btree_node_t *a, const btree_node_t *b) {
+    if (a->is_leaf != b->is_leaf || a->num_keys != b->num_keys) return false;
+    if (memcmp(a->keys, b->keys, a->num_keys * sizeof(int)) != 0) return false;
+    for (int i = 0; !a->is_leaf && i <= a->num_keys; i++) {
+        if (!test_same_shape(a->children[i], b->children[i])) return false;
+    }
+    return true;
+}
+
+/* 병렬 집계 상태: 항목 수, 값 합계, 처음과 마지막 키, 키 순서 유지 여부 */
+typedef struct {
+    size_t count;
+    long long sum;
+    int first;
+    int last;
+    bool ordered;
+} test_range_sum_t;
+
+static void test_range_sum_init(void *state, void *context) {
+    (void)context;
+    test_range_sum_t *sum = state;
+    memset(sum, 0, sizeof(*sum));
+    sum->ordered = true;
+}
+
+static bool test_range_sum_visit(const void *key, const void *value, void *state, void *context) {
+    test_range_sum_t *sum = state;
+    int k = *(const int*)key;
+    if (sum->count > 0 && k <= sum->last) sum->ordered = false;
+    if (sum->count == 0) sum->first = k;
+    sum->last = k;
+    sum->count++;
+    sum->sum += *(const int*)value;
+    /* context가 있으면 그 수만큼 방문한 조각은 멈춤 */
+    return !context || sum->count < *(const size_t*)context;
+}
+
+static void test_range_sum_merge(void *into, const void *from, void *context) {
+    (void)context;
+    test_range_sum_t *a = into;
+    const test_range_sum_t *b = from;
+    if (b->count == 0) return;
+    if (a->count > 0 && b->first <= a->last) a->ordered = false;
+    if (a->count == 0) a->first = b->first;
+    a->last = b->last;
+    a->count += b->count;
+    a->sum += b->sum;
+    a->ordered = a->ordered && b->ordered;
+}
+
+static bool test_count_visit(const void *key, const void *value, void *state, void *context) {
+    (void)key; (void)value; (void)state;
+    __atomic_add_fetch((size_t*)context, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * @brief 병렬 적재와 병렬 범위 집계 테스트
+ */
+bool test_parallel_bulk_and_scan() {
+    enum { N = 60000 };
+    int *keys = malloc(N * sizeof(int));
+    int *values = malloc(N * sizeof(int));
+    btree_key_value_pair_t *pairs = malloc(N * sizeof(btree_key_value_pair_t));
+    TEST_ASSERT(keys && values && pairs, "테스트 버퍼 할당 실패");
+    
+    /* 섞인 짝수 키 (일부 중복) */
+    srand(2027);
+    for (int i = 0; i < N; i++) {
+        keys[i] = 2 * i;
+    }
+    for (int i = N - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int swap = keys[i]; keys[i] = keys[j]; keys[j] = swap;
+    }
+    for (int i = 0; i < N; i++) {
+        if (i % 1000 == 999) keys[i] = keys[i - 1];
+        values[i] = keys[i] / 2;
+        pairs[i].key = &keys[i];
+        pairs[i].value = &values[i];
+    }
+    
+    for (int variant = 0; variant < 2; variant++) {
+        for (int lazy = 0; lazy < 2; lazy++) {
+            btree_test_int_t *serial = btree_test_int_create(8);
+            btree_test_int_t *tree = btree_test_int_create(8);
+            TEST_ASSERT(serial && tree, "B-Tree 생성 실패");
+            if (variant) {
+                btree_set_variant(&serial->base, BTREE_VARIANT_PLUS);
+                btree_set_variant(&tree->base, BTREE_VARIANT_PLUS);
+            }
+            if (lazy) btree_set_lazy_delete(&tree->base, true);
+            
+            /* 직렬 적재와 모양, 집계가 같아야 함 (지연 삭제 트리는 삭제 표시 배열만 더 큼) */
+            TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, btree_bulk_insert(&serial->base, pairs, N),
+                           "직렬 적재 중복이 보고되지 않음");
+            TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY,
+                           btree_bulk_insert_parallel(&tree->base, pairs, N, 4),
+                           "병렬 적재 중복이 보고되지 않음");
+            TEST_ASSERT(btree_validate_structure(&tree->base), "병렬 적재 후 구조가 유효하지 않음");
+            TEST_ASSERT_EQ(btree_test_int_size(serial), btree_test_int_size(tree), "병렬 적재 후 크기 불일치");
+            TEST_ASSERT_EQ(serial->base.height, tree->base.height, "병렬 적재 후 높이 불일치");
+            TEST_ASSERT_EQ(serial->base.node_count, tree->base.node_count, "병렬 적재 후 노드 수 불일치");
+            if (!lazy) {
+                TEST_ASSERT_EQ(serial->base.total_memory, tree->base.total_memory, "병렬 적재 후 메모리 집계 불일치");
+            }
+            TEST_ASSERT(test_same_shape(serial->base.root, tree->base.root), "병렬 적재 모양이 직렬과 다름");
+            
+            /* 지연 삭제 트리는 삭제 표시된 키를 건너뜀 */
+            long long total = 0;
+            size_t live = 0;
+            for (int k = 0; k < 2 * N; k += 2) {
+                if (lazy && k % 6 == 0) {
+                    btree_test_int_delete(tree, k);
+                    continue;
+                }
+                if (btree_test_int_search(tree, k)) {
+                    total += k / 2;
+                    live++;
+                }
+            }
+            
+            btree_aggregate_t aggregate = {
+                sizeof(test_range_sum_t), test_range_sum_init, test_range_sum_visit,
+                test_range_sum_merge, NULL
+            };
+            test_range_sum_t sum;
+            TEST_ASSERT_EQ(BTREE_SUCCESS,
+                           btree_parallel_aggregate(&tree->base, NULL, NULL, &aggregate, &sum, 4),
+                           "병렬 집계 실패");
+            TEST_ASSERT_EQ(live, sum.count, "병렬 집계 항목 수 불일치");
+            TEST_ASSERT_EQ(total, sum.sum, "병렬 집계 합계 불일치");
+            TEST_ASSERT(sum.ordered, "병렬 집계 조각 순서가 키 순서가 아님");
+            
+            /* 임의 범위 (경계는 있는 키와 없는 키 모두) */
+            for (int round = 0; round < 50; round++) {
+                int lo = rand() % (2 * N + 10) - 5;
+                int hi = lo + rand() % (2 * N / (1 + round % 8));
+                long long expect_sum = 0;
+                size_t expect_count = 0;
+                for (int k = lo < 0 ? 0 : lo; k <= hi && k < 2 * N; k++) {
+                    if (k % 2 == 0 && !(lazy && k % 6 == 0) && btree_test_int_search(tree, k)) {
+                        expect_sum += k / 2;
+                        expect_count++;
+                    }
+                }
+                TEST_ASSERT_EQ(BTREE_SUCCESS,
+                               btree_parallel_aggregate(&tree->base, &lo, &hi, &aggregate, &sum,
+                                                        round % 5),
+                               "범위 병렬 집계 실패");
+                TEST_ASSERT_EQ(expect_count, sum.count, "범위 집계 항목 수 불일치");
+                TEST_ASSERT_EQ(expect_sum, sum.sum, "범위 집계 합계 불일치");
+                TEST_ASSERT(sum.ordered, "범위 집계 순서 불일치");
+            }
+            
+            /* 상태 없는 순회와 조각별 중단 */
+            size_t visited = 0;
+            TEST_ASSERT_EQ(BTREE_SUCCESS,
+                           btree_parallel_scan(&tree->base, NULL, NULL, test_count_visit, &visited, 0),
+                           "병렬 순회 실패");
+            TEST_ASSERT_EQ(live, visited, "병렬 순회 항목 수 불일치");
+            size_t limit = 10;
+            aggregate.context = &limit;
+            TEST_ASSERT_EQ(BTREE_SUCCESS,
+                           btree_parallel_aggregate(&tree->base, NULL, NULL, &aggregate, &sum, 4),
+                           "중단한 병렬 집계 실패");
+            TEST_ASSERT(sum.count >= limit && sum.count < live, "visit가 false를 반환해도 멈추지 않음");
+            
+            btree_test_int_destroy(serial);
+            btree_test_int_destroy(tree);
+        }
+    }
+    
+    /* 빈 범위, 빈 트리와 잘못된 인자 */
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    btree_aggregate_t aggregate = {
+        sizeof(test_range_sum_t), test_range_sum_init, test_range_sum_visit,
+        test_range_sum_merge, NULL
+    };
+    test_range_sum_t sum;
+    TEST_ASSERT_EQ(BTREE_SUCCESS,
+                   btree_parallel_aggregate(&tree->base, NULL, NULL, &aggregate, &sum, 4),
+                   "빈 트리 집계 실패");
+    TEST_ASSERT_EQ(0, sum.count, "빈 트리 집계 항목 수 불일치");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_bulk_insert_parallel(&tree->base, pairs, 100, 0),
+                   "작은 병렬 적재 실패");
+    int lo = 50, hi = 10;
+    TEST_ASSERT_EQ(BTREE_SUCCESS,
+                   btree_parallel_aggregate(&tree->base, &lo, &hi, &aggregate, &sum, 4),
+                   "뒤집힌 범위 집계 실패");
+    TEST_ASSERT_EQ(0, sum.count, "뒤집힌 범위에서 항목이 나옴");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER,
+                   btree_parallel_scan(&tree->base, NULL, NULL, NULL, NULL, 4),
+                   "visit 없이 순회가 허용됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER,
+                   btree_parallel_aggregate(&tree->base, NULL, NULL, &aggregate, NULL, 4),
+                   "결과 없이 집계가 허용됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_SIZE,
+                   btree_bulk_insert_parallel(&tree->base, pairs, 100, -1),
+                   "음수 스레드 수가 허용됨");
+    btree_test_int_destroy(tree);
+    
+    free(pairs);
+    free(values);
+    free(keys);
+    return true;
+}
+
+/* 할당 횟수를 세는 테스트용 할당자 */
+static size_t counting_alloc_calls = 0;
+
+static void* counting_alloc(size_t size) {
+    counting_alloc_calls++;
+    return malloc(size);
+}
+
+static void counting_free(void *ptr) {
+    free(ptr);
+}
+
+/**
+ * @brief 선제 분할 삽입 경로 테스트 (노드 외 할당 없음)
+ */
+bool test_insert_no_temp_allocations() {
+    btree_allocator_t allocator = { counting_alloc, counting_free, NULL, NULL, 0, 0, NULL, NULL };
+    btree_test_int_t *tree = btree_test_int_create_with_allocator(4, &allocator);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_INLINE_NODES;
+    
+    counting_alloc_calls = 0;
+    srand(12345);
+    int inserted = 0;
+    for (int i = 0; i < 5000; i++) {
+        int key = rand() % 20000;
+        btree_result_t result = btree_test_int_insert(tree, key, key + 1);
+        TEST_ASSERT(result == BTREE_SUCCESS || result == BTREE_ERROR_DUPLICATE_KEY, "삽입 실패");
+        if (result == BTREE_SUCCESS) inserted++;
+    }
+    
+    /* 단일 블록 레이아웃에서는 노드당 정확히 한 번 할당 */
+    TEST_ASSERT_EQ(tree->base.node_count, counting_alloc_calls, "노드 외 할당이 발생함");
+    TEST_ASSERT_EQ((size_t)inserted, btree_test_int_size(tree), "삽입 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "삽입 후 구조가 유효하지 않음");
+    
+    srand(12345);
+    for (int i = 0; i < 5000; i++) {
+        int key = rand() % 20000;
+        int *value = btree_test_int_search(tree, key);
+        TEST_ASSERT_NOT_NULL(value, "삽입한 키를 찾을 수 없음");
+        TEST_ASSERT_EQ(key + 1, *value, "검색된 값이 올바르지 않음");
+    }
+    
+    btree_test_int_destroy(tree);
+    
+    /* 중복 허용 모드 */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_ALLOW_DUPLICATES;
+    for (int i = 0; i < 300; i++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, i % 10, i), "중복 허용 삽입 실패");
+    }
+    TEST_ASSERT_EQ(300, btree_test_int_size(tree), "중복 허용 삽입 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "중복 허용 트리 구조가 유효하지 않음");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 오른쪽 끝 추가 빠른 경로와 연속 추가 감지 분할 테스트
+ */
+bool test_append_path() {
+    const int n = 30000;
+    for (int plus = 0; plus <= 1; plus++) {
+        btree_test_int_t *tree = btree_test_int_create(16);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        if (plus) btree_set_variant(&tree->base, BTREE_VARIANT_PLUS);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_enable_metrics(&tree->base, BTREE_METRICS_COUNTERS),
+                       "계측 켜기 실패");
+        
+        /* 순차 키는 대부분 리프 하나만 방문하고, 힌트 없이도 노드가 거의 가득 참 */
+        for (int key = 0; key < n; key++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, key), "순차 삽입 실패");
+        }
+        btree_metrics_t metrics;
+        btree_metrics_snapshot(&tree->base, &metrics);
+        TEST_ASSERT(metrics.nodes_visited < (uint64_t)n * 5 / 4, "순차 삽입이 루트부터 내려감");
+        TEST_ASSERT(tree->base.node_count * 24 < (size_t)n, "연속 추가에서 치우친 분할을 쓰지 않음");
+        TEST_ASSERT_NOT_NULL(tree->base.append_leaf, "오른쪽 끝 리프를 기억하지 않음");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "순차 삽입 후 구조 검증 실패");
+        TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, btree_test_int_insert(tree, n - 1, 0),
+                       "마지막 키 중복이 거부되지 않음");
+        
+        /* 끝을 지우고, 가운데 넣고, 스냅숏을 뜬 뒤에도 추가는 올바른 리프로 감 */
+        for (int key = n - 1; key >= n - 500; key--) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, key), "끝 키 삭제 실패");
+        }
+        for (int key = 1; key < n - 500; key += 97) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, key), "가운데 삭제 실패");
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, -key), "가운데 삽입 실패");
+        }
+        btree_t snapshot;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snapshot, &tree->base), "스냅숏 생성 실패");
+        TEST_ASSERT_NULL(snapshot.append_leaf, "스냅숏이 원본 리프를 기억함");
+        for (int key = n - 500; key < n + 2000; key++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, key), "재추가 실패");
+        }
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_compact(&tree->base), "재배치 실패");
+        for (int key = n + 2000; key < n + 3000; key++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, key), "재배치 후 추가 실패");
+        }
+        TEST_ASSERT(btree_validate_structure(&tree->base), "섞인 변경 후 구조 검증 실패");
+        TEST_ASSERT(btree_validate_structure(&snapshot), "스냅숏 구조 검증 실패");
+        TEST_ASSERT_EQ((size_t)(n + 3000), btree_test_int_size(tree), "추가 후 크기 불일치");
+        for (int key = 0; key < n + 3000; key++) {
+            int *value = btree_test_int_search(tree, key);
+            TEST_ASSERT_NOT_NULL(value, "추가한 키를 찾을 수 없음");
+            TEST_ASSERT_EQ(key % 97 == 1 && key < n - 500 ? -key : key, *value, "값 불일치");
+        }
+        TEST_ASSERT_NULL(btree_search(&snapshot, &(int){ n }), "스냅숏에 원본 추가가 보임");
+        btree_cleanup(&snapshot);
+        
+        /* 무작위 삽입은 보통 분할로 되돌아감 */
+        btree_clear(&tree->base);
+        srand(777);
+        for (int i = 0; i < n; i++) {
+            btree_result_t result = btree_test_int_insert(tree, rand() % 1000000, i);
+            TEST_ASSERT(result == BTREE_SUCCESS || result == BTREE_ERROR_DUPLICATE_KEY, "무작위 삽입 실패");
+        }
+        TEST_ASSERT(tree->base.node_count * 24 > tree->base.key_count, "무작위 삽입이 치우쳐 분할됨");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "무작위 삽입 후 구조 검증 실패");
+        btree_test_int_destroy(tree);
+    }
+    return true;
+}
+
+/**
+ * @brief 운영 계측 (카운터, 지연 시간 히스토그램, 스냅숏) 테스트
+ */
+bool test_metrics() {
+    btree_allocator_t allocator = { counting_alloc, counting_free, NULL, NULL, 0, 0, NULL, NULL };
+    btree_test_int_t *tree = btree_test_int_create_with_allocator(4, &allocator);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    
+    /* 켜기 전에는 아무것도 세지 않음 */
+    btree_metrics_t metrics;
+    btree_test_int_insert(tree, -1, 0);
+    btree_metrics_snapshot(&tree->base, &metrics);
+    TEST_ASSERT_EQ(0, metrics.operations[BTREE_METRIC_INSERT], "꺼진 계측이 연산을 셈");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_enable_metrics(&tree->base, 0x80),
+                   "알 수 없는 계측 플래그가 거부되지 않음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_enable_metrics(&tree->base, BTREE_METRICS_LATENCY),
+                   "계측 켜기 실패");
+    
+    counting_alloc_calls = 0;
+    const int n = 3000;
+    for (int i = 0; i < n; i++) btree_test_int_insert(tree, i, i);
+    for (int i = 0; i < n + 100; i++) btree_test_int_search(tree, i);
+    for (int i = 0; i < n; i += 2) btree_test_int_delete(tree, i);
+    
+    btree_metrics_snapshot(&tree->base, &metrics);
+    TEST_ASSERT_EQ((uint64_t)n, metrics.operations[BTREE_METRIC_INSERT], "삽입 수 불일치");
+    TEST_ASSERT_EQ((uint64_t)n + 100, metrics.operations[BTREE_METRIC_SEARCH], "검색 수 불일치");
+    TEST_ASSERT_EQ((uint64_t)n / 2, metrics.operations[BTREE_METRIC_DELETE], "삭제 수 불일치");
+    TEST_ASSERT_EQ((uint64_t)counting_alloc_calls, metrics.node_allocs, "노드 할당 수 불일치");
+    TEST_ASSERT(metrics.splits > 0 && metrics.merges > 0 && metrics.node_frees > 0,
+                "분할/병합/해제가 세어지지 않음");
+    TEST_ASSERT(metrics.nodes_visited >= 2 * (uint64_t)n, "노드 방문 수가 너무 적음");
+    TEST_ASSERT(metrics.comparisons >= metrics.nodes_visited, "비교 수가 방문 수보다 적음");
+    
+    for (int op = 0; op < BTREE_METRIC_OP_COUNT; op++) {
+        uint64_t recorded = 0;
+        for (int b = 0; b < BTREE_LATENCY_BUCKETS; b++) recorded += metrics.latency[op][b];
+        TEST_ASSERT_EQ(metrics.operations[op], recorded, "히스토그램 합이 연산 수와 다름");
+        
+        uint64_t p50 = btree_metrics_percentile(&metrics, op, 0.5);
+        uint64_t p99 = btree_metrics_percentile(&metrics, op, 0.99);
+        uint64_t max = btree_metrics_percentile(&metrics, op, 1.0);
+        TEST_ASSERT(p50 <= p99 && p99 <= max && max > 0, "분위수 순서가 올바르지 않음");
+    }
+    
+    FILE *output = tmpfile();
+    TEST_ASSERT_NOT_NULL(output, "임시 파일 생성 실패");
+    btree_print_statistics(&tree->base, output);
+    TEST_ASSERT(ftell(output) > 0, "통계가 출력되지 않음");
+    fclose(output);
+    
+    /* 초기화 후 카운터만 켜면 히스토그램은 비어 있음 */
+    btree_metrics_reset(&tree->base);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_enable_metrics(&tree->base, BTREE_METRICS_COUNTERS),
+                   "계측 플래그 변경 실패");
+    btree_test_int_search(tree, 1);
+    btree_metrics_snapshot(&tree->base, &metrics);
+    TEST_ASSERT_EQ(1, metrics.operations[BTREE_METRIC_SEARCH], "초기화 후 검색 수 불일치");
+    TEST_ASSERT_EQ(0, metrics.operations[BTREE_METRIC_INSERT], "초기화되지 않은 카운터");
+    TEST_ASSERT_EQ(0, btree_metrics_percentile(&metrics, BTREE_METRIC_SEARCH, 0.5),
+                   "카운터 모드에서 지연 시간이 기록됨");
+    
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_enable_metrics(&tree->base, 0), "계측 끄기 실패");
+    btree_metrics_snapshot(&tree->base, &metrics);
+    TEST_ASSERT_EQ(0, metrics.operations[BTREE_METRIC_SEARCH], "꺼진 계측의 스냅숏이 비어 있지 않음");
+    
+    /* 켠 채로 소멸해도 누수 없음 */
+    btree_enable_metrics(&tree->base, BTREE_METRICS_COUNTERS);
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/* 분위수가 실제 값보다 작지 않고 문서의 상대 오차 (1/16) 이내로 큼 */
+static bool test_percentile_close(const btree_metrics_t *metrics, double quantile, uint64_t expected) {
+    uint64_t actual = btree_metrics_percentile(metrics, BTREE_METRIC_SEARCH, quantile);
+    return actual >= expected && actual - expected <= expected / 16;
+}
+
+/**
+ * @brief 알려진 분포에서 지연 시간 분위수의 정확도 테스트
+ */
+bool test_metrics_percentiles() {
+    enum { N = 100000 };
+    const double quantiles[] = {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0};
+    static btree_metrics_t metrics;
+    
+    /* 균등 분포 1..N ns: rank번째 값은 rank */
+    memset(&metrics, 0, sizeof(metrics));
+    for (uint64_t v = 1; v <= N; v++) btree_metrics_record(&metrics, BTREE_METRIC_SEARCH, v);
+    for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+        uint64_t rank = (uint64_t)(quantiles[q] * N + 0.5);
+        TEST_ASSERT(test_percentile_close(&metrics, quantiles[q], rank), "균등 분포 분위수 오차가 큼");
+    }
+    
+    /* 로그 균등 분포 10ns..10ms (꼬리가 긴 지연 시간) */
+    static uint64_t values[N];
+    memset(&metrics, 0, sizeof(metrics));
+    for (int i = 0; i < N; i++) {
+        values[i] = (uint64_t)(10.0 * exp(log(1e6) * i / (N - 1)));
+        btree_metrics_record(&metrics, BTREE_METRIC_SEARCH, values[i]);
+    }
+    for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+        uint64_t rank = (uint64_t)(quantiles[q] * N + 0.5);
+        TEST_ASSERT(test_percentile_close(&metrics, quantiles[q], values[rank - 1]),
+                    "로그 균등 분포 분위수 오차가 큼");
+    }
+    
+    /* 작은 값은 정확히, 가장 큰 값도 넘치지 않고 기록 */
+    memset(&metrics, 0, sizeof(metrics));
+    btree_metrics_record(&metrics, BTREE_METRIC_SEARCH, 3);
+    TEST_ASSERT_EQ(3, btree_metrics_percentile(&metrics, BTREE_METRIC_SEARCH, 1.0), "작은 값이 정확하지 않음");
+    btree_metrics_record(&metrics, BTREE_METRIC_SEARCH, UINT64_MAX);
+    TEST_ASSERT_EQ(UINT64_MAX, btree_metrics_percentile(&metrics, BTREE_METRIC_SEARCH, 1.0),
+                   "최댓값 버킷 상한이 올바르지 않음");
+    TEST_ASSERT_EQ(0, btree_metrics_percentile(&metrics, BTREE_METRIC_INSERT, 0.5), "다른 연산에 기록됨");
+    return true;
+}
+
+/* 이벤트 테스트용 수집기 */
+typedef struct {
+    size_t counts[BTREE_EVENT_COUNT];
+    size_t batches;
+    size_t buffered;
+    uint64_t last_sequence;
+    bool ordered;
+    int last_key;
+    const void *last_value;
+} test_event_log_t;
+
+static void test_event_callback(btree_t *tree, btree_event_type_t event,
+                                const void *key, const void *value, void *context) {
+    (void)tree;
+    test_event_log_t *log = context;
+    log->counts[event]++;
+    log->last_key = *(const int*)key;
+    log->last_value = value;
+}
+
+static void test_event_batch(btree_t *tree, const btree_event_record_t *events,
+                             size_t count, void *context) {
+    (void)tree;
+    test_event_log_t *log = context;
+    log->batches++;
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].sequence != log->last_sequence + 1) log->ordered = false;
+        log->last_sequence = events[i].sequence;
+        log->counts[events[i].type]++;
+        if (events[i].type == BTREE_EVENT_INSERT &&
+            *(const int*)events[i].value != *(const int*)events[i].key * 3) {
+            log->ordered = false;
+        }
+    }
+    log->buffered += count;
+}
+
+/**
+ * @brief 이벤트 훅 (연산별 콜백과 묶음 버퍼) 테스트
+ */
+bool test_events() {
+    btree_test_int_t *tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    
+    test_event_log_t log;
+    memset(&log, 0, sizeof(log));
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION,
+                   btree_set_event_callback(&tree->base, BTREE_EVENT_COUNT, test_event_callback, &log),
+                   "알 수 없는 이벤트가 거부되지 않음");
+    for (int e = 0; e < BTREE_EVENT_COUNT; e++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS,
+                       btree_set_event_callback(&tree->base, e, test_event_callback, &log),
+                       "이벤트 콜백 등록 실패");
+    }
+    
+    for (int i = 0; i < 500; i++) btree_test_int_insert(tree, i, i * 3);
+    TEST_ASSERT_EQ(500, log.counts[BTREE_EVENT_INSERT], "삽입 이벤트 수 불일치");
+    TEST_ASSERT(log.counts[BTREE_EVENT_SPLIT] > 0, "분할 이벤트가 없음");
+    TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, btree_test_int_insert(tree, 7, 0), "중복 삽입이 성공함");
+    TEST_ASSERT_EQ(500, log.counts[BTREE_EVENT_INSERT], "실패한 삽입이 이벤트를 보냄");
+    
+    int *found = btree_test_int_search(tree, 42);
+    TEST_ASSERT_EQ(42, log.last_key, "검색 이벤트 키 불일치");
+    TEST_ASSERT(log.last_value == found, "검색 이벤트 값이 검색 결과와 다름");
+    btree_test_int_search(tree, 9999);
+    TEST_ASSERT_NULL(log.last_value, "없는 키의 검색 이벤트 값이 NULL이 아님");
+    TEST_ASSERT_EQ(2, log.counts[BTREE_EVENT_SEARCH], "검색 이벤트 수 불일치");
+    
+    for (int i = 0; i < 400; i++) btree_test_int_delete(tree, i);
+    TEST_ASSERT_EQ(400, log.counts[BTREE_EVENT_DELETE], "삭제 이벤트 수 불일치");
+    TEST_ASSERT(log.counts[BTREE_EVENT_MERGE] > 0, "병합 이벤트가 없음");
+    
+    /* 모든 구독을 해제하면 이벤트 상태가 사라짐 */
+    for (int e = 0; e < BTREE_EVENT_COUNT; e++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_remove_event_callback(&tree->base, e), "콜백 해제 실패");
+    }
+    TEST_ASSERT_NULL(tree->base.events, "구독 해제 후 이벤트 상태가 남음");
+    btree_test_int_search(tree, 450);
+    TEST_ASSERT_EQ(2, log.counts[BTREE_EVENT_SEARCH], "해제한 콜백이 불림");
+    btree_test_int_destroy(tree);
+    
+    /* 묶음 버퍼: 가득 찰 때마다 한 번 호출, 나머지는 flush */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    memset(&log, 0, sizeof(log));
+    log.ordered = true;
+    TEST_ASSERT_EQ(BTREE_SUCCESS,
+                   btree_set_event_buffer(&tree->base, BTREE_EVENT_MASK(BTREE_EVENT_INSERT) |
+                                          BTREE_EVENT_MASK(BTREE_EVENT_SPLIT), 16,
+                                          test_event_batch, &log),
+                   "이벤트 버퍼 설정 실패");
+    for (int i = 0; i < 100; i++) btree_test_int_insert(tree, i, i * 3);
+    btree_test_int_search(tree, 5);
+    size_t total = 100 + log.counts[BTREE_EVENT_SPLIT];
+    TEST_ASSERT(log.batches > 0 && log.buffered % 16 == 0, "가득 찬 버퍼만 전달되어야 함");
+    size_t pending = btree_flush_events(&tree->base);
+    TEST_ASSERT_EQ(total % 16, pending, "flush로 전달한 수가 올바르지 않음");
+    TEST_ASSERT_EQ(total, log.buffered, "전달된 이벤트 수 불일치");
+    TEST_ASSERT_EQ(0, btree_flush_events(&tree->base), "빈 버퍼 flush가 이벤트를 전달함");
+    TEST_ASSERT_EQ(100, log.counts[BTREE_EVENT_INSERT], "버퍼 삽입 이벤트 수 불일치");
+    TEST_ASSERT_EQ(0, log.counts[BTREE_EVENT_SEARCH], "구독하지 않은 이벤트가 쌓임");
+    TEST_ASSERT(log.ordered, "이벤트 순서나 사본이 올바르지 않음");
+    
+    /* 비어 있지 않은 트리의 일괄 삽입도 새 키마다 이벤트 */
+    int keys[50], values[50];
+    btree_key_value_pair_t pairs[50];
+    for (int i = 0; i < 50; i++) {
+        keys[i] = 80 + i;
+        values[i] = keys[i] * 3;
+        pairs[i].key = &keys[i];
+        pairs[i].value = &values[i];
+    }
+    btree_bulk_insert(&tree->base, pairs, 50);
+    btree_flush_events(&tree->base);
+    TEST_ASSERT_EQ(130, log.counts[BTREE_EVENT_INSERT], "일괄 삽입 이벤트 수 불일치");
+    TEST_ASSERT(log.ordered, "일괄 삽입 이벤트 순서가 올바르지 않음");
+    
+    /* 정리하면 남은 이벤트를 보내고 상태를 해제 */
+    btree_test_int_insert(tree, 1000, 3000);
+    btree_test_int_destroy(tree);
+    TEST_ASSERT_EQ(131, log.counts[BTREE_EVENT_INSERT], "정리 시 남은 이벤트가 전달되지 않음");
+    return true;
+}
+
+/* 기준 검색 (compare 기반 선형 탐색) */
+static int reference_find(const void *keys, int count, const void *key, size_t size,
+                          btree_compare_func_t compare) {
+    for (int i = 0; i < count; i++) {
+        int cmp = compare(key, (const char*)keys + i * size);
+        if (cmp == 0) return i;
+        if (cmp < 0) return -(i + 1);
+    }
+    return -(count + 1);
+}
+
+/**
+ * @brief 타입 특화 노드 내 검색 커널 테스트
+ */
+bool test_search_kernels() {
+    int ikeys[70];
+    long lkeys[70];
+    double dkeys[70];
+    unsigned long long ukeys[70];
+    const int thresholds[] = {1, 4, BTREE_LINEAR_SEARCH_THRESHOLD, 100};
+    
+    srand(4242);
+    for (int count = 0; count <= 70; count++) {
+        int v = -200;
+        for (int i = 0; i < count; i++) {
+            v += 1 + rand() % 4;
+            ikeys[i] = v;
+            lkeys[i] = (long)v * 100000L;
+            dkeys[i] = v * 0.5;
+            ukeys[i] = (unsigned long long)(v + 1000);
+        }
+        
+        for (int probe = -210; probe <= v + 10; probe++) {
+            long lprobe = (long)probe * 100000L;
+            double dprobe = probe * 0.5;
+            unsigned long long uprobe = (unsigned long long)(probe + 1000);
+            
+            for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); t++) {
+                TEST_ASSERT_EQ(reference_find(ikeys, count, &probe, sizeof(int), btree_compare_int),
+                               btree_search_int(ikeys, count, &probe, thresholds[t]),
+                               "int 검색 결과 불일치");
+                TEST_ASSERT_EQ(reference_find(lkeys, count, &lprobe, sizeof(long), btree_compare_long),
+                               btree_search_long(lkeys, count, &lprobe, thresholds[t]),
+                               "long 검색 결과 불일치");
+                TEST_ASSERT_EQ(reference_find(dkeys, count, &dprobe, sizeof(double), btree_compare_double),
+                               btree_search_double(dkeys, count, &dprobe, thresholds[t]),
+                               "double 검색 결과 불일치");
+                TEST_ASSERT_EQ(reference_find(ukeys, count, &uprobe, sizeof(unsigned long long),
+                                              btree_compare_ullong),
+                               btree_search_ullong(ukeys, count, &uprobe, thresholds[t]),
+                               "unsigned long long 검색 결과 불일치");
+            }
+        }
+    }
+    
+    /* 부호 없는 키: 부호 비트 경계 (2^31, 2^63)와 양 끝값 주변 */
+    {
+        const unsigned long long top = 1ULL << 63;
+        const unsigned int utop = 1U << 31;
+        unsigned long long bkeys[24];
+        unsigned int bukeys[24];
+        int n = 0;
+        for (unsigned long long d = 0; d < 4; d++) {
+            bkeys[n] = d;
+            bukeys[n++] = (unsigned int)d;
+        }
+        for (unsigned long long d = 0; d < 16; d++) {
+            bkeys[n] = top - 8 + d;
+            bukeys[n++] = utop - 8 + (unsigned int)d;
+        }
+        for (unsigned long long d = 4; d > 0; d--) {
+            bkeys[n] = ~0ULL - (d - 1);
+            bukeys[n++] = ~0U - (unsigned int)(d - 1);
+        }
+        for (int count = 0; count <= n; count++) {
+            for (int p = 0; p < n; p++) {
+                for (int delta = -1; delta <= 1; delta++) {
+                    unsigned long long bprobe = bkeys[p] + (unsigned long long)(long long)delta;
+                    unsigned int buprobe = bukeys[p] + (unsigned int)delta;
+                    for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); t++) {
+                        TEST_ASSERT_EQ(reference_find(bkeys, count, &bprobe, sizeof(unsigned long long),
+                                                      btree_compare_ullong),
+                                       btree_search_ullong(bkeys, count, &bprobe, thresholds[t]),
+                                       "2^63 경계 unsigned long long 검색 결과 불일치");
+                        TEST_ASSERT_EQ(reference_find(bukeys, count, &buprobe, sizeof(unsigned int),
+                                                      btree_compare_uint),
+                                       btree_search_uint(bukeys, count, &buprobe, thresholds[t]),
+                                       "2^31 경계 unsigned int 검색 결과 불일치");
+                    }
+                }
+            }
+        }
+        
+        /* 커널이 처리한 앞부분과 나머지 스칼라를 합치면 경계 아래 키 수 */
+        int done = 0;
+        int less = btree_simd_count_less_u64(bkeys + 4, 16, top, &done);
+        for (int i = done; i < 16; i++) less += bkeys[4 + i] < top;
+        TEST_ASSERT_EQ(8, less, "u64 커널: 2^63보다 작은 키 수 불일치");
+        less = btree_simd_count_less_u32(bukeys + 4, 16, utop, &done);
+        for (int i = done; i < 16; i++) less += bukeys[4 + i] < utop;
+        TEST_ASSERT_EQ(8, less, "u32 커널: 2^31보다 작은 키 수 불일치");
+    }
+    
+    /* 생성된 트리는 특화 검색을 사용 */
+    btree_test_int_t *tree = btree_test_int_create(8);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT(tree->base.key_type.search == btree_search_int, "특화 검색 함수가 설정되지 않음");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 노드 바이트 예산에 맞춘 자동 차수와 노드 내 검색 방식 테스트
+ */
+bool test_node_sizing() {
+    enum { N = 5000 };
+    btree_type_info_t key_type = { .key_size = sizeof(int), .alignment = sizeof(int) };
+    btree_type_info_t value_type = { .value_size = sizeof(int), .alignment = sizeof(int) };
+    
+    /* 예산이 클수록 차수가 크고, B+Tree는 내부 노드에 값이 없어 더 큼 */
+    int small = btree_degree_for_bytes(&key_type, &value_type, BTREE_VARIANT_STANDARD, 256);
+    int page = btree_degree_for_bytes(&key_type, &value_type, BTREE_VARIANT_STANDARD, 4096);
+    int plus = btree_degree_for_bytes(&key_type, &value_type, BTREE_VARIANT_PLUS, 4096);
+    TEST_ASSERT(small >= BTREE_MIN_DEGREE && small < page, "예산에 따른 차수 증가 실패");
+    TEST_ASSERT(plus > page, "B+Tree 차수가 표준보다 크지 않음");
+    TEST_ASSERT_EQ(BTREE_MIN_DEGREE,
+                   btree_degree_for_bytes(&key_type, &value_type, BTREE_VARIANT_STANDARD, 1),
+                   "예산이 모자라면 최소 차수");
+    TEST_ASSERT_EQ(0, btree_degree_for_bytes(NULL, &value_type, BTREE_VARIANT_STANDARD, 4096),
+                   "NULL 타입은 0");
+    TEST_ASSERT(BTREE_OPTIMAL_DEGREE(sizeof(int), sizeof(int)) > BTREE_DEFAULT_DEGREE,
+                "최적 차수 매크로가 너무 작음");
+    
+    /* 자동 차수: 노드마다 예산 안에 들어가고 변형을 바꾸면 다시 맞춤 */
+    btree_test_int_t *tree = btree_test_int_create(BTREE_DEGREE_AUTO);
+    TEST_ASSERT_NOT_NULL(tree, "자동 차수 B-Tree 생성 실패");
+    TEST_ASSERT_EQ(btree_degree_for_bytes(&key_type, &value_type, BTREE_VARIANT_STANDARD,
+                                          BTREE_DEFAULT_NODE_BYTES),
+                   tree->base.degree, "기본 예산 차수 불일치");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS),
+                   "B+Tree 변형 설정 실패");
+    TEST_ASSERT_EQ(plus, tree->base.degree, "변형 변경 후 차수를 다시 맞추지 않음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_node_bytes(&tree->base, 1024), "노드 예산 설정 실패");
+    for (int i = 0; i < N; i++) {
+        int key = (i * 7919) % N;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, key), "삽입 실패");
+    }
+    TEST_ASSERT((tree->base.total_memory - sizeof(btree_t)) / tree->base.node_count <= 1024,
+                "노드가 예산보다 큼");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_set_node_bytes(&tree->base, 4096),
+                   "빈 트리가 아닌데 예산 변경");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "트리 검증 실패");
+    
+    /* 검색 방식마다 같은 결과 (SIMD 커널이 없는 빌드는 BINARY로 동작) */
+    const btree_search_mode_t modes[] = {
+        BTREE_SEARCH_LINEAR, BTREE_SEARCH_BINARY, BTREE_SEARCH_SIMD, BTREE_SEARCH_AUTO
+    };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_search_mode(&tree->base, modes[m]),
+                       "검색 방식 설정 실패");
+        btree_search_mode_t used = btree_get_search_mode(&tree->base);
+        TEST_ASSERT(used != BTREE_SEARCH_AUTO, "AUTO를 풀지 않음");
+        if (modes[m] != BTREE_SEARCH_AUTO && modes[m] != BTREE_SEARCH_SIMD) {
+            TEST_ASSERT_EQ(modes[m], used, "요청한 검색 방식과 다름");
+        }
+        for (int key = -1; key <= N; key++) {
+            int *value = btree_test_int_search(tree, key);
+            if (key < 0 || key == N) {
+                TEST_ASSERT_NULL(value, "없는 키를 찾음");
+            } else {
+                TEST_ASSERT(value && *value == key, "키 검색 실패");
+            }
+        }
+    }
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION,
+                   btree_set_search_mode(&tree->base, (btree_search_mode_t)99),
+                   "잘못된 검색 방식 허용");
+    btree_test_int_destroy(tree);
+    
+    /* 작은 노드는 이진 탐색 없이 선형으로 셈 */
+    tree = btree_test_int_create(BTREE_MIN_DEGREE);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_SEARCH_LINEAR, btree_get_search_mode(&tree->base), "작은 노드 검색 방식");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+static int test_strcmp_ptr(const void *a, const void *b) {
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+/**
+ * @brief 인라인 문자열 키 (정규화 prefix, 긴 문자열 복사본) 테스트
+ */
+bool test_string_keys() {
+    enum { N = 3000 };
+    static char names[N][96];
+    const char *sorted[N];
+    
+    /* 짧은 키, prefix가 같은 키, 인라인 한도를 넘는 긴 키를 섞음 */
+    for (int i = 0; i < N; i++) {
+        switch (i % 3) {
+            case 0: snprintf(names[i], sizeof(names[i]), "k%d", i); break;
+            case 1: snprintf(names[i], sizeof(names[i]), "/static/%d.css", i); break;
+            default: snprintf(names[i], sizeof(names[i]),
+                              "https://example.com/catalog/items/%d/details?ref=%d", i, i * 7); break;
+        }
+        sorted[i] = names[i];
+    }
+    qsort(sorted, N, sizeof(sorted[0]), test_strcmp_ptr);
+    
+    /* 비교는 strcmp 순서와 같음 */
+    srand(77);
+    for (int i = 0; i < 5000; i++) {
+        const char *a = names[rand() % N], *b = names[rand() % N];
+        btree_strkey_t ka = btree_strkey(a), kb = btree_strkey(b);
+        int expected = strcmp(a, b);
+        int actual = btree_compare_strkey(&ka, &kb);
+        TEST_ASSERT((expected > 0) == (actual > 0) && (expected < 0) == (actual < 0),
+                    "문자열 키 비교가 strcmp와 다름");
+    }
+    btree_strkey_t ka = btree_strkey("abc"), kb = btree_strkey_n("abc\0", 4);
+    TEST_ASSERT(btree_compare_strkey(&ka, &kb) < 0, "접두사 키가 더 길지 않은 키보다 뒤에 옴");
+    
+    const btree_variant_t variants[] = { BTREE_VARIANT_STANDARD, BTREE_VARIANT_PLUS };
+    for (int v = 0; v < 2; v++) {
+        btree_test_str_t *tree = btree_test_str_create(6);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        TEST_ASSERT(tree->base.key_type.search == btree_search_strkey, "문자열 키 검색 함수가 설정되지 않음");
+        
+        for (int i = 0; i < N; i++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_str_insert(tree, btree_strkey(names[i]), i),
+                           "문자열 키 삽입 실패");
+        }
+        TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, btree_test_str_insert(tree, btree_strkey(names[5]), 0),
+                       "중복 문자열 키가 삽입됨");
+        TEST_ASSERT(btree_test_str_validate(tree), "구조가 유효하지 않음");
+        
+        /* 긴 키는 트리가 복사본을 소유하므로 원본을 바꿔도 그대로 */
+        char probe[96];
+        for (int i = 0; i < N; i++) {
+            strcpy(probe, names[i]);
+            int *value = btree_test_str_search(tree, btree_strkey(probe));
+            TEST_ASSERT_NOT_NULL(value, "삽입한 문자열 키를 찾지 못함");
+            TEST_ASSERT_EQ(i, *value, "문자열 키 값 불일치");
+        }
+        TEST_ASSERT(!btree_test_str_contains(tree, btree_strkey("k")), "없는 키가 검색됨");
+        TEST_ASSERT(!btree_test_str_contains(tree, btree_strkey("https://example.com/catalog/items/1")),
+                    "없는 긴 키가 검색됨");
+        
+        /* 순회 순서는 바이트 사전순 */
+        btree_test_str_iterator_t *iter = btree_test_str_iterator_create(tree);
+        btree_strkey_t key;
+        int value, count = 0;
+        while (btree_test_str_iterator_next(iter, &key, &value)) {
+            TEST_ASSERT(count < N, "순회 항목이 너무 많음");
+            TEST_ASSERT_EQ(strlen(sorted[count]), btree_strkey_length(&key), "순회 키 길이 불일치");
+            TEST_ASSERT(memcmp(sorted[count], btree_strkey_data(&key), btree_strkey_length(&key)) == 0,
+                        "순회 순서 불일치");
+            count++;
+        }
+        TEST_ASSERT_EQ(N, count, "순회 항목 수 불일치");
+        btree_test_str_iterator_destroy(iter);
+        
+        for (int i = 0; i < N; i += 2) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_str_delete(tree, btree_strkey(names[i])),
+                           "문자열 키 삭제 실패");
+        }
+        TEST_ASSERT(btree_test_str_validate(tree), "삭제 후 구조가 유효하지 않음");
+        TEST_ASSERT_EQ((size_t)(N / 2), btree_test_str_size(tree), "삭제 후 크기 불일치");
+        for (int i = 0; i < N; i++) {
+            TEST_ASSERT_EQ(i % 2 == 1, btree_test_str_contains(tree, btree_strkey(names[i])),
+                           "삭제 후 키 집합 불일치");
+        }
+        
+        /* 슬롯 밖의 메모리를 소유하므로 저장과 동시 모드는 불가 */
+        TEST_ASSERT_EQ(BTREE_ERROR_TYPE_MISMATCH, btree_save_to_file(&tree->base, "test_btree_str.bin"),
+                       "문자열 키 트리가 저장됨");
+        TEST_ASSERT_EQ(BTREE_ERROR_TYPE_MISMATCH, btree_set_thread_safe(&tree->base, true),
+                       "문자열 키 트리에 동시 모드가 켜짐");
+        btree_test_str_destroy(tree);
+    }
+    return true;
+}
+
+/* 긴 문자열 키 복사가 실패하면 노드를 건드리지 않고 메모리 오류 */
+bool test_strkey_copy_failure() {
+    const int N = 200;
+    char name[64];
+    btree_test_str_t *tree = btree_test_str_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "트리 생성 실패");
+    for (int i = 0; i < N; i += 2) {
+        snprintf(name, sizeof(name), "https://example.com/items/%04d", i);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_str_insert(tree, btree_strkey(name), i), "삽입 실패");
+    }
+    
+    test_strkey_fail = 1;
+    for (int i = 1; i < N; i += 2) {
+        snprintf(name, sizeof(name), "https://example.com/items/%04d", i);
+        TEST_ASSERT_EQ(BTREE_ERROR_MEMORY_ALLOCATION, btree_test_str_insert(tree, btree_strkey(name), i),
+                       "복사 실패가 보고되지 않음");
+        TEST_ASSERT_EQ(BTREE_ERROR_MEMORY_ALLOCATION, btree_get_last_error(), "마지막 오류 불일치");
+    }
+    /* 오른쪽 끝에 붙이는 빠른 경로도 같은 검사를 거침 */
+    TEST_ASSERT_EQ(BTREE_ERROR_MEMORY_ALLOCATION,
+                   btree_test_str_insert(tree, btree_strkey("https://example.com/items/9999"), 0),
+                   "끝 삽입에서 복사 실패가 보고되지 않음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_str_insert(tree, btree_strkey("short"), -1),
+                   "인라인 키는 할당 없이 삽입되어야 함");
+    test_strkey_fail = 0;
+    
+    TEST_ASSERT_EQ((size_t)(N / 2 + 1), btree_test_str_size(tree), "실패한 삽입이 크기에 반영됨");
+    TEST_ASSERT(btree_test_str_validate(tree), "실패 후 구조가 유효하지 않음");
+    for (int i = 0; i < N; i++) {
+        snprintf(name, sizeof(name), "https://example.com/items/%04d", i);
+        TEST_ASSERT_EQ(i % 2 == 0, btree_test_str_contains(tree, btree_strkey(name)), "포함 여부 불일치");
+    }
+    for (int i = 1; i < N; i += 2) {
+        snprintf(name, sizeof(name), "https://example.com/items/%04d", i);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_str_insert(tree, btree_strkey(name), i), "재삽입 실패");
+    }
+    TEST_ASSERT_EQ((size_t)(N + 1), btree_test_str_size(tree), "재삽입 후 크기 불일치");
+    for (int i = 0; i < N; i++) {
+        snprintf(name, sizeof(name), "https://example.com/items/%04d", i);
+        int *value = btree_test_str_search(tree, btree_strkey(name));
+        TEST_ASSERT(value && *value == i, "재삽입 후 값 불일치");
+    }
+    TEST_ASSERT(btree_test_str_validate(tree), "재삽입 후 구조가 유효하지 않음");
+    btree_test_str_destroy(tree);
+    return true;
+}
+
+/* 8바이트 원시 키 (memcmp 순서) */
+static int test_compare_bytes8(const void *a, const void *b) {
+    return memcmp(a, b, 8);
+}
+
+/* sorted에서 prefix로 시작하는 키와 결과 비교 */
+static bool test_prefix_matches(const char **sorted, int n, const char *prefix,
+                                const btree_key_value_pair_t *results, size_t count,
+                                size_t max_results, bool strkey) {
+    size_t expected = 0, plen = strlen(prefix);
+    for (int i = 0; i < n; i++) {
+        if (strncmp(sorted[i], prefix, plen) != 0) continue;
+        if (expected < max_results) {
+            if (expected >= count) return false;
+            const char *key = strkey ? btree_strkey_data(results[expected].key)
+                                     : *(const char * const *)results[expected].key;
+            size_t length = strkey ? btree_strkey_length(results[expected].key) : strlen(key);
+            if (length != strlen(sorted[i]) || memcmp(key, sorted[i], length) != 0) return false;
+        }
+        expected++;
+    }
+    return count == (expected < max_results ? expected : max_results);
+}
+
+/**
+ * @brief 접두사 검색 테스트 (문자열 키, 인라인 문자열 키, 원시 바이트 키)
+ */
+bool test_prefix_search() {
+    enum { N = 2000 };
+    static char names[N][64];
+    const char *sorted[N];
+    static btree_key_value_pair_t results[N];
+    for (int i = 0; i < N; i++) {
+        if (i % 2) {
+            snprintf(names[i], sizeof(names[i]), "https://example.com/item/%d", i);
+        } else {
+            snprintf(names[i], sizeof(names[i]), "k%d", i);
+        }
+        sorted[i] = names[i];
+    }
+    qsort(sorted, N, sizeof(sorted[0]), test_strcmp_ptr);
+    const char *prefixes[] = { "", "k", "k1", "k19", "k1998", "k1998x", "https://example.com/item/1",
+                               "https", "a", "zz", "https://example.com/item/" };
+    const size_t limits[] = { N, 5, 1 };
+    
+    const btree_variant_t variants[] = { BTREE_VARIANT_STANDARD, BTREE_VARIANT_PLUS };
+    for (int v = 0; v < 2; v++) {
+        btree_test_str_t *tree = btree_test_str_create(4);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        for (int i = 0; i < N; i++) {
+            btree_test_str_insert(tree, btree_strkey(names[i]), i);
+        }
+        for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); p++) {
+            for (size_t l = 0; l < sizeof(limits) / sizeof(limits[0]); l++) {
+                size_t count = btree_prefix_search(&tree->base, prefixes[p], strlen(prefixes[p]),
+                                                   results, limits[l]);
+                TEST_ASSERT(test_prefix_matches(sorted, N, prefixes[p], results, count, limits[l], true),
+                            "인라인 문자열 키 접두사 검색 결과 불일치");
+            }
+        }
+        
+        /* 삭제 표시된 키는 건너뜀 */
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+        btree_test_str_delete(tree, btree_strkey("k10"));
+        btree_test_str_delete(tree, btree_strkey("k100"));
+        size_t count = btree_prefix_search(&tree->base, "k10", 3, results, N);
+        TEST_ASSERT_EQ((size_t)54, count, "삭제 표시된 키가 접두사 검색에 포함됨");
+        TEST_ASSERT_EQ(1000, *(int*)results[0].value, "접두사 검색 첫 결과 불일치");
+        btree_test_str_destroy(tree);
+    }
+    
+    /* char* 키: 문자열 자체를 접두사로 */
+    btree_type_info_t cstr_type = {
+        .key_size = sizeof(char*), .alignment = BTREE_ALIGNOF(char*), .type_name = "char*",
+        .compare = btree_compare_string, .search = btree_search_string, .bytes = btree_bytes_string
+    };
+    btree_t cstr;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&cstr, 5, &cstr_type, &btree_test_int_value_type_info, NULL),
+                   "B-Tree 초기화 실패");
+    for (int i = 0; i < N; i++) {
+        const char *key = names[i];
+        btree_insert(&cstr, &key, &i);
+    }
+    for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); p++) {
+        size_t count = btree_prefix_search(&cstr, prefixes[p], strlen(prefixes[p]), results, N);
+        TEST_ASSERT(test_prefix_matches(sorted, N, prefixes[p], results, count, N, false),
+                    "문자열 키 접두사 검색 결과 불일치");
+    }
+    btree_cleanup(&cstr);
+    
+    /* 원시 바이트 키: 키 메모리를 그대로 비교 */
+    btree_type_info_t raw_type = {
+        .key_size = 8, .alignment = 1, .type_name = "char[8]", .compare = test_compare_bytes8
+    };
+    btree_t raw;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&raw, 4, &raw_type, &btree_test_int_value_type_info, NULL),
+                   "B-Tree 초기화 실패");
+    for (int i = 0; i < 256; i++) {
+        unsigned char key[8] = { 0xab, (unsigned char)i, 0, 0, 0, 0, 0, (unsigned char)(i * 3) };
+        btree_insert(&raw, key, &i);
+        key[0] = 0xac;
+        btree_insert(&raw, key, &i);
+    }
+    const unsigned char raw_prefix[] = { 0xab, 0x10 };
+    TEST_ASSERT_EQ((size_t)1, btree_prefix_search(&raw, raw_prefix, 2, results, N), "원시 키 접두사 검색 실패");
+    TEST_ASSERT_EQ(0x10, *(int*)results[0].value, "원시 키 접두사 검색 값 불일치");
+    TEST_ASSERT_EQ((size_t)256, btree_prefix_search(&raw, raw_prefix, 1, results, N),
+                   "원시 키 한 바이트 접두사 검색 실패");
+    btree_cleanup(&raw);
+    
+    /* 바이트 순서가 아닌 타입은 거부 */
+    btree_test_int_t *ints = btree_test_int_create(4);
+    btree_test_int_insert(ints, 1, 1);
+    TEST_ASSERT_EQ((size_t)0, btree_prefix_search(&ints->base, "\x01", 1, results, N), "정수 키 접두사 검색됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_TYPE_MISMATCH, btree_get_last_error(), "정수 키 접두사 검색 오류 불일치");
+    btree_test_int_destroy(ints);
+    return true;
+}
+
+/**
+ * @brief 다중 키 검색 (교차 진행, 프리페치, 정렬) 테스트
+ */
+bool test_search_batch() {
+    enum { N = 5000, BATCH = 600 };
+    static int key_store[BATCH];
+    static const void *keys[BATCH];
+    static void *values[BATCH];
+    const size_t sizes[] = { 0, 1, 17, 63, 64, BATCH };
+    
+    for (int config = 0; config < 4; config++) {
+        btree_test_int_t *tree = btree_test_int_create(config == 2 ? 3 : 8);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        if (config & 1) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS), "변형 설정 실패");
+        }
+        if (config >= 2) tree->base.flags |= BTREE_FLAG_INLINE_NODES;
+        
+        TEST_ASSERT_EQ((size_t)0, btree_search_batch(&tree->base, NULL, 0, NULL), "빈 배치 결과 불일치");
+        for (int i = 0; i < N; i++) {
+            btree_test_int_insert(tree, i * 2, i);
+        }
+        if (config == 3) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+            for (int i = 0; i < 2 * N; i += 6) btree_test_int_delete(tree, i);
+        }
+        
+        srand(99 + config);
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t expected = 0;
+            for (size_t i = 0; i < sizes[s]; i++) {
+                key_store[i] = rand() % (2 * N + 20) - 10;
+                keys[i] = (i % 97 == 5) ? NULL : &key_store[i];
+                values[i] = (void*)&values[i];
+                expected += keys[i] && btree_test_int_search(tree, key_store[i]) != NULL;
+            }
+            TEST_ASSERT_EQ(expected, btree_search_batch(&tree->base, keys, sizes[s], values),
+                           "배치 검색으로 찾은 키 수 불일치");
+            for (size_t i = 0; i < sizes[s]; i++) {
+                void *single = keys[i] ? btree_search(&tree->base, keys[i]) : NULL;
+                TEST_ASSERT(values[i] == single, "배치 검색 결과가 단일 검색과 다름");
+            }
+        }
+        btree_test_int_destroy(tree);
+    }
+    return true;
+}
+
+/**
+ * @brief 삭제 및 병합/재분배 테스트
+ */
+bool test_delete() {
+    btree_test_int_t *tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    
+    const int n = 2000;
+    for (int i = 0; i < n; i++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, i, i * 2), "삽입 실패");
+    }
+    
+    TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, btree_test_int_delete(tree, n + 5),
+                   "없는 키 삭제가 성공함");
+    
+    /* 무작위 순서로 절반 삭제 (내부 노드 키와 병합/회전 경로 포함) */
+    int *order = malloc(n * sizeof(int));
+    TEST_ASSERT_NOT_NULL(order, "메모리 할당 실패");
+    for (int i = 0; i < n; i++) order[i] = i;
+    srand(777);
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+    for (int i = 0; i < n / 2; i++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, order[i]), "삭제 실패");
+        if (i % 97 == 0) {
+            TEST_ASSERT(btree_validate_structure(&tree->base), "삭제 중 구조가 유효하지 않음");
+        }
+    }
+    TEST_ASSERT_EQ((size_t)(n - n / 2), btree_test_int_size(tree), "삭제 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "삭제 후 구조가 유효하지 않음");
+    
+    for (int i = 0; i < n; i++) {
+        int *value = btree_test_int_search(tree, order[i]);
+        if (i < n / 2) {
+            TEST_ASSERT_NULL(value, "삭제된 키가 검색됨");
+        } else {
+            TEST_ASSERT_NOT_NULL(value, "남은 키를 찾을 수 없음");
+            TEST_ASSERT_EQ(order[i] * 2, *value, "남은 키의 값이 올바르지 않음");
+        }
+    }
+    
+    /* 나머지는 일괄 삭제 */
+    const void **keys = malloc((n - n / 2 + 1) * sizeof(void*));
+    TEST_ASSERT_NOT_NULL(keys, "메모리 할당 실패");
+    for (int i = n / 2; i < n; i++) keys[i - n / 2] = &order[i];
+    keys[n - n / 2] = &order[0];  /* 이미 삭제된 키 */
+    TEST_ASSERT_EQ((size_t)(n - n / 2), btree_bulk_delete(&tree->base, keys, n - n / 2 + 1),
+                   "일괄 삭제 수 불일치");
+    TEST_ASSERT(btree_test_int_is_empty(tree), "모두 삭제 후 트리가 비어있지 않음");
+    TEST_ASSERT_EQ(0, btree_test_int_height(tree), "모두 삭제 후 높이가 0이 아님");
+    TEST_ASSERT_EQ(0, tree->base.node_count, "모두 삭제 후 노드가 남음");
+    free(keys);
+    free(order);
+    
+    /* 형제 노드 병합/재분배 API */
+    for (int i = 0; i < 8; i++) {
+        btree_test_int_insert(tree, i, i);
+    }
+    btree_node_t *root = tree->base.root;
+    TEST_ASSERT(!root->is_leaf && root->num_keys >= 1, "예상한 2단 구조가 아님");
+    btree_node_t *left = root->children[0];
+    btree_node_t *right = root->children[1];
+    int left_keys = left->num_keys, right_keys = right->num_keys;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_redistribute_keys(&tree->base, left, right, root->keys),
+                   "재분배 실패");
+    TEST_ASSERT_EQ(left_keys + right_keys, left->num_keys + right->num_keys, "재분배 후 키 수 불일치");
+    TEST_ASSERT(abs(left->num_keys - right->num_keys) <= 1, "재분배 후 균형이 맞지 않음");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "재분배 후 구조가 유효하지 않음");
+    
+    int wrong_sep = 999;
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION,
+                   btree_merge_nodes(&tree->base, left, right, &wrong_sep), "잘못된 구분 키가 허용됨");
+    
+    btree_test_int_delete(tree, 7);
+    btree_test_int_delete(tree, 6);
+    btree_test_int_delete(tree, 5);
+    root = tree->base.root;
+    if (!root->is_leaf && root->children[0]->num_keys + root->children[1]->num_keys + 1 <=
+                          tree->base.max_keys) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS,
+                       btree_merge_nodes(&tree->base, root->children[0], root->children[1], root->keys),
+                       "병합 실패");
+    }
+    TEST_ASSERT(btree_validate_structure(&tree->base), "병합 후 구조가 유효하지 않음");
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_NOT_NULL(btree_test_int_search(tree, i), "병합 후 키를 찾을 수 없음");
+    }
+    
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 지연 삭제 (삭제 표시) 모드 테스트
+ */
+bool test_lazy_delete() {
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    
+    const int n = 1000;
+    for (int i = 0; i < n; i++) {
+        btree_test_int_insert(tree, i, i);
+    }
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+    
+    size_t nodes = tree->base.node_count;
+    for (int i = 0; i < n; i += 2) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, i), "지연 삭제 실패");
+    }
+    TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, btree_test_int_delete(tree, 0), "중복 삭제가 성공함");
+    
+    /* 구조는 그대로, 표시된 키는 보이지 않음 */
+    TEST_ASSERT_EQ(nodes, tree->base.node_count, "지연 삭제가 구조를 변경함");
+    TEST_ASSERT_EQ((size_t)(n / 2), btree_test_int_size(tree), "지연 삭제 후 크기 불일치");
+    TEST_ASSERT_EQ((size_t)(n / 2), tree->base.dead_count, "삭제 표시 수 불일치");
+    TEST_ASSERT_NULL(btree_test_int_search(tree, 10), "삭제 표시된 키가 검색됨");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "지연 삭제 후 구조가 유효하지 않음");
+    
+    /* 재삽입하면 새 값으로 되살아남 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, 10, -10), "재삽입 실패");
+    TEST_ASSERT_EQ(-10, *btree_test_int_search(tree, 10), "되살린 값이 올바르지 않음");
+    TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, btree_test_int_insert(tree, 11, 0), "살아 있는 키 중복 허용됨");
+    
+    /* 새로 만든 노드에도 삭제 표시가 유지됨 */
+    for (int i = n; i < 2 * n; i++) {
+        btree_test_int_insert(tree, i, i);
+    }
+    for (int i = n; i < 2 * n; i += 3) {
+        btree_test_int_delete(tree, i);
+    }
+    TEST_ASSERT(btree_validate_structure(&tree->base), "분할 후 구조가 유효하지 않음");
+    
+    size_t live = btree_test_int_size(tree);
+    size_t dead = tree->base.dead_count;
+    btree_compact(&tree->base);
+    TEST_ASSERT_EQ(0, tree->base.dead_count, "압축 후 삭제 표시가 남음");
+    TEST_ASSERT_EQ(live, btree_test_int_size(tree), "압축 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "압축 후 구조가 유효하지 않음");
+    TEST_ASSERT(dead > 0, "삭제 표시가 없었음");
+    
+    for (int i = 0; i < 2 * n; i++) {
+        bool expected = (i < n) ? (i % 2 == 1 || i == 10) : ((i - n) % 3 != 0);
+        TEST_ASSERT_EQ(expected, btree_test_int_contains(tree, i), "압축 후 키 집합이 올바르지 않음");
+    }
+    
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, false), "지연 삭제 해제 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, 1), "즉시 삭제 실패");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "해제 후 구조가 유효하지 않음");
+    btree_test_int_destroy(tree);
+    
+    /* 중복 허용 트리에서는 사용할 수 없음 */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_ALLOW_DUPLICATES;
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_set_lazy_delete(&tree->base, true),
+                   "중복 허용 트리에서 지연 삭제가 허용됨");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief B+Tree 변형 테스트 (값은 리프에만, 리프 연결)
+ */
+bool test_bplus_tree() {
+    btree_test_int_t *tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS), "변형 설정 실패");
+    TEST_ASSERT_EQ(BTREE_VARIANT_PLUS, btree_get_variant(&tree->base), "변형이 설정되지 않음");
+    
+    srand(99);
+    int inserted = 0;
+    for (int i = 0; i < 3000; i++) {
+        int key = rand() % 5000;
+        btree_result_t result = btree_test_int_insert(tree, key, key * 3);
+        TEST_ASSERT(result == BTREE_SUCCESS || result == BTREE_ERROR_DUPLICATE_KEY, "삽입 실패");
+        if (result == BTREE_SUCCESS) inserted++;
+    }
+    TEST_ASSERT_EQ((size_t)inserted, btree_test_int_size(tree), "삽입 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "B+Tree 구조가 유효하지 않음");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_set_variant(&tree->base, BTREE_VARIANT_STANDARD),
+                   "비어 있지 않은 트리의 변형이 바뀜");
+    
+    /* 내부 노드에는 값이 없고, 리프 연결로 모든 키를 순서대로 방문 */
+    btree_node_t *node = tree->base.root;
+    TEST_ASSERT(!node->is_leaf, "높이가 1임");
+    TEST_ASSERT_NULL(node->values, "내부 노드에 값 배열이 있음");
+    while (!node->is_leaf) node = node->children[0];
+    size_t visited = 0;
+    int prev = -1;
+    for (; node; node = node->next_leaf) {
+        for (int i = 0; i < node->num_keys; i++) {
+            int key = ((int*)node->keys)[i];
+            TEST_ASSERT(key > prev, "리프 연결 순서가 올바르지 않음");
+            TEST_ASSERT_EQ(key * 3, ((int*)node->values)[i], "리프 값이 올바르지 않음");
+            prev = key;
+            visited++;
+        }
+    }
+    TEST_ASSERT_EQ((size_t)inserted, visited, "리프 연결 순회 키 수 불일치");
+    
+    /* 구분 키와 같은 키 포함 삭제 */
+    for (int key = 0; key < 5000; key += 2) {
+        bool present = btree_test_int_contains(tree, key);
+        btree_result_t result = btree_test_int_delete(tree, key);
+        TEST_ASSERT_EQ(present ? BTREE_SUCCESS : BTREE_ERROR_KEY_NOT_FOUND, result, "삭제 결과 불일치");
+        if (present) inserted--;
+    }
+    TEST_ASSERT_EQ((size_t)inserted, btree_test_int_size(tree), "삭제 후 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "삭제 후 B+Tree 구조가 유효하지 않음");
+    for (int key = 1; key < 5000; key += 2) {
+        int *value = btree_test_int_search(tree, key);
+        if (value) TEST_ASSERT_EQ(key * 3, *value, "삭제 후 값이 올바르지 않음");
+    }
+    btree_test_int_destroy(tree);
+    
+    /* 일괄 적재 */
+    tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    btree_set_variant(&tree->base, BTREE_VARIANT_PLUS);
+    const size_t count = 2000;
+    int *keys = malloc(count * sizeof(int));
+    btree_key_value_pair_t *pairs = malloc(count * sizeof(btree_key_value_pair_t));
+    TEST_ASSERT(keys && pairs, "메모리 할당 실패");
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = (int)i * 2;
+        pairs[i].key = &keys[i];
+        pairs[i].value = &keys[i];
+    }
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_bulk_insert(&tree->base, pairs, count), "일괄 적재 실패");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "일괄 적재 후 구조가 유효하지 않음");
+    for (size_t i = 0; i < count; i++) {
+        int *value = btree_test_int_search(tree, keys[i]);
+        TEST_ASSERT(value && *value == keys[i], "일괄 적재 키를 찾을 수 없음");
+        TEST_ASSERT(!btree_test_int_contains(tree, keys[i] + 1), "없는 키가 검색됨");
+    }
+    free(pairs);
+    free(keys);
+    btree_test_int_destroy(tree);
+    
+    /* 큰 값에서는 내부 노드 팬아웃이 커져 높이가 낮아짐 */
+    btree_type_info_t value_type = { 0 };
+    value_type.value_size = 64;
+    value_type.alignment = 8;
+    int heights[2];
+    for (int variant = 0; variant < 2; variant++) {
+        btree_t big;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&big, 4, &btree_test_int_key_type_info, &value_type, NULL),
+                       "초기화 실패");
+        if (variant) {
+            btree_set_variant(&big, BTREE_VARIANT_PLUS);
+            TEST_ASSERT(big.internal_max_keys > big.max_keys, "내부 노드 용량이 커지지 않음");
+        }
+        char payload[64] = { 0 };
+        for (int i = 0; i < 20000; i++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&big, &i, payload), "큰 값 삽입 실패");
+        }
+        TEST_ASSERT(btree_validate_structure(&big), "큰 값 트리 구조가 유효하지 않음");
+        heights[variant] = big.height;
+        btree_cleanup(&big);
+    }
+    TEST_ASSERT(heights[1] < heights[0], "B+Tree 높이가 낮아지지 않음");
+    
+    /* 중복 허용 트리에서는 사용할 수 없음 */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_ALLOW_DUPLICATES;
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS),
+                   "중복 허용 트리에 B+Tree가 설정됨");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/* 스냅숏을 끝까지 순회하며 키 합계를 계산 (다른 스레드가 원본을 쓰는 동안) */
+static void* test_snapshot_scan(void *arg) {
+    btree_t *snap = (btree_t*)arg;
+    long long *sum = malloc(sizeof(long long));
+    *sum = 0;
+    for (int round = 0; round < 20; round++) {
+        btree_iterator_t iter;
+        void *key, *value;
+        btree_iterator_init(&iter, snap, NULL, NULL);
+        while (btree_iterator_next(&iter, &key, &value)) {
+            *sum += *(int*)key;
+        }
+    }
+    return sum;
+}
+
+/* 트리 내용이 참조 배열과 같은지 (ref[k] < 0이면 없는 키), 집계한 노드 수도 확인 */
+static bool test_snapshot_matches(btree_t *tree, const int *ref, int range) {
+    size_t live = 0;
+    for (int k = 0; k < range; k++) {
+        int *value = (int*)btree_search(tree, &k);
+        if ((ref[k] >= 0) != (value != NULL)) return false;
+        if (value && *value != ref[k]) return false;
+        if (value) live++;
+    }
+
+    btree_statistics_t stats;
+    btree_collect_statistics(tree, &stats);
+    return live == btree_size(tree) && stats.node_count == tree->node_count &&
+           btree_validate_structure(tree);
+}
+
+bool test_snapshot() {
+    enum { RANGE = 4000 };
+    static int ref_a[RANGE], ref_b[RANGE], ref_c[RANGE];
+    btree_test_int_t *tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    
+    for (int k = 0; k < RANGE; k++) {
+        ref_a[k] = (k % 2 == 0) ? k : -1;
+        if (ref_a[k] >= 0) btree_test_int_insert(tree, k, k);
+    }
+    
+    /* 스냅숏은 루트 하나의 참조만 늘림 */
+    btree_t snap;
+    size_t nodes = tree->base.node_count;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snap, &tree->base), "스냅숏 생성 실패");
+    TEST_ASSERT(snap.root == tree->base.root, "스냅숏이 루트를 공유하지 않음");
+    TEST_ASSERT_EQ(2, tree->base.root->ref_count, "루트 참조 카운트가 올바르지 않음");
+    TEST_ASSERT_EQ(nodes, snap.node_count, "스냅숏 노드 수 불일치");
+    memcpy(ref_b, ref_a, sizeof(ref_a));
+    
+    /* 첫 쓰기는 루트부터 리프까지의 경로만 복사 */
+    int key = 1, value = 1;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&tree->base, &key, &value), "공유 트리 삽입 실패");
+    ref_a[1] = 1;
+    TEST_ASSERT(snap.root != tree->base.root, "루트가 복사되지 않음");
+    TEST_ASSERT_EQ(1, snap.root->ref_count, "원본 루트 참조가 놓이지 않음");
+    TEST_ASSERT_EQ(nodes, tree->base.node_count, "경로 복사 후 노드 수가 바뀜");
+    TEST_ASSERT_NULL(btree_search(&snap, &key), "원본 쓰기가 스냅숏에 보임");
+    
+    /* 양쪽에 임의의 쓰기, 중간에 스냅숏의 스냅숏 */
+    btree_t nested;
+    srand(21);
+    for (int i = 0; i < 20000; i++) {
+        bool on_snap = rand() % 2;
+        btree_t *target = on_snap ? &snap : &tree->base;
+        int *ref = on_snap ? ref_b : ref_a;
+        int k = rand() % RANGE;
+        int v = rand() % 1000;
+        if (rand() % 3 == 0) {
+            btree_result_t result = btree_delete(target, &k);
+            TEST_ASSERT_EQ(ref[k] >= 0 ? BTREE_SUCCESS : BTREE_ERROR_KEY_NOT_FOUND, result,
+                           "공유 트리 삭제 결과가 올바르지 않음");
+            ref[k] = -1;
+        } else {
+            btree_result_t result = btree_insert(target, &k, &v);
+            TEST_ASSERT_EQ(ref[k] >= 0 ? BTREE_ERROR_DUPLICATE_KEY : BTREE_SUCCESS, result,
+                           "공유 트리 삽입 결과가 올바르지 않음");
+            if (ref[k] < 0) ref[k] = v;
+        }
+        if (i == 10000) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&nested, &snap), "중첩 스냅숏 생성 실패");
+            memcpy(ref_c, ref_b, sizeof(ref_b));
+        }
+    }
+    TEST_ASSERT(test_snapshot_matches(&tree->base, ref_a, RANGE), "원본 내용이 올바르지 않음");
+    TEST_ASSERT(test_snapshot_matches(&snap, ref_b, RANGE), "스냅숏 내용이 올바르지 않음");
+    TEST_ASSERT(test_snapshot_matches(&nested, ref_c, RANGE), "중첩 스냅숏 내용이 올바르지 않음");
+    
+    /* 다른 스레드가 스냅숏을 순회하는 동안 원본에 계속 쓰기 */
+    btree_t frozen;
+    long long frozen_sum = 0;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&frozen, &tree->base), "스냅숏 생성 실패");
+    for (int k = 0; k < RANGE; k++) {
+        if (ref_a[k] >= 0) frozen_sum += k;
+    }
+    pthread_t reader;
+    TEST_ASSERT_EQ(0, pthread_create(&reader, NULL, test_snapshot_scan, &frozen), "스레드 생성 실패");
+    for (int i = 0; i < 20000; i++) {
+        int k = rand() % RANGE;
+        int v = i;
+        if (btree_delete(&tree->base, &k) != BTREE_SUCCESS) {
+            btree_insert(&tree->base, &k, &v);
+        }
+    }
+    void *scanned;
+    pthread_join(reader, &scanned);
+    TEST_ASSERT_EQ(frozen_sum * 20, *(long long*)scanned, "순회 중 스냅숏 내용이 바뀜");
+    free(scanned);
+    btree_cleanup(&frozen);
+    for (int k = 0; k < RANGE; k++) {
+        ref_a[k] = btree_search(&tree->base, &k) ? *(int*)btree_search(&tree->base, &k) : -1;
+    }
+    TEST_ASSERT(btree_validate_structure(&tree->base), "동시 순회 후 원본 구조가 유효하지 않음");
+    
+    /* 공유 중에는 모드를 바꿀 수 없음 */
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_set_thread_safe(&snap, true),
+                   "공유 트리에서 동시 모드가 켜짐");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_set_lazy_delete(&tree->base, true),
+                   "공유 트리에서 지연 삭제가 켜짐");
+    
+    /* 원본을 먼저 정리해도 나머지는 그대로 */
+    btree_test_int_destroy(tree);
+    TEST_ASSERT(test_snapshot_matches(&snap, ref_b, RANGE), "원본 정리 후 스냅숏이 바뀜");
+    btree_cleanup(&snap);
+    TEST_ASSERT(test_snapshot_matches(&nested, ref_c, RANGE), "정리 후 중첩 스냅숏이 바뀜");
+    btree_clear(&nested);
+    TEST_ASSERT_EQ(0, nested.node_count, "비운 스냅숏의 노드 수가 남음");
+    TEST_ASSERT(!(nested.flags & BTREE_FLAG_SHARED), "비운 트리에 공유 표시가 남음");
+    btree_cleanup(&nested);
+    
+    /* 지연 삭제 모드: 삭제 표시도 경로 복사를 거침 */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+    for (int k = 0; k < 500; k++) btree_test_int_insert(tree, k, k);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snap, &tree->base), "스냅숏 생성 실패");
+    for (int k = 0; k < 500; k += 2) btree_test_int_delete(tree, k);
+    TEST_ASSERT_EQ((size_t)250, btree_test_int_size(tree), "지연 삭제 후 크기 불일치");
+    TEST_ASSERT_EQ((size_t)500, btree_size(&snap), "지연 삭제가 스냅숏에 보임");
+    btree_purge_tombstones(&tree->base);
+    for (int k = 0; k < 500; k++) {
+        TEST_ASSERT_EQ(k % 2 == 1, btree_test_int_contains(tree, k), "원본 키 집합이 올바르지 않음");
+        TEST_ASSERT(btree_contains(&snap, &k), "스냅숏 키가 사라짐");
+    }
+    TEST_ASSERT(btree_validate_structure(&tree->base), "원본 구조가 유효하지 않음");
+    TEST_ASSERT(btree_validate_structure(&snap), "스냅숏 구조가 유효하지 않음");
+    btree_test_int_destroy(tree);
+    btree_cleanup(&snap);
+    
+    /* 소멸 함수가 있는 키: 마지막 참조를 놓을 때 한 번만 소멸 */
+    btree_test_str_t *strs = btree_test_str_create(3);
+    TEST_ASSERT_NOT_NULL(strs, "B-Tree 생성 실패");
+    char name[64];
+    for (int i = 0; i < 300; i++) {
+        snprintf(name, sizeof(name), "https://example.com/snapshot/item/%04d", i);
+        btree_test_str_insert(strs, btree_strkey(name), i);
+    }
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snap, &strs->base), "스냅숏 생성 실패");
+    for (int i = 0; i < 300; i += 3) {
+        snprintf(name, sizeof(name), "https://example.com/snapshot/item/%04d", i);
+        btree_test_str_delete(strs, btree_strkey(name));
+    }
+    btree_test_str_destroy(strs);
+    TEST_ASSERT_EQ((size_t)300, btree_size(&snap), "문자열 스냅숏 크기 불일치");
+    TEST_ASSERT(btree_validate_structure(&snap), "문자열 스냅숏 구조가 유효하지 않음");
+    btree_cleanup(&snap);
+    
+    /* B+Tree는 노드를 복사하고 리프 연결을 새로 만듦 */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS), "변형 설정 실패");
+    for (int k = 0; k < 1000; k++) btree_test_int_insert(tree, k, k * 2);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snap, &tree->base), "B+Tree 복사 실패");
+    TEST_ASSERT(snap.root != tree->base.root, "B+Tree 노드가 공유됨");
+    TEST_ASSERT_EQ(tree->base.node_count, snap.node_count, "B+Tree 사본 노드 수 불일치");
+    TEST_ASSERT(btree_validate_structure(&snap), "B+Tree 사본 구조가 유효하지 않음");
+    for (int k = 0; k < 1000; k += 2) btree_test_int_delete(tree, k);
+    btree_iterator_t iter;
+    btree_iterator_init(&iter, &snap, NULL, NULL);
+    void *k_ptr, *v_ptr;
+    int expected = 0;
+    while (btree_iterator_next(&iter, &k_ptr, &v_ptr)) {
+        TEST_ASSERT_EQ(expected, *(int*)k_ptr, "B+Tree 사본 순회 순서가 올바르지 않음");
+        TEST_ASSERT_EQ(expected * 2, *(int*)v_ptr, "B+Tree 사본 값이 올바르지 않음");
+        expected++;
+    }
+    TEST_ASSERT_EQ(1000, expected, "B+Tree 사본 순회 키 수 불일치");
+    btree_test_int_destroy(tree);
+    btree_cleanup(&snap);
+    
+    /* 매핑된 트리와 같은 트리로의 복사는 불가 */
+    btree_t empty;
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_copy(&empty, NULL), "NULL 원본이 허용됨");
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_copy(&tree->base, &tree->base),
+                   "자기 자신으로의 복사가 허용됨");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&empty, &tree->base), "빈 트리 복사 실패");
+    TEST_ASSERT(btree_is_empty(&empty), "빈 트리의 사본이 비어 있지 않음");
+    btree_cleanup(&empty);
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 노드 재배치 테스트 (BFS/vEB 배치, 다시 채우기, 점진 압축, 공유 노드)
+ */
+bool test_layout() {
+    enum { RANGE = 6000 };
+    static int ref[RANGE], ref_snap[RANGE];
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    
+    /* 대부분 지워 노드를 반쯤 비움 */
+    srand(22);
+    for (int k = 0; k < RANGE; k++) {
+        btree_test_int_insert(tree, k, k);
+        ref[k] = k;
+    }
+    for (int k = 0; k < RANGE; k++) {
+        if (rand() % 4 != 0) {
+            btree_test_int_delete(tree, k);
+            ref[k] = -1;
+        }
+    }
+    size_t churned = tree->base.node_count;
+    
+    /* BFS: 루트 뒤에 자식이 키 순서로 같은 간격으로 이어짐 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_optimize_layout(&tree->base, BTREE_LAYOUT_BFS),
+                   "BFS 재배치 실패");
+    btree_node_t *root = tree->base.root;
+    TEST_ASSERT(!root->is_leaf && root->num_keys >= 2, "테스트 트리가 너무 낮음");
+    ptrdiff_t stride = (char*)root->children[1] - (char*)root->children[0];
+    TEST_ASSERT((char*)root->children[0] > (char*)root, "자식이 루트 앞에 놓임");
+    for (int i = 1; i <= root->num_keys; i++) {
+        TEST_ASSERT_EQ(stride, (char*)root->children[i] - (char*)root->children[i - 1],
+                       "형제 노드가 연속 배치되지 않음");
+    }
+    TEST_ASSERT_EQ(churned, tree->base.node_count, "재배치 후 노드 수가 바뀜");
+    TEST_ASSERT(test_snapshot_matches(&tree->base, ref, RANGE), "BFS 재배치 후 내용이 올바르지 않음");
+    
+    /* vEB: 루트의 첫 자식 서브트리가 둘째 자식보다 앞에 모임 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_optimize_layout(&tree->base, BTREE_LAYOUT_VEB),
+                   "vEB 재배치 실패");
+    root = tree->base.root;
+    TEST_ASSERT((char*)root->children[0] > (char*)root, "자식이 루트 앞에 놓임");
+    TEST_ASSERT((char*)root->children[1] > (char*)root->children[0], "자식 순서가 뒤바뀜");
+    TEST_ASSERT(test_snapshot_matches(&tree->base, ref, RANGE), "vEB 재배치 후 내용이 올바르지 않음");
+    
+    /* 점진 압축: 단계 사이에 삽입과 삭제 */
+    size_t before = tree->base.node_count;
+    int steps = 0;
+    bool done = false;
+    while (!done) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_compact_step(&tree->base, 8, &done), "압축 단계 실패");
+        TEST_ASSERT(++steps < 100000, "점진 압축이 끝나지 않음");
+        int k = rand() % RANGE;
+        if (ref[k] < 0) {
+            btree_test_int_insert(tree, k, k);
+            ref[k] = k;
+        } else {
+            btree_test_int_delete(tree, k);
+            ref[k] = -1;
+        }
+        TEST_ASSERT(btree_validate_structure(&tree->base), "압축 단계 후 구조가 유효하지 않음");
+    }
+    TEST_ASSERT(steps > 1, "압축이 단계로 나뉘지 않음");
+    TEST_ASSERT(tree->base.node_count < before, "반쯤 빈 노드가 병합되지 않음");
+    TEST_ASSERT_NULL(tree->base.layout, "끝난 압축 상태가 남음");
+    TEST_ASSERT(test_snapshot_matches(&tree->base, ref, RANGE), "압축 후 내용이 올바르지 않음");
+    
+    /* 다시 채우기: fill_factor 1.0이면 거의 모든 노드가 가득 참 */
+    btree_statistics_t stats;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_fill_factor(&tree->base, 1.0), "채움 비율 설정 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_rebuild(&tree->base), "다시 채우기 실패");
+    btree_collect_statistics(&tree->base, &stats);
+    TEST_ASSERT(stats.fill_factor > 0.9, "다시 채운 노드의 채움 비율이 낮음");
+    TEST_ASSERT(test_snapshot_matches(&tree->base, ref, RANGE), "다시 채운 뒤 내용이 올바르지 않음");
+    
+    /* 단계 도중에 시작한 재배치는 진행 상태를 버림 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_compact_step(&tree->base, 2, &done), "압축 단계 실패");
+    TEST_ASSERT(!done && tree->base.layout != NULL, "압축이 한 단계에 끝남");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_optimize_layout(&tree->base, BTREE_LAYOUT_BFS),
+                   "BFS 재배치 실패");
+    TEST_ASSERT_NULL(tree->base.layout, "재배치 후 압축 상태가 남음");
+    
+    /* 스냅숏과 공유한 노드는 복사하므로 스냅숏은 그대로, 원본은 공유가 끊김 */
+    btree_t snap;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snap, &tree->base), "스냅숏 생성 실패");
+    memcpy(ref_snap, ref, sizeof(ref));
+    for (int k = 1; k < RANGE; k += 97) {
+        if (ref[k] < 0) {
+            btree_test_int_insert(tree, k, k + RANGE);
+            ref[k] = k + RANGE;
+        }
+    }
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_optimize_layout(&tree->base, BTREE_LAYOUT_BFS),
+                   "공유 트리 재배치 실패");
+    TEST_ASSERT(!(tree->base.flags & BTREE_FLAG_SHARED), "재배치 후 공유 표시가 남음");
+    TEST_ASSERT(test_snapshot_matches(&tree->base, ref, RANGE), "공유 트리 재배치 후 내용이 올바르지 않음");
+    TEST_ASSERT(test_snapshot_matches(&snap, ref_snap, RANGE), "재배치가 스냅숏에 보임");
+    
+    done = false;
+    while (!done) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_compact_step(&snap, 16, &done), "공유 트리 압축 실패");
+    }
+    TEST_ASSERT(test_snapshot_matches(&snap, ref_snap, RANGE), "스냅숏 압축 후 내용이 올바르지 않음");
+    btree_test_int_destroy(tree);
+    TEST_ASSERT(test_snapshot_matches(&snap, ref_snap, RANGE), "원본 정리 후 스냅숏이 바뀜");
+    btree_cleanup(&snap);
+    
+    /* B+Tree와 지연 삭제: 압축이 삭제 표시를 지우고 리프 연결을 유지 */
+    tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, BTREE_VARIANT_PLUS), "변형 설정 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+    for (int k = 0; k < 3000; k++) btree_test_int_insert(tree, k, k * 2);
+    for (int k = 0; k < 3000; k++) {
+        if (k % 3 != 0) btree_test_int_delete(tree, k);
+    }
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_compact(&tree->base), "B+Tree 압축 실패");
+    TEST_ASSERT_EQ(0, tree->base.dead_count, "압축 후 삭제 표시가 남음");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "B+Tree 압축 후 구조가 유효하지 않음");
+    btree_iterator_t iter;
+    void *k_ptr, *v_ptr;
+    int expected = 0;
+    btree_iterator_init(&iter, &tree->base, NULL, NULL);
+    while (btree_iterator_next(&iter, &k_ptr, &v_ptr)) {
+        TEST_ASSERT_EQ(expected, *(int*)k_ptr, "B+Tree 압축 후 순회 순서가 올바르지 않음");
+        TEST_ASSERT_EQ(expected * 2, *(int*)v_ptr, "B+Tree 압축 후 값이 올바르지 않음");
+        expected += 3;
+    }
+    TEST_ASSERT_EQ(3000, expected, "B+Tree 압축 후 순회 키 수 불일치");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_rebuild(&tree->base), "B+Tree 다시 채우기 실패");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "B+Tree 다시 채운 뒤 구조가 유효하지 않음");
+    TEST_ASSERT_EQ((size_t)1000, btree_test_int_size(tree), "B+Tree 다시 채운 뒤 크기 불일치");
+    
+    /* 오류 처리 */
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_rebuild(NULL), "NULL 트리가 허용됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_compact_step(&tree->base, 1, NULL),
+                   "NULL 완료 플래그가 허용됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION,
+                   btree_optimize_layout(&tree->base, (btree_layout_order_t)7),
+                   "알 수 없는 배치 순서가 허용됨");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 반복자 및 범위 검색 테스트 (두 변형, 삭제 표시 건너뛰기)
+ */
+bool test_iterator_range() {
+    const btree_variant_t variants[] = { BTREE_VARIANT_STANDARD, BTREE_VARIANT_PLUS };
+    const int n = 2000;
+    
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        btree_test_int_t *tree = btree_test_int_create(3);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        
+        /* 빈 트리 */
+        btree_iterator_t *iter = btree_iterator_create(&tree->base);
+        TEST_ASSERT_NOT_NULL(iter, "반복자 생성 실패");
+        TEST_ASSERT(!btree_iterator_has_next(iter), "빈 트리에 다음 항목이 있음");
+        TEST_ASSERT(!btree_iterator_prev(iter, NULL, NULL), "빈 트리에 이전 항목이 있음");
+        btree_iterator_destroy(iter);
+        
+        /* 짝수 키만 삽입, 4의 배수가 아닌 키 일부는 지연 삭제 */
+        for (int i = n - 1; i >= 0; i--) {
+            btree_test_int_insert(tree, i * 2, i);
+        }
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+        for (int i = 1; i < n; i += 4) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, i * 2), "지연 삭제 실패");
+        }
+        
+        /* 전체 순방향: 살아 있는 키만 순서대로, 포인터는 노드 저장소를 가리킴 */
+        iter = btree_iterator_create(&tree->base);
+        TEST_ASSERT_NOT_NULL(iter, "반복자 생성 실패");
+        void *key, *value;
+        int expected = 0;
+        size_t visited = 0;
+        while (btree_iterator_next(iter, &key, &value)) {
+            if (expected % 4 == 1) expected++;
+            TEST_ASSERT_EQ(expected * 2, *(int*)key, "순방향 순서가 올바르지 않음");
+            TEST_ASSERT_EQ((void*)btree_test_int_search(tree, expected * 2), value,
+                           "값 포인터가 노드 저장소를 가리키지 않음");
+            expected++;
+            visited++;
+        }
+        TEST_ASSERT_EQ(btree_test_int_size(tree), visited, "순방향 항목 수 불일치");
+        
+        /* 끝에서 역방향 */
+        expected = n - 1;
+        visited = 0;
+        while (btree_iterator_prev(iter, &key, &value)) {
+            if (expected % 4 == 1) expected--;
+            TEST_ASSERT_EQ(expected * 2, *(int*)key, "역방향 순서가 올바르지 않음");
+            TEST_ASSERT_EQ(expected, *(int*)value, "역방향 값이 올바르지 않음");
+            expected--;
+            visited++;
+        }
+        TEST_ASSERT_EQ(btree_test_int_size(tree), visited, "역방향 항목 수 불일치");
+        TEST_ASSERT(!btree_iterator_has_prev(iter), "처음 위치에서 이전 항목이 있음");
+        TEST_ASSERT(btree_iterator_next(iter, &key, NULL) && *(int*)key == 0, "처음 위치 복원 실패");
+        btree_iterator_destroy(iter);
+        
+        /* 범위 반복자: 경계가 트리에 없는 키 */
+        int lo = 301, hi = 1999;
+        iter = btree_iterator_create_range(&tree->base, &lo, &hi);
+        TEST_ASSERT_NOT_NULL(iter, "범위 반복자 생성 실패");
+        expected = 151;
+        while (btree_iterator_next(iter, &key, NULL)) {
+            if (expected % 4 == 1) expected++;
+            TEST_ASSERT_EQ(expected * 2, *(int*)key, "범위 순서가 올바르지 않음");
+            expected++;
+        }
+        TEST_ASSERT_EQ(1000, expected, "범위 상한이 올바르지 않음");
+        TEST_ASSERT(btree_iterator_prev(iter, &key, NULL) && *(int*)key == 1998, "범위 역방향 시작 실패");
+        btree_iterator_reset(iter);
+        TEST_ASSERT(btree_iterator_next(iter, &key, NULL) && *(int*)key == 302, "범위 처음으로 복원 실패");
+        TEST_ASSERT(btree_iterator_prev(iter, &key, NULL) && *(int*)key == 302, "범위 이전 항목 실패");
+        TEST_ASSERT(!btree_iterator_prev(iter, &key, NULL), "범위 하한 아래로 이동함");
+        btree_iterator_destroy(iter);
+        
+        /* 일괄 반복과 범위 검색 */
+        btree_key_value_pair_t pairs[64];
+        btree_iterator_t stack_iter;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_iterator_init(&stack_iter, &tree->base, NULL, NULL),
+                       "반복자 초기화 실패");
+        size_t total = 0, got;
+        int last = -1;
+        while ((got = btree_iterator_next_batch(&stack_iter, pairs, 64)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                TEST_ASSERT(*(int*)pairs[i].key > last, "일괄 반복 순서가 올바르지 않음");
+                TEST_ASSERT_EQ(*(int*)pairs[i].key / 2, *(int*)pairs[i].value, "일괄 반복 값 불일치");
+                last = *(int*)pairs[i].key;
+            }
+            total += got;
+        }
+        TEST_ASSERT_EQ(btree_test_int_size(tree), total, "일괄 반복 항목 수 불일치");
+        
+        lo = 100;
+        hi = 140;
+        got = btree_range_search(&tree->base, &lo, &hi, pairs, 64);
+        TEST_ASSERT_EQ(16, got, "범위 검색 결과 수 불일치");
+        TEST_ASSERT_EQ(100, *(int*)pairs[0].key, "범위 검색 첫 키 불일치");
+        TEST_ASSERT_EQ(140, *(int*)pairs[got - 1].key, "범위 검색 마지막 키 불일치");
+        TEST_ASSERT_EQ(4, btree_range_search(&tree->base, NULL, &lo, pairs, 4), "결과 수 제한 무시됨");
+        
+        btree_test_int_destroy(tree);
+    }
+    
+    /* 중복 키: 같은 키가 여러 노드에 걸쳐도 범위에 모두 포함 */
+    btree_test_int_t *tree = btree_test_int_create(3);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    tree->base.flags |= BTREE_FLAG_ALLOW_DUPLICATES;
+    for (int i = 0; i < 300; i++) {
+        btree_test_int_insert(tree, i % 3, i);
+    }
+    int one = 1;
+    btree_key_value_pair_t pairs[128];
+    TEST_ASSERT_EQ(100, btree_range_search(&tree->base, &one, &one, pairs, 128),
+                   "중복 키 범위 검색 결과 수 불일치");
+    
+    btree_test_int_iterator_t *typed = btree_test_int_iterator_create(tree);
+    TEST_ASSERT_NOT_NULL(typed, "타입별 반복자 생성 실패");
+    int k, val, count = 0, prev = 0;
+    while (btree_test_int_iterator_next(typed, &k, &val)) {
+        TEST_ASSERT(k >= prev && k == val % 3, "타입별 반복 순서가 올바르지 않음");
+        prev = k;
+        count++;
+    }
+    TEST_ASSERT_EQ(300, count, "타입별 반복 항목 수 불일치");
+    btree_test_int_iterator_destroy(typed);
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/* 동시성 테스트용 할당자 (전역 메모리 통계를 거치지 않음) */
+static void* test_thread_alloc(size_t size) {
+    return malloc(size);
+}
+
+static void test_thread_free(void *ptr) {
+    free(ptr);
+}
+
+static btree_allocator_t test_thread_allocator = {
+    test_thread_alloc, test_thread_free, NULL, NULL, 0, 0, NULL, NULL
+};
+
+/* 동시성 테스트 스레드 인자 */
+typedef struct {
+    btree_test_int_t *tree;
+    int begin;
+    int end;
+    int step;
+    int n;                              /* 처음부터 있던 키 수 (홀수 키는 삭제되지 않음) */
+    bool ok;
+} test_thread_arg_t;
+
+/* 읽기 스레드: 찾은 값은 항상 올바르고, 삭제되지 않는 키는 항상 보여야 함 */
+static void* test_reader_thread(void *p) {
+    test_thread_arg_t *arg = p;
+    for (int round = 0; round < 4; round++) {
+        for (int key = arg->begin; key < arg->end; key++) {
+            int value;
+            btree_result_t result = btree_get(&arg->tree->base, &key, &value);
+            if (result == BTREE_SUCCESS ? value != key * 3 : (key < arg->n && key % 2 == 1)) {
+                arg->ok = false;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void* test_writer_thread(void *p) {
+    test_thread_arg_t *arg = p;
+    for (int key = arg->begin; key < arg->end; key += arg->step) {
+        if (btree_test_int_insert(arg->tree, key, key * 3) != BTREE_SUCCESS) arg->ok = false;
+    }
+    return NULL;
+}
+
+static void* test_deleter_thread(void *p) {
+    test_thread_arg_t *arg = p;
+    for (int key = arg->begin; key < arg->end; key += arg->step) {
+        if (btree_test_int_delete(arg->tree, key) != BTREE_SUCCESS) arg->ok = false;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 동시 접근 모드 테스트 (잠금 없는 읽기, 동시 삽입과 삭제)
+ */
+bool test_concurrent_access() {
+    const btree_variant_t variants[] = { BTREE_VARIANT_CONCURRENT, BTREE_VARIANT_PLUS };
+    const int n = 20000;
+    enum { READERS = 4, WRITERS = 2 };
+    
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        btree_test_int_t *tree = btree_test_int_create_with_allocator(4, &test_thread_allocator);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_thread_safe(&tree->base, true), "동시 모드 설정 실패");
+        TEST_ASSERT(tree->base.flags & BTREE_FLAG_THREAD_SAFE, "동시 모드 플래그가 없음");
+        
+        for (int key = 0; key < n; key++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, key * 3), "초기 삽입 실패");
+        }
+        
+        pthread_t threads[READERS + WRITERS + 1];
+        test_thread_arg_t args[READERS + WRITERS + 1];
+        int t = 0;
+        for (int i = 0; i < READERS; i++, t++) {
+            args[t] = (test_thread_arg_t){ tree, 0, 3 * n, 1, n, true };
+            pthread_create(&threads[t], NULL, test_reader_thread, &args[t]);
+        }
+        for (int i = 0; i < WRITERS; i++, t++) {
+            args[t] = (test_thread_arg_t){ tree, n + i, 3 * n, WRITERS, n, true };
+            pthread_create(&threads[t], NULL, test_writer_thread, &args[t]);
+        }
+        args[t] = (test_thread_arg_t){ tree, 0, n, 2, n, true };
+        pthread_create(&threads[t], NULL, test_deleter_thread, &args[t]);
+        t++;
+        
+        for (int i = 0; i < t; i++) {
+            pthread_join(threads[i], NULL);
+            TEST_ASSERT(args[i].ok, i < READERS ? "동시 읽기 결과가 올바르지 않음" : "동시 쓰기 실패");
+        }
+        
+        TEST_ASSERT_EQ((size_t)(n / 2 + 2 * n), btree_test_int_size(tree), "동시 수정 후 크기 불일치");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "동시 수정 후 구조가 유효하지 않음");
+        for (int key = 0; key < 3 * n; key++) {
+            bool expected = key >= n || key % 2 == 1;
+            TEST_ASSERT_EQ(expected, btree_test_int_contains(tree, key), "동시 수정 후 키 집합이 올바르지 않음");
+        }
+        
+        btree_test_int_destroy(tree);
+    }
+    return true;
+}
+
+/**
+ * @brief 삽입이 계속되는 동시 모드 트리의 복사 (사본은 한 시점의 일관된 내용)
+ */
+bool test_concurrent_copy() {
+    const btree_variant_t variants[] = { BTREE_VARIANT_CONCURRENT, BTREE_VARIANT_PLUS };
+    const int n = 2000;
+    enum { WRITERS = 2, COPIES = 20 };
+    
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); v++) {
+        btree_test_int_t *tree = btree_test_int_create_with_allocator(3, &test_thread_allocator);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_thread_safe(&tree->base, true), "동시 모드 설정 실패");
+        for (int key = 0; key < n; key++) {
+            btree_test_int_insert(tree, key, key * 3);
+        }
+        
+        pthread_t threads[WRITERS];
+        test_thread_arg_t args[WRITERS];
+        for (int i = 0; i < WRITERS; i++) {
+            args[i] = (test_thread_arg_t){ tree, n + i, 20 * n, WRITERS, n, true };
+            pthread_create(&threads[i], NULL, test_writer_thread, &args[i]);
+        }
+        
+        bool consistent = true;
+        for (int c = 0; c < COPIES && consistent; c++) {
+            btree_t copy;
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&copy, &tree->base), "동시 모드 트리 복사 실패");
+            consistent = btree_validate_structure(&copy);
+            
+            /* 스레드마다 오름차순으로 넣으므로 각 스레드의 키는 앞부분만 보여야 함 */
+            size_t present = 0;
+            bool gap[WRITERS] = { false };
+            for (int key = 0; key < 20 * n && consistent; key++) {
+                bool found = btree_contains(&copy, &key);
+                present += found;
+                if (key < n) {
+                    consistent = found;
+                } else if (found) {
+                    consistent = !gap[(key - n) % WRITERS];
+                } else {
+                    gap[(key - n) % WRITERS] = true;
+                }
+            }
+            consistent = consistent && present == btree_size(&copy);
+            btree_cleanup(&copy);
+            sched_yield();
+        }
+        
+        for (int i = 0; i < WRITERS; i++) {
+            pthread_join(threads[i], NULL);
+            TEST_ASSERT(args[i].ok, "동시 쓰기 실패");
+        }
+        TEST_ASSERT(consistent, "쓰기 도중의 사본이 일관되지 않음");
+        btree_test_int_destroy(tree);
+    }
+    return true;
+}
+
+/* 회수 테스트 읽기 스레드: 멈추라고 할 때까지 계속 조회 */
+typedef struct {
+    btree_test_int_t *tree;
+    int n;
+    int stop;
+    bool ok;
+} test_reclaim_arg_t;
+
+static void* test_reclaim_reader(void *p) {
+    test_reclaim_arg_t *arg = p;
+    unsigned seed = 1;
+    while (!__atomic_load_n(&arg->stop, __ATOMIC_ACQUIRE)) {
+        seed = seed * 1103515245u + 12345u;
+        int key = (int)(seed >> 8) % arg->n;
+        int value;
+        if (btree_get(&arg->tree->base, &key, &value) == BTREE_SUCCESS && value != key * 3) {
+            arg->ok = false;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 동시 모드에서 떨어져 나간 노드의 에포크 기반 회수 테스트
+ *
+ * 읽기 스레드가 쉬지 않고 도는 동안 삽입과 삭제를 반복해 분할과 병합을
+ * 일으킨다. 보류 노드 수는 실행 중에도 줄어들어야 하고 (정리 때까지 쌓이지
+ * 않음), 읽기가 모두 끝난 뒤의 배타 쓰기에서 0이 되어야 한다.
+ */
+bool test_concurrent_reclaim() {
+    enum { READERS = 3, N = 4000, ROUNDS = 8 };
+    btree_test_int_t *tree = btree_test_int_create_with_allocator(3, &test_thread_allocator);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_thread_safe(&tree->base, true), "동시 모드 설정 실패");
+    
+    test_reclaim_arg_t arg = { tree, N, 0, true };
+    pthread_t readers[READERS];
+    for (int i = 0; i < READERS; i++) {
+        pthread_create(&readers[i], NULL, test_reclaim_reader, &arg);
+    }
+    
+    size_t last = 0, peak = 0, retired_total = 0;
+    int shrinks = 0;
+    bool ok = true;
+    for (int round = 0; round < ROUNDS && ok; round++) {
+        for (int key = 0; key < N; key++) {
+            if (btree_test_int_insert(tree, key, key * 3) != BTREE_SUCCESS) ok = false;
+        }
+        for (int key = 0; key < N; key++) {
+            if (btree_test_int_delete(tree, key) != BTREE_SUCCESS) ok = false;
+            if (key % 64 == 0) sched_yield();     /* 코어가 적어도 읽기가 번갈아 돌도록 */
+            size_t pending = btree_concurrent_retired(&tree->base);
+            if (pending < last) {
+                shrinks++;
+                retired_total += last - pending;
+            }
+            if (pending > peak) peak = pending;
+            last = pending;
+        }
+    }
+    __atomic_store_n(&arg.stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    TEST_ASSERT(ok, "동시 삽입/삭제 실패");
+    TEST_ASSERT(arg.ok, "동시 읽기 결과가 올바르지 않음");
+    TEST_ASSERT(shrinks >= ROUNDS, "실행 중 보류 노드가 해제되지 않음");
+    TEST_ASSERT(peak * 4 < retired_total, "보류 노드가 해제보다 많이 쌓임");
+    
+    /* 읽기가 없으면 다음 배타 쓰기에서 모두 해제 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, 1, 3), "삽입 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, 1), "삭제 실패");
+    TEST_ASSERT_EQ((size_t)0, btree_concurrent_retired(&tree->base), "읽기가 끝난 뒤에도 보류 노드가 남음");
+    TEST_ASSERT(btree_validate_structure(&tree->base), "구조가 유효하지 않음");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/**
+ * @brief 메모리 풀 테스트
+ */
+bool test_memory_pool() {
+    btree_memory_pool_t *pool = btree_pool_create(64, 64 * 1024, BTREE_POOL_FLAG_ZERO_MEMORY);
+    TEST_ASSERT_NOT_NULL(pool, "메모리 풀 생성 실패");
+    
+    /* 메모리 할당 테스트 */
+    void *ptr1 = btree_pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(ptr1, "풀에서 메모리 할당 실패");
+    
+    void *ptr2 = btree_pool_alloc(pool);
+    TEST_ASSERT_NOT_NULL(ptr2, "풀에서 두 번째 메모리 할당 실패");
+    TEST_ASSERT_NE(ptr1, ptr2, "동일한 메모리 주소가 할당됨");
+    
+    /* 메모리 소속 확인 */
+    TEST_ASSERT(btree_pool_contains(pool, ptr1), "할당된 메모리가 풀에 속하지 않음");
+    TEST_ASSERT(btree_pool_contains(pool, ptr2), "할당된 메모리가 풀에 속하지 않음");
+    
+    /* 통계 확인 */
+    btree_pool_stats_t stats;
+    btree_pool_get_stats(pool, &stats);
+    TEST_ASSERT(stats.used_blocks >= 2, "사용된 블록 수가 올바르지 않음");
+    
+    /* 메모리 해제 */
+    btree_pool_free(pool, ptr1);
+    btree_pool_free(pool, ptr2);
+    
+    btree_pool_destroy(pool);
+    return true;
+}
+
+/* 풀 동시성 테스트 공유 상태 */
+#define TEST_POOL_SLOTS 256
+typedef struct {
+    btree_memory_pool_t *pool;
+    void **slots;                       /* 스레드 간 블록 교환 슬롯 */
+    int id;
+    int rounds;
+    size_t allocs;
+    bool ok;
+} test_pool_arg_t;
+
+static void* test_pool_worker(void *p) {
+    test_pool_arg_t *arg = p;
+    btree_allocator_t *allocator = btree_default_allocator();
+    void *blocks[48];
+    
+    for (int r = 0; r < arg->rounds; r++) {
+        for (int i = 0; i < 48; i++) {
+            blocks[i] = btree_pool_alloc(arg->pool);
+            if (!blocks[i]) {
+                arg->ok = false;
+                return NULL;
+            }
+            arg->allocs++;
+            memset(blocks[i], arg->id, 64);
+        }
+        /* 다른 스레드가 같은 블록을 받지 않았는지 확인 */
+        for (int i = 0; i < 48; i++) {
+            const unsigned char *bytes = blocks[i];
+            for (int b = 0; b < 64; b++) {
+                if (bytes[b] != (unsigned char)arg->id) arg->ok = false;
+            }
+        }
+        /* 절반은 직접 해제, 절반은 슬롯에 넣고 다른 스레드가 남긴 블록을 해제 */
+        for (int i = 0; i < 48; i++) {
+            void *victim = blocks[i];
+            if (i % 2) {
+                int slot = (arg->id * 31 + r * 7 + i) % TEST_POOL_SLOTS;
+                victim = __atomic_exchange_n(&arg->slots[slot], blocks[i], __ATOMIC_ACQ_REL);
+            }
+            btree_pool_free(arg->pool, victim);
+        }
+        /* 기본 할당자 통계도 함께 경합 */
+        void *tmp = allocator->alloc(128 + r % 64);
+        if (!tmp) arg->ok = false;
+        allocator->free(tmp);
+    }
+    return NULL;
+}
+
+/**
+ * @brief 메모리 풀 동시 할당/교차 스레드 해제 테스트
+ */
+bool test_memory_pool_threads() {
+    enum { THREADS = 4 };
+    btree_memory_pool_t *pool = btree_pool_create(64, 64 * 1024, BTREE_POOL_FLAG_THREAD_SAFE);
+    TEST_ASSERT_NOT_NULL(pool, "메모리 풀 생성 실패");
+    
+    size_t usage_before = btree_memory_get_usage();
+    void *slots[TEST_POOL_SLOTS] = { NULL };
+    pthread_t threads[THREADS];
+    test_pool_arg_t args[THREADS];
+    
+    for (int t = 0; t < THREADS; t++) {
+        test_pool_arg_t init = { pool, slots, t + 1, 2000, 0, true };
+        args[t] = init;
+        TEST_ASSERT_EQ(0, pthread_create(&threads[t], NULL, test_pool_worker, &args[t]),
+                       "스레드 생성 실패");
+    }
+    size_t allocs = 0;
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        TEST_ASSERT(args[t].ok, "블록이 중복 할당되었거나 할당 실패");
+        allocs += args[t].allocs;
+    }
+    for (int i = 0; i < TEST_POOL_SLOTS; i++) {
+        btree_pool_free(pool, slots[i]);
+    }
+    
+    btree_pool_stats_t stats;
+    btree_pool_get_stats(pool, &stats);
+    TEST_ASSERT_EQ((size_t)0, stats.used_blocks, "모든 블록이 반환되지 않음");
+    TEST_ASSERT_EQ(allocs, stats.allocation_count, "할당 횟수 합산 불일치");
+    TEST_ASSERT_EQ(allocs, stats.deallocation_count, "해제 횟수 합산 불일치");
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "샤드별 사용량 합계 불일치");
+    
+    /* 매거진과 반환 스택에 흩어진 블록까지 모두 다시 할당할 수 있어야 함 */
+    size_t total = 0;
+    while (btree_pool_alloc(pool)) {
+        total++;
+    }
+    TEST_ASSERT_EQ(stats.total_blocks, total, "흩어진 블록을 회수하지 못함");
+    
+    btree_pool_reset(pool);
+    btree_pool_get_stats(pool, &stats);
+    TEST_ASSERT_EQ((size_t)0, stats.used_blocks, "리셋 후 사용 블록이 남음");
+    TEST_ASSERT_NOT_NULL(btree_pool_alloc(pool), "리셋 후 할당 실패");
+    
+    btree_pool_destroy(pool);
+    return true;
+}
+
+/**
+ * @brief 슬랩 체인 확장, 페이지 맵 소유자 검색, 노드 풀 연결 테스트
+ */
+bool test_node_pool() {
+    btree_memory_manager_t *manager = btree_memory_manager_create();
+    TEST_ASSERT_NOT_NULL(manager, "메모리 매니저 생성 실패");
+    
+    /* 첫 슬랩을 넘어서면 같은 크기 클래스에 슬랩이 이어져야 함 */
+    enum { BLOCKS = 3000 };
+    static void *blocks[BLOCKS];
+    for (int i = 0; i < BLOCKS; i++) {
+        blocks[i] = btree_memory_manager_alloc_exact(manager, 4000);
+        TEST_ASSERT_NOT_NULL(blocks[i], "매니저 할당 실패");
+        memset(blocks[i], 0x5a, 4000);
+    }
+    TEST_ASSERT_EQ((size_t)1, manager->pool_count, "정확한 크기 클래스가 하나가 아님");
+    TEST_ASSERT(manager->slab_count >= 3, "슬랩이 체인에 추가되지 않음");
+    TEST_ASSERT_NOT_NULL(manager->pools[0]->next, "슬랩 체인이 비어 있음");
+    TEST_ASSERT_EQ(manager->current_usage, (size_t)BLOCKS * 4032, "매니저 사용량 불일치");
+    
+    for (int i = 0; i < BLOCKS; i += 97) {
+        btree_memory_pool_t *owner = btree_memory_find_pool(blocks[i]);
+        TEST_ASSERT_NOT_NULL(owner, "블록의 소유 슬랩을 찾지 못함");
+        TEST_ASSERT(btree_pool_contains(owner, blocks[i]), "잘못된 소유 슬랩");
+        TEST_ASSERT_EQ((size_t)4032, owner->block_size, "블록 크기가 정확하지 않음");
+    }
+    int local = 0;
+    void *heap = malloc(64);
+    TEST_ASSERT_NULL(btree_memory_find_pool(&local), "스택 주소가 슬랩으로 인식됨");
+    TEST_ASSERT_NULL(btree_memory_find_pool(heap), "일반 힙 주소가 슬랩으로 인식됨");
+    free(heap);
+    
+    for (int i = 0; i < BLOCKS; i++) {
+        btree_memory_manager_free(manager, blocks[i]);
+    }
+    TEST_ASSERT_EQ((size_t)0, manager->current_usage, "해제 후 매니저 사용량이 남음");
+    btree_memory_manager_destroy(manager);
+    TEST_ASSERT_NULL(btree_memory_find_pool(blocks[0]), "소멸된 슬랩이 페이지 맵에 남음");
+    
+    /* 할당자를 지정하지 않은 트리는 노드를 공용 노드 풀에서 할당 */
+    size_t usage_before = btree_memory_get_usage();
+    for (int inline_nodes = 0; inline_nodes <= 1; inline_nodes++) {
+        btree_test_int_t *tree = btree_test_int_create(8);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT(tree->base.allocator == btree_node_pool_allocator(), "노드 풀 할당자가 아님");
+        if (inline_nodes) tree->base.flags |= BTREE_FLAG_INLINE_NODES;
+        
+        for (int key = 0; key < 5000; key++) {
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, key, key), "삽입 실패");
+        }
+        const btree_node_t *root = tree->base.root;
+        btree_memory_pool_t *owner = btree_memory_find_pool(root);
+        TEST_ASSERT_NOT_NULL(owner, "노드가 노드 풀에서 할당되지 않음");
+        if (inline_nodes) {
+            TEST_ASSERT_EQ((void*)root, root->block, "풀 노드에 정렬 여유분이 생김");
+            TEST_ASSERT_EQ((uintptr_t)0, (uintptr_t)root % BTREE_CACHE_LINE_SIZE, "노드가 정렬되지 않음");
+        }
+        TEST_ASSERT(btree_validate_structure(&tree->base), "트리 구조 검증 실패");
+        btree_statistics_t stats;
+        btree_collect_statistics(&tree->base, &stats);
+        TEST_ASSERT_EQ(tree->base.total_memory, stats.memory_usage, "메모리 사용량이 일치하지 않음");
+        btree_test_int_destroy(tree);
+    }
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "노드 풀 사용량이 반환되지 않음");
+    
+    /* 풀 할당자는 block_size 클래스에서 할당 */
+    btree_allocator_t *allocator = btree_pool_allocator_create(192, 64 * 1024);
+    TEST_ASSERT_NOT_NULL(allocator, "풀 할당자 생성 실패");
+    void *ptr = allocator->alloc(192);
+    TEST_ASSERT_NOT_NULL(ptr, "풀 할당자 할당 실패");
+    TEST_ASSERT_NOT_NULL(btree_memory_find_pool(ptr), "풀 할당자 블록이 슬랩에 없음");
+    ptr = allocator->realloc(ptr, 1000);
+    TEST_ASSERT_NOT_NULL(ptr, "풀 할당자 재할당 실패");
+    allocator->free(ptr);
+    btree_pool_allocator_destroy(allocator);
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "풀 할당자 사용량이 반환되지 않음");
+    return true;
+}
+
+/**
+ * @brief 할당 힌트별 할당자와 순차 삽입 치우친 분할 테스트
+ */
+bool test_alloc_hints() {
+    btree_test_int_t *meta = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(meta, "B-Tree 생성 실패");
+    TEST_ASSERT(btree_optimized_allocator_create(BTREE_ALLOC_HINT_SMALL_FREQUENT) ==
+                btree_node_pool_allocator(), "SMALL_FREQUENT가 노드 풀이 아님");
+    TEST_ASSERT(btree_optimized_allocator_create(BTREE_ALLOC_HINT_LARGE_INFREQUENT) ==
+                btree_default_allocator(), "LARGE_INFREQUENT가 기본 할당자가 아님");
+    
+    size_t usage_before = btree_memory_get_usage();
+    const int n = 20000;
+    
+    /* SEQUENTIAL: 아레나 노드, 힌트를 주면 순차 삽입 노드 수가 크게 줄어듦 */
+    for (int plus = 0; plus <= 1; plus++) {
+        size_t nodes[2] = { 0, 0 };
+        for (int hinted = 0; hinted <= 1; hinted++) {
+            btree_allocator_t *allocator = btree_optimized_allocator_create(BTREE_ALLOC_HINT_SEQUENTIAL);
+            TEST_ASSERT_NOT_NULL(allocator, "SEQUENTIAL 할당자 생성 실패");
+            btree_t tree;
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&tree, 16, &meta->base.key_type,
+                                                     &meta->base.value_type, allocator), "B-Tree 초기화 실패");
+            if (plus) btree_set_variant(&tree, BTREE_VARIANT_PLUS);
+            if (hinted) btree_set_cache_hint(&tree, BTREE_ALLOC_HINT_SEQUENTIAL);
+            TEST_ASSERT_EQ((uint32_t)(hinted ? BTREE_FLAG_APPEND : 0), tree.flags & BTREE_FLAG_APPEND,
+                           "힌트 플래그 불일치");
+            
+            for (int key = 0; key < n; key++) {
+                int value = key * 2;
+                TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&tree, &key, &value), "순차 삽입 실패");
+            }
+            TEST_ASSERT(btree_validate_structure(&tree), "순차 삽입 후 구조 검증 실패");
+            nodes[hinted] = tree.node_count;
+            
+            btree_memory_pool_t *chunk = btree_memory_find_pool(tree.root);
+            TEST_ASSERT_NOT_NULL(chunk, "노드가 아레나 청크에 없음");
+            TEST_ASSERT(chunk->flags & BTREE_POOL_FLAG_ARENA, "노드 청크가 아레나가 아님");
+            TEST_ASSERT_EQ((size_t)BTREE_HUGE_PAGE_SIZE, chunk->pool_size, "청크 크기 불일치");
+            TEST_ASSERT_EQ((uintptr_t)0, (uintptr_t)tree.root % BTREE_CACHE_LINE_SIZE, "노드가 정렬되지 않음");
+            
+            /* 가운데 삽입과 삭제를 섞어도 트리는 유효 (오른쪽 끝 노드의 부족분 포함) */
+            for (int key = 1; key < n; key += 2) {
+                TEST_ASSERT_EQ(BTREE_SUCCESS, btree_delete(&tree, &key), "삭제 실패");
+            }
+            for (int key = n - 1; key > 0; key -= 4) {
+                int value = -key;
+                TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&tree, &key, &value), "재삽입 실패");
+            }
+            TEST_ASSERT(btree_validate_structure(&tree), "삭제/재삽입 후 구조 검증 실패");
+            for (int key = 0; key < n; key++) {
+                int *value = btree_search(&tree, &key);
+                bool present = key % 2 == 0 || (n - 1 - key) % 4 == 0;
+                TEST_ASSERT_EQ(present, value != NULL, "검색 결과 불일치");
+                if (value) TEST_ASSERT_EQ(key % 2 == 0 ? key * 2 : -key, *value, "값 불일치");
+            }
+            btree_cleanup(&tree);
+            btree_optimized_allocator_destroy(allocator);
+        }
+        /* 힌트가 없어도 연속 추가를 감지해 같은 분할로 바뀜 */
+        TEST_ASSERT(nodes[1] <= nodes[0], "힌트를 준 트리의 노드가 더 많음");
+        TEST_ASSERT(nodes[0] * 24 < (size_t)n && nodes[1] * 24 < (size_t)n, "치우친 분할로 노드 수가 줄지 않음");
+    }
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "SEQUENTIAL 청크가 반환되지 않음");
+    
+    /* TEMPORARY: 트리 정리 후 리셋하면 첫 청크 처음부터 다시 잘라 냄 */
+    btree_allocator_t *temporary = btree_optimized_allocator_create(BTREE_ALLOC_HINT_TEMPORARY);
+    TEST_ASSERT_NOT_NULL(temporary, "TEMPORARY 할당자 생성 실패");
+    for (int round = 0; round < 2; round++) {
+        btree_t tree;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&tree, 8, &meta->base.key_type,
+                                                 &meta->base.value_type, temporary), "B-Tree 초기화 실패");
+        for (int i = 0; i < n; i++) {
+            int key = (i * 7919) % n;
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&tree, &key, &i), "TEMPORARY 삽입 실패");
+        }
+        TEST_ASSERT(btree_validate_structure(&tree), "TEMPORARY 트리 구조 검증 실패");
+        btree_cleanup(&tree);
+        btree_optimized_allocator_reset(temporary);
+    }
+    void *block = temporary->node_alloc(temporary->context, 100);
+    btree_memory_pool_t *chunk = btree_memory_find_pool(block);
+    TEST_ASSERT_NOT_NULL(chunk, "TEMPORARY 블록이 청크에 없음");
+    TEST_ASSERT_EQ(chunk->pool_start, block, "리셋 후 청크 처음부터 할당하지 않음");
+    btree_pool_stats_t stats;
+    btree_pool_get_stats(chunk, &stats);
+    TEST_ASSERT_EQ((size_t)128, stats.used_size, "아레나 사용량 불일치");
+    temporary->free(block);
+    btree_optimized_allocator_destroy(temporary);
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "TEMPORARY 청크가 반환되지 않음");
+    
+    /* RANDOM: 전용 크기 클래스 슬랩 */
+    btree_allocator_t *random = btree_optimized_allocator_create(BTREE_ALLOC_HINT_RANDOM);
+    TEST_ASSERT_NOT_NULL(random, "RANDOM 할당자 생성 실패");
+    btree_t tree;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&tree, 8, &meta->base.key_type,
+                                             &meta->base.value_type, random), "B-Tree 초기화 실패");
+    for (int i = 0; i < n; i++) {
+        int key = (i * 7919) % n;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&tree, &key, &i), "RANDOM 삽입 실패");
+    }
+    btree_memory_pool_t *slab = btree_memory_find_pool(tree.root);
+    TEST_ASSERT_NOT_NULL(slab, "RANDOM 노드가 슬랩에 없음");
+    TEST_ASSERT(!(slab->flags & BTREE_POOL_FLAG_ARENA), "RANDOM 노드가 아레나에 있음");
+    for (int key = 0; key < n; key += 3) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_delete(&tree, &key), "RANDOM 삭제 실패");
+    }
+    TEST_ASSERT(btree_validate_structure(&tree), "RANDOM 트리 구조 검증 실패");
+    btree_cleanup(&tree);
+    btree_optimized_allocator_destroy(random);
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "RANDOM 슬랩 사용량이 반환되지 않음");
+    
+    btree_memory_set_alloc_hint(BTREE_ALLOC_HINT_RANDOM);
+    btree_memory_set_alloc_hint(BTREE_ALLOC_HINT_PERSISTENT);
+    btree_test_int_destroy(meta);
+    return true;
+}
+
+/**
+ * @brief NUMA 상위 레벨 복제와 노드별 할당자 테스트
+ */
+bool test_numa_replication() {
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+#ifndef BTREE_NUMA_SUPPORT
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_numa_replicate(&tree->base, 2),
+                   "NUMA 지원 없이 복제가 허용됨");
+    TEST_ASSERT_EQ(0, btree_numa_replicated_levels(&tree->base), "복제 레벨 수 불일치");
+    btree_test_int_destroy(tree);
+    return true;
+#else
+    const int n = 20000;
+    btree_numa_info_t info;
+    TEST_ASSERT(btree_numa_get_info(&info), "NUMA 정보 조회 실패");
+    TEST_ASSERT(info.node_id >= 0 && info.node_id < btree_numa_node_count(), "NUMA 노드 번호 범위 밖");
+    
+    for (int plus = 0; plus <= 1; plus++) {
+        if (plus) btree_set_variant(&tree->base, BTREE_VARIANT_PLUS);
+        srand(2025);
+        for (int i = 0; i < n; i++) {
+            btree_test_int_insert(tree, rand() % (4 * n), i);
+        }
+        int height = tree->base.height;
+        TEST_ASSERT(height >= 5, "트리가 충분히 높지 않음");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_SIZE, btree_numa_replicate(&tree->base, -1), "음수 레벨 허용");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_numa_replicate(&tree->base, 100), "복제 실패");
+        TEST_ASSERT_EQ(height - 2, btree_numa_replicated_levels(&tree->base), "리프 부모 레벨까지 복제됨");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_numa_replicate(&tree->base, 2), "복제 레벨 변경 실패");
+        TEST_ASSERT_EQ(2, btree_numa_replicated_levels(&tree->base), "복제 레벨 수 불일치");
+        TEST_ASSERT(tree->base.root->replicated, "원본 루트에 복제 표시가 없음");
+        
+        /* 삽입과 삭제가 복제된 노드를 바꿔도 끝나면 다시 복제되고 검색은 원본과 같음 */
+        for (int key = 0; key < 4 * n; key++) {
+            if (key % 3 == 0) {
+                btree_test_int_delete(tree, key);
+            } else if (key % 3 == 1) {
+                btree_test_int_delete(tree, key);
+                btree_test_int_insert(tree, key, -key);
+            }
+            TEST_ASSERT(btree_numa_replicated_levels(&tree->base) > 0, "쓰기 뒤 복제본이 다시 만들어지지 않음");
+        }
+        TEST_ASSERT(btree_validate_structure(&tree->base), "복제 중 구조 검증 실패");
+        for (int key = 0; key < 4 * n; key++) {
+            int *value = btree_test_int_search(tree, key);
+            if (key % 3 == 0) {
+                TEST_ASSERT_NULL(value, "삭제한 키가 복제본으로 보임");
+            } else if (key % 3 == 1) {
+                TEST_ASSERT_NOT_NULL(value, "삽입한 키를 찾을 수 없음");
+                TEST_ASSERT_EQ(-key, *value, "값 불일치");
+            }
+        }
+        
+        /* 재배치 뒤에는 다음 쓰기까지 원본으로 검색, 스냅숏은 복제본을 해제 */
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_compact(&tree->base), "재배치 실패");
+        TEST_ASSERT_EQ(0, btree_numa_replicated_levels(&tree->base), "재배치 뒤 옛 복제본을 씀");
+        TEST_ASSERT_NOT_NULL(btree_test_int_search(tree, 1), "재배치 뒤 검색 실패");
+        btree_test_int_insert(tree, 1, 1);
+        TEST_ASSERT_EQ(2, btree_numa_replicated_levels(&tree->base), "재배치 뒤 다시 복제되지 않음");
+        if (!plus) {
+            btree_t snapshot;
+            TEST_ASSERT_EQ(BTREE_SUCCESS, btree_copy(&snapshot, &tree->base), "스냅숏 생성 실패");
+            TEST_ASSERT_NULL(tree->base.numa, "공유한 트리가 복제본을 유지함");
+            TEST_ASSERT_NULL(snapshot.numa, "스냅숏이 복제본을 물려받음");
+            TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_numa_replicate(&snapshot, 2),
+                           "공유 트리 복제가 허용됨");
+            btree_cleanup(&snapshot);
+        }
+        btree_clear(&tree->base);
+        TEST_ASSERT_NULL(tree->base.numa, "비운 트리가 복제본을 유지함");
+    }
+    
+    /* 노드별 할당자: 노드 블록은 슬랩에서, 해제하면 사용량이 돌아옴 */
+    size_t usage_before = btree_memory_get_usage();
+    btree_allocator_t *allocator = btree_numa_allocator_create();
+    TEST_ASSERT_NOT_NULL(allocator, "NUMA 할당자 생성 실패");
+    btree_t local;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&local, 16, &tree->base.key_type,
+                                             &tree->base.value_type, allocator), "B-Tree 초기화 실패");
+    for (int key = 0; key < n; key++) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&local, &key, &key), "삽입 실패");
+    }
+    TEST_ASSERT_NOT_NULL(btree_memory_find_pool(local.root), "노드가 슬랩에 없음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_numa_replicate(&local, 1), "NUMA 할당자 트리 복제 실패");
+    for (int key = 0; key < n; key += 7) {
+        int *value = btree_search(&local, &key);
+        TEST_ASSERT(value && *value == key, "NUMA 할당자 트리 검색 실패");
+    }
+    btree_cleanup(&local);
+    btree_optimized_allocator_destroy(allocator);
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "NUMA 할당 사용량이 돌아오지 않음");
+    
+    void *block = btree_numa_alloc_onnode(1000, info.node_id);
+    TEST_ASSERT_NOT_NULL(block, "노드 지정 할당 실패");
+    memset(block, 0xAB, 1000);
+    btree_numa_free(block);
+    btree_numa_free(btree_numa_alloc_interleaved(64));
+    TEST_ASSERT_EQ(usage_before, btree_memory_get_usage(), "NUMA 블록 사용량이 돌아오지 않음");
+    
+    btree_test_int_destroy(tree);
+    return true;
+#endif
+}
+
+#ifdef TEST_HAS_FORK
+/* 자식 프로세스에서 ptr에 쓰면 SIGSEGV로 죽는지 */
+static bool test_write_faults(volatile char *ptr) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        signal(SIGSEGV, SIG_DFL);
+        signal(SIGBUS, SIG_DFL);
+        *ptr = 1;
+        _exit(0);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return false;
+    return WIFSIGNALED(status);
+}
+#endif
+
+/**
+ * @brief 페이지 매핑 풀: 큰 페이지 정렬, 보호 페이지, 캐시 라인 정렬 할당 테스트
+ */
+bool test_page_mapped_pools() {
+    void *aligned = btree_cache_aligned_alloc(100);
+    TEST_ASSERT_NOT_NULL(aligned, "정렬 할당 실패");
+    TEST_ASSERT_EQ((uintptr_t)0, (uintptr_t)aligned % BTREE_CACHE_LINE_SIZE, "캐시 라인에 정렬되지 않음");
+    memset(aligned, 0x5A, 128);
+    btree_cache_aligned_free(aligned);
+    
+    /* 큰 페이지 풀: 2MB 경계에서 시작하는 직접 매핑 영역 */
+    btree_memory_pool_t *pool = btree_pool_create(64, 2 * BTREE_HUGE_PAGE_SIZE, BTREE_POOL_FLAG_HUGE_PAGES);
+    TEST_ASSERT_NOT_NULL(pool, "큰 페이지 풀 생성 실패");
+    TEST_ASSERT_NOT_NULL(pool->map_base, "큰 페이지 풀이 매핑되지 않음");
+    TEST_ASSERT_EQ((uintptr_t)0, (uintptr_t)pool->pool_start % BTREE_HUGE_PAGE_SIZE, "2MB 경계가 아님");
+    void *blocks[1000];
+    for (int i = 0; i < 1000; i++) {
+        blocks[i] = btree_pool_alloc(pool);
+        TEST_ASSERT_NOT_NULL(blocks[i], "큰 페이지 풀 할당 실패");
+        memset(blocks[i], i & 0xFF, 64);
+    }
+    for (int i = 0; i < 1000; i++) {
+        btree_pool_free(pool, blocks[i]);
+    }
+    btree_pool_destroy(pool);
+    
+    /* 보통 풀은 malloc 영역 그대로 */
+    pool = btree_pool_create(64, 64 * 1024, 0);
+    TEST_ASSERT_NOT_NULL(pool, "풀 생성 실패");
+    TEST_ASSERT_NULL(pool->map_base, "보통 풀이 매핑됨");
+    btree_pool_destroy(pool);
+    
+    /* 디버그 모드: 풀과 노드 풀 슬랩이 보호 페이지로 둘러싸임 */
+    btree_memory_set_debug_mode(true);
+    pool = btree_pool_create(64, 64 * 1024, 0);
+    TEST_ASSERT_NOT_NULL(pool, "디버그 풀 생성 실패");
+    TEST_ASSERT_NOT_NULL(pool->map_base, "디버그 풀이 매핑되지 않음");
+    TEST_ASSERT(pool->map_size > pool->pool_size, "보호 페이지가 없음");
+    char *start = pool->pool_start;
+    memset(start, 0, pool->pool_size);
+#ifdef TEST_HAS_FORK
+    TEST_ASSERT(test_write_faults(start + pool->pool_size), "풀 뒤 보호 페이지에 쓸 수 있음");
+    TEST_ASSERT(test_write_faults(start - 1), "풀 앞 보호 페이지에 쓸 수 있음");
+    TEST_ASSERT(!test_write_faults(start + pool->pool_size - 1), "풀 마지막 바이트에 쓸 수 없음");
+    
+    /* btree_memory_protect로 읽기 전용으로 바꾸고 되돌림 */
+    TEST_ASSERT(btree_memory_protect(start, 4096, BTREE_PROTECT_READ), "읽기 전용 변경 실패");
+    TEST_ASSERT_EQ(0, start[0], "읽기 전용 페이지를 읽을 수 없음");
+    TEST_ASSERT(test_write_faults(start), "읽기 전용 페이지에 쓸 수 있음");
+    TEST_ASSERT(btree_memory_protect(start, 4096, BTREE_PROTECT_READ | BTREE_PROTECT_WRITE),
+                "쓰기 권한 복원 실패");
+    start[0] = 1;
+#endif
+    TEST_ASSERT(!btree_memory_protect(start + 1, 4096, BTREE_PROTECT_NONE), "페이지 경계가 아닌 주소를 허용함");
+    btree_pool_destroy(pool);
+    
+    btree_allocator_t *random = btree_optimized_allocator_create(BTREE_ALLOC_HINT_RANDOM);
+    TEST_ASSERT_NOT_NULL(random, "RANDOM 할당자 생성 실패");
+    void *node = random->node_alloc(random->context, 200);
+    btree_memory_pool_t *slab = btree_memory_find_pool(node);
+    TEST_ASSERT_NOT_NULL(slab, "노드가 슬랩에 없음");
+    TEST_ASSERT(slab->map_base && slab->map_size > slab->pool_size, "슬랩에 보호 페이지가 없음");
+#ifdef TEST_HAS_FORK
+    TEST_ASSERT(test_write_faults((char*)slab->pool_start + slab->pool_size), "슬랩 뒤에 쓸 수 있음");
+#endif
+    random->free(node);
+    btree_optimized_allocator_destroy(random);
+    btree_memory_set_debug_mode(false);
+    return true;
+}
+
+/**
+ * @brief 페이지 파일 저장, 읽기 전용 매핑, 버퍼 직렬화 테스트
+ */
+bool test_file_storage() {
+    const char *path = "test_btree_pages.bin";
+    const btree_variant_t variants[] = { BTREE_VARIANT_STANDARD, BTREE_VARIANT_PLUS };
+    
+    for (int v = 0; v < 2; v++) {
+        btree_test_int_t *tree = btree_test_int_create(5);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        for (int i = 0; i < 5000; i++) {
+            btree_test_int_insert(tree, i * 2, i * 7);
+        }
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+        for (int i = 0; i < 10000; i += 10) {
+            btree_test_int_delete(tree, i);
+        }
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_save_to_file(&tree->base, path), "파일 저장 실패");
+        
+        /* 차수가 달라도 파일의 구성을 따름 */
+        btree_test_int_t *mapped = btree_test_int_create(3);
+        TEST_ASSERT_NOT_NULL(mapped, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_load_from_file(&mapped->base, path), "파일 매핑 실패");
+        TEST_ASSERT_EQ(tree->base.degree, mapped->base.degree, "매핑된 트리 차수 불일치");
+        TEST_ASSERT_EQ(variants[v], btree_get_variant(&mapped->base), "매핑된 트리 변형 불일치");
+        TEST_ASSERT_EQ(btree_test_int_size(tree), btree_test_int_size(mapped), "매핑된 트리 크기 불일치");
+        TEST_ASSERT_EQ(tree->base.height, mapped->base.height, "매핑된 트리 높이 불일치");
+        TEST_ASSERT(btree_validate_structure(&mapped->base), "매핑된 트리 구조가 유효하지 않음");
+        TEST_ASSERT(!btree_test_int_is_empty(mapped), "매핑된 트리가 비어 있음");
+        
+        for (int key = -1; key < 10001; key++) {
+            int *expected = btree_test_int_search(tree, key);
+            int *found = btree_test_int_search(mapped, key);
+            TEST_ASSERT_EQ(expected == NULL, found == NULL, "매핑된 트리 검색 결과 불일치");
+            if (found) TEST_ASSERT_EQ(*expected, *found, "매핑된 트리 값 불일치");
+        }
+        
+        /* 읽기 전용 */
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_test_int_insert(mapped, 1, 1),
+                       "매핑된 트리에 삽입됨");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_test_int_delete(mapped, 2),
+                       "매핑된 트리에서 삭제됨");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_load_from_file(&mapped->base, path),
+                       "매핑된 트리에 다시 불러옴");
+        btree_iterator_t iter;
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_iterator_init(&iter, &mapped->base, NULL, NULL),
+                       "매핑된 트리 반복자가 생성됨");
+        TEST_ASSERT(!btree_iterator_next(&iter, NULL, NULL), "매핑된 트리 반복자가 항목을 반환함");
+        
+        /* 비우면 매핑이 해제되고 다시 수정 가능 */
+        btree_test_int_clear(mapped);
+        TEST_ASSERT(btree_test_int_is_empty(mapped), "매핑 해제 후 비어 있지 않음");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(mapped, 1, 1), "매핑 해제 후 삽입 실패");
+        btree_test_int_destroy(mapped);
+        
+        /* 버퍼 왕복 */
+        size_t size = btree_serialize_size(&tree->base);
+        TEST_ASSERT(size > 0, "직렬화 크기가 0");
+        unsigned char *image = malloc(size);
+        TEST_ASSERT_NOT_NULL(image, "버퍼 할당 실패");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_SIZE, btree_serialize(&tree->base, image, size - 1),
+                       "작은 버퍼에 직렬화됨");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_serialize(&tree->base, image, size), "직렬화 실패");
+        
+        btree_test_int_t *copy = btree_test_int_create(5);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_deserialize(&copy->base, image, size), "역직렬화 실패");
+        TEST_ASSERT(btree_validate_structure(&copy->base), "역직렬화한 트리 구조가 유효하지 않음");
+        TEST_ASSERT_EQ(tree->base.node_count, copy->base.node_count, "역직렬화한 노드 수 불일치");
+        TEST_ASSERT_EQ(btree_test_int_size(tree), btree_test_int_size(copy), "역직렬화한 크기 불일치");
+        TEST_ASSERT_NULL(btree_test_int_search(copy, 10), "삭제 표시된 키가 검색됨");
+        TEST_ASSERT_EQ(7, *btree_test_int_search(copy, 2), "역직렬화한 값 불일치");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(copy, 10, -1), "역직렬화한 트리 삽입 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(copy, 12), "역직렬화한 트리 삭제 실패");
+        TEST_ASSERT(btree_validate_structure(&copy->base), "수정 후 구조가 유효하지 않음");
+        btree_test_int_destroy(copy);
+        
+        /* 헤더나 페이지가 손상되면 거부 */
+        copy = btree_test_int_create(5);
+        image[20] ^= 0x40;
+        TEST_ASSERT_EQ(BTREE_ERROR_CORRUPTED, btree_deserialize(&copy->base, image, size),
+                       "손상된 헤더가 허용됨");
+        image[20] ^= 0x40;
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_SIZE, btree_deserialize(&copy->base, image, size - 1),
+                       "잘린 이미지가 허용됨");
+        memset(image + size / 2, 0xff, 1024);
+        TEST_ASSERT_EQ(BTREE_ERROR_CORRUPTED, btree_deserialize(&copy->base, image, size),
+                       "손상된 페이지가 허용됨");
+        TEST_ASSERT(btree_test_int_is_empty(copy), "실패한 역직렬화가 트리를 바꿈");
+        btree_test_int_destroy(copy);
+        free(image);
+        btree_test_int_destroy(tree);
+    }
+    
+    /* 타입이 다른 트리와 포인터 타입은 거부 */
+    btree_test_int_t *tree = btree_test_int_create(4);
+    btree_test_int_insert(tree, 1, 1);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_save_to_file(&tree->base, path), "파일 저장 실패");
+    
+    btree_t other;
+    btree_type_info_t key_type = tree->base.key_type;
+    key_type.type_name = "unsigned";
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&other, 4, &key_type, &tree->base.value_type, NULL),
+                   "B-Tree 초기화 실패");
+    TEST_ASSERT_EQ(BTREE_ERROR_TYPE_MISMATCH, btree_load_from_file(&other, path), "다른 타입으로 불러옴");
+    btree_cleanup(&other);
+    
+    const char *value_name = tree->base.value_type.type_name;
+    tree->base.value_type.type_name = "int*";
+    TEST_ASSERT_EQ(BTREE_ERROR_TYPE_MISMATCH, btree_save_to_file(&tree->base, path), "포인터 값이 저장됨");
+    TEST_ASSERT_EQ((size_t)0, btree_serialize_size(&tree->base), "포인터 값의 직렬화 크기가 0이 아님");
+    tree->base.value_type.type_name = value_name;
+    btree_test_int_destroy(tree);
+    
+    FILE *file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(file, "파일 열기 실패");
+    char garbage[4096];
+    memset(garbage, 'x', sizeof(garbage));
+    fwrite(garbage, 1, sizeof(garbage), file);
+    fclose(file);
+    tree = btree_test_int_create(4);
+    TEST_ASSERT_EQ(BTREE_ERROR_CORRUPTED, btree_load_from_file(&tree->base, path), "손상된 파일이 열림");
+    remove(path);
+    TEST_ASSERT_EQ(BTREE_ERROR_IO, btree_load_from_file(&tree->base, path), "없는 파일이 열림");
+    TEST_ASSERT(btree_test_int_is_empty(tree), "실패한 매핑이 트리를 바꿈");
+    btree_test_int_destroy(tree);
+    return true;
+}
+
+/* 블록 하나를 algorithm으로 압축하고 되돌려 비교 (압축 크기 반환, 실패하면 0) */
+static size_t test_codec_roundtrip(const void *src, size_t size, uint32_t element_size,
+                                   uint32_t algorithm, uint32_t *chosen) {
+    static unsigned char packed[65536], restored[65536];
+    btree_compression_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.algorithm = algorithm;
+    info.element_size = element_size;
+    
+    size_t packed_size = sizeof(packed);
+    if (!btree_memory_compress(src, size, packed, &packed_size, &info)) return 0;
+    if (!btree_memory_decompress(packed, packed_size, restored, size, &info)) return 0;
+    if (memcmp(src, restored, size) != 0) return 0;
+    if (chosen) *chosen = info.algorithm;
+    return packed_size ? packed_size : 1;
+}
+
+typedef struct {
+    btree_test_int_t *tree;
+    int seed;
+    int errors;
+} test_frozen_reader_t;
+
+/* 얼린 트리를 btree_get으로 읽는 스레드 (리프 캐시를 서로 교체함) */
+static void* test_frozen_reader(void *arg) {
+    test_frozen_reader_t *reader = arg;
+    unsigned state = (unsigned)reader->seed;
+    for (int i = 0; i < 20000; i++) {
+        state = state * 1103515245u + 12345u;
+        int key = (int)((state >> 8) % 8000) * 2;
+        int value = 0;
+        btree_result_t result = btree_get(&reader->tree->base, &key, &value);
+        if (key % 10 == 0 ? result != BTREE_ERROR_KEY_NOT_FOUND
+                          : (result != BTREE_SUCCESS || value != key * 3 + 1)) {
+            reader->errors++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 블록 압축 코덱, 압축 리프 이미지, 얼리기/녹이기 테스트
+ */
+bool test_compressed_leaves() {
+    /* 코덱: 정수 배열은 FOR/DELTA, 반복되는 바이트열은 LZ4가 줄임 */
+    static int32_t ascending[4096];
+    static int64_t spread[1024];
+    static char text[16384];
+    for (int i = 0; i < 4096; i++) ascending[i] = 1000000 + i * 3;
+    for (int i = 0; i < 1024; i++) spread[i] = (int64_t)(i % 17) * 1000 - 8000;
+    for (int i = 0; i < (int)sizeof(text); i++) text[i] = "archival index page "[i % 20];
+    
+    uint32_t chosen = 0;
+    const uint32_t algorithms[] = { BTREE_COMPRESS_NONE, BTREE_COMPRESS_LZ4,
+                                    BTREE_COMPRESS_FOR, BTREE_COMPRESS_DELTA };
+    for (int a = 0; a < 4; a++) {
+        TEST_ASSERT(test_codec_roundtrip(ascending, sizeof(ascending), 4, algorithms[a], NULL) > 0,
+                    "정수 배열 왕복 실패");
+        TEST_ASSERT(test_codec_roundtrip(spread, sizeof(spread), 8, algorithms[a], NULL) > 0,
+                    "음수 섞인 배열 왕복 실패");
+    }
+    size_t packed = test_codec_roundtrip(ascending, sizeof(ascending), 4, BTREE_COMPRESS_AUTO, &chosen);
+    TEST_ASSERT(packed > 0 && packed < sizeof(ascending) / 3, "증가하는 정수가 줄지 않음");
+    TEST_ASSERT(chosen == BTREE_COMPRESS_FOR || chosen == BTREE_COMPRESS_DELTA,
+                "정수 배열에 정수 코덱이 선택되지 않음");
+    packed = test_codec_roundtrip(text, sizeof(text), 0, BTREE_COMPRESS_AUTO, &chosen);
+    TEST_ASSERT(packed > 0 && packed < sizeof(text) / 20, "반복되는 바이트열이 줄지 않음");
+    TEST_ASSERT_EQ(BTREE_COMPRESS_LZ4, chosen, "바이트열에 LZ4가 선택되지 않음");
+    TEST_ASSERT(test_codec_roundtrip(text, 0, 0, BTREE_COMPRESS_AUTO, NULL) > 0, "빈 블록 왕복 실패");
+    TEST_ASSERT_EQ((size_t)0, test_codec_roundtrip(text, sizeof(text), 0, BTREE_COMPRESS_FOR, NULL),
+                   "정수 크기 없이 FOR가 허용됨");
+    
+    unsigned char small[16];
+    size_t small_size = sizeof(small);
+    btree_compression_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.algorithm = BTREE_COMPRESS_NONE;
+    TEST_ASSERT(!btree_memory_compress(text, 64, small, &small_size, &info), "작은 버퍼에 압축됨");
+    info.algorithm = BTREE_COMPRESS_LZ4;
+    small_size = sizeof(small);
+    TEST_ASSERT(btree_memory_compress(text, 12, small, &small_size, &info), "짧은 블록 압축 실패");
+    TEST_ASSERT(!btree_memory_decompress(small, small_size - 1, text + 8192, 12, &info),
+                "잘린 LZ4 블록이 풀림");
+    
+    /* 압축 이미지 저장과 매핑 */
+    const char *path = "test_btree_compressed.bin";
+    const btree_variant_t variants[] = { BTREE_VARIANT_STANDARD, BTREE_VARIANT_PLUS };
+    for (int v = 0; v < 2; v++) {
+        btree_test_int_t *tree = btree_test_int_create(16);
+        TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_variant(&tree->base, variants[v]), "변형 설정 실패");
+        for (int i = 0; i < 8000; i++) {
+            btree_test_int_insert(tree, i * 2, i * 6 + 1);
+        }
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_lazy_delete(&tree->base, true), "지연 삭제 설정 실패");
+        for (int i = 0; i < 16000; i += 10) {
+            btree_test_int_delete(tree, i);
+        }
+        
+        size_t plain_size = btree_serialize_size(&tree->base);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_leaf_compression(&tree->base, true), "압축 설정 실패");
+        size_t size = btree_serialize_size(&tree->base);
+        TEST_ASSERT(size > 0 && size < plain_size / 2, "압축 이미지가 작지 않음");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_save_to_file(&tree->base, path), "압축 이미지 저장 실패");
+        
+        btree_test_int_t *mapped = btree_test_int_create(3);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_load_from_file(&mapped->base, path), "압축 이미지 매핑 실패");
+        TEST_ASSERT_EQ(btree_test_int_size(tree), btree_test_int_size(mapped), "매핑된 크기 불일치");
+        TEST_ASSERT(btree_validate_structure(&mapped->base), "압축 이미지 구조가 유효하지 않음");
+        for (int key = -1; key < 16001; key++) {
+            int *expected = btree_test_int_search(tree, key);
+            int *found = btree_test_int_search(mapped, key);
+            TEST_ASSERT_EQ(expected == NULL, found == NULL, "압축 이미지 검색 결과 불일치");
+            if (found) TEST_ASSERT_EQ(*expected, *found, "압축 이미지 값 불일치");
+        }
+        int value = 0, key = 42;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_get(&mapped->base, &key, &value), "압축 이미지 값 읽기 실패");
+        TEST_ASSERT_EQ(127, value, "압축 이미지 btree_get 값 불일치");
+        key = 40;
+        TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, btree_get(&mapped->base, &key, &value),
+                       "삭제 표시된 키를 읽음");
+        
+        btree_compression_stats_t stats;
+        TEST_ASSERT(btree_compression_get_stats(&mapped->base, &stats), "압축 통계 조회 실패");
+        TEST_ASSERT(stats.leaf_count > stats.cache_slots, "리프가 캐시보다 적음");
+        TEST_ASSERT(stats.compressed_bytes * 2 < stats.leaf_bytes, "리프가 절반 이하로 줄지 않음");
+        TEST_ASSERT(stats.cache_hits > 0 && stats.cache_misses >= stats.leaf_count,
+                    "리프 캐시가 쓰이지 않음");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_test_int_insert(mapped, 1, 1),
+                       "압축 이미지에 삽입됨");
+        btree_test_int_destroy(mapped);
+        TEST_ASSERT(!btree_compression_get_stats(&tree->base, &stats), "노드 트리에 압축 통계가 있음");
+        
+        /* 버퍼 왕복과 손상 검출 */
+        unsigned char *image = malloc(size);
+        TEST_ASSERT_NOT_NULL(image, "버퍼 할당 실패");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_SIZE, btree_serialize(&tree->base, image, size - 1),
+                       "작은 버퍼에 직렬화됨");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_serialize(&tree->base, image, size), "직렬화 실패");
+        btree_test_int_t *copy = btree_test_int_create(5);
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_deserialize(&copy->base, image, size), "역직렬화 실패");
+        TEST_ASSERT(btree_validate_structure(&copy->base), "역직렬화한 트리 구조가 유효하지 않음");
+        TEST_ASSERT_EQ(tree->base.node_count, copy->base.node_count, "역직렬화한 노드 수 불일치");
+        TEST_ASSERT_EQ(13, *btree_test_int_search(copy, 4), "역직렬화한 값 불일치");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(copy, 10, -1), "역직렬화한 트리 삽입 실패");
+        btree_test_int_destroy(copy);
+        
+        copy = btree_test_int_create(5);
+        image[size - 3] ^= 0x5a;
+        TEST_ASSERT_EQ(BTREE_ERROR_CORRUPTED, btree_deserialize(&copy->base, image, size),
+                       "손상된 블롭이 허용됨");
+        image[size - 3] ^= 0x5a;
+        TEST_ASSERT_EQ(BTREE_ERROR_CORRUPTED, btree_deserialize(&copy->base, image, size - 1),
+                       "잘린 압축 이미지가 허용됨");
+        TEST_ASSERT(btree_test_int_is_empty(copy), "실패한 역직렬화가 트리를 바꿈");
+        btree_test_int_destroy(copy);
+        free(image);
+        
+        /* 얼리기: 노드를 해제하고 압축 이미지로 검색, 녹이면 다시 수정 가능 */
+        size_t nodes = tree->base.node_count;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_freeze(&tree->base), "얼리기 실패");
+        TEST_ASSERT_EQ((size_t)0, tree->base.node_count, "얼린 트리에 노드가 남음");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "얼린 트리 구조가 유효하지 않음");
+        TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_test_int_delete(tree, 2), "얼린 트리에서 삭제됨");
+        
+        pthread_t threads[4];
+        test_frozen_reader_t readers[4];
+        for (int t = 0; t < 4; t++) {
+            readers[t].tree = tree;
+            readers[t].seed = t + 1;
+            readers[t].errors = 0;
+            TEST_ASSERT_EQ(0, pthread_create(&threads[t], NULL, test_frozen_reader, &readers[t]),
+                           "스레드 생성 실패");
+        }
+        int errors = 0;
+        for (int t = 0; t < 4; t++) {
+            pthread_join(threads[t], NULL);
+            errors += readers[t].errors;
+        }
+        TEST_ASSERT_EQ(0, errors, "얼린 트리 동시 읽기 결과 불일치");
+        
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_thaw(&tree->base), "녹이기 실패");
+        TEST_ASSERT_EQ(nodes, tree->base.node_count, "녹인 트리 노드 수 불일치");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_delete(tree, 2), "녹인 트리 삭제 실패");
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_test_int_insert(tree, 16001, 5), "녹인 트리 삽입 실패");
+        TEST_ASSERT(btree_validate_structure(&tree->base), "녹인 트리 구조가 유효하지 않음");
+        btree_test_int_destroy(tree);
+    }
+    
+    /* 빈 트리와 로그가 붙은 트리 */
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_freeze(&tree->base), "빈 트리 얼리기 실패");
+    TEST_ASSERT_NULL(btree_test_int_search(tree, 1), "빈 얼린 트리에서 키가 검색됨");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_thaw(&tree->base), "빈 트리 녹이기 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_wal_open(&tree->base, path), "로그 열기 실패");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_freeze(&tree->base), "로그가 붙은 트리가 얼려짐");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_wal_close(&tree->base), "로그 닫기 실패");
+    btree_test_int_destroy(tree);
+    remove(path);
+    remove("test_btree_compressed.bin.wal");
+    return true;
+}
+
+/**
+ * @brief 디스크 할당자 (상주 프레임 한도, 내보내기, 고정) 테스트
+ */
+bool test_disk_allocator() {
+    const char *path = "test_btree_disk.bin";
+    remove(path);
+    
+    btree_allocator_t *disk = btree_disk_allocator_create(path, 256u << 20, 4096, 32 * 4096);
+    TEST_ASSERT_NOT_NULL(disk, "디스크 할당자 생성 실패");
+    TEST_ASSERT_NULL(btree_disk_allocator_create(path, 256u << 20, 4096, 32 * 4096),
+                     "기존 파일 위에 할당자가 생성됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_IO, btree_get_last_error(), "기존 파일 오류 코드 불일치");
+    
+    int degree = btree_disk_page_degree(4096, sizeof(int), sizeof(int));
+    TEST_ASSERT(degree > 100, "프레임 차수가 너무 작음");
+    btree_t tree;
+    btree_test_int_t *meta = btree_test_int_create(4);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_init(&tree, degree, &meta->base.key_type,
+                                             &meta->base.value_type, disk), "B-Tree 초기화 실패");
+    tree.flags |= BTREE_FLAG_INLINE_NODES;
+    
+    const int n = 60000;
+    for (int i = 0; i < n; i++) {
+        int key = (i * 7919) % n, value = key * 3;
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_insert(&tree, &key, &value), "디스크 트리 삽입 실패");
+    }
+    TEST_ASSERT(tree.root->is_inline, "루트가 단일 블록 노드가 아님");
+    
+    btree_disk_stats_t stats;
+    TEST_ASSERT(btree_disk_allocator_get_stats(disk, &stats), "통계 조회 실패");
+    TEST_ASSERT(stats.frames_used > 2 * stats.resident_limit, "트리가 상주 한도보다 작음");
+    TEST_ASSERT(stats.resident_frames <= stats.resident_limit, "상주 프레임이 한도를 넘음");
+    TEST_ASSERT(stats.evictions > 0 && stats.writebacks > 0, "프레임을 내보내지 않음");
+    TEST_ASSERT(stats.frames_used >= tree.node_count, "노드가 프레임을 공유함");
+    
+    /* 루트 고정: 검색이 돌아도 내보내지 않음 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_disk_allocator_pin(disk, tree.root, true), "루트 고정 실패");
+    size_t evictions = stats.evictions;
+    for (int key = 0; key < n; key++) {
+        int *value = btree_search(&tree, &key);
+        TEST_ASSERT_NOT_NULL(value, "디스크 트리에서 키를 찾지 못함");
+        TEST_ASSERT_EQ(key * 3, *value, "디스크 트리 값 불일치");
+    }
+    btree_disk_allocator_get_stats(disk, &stats);
+    TEST_ASSERT(stats.faults > 0 && stats.evictions > evictions, "검색 중 교체가 일어나지 않음");
+    TEST_ASSERT_EQ((size_t)1, stats.pinned_frames, "고정 프레임 수 불일치");
+    TEST_ASSERT(btree_validate_structure(&tree), "디스크 트리 구조가 유효하지 않음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_disk_allocator_pin(disk, tree.root, false), "고정 해제 실패");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_disk_allocator_pin(disk, tree.root, false),
+                   "고정되지 않은 프레임이 해제됨");
+    
+    /* 삭제로 반환된 블록을 재사용 */
+    for (int key = 0; key < n; key += 2) {
+        TEST_ASSERT_EQ(BTREE_SUCCESS, btree_delete(&tree, &key), "디스크 트리 삭제 실패");
+    }
+    size_t frames = stats.frames_used;
+    for (int key = 0; key < n; key += 2) {
+        int value = -key;
+        btree_insert(&tree, &key, &value);
+    }
+    btree_disk_allocator_get_stats(disk, &stats);
+    TEST_ASSERT(stats.frames_used < frames + frames / 4, "반환된 블록을 재사용하지 않음");
+    TEST_ASSERT(btree_validate_structure(&tree), "재삽입 후 구조가 유효하지 않음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_disk_allocator_flush(disk), "플러시 실패");
+    
+    btree_cleanup(&tree);
+    btree_disk_allocator_get_stats(disk, &stats);
+    TEST_ASSERT_EQ((size_t)0, stats.bytes_in_use, "트리 정리 후 블록이 남음");
+    btree_disk_allocator_destroy(disk);
+    btree_test_int_destroy(meta);
+    
+    FILE *file = fopen(path, "rb");
+    if (file) fclose(file);
+    TEST_ASSERT_NULL(file, "할당자 해제 후 파일이 남음");
+    return true;
+}
+
+/* 트랜잭션 커밋 스레드 */
+typedef struct {
+    btree_test_int_t *tree;
+    int base;
+    int count;
+    bool ok;
+} test_commit_arg_t;
+
+static void* test_commit_thread(void *arg) {
+    test_commit_arg_t *a = arg;
+    a->ok = true;
+    for (int i = 0; i < a->count; i++) {
+        btree_transaction_t *tx = btree_transaction_begin(&a->tree->base);
+        int key = a->base + i, value = key * 5;
+        if (!tx || btree_transaction_insert(tx, &key, &value) != BTREE_SUCCESS ||
+            btree_transaction_commit(tx) != BTREE_SUCCESS) {
+            a->ok = false;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 트랜잭션, 선행 기록 로그, 복구 테스트
+ */
+bool test_transactions() {
+    const char *path = "test_btree_wal.bin";
+    const char *log_path = "test_btree_wal.bin.wal";
+    remove(path);
+    remove(log_path);
+    
+    /* 로그 없이 커밋과 롤백 */
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    for (int i = 0; i < 100; i++) {
+        btree_test_int_insert(tree, i, i);
+    }
+    btree_transaction_t *tx = btree_transaction_begin(&tree->base);
+    TEST_ASSERT_NOT_NULL(tx, "트랜잭션 시작 실패");
+    int key = 500, value = 1;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_insert(tx, &key, &value), "트랜잭션 삽입 실패");
+    key = 7;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_delete(tx, &key), "트랜잭션 삭제 실패");
+    key = 1000;
+    TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, btree_transaction_delete(tx, &key), "없는 키가 삭제됨");
+    key = 3;
+    TEST_ASSERT_EQ(BTREE_ERROR_DUPLICATE_KEY, btree_transaction_insert(tx, &key, &value), "중복 키가 삽입됨");
+    TEST_ASSERT(btree_test_int_contains(tree, 500), "트랜잭션 삽입이 적용되지 않음");
+    TEST_ASSERT(!btree_test_int_contains(tree, 7), "트랜잭션 삭제가 적용되지 않음");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_rollback(tx), "롤백 실패");
+    TEST_ASSERT(!btree_test_int_contains(tree, 500), "롤백 후 삽입이 남음");
+    TEST_ASSERT_EQ(7, *btree_test_int_search(tree, 7), "롤백 후 삭제된 값이 복원되지 않음");
+    TEST_ASSERT_EQ((size_t)100, btree_test_int_size(tree), "롤백 후 크기 불일치");
+    
+    tx = btree_transaction_begin(&tree->base);
+    key = 7;
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_delete(tx, &key), "트랜잭션 삭제 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_commit(tx), "커밋 실패");
+    TEST_ASSERT(!btree_test_int_contains(tree, 7), "커밋한 삭제가 사라짐");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_checkpoint(&tree->base), "로그 없이 체크포인트됨");
+    
+    /* 로그를 붙이고 여러 스레드에서 커밋 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_wal_open(&tree->base, path), "로그 열기 실패");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_wal_open(&tree->base, path), "로그가 두 번 열림");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_set_thread_safe(&tree->base, true), "동시 모드 설정 실패");
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_checkpoint(&tree->base), "동시 모드에서 체크포인트됨");
+    
+    enum { THREADS = 4, PER_THREAD = 200 };
+    pthread_t threads[THREADS];
+    test_commit_arg_t args[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        args[t] = (test_commit_arg_t){ tree, 1000 + t * PER_THREAD, PER_THREAD, false };
+        pthread_create(&threads[t], NULL, test_commit_thread, &args[t]);
+    }
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        TEST_ASSERT(args[t].ok, "동시 커밋 실패");
+    }
+    
+    /* 롤백한 변경은 로그에 남지 않음 */
+    tx = btree_transaction_begin(&tree->base);
+    key = 20;
+    btree_transaction_delete(tx, &key);
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_OPERATION, btree_checkpoint(&tree->base),
+                   "진행 중인 트랜잭션이 있는데 체크포인트됨");
+    btree_transaction_rollback(tx);
+    
+    tx = btree_transaction_begin(&tree->base);
+    key = 30;
+    btree_transaction_delete(tx, &key);
+    key = 31; value = -31;
+    btree_transaction_delete(tx, &key);
+    btree_transaction_insert(tx, &key, &value);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_commit(tx), "커밋 실패");
+    
+    btree_wal_stats_t stats;
+    TEST_ASSERT(btree_wal_get_stats(&tree->base, &stats), "로그 통계 조회 실패");
+    TEST_ASSERT_EQ((size_t)(THREADS * PER_THREAD + 1), stats.commits, "커밋 수 불일치");
+    TEST_ASSERT(stats.syncs > 0 && stats.syncs <= stats.commits, "동기화 수가 올바르지 않음");
+    TEST_ASSERT_EQ(stats.last_lsn, stats.durable_lsn, "커밋한 묶음이 디스크에 내려지지 않음");
+    size_t expected_size = btree_test_int_size(tree);
+    
+    /* 체크포인트 없이 닫고 쓰다 만 꼬리를 붙인 뒤 복구 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_wal_close(&tree->base), "로그 닫기 실패");
+    FILE *file = fopen(log_path, "ab");
+    TEST_ASSERT_NOT_NULL(file, "로그 열기 실패");
+    const unsigned char torn[] = { 'B', 'T', 'X', 'N', 2, 0, 0, 0, 0xff, 0xff };
+    fwrite(torn, 1, sizeof(torn), file);
+    fclose(file);
+    
+    btree_test_int_t *recovered = btree_test_int_create(4);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_load_from_file(&recovered->base, path), "복구 실패");
+    TEST_ASSERT(btree_validate_structure(&recovered->base), "복구한 트리 구조가 유효하지 않음");
+    TEST_ASSERT_EQ(expected_size, btree_test_int_size(recovered), "복구한 트리 크기 불일치");
+    for (int k = 0; k < 1000 + THREADS * PER_THREAD; k++) {
+        int *expected = btree_test_int_search(tree, k);
+        int *found = btree_test_int_search(recovered, k);
+        TEST_ASSERT_EQ(expected == NULL, found == NULL, "복구한 트리 키 집합 불일치");
+        if (found) TEST_ASSERT_EQ(*expected, *found, "복구한 트리 값 불일치");
+    }
+    TEST_ASSERT(btree_test_int_contains(recovered, 20), "롤백한 삭제가 복구됨");
+    TEST_ASSERT_EQ(-31, *btree_test_int_search(recovered, 31), "커밋한 값이 복구되지 않음");
+    
+    /* 복구한 트리는 수정 가능, 체크포인트 후 로그는 헤더만 남음 */
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_wal_open(&recovered->base, path), "로그 다시 열기 실패");
+    tx = btree_transaction_begin(&recovered->base);
+    key = 5000; value = 5;
+    btree_transaction_insert(tx, &key, &value);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_transaction_commit(tx), "커밋 실패");
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_checkpoint(&recovered->base), "체크포인트 실패");
+    TEST_ASSERT(btree_wal_get_stats(&recovered->base, &stats), "로그 통계 조회 실패");
+    TEST_ASSERT_EQ((size_t)1, stats.checkpoints, "체크포인트 수 불일치");
+    file = fopen(log_path, "rb");
+    TEST_ASSERT_NOT_NULL(file, "로그 열기 실패");
+    fseek(file, 0, SEEK_END);
+    long log_size = ftell(file);
+    fclose(file);
+    TEST_ASSERT(log_size > 0 && log_size < 64, "체크포인트 후 로그가 비워지지 않음");
+    btree_test_int_destroy(recovered);
+    
+    /* 체크포인트한 이미지는 로그 없이 매핑 */
+    btree_test_int_t *mapped = btree_test_int_create(4);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, btree_load_from_file(&mapped->base, path), "이미지 매핑 실패");
+    TEST_ASSERT_EQ(5, *btree_test_int_search(mapped, 5000), "체크포인트에 커밋이 없음");
+    TEST_ASSERT_NULL(btree_transaction_begin(&mapped->base), "매핑된 트리에서 트랜잭션 시작됨");
+    btree_test_int_destroy(mapped);
+    btree_test_int_destroy(tree);
+    
+    remove(path);
+    remove(log_path);
+    return true;
+}
+
+/**
+ * @brief 오류 처리 테스트
+ */
+static int test_error_calls;
+static btree_result_t test_error_last;
+
+static void test_error_handler(btree_result_t error, const char *message) {
+    if (message && message[0]) {
+        test_error_calls++;
+        test_error_last = error;
+    }
+}
+
+/* 다른 스레드에서 오류를 만들고 그 스레드의 마지막 오류를 돌려줌 */
+static void* test_error_thread(void *arg) {
+    btree_test_int_t *tree = btree_test_int_create(1);
+    *(btree_result_t*)arg = tree ? BTREE_SUCCESS : btree_get_last_error();
+    return NULL;
+}
+
+bool test_error_handling() {
+    /* NULL 포인터 테스트 */
+    btree_result_t result = btree_insert(NULL, NULL, NULL);
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, result, "NULL 포인터 오류가 감지되지 않음");
+    
+    void *search_result = btree_search(NULL, NULL);
+    TEST_ASSERT_NULL(search_result, "NULL 트리에서 검색이 성공함");
+    
+    /* 잘못된 차수 테스트 */
+    btree_test_int_t *invalid_tree = btree_test_int_create(1);  /* 최소 차수보다 작음 */
+    TEST_ASSERT_NULL(invalid_tree, "잘못된 차수로 트리가 생성됨");
+    
+    /* 오류 문자열 테스트 */
+    const char *error_msg = btree_error_string(BTREE_ERROR_MEMORY_ALLOCATION);
+    TEST_ASSERT_NOT_NULL(error_msg, "오류 문자열이 NULL임");
+    TEST_ASSERT(strlen(error_msg) > 0, "오류 문자열이 비어있음");
+    
+    /* 찾은 검색은 오류 상태를 바꾸지 않고, btree_lookup은 없는 키도 기록하지 않음 */
+    btree_test_int_t *tree = btree_test_int_create(4);
+    TEST_ASSERT_NOT_NULL(tree, "B-Tree 생성 실패");
+    for (int i = 0; i < 100; i++) btree_test_int_insert(tree, i, i * 2);
+    int key = 500;
+    TEST_ASSERT_NULL(btree_search(&tree->base, &key), "없는 키가 검색됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, btree_get_last_error(), "없는 키 오류 불일치");
+    key = 7;
+    TEST_ASSERT_NOT_NULL(btree_search(&tree->base, &key), "있는 키를 찾지 못함");
+    TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, btree_get_last_error(), "찾은 검색이 오류 상태를 바꿈");
+    
+    btree_search(NULL, NULL);
+    btree_lookup_t found = btree_lookup(&tree->base, &key);
+    TEST_ASSERT_EQ(BTREE_SUCCESS, found.status, "btree_lookup 상태 불일치");
+    TEST_ASSERT_NOT_NULL(found.value, "btree_lookup 값이 NULL");
+    TEST_ASSERT_EQ(14, *(int*)found.value, "btree_lookup 값 불일치");
+    key = -1;
+    found = btree_lookup(&tree->base, &key);
+    TEST_ASSERT_EQ(BTREE_ERROR_KEY_NOT_FOUND, found.status, "없는 키의 btree_lookup 상태 불일치");
+    TEST_ASSERT_NULL(found.value, "없는 키의 btree_lookup 값이 NULL이 아님");
+    TEST_ASSERT(!btree_contains(&tree->base, &key), "없는 키가 포함됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_get_last_error(), "btree_lookup이 오류 상태를 바꿈");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_lookup(NULL, &key).status, "NULL 트리 btree_lookup 상태 불일치");
+    
+    /* 마지막 오류는 스레드마다 따로 */
+    pthread_t thread;
+    btree_result_t seen = BTREE_SUCCESS;
+    TEST_ASSERT_EQ(0, pthread_create(&thread, NULL, test_error_thread, &seen), "스레드 생성 실패");
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQ(BTREE_ERROR_INVALID_DEGREE, seen, "다른 스레드의 마지막 오류 불일치");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_get_last_error(), "다른 스레드의 오류가 보임");
+    
+    /* 처리기는 없는 키를 빼고 오류마다 불림 */
+    test_error_calls = 0;
+    test_error_last = BTREE_SUCCESS;
+    btree_set_error_handler(test_error_handler);
+    key = 500;
+    btree_search(&tree->base, &key);
+    TEST_ASSERT_EQ(0, test_error_calls, "없는 키가 처리기로 전달됨");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, btree_insert(NULL, &key, &key), "NULL 트리에 삽입됨");
+    TEST_ASSERT_EQ(1, test_error_calls, "처리기가 불리지 않음");
+    TEST_ASSERT_EQ(BTREE_ERROR_NULL_POINTER, test_error_last, "처리기에 전달된 오류 불일치");
+    btree_set_error_handler(NULL);
+    btree_search(NULL, NULL);
+    TEST_ASSERT_EQ(1, test_error_calls, "해제한 처리기가 불림");
+    btree_test_int_destroy(tree);
     
     return true;
 }
@@ -382,7 +3857,41 @@ void run_all_tests() {
     
     /* 고급 기능 테스트 */
     RUN_TEST(test_large_dataset);
+    RUN_TEST(test_inline_node_layout);
+    RUN_TEST(test_bulk_insert_sorted);
+    RUN_TEST(test_bulk_insert_unsorted);
+    RUN_TEST(test_batch_upsert);
+    RUN_TEST(test_parallel_bulk_and_scan);
+    RUN_TEST(test_insert_no_temp_allocations);
+    RUN_TEST(test_append_path);
+    RUN_TEST(test_metrics);
+    RUN_TEST(test_metrics_percentiles);
+    RUN_TEST(test_events);
+    RUN_TEST(test_delete);
+    RUN_TEST(test_search_kernels);
+    RUN_TEST(test_node_sizing);
+    RUN_TEST(test_string_keys);
+    RUN_TEST(test_strkey_copy_failure);
+    RUN_TEST(test_prefix_search);
+    RUN_TEST(test_search_batch);
+    RUN_TEST(test_bplus_tree);
+    RUN_TEST(test_lazy_delete);
+    RUN_TEST(test_snapshot);
+    RUN_TEST(test_layout);
+    RUN_TEST(test_iterator_range);
+    RUN_TEST(test_concurrent_access);
+    RUN_TEST(test_concurrent_copy);
+    RUN_TEST(test_concurrent_reclaim);
     RUN_TEST(test_memory_pool);
+    RUN_TEST(test_memory_pool_threads);
+    RUN_TEST(test_node_pool);
+    RUN_TEST(test_alloc_hints);
+    RUN_TEST(test_numa_replication);
+    RUN_TEST(test_page_mapped_pools);
+    RUN_TEST(test_file_storage);
+    RUN_TEST(test_compressed_leaves);
+    RUN_TEST(test_disk_allocator);
+    RUN_TEST(test_transactions);
     
     /* 오류 처리 테스트 */
     RUN_TEST(test_error_handling);